@@ -37,6 +37,9 @@ pixelix.ws.Client = function(options) {
     this._cmdQueue      = [];
     this._pendingCmd    = null;
     this._onEvent       = null;
+    this._frame         = null;
+    this._stream        = null;
+    this._streamFrame   = null;
 
     this._sendCmdFromQueue = function() {
         var msg = "";
@@ -90,6 +93,7 @@ pixelix.ws.Client.prototype.connect = function(options) {
             try {
                 wsUrl = options.protocol + "://" + options.hostname + ":" + options.port + options.endpoint;
                 this._socket = new WebSocket(wsUrl);
+                this._socket.binaryType = "arraybuffer";
 
                 this._socket.onopen = function(openEvent) {
                     console.debug("Websocket opened.");
@@ -106,8 +110,13 @@ pixelix.ws.Client.prototype.connect = function(options) {
                 };
 
                 this._socket.onmessage = function(messageEvent) {
-                    console.debug("Websocket message: " + messageEvent.data);
-                    this._onMessage(messageEvent.data);
+                    if (messageEvent.data instanceof ArrayBuffer) {
+                        console.debug("Websocket binary message: " + messageEvent.data.byteLength + " byte");
+                        this._onBinaryMessage(messageEvent.data);
+                    } else {
+                        console.debug("Websocket message: " + messageEvent.data);
+                        this._onMessage(messageEvent.data);
+                    }
                 }.bind(this);
 
             } catch (exception) {
@@ -205,6 +214,8 @@ pixelix.ws.Client.prototype._onMessage = function(msg) {
                 this._pendingCmd.resolve(rsp);
             } else if ("UNINSTALL" === this._pendingCmd.name) {
                 this._pendingCmd.resolve(rsp);
+            } else if ("STREAM" === this._pendingCmd.name) {
+                this._pendingCmd.resolve(rsp);
             } else {
                 console.error("Unknown command: " + this._pendingCmd.name);
                 this._pendingCmd.reject();
@@ -222,14 +233,276 @@ pixelix.ws.Client.prototype._onMessage = function(msg) {
     return;
 };
 
-pixelix.ws.Client.prototype.getDisplayContent = function() {
+pixelix.ws.Client.prototype._decodeFrame = function(buffer, reference) {
+    var view            = new DataView(buffer);
+    var headerSize      = 16;
+    var format          = 0;
+    var encoding        = 0;
+    var frameNo         = 0;
+    var refFrameNo      = 0;
+    var width           = 0;
+    var height          = 0;
+    var bytesPerPixel   = 0;
+    var values          = null;
+    var rdIndex         = headerSize;
+    var index           = 0;
+    var num             = 0;
+    var isRepeated      = false;
+    var pixel           = 0;
+    var value           = 0;
+    var frame           = null;
+
+    if ((headerSize > buffer.byteLength) ||
+        (1 !== view.getUint8(0))) {
+        return null;
+    }
+
+    /* Bit 7 marks a stream frame. */
+    format      = view.getUint8(1) & 0x7f;
+    encoding    = view.getUint8(2);
+    frameNo     = view.getUint32(4, true);
+    refFrameNo  = view.getUint32(8, true);
+    width       = view.getUint16(12, true);
+    height      = view.getUint16(14, true);
+
+    /* 0: RGB888, 1: RGB565 */
+    bytesPerPixel = (1 === format) ? 2 : 3;
+
+    /* 0: raw, 1: run-length encoded, 2: run-length encoded XOR delta to the reference frame */
+    if (2 === encoding) {
+        if ((null === reference) ||
+            (refFrameNo !== reference.frameNo) ||
+            (format !== reference.format) ||
+            (width * height !== reference.values.length)) {
+            return null;
+        }
+
+        values = reference.values;
+    } else {
+        values = new Uint32Array(width * height);
+    }
+
+    while((buffer.byteLength > rdIndex) && (values.length > index)) {
+        num         = 1;
+        isRepeated  = false;
+
+        if (0 !== encoding) {
+            isRepeated  = (0 !== (view.getUint8(rdIndex) & 0x80));
+            num         = (view.getUint8(rdIndex) & 0x7f) + 1;
+            ++rdIndex;
+        }
+
+        if (buffer.byteLength < (rdIndex + bytesPerPixel)) {
+            return null;
+        }
+
+        for(pixel = 0; (pixel < num) && (values.length > index); ++pixel) {
+
+            if (2 === bytesPerPixel) {
+                value = view.getUint16(rdIndex, true);
+            } else {
+                value = (view.getUint8(rdIndex) << 16) | (view.getUint8(rdIndex + 1) << 8) | view.getUint8(rdIndex + 2);
+            }
+
+            if (2 === encoding) {
+                values[index] ^= value;
+            } else {
+                values[index] = value;
+            }
+
+            if (false === isRepeated) {
+                rdIndex += bytesPerPixel;
+
+                if ((num > (pixel + 1)) && (buffer.byteLength < (rdIndex + bytesPerPixel))) {
+                    return null;
+                }
+            }
+
+            ++index;
+        }
+
+        if (true === isRepeated) {
+            rdIndex += bytesPerPixel;
+        }
+    }
+
+    if (values.length !== index) {
+        return null;
+    }
+
+    frame = {
+        frameNo: frameNo,
+        format: format,
+        slotId: view.getUint8(3),
+        values: values
+    };
+
+    return frame;
+};
+
+pixelix.ws.Client.prototype._toDisplayContent = function(frame) {
+    var rsp     = {};
+    var index   = 0;
+    var value   = 0;
+
+    rsp.slotId = frame.slotId;
+    rsp.data = [];
+    for(index = 0; index < frame.values.length; ++index) {
+        value = frame.values[index];
+
+        /* Convert RGB565 to RGB888. */
+        if (1 === frame.format) {
+            value = ((value & 0xf800) << 8) | ((value & 0x07e0) << 5) | ((value & 0x001f) << 3);
+        }
+
+        rsp.data.push(value);
+    }
+
+    return rsp;
+};
+
+pixelix.ws.Client.prototype._onStreamFrame = function(buffer) {
+    var frame = null;
+
+    /* Frames may still arrive after the stream was stopped. */
+    if (null !== this._stream) {
+        frame = this._decodeFrame(buffer, this._streamFrame);
+
+        if (null === frame) {
+            this._streamFrame = null;
+
+            /* Subscribe again to get a key frame. Until then, all delta frames are dropped. */
+            if (false === this._stream.isResyncing) {
+                console.warn("Display stream lost, resynchronizing.");
+                this._stream.isResyncing = true;
+                this._sendCmd({
+                    name: "STREAM",
+                    par: this._stream.par,
+                    resolve: function() {},
+                    reject: function() {}
+                });
+            }
+        } else {
+            this._streamFrame           = frame;
+            this._stream.isResyncing    = false;
+            this._stream.onFrame(this._toDisplayContent(frame));
+        }
+    }
+
+    return;
+};
+
+pixelix.ws.Client.prototype._onBinaryMessage = function(buffer) {
+    var frame   = null;
+
+    /* Stream frames are pushed without request. */
+    if ((2 <= buffer.byteLength) &&
+        (0 !== (new Uint8Array(buffer, 1, 1)[0] & 0x80))) {
+        this._onStreamFrame(buffer);
+    } else if (null === this._pendingCmd) {
+        console.error("No pending command, but response received.");
+    } else if ("GETDISP" !== this._pendingCmd.name) {
+        console.error("Command " + this._pendingCmd.name + " got unexpected binary response.");
+        this._pendingCmd.reject();
+        this._pendingCmd = null;
+    } else {
+        frame = this._decodeFrame(buffer, this._frame);
+
+        if (null === frame) {
+            console.error("Invalid display frame.");
+
+            /* Request a complete frame next time. */
+            this._frame = null;
+            this._pendingCmd.reject();
+        } else {
+            this._frame = frame;
+            this._pendingCmd.resolve(this._toDisplayContent(frame));
+        }
+
+        this._pendingCmd = null;
+    }
+
+    this._sendCmdFromQueue();
+
+    return;
+};
+
+pixelix.ws.Client.prototype.getDisplayContent = function(options) {
     return new Promise(function(resolve, reject) {
+        var pixelFormat = 0;
+        var ackFrameNo  = 0;
+
         if (null === this._socket) {
             reject();
         } else {
+            /* RGB565 halves the size, but loses color depth. */
+            if (("object" === typeof options) &&
+                ("RGB565" === options.pixelFormat)) {
+                pixelFormat = 1;
+            }
+
+            /* Only the difference to the last received frame is sent, if it is acknowledged. */
+            if ((null !== this._frame) &&
+                (pixelFormat === this._frame.format)) {
+                ackFrameNo = this._frame.frameNo;
+            }
+
             this._sendCmd({
                 name: "GETDISP",
-                par: null,
+                par: pixelFormat + ";" + ackFrameNo,
+                resolve: resolve,
+                reject: reject
+            });
+        }
+    }.bind(this));
+};
+
+pixelix.ws.Client.prototype.startDisplayStream = function(options) {
+    return new Promise(function(resolve, reject) {
+        var pixelFormat = 0;
+
+        if (null === this._socket) {
+            reject();
+        } else if (("number" !== typeof options.maxFps) ||
+                   ("function" !== typeof options.onFrame)) {
+            reject();
+        } else {
+            /* RGB565 halves the size, but loses color depth. */
+            if ("RGB565" === options.pixelFormat) {
+                pixelFormat = 1;
+            }
+
+            this._stream = {
+                par: pixelFormat + ";" + options.maxFps,
+                onFrame: options.onFrame,
+                isResyncing: false
+            };
+            this._streamFrame = null;
+
+            this._sendCmd({
+                name: "STREAM",
+                par: this._stream.par,
+                resolve: resolve,
+                reject: function() {
+                    this._stream = null;
+                    reject();
+                }.bind(this)
+            });
+        }
+    }.bind(this));
+};
+
+pixelix.ws.Client.prototype.stopDisplayStream = function() {
+    return new Promise(function(resolve, reject) {
+        if (null === this._socket) {
+            reject();
+        } else {
+            this._stream        = null;
+            this._streamFrame   = null;
+
+            this._sendCmd({
+                name: "STREAM",
+                par: "0;0",
                 resolve: resolve,
                 reject: reject
             });
@@ -0,0 +1,195 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Arduino stuff for test
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "Arduino.h"
+#include "VirtualClock.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Default seed of the pseudo random number generator. */
+static const uint32_t   RANDOM_SEED_DEFAULT = 0x2545F491U;
+
+/** Pseudo random number generator state. */
+static uint32_t         gRandomState        = RANDOM_SEED_DEFAULT;
+
+/** CPU clock in MHz, used to derive the cycle count. */
+static const uint32_t   CPU_CLOCK_MHZ       = 240U;
+
+/** Reported free heap in bytes. */
+static const uint32_t   FREE_HEAP           = 320U * 1024U;
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+uint32_t EspClass::getCycleCount()
+{
+    return static_cast<uint32_t>(VirtualClock::getInstance().getMicros() * CPU_CLOCK_MHZ);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return FREE_HEAP;
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+    return FREE_HEAP;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+EspClass ESP;
+
+unsigned long millis(void)
+{
+    return static_cast<unsigned long>(VirtualClock::getInstance().getMillis());
+}
+
+unsigned long micros(void)
+{
+    return static_cast<unsigned long>(VirtualClock::getInstance().getMicros());
+}
+
+void delay(uint32_t ms)
+{
+    vTaskDelay(ms / portTICK_PERIOD_MS);
+    return;
+}
+
+void randomSeed(unsigned long seed)
+{
+    /* The xorshift generator must never be seeded with 0. */
+    if (0U == seed)
+    {
+        gRandomState = RANDOM_SEED_DEFAULT;
+    }
+    else
+    {
+        gRandomState = static_cast<uint32_t>(seed);
+    }
+
+    return;
+}
+
+long random(long howBig)
+{
+    long value = 0;
+
+    if (0 < howBig)
+    {
+        /* xorshift32 */
+        gRandomState ^= gRandomState << 13U;
+        gRandomState ^= gRandomState >> 17U;
+        gRandomState ^= gRandomState << 5U;
+
+        value = static_cast<long>(gRandomState % static_cast<unsigned long>(howBig));
+    }
+
+    return value;
+}
+
+long random(long howSmall, long howBig)
+{
+    long value = howSmall;
+
+    if (howSmall < howBig)
+    {
+        value = howSmall + random(howBig - howSmall);
+    }
+
+    return value;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+
+    return;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    (void)pin;
+    (void)value;
+
+    return;
+}
+
+int digitalRead(uint8_t pin)
+{
+    (void)pin;
+
+    return LOW;
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+    (void)pin;
+
+    return 0U;
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
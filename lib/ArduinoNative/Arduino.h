@@ -52,14 +52,37 @@
 #include <string.h>
 #include <inttypes.h>
 #include <time.h>
+#include <math.h>
 
 #include "WString.h"
 #include "Print.h"
+#include "FreeRTOS.h"
 
 /******************************************************************************
  * Macros
  *****************************************************************************/
 
+/** Logic level low */
+#define LOW             (0x0)
+
+/** Logic level high */
+#define HIGH            (0x1)
+
+/** Pin mode: Input */
+#define INPUT           (0x01)
+
+/** Pin mode: Output */
+#define OUTPUT          (0x02)
+
+/** Pin mode: Input with pull-up */
+#define INPUT_PULLUP    (0x05)
+
+/** Pin mode: Input with pull-down */
+#define INPUT_PULLDOWN  (0x09)
+
+/** Pin mode: Analog input */
+#define ANALOG          (0xC0)
+
 /******************************************************************************
  * Types and Classes
  *****************************************************************************/
@@ -67,18 +90,151 @@
 /** Arduino boolean */
 typedef bool boolean;
 
+/**
+ * ESP specific functionality, as far as its used by the application.
+ */
+class EspClass
+{
+public:
+
+    /**
+     * Constructs the ESP class.
+     */
+    EspClass()
+    {
+    }
+
+    /**
+     * Destroys the ESP class.
+     */
+    ~EspClass()
+    {
+    }
+
+    /**
+     * Get CPU cycle count. It is derived from the host clock, assuming a
+     * 240 MHz CPU clock. In virtual time it is deterministic.
+     *
+     * @return CPU cycle count
+     */
+    uint32_t getCycleCount();
+
+    /**
+     * Get free heap in bytes. The host has no heap limit, therefore a fixed
+     * value is reported.
+     *
+     * @return Free heap in bytes
+     */
+    uint32_t getFreeHeap();
+
+    /**
+     * Get largest allocatable heap block in bytes. The host has no heap
+     * limit, therefore the free heap is reported.
+     *
+     * @return Largest allocatable heap block in bytes
+     */
+    uint32_t getMaxAllocHeap();
+};
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** ESP specific functionality */
+extern EspClass ESP;
+
 /******************************************************************************
  * Functions
  *****************************************************************************/
 
-static unsigned long millis()
-{
-    clock_t now = clock();
+/**
+ * Get number of ms since start, derived from the host clock.
+ *
+ * @return Number of ms
+ */
+extern unsigned long millis(void);
 
-    return (now * 1000UL) / CLOCKS_PER_SEC;
-}
+/**
+ * Get number of us since start, derived from the host clock.
+ *
+ * @return Number of us
+ */
+extern unsigned long micros(void);
+
+/**
+ * Block the calling task for the given time.
+ *
+ * @param[in] ms    Time in ms
+ */
+extern void delay(uint32_t ms);
 
-static uint32_t esp_log_timestamp(void)
+/**
+ * Seed the pseudo random number generator. The same seed results always in
+ * the same random number sequence.
+ *
+ * @param[in] seed  Seed
+ */
+extern void randomSeed(unsigned long seed);
+
+/**
+ * Get a pseudo random number in the range [0; howBig).
+ *
+ * @param[in] howBig    Upper bound (exclusive)
+ *
+ * @return Random number
+ */
+extern long random(long howBig);
+
+/**
+ * Get a pseudo random number in the range [howSmall; howBig).
+ *
+ * @param[in] howSmall  Lower bound (inclusive)
+ * @param[in] howBig    Upper bound (exclusive)
+ *
+ * @return Random number
+ */
+extern long random(long howSmall, long howBig);
+
+/**
+ * Configure pin mode. There are no pins on the host.
+ *
+ * @param[in] pin   Pin number
+ * @param[in] mode  Pin mode
+ */
+extern void pinMode(uint8_t pin, uint8_t mode);
+
+/**
+ * Write to a digital output pin. There are no pins on the host.
+ *
+ * @param[in] pin   Pin number
+ * @param[in] value Logic level
+ */
+extern void digitalWrite(uint8_t pin, uint8_t value);
+
+/**
+ * Read from a digital pin. There are no pins on the host, it reads always low.
+ *
+ * @param[in] pin   Pin number
+ *
+ * @return Logic level
+ */
+extern int digitalRead(uint8_t pin);
+
+/**
+ * Read from a analog pin. There are no pins on the host, it reads always 0.
+ *
+ * @param[in] pin   Pin number
+ *
+ * @return ADC value in digits
+ */
+extern uint16_t analogRead(uint8_t pin);
+
+/**
+ * Get the timestamp used in log messages.
+ *
+ * @return Timestamp in ms
+ */
+static inline uint32_t esp_log_timestamp(void)
 {
     return millis();
 }
@@ -0,0 +1,607 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  FreeRTOS emulation for the host
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "FreeRTOS.h"
+#include "VirtualClock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/**
+ * Emulated semaphore or mutex.
+ */
+struct HostSemaphore
+{
+    /** Semaphore types */
+    enum Type
+    {
+        TYPE_MUTEX = 0,         /**< Mutex */
+        TYPE_RECURSIVE_MUTEX,   /**< Recursive mutex */
+        TYPE_BINARY             /**< Binary semaphore */
+    };
+
+    Type        type;       /**< Semaphore type */
+    bool        isTaken;    /**< Is semaphore taken or mutex locked? */
+    HostTask*   owner;      /**< Mutex owner */
+    uint32_t    recursion;  /**< Recursive mutex lock counter */
+};
+
+/**
+ * Emulated task.
+ */
+struct HostTask
+{
+    TaskFunction_t  func;       /**< Task function */
+    void*           parameters; /**< Task function parameters */
+    uint64_t        wakeUp;     /**< Point in time in us, when the task shall continue. */
+    uint64_t        order;      /**< Sequence number of the last block, used to schedule tasks with same wake-up time fair. */
+    HostSemaphore*  waitFor;    /**< Semaphore the task is waiting for. */
+    bool            isDeleted;  /**< Is task deleted? */
+};
+
+/**
+ * Scheduler context. Only the task, which holds the baton (running task),
+ * is allowed to run.
+ */
+struct Scheduler
+{
+    std::mutex                  mutex;      /**< Protects the scheduler context. */
+    std::condition_variable     cond;       /**< Used to pass the baton. */
+    std::vector<HostTask*>      tasks;      /**< All known tasks. */
+    HostTask*                   running;    /**< Running task */
+    uint64_t                    order;      /**< Block sequence counter */
+
+    /**
+     * Constructs the scheduler context.
+     */
+    Scheduler() :
+        mutex(),
+        cond(),
+        tasks(),
+        running(nullptr),
+        order(0U)
+    {
+    }
+};
+
+/** Scheduler lock type */
+typedef std::unique_lock<std::mutex> SchedulerLock;
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static Scheduler& getScheduler(void);
+static HostTask* getCurrentTask(Scheduler& scheduler);
+static void switchTask(Scheduler& scheduler, SchedulerLock& lock, HostTask* self);
+static void wakeUpWaitingTasks(Scheduler& scheduler, HostSemaphore* semaphore);
+static bool isAvailable(const HostSemaphore* semaphore, const HostTask* task);
+static SemaphoreHandle_t createSemaphore(HostSemaphore::Type type);
+static BaseType_t takeSemaphore(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+static BaseType_t giveSemaphore(SemaphoreHandle_t semaphore);
+static void taskEntry(HostTask* task);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Wake-up time of a task, which waits without timeout. */
+static const uint64_t       WAKE_UP_NEVER   = UINT64_MAX;
+
+/** Task which is executed by the current thread. */
+static thread_local HostTask*   gCurrentTask    = nullptr;
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return createSemaphore(HostSemaphore::TYPE_MUTEX);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return createSemaphore(HostSemaphore::TYPE_RECURSIVE_MUTEX);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    SemaphoreHandle_t semaphore = createSemaphore(HostSemaphore::TYPE_BINARY);
+
+    if (nullptr != semaphore)
+    {
+        /* A binary semaphore is created empty. */
+        semaphore->isTaken = true;
+    }
+
+    return semaphore;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    if (nullptr != semaphore)
+    {
+        delete semaphore;
+    }
+
+    return;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    return takeSemaphore(semaphore, ticksToWait);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return giveSemaphore(semaphore);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    return takeSemaphore(semaphore, ticksToWait);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore)
+{
+    return giveSemaphore(semaphore);
+}
+
+BaseType_t xTaskCreateUniversal(TaskFunction_t taskFunc, const char* name, uint32_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* taskHandle, BaseType_t coreId)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+    HostTask*       task        = nullptr;
+
+    (void)name;
+    (void)stackSize;
+    (void)priority;
+    (void)coreId;
+
+    if (nullptr == taskFunc)
+    {
+        return pdFAIL;
+    }
+
+    /* Ensure that the creator is known, before the new task is scheduled. */
+    (void)getCurrentTask(scheduler);
+
+    task = new HostTask();
+
+    task->func          = taskFunc;
+    task->parameters    = parameters;
+    task->wakeUp        = VirtualClock::getInstance().getMicros();
+    task->order         = ++scheduler.order;
+    task->waitFor       = nullptr;
+    task->isDeleted     = false;
+
+    scheduler.tasks.push_back(task);
+
+    /* The thread waits until the task gets the baton. */
+    std::thread(taskEntry, task).detach();
+
+    if (nullptr != taskHandle)
+    {
+        *taskHandle = task;
+    }
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunc, const char* name, uint32_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* taskHandle, BaseType_t coreId)
+{
+    return xTaskCreateUniversal(taskFunc, name, stackSize, parameters, priority, taskHandle, coreId);
+}
+
+void vTaskDelete(TaskHandle_t taskHandle)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+    HostTask*       self        = getCurrentTask(scheduler);
+
+    if ((nullptr == taskHandle) ||
+        (self == taskHandle))
+    {
+        self->isDeleted = true;
+
+        /* Pass the baton to the next task. The caller returns from its
+         * task function afterwards, which ends the thread.
+         */
+        switchTask(scheduler, lock, self);
+    }
+    else
+    {
+        /* The thread of the deleted task will never get the baton again. */
+        taskHandle->isDeleted = true;
+    }
+
+    return;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+
+    return getCurrentTask(scheduler);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+    HostTask*       self        = getCurrentTask(scheduler);
+
+    self->wakeUp    = VirtualClock::getInstance().getMicros() + (static_cast<uint64_t>(ticks) * portTICK_PERIOD_MS * 1000U);
+    self->order     = ++scheduler.order;
+
+    switchTask(scheduler, lock, self);
+
+    return;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return static_cast<TickType_t>(VirtualClock::getInstance().getMillis() / portTICK_PERIOD_MS);
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Get scheduler context.
+ * It is never destroyed, because detached task threads may still wait for
+ * the baton, when the application exits.
+ *
+ * @return Scheduler context
+ */
+static Scheduler& getScheduler(void)
+{
+    static Scheduler* scheduler = new Scheduler();
+
+    return *scheduler;
+}
+
+/**
+ * Get the task, which is executed by the calling thread. A thread which is
+ * not known yet (e.g. the main thread) is registered as task.
+ * The scheduler lock must be held.
+ *
+ * @param[in] scheduler Scheduler context
+ *
+ * @return Task of the calling thread
+ */
+static HostTask* getCurrentTask(Scheduler& scheduler)
+{
+    if (nullptr == gCurrentTask)
+    {
+        HostTask* task = new HostTask();
+
+        task->func          = nullptr;
+        task->parameters    = nullptr;
+        task->wakeUp        = VirtualClock::getInstance().getMicros();
+        task->order         = ++scheduler.order;
+        task->waitFor       = nullptr;
+        task->isDeleted     = false;
+
+        scheduler.tasks.push_back(task);
+
+        if (nullptr == scheduler.running)
+        {
+            scheduler.running = task;
+        }
+
+        gCurrentTask = task;
+    }
+
+    return gCurrentTask;
+}
+
+/**
+ * Pass the baton to the task with the earliest wake-up time and wait until
+ * the calling task gets it back. The clock is advanced to the wake-up time of
+ * the next task. A deleted task returns immediately.
+ * The scheduler lock must be held.
+ *
+ * @param[in] scheduler Scheduler context
+ * @param[in] lock      Scheduler lock
+ * @param[in] self      Calling task
+ */
+static void switchTask(Scheduler& scheduler, SchedulerLock& lock, HostTask* self)
+{
+    HostTask*   next    = nullptr;
+    size_t      index   = 0U;
+
+    for(index = 0U; index < scheduler.tasks.size(); ++index)
+    {
+        HostTask* task = scheduler.tasks[index];
+
+        if ((false == task->isDeleted) &&
+            (WAKE_UP_NEVER != task->wakeUp))
+        {
+            if ((nullptr == next) ||
+                (task->wakeUp < next->wakeUp) ||
+                ((task->wakeUp == next->wakeUp) && (task->order < next->order)))
+            {
+                next = task;
+            }
+        }
+    }
+
+    if (nullptr == next)
+    {
+        /* Every task waits without timeout, nobody will ever wake them up. */
+        fprintf(stderr, "FreeRTOS emulation: Deadlock, all tasks are blocked.\n");
+        abort();
+    }
+
+    VirtualClock::getInstance().advanceTo(next->wakeUp);
+
+    scheduler.running = next;
+    scheduler.cond.notify_all();
+
+    if (false == self->isDeleted)
+    {
+        scheduler.cond.wait(lock, [&scheduler, self]{ return self == scheduler.running; });
+    }
+
+    return;
+}
+
+/**
+ * Make all tasks ready, which wait for the given semaphore.
+ * The scheduler lock must be held.
+ *
+ * @param[in] scheduler Scheduler context
+ * @param[in] semaphore Semaphore
+ */
+static void wakeUpWaitingTasks(Scheduler& scheduler, HostSemaphore* semaphore)
+{
+    size_t      index   = 0U;
+    uint64_t    now     = VirtualClock::getInstance().getMicros();
+
+    for(index = 0U; index < scheduler.tasks.size(); ++index)
+    {
+        HostTask* task = scheduler.tasks[index];
+
+        if (semaphore == task->waitFor)
+        {
+            task->wakeUp    = now;
+            task->order     = ++scheduler.order;
+            task->waitFor   = nullptr;
+        }
+    }
+
+    return;
+}
+
+/**
+ * Is the semaphore available for the given task?
+ *
+ * @param[in] semaphore Semaphore
+ * @param[in] task      Task which wants to take it.
+ *
+ * @return If available, it will return true otherwise false.
+ */
+static bool isAvailable(const HostSemaphore* semaphore, const HostTask* task)
+{
+    bool isAvailable = (false == semaphore->isTaken);
+
+    if ((HostSemaphore::TYPE_RECURSIVE_MUTEX == semaphore->type) &&
+        (task == semaphore->owner))
+    {
+        isAvailable = true;
+    }
+
+    return isAvailable;
+}
+
+/**
+ * Create a semaphore.
+ *
+ * @param[in] type  Semaphore type
+ *
+ * @return Semaphore handle
+ */
+static SemaphoreHandle_t createSemaphore(HostSemaphore::Type type)
+{
+    HostSemaphore* semaphore = new HostSemaphore();
+
+    semaphore->type         = type;
+    semaphore->isTaken      = false;
+    semaphore->owner        = nullptr;
+    semaphore->recursion    = 0U;
+
+    return semaphore;
+}
+
+/**
+ * Take a semaphore. If it is not available, the calling task blocks until
+ * it is given or the timeout elapsed.
+ *
+ * @param[in] semaphore     Semaphore
+ * @param[in] ticksToWait   Max. number of ticks to wait
+ *
+ * @return If taken, it will return pdTRUE otherwise pdFALSE.
+ */
+static BaseType_t takeSemaphore(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+    HostTask*       self        = getCurrentTask(scheduler);
+    uint64_t        deadline    = WAKE_UP_NEVER;
+
+    if (nullptr == semaphore)
+    {
+        return pdFALSE;
+    }
+
+    if (portMAX_DELAY != ticksToWait)
+    {
+        deadline = VirtualClock::getInstance().getMicros() + (static_cast<uint64_t>(ticksToWait) * portTICK_PERIOD_MS * 1000U);
+    }
+
+    while(false == isAvailable(semaphore, self))
+    {
+        if ((WAKE_UP_NEVER != deadline) &&
+            (deadline <= VirtualClock::getInstance().getMicros()))
+        {
+            self->waitFor = nullptr;
+            return pdFALSE;
+        }
+
+        self->wakeUp    = deadline;
+        self->order     = ++scheduler.order;
+        self->waitFor   = semaphore;
+
+        switchTask(scheduler, lock, self);
+    }
+
+    self->waitFor       = nullptr;
+    semaphore->isTaken  = true;
+
+    if (HostSemaphore::TYPE_BINARY != semaphore->type)
+    {
+        semaphore->owner = self;
+        ++semaphore->recursion;
+    }
+
+    return pdTRUE;
+}
+
+/**
+ * Give a semaphore. Tasks which wait for it, become ready, but the calling
+ * task keeps running.
+ *
+ * @param[in] semaphore Semaphore
+ *
+ * @return If given, it will return pdTRUE otherwise pdFALSE.
+ */
+static BaseType_t giveSemaphore(SemaphoreHandle_t semaphore)
+{
+    Scheduler&      scheduler   = getScheduler();
+    SchedulerLock   lock(scheduler.mutex);
+    HostTask*       self        = getCurrentTask(scheduler);
+
+    if ((nullptr == semaphore) ||
+        (false == semaphore->isTaken))
+    {
+        return pdFALSE;
+    }
+
+    if (HostSemaphore::TYPE_BINARY != semaphore->type)
+    {
+        /* Only the owner is allowed to unlock a mutex. */
+        if (self != semaphore->owner)
+        {
+            return pdFALSE;
+        }
+
+        --semaphore->recursion;
+
+        if (0U < semaphore->recursion)
+        {
+            return pdTRUE;
+        }
+
+        semaphore->owner = nullptr;
+    }
+
+    semaphore->isTaken = false;
+    wakeUpWaitingTasks(scheduler, semaphore);
+
+    return pdTRUE;
+}
+
+/**
+ * Entry of every task thread.
+ *
+ * @param[in] task  Task
+ */
+static void taskEntry(HostTask* task)
+{
+    Scheduler& scheduler = getScheduler();
+
+    {
+        SchedulerLock lock(scheduler.mutex);
+
+        gCurrentTask = task;
+        scheduler.cond.wait(lock, [&scheduler, task]{ return task == scheduler.running; });
+    }
+
+    task->func(task->parameters);
+
+    {
+        SchedulerLock lock(scheduler.mutex);
+
+        /* Task function returned without deleting itself? */
+        if (false == task->isDeleted)
+        {
+            task->isDeleted = true;
+            switchTask(scheduler, lock, task);
+        }
+    }
+
+    return;
+}
@@ -0,0 +1,245 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  FreeRTOS emulation for the host
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ *
+ * Only the subset of the FreeRTOS API is provided, which is used by the
+ * application modules that are built for the host.
+ *
+ * The tasks are mapped to host threads, but they are scheduled cooperatively:
+ * only one task runs at a time and a task gives up the processor only when it
+ * blocks (delay, semaphore). The task which shall run next is the one with the
+ * earliest wake-up time, tasks with the same wake-up time are scheduled in the
+ * order they blocked. Together with the virtual clock this makes every run
+ * deterministic.
+ */
+
+#ifndef __FREERTOS_H__
+#define __FREERTOS_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/** Successful */
+#define pdPASS                  (1)
+
+/** Failed */
+#define pdFAIL                  (0)
+
+/** True */
+#define pdTRUE                  (1)
+
+/** False */
+#define pdFALSE                 (0)
+
+/** Block forever */
+#define portMAX_DELAY           (UINT32_MAX)
+
+/** Duration of one tick in ms. */
+#define portTICK_PERIOD_MS      (1U)
+
+/** Convert ms to ticks */
+#define pdMS_TO_TICKS(__ms)     (static_cast<TickType_t>(__ms) / portTICK_PERIOD_MS)
+
+/** Task is not pinned to a core. */
+#define tskNO_AFFINITY          (0x7FFFFFFF)
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/** Base type */
+typedef int32_t         BaseType_t;
+
+/** Unsigned base type */
+typedef uint32_t        UBaseType_t;
+
+/** Tick type */
+typedef uint32_t        TickType_t;
+
+/** Task function */
+typedef void (*TaskFunction_t)(void* parameters);
+
+/** Opaque semaphore/mutex */
+struct HostSemaphore;
+
+/** Opaque task */
+struct HostTask;
+
+/** Semaphore handle */
+typedef HostSemaphore*  SemaphoreHandle_t;
+
+/** Task handle */
+typedef HostTask*       TaskHandle_t;
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+/**
+ * Create a mutex.
+ *
+ * @return Mutex handle or nullptr.
+ */
+extern SemaphoreHandle_t xSemaphoreCreateMutex(void);
+
+/**
+ * Create a recursive mutex.
+ *
+ * @return Mutex handle or nullptr.
+ */
+extern SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+
+/**
+ * Create a binary semaphore. It is created in the empty state.
+ *
+ * @return Semaphore handle or nullptr.
+ */
+extern SemaphoreHandle_t xSemaphoreCreateBinary(void);
+
+/**
+ * Delete a semaphore/mutex.
+ *
+ * @param[in] semaphore Semaphore handle
+ */
+extern void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+/**
+ * Take a semaphore or mutex.
+ *
+ * @param[in] semaphore     Semaphore handle
+ * @param[in] ticksToWait   Max. number of ticks to wait
+ *
+ * @return If taken, it will return pdTRUE otherwise pdFALSE.
+ */
+extern BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+
+/**
+ * Give a semaphore or mutex.
+ *
+ * @param[in] semaphore     Semaphore handle
+ *
+ * @return If given, it will return pdTRUE otherwise pdFALSE.
+ */
+extern BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+/**
+ * Take a recursive mutex.
+ *
+ * @param[in] semaphore     Mutex handle
+ * @param[in] ticksToWait   Max. number of ticks to wait
+ *
+ * @return If taken, it will return pdTRUE otherwise pdFALSE.
+ */
+extern BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+
+/**
+ * Give a recursive mutex.
+ *
+ * @param[in] semaphore     Mutex handle
+ *
+ * @return If given, it will return pdTRUE otherwise pdFALSE.
+ */
+extern BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+
+/**
+ * Create a task. The core affinity is ignored on the host.
+ *
+ * @param[in]   taskFunc    Task function
+ * @param[in]   name        Task name
+ * @param[in]   stackSize   Stack size in byte (ignored)
+ * @param[in]   parameters  Task parameters
+ * @param[in]   priority    Task priority (ignored)
+ * @param[out]  taskHandle  Task handle
+ * @param[in]   coreId      Core id (ignored)
+ *
+ * @return If successful created, it will return pdPASS otherwise pdFAIL.
+ */
+extern BaseType_t xTaskCreateUniversal(TaskFunction_t taskFunc, const char* name, uint32_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* taskHandle, BaseType_t coreId);
+
+/**
+ * Create a task pinned to a core. The core affinity is ignored on the host.
+ *
+ * @param[in]   taskFunc    Task function
+ * @param[in]   name        Task name
+ * @param[in]   stackSize   Stack size in byte (ignored)
+ * @param[in]   parameters  Task parameters
+ * @param[in]   priority    Task priority (ignored)
+ * @param[out]  taskHandle  Task handle
+ * @param[in]   coreId      Core id (ignored)
+ *
+ * @return If successful created, it will return pdPASS otherwise pdFAIL.
+ */
+extern BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunc, const char* name, uint32_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* taskHandle, BaseType_t coreId);
+
+/**
+ * Delete a task. If nullptr is given, the calling task will be deleted and
+ * the task function shall return afterwards.
+ *
+ * @param[in] taskHandle    Task handle
+ */
+extern void vTaskDelete(TaskHandle_t taskHandle);
+
+/**
+ * Get the handle of the calling task.
+ *
+ * @return Task handle
+ */
+extern TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+/**
+ * Block the calling task for the given number of ticks.
+ *
+ * @param[in] ticks Number of ticks
+ */
+extern void vTaskDelay(TickType_t ticks);
+
+/**
+ * Get number of ticks since start.
+ *
+ * @return Ticks
+ */
+extern TickType_t xTaskGetTickCount(void);
+
+#endif  /* __FREERTOS_H__ */
+
+/** @} */
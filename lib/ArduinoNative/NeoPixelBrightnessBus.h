@@ -0,0 +1,480 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Virtual LED strip for the host, which replaces the NeoPixelBus
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ *
+ * Only the subset of the NeoPixelBus library is provided, which is used by
+ * the LED matrix. The pixels are kept in RAM and every Show() is reported
+ * to a registered show hook, e.g. to record the frames.
+ */
+
+#ifndef __NEOPIXELBRIGHTNESSBUS_H__
+#define __NEOPIXELBRIGHTNESSBUS_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+struct HtmlColor;
+
+/**
+ * RGB color with 8 bit per base color.
+ */
+struct RgbColor
+{
+    uint8_t R;  /**< Red */
+    uint8_t G;  /**< Green */
+    uint8_t B;  /**< Blue */
+
+    /**
+     * Constructs a gray color.
+     *
+     * @param[in] brightness    Brightness of all base colors
+     */
+    RgbColor(uint8_t brightness = 0U) :
+        R(brightness),
+        G(brightness),
+        B(brightness)
+    {
+    }
+
+    /**
+     * Constructs a color.
+     *
+     * @param[in] r Red
+     * @param[in] g Green
+     * @param[in] b Blue
+     */
+    RgbColor(uint8_t r, uint8_t g, uint8_t b) :
+        R(r),
+        G(g),
+        B(b)
+    {
+    }
+
+    /**
+     * Constructs a color by HTML color.
+     *
+     * @param[in] color HTML color
+     */
+    RgbColor(const HtmlColor& color);
+
+    /**
+     * Dim the color.
+     *
+     * @param[in] ratio Dim ratio [0; 255], 255 means no change.
+     *
+     * @return Dimmed color
+     */
+    RgbColor Dim(uint8_t ratio) const
+    {
+        return RgbColor(dim(R, ratio), dim(G, ratio), dim(B, ratio));
+    }
+
+private:
+
+    /**
+     * Dim a single base color.
+     *
+     * @param[in] value Base color value
+     * @param[in] ratio Dim ratio [0; 255]
+     *
+     * @return Dimmed base color value
+     */
+    static uint8_t dim(uint8_t value, uint8_t ratio)
+    {
+        return static_cast<uint8_t>((static_cast<uint16_t>(value) * (static_cast<uint16_t>(ratio) + 1U)) >> 8U);
+    }
+};
+
+/**
+ * HTML color in RGB888 format.
+ */
+struct HtmlColor
+{
+    uint32_t Color; /**< Color in RGB888 format */
+
+    /**
+     * Constructs a HTML color.
+     *
+     * @param[in] color Color in RGB888 format
+     */
+    HtmlColor(uint32_t color = 0U) :
+        Color(color)
+    {
+    }
+
+    /**
+     * Constructs a HTML color by RGB color.
+     *
+     * @param[in] color RGB color
+     */
+    HtmlColor(const RgbColor& color) :
+        Color((static_cast<uint32_t>(color.R) << 16U) | (static_cast<uint32_t>(color.G) << 8U) | static_cast<uint32_t>(color.B))
+    {
+    }
+};
+
+inline RgbColor::RgbColor(const HtmlColor& color) :
+    R(static_cast<uint8_t>((color.Color >> 16U) & 0xFFU)),
+    G(static_cast<uint8_t>((color.Color >>  8U) & 0xFFU)),
+    B(static_cast<uint8_t>((color.Color >>  0U) & 0xFFU))
+{
+}
+
+/** Color feature GRB (no function on the host) */
+struct NeoGrbFeature
+{
+    typedef RgbColor ColorObject; /**< Color object */
+};
+
+/** 800 kbps method (no function on the host) */
+struct Neo800KbpsMethod
+{
+};
+
+/**
+ * Column major alternating layout.
+ */
+class ColumnMajorAlternatingLayout
+{
+public:
+
+    /**
+     * Map coordinates to the pixel index.
+     *
+     * @param[in] width     Panel width
+     * @param[in] height    Panel height
+     * @param[in] x         x-coordinate
+     * @param[in] y         y-coordinate
+     *
+     * @return Pixel index
+     */
+    static uint16_t Map(uint16_t width, uint16_t height, uint16_t x, uint16_t y)
+    {
+        uint16_t index = x * height;
+
+        (void)width;
+
+        if (0U != (x & 0x0001U))
+        {
+            index += ((height - 1U) - y);
+        }
+        else
+        {
+            index += y;
+        }
+
+        return index;
+    }
+};
+
+/**
+ * Panel topology.
+ *
+ * @tparam T_LAYOUT Pixel layout
+ */
+template < typename T_LAYOUT >
+class NeoTopology
+{
+public:
+
+    /**
+     * Constructs the topology.
+     *
+     * @param[in] width     Panel width
+     * @param[in] height    Panel height
+     */
+    NeoTopology(uint16_t width, uint16_t height) :
+        m_width(width),
+        m_height(height)
+    {
+    }
+
+    /**
+     * Map coordinates to the pixel index.
+     *
+     * @param[in] x x-coordinate
+     * @param[in] y y-coordinate
+     *
+     * @return Pixel index
+     */
+    uint16_t Map(int16_t x, int16_t y) const
+    {
+        uint16_t index = 0U;
+
+        if ((0 <= x) && (m_width > x) && (0 <= y) && (m_height > y))
+        {
+            index = T_LAYOUT::Map(m_width, m_height, x, y);
+        }
+
+        return index;
+    }
+
+private:
+
+    const uint16_t  m_width;    /**< Panel width */
+    const uint16_t  m_height;   /**< Panel height */
+};
+
+/**
+ * The show hook is called after every Show() of any virtual LED strip.
+ */
+class NeoPixelShowHook
+{
+public:
+
+    /** Show hook function */
+    typedef void (*Func)(void* arg);
+
+    /**
+     * Register a show hook. Only one hook is supported, a previous one
+     * will be replaced.
+     *
+     * @param[in] func  Show hook function, use nullptr to unregister.
+     * @param[in] arg   Argument, which is passed to the hook function.
+     */
+    static void set(Func func, void* arg)
+    {
+        Hook& hook = getHook();
+
+        hook.func   = func;
+        hook.arg    = arg;
+
+        return;
+    }
+
+    /**
+     * Call the registered show hook, if there is one.
+     */
+    static void call()
+    {
+        Hook& hook = getHook();
+
+        if (nullptr != hook.func)
+        {
+            hook.func(hook.arg);
+        }
+
+        return;
+    }
+
+private:
+
+    /** Registered hook */
+    struct Hook
+    {
+        Func    func;   /**< Hook function */
+        void*   arg;    /**< Hook function argument */
+    };
+
+    /**
+     * Get registered hook.
+     *
+     * @return Hook
+     */
+    static Hook& getHook()
+    {
+        static Hook hook = { nullptr, nullptr };
+
+        return hook;
+    }
+
+    NeoPixelShowHook();
+    ~NeoPixelShowHook();
+};
+
+/**
+ * Virtual LED strip.
+ * The brightness is not applied to the stored pixels, so they contain the
+ * colors like drawn by the application.
+ *
+ * @tparam T_COLOR_FEATURE  Color feature
+ * @tparam T_METHOD         Transfer method
+ */
+template < typename T_COLOR_FEATURE, typename T_METHOD >
+class NeoPixelBrightnessBus
+{
+public:
+
+    /**
+     * Constructs the virtual LED strip.
+     *
+     * @param[in] countPixels   Number of pixels
+     * @param[in] pin           Data out pin (ignored)
+     */
+    NeoPixelBrightnessBus(uint16_t countPixels, uint8_t pin) :
+        m_countPixels(countPixels),
+        m_pixels(new RgbColor[countPixels]),
+        m_brightness(UINT8_MAX)
+    {
+        (void)pin;
+    }
+
+    /**
+     * Destroys the virtual LED strip.
+     */
+    ~NeoPixelBrightnessBus()
+    {
+        delete[] m_pixels;
+    }
+
+    /**
+     * Initialize the strip.
+     */
+    void Begin()
+    {
+        return;
+    }
+
+    /**
+     * Show the pixels. It will call the registered show hook.
+     */
+    void Show()
+    {
+        NeoPixelShowHook::call();
+        return;
+    }
+
+    /**
+     * The virtual strip is always ready.
+     *
+     * @return true
+     */
+    bool CanShow() const
+    {
+        return true;
+    }
+
+    /**
+     * Set brightness.
+     *
+     * @param[in] brightness    Brightness [0; 255]
+     */
+    void SetBrightness(uint8_t brightness)
+    {
+        m_brightness = brightness;
+        return;
+    }
+
+    /**
+     * Get brightness.
+     *
+     * @return Brightness [0; 255]
+     */
+    uint8_t GetBrightness() const
+    {
+        return m_brightness;
+    }
+
+    /**
+     * Set all pixels to the given color.
+     *
+     * @param[in] color Color
+     */
+    void ClearTo(typename T_COLOR_FEATURE::ColorObject color)
+    {
+        uint16_t index = 0U;
+
+        for(index = 0U; index < m_countPixels; ++index)
+        {
+            m_pixels[index] = color;
+        }
+
+        return;
+    }
+
+    /**
+     * Set pixel color.
+     *
+     * @param[in] index Pixel index
+     * @param[in] color Color
+     */
+    void SetPixelColor(uint16_t index, typename T_COLOR_FEATURE::ColorObject color)
+    {
+        if (m_countPixels > index)
+        {
+            m_pixels[index] = color;
+        }
+
+        return;
+    }
+
+    /**
+     * Get pixel color.
+     *
+     * @param[in] index Pixel index
+     *
+     * @return Color
+     */
+    typename T_COLOR_FEATURE::ColorObject GetPixelColor(uint16_t index) const
+    {
+        typename T_COLOR_FEATURE::ColorObject color;
+
+        if (m_countPixels > index)
+        {
+            color = m_pixels[index];
+        }
+
+        return color;
+    }
+
+private:
+
+    const uint16_t  m_countPixels;  /**< Number of pixels */
+    RgbColor*       m_pixels;       /**< Pixels */
+    uint8_t         m_brightness;   /**< Brightness */
+
+    NeoPixelBrightnessBus(const NeoPixelBrightnessBus& bus);
+    NeoPixelBrightnessBus& operator=(const NeoPixelBrightnessBus& bus);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __NEOPIXELBRIGHTNESSBUS_H__ */
+
+/** @} */
@@ -0,0 +1,340 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Preferences for test, kept in RAM only
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __PREFERENCES_H__
+#define __PREFERENCES_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "WString.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Preferences, which are kept in RAM. Every key which was never written
+ * returns the given default value, like on a freshly erased flash.
+ */
+class Preferences
+{
+public:
+
+    /**
+     * Constructs the preferences.
+     */
+    Preferences() :
+        m_isOpen(false),
+        m_isReadOnly(true),
+        m_values()
+    {
+    }
+
+    /**
+     * Destroys the preferences.
+     */
+    ~Preferences()
+    {
+    }
+
+    /**
+     * Open namespace. Only one namespace is supported.
+     *
+     * @param[in] name      Namespace
+     * @param[in] readOnly  Open read only or read/write
+     *
+     * @return If successful opened, it will return true otherwise false.
+     */
+    bool begin(const char* name, bool readOnly = false)
+    {
+        (void)name;
+
+        m_isOpen        = true;
+        m_isReadOnly    = readOnly;
+
+        return true;
+    }
+
+    /**
+     * Close namespace.
+     */
+    void end()
+    {
+        m_isOpen = false;
+        return;
+    }
+
+    /**
+     * Remove all keys.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool clear()
+    {
+        bool isSuccessful = false;
+
+        if ((true == m_isOpen) &&
+            (false == m_isReadOnly))
+        {
+            m_values.clear();
+            isSuccessful = true;
+        }
+
+        return isSuccessful;
+    }
+
+    /**
+     * Get boolean value.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    bool getBool(const char* key, bool defaultValue = false)
+    {
+        return (0 != getNumber(key, defaultValue ? 1 : 0));
+    }
+
+    /**
+     * Get unsigned 8-bit value.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0)
+    {
+        return static_cast<uint8_t>(getNumber(key, defaultValue));
+    }
+
+    /**
+     * Get signed 32-bit value.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    int32_t getInt(const char* key, int32_t defaultValue = 0)
+    {
+        return static_cast<int32_t>(getNumber(key, defaultValue));
+    }
+
+    /**
+     * Get unsigned 32-bit value.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0)
+    {
+        return static_cast<uint32_t>(getNumber(key, defaultValue));
+    }
+
+    /**
+     * Get string value.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    String getString(const char* key, const String defaultValue = String())
+    {
+        String                                      value   = defaultValue;
+        std::map<std::string, std::string>::iterator it     = m_values.find(key);
+
+        if ((true == m_isOpen) &&
+            (m_values.end() != it))
+        {
+            value = it->second.c_str();
+        }
+
+        return value;
+    }
+
+    /**
+     * Put boolean value.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     *
+     * @return Number of written bytes.
+     */
+    size_t putBool(const char* key, bool value)
+    {
+        return putNumber(key, value ? 1 : 0, sizeof(uint8_t));
+    }
+
+    /**
+     * Put unsigned 8-bit value.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     *
+     * @return Number of written bytes.
+     */
+    size_t putUChar(const char* key, uint8_t value)
+    {
+        return putNumber(key, value, sizeof(value));
+    }
+
+    /**
+     * Put signed 32-bit value.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     *
+     * @return Number of written bytes.
+     */
+    size_t putInt(const char* key, int32_t value)
+    {
+        return putNumber(key, value, sizeof(value));
+    }
+
+    /**
+     * Put unsigned 32-bit value.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     *
+     * @return Number of written bytes.
+     */
+    size_t putUInt(const char* key, uint32_t value)
+    {
+        return putNumber(key, value, sizeof(value));
+    }
+
+    /**
+     * Put string value.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     *
+     * @return Number of written bytes.
+     */
+    size_t putString(const char* key, const String& value)
+    {
+        size_t written = 0U;
+
+        if ((true == m_isOpen) &&
+            (false == m_isReadOnly))
+        {
+            m_values[key]   = value.c_str();
+            written         = value.length();
+        }
+
+        return written;
+    }
+
+private:
+
+    bool                                m_isOpen;       /**< Is namespace open? */
+    bool                                m_isReadOnly;   /**< Is namespace open read only? */
+    std::map<std::string, std::string>  m_values;       /**< Key value pairs */
+
+    Preferences(const Preferences& pref);
+    Preferences& operator=(const Preferences& pref);
+
+    /**
+     * Get number.
+     *
+     * @param[in] key           Key
+     * @param[in] defaultValue  Value used if key doesn't exist.
+     *
+     * @return Value
+     */
+    int64_t getNumber(const char* key, int64_t defaultValue)
+    {
+        int64_t                                     value   = defaultValue;
+        std::map<std::string, std::string>::iterator it     = m_values.find(key);
+
+        if ((true == m_isOpen) &&
+            (m_values.end() != it))
+        {
+            value = strtoll(it->second.c_str(), nullptr, 10);
+        }
+
+        return value;
+    }
+
+    /**
+     * Put number.
+     *
+     * @param[in] key   Key
+     * @param[in] value Value
+     * @param[in] size  Size of the value type in bytes.
+     *
+     * @return Number of written bytes.
+     */
+    size_t putNumber(const char* key, int64_t value, size_t size)
+    {
+        size_t written = 0U;
+
+        if ((true == m_isOpen) &&
+            (false == m_isReadOnly))
+        {
+            m_values[key]   = std::to_string(static_cast<long long>(value));
+            written         = size;
+        }
+
+        return written;
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __PREFERENCES_H__ */
+
+/** @} */
@@ -0,0 +1,124 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Host clock, which runs either in real-time or in virtual time
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "VirtualClock.h"
+
+#include <thread>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void VirtualClock::setMode(Mode mode)
+{
+    if (mode != m_mode)
+    {
+        uint64_t now = getMicros();
+
+        m_start     = WallClock::now();
+        m_offset    = now;
+        m_mode      = mode;
+    }
+
+    return;
+}
+
+uint64_t VirtualClock::getMicros() const
+{
+    uint64_t timestamp = m_offset;
+
+    if (MODE_REALTIME == m_mode)
+    {
+        WallClock::duration elapsed = WallClock::now() - m_start;
+
+        timestamp += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+
+    return timestamp;
+}
+
+void VirtualClock::advanceTo(uint64_t timestamp)
+{
+    uint64_t now = getMicros();
+
+    if (now < timestamp)
+    {
+        if (MODE_VIRTUAL == m_mode)
+        {
+            m_offset = timestamp;
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(timestamp - now));
+        }
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,171 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Host clock, which runs either in real-time or in virtual time
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup test
+ *
+ * @{
+ */
+
+#ifndef __VIRTUALCLOCK_H__
+#define __VIRTUALCLOCK_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The host clock is the time base for millis(), delay() and the FreeRTOS
+ * emulation on the host.
+ *
+ * In real-time mode it follows the monotonic wall clock. In virtual mode the
+ * time stands still, until the scheduler advances it to the next point in time
+ * where a task wakes up. This makes a simulation deterministic and independent
+ * of the host performance.
+ */
+class VirtualClock
+{
+public:
+
+    /** Clock modes */
+    enum Mode
+    {
+        MODE_REALTIME = 0,  /**< Time follows the monotonic wall clock. */
+        MODE_VIRTUAL        /**< Time is advanced by the scheduler only. */
+    };
+
+    /**
+     * Get virtual clock instance.
+     *
+     * @return Virtual clock
+     */
+    static VirtualClock& getInstance()
+    {
+        static VirtualClock instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Select clock mode. The current time is kept, so the time never jumps
+     * backwards on a mode change.
+     *
+     * @param[in] mode  Clock mode
+     */
+    void setMode(Mode mode);
+
+    /**
+     * Get clock mode.
+     *
+     * @return Clock mode
+     */
+    Mode getMode() const
+    {
+        return m_mode;
+    }
+
+    /**
+     * Get time in us since the clock started.
+     *
+     * @return Time in us
+     */
+    uint64_t getMicros() const;
+
+    /**
+     * Get time in ms since the clock started.
+     *
+     * @return Time in ms
+     */
+    uint64_t getMillis() const
+    {
+        return getMicros() / 1000U;
+    }
+
+    /**
+     * Advance the clock to the given point in time.
+     * In virtual mode the time is set immediately, in real-time mode the
+     * calling thread sleeps until the point in time is reached.
+     * A point in time in the past is ignored.
+     *
+     * @param[in] timestamp Point in time in us
+     */
+    void advanceTo(uint64_t timestamp);
+
+private:
+
+    /** Monotonic wall clock */
+    typedef std::chrono::steady_clock   WallClock;
+
+    Mode                    m_mode;         /**< Clock mode */
+    WallClock::time_point   m_start;        /**< Wall clock time, which corresponds to the offset. */
+    std::atomic<uint64_t>   m_offset;       /**< Real-time mode: start offset in us, virtual mode: current time in us */
+
+    /**
+     * Constructs the clock in real-time mode.
+     */
+    VirtualClock() :
+        m_mode(MODE_REALTIME),
+        m_start(WallClock::now()),
+        m_offset(0U)
+    {
+    }
+
+    /**
+     * Destroys the clock.
+     */
+    ~VirtualClock()
+    {
+    }
+
+    VirtualClock(const VirtualClock& clock);
+    VirtualClock& operator=(const VirtualClock& clock);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __VIRTUALCLOCK_H__ */
+
+/** @} */
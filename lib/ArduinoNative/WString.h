@@ -43,8 +43,10 @@
 /******************************************************************************
  * Includes
  *****************************************************************************/
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 /******************************************************************************
  * Macros
@@ -399,6 +401,28 @@ public:
         return out;
     }
 
+    /**
+     * Is string empty?
+     *
+     * @return If string is empty, it will return true otherwise false.
+     */
+    bool isEmpty() const
+    {
+        return (0U == length());
+    }
+
+    /**
+     * Compare with other string.
+     *
+     * @param[in] s2    Other string
+     *
+     * @return If both strings are equal, it will return a non-zero value otherwise 0.
+     */
+    unsigned char equals(const String& s2) const
+    {
+        return (*this == s2) ? 1U : 0U;
+    }
+
     /**
      * Starts string with given pattern?
      *
@@ -436,6 +460,109 @@ public:
         return 0 == strncmp(&m_buffer[offset], s2.m_buffer, s2.length());
     }
 
+    /**
+     * Compare with other string case insensitive.
+     *
+     * @param[in] s2    Other string
+     *
+     * @return If both strings are equal, it will return a non-zero value otherwise 0.
+     */
+    unsigned char equalsIgnoreCase(const String& s2) const
+    {
+        return (0 == strcasecmp(c_str(), s2.c_str())) ? 1U : 0U;
+    }
+
+    /**
+     * Get index of the first occurrence of a character.
+     *
+     * @param[in] c         Character
+     * @param[in] fromIndex Index where to start searching
+     *
+     * @return If found, it will return the index otherwise -1.
+     */
+    int indexOf(char c, unsigned int fromIndex = 0U) const
+    {
+        int index = -1;
+
+        if (length() > fromIndex)
+        {
+            const char* pos = strchr(&m_buffer[fromIndex], c);
+
+            if (nullptr != pos)
+            {
+                index = static_cast<int>(pos - m_buffer);
+            }
+        }
+
+        return index;
+    }
+
+    /**
+     * Get index of the first occurrence of a string.
+     *
+     * @param[in] s2        String to search for
+     * @param[in] fromIndex Index where to start searching
+     *
+     * @return If found, it will return the index otherwise -1.
+     */
+    int indexOf(const String& s2, unsigned int fromIndex = 0U) const
+    {
+        int index = -1;
+
+        if (length() > fromIndex)
+        {
+            const char* pos = strstr(&m_buffer[fromIndex], s2.c_str());
+
+            if (nullptr != pos)
+            {
+                index = static_cast<int>(pos - m_buffer);
+            }
+        }
+
+        return index;
+    }
+
+    /**
+     * Remove all characters from the given index to the end.
+     *
+     * @param[in] index Index
+     */
+    void remove(unsigned int index)
+    {
+        if (length() > index)
+        {
+            m_buffer[index] = '\0';
+        }
+
+        return;
+    }
+
+    /**
+     * Convert string to integer number.
+     *
+     * @return Integer number, 0 if the conversion fails.
+     */
+    long toInt() const
+    {
+        return strtol(c_str(), nullptr, 10);
+    }
+
+    /**
+     * Reserve buffer for the given string length. The native string
+     * allocates its buffer with every change anyway, therefore this has
+     * no effect.
+     *
+     * @param[in] size  String length
+     *
+     * @return If successful, it will return 1 otherwise 0.
+     */
+    unsigned char reserve(unsigned int size)
+    {
+        (void)size;
+
+        return 1U;
+    }
+
     /**
      * Clear string.
      */
@@ -169,6 +169,24 @@ public:
         return m_buffer;
     }
 
+    /**
+     * Remove the bitmap and free its buffer.
+     */
+    void clear()
+    {
+        if (nullptr != m_buffer)
+        {
+            delete[] m_buffer;
+            m_buffer = nullptr;
+        }
+
+        m_bufferSize    = 0U;
+        m_width         = 0U;
+        m_height        = 0U;
+
+        return;
+    }
+
     #ifndef NATIVE
 
     /**
@@ -0,0 +1,469 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Framebuffer encoder
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "FrameEncoder.h"
+
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static void writeUInt16(uint8_t* dst, uint16_t value);
+static void writeUInt32(uint8_t* dst, uint32_t value);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+FrameEncoder::FrameEncoder() :
+    m_width(0U),
+    m_height(0U),
+    m_format(PIXEL_FORMAT_RGB888),
+    m_reference(nullptr),
+    m_isReference(false),
+    m_frameNo(0U),
+    m_encoding(ENCODING_RAW),
+    m_isStream(false)
+{
+}
+
+FrameEncoder::~FrameEncoder()
+{
+    end();
+}
+
+bool FrameEncoder::begin(uint16_t width, uint16_t height, PixelFormat format)
+{
+    bool isSuccessful = true;
+
+    if ((0U == width) ||
+        (0U == height) ||
+        (PIXEL_FORMAT_MAX <= format))
+    {
+        isSuccessful = false;
+    }
+    else if ((nullptr == m_reference) ||
+             (width != m_width) ||
+             (height != m_height) ||
+             (format != m_format))
+    {
+        end();
+
+        m_reference = new uint8_t[getMaxSize(width, height, format) - HEADER_SIZE];
+
+        if (nullptr == m_reference)
+        {
+            isSuccessful = false;
+        }
+        else
+        {
+            m_width     = width;
+            m_height    = height;
+            m_format    = format;
+        }
+    }
+
+    return isSuccessful;
+}
+
+void FrameEncoder::end()
+{
+    if (nullptr != m_reference)
+    {
+        delete[] m_reference;
+        m_reference = nullptr;
+    }
+
+    m_isReference = false;
+
+    return;
+}
+
+size_t FrameEncoder::encode(uint8_t* buffer, size_t size, const uint32_t* pixels, uint8_t slotId, uint32_t ackFrameNo)
+{
+    size_t          frameSize       = 0U;
+    const size_t    RAW_SIZE        = getMaxSize() - HEADER_SIZE;
+    const size_t    PIXEL_COUNT     = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    const uint8_t   BYTES_PER_PIXEL = getBytesPerPixel(m_format);
+    uint32_t        refFrameNo      = 0U;
+    uint8_t*        data            = nullptr;
+    size_t          dataSize        = 0U;
+    size_t          index           = 0U;
+
+    if ((nullptr == buffer) ||
+        (getMaxSize() > size) ||
+        (nullptr == pixels) ||
+        (nullptr == m_reference))
+    {
+        return 0U;
+    }
+
+    data = &buffer[HEADER_SIZE];
+
+    /* A delta frame needs the reference frame on both sides. Its size is
+     * mostly independent of the content and small, if only a part of the
+     * display changes. Therefore it is preferred.
+     */
+    if ((true == m_isReference) &&
+        (m_frameNo == ackFrameNo))
+    {
+        dataSize = encodeRle(data, RAW_SIZE - 1U, pixels, true);
+
+        if (0U < dataSize)
+        {
+            m_encoding  = ENCODING_DELTA;
+            refFrameNo  = m_frameNo;
+        }
+    }
+
+    if (0U == dataSize)
+    {
+        dataSize = encodeRle(data, RAW_SIZE - 1U, pixels, false);
+
+        if (0U < dataSize)
+        {
+            m_encoding = ENCODING_RLE;
+        }
+    }
+
+    /* The reference frame is updated in any case, so the raw pixel data
+     * can be written in the same step.
+     */
+    for(index = 0U; index < PIXEL_COUNT; ++index)
+    {
+        uint8_t* ref = &m_reference[index * BYTES_PER_PIXEL];
+
+        writePixel(ref, toPixel(pixels[index]));
+
+        if (0U == dataSize)
+        {
+            writePixel(&data[index * BYTES_PER_PIXEL], readPixel(ref));
+        }
+    }
+
+    if (0U == dataSize)
+    {
+        m_encoding  = ENCODING_RAW;
+        dataSize    = RAW_SIZE;
+    }
+
+    /* Frame number 0 is reserved for "no frame received". */
+    ++m_frameNo;
+    if (0U == m_frameNo)
+    {
+        ++m_frameNo;
+    }
+
+    m_isReference = true;
+
+    writeHeader(buffer, slotId, refFrameNo);
+
+    frameSize = HEADER_SIZE + dataSize;
+
+    return frameSize;
+}
+
+size_t FrameEncoder::encodeKeyFrame(uint8_t* buffer, size_t size, uint8_t slotId)
+{
+    size_t          frameSize   = 0U;
+    const size_t    RAW_SIZE    = getMaxSize() - HEADER_SIZE;
+    uint8_t*        data        = nullptr;
+    size_t          dataSize    = 0U;
+
+    if ((nullptr == buffer) ||
+        (getMaxSize() > size) ||
+        (false == m_isReference))
+    {
+        return 0U;
+    }
+
+    data        = &buffer[HEADER_SIZE];
+    dataSize    = encodeRle(data, RAW_SIZE - 1U, nullptr, false);
+
+    if (0U < dataSize)
+    {
+        m_encoding = ENCODING_RLE;
+    }
+    else
+    {
+        /* The reference frame is stored in the pixel format. */
+        memcpy(data, m_reference, RAW_SIZE);
+
+        m_encoding  = ENCODING_RAW;
+        dataSize    = RAW_SIZE;
+    }
+
+    writeHeader(buffer, slotId, 0U);
+
+    frameSize = HEADER_SIZE + dataSize;
+
+    return frameSize;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+uint32_t FrameEncoder::toPixel(uint32_t color) const
+{
+    uint32_t pixel = color & 0x00FFFFFFU;
+
+    if (PIXEL_FORMAT_RGB565 == m_format)
+    {
+        const uint32_t  RED5    = (color >> 19U) & 0x1FU;
+        const uint32_t  GREEN6  = (color >> 10U) & 0x3FU;
+        const uint32_t  BLUE5   = (color >>  3U) & 0x1FU;
+
+        pixel = (RED5 << 11U) | (GREEN6 << 5U) | BLUE5;
+    }
+
+    return pixel;
+}
+
+uint32_t FrameEncoder::getValue(const uint32_t* pixels, size_t index, bool isDelta) const
+{
+    const uint8_t*  reference   = &m_reference[index * getBytesPerPixel(m_format)];
+    uint32_t        value       = 0U;
+
+    if (nullptr == pixels)
+    {
+        value = readPixel(reference);
+    }
+    else
+    {
+        value = toPixel(pixels[index]);
+
+        if (true == isDelta)
+        {
+            value ^= readPixel(reference);
+        }
+    }
+
+    return value;
+}
+
+void FrameEncoder::writePixel(uint8_t* dst, uint32_t value) const
+{
+    if (PIXEL_FORMAT_RGB565 == m_format)
+    {
+        writeUInt16(dst, static_cast<uint16_t>(value));
+    }
+    else
+    {
+        dst[0] = static_cast<uint8_t>(value >> 16U);
+        dst[1] = static_cast<uint8_t>(value >>  8U);
+        dst[2] = static_cast<uint8_t>(value >>  0U);
+    }
+
+    return;
+}
+
+uint32_t FrameEncoder::readPixel(const uint8_t* src) const
+{
+    uint32_t value = 0U;
+
+    if (PIXEL_FORMAT_RGB565 == m_format)
+    {
+        value  = static_cast<uint32_t>(src[0]) << 0U;
+        value |= static_cast<uint32_t>(src[1]) << 8U;
+    }
+    else
+    {
+        value  = static_cast<uint32_t>(src[0]) << 16U;
+        value |= static_cast<uint32_t>(src[1]) <<  8U;
+        value |= static_cast<uint32_t>(src[2]) <<  0U;
+    }
+
+    return value;
+}
+
+size_t FrameEncoder::encodeRle(uint8_t* buffer, size_t size, const uint32_t* pixels, bool isDelta) const
+{
+    const size_t    PIXEL_COUNT     = static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    const uint8_t   BYTES_PER_PIXEL = getBytesPerPixel(m_format);
+    size_t          index           = 0U;
+    size_t          wrIndex         = 0U;
+    bool            isFull          = false;
+
+    while((PIXEL_COUNT > index) && (false == isFull))
+    {
+        const uint32_t  VALUE   = getValue(pixels, index, isDelta);
+        size_t          run     = 1U;
+
+        while(((index + run) < PIXEL_COUNT) &&
+              (MAX_RUN > run) &&
+              (VALUE == getValue(pixels, index + run, isDelta)))
+        {
+            ++run;
+        }
+
+        /* Repeated pixels */
+        if (1U < run)
+        {
+            if (size < (wrIndex + 1U + BYTES_PER_PIXEL))
+            {
+                isFull = true;
+            }
+            else
+            {
+                buffer[wrIndex] = static_cast<uint8_t>(0x80U | (run - 1U));
+                writePixel(&buffer[wrIndex + 1U], VALUE);
+
+                wrIndex += 1U + BYTES_PER_PIXEL;
+                index   += run;
+            }
+        }
+        /* Literal pixels, until the next repeated pixels start. */
+        else
+        {
+            uint32_t    previous    = VALUE;
+            bool        isRepeated  = false;
+            size_t      literals    = 1U;
+
+            while(((index + literals) < PIXEL_COUNT) &&
+                  (MAX_RUN > literals) &&
+                  (false == isRepeated))
+            {
+                const uint32_t CURRENT = getValue(pixels, index + literals, isDelta);
+
+                if (CURRENT == previous)
+                {
+                    /* The previous pixel starts the repeated pixels. */
+                    --literals;
+                    isRepeated = true;
+                }
+                else
+                {
+                    previous = CURRENT;
+                    ++literals;
+                }
+            }
+
+            if (size < (wrIndex + 1U + (literals * BYTES_PER_PIXEL)))
+            {
+                isFull = true;
+            }
+            else
+            {
+                size_t literal = 0U;
+
+                buffer[wrIndex] = static_cast<uint8_t>(literals - 1U);
+                ++wrIndex;
+
+                for(literal = 0U; literal < literals; ++literal)
+                {
+                    writePixel(&buffer[wrIndex], getValue(pixels, index + literal, isDelta));
+                    wrIndex += BYTES_PER_PIXEL;
+                }
+
+                index += literals;
+            }
+        }
+    }
+
+    return (true == isFull) ? 0U : wrIndex;
+}
+
+void FrameEncoder::writeHeader(uint8_t* buffer, uint8_t slotId, uint32_t refFrameNo) const
+{
+    buffer[0] = VERSION;
+    buffer[1] = static_cast<uint8_t>(m_format) | ((true == m_isStream) ? FLAG_STREAM : 0U);
+    buffer[2] = static_cast<uint8_t>(m_encoding);
+    buffer[3] = slotId;
+    writeUInt32(&buffer[4], m_frameNo);
+    writeUInt32(&buffer[8], refFrameNo);
+    writeUInt16(&buffer[12], m_width);
+    writeUInt16(&buffer[14], m_height);
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Write a 16 bit value in little endian.
+ *
+ * @param[out] dst      Destination
+ * @param[in]  value    Value
+ */
+static void writeUInt16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = static_cast<uint8_t>(value >> 0U);
+    dst[1] = static_cast<uint8_t>(value >> 8U);
+
+    return;
+}
+
+/**
+ * Write a 32 bit value in little endian.
+ *
+ * @param[out] dst      Destination
+ * @param[in]  value    Value
+ */
+static void writeUInt32(uint8_t* dst, uint32_t value)
+{
+    dst[0] = static_cast<uint8_t>(value >>  0U);
+    dst[1] = static_cast<uint8_t>(value >>  8U);
+    dst[2] = static_cast<uint8_t>(value >> 16U);
+    dst[3] = static_cast<uint8_t>(value >> 24U);
+
+    return;
+}
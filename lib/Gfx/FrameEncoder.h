@@ -0,0 +1,323 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Framebuffer encoder
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup gfx
+ *
+ * @{
+ */
+
+#ifndef __FRAME_ENCODER_H__
+#define __FRAME_ENCODER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Encodes framebuffer copies to compact binary frames, e.g. for a display
+ * preview over a websocket.
+ *
+ * A frame consists of a header and the pixel data. All header values are
+ * little endian.
+ *
+ * | Offset | Size | Description                                            |
+ * | ------ | ---- | ------------------------------------------------------ |
+ * | 0      | 1    | Protocol version                                       |
+ * | 1      | 1    | Pixel format, see PixelFormat. Bit 7 marks a stream.   |
+ * | 2      | 1    | Encoding, see Encoding                                 |
+ * | 3      | 1    | Slot id                                                |
+ * | 4      | 4    | Frame number                                           |
+ * | 8      | 4    | Reference frame number of a delta frame, otherwise 0   |
+ * | 12     | 2    | Width in pixel                                         |
+ * | 14     | 2    | Height in pixel                                        |
+ *
+ * A RGB888 pixel is stored as red, green and blue byte. A RGB565 pixel is
+ * stored as 16 bit value.
+ *
+ * Run-length encoded pixel data is a sequence of packets. Each packet starts
+ * with a control byte. If bit 7 is cleared, the control byte value + 1
+ * pixels follow. If bit 7 is set, the next pixel is repeated by the value of
+ * the lower 7 bits + 1.
+ *
+ * A delta frame is run-length encoded too, but its pixels are the XOR of the
+ * pixels and the pixels of the reference frame. The reference frame is the
+ * last encoded frame. It is only used, if the receiver acknowledges it.
+ *
+ * Frames of a stream, which are pushed without request, are marked in the
+ * pixel format byte. So a receiver can distinguish them from requested ones.
+ */
+class FrameEncoder
+{
+public:
+
+    /** Pixel formats */
+    enum PixelFormat
+    {
+        PIXEL_FORMAT_RGB888 = 0,    /**< 24 bit per pixel */
+        PIXEL_FORMAT_RGB565,        /**< 16 bit per pixel */
+        PIXEL_FORMAT_MAX            /**< Number of pixel formats */
+    };
+
+    /** Pixel data encodings */
+    enum Encoding
+    {
+        ENCODING_RAW = 0,   /**< Not compressed */
+        ENCODING_RLE,       /**< Run-length encoded */
+        ENCODING_DELTA      /**< Run-length encoded XOR delta to the reference frame */
+    };
+
+    /**
+     * Constructs the frame encoder.
+     */
+    FrameEncoder();
+
+    /**
+     * Destroys the frame encoder.
+     */
+    ~FrameEncoder();
+
+    /**
+     * Start encoding frames with the given dimensions and pixel format.
+     * If they are unchanged, the reference frame is kept.
+     *
+     * @param[in] width     Width in pixel
+     * @param[in] height    Height in pixel
+     * @param[in] format    Pixel format
+     *
+     * @return If successful started, it will return true otherwise false.
+     */
+    bool begin(uint16_t width, uint16_t height, PixelFormat format);
+
+    /**
+     * Stop encoding and release the reference frame.
+     */
+    void end();
+
+    /**
+     * Encode a frame.
+     *
+     * @param[out] buffer       Frame buffer, which shall have at least the size of getMaxSize().
+     * @param[in]  size         Frame buffer size in byte
+     * @param[in]  pixels       Pixels as 0x00RRGGBB, row by row
+     * @param[in]  slotId       Id of slot, which shows the pixels
+     * @param[in]  ackFrameNo   Number of the last frame, the receiver got.
+     *
+     * @return Frame size in byte. If it fails, it will return 0.
+     */
+    size_t encode(uint8_t* buffer, size_t size, const uint32_t* pixels, uint8_t slotId, uint32_t ackFrameNo);
+
+    /**
+     * Encode the last encoded frame again, but as key frame with the same
+     * frame number. This is used for a receiver, which has not the reference
+     * frame of the last encoded delta frame.
+     *
+     * @param[out] buffer   Frame buffer, which shall have at least the size of getMaxSize().
+     * @param[in]  size     Frame buffer size in byte
+     * @param[in]  slotId   Id of slot, which shows the pixels
+     *
+     * @return Frame size in byte. If no frame was encoded yet, it will return 0.
+     */
+    size_t encodeKeyFrame(uint8_t* buffer, size_t size, uint8_t slotId);
+
+    /**
+     * Mark the frames as stream frames or not.
+     *
+     * @param[in] isStream  Stream frames or not
+     */
+    void setStream(bool isStream)
+    {
+        m_isStream = isStream;
+    }
+
+    /**
+     * Get the max. size of an encoded frame.
+     *
+     * @return Max. frame size in byte
+     */
+    size_t getMaxSize() const
+    {
+        return getMaxSize(m_width, m_height, m_format);
+    }
+
+    /**
+     * Get the max. size of an encoded frame.
+     *
+     * @param[in] width     Width in pixel
+     * @param[in] height    Height in pixel
+     * @param[in] format    Pixel format
+     *
+     * @return Max. frame size in byte
+     */
+    static size_t getMaxSize(uint16_t width, uint16_t height, PixelFormat format)
+    {
+        return HEADER_SIZE + (static_cast<size_t>(width) * static_cast<size_t>(height) * getBytesPerPixel(format));
+    }
+
+    /**
+     * Get the number of the last encoded frame.
+     *
+     * @return Frame number
+     */
+    uint32_t getFrameNo() const
+    {
+        return m_frameNo;
+    }
+
+    /**
+     * Get the encoding of the last encoded frame.
+     *
+     * @return Encoding
+     */
+    Encoding getEncoding() const
+    {
+        return m_encoding;
+    }
+
+    /**
+     * Get the number of bytes per pixel.
+     *
+     * @param[in] format    Pixel format
+     *
+     * @return Bytes per pixel
+     */
+    static uint8_t getBytesPerPixel(PixelFormat format)
+    {
+        return (PIXEL_FORMAT_RGB565 == format) ? 2U : 3U;
+    }
+
+    /** Protocol version */
+    static const uint8_t    VERSION             = 1U;
+
+    /** Header size in byte */
+    static const size_t     HEADER_SIZE         = 16U;
+
+    /** Max. number of bytes per pixel of all pixel formats. */
+    static const uint8_t    MAX_BYTES_PER_PIXEL = 3U;
+
+    /** Max. number of pixels in a run-length encoded packet */
+    static const uint8_t    MAX_RUN             = 128U;
+
+    /** Pixel format byte flag of a stream frame */
+    static const uint8_t    FLAG_STREAM         = 0x80U;
+
+private:
+
+    uint16_t    m_width;        /**< Width in pixel */
+    uint16_t    m_height;       /**< Height in pixel */
+    PixelFormat m_format;       /**< Pixel format */
+    uint8_t*    m_reference;    /**< Pixels of the reference frame in the pixel format */
+    bool        m_isReference;  /**< Is the reference frame valid? */
+    uint32_t    m_frameNo;      /**< Number of the last encoded frame */
+    Encoding    m_encoding;     /**< Encoding of the last encoded frame */
+    bool        m_isStream;     /**< Are the frames marked as stream frames? */
+
+    FrameEncoder(const FrameEncoder& encoder);
+    FrameEncoder& operator=(const FrameEncoder& encoder);
+
+    /**
+     * Convert a color to the pixel format.
+     *
+     * @param[in] color Color as 0x00RRGGBB
+     *
+     * @return Pixel value
+     */
+    uint32_t toPixel(uint32_t color) const;
+
+    /**
+     * Get the value of a pixel, which shall be encoded.
+     *
+     * @param[in] pixels    Pixels as 0x00RRGGBB. If nullptr, the reference frame is used.
+     * @param[in] index     Pixel index
+     * @param[in] isDelta   Get the XOR delta to the reference frame?
+     *
+     * @return Pixel value
+     */
+    uint32_t getValue(const uint32_t* pixels, size_t index, bool isDelta) const;
+
+    /**
+     * Write a pixel value in the pixel format.
+     *
+     * @param[out] dst      Destination
+     * @param[in]  value    Pixel value
+     */
+    void writePixel(uint8_t* dst, uint32_t value) const;
+
+    /**
+     * Read a pixel value in the pixel format.
+     *
+     * @param[in] src   Source
+     *
+     * @return Pixel value
+     */
+    uint32_t readPixel(const uint8_t* src) const;
+
+    /**
+     * Run-length encode the pixels.
+     *
+     * @param[out] buffer   Pixel data buffer
+     * @param[in]  size     Max. pixel data size in byte
+     * @param[in]  pixels   Pixels as 0x00RRGGBB. If nullptr, the reference frame is used.
+     * @param[in]  isDelta  Encode the XOR delta to the reference frame?
+     *
+     * @return Pixel data size in byte. If it doesn't fit, it will return 0.
+     */
+    size_t encodeRle(uint8_t* buffer, size_t size, const uint32_t* pixels, bool isDelta) const;
+
+    /**
+     * Write the frame header.
+     *
+     * @param[out] buffer       Frame buffer
+     * @param[in]  slotId       Id of slot, which shows the pixels
+     * @param[in]  refFrameNo   Reference frame number of a delta frame, otherwise 0
+     */
+    void writeHeader(uint8_t* buffer, uint8_t slotId, uint32_t refFrameNo) const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __FRAME_ENCODER_H__ */
+
+/** @} */
@@ -0,0 +1,194 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Hibernation state of a plugin
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup utilities
+ *
+ * @{
+ */
+
+#ifndef __HIBERNATION_HPP__
+#define __HIBERNATION_HPP__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <SimpleTimer.hpp>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Keeps track how long a plugin is invisible and whether it is hibernated.
+ * A plugin shall hibernate after it was invisible for the hibernation time
+ * and it shall resume, before it gets visible again.
+ */
+class Hibernation
+{
+public:
+
+    /**
+     * Constructs the hibernation state of a plugin, which is not hibernated.
+     */
+    Hibernation() :
+        m_isHibernated(false),
+        m_reclaimedHeap(0U),
+        m_invisibilityTimer()
+    {
+    }
+
+    /**
+     * Destroys the hibernation state.
+     */
+    ~Hibernation()
+    {
+    }
+
+    /**
+     * Process the invisibility of the plugin. Call it periodically.
+     * If the plugin is visible or about to get visible, the invisibility
+     * timer is stopped. Otherwise it is started and after it expired, the
+     * plugin shall hibernate.
+     *
+     * @param[in] isVisible Is plugin visible or about to get visible?
+     * @param[in] duration  Hibernation time in ms. 0 disables hibernation.
+     *
+     * @return If the plugin shall hibernate now, it will return true otherwise false.
+     */
+    bool isDue(bool isVisible, uint32_t duration)
+    {
+        bool isDue = false;
+
+        if ((0U == duration) ||
+            (true == isVisible))
+        {
+            m_invisibilityTimer.stop();
+        }
+        else if (true == m_isHibernated)
+        {
+            /* Nothing to do. */
+            ;
+        }
+        else if (false == m_invisibilityTimer.isTimerRunning())
+        {
+            m_invisibilityTimer.start(duration);
+        }
+        else if (true == m_invisibilityTimer.isTimeout())
+        {
+            /* If the plugin refuses to hibernate, it will be asked again
+             * after the next hibernation time.
+             */
+            m_invisibilityTimer.stop();
+            isDue = true;
+        }
+        else
+        {
+            /* Nothing to do. */
+            ;
+        }
+
+        return isDue;
+    }
+
+    /**
+     * Mark the plugin as hibernated.
+     *
+     * @param[in] reclaimedHeap Heap in byte, which was reclaimed by hibernation.
+     */
+    void hibernated(uint32_t reclaimedHeap)
+    {
+        m_isHibernated  = true;
+        m_reclaimedHeap = reclaimedHeap;
+
+        return;
+    }
+
+    /**
+     * Mark the plugin as resumed and stop the invisibility timer.
+     *
+     * @return If the plugin was hibernated and needs to resume, it will return true otherwise false.
+     */
+    bool resume()
+    {
+        bool wasHibernated = m_isHibernated;
+
+        m_isHibernated  = false;
+        m_reclaimedHeap = 0U;
+        m_invisibilityTimer.stop();
+
+        return wasHibernated;
+    }
+
+    /**
+     * Is the plugin hibernated?
+     *
+     * @return If hibernated, it will return true otherwise false.
+     */
+    bool isHibernated() const
+    {
+        return m_isHibernated;
+    }
+
+    /**
+     * Get heap in byte, which was reclaimed by hibernating the plugin.
+     *
+     * @return Reclaimed heap in byte
+     */
+    uint32_t getReclaimedHeap() const
+    {
+        return m_reclaimedHeap;
+    }
+
+private:
+
+    bool        m_isHibernated;         /**< Is the plugin hibernated? */
+    uint32_t    m_reclaimedHeap;        /**< Heap in byte, which was reclaimed by hibernation. */
+    SimpleTimer m_invisibilityTimer;    /**< Measures how long the plugin is invisible. */
+
+    Hibernation(const Hibernation& hibernation);
+    Hibernation& operator=(const Hibernation& hibernation);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HIBERNATION_HPP__ */
+
+/** @} */
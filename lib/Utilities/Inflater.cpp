@@ -0,0 +1,1266 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Streaming inflater for deflate, zlib and gzip data
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "Inflater.h"
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static uint32_t updateCrc32(uint32_t crc, const uint8_t* data, size_t size);
+static uint32_t updateAdler32(uint32_t adler, const uint8_t* data, size_t size);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** gzip header flag: CRC16 of the header is present. */
+static const uint8_t    GZIP_FHCRC      = 0x02U;
+
+/** gzip header flag: Extra field is present. */
+static const uint8_t    GZIP_FEXTRA     = 0x04U;
+
+/** gzip header flag: Original file name is present. */
+static const uint8_t    GZIP_FNAME      = 0x08U;
+
+/** gzip header flag: Comment is present. */
+static const uint8_t    GZIP_FCOMMENT   = 0x10U;
+
+/** Order of the code length code lengths in a dynamic block header */
+static const uint8_t    CL_ORDER[19U]   =
+{
+    16U, 17U, 18U, 0U, 8U, 7U, 9U, 6U, 10U, 5U, 11U, 4U, 12U, 3U, 13U, 2U, 14U, 1U, 15U
+};
+
+/** Base length of the length symbols 257..285 */
+static const uint16_t   LENGTH_BASE[29U]    =
+{
+    3U, 4U, 5U, 6U, 7U, 8U, 9U, 10U, 11U, 13U, 15U, 17U, 19U, 23U, 27U, 31U,
+    35U, 43U, 51U, 59U, 67U, 83U, 99U, 115U, 131U, 163U, 195U, 227U, 258U
+};
+
+/** Number of extra bits of the length symbols 257..285 */
+static const uint8_t    LENGTH_EXTRA[29U]   =
+{
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U, 2U, 2U, 2U, 2U,
+    3U, 3U, 3U, 3U, 4U, 4U, 4U, 4U, 5U, 5U, 5U, 5U, 0U
+};
+
+/** Base distance of the distance symbols 0..29 */
+static const uint16_t   DIST_BASE[30U]      =
+{
+    1U, 2U, 3U, 4U, 5U, 7U, 9U, 13U, 17U, 25U, 33U, 49U, 65U, 97U, 129U, 193U,
+    257U, 385U, 513U, 769U, 1025U, 1537U, 2049U, 3073U, 4097U, 6145U, 8193U, 12289U, 16385U, 24577U
+};
+
+/** Number of extra bits of the distance symbols 0..29 */
+static const uint8_t    DIST_EXTRA[30U]     =
+{
+    0U, 0U, 0U, 0U, 1U, 1U, 2U, 2U, 3U, 3U, 4U, 4U, 5U, 5U, 6U, 6U,
+    7U, 7U, 8U, 8U, 9U, 9U, 10U, 10U, 11U, 11U, 12U, 12U, 13U, 13U
+};
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+Inflater::Inflater() :
+    m_format(FORMAT_RAW),
+    m_state(STATE_IDLE),
+    m_outputFunc(nullptr),
+    m_outputArg(nullptr),
+    m_input(nullptr),
+    m_inputSize(0U),
+    m_inputIndex(0U),
+    m_isFinishing(false),
+    m_bitBuf(0U),
+    m_bitCnt(0U),
+    m_window(nullptr),
+    m_windowSize(MAX_WINDOW_SIZE),
+    m_wrIndex(0U),
+    m_flushIndex(0U),
+    m_isWindowFull(false),
+    m_isFinalBlock(false),
+    m_gzipFlags(0U),
+    m_bytes(),
+    m_count(0U),
+    m_nlen(0U),
+    m_ndist(0U),
+    m_ncode(0U),
+    m_length(0U),
+    m_dist(0U),
+    m_extraBits(0U),
+    m_lengths(),
+    m_lenCode(),
+    m_distCode(),
+    m_checksum(0U),
+    m_outputSize(0U)
+{
+}
+
+Inflater::~Inflater()
+{
+    end();
+}
+
+bool Inflater::begin(Format format, OutputFunc func, void* arg)
+{
+    end();
+
+    m_format        = format;
+    m_outputFunc    = func;
+    m_outputArg     = arg;
+    m_isFinishing   = false;
+    m_bitBuf        = 0U;
+    m_bitCnt        = 0U;
+    m_windowSize    = MAX_WINDOW_SIZE;
+    m_wrIndex       = 0U;
+    m_flushIndex    = 0U;
+    m_isWindowFull  = false;
+    m_isFinalBlock  = false;
+    m_count         = 0U;
+    m_outputSize    = 0U;
+
+    switch(m_format)
+    {
+    case FORMAT_ZLIB:
+        m_state     = STATE_ZLIB_HEADER;
+        m_checksum  = 1U;
+        break;
+
+    case FORMAT_GZIP:
+        m_state     = STATE_GZIP_HEADER;
+        m_checksum  = 0U;
+        break;
+
+    case FORMAT_RAW:
+        /* fall through */
+    default:
+        m_format    = FORMAT_RAW;
+        m_state     = STATE_BLOCK_HEADER;
+        m_checksum  = 0U;
+        break;
+    }
+
+    return true;
+}
+
+void Inflater::end()
+{
+    if (nullptr != m_window)
+    {
+        delete[] m_window;
+        m_window = nullptr;
+    }
+
+    m_state         = STATE_IDLE;
+    m_input         = nullptr;
+    m_inputSize     = 0U;
+    m_inputIndex    = 0U;
+
+    return;
+}
+
+Inflater::Status Inflater::write(const uint8_t* data, size_t size)
+{
+    Status status = STATUS_ERROR;
+
+    if ((STATE_IDLE != m_state) &&
+        (false == m_isFinishing))
+    {
+        m_input         = data;
+        m_inputSize     = (nullptr == data) ? 0U : size;
+        m_inputIndex    = 0U;
+
+        process();
+        flush();
+
+        /* All data is consumed by the bit buffer. */
+        m_input         = nullptr;
+        m_inputSize     = 0U;
+        m_inputIndex    = 0U;
+
+        if (STATE_DONE == m_state)
+        {
+            status = STATUS_DONE;
+        }
+        else if (STATE_ERROR != m_state)
+        {
+            status = STATUS_CONTINUE;
+        }
+    }
+
+    return status;
+}
+
+Inflater::Status Inflater::finish()
+{
+    Status status = STATUS_ERROR;
+
+    if (STATE_IDLE != m_state)
+    {
+        /* A raw deflate stream may end with less bits than a code has. */
+        m_isFinishing = true;
+
+        process();
+        flush();
+
+        if (STATE_DONE == m_state)
+        {
+            status = STATUS_DONE;
+        }
+    }
+
+    return status;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void Inflater::process()
+{
+    State lastState = STATE_IDLE;
+
+    /* Every state returns without state change, if it needs more data. */
+    while((STATE_DONE != m_state) &&
+          (STATE_ERROR != m_state) &&
+          (lastState != m_state))
+    {
+        lastState = m_state;
+
+        switch(m_state)
+        {
+        case STATE_GZIP_HEADER:
+        case STATE_GZIP_EXTRA_LEN:
+        case STATE_GZIP_EXTRA:
+        case STATE_GZIP_NAME:
+        case STATE_GZIP_COMMENT:
+        case STATE_GZIP_HCRC:
+            processGzipHeader();
+            break;
+
+        case STATE_ZLIB_HEADER:
+            processZlibHeader();
+            break;
+
+        case STATE_BLOCK_HEADER:
+        case STATE_STORED_LEN:
+        case STATE_STORED_DATA:
+            processBlock();
+            break;
+
+        case STATE_TABLE_COUNTS:
+        case STATE_TABLE_CL:
+        case STATE_TABLE_LENGTHS:
+            processTable();
+            break;
+
+        case STATE_LEN:
+        case STATE_LEN_EXTRA:
+        case STATE_DIST:
+        case STATE_DIST_EXTRA:
+            processCodes();
+            break;
+
+        case STATE_TRAILER:
+            processTrailer();
+            break;
+
+        case STATE_IDLE:
+            /* fall through */
+        case STATE_DONE:
+            /* fall through */
+        case STATE_ERROR:
+            /* fall through */
+        default:
+            break;
+        }
+    }
+
+    return;
+}
+
+void Inflater::processGzipHeader()
+{
+    bool isWaiting = false;
+
+    /* The gzip header is byte aligned. */
+    while((false == isWaiting) &&
+          (STATE_ERROR != m_state) &&
+          (STATE_BLOCK_HEADER != m_state))
+    {
+        if (false == needBits(8U))
+        {
+            isWaiting = true;
+        }
+        else
+        {
+            uint8_t value = static_cast<uint8_t>(getBits(8U));
+
+            switch(m_state)
+            {
+            /* ID1 ID2 CM FLG MTIME(4) XFL OS */
+            case STATE_GZIP_HEADER:
+                m_bytes[m_count] = value;
+                ++m_count;
+
+                if (10U <= m_count)
+                {
+                    if ((0x1FU != m_bytes[0U]) ||
+                        (0x8BU != m_bytes[1U]) ||
+                        (8U != m_bytes[2U]))
+                    {
+                        m_state = STATE_ERROR;
+                    }
+                    else
+                    {
+                        m_gzipFlags = m_bytes[3U];
+                        m_count     = 0U;
+                        m_state     = getNextGzipState();
+                    }
+                }
+                break;
+
+            case STATE_GZIP_EXTRA_LEN:
+                m_bytes[m_count] = value;
+                ++m_count;
+
+                if (2U <= m_count)
+                {
+                    m_length    = static_cast<uint16_t>(m_bytes[0U]) | (static_cast<uint16_t>(m_bytes[1U]) << 8U);
+                    m_count     = 0U;
+                    m_state     = STATE_GZIP_EXTRA;
+                }
+                break;
+
+            case STATE_GZIP_EXTRA:
+                ++m_count;
+
+                if (m_length <= m_count)
+                {
+                    m_gzipFlags &= ~GZIP_FEXTRA;
+                    m_count     = 0U;
+                    m_state     = getNextGzipState();
+                }
+                break;
+
+            /* Zero terminated strings */
+            case STATE_GZIP_NAME:
+            case STATE_GZIP_COMMENT:
+                if (0U == value)
+                {
+                    if (STATE_GZIP_NAME == m_state)
+                    {
+                        m_gzipFlags &= ~GZIP_FNAME;
+                    }
+                    else
+                    {
+                        m_gzipFlags &= ~GZIP_FCOMMENT;
+                    }
+
+                    m_state = getNextGzipState();
+                }
+                break;
+
+            case STATE_GZIP_HCRC:
+                ++m_count;
+
+                if (2U <= m_count)
+                {
+                    m_gzipFlags &= ~GZIP_FHCRC;
+                    m_count     = 0U;
+                    m_state     = getNextGzipState();
+                }
+                break;
+
+            default:
+                m_state = STATE_ERROR;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+void Inflater::processZlibHeader()
+{
+    if (true == needBits(16U))
+    {
+        uint8_t cmf = static_cast<uint8_t>(m_bitBuf & 0xFFU);
+        uint8_t flg = static_cast<uint8_t>((m_bitBuf >> 8U) & 0xFFU);
+
+        /* RFC1950 - CM must be 8 (deflate), the header a multiple of 31 and
+         * no preset dictionary shall be used. Otherwise its raw deflate
+         * data, which is sent by some servers for "deflate" too.
+         */
+        if ((8U == (cmf & 0x0FU)) &&
+            (7U >= (cmf >> 4U)) &&
+            (0U == (((static_cast<uint16_t>(cmf) << 8U) | flg) % 31U)) &&
+            (0U == (flg & 0x20U)))
+        {
+            (void)getBits(16U);
+            m_windowSize = static_cast<size_t>(1U) << ((cmf >> 4U) + 8U);
+        }
+        else
+        {
+            m_format = FORMAT_RAW;
+        }
+
+        m_state = STATE_BLOCK_HEADER;
+    }
+    else if ((true == m_isFinishing) &&
+             (0U < m_bitCnt))
+    {
+        m_state = STATE_ERROR;
+    }
+
+    return;
+}
+
+void Inflater::processBlock()
+{
+    bool isWaiting = false;
+
+    switch(m_state)
+    {
+    case STATE_BLOCK_HEADER:
+        if (false == allocWindow())
+        {
+            m_state = STATE_ERROR;
+        }
+        else if (true == needBits(3U))
+        {
+            uint32_t type = 0U;
+
+            m_isFinalBlock  = (0U != getBits(1U));
+            type            = getBits(2U);
+
+            switch(type)
+            {
+            case 0U:
+                alignToByte();
+                m_count = 0U;
+                m_state = STATE_STORED_LEN;
+                break;
+
+            case 1U:
+                buildFixed();
+                m_state = STATE_LEN;
+                break;
+
+            case 2U:
+                m_state = STATE_TABLE_COUNTS;
+                break;
+
+            default:
+                m_state = STATE_ERROR;
+                break;
+            }
+        }
+        break;
+
+    /* LEN NLEN */
+    case STATE_STORED_LEN:
+        while((false == isWaiting) && (4U > m_count))
+        {
+            if (false == needBits(8U))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                m_bytes[m_count] = static_cast<uint8_t>(getBits(8U));
+                ++m_count;
+            }
+        }
+
+        if (4U <= m_count)
+        {
+            uint16_t len    = static_cast<uint16_t>(m_bytes[0U]) | (static_cast<uint16_t>(m_bytes[1U]) << 8U);
+            uint16_t nlen   = static_cast<uint16_t>(m_bytes[2U]) | (static_cast<uint16_t>(m_bytes[3U]) << 8U);
+
+            if (static_cast<uint16_t>(~nlen) != len)
+            {
+                m_state = STATE_ERROR;
+            }
+            else
+            {
+                m_length    = len;
+                m_state     = STATE_STORED_DATA;
+            }
+        }
+        break;
+
+    case STATE_STORED_DATA:
+        while((false == isWaiting) && (0U < m_length))
+        {
+            if (false == needBits(8U))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                putByte(static_cast<uint8_t>(getBits(8U)));
+                --m_length;
+            }
+        }
+
+        if (0U == m_length)
+        {
+            m_count = 0U;
+            m_state = (true == m_isFinalBlock) ? STATE_TRAILER : STATE_BLOCK_HEADER;
+        }
+        break;
+
+    default:
+        m_state = STATE_ERROR;
+        break;
+    }
+
+    return;
+}
+
+void Inflater::processTable()
+{
+    bool isWaiting = false;
+
+    switch(m_state)
+    {
+    /* HLIT HDIST HCLEN */
+    case STATE_TABLE_COUNTS:
+        if (true == needBits(14U))
+        {
+            m_nlen  = static_cast<uint16_t>(getBits(5U)) + 257U;
+            m_ndist = static_cast<uint16_t>(getBits(5U)) + 1U;
+            m_ncode = static_cast<uint16_t>(getBits(4U)) + 4U;
+
+            if ((286U < m_nlen) ||
+                (MAX_DCODES < m_ndist))
+            {
+                m_state = STATE_ERROR;
+            }
+            else
+            {
+                m_count = 0U;
+                m_state = STATE_TABLE_CL;
+            }
+        }
+        break;
+
+    case STATE_TABLE_CL:
+        while((false == isWaiting) && (m_ncode > m_count))
+        {
+            if (false == needBits(3U))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                m_lengths[CL_ORDER[m_count]] = static_cast<uint8_t>(getBits(3U));
+                ++m_count;
+            }
+        }
+
+        if (m_ncode <= m_count)
+        {
+            while(19U > m_count)
+            {
+                m_lengths[CL_ORDER[m_count]] = 0U;
+                ++m_count;
+            }
+
+            /* The code length code is temporary kept in the literal/length code. */
+            if (false == build(m_lenCode, m_lengths, 19U))
+            {
+                m_state = STATE_ERROR;
+            }
+            else
+            {
+                m_count = 0U;
+                m_state = STATE_TABLE_LENGTHS;
+            }
+        }
+        break;
+
+    case STATE_TABLE_LENGTHS:
+        while((false == isWaiting) &&
+              (STATE_ERROR != m_state) &&
+              ((m_nlen + m_ndist) > m_count))
+        {
+            /* Code and max. 7 extra bits */
+            if (false == needBits(MAX_BITS + 7U))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                int32_t     symbol  = decode(m_lenCode);
+                uint8_t     value   = 0U;
+                uint16_t    repeat  = 0U;
+
+                if (0 > symbol)
+                {
+                    m_state = STATE_ERROR;
+                }
+                else if (16 > symbol)
+                {
+                    value   = static_cast<uint8_t>(symbol);
+                    repeat  = 1U;
+                }
+                else if (16 == symbol)
+                {
+                    if (0U == m_count)
+                    {
+                        m_state = STATE_ERROR;
+                    }
+                    else
+                    {
+                        value   = m_lengths[m_count - 1U];
+                        repeat  = 3U + static_cast<uint16_t>(getBits(2U));
+                    }
+                }
+                else if (17 == symbol)
+                {
+                    repeat = 3U + static_cast<uint16_t>(getBits(3U));
+                }
+                else
+                {
+                    repeat = 11U + static_cast<uint16_t>(getBits(7U));
+                }
+
+                if ((m_count + repeat) > (m_nlen + m_ndist))
+                {
+                    m_state = STATE_ERROR;
+                }
+                else
+                {
+                    while(0U < repeat)
+                    {
+                        m_lengths[m_count] = value;
+                        ++m_count;
+                        --repeat;
+                    }
+                }
+            }
+        }
+
+        if ((STATE_ERROR != m_state) &&
+            ((m_nlen + m_ndist) <= m_count))
+        {
+            /* The end of block code is mandatory. */
+            if ((0U == m_lengths[256U]) ||
+                (false == build(m_lenCode, m_lengths, m_nlen)) ||
+                (false == build(m_distCode, &m_lengths[m_nlen], m_ndist)))
+            {
+                m_state = STATE_ERROR;
+            }
+            else
+            {
+                m_state = STATE_LEN;
+            }
+        }
+        break;
+
+    default:
+        m_state = STATE_ERROR;
+        break;
+    }
+
+    return;
+}
+
+void Inflater::processCodes()
+{
+    bool isWaiting = false;
+
+    while((false == isWaiting) &&
+          (STATE_LEN <= m_state) &&
+          (STATE_DIST_EXTRA >= m_state))
+    {
+        switch(m_state)
+        {
+        case STATE_LEN:
+            if (false == needCodeBits(MAX_BITS))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                int32_t symbol = decode(m_lenCode);
+
+                if (0 > symbol)
+                {
+                    m_state = STATE_ERROR;
+                }
+                else if (256 > symbol)
+                {
+                    putByte(static_cast<uint8_t>(symbol));
+                }
+                else if (256 == symbol)
+                {
+                    m_count = 0U;
+                    m_state = (true == m_isFinalBlock) ? STATE_TRAILER : STATE_BLOCK_HEADER;
+                }
+                else if (286 <= symbol)
+                {
+                    m_state = STATE_ERROR;
+                }
+                else
+                {
+                    m_length    = LENGTH_BASE[symbol - 257];
+                    m_extraBits = LENGTH_EXTRA[symbol - 257];
+                    m_state     = STATE_LEN_EXTRA;
+                }
+            }
+            break;
+
+        case STATE_LEN_EXTRA:
+            if (false == needBits(m_extraBits))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                m_length += static_cast<uint16_t>(getBits(m_extraBits));
+                m_state = STATE_DIST;
+            }
+            break;
+
+        case STATE_DIST:
+            if (false == needCodeBits(MAX_BITS))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                int32_t symbol = decode(m_distCode);
+
+                if ((0 > symbol) ||
+                    (static_cast<int32_t>(MAX_DCODES) <= symbol))
+                {
+                    m_state = STATE_ERROR;
+                }
+                else
+                {
+                    m_dist      = DIST_BASE[symbol];
+                    m_extraBits = DIST_EXTRA[symbol];
+                    m_state     = STATE_DIST_EXTRA;
+                }
+            }
+            break;
+
+        case STATE_DIST_EXTRA:
+            if (false == needBits(m_extraBits))
+            {
+                isWaiting = true;
+            }
+            else
+            {
+                m_dist += static_cast<uint16_t>(getBits(m_extraBits));
+
+                if (false == copy())
+                {
+                    m_state = STATE_ERROR;
+                }
+                else
+                {
+                    m_state = STATE_LEN;
+                }
+            }
+            break;
+
+        default:
+            m_state = STATE_ERROR;
+            break;
+        }
+    }
+
+    return;
+}
+
+void Inflater::processTrailer()
+{
+    bool    isWaiting   = false;
+    uint8_t trailerSize = 0U;
+
+    if (FORMAT_GZIP == m_format)
+    {
+        trailerSize = 8U;   /* CRC32 ISIZE, little endian */
+    }
+    else if (FORMAT_ZLIB == m_format)
+    {
+        trailerSize = 4U;   /* ADLER32, big endian */
+    }
+
+    /* The trailer is byte aligned. */
+    alignToByte();
+
+    while((false == isWaiting) && (trailerSize > m_count))
+    {
+        if (false == needBits(8U))
+        {
+            isWaiting = true;
+        }
+        else
+        {
+            m_bytes[m_count] = static_cast<uint8_t>(getBits(8U));
+            ++m_count;
+        }
+    }
+
+    if (trailerSize <= m_count)
+    {
+        uint32_t expected = 0U;
+
+        /* The checksum is calculated over the provided data. */
+        flush();
+
+        if (FORMAT_GZIP == m_format)
+        {
+            uint32_t size = 0U;
+
+            expected    = static_cast<uint32_t>(m_bytes[0U]) |
+                          (static_cast<uint32_t>(m_bytes[1U]) << 8U) |
+                          (static_cast<uint32_t>(m_bytes[2U]) << 16U) |
+                          (static_cast<uint32_t>(m_bytes[3U]) << 24U);
+            size        = static_cast<uint32_t>(m_bytes[4U]) |
+                          (static_cast<uint32_t>(m_bytes[5U]) << 8U) |
+                          (static_cast<uint32_t>(m_bytes[6U]) << 16U) |
+                          (static_cast<uint32_t>(m_bytes[7U]) << 24U);
+
+            m_state = ((expected == m_checksum) && (size == m_outputSize)) ? STATE_DONE : STATE_ERROR;
+        }
+        else if (FORMAT_ZLIB == m_format)
+        {
+            expected    = (static_cast<uint32_t>(m_bytes[0U]) << 24U) |
+                          (static_cast<uint32_t>(m_bytes[1U]) << 16U) |
+                          (static_cast<uint32_t>(m_bytes[2U]) << 8U) |
+                          static_cast<uint32_t>(m_bytes[3U]);
+
+            m_state = (expected == m_checksum) ? STATE_DONE : STATE_ERROR;
+        }
+        else
+        {
+            m_state = STATE_DONE;
+        }
+    }
+
+    return;
+}
+
+Inflater::State Inflater::getNextGzipState() const
+{
+    State state = STATE_BLOCK_HEADER;
+
+    if (0U != (m_gzipFlags & GZIP_FEXTRA))
+    {
+        state = STATE_GZIP_EXTRA_LEN;
+    }
+    else if (0U != (m_gzipFlags & GZIP_FNAME))
+    {
+        state = STATE_GZIP_NAME;
+    }
+    else if (0U != (m_gzipFlags & GZIP_FCOMMENT))
+    {
+        state = STATE_GZIP_COMMENT;
+    }
+    else if (0U != (m_gzipFlags & GZIP_FHCRC))
+    {
+        state = STATE_GZIP_HCRC;
+    }
+
+    return state;
+}
+
+bool Inflater::needBits(uint8_t num)
+{
+    while((num > m_bitCnt) && (m_inputSize > m_inputIndex))
+    {
+        m_bitBuf |= static_cast<uint32_t>(m_input[m_inputIndex]) << m_bitCnt;
+        m_bitCnt += 8U;
+        ++m_inputIndex;
+    }
+
+    return (num <= m_bitCnt);
+}
+
+bool Inflater::needCodeBits(uint8_t num)
+{
+    bool isAvailable = needBits(num);
+
+    /* The missing bits are zero. If the code needs them, decoding fails. */
+    if ((false == isAvailable) &&
+        (true == m_isFinishing) &&
+        (0U < m_bitCnt))
+    {
+        isAvailable = true;
+    }
+
+    return isAvailable;
+}
+
+uint32_t Inflater::getBits(uint8_t num)
+{
+    uint32_t bits = 0U;
+
+    if (0U < num)
+    {
+        bits        = m_bitBuf & ((static_cast<uint32_t>(1U) << num) - 1U);
+        m_bitBuf  >>= num;
+        m_bitCnt   -= num;
+    }
+
+    return bits;
+}
+
+void Inflater::alignToByte()
+{
+    (void)getBits(m_bitCnt & 7U);
+
+    return;
+}
+
+int32_t Inflater::decode(const Huffman& code)
+{
+    int32_t     symbol  = -1;
+    uint32_t    bits    = m_bitBuf;
+    int32_t     value   = 0;    /* Bits of the code, MSB first */
+    int32_t     first   = 0;    /* First code of the current length */
+    int32_t     index   = 0;    /* Index of the first code of the current length in the symbol table */
+    uint8_t     len     = 1U;
+
+    /* RFC1951 - 3.1.1. Huffman codes are packed starting with the MSB. */
+    while((0 > symbol) && (MAX_BITS >= len))
+    {
+        int32_t count = code.count[len];
+
+        value |= static_cast<int32_t>(bits & 1U);
+        bits >>= 1U;
+
+        if ((value - count) < first)
+        {
+            if (len <= m_bitCnt)
+            {
+                symbol = code.symbol[index + (value - first)];
+                (void)getBits(len);
+            }
+
+            /* Not enough bits at the end of the data. */
+            len = MAX_BITS + 1U;
+        }
+        else
+        {
+            index  += count;
+            first  += count;
+            first <<= 1;
+            value <<= 1;
+            ++len;
+        }
+    }
+
+    return symbol;
+}
+
+bool Inflater::build(Huffman& code, const uint8_t* lengths, uint16_t num)
+{
+    bool        isValid = true;
+    uint16_t    offs[MAX_BITS + 1U];
+    int32_t     left    = 1;
+    uint16_t    symbol  = 0U;
+    uint8_t     len     = 0U;
+
+    for(len = 0U; len <= MAX_BITS; ++len)
+    {
+        code.count[len] = 0U;
+    }
+
+    for(symbol = 0U; symbol < num; ++symbol)
+    {
+        ++code.count[lengths[symbol]];
+    }
+
+    /* Over-subscribed code lengths are invalid. A incomplete code is
+     * accepted, e.g. a single distance code.
+     */
+    for(len = 1U; (len <= MAX_BITS) && (true == isValid); ++len)
+    {
+        left <<= 1;
+        left  -= code.count[len];
+
+        if (0 > left)
+        {
+            isValid = false;
+        }
+    }
+
+    if (true == isValid)
+    {
+        offs[1U] = 0U;
+
+        for(len = 1U; len < MAX_BITS; ++len)
+        {
+            offs[len + 1U] = offs[len] + code.count[len];
+        }
+
+        for(symbol = 0U; symbol < num; ++symbol)
+        {
+            if (0U != lengths[symbol])
+            {
+                code.symbol[offs[lengths[symbol]]] = symbol;
+                ++offs[lengths[symbol]];
+            }
+        }
+    }
+
+    return isValid;
+}
+
+void Inflater::buildFixed()
+{
+    uint16_t symbol = 0U;
+
+    /* RFC1951 - 3.2.6. Compression with fixed Huffman codes */
+    for(symbol = 0U; symbol < 144U; ++symbol)
+    {
+        m_lengths[symbol] = 8U;
+    }
+
+    for(; symbol < 256U; ++symbol)
+    {
+        m_lengths[symbol] = 9U;
+    }
+
+    for(; symbol < 280U; ++symbol)
+    {
+        m_lengths[symbol] = 7U;
+    }
+
+    for(; symbol < MAX_LCODES; ++symbol)
+    {
+        m_lengths[symbol] = 8U;
+    }
+
+    (void)build(m_lenCode, m_lengths, MAX_LCODES);
+
+    for(symbol = 0U; symbol < MAX_DCODES; ++symbol)
+    {
+        m_lengths[symbol] = 5U;
+    }
+
+    (void)build(m_distCode, m_lengths, MAX_DCODES);
+
+    return;
+}
+
+bool Inflater::allocWindow()
+{
+    if (nullptr == m_window)
+    {
+        m_window = new uint8_t[m_windowSize];
+    }
+
+    return (nullptr != m_window);
+}
+
+void Inflater::putByte(uint8_t value)
+{
+    m_window[m_wrIndex] = value;
+    ++m_wrIndex;
+
+    if (m_windowSize <= m_wrIndex)
+    {
+        flush();
+
+        m_wrIndex       = 0U;
+        m_flushIndex    = 0U;
+        m_isWindowFull  = true;
+    }
+
+    return;
+}
+
+bool Inflater::copy()
+{
+    bool    isValid = true;
+    size_t  history = (true == m_isWindowFull) ? m_windowSize : m_wrIndex;
+
+    if (m_dist > history)
+    {
+        isValid = false;
+    }
+    else
+    {
+        size_t src = (m_wrIndex + m_windowSize - m_dist) % m_windowSize;
+
+        while(0U < m_length)
+        {
+            uint8_t value = m_window[src];
+
+            ++src;
+
+            if (m_windowSize <= src)
+            {
+                src = 0U;
+            }
+
+            putByte(value);
+            --m_length;
+        }
+    }
+
+    return isValid;
+}
+
+void Inflater::flush()
+{
+    if (m_wrIndex > m_flushIndex)
+    {
+        const uint8_t*  data = &m_window[m_flushIndex];
+        size_t          size = m_wrIndex - m_flushIndex;
+
+        if (FORMAT_GZIP == m_format)
+        {
+            m_checksum = updateCrc32(m_checksum, data, size);
+        }
+        else if (FORMAT_ZLIB == m_format)
+        {
+            m_checksum = updateAdler32(m_checksum, data, size);
+        }
+
+        m_outputSize += size;
+
+        if (nullptr != m_outputFunc)
+        {
+            m_outputFunc(m_outputArg, data, size);
+        }
+
+        m_flushIndex = m_wrIndex;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Update a CRC32 (ISO-HDLC) with the given data.
+ * A 4 bit table is used to save memory.
+ *
+ * @param[in] crc   Current CRC, 0 for the first data.
+ * @param[in] data  Data
+ * @param[in] size  Data size in byte
+ *
+ * @return Updated CRC
+ */
+static uint32_t updateCrc32(uint32_t crc, const uint8_t* data, size_t size)
+{
+    static const uint32_t   TABLE[16U]  =
+    {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+    };
+    size_t                  index       = 0U;
+
+    crc = ~crc;
+
+    for(index = 0U; index < size; ++index)
+    {
+        crc ^= data[index];
+        crc  = (crc >> 4U) ^ TABLE[crc & 0x0FU];
+        crc  = (crc >> 4U) ^ TABLE[crc & 0x0FU];
+    }
+
+    return ~crc;
+}
+
+/**
+ * Update a Adler-32 checksum with the given data.
+ *
+ * @param[in] adler Current checksum, 1 for the first data.
+ * @param[in] data  Data
+ * @param[in] size  Data size in byte
+ *
+ * @return Updated checksum
+ */
+static uint32_t updateAdler32(uint32_t adler, const uint8_t* data, size_t size)
+{
+    const uint32_t  BASE    = 65521U;   /* Largest prime smaller than 65536 */
+    const size_t    NMAX    = 5552U;    /* Max. number of bytes before the sums overflow */
+    uint32_t        a       = adler & 0xFFFFU;
+    uint32_t        b       = (adler >> 16U) & 0xFFFFU;
+
+    while(0U < size)
+    {
+        size_t blockSize = (NMAX < size) ? NMAX : size;
+
+        size -= blockSize;
+
+        while(0U < blockSize)
+        {
+            a += *data;
+            b += a;
+            ++data;
+            --blockSize;
+        }
+
+        a %= BASE;
+        b %= BASE;
+    }
+
+    return (b << 16U) | a;
+}
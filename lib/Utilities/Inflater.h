@@ -0,0 +1,374 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Streaming inflater for deflate, zlib and gzip data
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup utilities
+ *
+ * @{
+ */
+
+#ifndef __INFLATER_H__
+#define __INFLATER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Streaming inflater according to RFC1950 (zlib), RFC1951 (deflate) and
+ * RFC1952 (gzip).
+ *
+ * The compressed data can be written in pieces of any size, e.g. as
+ * received from the network. The decompressed data is provided via a
+ * output function as soon as it is available. Beside the fixed decoder
+ * state, only the window buffer for back references is allocated. Its size
+ * is taken from the zlib header, otherwise the max. size of 32 KB is used.
+ */
+class Inflater
+{
+public:
+
+    /** Data formats */
+    enum Format
+    {
+        FORMAT_RAW = 0, /**< Raw deflate data (RFC1951) */
+        FORMAT_ZLIB,    /**< zlib data (RFC1950). Raw deflate data is detected and accepted too. */
+        FORMAT_GZIP     /**< gzip data (RFC1952) */
+    };
+
+    /** Processing status */
+    enum Status
+    {
+        STATUS_CONTINUE = 0,    /**< More data is expected. */
+        STATUS_DONE,            /**< All data is successful decompressed. */
+        STATUS_ERROR            /**< Invalid or incomplete data */
+    };
+
+    /**
+     * Prototype of the output function, which gets the decompressed data.
+     *
+     * @param[in] arg   Argument, provided in begin()
+     * @param[in] data  Decompressed data
+     * @param[in] size  Decompressed data size in byte
+     */
+    typedef void (*OutputFunc)(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * Constructs the inflater.
+     */
+    Inflater();
+
+    /**
+     * Destroys the inflater.
+     */
+    ~Inflater();
+
+    /**
+     * Start decompression.
+     *
+     * @param[in] format    Data format
+     * @param[in] func      Output function
+     * @param[in] arg       Argument for the output function
+     *
+     * @return If successful started, it will return true otherwise false.
+     */
+    bool begin(Format format, OutputFunc func, void* arg);
+
+    /**
+     * Stop decompression and release the window buffer.
+     */
+    void end();
+
+    /**
+     * Decompress the next piece of compressed data. All of it is consumed.
+     *
+     * @param[in] data  Compressed data
+     * @param[in] size  Compressed data size in byte
+     *
+     * @return Processing status
+     */
+    Status write(const uint8_t* data, size_t size);
+
+    /**
+     * Signal the end of the compressed data and provide the remaining
+     * decompressed data.
+     *
+     * @return If the data was complete and valid, it will return STATUS_DONE otherwise STATUS_ERROR.
+     */
+    Status finish();
+
+    /**
+     * Get the size of the allocated window buffer.
+     *
+     * @return Window buffer size in byte
+     */
+    size_t getWindowSize() const
+    {
+        return (nullptr == m_window) ? 0U : m_windowSize;
+    }
+
+    /**
+     * Get the number of decompressed bytes.
+     *
+     * @return Number of decompressed bytes
+     */
+    uint32_t getOutputSize() const
+    {
+        return m_outputSize;
+    }
+
+    /** Max. window buffer size in byte */
+    static const size_t     MAX_WINDOW_SIZE = 32768U;
+
+private:
+
+    /** Max. number of bits of a huffman code */
+    static const uint8_t    MAX_BITS        = 15U;
+
+    /** Max. number of literal/length symbols */
+    static const uint16_t   MAX_LCODES      = 288U;
+
+    /** Max. number of distance symbols */
+    static const uint16_t   MAX_DCODES      = 30U;
+
+    /** Decoder states */
+    enum State
+    {
+        STATE_IDLE = 0,         /**< Not started */
+        STATE_GZIP_HEADER,      /**< Fixed gzip header */
+        STATE_GZIP_EXTRA_LEN,   /**< gzip extra field length */
+        STATE_GZIP_EXTRA,       /**< gzip extra field */
+        STATE_GZIP_NAME,        /**< gzip file name */
+        STATE_GZIP_COMMENT,     /**< gzip comment */
+        STATE_GZIP_HCRC,        /**< gzip header CRC */
+        STATE_ZLIB_HEADER,      /**< zlib header */
+        STATE_BLOCK_HEADER,     /**< Deflate block header */
+        STATE_STORED_LEN,       /**< Stored block length */
+        STATE_STORED_DATA,      /**< Stored block data */
+        STATE_TABLE_COUNTS,     /**< Dynamic block code counts */
+        STATE_TABLE_CL,         /**< Dynamic block code length code lengths */
+        STATE_TABLE_LENGTHS,    /**< Dynamic block literal/length and distance code lengths */
+        STATE_LEN,              /**< Literal or length symbol */
+        STATE_LEN_EXTRA,        /**< Length extra bits */
+        STATE_DIST,             /**< Distance symbol */
+        STATE_DIST_EXTRA,       /**< Distance extra bits */
+        STATE_TRAILER,          /**< zlib or gzip trailer */
+        STATE_DONE,             /**< Finished */
+        STATE_ERROR             /**< Invalid data */
+    };
+
+    /** Canonical huffman code */
+    struct Huffman
+    {
+        uint16_t    count[MAX_BITS + 1U];   /**< Number of symbols per code length */
+        uint16_t    symbol[MAX_LCODES];     /**< Symbols ordered by their code */
+    };
+
+    Format          m_format;                               /**< Data format */
+    State           m_state;                                /**< Decoder state */
+    OutputFunc      m_outputFunc;                           /**< Output function */
+    void*           m_outputArg;                            /**< Output function argument */
+    const uint8_t*  m_input;                                /**< Current compressed data */
+    size_t          m_inputSize;                            /**< Current compressed data size in byte */
+    size_t          m_inputIndex;                           /**< Current compressed data index */
+    bool            m_isFinishing;                          /**< No further compressed data will follow. */
+    uint32_t        m_bitBuf;                               /**< Bit buffer */
+    uint8_t         m_bitCnt;                               /**< Number of bits in the bit buffer */
+    uint8_t*        m_window;                               /**< Window buffer */
+    size_t          m_windowSize;                           /**< Window buffer size in byte */
+    size_t          m_wrIndex;                              /**< Window write index */
+    size_t          m_flushIndex;                           /**< Window index of the first not provided byte */
+    bool            m_isWindowFull;                         /**< Was the window buffer completely written once? */
+    bool            m_isFinalBlock;                         /**< Is the current block the final one? */
+    uint8_t         m_gzipFlags;                            /**< Remaining gzip header flags */
+    uint8_t         m_bytes[10U];                           /**< Header or trailer bytes */
+    uint16_t        m_count;                                /**< Counter of the current state */
+    uint16_t        m_nlen;                                 /**< Number of literal/length codes */
+    uint16_t        m_ndist;                                /**< Number of distance codes */
+    uint16_t        m_ncode;                                /**< Number of code length codes */
+    uint16_t        m_length;                               /**< Copy length or remaining bytes */
+    uint16_t        m_dist;                                 /**< Copy distance */
+    uint8_t         m_extraBits;                            /**< Number of extra bits */
+    uint8_t         m_lengths[MAX_LCODES + MAX_DCODES];     /**< Code lengths of a dynamic block */
+    Huffman         m_lenCode;                              /**< Literal/length code */
+    Huffman         m_distCode;                             /**< Distance code */
+    uint32_t        m_checksum;                             /**< CRC32 (gzip) or Adler-32 (zlib) */
+    uint32_t        m_outputSize;                           /**< Number of decompressed bytes */
+
+    Inflater(const Inflater& inflater);
+    Inflater& operator=(const Inflater& inflater);
+
+    /**
+     * Run the decoder, until more data is needed or it finished.
+     */
+    void process();
+
+    /**
+     * Process a gzip header state.
+     */
+    void processGzipHeader();
+
+    /**
+     * Process the zlib header.
+     */
+    void processZlibHeader();
+
+    /**
+     * Process a deflate block header or stored block state.
+     */
+    void processBlock();
+
+    /**
+     * Process a dynamic block code table state.
+     */
+    void processTable();
+
+    /**
+     * Process a compressed data state.
+     */
+    void processCodes();
+
+    /**
+     * Process the trailer.
+     */
+    void processTrailer();
+
+    /**
+     * Get the next gzip header state, depended on the remaining flags.
+     *
+     * @return gzip header state
+     */
+    State getNextGzipState() const;
+
+    /**
+     * Fill the bit buffer with the given number of bits.
+     *
+     * @param[in] num   Number of bits, max. 24.
+     *
+     * @return If the bits are available, it will return true otherwise false.
+     */
+    bool needBits(uint8_t num);
+
+    /**
+     * Fill the bit buffer for decoding a huffman code. At the end of the
+     * data, less bits may be available.
+     *
+     * @param[in] num   Number of bits, max. 24.
+     *
+     * @return If decoding can be tried, it will return true otherwise false.
+     */
+    bool needCodeBits(uint8_t num);
+
+    /**
+     * Get bits from the bit buffer.
+     *
+     * @param[in] num   Number of bits
+     *
+     * @return Bits
+     */
+    uint32_t getBits(uint8_t num);
+
+    /**
+     * Discard the bits up to the next byte boundary.
+     */
+    void alignToByte();
+
+    /**
+     * Decode a symbol with the given huffman code.
+     *
+     * @param[in] code  Huffman code
+     *
+     * @return Symbol. If invalid, it will return a negative value.
+     */
+    int32_t decode(const Huffman& code);
+
+    /**
+     * Build a canonical huffman code from the code lengths.
+     *
+     * @param[out] code     Huffman code
+     * @param[in]  lengths  Code lengths
+     * @param[in]  num      Number of symbols
+     *
+     * @return If the code is valid, it will return true otherwise false.
+     */
+    static bool build(Huffman& code, const uint8_t* lengths, uint16_t num);
+
+    /**
+     * Build the fixed huffman codes.
+     */
+    void buildFixed();
+
+    /**
+     * Allocate the window buffer, if not already done.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool allocWindow();
+
+    /**
+     * Write a decompressed byte to the window buffer.
+     *
+     * @param[in] value Decompressed byte
+     */
+    void putByte(uint8_t value);
+
+    /**
+     * Copy a back reference.
+     *
+     * @return If the distance is valid, it will return true otherwise false.
+     */
+    bool copy();
+
+    /**
+     * Provide the not yet provided decompressed data to the output function.
+     */
+    void flush();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __INFLATER_H__ */
+
+/** @} */
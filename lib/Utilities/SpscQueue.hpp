@@ -0,0 +1,196 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Lock-free single producer single consumer queue
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup utilities
+ *
+ * @{
+ */
+
+#ifndef __SPSCQUEUE_HPP__
+#define __SPSCQUEUE_HPP__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Lock-free queue with a fixed capacity for exactly one producer and exactly
+ * one consumer, which may run on different cores. Only the producer may call
+ * push() and only the consumer may call pop().
+ *
+ * @tparam T    Element type
+ * @tparam N    Max. number of elements
+ */
+template < typename T, size_t N >
+class SpscQueue
+{
+public:
+
+    /**
+     * Constructs an empty queue.
+     */
+    SpscQueue() :
+        m_buffer(),
+        m_head(0U),
+        m_tail(0U)
+    {
+    }
+
+    /**
+     * Destroys the queue.
+     */
+    ~SpscQueue()
+    {
+    }
+
+    /**
+     * Append element at the end of the queue. Called only by the producer.
+     *
+     * @param[in] element   Element
+     *
+     * @return If successful, it will return true otherwise false (queue is full).
+     */
+    bool push(const T& element)
+    {
+        bool    isSuccessful    = false;
+        size_t  head            = m_head.load(std::memory_order_relaxed);
+        size_t  next            = nextIndex(head);
+
+        if (m_tail.load(std::memory_order_acquire) != next)
+        {
+            m_buffer[head] = element;
+            m_head.store(next, std::memory_order_release);
+
+            isSuccessful = true;
+        }
+
+        return isSuccessful;
+    }
+
+    /**
+     * Remove element from the front of the queue. Called only by the consumer.
+     *
+     * @param[out] element  Element
+     *
+     * @return If successful, it will return true otherwise false (queue is empty).
+     */
+    bool pop(T& element)
+    {
+        bool    isSuccessful    = false;
+        size_t  tail            = m_tail.load(std::memory_order_relaxed);
+
+        if (m_head.load(std::memory_order_acquire) != tail)
+        {
+            element = m_buffer[tail];
+            m_tail.store(nextIndex(tail), std::memory_order_release);
+
+            isSuccessful = true;
+        }
+
+        return isSuccessful;
+    }
+
+    /**
+     * Is queue empty?
+     * Note, the result may be outdated already, if the other side works on
+     * the queue in parallel.
+     *
+     * @return If queue is empty, it will return true otherwise false.
+     */
+    bool isEmpty() const
+    {
+        return (m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire));
+    }
+
+    /**
+     * Get max. number of elements in the queue.
+     *
+     * @return Capacity
+     */
+    size_t getCapacity() const
+    {
+        return N;
+    }
+
+private:
+
+    /** The ring buffer has one element more than the capacity, to distinguish full from empty. */
+    static const size_t BUFFER_SIZE = N + 1U;
+
+    T                   m_buffer[BUFFER_SIZE];  /**< Ring buffer */
+    std::atomic<size_t> m_head;                 /**< Index of the next element to write, owned by the producer. */
+    std::atomic<size_t> m_tail;                 /**< Index of the next element to read, owned by the consumer. */
+
+    /* An instance shall not be copied. */
+    SpscQueue(const SpscQueue& queue);
+    SpscQueue& operator=(const SpscQueue& queue);
+
+    /**
+     * Get the ring buffer index after the given one.
+     *
+     * @param[in] index Ring buffer index
+     *
+     * @return Next ring buffer index
+     */
+    static size_t nextIndex(size_t index)
+    {
+        ++index;
+
+        if (BUFFER_SIZE <= index)
+        {
+            index = 0U;
+        }
+
+        return index;
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __SPSCQUEUE_HPP__ */
+
+/** @} */
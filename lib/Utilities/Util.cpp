@@ -71,19 +71,24 @@
  * External Functions
  *****************************************************************************/
 
-extern bool Util::strToUInt8(const String& str, uint8_t& value)
+extern bool Util::strToUInt8(const char* str, uint8_t& value)
 {
     bool            success = false;
     char*           endPtr  = nullptr;
     unsigned long   tmp     = 0UL;
 
+    if (nullptr == str)
+    {
+        return false;
+    }
+
     errno = 0;
-    tmp = strtoul(str.c_str(), &endPtr, 0);
+    tmp = strtoul(str, &endPtr, 0);
 
     if ((0 == errno) &&
         (nullptr != endPtr) &&
         ('\0' == *endPtr) &&
-        (str.c_str() != endPtr) &&
+        (str != endPtr) &&
         (UINT8_MAX >= tmp))
     {
         value = static_cast<uint8_t>(tmp);
@@ -93,19 +98,29 @@ extern bool Util::strToUInt8(const String& str, uint8_t& value)
     return success;
 }
 
-extern bool Util::strToUInt16(const String& str, uint16_t& value)
+extern bool Util::strToUInt8(const String& str, uint8_t& value)
+{
+    return strToUInt8(str.c_str(), value);
+}
+
+extern bool Util::strToUInt16(const char* str, uint16_t& value)
 {
     bool            success = false;
     char*           endPtr  = nullptr;
     unsigned long   tmp     = 0UL;
 
+    if (nullptr == str)
+    {
+        return false;
+    }
+
     errno = 0;
-    tmp = strtoul(str.c_str(), &endPtr, 0);
+    tmp = strtoul(str, &endPtr, 0);
 
     if ((0 == errno) &&
         (nullptr != endPtr) &&
         ('\0' == *endPtr) &&
-        (str.c_str() != endPtr) &&
+        (str != endPtr) &&
         (UINT16_MAX >= tmp))
     {
         value = static_cast<uint16_t>(tmp);
@@ -115,19 +130,29 @@ extern bool Util::strToUInt16(const String& str, uint16_t& value)
     return success;
 }
 
-extern bool Util::strToInt32(const String& str, int32_t& value)
+extern bool Util::strToUInt16(const String& str, uint16_t& value)
+{
+    return strToUInt16(str.c_str(), value);
+}
+
+extern bool Util::strToInt32(const char* str, int32_t& value)
 {
     bool    success = false;
     char*   endPtr  = nullptr;
     long    tmp     = 0L;
 
+    if (nullptr == str)
+    {
+        return false;
+    }
+
     errno = 0;
-    tmp = strtol(str.c_str(), &endPtr, 0);
+    tmp = strtol(str, &endPtr, 0);
 
     if ((0 == errno) &&
         (nullptr != endPtr) &&
         ('\0' == *endPtr) &&
-        (str.c_str() != endPtr) &&
+        (str != endPtr) &&
         (INT32_MAX >= tmp))
     {
         value = static_cast<int32_t>(tmp);
@@ -137,19 +162,29 @@ extern bool Util::strToInt32(const String& str, int32_t& value)
     return success;
 }
 
-extern bool Util::strToUInt32(const String& str, uint32_t& value)
+extern bool Util::strToInt32(const String& str, int32_t& value)
+{
+    return strToInt32(str.c_str(), value);
+}
+
+extern bool Util::strToUInt32(const char* str, uint32_t& value)
 {
     bool            success = false;
     char*           endPtr  = nullptr;
     unsigned long   tmp     = 0UL;
 
+    if (nullptr == str)
+    {
+        return false;
+    }
+
     errno = 0;
-    tmp = strtoul(str.c_str(), &endPtr, 0);
+    tmp = strtoul(str, &endPtr, 0);
 
     if ((0 == errno) &&
         (nullptr != endPtr) &&
         ('\0' == *endPtr) &&
-        (str.c_str() != endPtr) &&
+        (str != endPtr) &&
         (UINT32_MAX >= tmp))
     {
         value = static_cast<uint32_t>(tmp);
@@ -159,6 +194,11 @@ extern bool Util::strToUInt32(const String& str, uint32_t& value)
     return success;
 }
 
+extern bool Util::strToUInt32(const String& str, uint32_t& value)
+{
+    return strToUInt32(str.c_str(), value);
+}
+
 extern String Util::uint32ToHex(uint32_t value)
 {
     char buffer[9];  /* Contains a 32-bit value in hex */
@@ -80,6 +80,17 @@ namespace Util
  */
 extern bool strToUInt8(const String& str, uint8_t& value);
 
+/**
+ * Convert a string to uint8_t. String can contain integer number in decimal
+ * or hexadecimal format.
+ *
+ * @param[in]   str     String ('\0' terminated)
+ * @param[out]  value   Converted value
+ *
+ * @return If conversion fails, it will return false otherwise true.
+ */
+extern bool strToUInt8(const char* str, uint8_t& value);
+
 /**
  * Convert a string to uint16_t. String can contain integer number in decimal
  * or hexadecimal format.
@@ -91,6 +102,17 @@ extern bool strToUInt8(const String& str, uint8_t& value);
  */
 extern bool strToUInt16(const String& str, uint16_t& value);
 
+/**
+ * Convert a string to uint16_t. String can contain integer number in decimal
+ * or hexadecimal format.
+ *
+ * @param[in]   str     String ('\0' terminated)
+ * @param[out]  value   Converted value
+ *
+ * @return If conversion fails, it will return false otherwise true.
+ */
+extern bool strToUInt16(const char* str, uint16_t& value);
+
 /**
  * Convert a string to uint32_t. String can contain integer number in decimal
  * or hexadecimal format.
@@ -106,6 +128,21 @@ extern bool strToUInt16(const String& str, uint16_t& value);
  */
 extern bool strToUInt32(const String& str, uint32_t& value);
 
+/**
+ * Convert a string to uint32_t. String can contain integer number in decimal
+ * or hexadecimal format.
+ *
+ * Note, negative values in the string will lead to a successful conversion.
+ * This is a limitation due to fact that the underlying strtoul() cast the
+ * result to unsigned long, which is on the esp32 equal to uint32_t.
+ *
+ * @param[in]   str     String ('\0' terminated)
+ * @param[out]  value   Converted value
+ *
+ * @return If conversion fails, it will return false otherwise true.
+ */
+extern bool strToUInt32(const char* str, uint32_t& value);
+
 /**
  * Convert a string to int32_t. String can contain integer number in decimal
  * or hexadecimal format.
@@ -117,6 +154,17 @@ extern bool strToUInt32(const String& str, uint32_t& value);
  */
 extern bool strToInt32(const String& str, int32_t& value);
 
+/**
+ * Convert a string to int32_t. String can contain integer number in decimal
+ * or hexadecimal format.
+ *
+ * @param[in]   str     String ('\0' terminated)
+ * @param[out]  value   Converted value
+ *
+ * @return If conversion fails, it will return false otherwise true.
+ */
+extern bool strToInt32(const char* str, int32_t& value);
+
 /**
  * Convert uint32_t to hex string, but without "0x" as prefix.
  *
@@ -0,0 +1,184 @@
+# MIT License
+# 
+# Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Prepares the filesystem image content, before it is built or uploaded.
+#
+# The data folder is copied to the build folder and the copy is used as
+# source for the filesystem image:
+# 1. Every reference to a javascript or stylesheet file in the web pages gets
+#    the content hash of the file as version query parameter, e.g.
+#    "/js/menu.js?v=1a2b3c4d". The webserver let the client cache versioned
+#    files without revalidation, because a changed file gets a new URL.
+# 2. The placeholders of the templated web pages are indexed. The webserver
+#    substitutes them with the index, instead of scanning the whole page.
+# 3. Every text file is stored gzip compressed, except web pages with a
+#    tilde, which may be templated. The webserver delivers the compressed
+#    file with content encoding gzip.
+
+import gzip
+import hashlib
+import json
+import os
+import re
+import shutil
+
+Import("env")
+
+# SPIFFS limits the max. filename length, which includes the path as well.
+SPIFFS_FILENAME_LENGTH_LIMIT = 32
+
+# Files with these extensions are stored gzip compressed.
+COMPRESSED_FILE_EXT = [ ".html", ".js", ".css" ]
+
+# Folders, which contain versioned files.
+VERSIONED_FOLDERS = [ "/js/", "/style/" ]
+
+# Filename of the template index in the filesystem.
+TEMPLATE_INDEX_FILENAME = "tmplIndex.json"
+
+# Placeholder in a templated web page, e.g. ~SSID~.
+TEMPLATE_PLACEHOLDER = re.compile(rb"~[A-Za-z0-9_]+~")
+
+# Reference to a file in a web page, e.g. src="/js/menu.js".
+FILE_REFERENCE = re.compile(rb"(src|href)=\"(/[^\"?#]+)\"")
+
+def getFsPath(dataDir, fileName):
+    return "/" + os.path.relpath(fileName, dataDir).replace(os.sep, "/")
+
+def getFiles(dataDir):
+    files = []
+
+    for root, _, fileNames in os.walk(dataDir):
+        for fileName in sorted(fileNames):
+            files.append(os.path.join(root, fileName))
+
+    return sorted(files)
+
+def getVersions(dataDir):
+    versions = {}
+
+    for fileName in getFiles(dataDir):
+        fsPath = getFsPath(dataDir, fileName)
+
+        for folder in VERSIONED_FOLDERS:
+            if (True == fsPath.startswith(folder)):
+                with open(fileName, "rb") as file:
+                    versions[fsPath] = hashlib.sha256(file.read()).hexdigest()[:8]
+
+    return versions
+
+def addVersions(content, versions):
+    def replace(match):
+        fsPath = match.group(2).decode("ascii")
+        result = match.group(0)
+
+        if (fsPath in versions):
+            result = match.group(1) + b"=\"" + match.group(2) + b"?v=" + versions[fsPath].encode("ascii") + b"\""
+
+        return result
+
+    return FILE_REFERENCE.sub(replace, content)
+
+def getPlaceholders(content):
+    placeholders = []
+
+    # A page, which contains a tilde outside of a placeholder, is not indexed.
+    # The webserver handles it like before.
+    if (content.count(b"~") == (2 * len(TEMPLATE_PLACEHOLDER.findall(content)))):
+        for match in TEMPLATE_PLACEHOLDER.finditer(content):
+            placeholders.append(match.start())
+            placeholders.append(match.end() - match.start())
+
+    return placeholders
+
+def compress(fileName, fsPath):
+    isCompressed = False
+
+    if (SPIFFS_FILENAME_LENGTH_LIMIT > len(fsPath + ".gz")):
+        with open(fileName, "rb") as file:
+            content = file.read()
+
+        # The modification time is not stored, which keeps the image reproducible.
+        with open(fileName + ".gz", "wb") as file:
+            with gzip.GzipFile(filename="", mode="wb", compresslevel=9, fileobj=file, mtime=0) as gzipFile:
+                gzipFile.write(content)
+
+        os.remove(fileName)
+        isCompressed = True
+
+    return isCompressed
+
+def prepareDataDir(srcDataDir, dstDataDir):
+    versions = {}
+    tmplIndex = {}
+    compressedFiles = 0
+
+    if (True == os.path.isdir(dstDataDir)):
+        shutil.rmtree(dstDataDir)
+
+    shutil.copytree(srcDataDir, dstDataDir)
+
+    versions = getVersions(dstDataDir)
+
+    for fileName in getFiles(dstDataDir):
+        fsPath = getFsPath(dstDataDir, fileName)
+        fileExt = os.path.splitext(fileName)[1].lower()
+        isTemplated = False
+
+        if (".html" == fileExt):
+            with open(fileName, "rb") as file:
+                content = addVersions(file.read(), versions)
+
+            with open(fileName, "wb") as file:
+                file.write(content)
+
+            placeholders = getPlaceholders(content)
+
+            if (0 < len(placeholders)):
+                tmplIndex[fsPath] = { "size": len(content), "tmpl": placeholders }
+
+            # Every web page with a tilde is kept plain, because the template
+            # engine of the webserver processes it, even without index.
+            if (b"~" in content):
+                isTemplated = True
+
+        if ((False == isTemplated) and (fileExt in COMPRESSED_FILE_EXT)):
+            if (True == compress(fileName, fsPath)):
+                compressedFiles += 1
+
+    with open(os.path.join(dstDataDir, TEMPLATE_INDEX_FILENAME), "w") as file:
+        json.dump(tmplIndex, file, separators=(",", ":"), sort_keys=True)
+
+    print("Versioned files        : " + str(len(versions)))
+    print("Templated web pages    : " + str(len(tmplIndex)))
+    print("Compressed files       : " + str(compressedFiles))
+
+FILESYSTEM_TARGETS = [ "buildfs", "uploadfs", "uploadfsota" ]
+
+if (True == any(target in FILESYSTEM_TARGETS for target in COMMAND_LINE_TARGETS)):
+    srcDataDir = env.subst("$PROJECT_DATA_DIR")
+    dstDataDir = os.path.join(env.subst("$BUILD_DIR"), "data")
+
+    prepareDataDir(srcDataDir, dstDataDir)
+
+    env.Replace(PROJECT_DATA_DIR=dstDataDir)
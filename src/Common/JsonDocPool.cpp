@@ -0,0 +1,350 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pool of JSON document memory
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "JsonDocPool.h"
+
+#include <Logging.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void* JsonDocPool::allocate(size_t size)
+{
+    uint8_t sizeClass   = getSizeClass(size);
+    Header* header      = nullptr;
+    void*   block       = nullptr;
+
+    lock();
+
+    /* Use a kept block of the same size class, if available. */
+    if ((SIZE_CLASSES > sizeClass) &&
+        (nullptr != m_cache[sizeClass]))
+    {
+        CachedBlock* cachedBlock = m_cache[sizeClass];
+
+        m_cache[sizeClass] = cachedBlock->next;
+        --m_cacheCount[sizeClass];
+
+        header = reinterpret_cast<Header*>(cachedBlock) - 1;
+        ++m_statistics[sizeClass].reused;
+    }
+    else
+    {
+        header = static_cast<Header*>(malloc(sizeof(Header) + getBlockSize(size)));
+    }
+
+    if (nullptr != header)
+    {
+        Statistics& statistics = m_statistics[sizeClass];
+
+        header->sizeClass = sizeClass;
+        block = &header[1];
+
+        ++statistics.allocations;
+        ++statistics.inUse;
+
+        if (statistics.peakInUse < statistics.inUse)
+        {
+            statistics.peakInUse = statistics.inUse;
+        }
+    }
+
+    unlock();
+
+    return block;
+}
+
+void JsonDocPool::release(void* block)
+{
+    if (nullptr != block)
+    {
+        Header*     header      = static_cast<Header*>(block) - 1;
+        uint8_t     sizeClass   = header->sizeClass;
+        Statistics& statistics  = m_statistics[sizeClass];
+
+        lock();
+
+        if (0U < statistics.inUse)
+        {
+            --statistics.inUse;
+        }
+
+        /* Keep the block for the next allocation? */
+        if ((SIZE_CLASSES > sizeClass) &&
+            (MAX_CACHED_BLOCKS > m_cacheCount[sizeClass]))
+        {
+            CachedBlock* cachedBlock = static_cast<CachedBlock*>(block);
+
+            cachedBlock->next   = m_cache[sizeClass];
+            m_cache[sizeClass]  = cachedBlock;
+            ++m_cacheCount[sizeClass];
+        }
+        else
+        {
+            free(header);
+        }
+
+        unlock();
+    }
+
+    return;
+}
+
+void* JsonDocPool::reallocate(void* block, size_t size)
+{
+    void* newBlock = nullptr;
+
+    if (nullptr == block)
+    {
+        newBlock = allocate(size);
+    }
+    else
+    {
+        Header* header      = static_cast<Header*>(block) - 1;
+        uint8_t sizeClass   = header->sizeClass;
+
+        /* Large blocks are not kept, therefore they are resized directly. */
+        if (SIZE_CLASSES <= sizeClass)
+        {
+            header = static_cast<Header*>(realloc(header, sizeof(Header) + size));
+
+            if (nullptr != header)
+            {
+                newBlock = &header[1];
+            }
+        }
+        /* Fits the requested size still into the block? */
+        else if (size <= (MIN_BLOCK_SIZE << sizeClass))
+        {
+            newBlock = block;
+        }
+        else
+        {
+            newBlock = allocate(size);
+
+            if (nullptr != newBlock)
+            {
+                memcpy(newBlock, block, MIN_BLOCK_SIZE << sizeClass);
+                release(block);
+            }
+        }
+    }
+
+    return newBlock;
+}
+
+void JsonDocPool::reportUsage(size_t capacity, size_t usage, bool isOverflowed)
+{
+    Statistics& statistics = m_statistics[getSizeClass(capacity)];
+
+    lock();
+
+    if (statistics.maxUsage < usage)
+    {
+        statistics.maxUsage = usage;
+    }
+
+    if (true == isOverflowed)
+    {
+        ++statistics.overflows;
+    }
+
+    unlock();
+
+    return;
+}
+
+bool JsonDocPool::getStatistics(uint8_t sizeClass, Statistics& statistics) const
+{
+    bool isSuccessful = false;
+
+    if (SIZE_CLASSES >= sizeClass)
+    {
+        lock();
+        statistics = m_statistics[sizeClass];
+        unlock();
+
+        isSuccessful = true;
+    }
+
+    return isSuccessful;
+}
+
+void JsonDocPool::logStatistics() const
+{
+    uint8_t sizeClass = 0U;
+
+    for(sizeClass = 0U; sizeClass <= SIZE_CLASSES; ++sizeClass)
+    {
+        Statistics statistics;
+
+        if ((true == getStatistics(sizeClass, statistics)) &&
+            (0U < statistics.allocations))
+        {
+            char blockSize[8];
+
+            if (SIZE_CLASSES > sizeClass)
+            {
+                (void)snprintf(blockSize, sizeof(blockSize), "%u", static_cast<uint32_t>(MIN_BLOCK_SIZE << sizeClass));
+            }
+            else
+            {
+                (void)snprintf(blockSize, sizeof(blockSize), "large");
+            }
+
+            LOG_INFO("JSON doc %s: %u alloc., %u reused, %u peak in use, %u byte max. used, %u overflows",
+                blockSize,
+                statistics.allocations,
+                statistics.reused,
+                statistics.peakInUse,
+                statistics.maxUsage,
+                statistics.overflows);
+        }
+    }
+
+    return;
+}
+
+size_t JsonDocPool::getBlockSize(size_t size)
+{
+    uint8_t sizeClass = getSizeClass(size);
+    size_t  blockSize = size;
+
+    if (SIZE_CLASSES > sizeClass)
+    {
+        blockSize = MIN_BLOCK_SIZE << sizeClass;
+    }
+
+    return blockSize;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+JsonDocPool::JsonDocPool() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_cache(),
+    m_cacheCount(),
+    m_statistics()
+{
+    uint8_t sizeClass = 0U;
+
+    for(sizeClass = 0U; sizeClass < SIZE_CLASSES; ++sizeClass)
+    {
+        m_cache[sizeClass]      = nullptr;
+        m_cacheCount[sizeClass] = 0U;
+    }
+
+    for(sizeClass = 0U; sizeClass <= SIZE_CLASSES; ++sizeClass)
+    {
+        Statistics& statistics = m_statistics[sizeClass];
+
+        statistics.allocations  = 0U;
+        statistics.reused       = 0U;
+        statistics.inUse        = 0U;
+        statistics.peakInUse    = 0U;
+        statistics.maxUsage     = 0U;
+        statistics.overflows    = 0U;
+    }
+}
+
+uint8_t JsonDocPool::getSizeClass(size_t size)
+{
+    uint8_t sizeClass = 0U;
+    size_t  blockSize = MIN_BLOCK_SIZE;
+
+    while((SIZE_CLASSES > sizeClass) && (blockSize < size))
+    {
+        ++sizeClass;
+        blockSize <<= 1U;
+    }
+
+    return sizeClass;
+}
+
+void JsonDocPool::lock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void JsonDocPool::unlock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,321 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pool of JSON document memory
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup common
+ *
+ * @{
+ */
+
+#ifndef __JSON_DOC_POOL_H__
+#define __JSON_DOC_POOL_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The JSON document pool provides the memory for the JSON documents, which
+ * are only temporary used, e.g. to load or save a configuration or to
+ * handle a web request.
+ *
+ * The memory blocks are organized in size classes, starting with
+ * MIN_BLOCK_SIZE and doubled with every class. A requested size is rounded
+ * up to its size class. A released block is kept for the next document
+ * of the same size class, until MAX_CACHED_BLOCKS are kept. Therefore the
+ * same blocks are used again and again, instead of fragmenting the heap.
+ *
+ * Requests, which are larger than the largest size class, are allocated
+ * directly from the heap.
+ *
+ * Every size class provides statistics about the number of allocations,
+ * the peak of simultaneous used blocks and the max. memory usage of the
+ * documents. They are reported periodically by the memory monitor.
+ */
+class JsonDocPool
+{
+public:
+
+    /**
+     * Statistics of a size class.
+     */
+    struct Statistics
+    {
+        uint32_t    allocations;    /**< Number of allocations */
+        uint32_t    reused;         /**< Number of allocations, served by a kept block. */
+        uint32_t    inUse;          /**< Number of blocks, which are currently used. */
+        uint32_t    peakInUse;      /**< Max. number of simultaneous used blocks */
+        size_t      maxUsage;       /**< Max. memory usage of a document in byte */
+        uint32_t    overflows;      /**< Number of documents, which had too less memory. */
+    };
+
+    /**
+     * Get JSON document pool instance.
+     *
+     * @return JSON document pool instance
+     */
+    static JsonDocPool& getInstance()
+    {
+        static JsonDocPool instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Allocate a memory block.
+     *
+     * @param[in] size  Requested size in byte
+     *
+     * @return If successful, it will return the memory block otherwise nullptr.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Release a memory block. It is kept for a later allocation, as long as
+     * its size class has room for it.
+     *
+     * @param[in] block Memory block, which was allocated by the pool.
+     */
+    void release(void* block);
+
+    /**
+     * Change the size of a memory block. As long as the requested size fits
+     * into the size class of the block, the block is kept.
+     *
+     * @param[in] block Memory block, which was allocated by the pool.
+     * @param[in] size  Requested size in byte
+     *
+     * @return If successful, it will return the memory block otherwise nullptr.
+     */
+    void* reallocate(void* block, size_t size);
+
+    /**
+     * Report the memory usage of a document, before it is destroyed.
+     *
+     * @param[in] capacity      Document capacity in byte
+     * @param[in] usage         Document memory usage in byte
+     * @param[in] isOverflowed  Had the document too less memory?
+     */
+    void reportUsage(size_t capacity, size_t usage, bool isOverflowed);
+
+    /**
+     * Get the statistics of a size class.
+     *
+     * @param[in]   sizeClass   Size class index [0; SIZE_CLASSES]. The last one
+     *                          covers all sizes above the largest size class.
+     * @param[out]  statistics  Statistics
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool getStatistics(uint8_t sizeClass, Statistics& statistics) const;
+
+    /**
+     * Log the statistics of all used size classes.
+     */
+    void logStatistics() const;
+
+    /**
+     * Get the size of a memory block, which is used for the requested size.
+     * A document can use the whole block.
+     *
+     * @param[in] size  Requested size in byte
+     *
+     * @return Block size in byte
+     */
+    static size_t getBlockSize(size_t size);
+
+    /** Block size of the smallest size class in byte */
+    static const size_t     MIN_BLOCK_SIZE      = 256U;
+
+    /** Number of size classes */
+    static const uint8_t    SIZE_CLASSES        = 5U;
+
+    /** Max. number of released blocks, which are kept per size class. */
+    static const uint8_t    MAX_CACHED_BLOCKS   = 2U;
+
+private:
+
+    /**
+     * Header in front of every memory block.
+     * The union keeps the alignment of the block, which follows.
+     */
+    union Header
+    {
+        uint8_t     sizeClass;  /**< Size class index */
+        void*       ptr;        /**< Unused, only for alignment */
+        double      value;      /**< Unused, only for alignment */
+    };
+
+    /**
+     * A kept memory block. It uses the memory of the block itself.
+     */
+    struct CachedBlock
+    {
+        CachedBlock*    next;   /**< Next kept block of the same size class */
+    };
+
+    mutable SemaphoreHandle_t   m_xMutex;                           /**< Mutex to protect the pool. */
+    CachedBlock*                m_cache[SIZE_CLASSES];              /**< Kept blocks per size class */
+    uint8_t                     m_cacheCount[SIZE_CLASSES];         /**< Number of kept blocks per size class */
+    Statistics                  m_statistics[SIZE_CLASSES + 1U];    /**< Statistics per size class, the last one is for large blocks. */
+
+    /**
+     * Constructs the JSON document pool.
+     */
+    JsonDocPool();
+
+    /**
+     * Destroys the JSON document pool.
+     */
+    ~JsonDocPool()
+    {
+        /* Will never be called. */
+    }
+
+    JsonDocPool(const JsonDocPool& pool);
+    JsonDocPool& operator=(const JsonDocPool& pool);
+
+    /**
+     * Get the size class index of a requested size.
+     *
+     * @param[in] size  Requested size in byte
+     *
+     * @return Size class index. If the size is larger than the largest size class, it will return SIZE_CLASSES.
+     */
+    static uint8_t getSizeClass(size_t size);
+
+    /**
+     * Protect against concurrent access.
+     */
+    void lock() const;
+
+    /**
+     * Unprotect against concurrent access.
+     */
+    void unlock() const;
+};
+
+/**
+ * Allocator for the ArduinoJson documents, which uses the JSON document pool.
+ */
+class JsonDocPoolAllocator
+{
+public:
+
+    /**
+     * Allocate memory.
+     *
+     * @param[in] size  Size in byte
+     *
+     * @return If successful, it will return the memory otherwise nullptr.
+     */
+    void* allocate(size_t size)
+    {
+        return JsonDocPool::getInstance().allocate(size);
+    }
+
+    /**
+     * Release memory.
+     *
+     * @param[in] ptr   Memory
+     */
+    void deallocate(void* ptr)
+    {
+        JsonDocPool::getInstance().release(ptr);
+    }
+
+    /**
+     * Change memory size.
+     *
+     * @param[in] ptr       Memory
+     * @param[in] newSize   New size in byte
+     *
+     * @return If successful, it will return the memory otherwise nullptr.
+     */
+    void* reallocate(void* ptr, size_t newSize)
+    {
+        return JsonDocPool::getInstance().reallocate(ptr, newSize);
+    }
+};
+
+/**
+ * JSON document, which gets its memory from the JSON document pool.
+ * It is used like a DynamicJsonDocument. The capacity is rounded up to the
+ * size class and the memory usage is reported to the pool statistics.
+ */
+class PooledJsonDocument : public BasicJsonDocument<JsonDocPoolAllocator>
+{
+public:
+
+    /**
+     * Constructs a JSON document.
+     *
+     * @param[in] capacity  Min. capacity in byte
+     */
+    explicit PooledJsonDocument(size_t capacity) :
+        BasicJsonDocument<JsonDocPoolAllocator>(JsonDocPool::getBlockSize(capacity))
+    {
+    }
+
+    /**
+     * Destroys the JSON document.
+     */
+    ~PooledJsonDocument()
+    {
+        JsonDocPool::getInstance().reportUsage(capacity(), memoryUsage(), overflowed());
+    }
+
+private:
+
+    PooledJsonDocument(const PooledJsonDocument& doc);
+    PooledJsonDocument& operator=(const PooledJsonDocument& doc);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __JSON_DOC_POOL_H__ */
+
+/** @} */
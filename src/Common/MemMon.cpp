@@ -33,6 +33,8 @@
  * Includes
  *****************************************************************************/
 #include "MemMon.h"
+#include "DisplayMgr.h"
+#include "JsonDocPool.h"
 
 #include <Logging.h>
 
@@ -79,6 +81,8 @@ void MemMon::process()
     {
         uint32_t minFreeHeap        = ESP.getMinFreeHeap();
         uint32_t minFreeHeapBlock   = ESP.getMaxAllocHeap();
+        uint8_t  hibernatedPlugins  = 0U;
+        uint32_t reclaimedHeap      = DisplayMgr::getInstance().getReclaimedHeap(hibernatedPlugins);
 
         if (MIN_HEAP_MEMORY >= minFreeHeap)
         {
@@ -90,6 +94,14 @@ void MemMon::process()
             LOG_WARNING("Largest heap block which can be allocated is %u byte.", minFreeHeapBlock);
         }
 
+        if (0U < hibernatedPlugins)
+        {
+            LOG_INFO("%u hibernated plugins reclaimed %u byte heap.", hibernatedPlugins, reclaimedHeap);
+        }
+
+        /* Report the really needed JSON document sizes. */
+        JsonDocPool::getInstance().logStatistics();
+
         /* Any heap corrupt? */
         if (false == heap_caps_check_integrity_all(true))
         {
@@ -113,6 +113,24 @@ static const char*  KEY_SLOT_CONFIG                 = "slot_cfg";
 /** Scroll pause key */
 static const char*  KEY_SCROLL_PAUSE                = "scroll_pause";
 
+/** Slot prepare time key */
+static const char*  KEY_SLOT_PREPARE_TIME           = "slot_prep";
+
+/** Plugin hibernation time key */
+static const char*  KEY_HIBERNATION_TIME            = "hibernate";
+
+/** MQTT broker address key */
+static const char*  KEY_MQTT_BROKER                 = "mqtt_broker";
+
+/** MQTT broker port key */
+static const char*  KEY_MQTT_PORT                   = "mqtt_port";
+
+/** MQTT user name key */
+static const char*  KEY_MQTT_USER                   = "mqtt_user";
+
+/** MQTT password key */
+static const char*  KEY_MQTT_PASSWORD               = "mqtt_pass";
+
 /* ---------- Key value pair names ---------- */
 
 /** Wifi network name of key value pair */
@@ -163,6 +181,24 @@ static const char*  NAME_SLOT_CONFIG                = "Display slot configuratio
 /** Scroll pause name */
 static const char*  NAME_SCROLL_PAUSE               = "Text scroll pause [ms]";
 
+/** Slot prepare time name */
+static const char*  NAME_SLOT_PREPARE_TIME          = "Slot prepare time [ms]";
+
+/** Plugin hibernation time name */
+static const char*  NAME_HIBERNATION_TIME           = "Plugin hibernation time [s]";
+
+/** MQTT broker address name */
+static const char*  NAME_MQTT_BROKER                = "MQTT broker address (empty: disabled)";
+
+/** MQTT broker port name */
+static const char*  NAME_MQTT_PORT                  = "MQTT broker port";
+
+/** MQTT user name name */
+static const char*  NAME_MQTT_USER                  = "MQTT user";
+
+/** MQTT password name */
+static const char*  NAME_MQTT_PASSWORD              = "MQTT password";
+
 /* ---------- Default values ---------- */
 
 /** Wifi network default value */
@@ -213,6 +249,24 @@ static const char*      DEFAULT_SLOT_CONFIG             = "";
 /** Scroll pause default value in ms */
 static uint32_t         DEFAULT_SCROLL_PAUSE            = 80U;
 
+/** Slot prepare time default value in ms */
+static uint32_t         DEFAULT_SLOT_PREPARE_TIME       = 1000U;
+
+/** Plugin hibernation time default value in s, hibernation is disabled. */
+static uint32_t         DEFAULT_HIBERNATION_TIME        = 0U;
+
+/** MQTT broker address default value, MQTT is disabled. */
+static const char*      DEFAULT_MQTT_BROKER             = "";
+
+/** MQTT broker port default value */
+static uint32_t         DEFAULT_MQTT_PORT               = 1883U;
+
+/** MQTT user name default value */
+static const char*      DEFAULT_MQTT_USER               = "";
+
+/** MQTT password default value */
+static const char*      DEFAULT_MQTT_PASSWORD           = "";
+
 /* ---------- Minimum values ---------- */
 
 /** Wifi network SSID min. length. Section 7.3.2.1 of the 802.11-2007 specification. */
@@ -260,6 +314,24 @@ static const size_t     MIN_VALUE_SLOT_CONFIG           = 0U;
 /** Scroll pause minimum value in ms */
 static uint32_t         MIN_VALUE_SCROLL_PAUSE          = 20U;
 
+/** Slot prepare time minimum value in ms */
+static uint32_t         MIN_VALUE_SLOT_PREPARE_TIME     = 0U;
+
+/** Plugin hibernation time minimum value in s */
+static uint32_t         MIN_VALUE_HIBERNATION_TIME      = 0U;
+
+/** MQTT broker address min. length */
+static const size_t     MIN_VALUE_MQTT_BROKER           = 0U;
+
+/** MQTT broker port minimum value */
+static uint32_t         MIN_VALUE_MQTT_PORT             = 1U;
+
+/** MQTT user name min. length */
+static const size_t     MIN_VALUE_MQTT_USER             = 0U;
+
+/** MQTT password min. length */
+static const size_t     MIN_VALUE_MQTT_PASSWORD         = 0U;
+
 /* ---------- Maximum values ---------- */
 
 /** Wifi network SSID max. length. Section 7.3.2.1 of the 802.11-2007 specification. */
@@ -307,6 +379,24 @@ static const size_t     MAX_VALUE_SLOT_CONFIG           = 256U;
 /** Scroll pause maximum value in ms */
 static uint32_t         MAX_VALUE_SCROLL_PAUSE          = 500U;
 
+/** Slot prepare time maximum value in ms */
+static uint32_t         MAX_VALUE_SLOT_PREPARE_TIME     = 10000U;
+
+/** Plugin hibernation time maximum value in s */
+static uint32_t         MAX_VALUE_HIBERNATION_TIME      = 86400U;
+
+/** MQTT broker address max. length */
+static const size_t     MAX_VALUE_MQTT_BROKER           = 63U;
+
+/** MQTT broker port maximum value */
+static uint32_t         MAX_VALUE_MQTT_PORT             = 65535U;
+
+/** MQTT user name max. length */
+static const size_t     MAX_VALUE_MQTT_USER             = 32U;
+
+/** MQTT password max. length */
+static const size_t     MAX_VALUE_MQTT_PASSWORD         = 64U;
+
 /******************************************************************************
  * Public Methods
  *****************************************************************************/
@@ -368,7 +458,13 @@ Settings::Settings() :
     m_dateFormatCtrl        (m_preferences, KEY_DATE_FORMAT,            NAME_DATE_FORMAT_CTRL,      DEFAULT_DATE_FORMAT_CTRL),
     m_maxSlots              (m_preferences, KEY_MAX_SLOTS,              NAME_MAX_SLOTS,             DEFAULT_MAX_SLOTS,              MIN_MAX_SLOTS,                  MAX_MAX_SLOTS),
     m_slotConfig            (m_preferences, KEY_SLOT_CONFIG,            NAME_SLOT_CONFIG,           DEFAULT_SLOT_CONFIG,            MIN_VALUE_SLOT_CONFIG,          MAX_VALUE_SLOT_CONFIG),
-    m_scrollPause           (m_preferences, KEY_SCROLL_PAUSE,           NAME_SCROLL_PAUSE,          DEFAULT_SCROLL_PAUSE,           MIN_VALUE_SCROLL_PAUSE,         MAX_VALUE_SCROLL_PAUSE)
+    m_scrollPause           (m_preferences, KEY_SCROLL_PAUSE,           NAME_SCROLL_PAUSE,          DEFAULT_SCROLL_PAUSE,           MIN_VALUE_SCROLL_PAUSE,         MAX_VALUE_SCROLL_PAUSE),
+    m_slotPrepareTime       (m_preferences, KEY_SLOT_PREPARE_TIME,      NAME_SLOT_PREPARE_TIME,     DEFAULT_SLOT_PREPARE_TIME,      MIN_VALUE_SLOT_PREPARE_TIME,    MAX_VALUE_SLOT_PREPARE_TIME),
+    m_hibernationTime       (m_preferences, KEY_HIBERNATION_TIME,       NAME_HIBERNATION_TIME,      DEFAULT_HIBERNATION_TIME,       MIN_VALUE_HIBERNATION_TIME,     MAX_VALUE_HIBERNATION_TIME),
+    m_mqttBroker            (m_preferences, KEY_MQTT_BROKER,            NAME_MQTT_BROKER,           DEFAULT_MQTT_BROKER,            MIN_VALUE_MQTT_BROKER,          MAX_VALUE_MQTT_BROKER),
+    m_mqttPort              (m_preferences, KEY_MQTT_PORT,              NAME_MQTT_PORT,             DEFAULT_MQTT_PORT,              MIN_VALUE_MQTT_PORT,            MAX_VALUE_MQTT_PORT),
+    m_mqttUser              (m_preferences, KEY_MQTT_USER,              NAME_MQTT_USER,             DEFAULT_MQTT_USER,              MIN_VALUE_MQTT_USER,            MAX_VALUE_MQTT_USER),
+    m_mqttPassword          (m_preferences, KEY_MQTT_PASSWORD,          NAME_MQTT_PASSWORD,         DEFAULT_MQTT_PASSWORD,          MIN_VALUE_MQTT_PASSWORD,        MAX_VALUE_MQTT_PASSWORD)
 {
     uint8_t idx = 0;
 
@@ -403,6 +499,18 @@ Settings::Settings() :
     m_keyValueList[idx] = &m_slotConfig;
     ++idx;
     m_keyValueList[idx] = &m_scrollPause;
+    ++idx;
+    m_keyValueList[idx] = &m_slotPrepareTime;
+    ++idx;
+    m_keyValueList[idx] = &m_hibernationTime;
+    ++idx;
+    m_keyValueList[idx] = &m_mqttBroker;
+    ++idx;
+    m_keyValueList[idx] = &m_mqttPort;
+    ++idx;
+    m_keyValueList[idx] = &m_mqttUser;
+    ++idx;
+    m_keyValueList[idx] = &m_mqttPassword;
 }
 
 Settings::~Settings()
@@ -256,6 +256,68 @@ public:
         return m_scrollPause;
     }
 
+    /**
+     * Get slot prepare time, which is the time before a slot change, when
+     * the plugin in the next slot is prepared.
+     *
+     * @return Key value pair
+     */
+    KeyValueUInt32& getSlotPrepareTime()
+    {
+        return m_slotPrepareTime;
+    }
+
+    /**
+     * Get plugin hibernation time in s, which is the time a plugin must be
+     * invisible, until it is hibernated.
+     *
+     * @return Key value pair
+     */
+    KeyValueUInt32& getHibernationTime()
+    {
+        return m_hibernationTime;
+    }
+
+    /**
+     * Get MQTT broker address.
+     *
+     * @return Key value pair
+     */
+    KeyValueString& getMqttBroker()
+    {
+        return m_mqttBroker;
+    }
+
+    /**
+     * Get MQTT broker port.
+     *
+     * @return Key value pair
+     */
+    KeyValueUInt32& getMqttPort()
+    {
+        return m_mqttPort;
+    }
+
+    /**
+     * Get MQTT user name.
+     *
+     * @return Key value pair
+     */
+    KeyValueString& getMqttUser()
+    {
+        return m_mqttUser;
+    }
+
+    /**
+     * Get MQTT password.
+     *
+     * @return Key value pair
+     */
+    KeyValueString& getMqttPassword()
+    {
+        return m_mqttPassword;
+    }
+
     /**
      * Get a list of all key value pairs.
      *
@@ -278,7 +340,7 @@ public:
     }
 
     /** Number of key value pairs. */
-    static const uint8_t KEY_VALUE_PAIR_NUM = 16U;
+    static const uint8_t KEY_VALUE_PAIR_NUM = 22U;
 
 private:
 
@@ -301,6 +363,12 @@ private:
     KeyValueUInt8   m_maxSlots;             /**< Max. number of display slots. */
     KeyValueJson    m_slotConfig;           /**< Display slot configuration */
     KeyValueUInt32  m_scrollPause;          /**< Text scroll pause */
+    KeyValueUInt32  m_slotPrepareTime;      /**< Slot prepare time */
+    KeyValueUInt32  m_hibernationTime;      /**< Plugin hibernation time */
+    KeyValueString  m_mqttBroker;           /**< MQTT broker address */
+    KeyValueUInt32  m_mqttPort;             /**< MQTT broker port */
+    KeyValueString  m_mqttUser;             /**< MQTT user name */
+    KeyValueString  m_mqttPassword;         /**< MQTT password */
 
     /**
      * Constructs the settings instance.
@@ -0,0 +1,420 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Worker pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "WorkerPool.h"
+
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool WorkerPool::begin()
+{
+    bool    status  = false;
+
+    /* Not started yet? */
+    if (nullptr == m_xMutex)
+    {
+        m_xMutex    = xSemaphoreCreateMutex();
+        m_xJobReady = xSemaphoreCreateBinary();
+
+        if ((nullptr != m_xMutex) &&
+            (nullptr != m_xJobReady))
+        {
+            uint8_t index = 0U;
+
+            /* Tasks shall run */
+            m_taskExit  = false;
+            m_jobHead   = 0U;
+            m_jobCnt    = 0U;
+            status      = true;
+
+            for(index = 0U; index < WORKER_NUM; ++index)
+            {
+                Worker& worker = m_workers[index];
+
+                worker.pool         = this;
+                worker.taskHandle   = nullptr;
+                worker.isBusy       = false;
+                worker.arg          = nullptr;
+                worker.waiterCnt    = 0U;
+                worker.xSemaphore   = xSemaphoreCreateBinary();
+                worker.xJobFinished = xSemaphoreCreateBinary();
+
+                if ((nullptr == worker.xSemaphore) ||
+                    (nullptr == worker.xJobFinished))
+                {
+                    status = false;
+                }
+                else if (pdPASS != xTaskCreateUniversal(workerTask,
+                                                        "workerTask",
+                                                        TASK_STACK_SIZE,
+                                                        &worker,
+                                                        TASK_PRIORITY,
+                                                        &worker.taskHandle,
+                                                        TASK_RUN_CORE))
+                {
+                    worker.taskHandle = nullptr;
+                    status = false;
+                }
+                else
+                {
+                    (void)xSemaphoreGive(worker.xSemaphore);
+                }
+            }
+        }
+
+        if (false == status)
+        {
+            end();
+        }
+        else
+        {
+            LOG_INFO("Worker pool is up.");
+        }
+    }
+
+    return status;
+}
+
+void WorkerPool::end()
+{
+    uint8_t index = 0U;
+
+    m_taskExit = true;
+
+    /* Join */
+    for(index = 0U; index < WORKER_NUM; ++index)
+    {
+        Worker& worker = m_workers[index];
+
+        if (nullptr != worker.taskHandle)
+        {
+            (void)xSemaphoreTake(worker.xSemaphore, portMAX_DELAY);
+            worker.taskHandle = nullptr;
+        }
+
+        if (nullptr != worker.xSemaphore)
+        {
+            vSemaphoreDelete(worker.xSemaphore);
+            worker.xSemaphore = nullptr;
+        }
+
+        if (nullptr != worker.xJobFinished)
+        {
+            vSemaphoreDelete(worker.xJobFinished);
+            worker.xJobFinished = nullptr;
+        }
+    }
+
+    if (nullptr != m_xJobReady)
+    {
+        vSemaphoreDelete(m_xJobReady);
+        m_xJobReady = nullptr;
+    }
+
+    if (nullptr != m_xMutex)
+    {
+        vSemaphoreDelete(m_xMutex);
+        m_xMutex = nullptr;
+
+        /* Pending jobs are discarded. */
+        m_jobHead   = 0U;
+        m_jobCnt    = 0U;
+
+        LOG_INFO("Worker pool is down.");
+    }
+
+    return;
+}
+
+bool WorkerPool::submit(JobFunc func, void* arg)
+{
+    bool isSuccessful = false;
+
+    if ((nullptr != func) &&
+        (nullptr != m_xMutex) &&
+        (false == m_taskExit))
+    {
+        lock();
+
+        if (QUEUE_SIZE > m_jobCnt)
+        {
+            Job& job = m_jobs[(m_jobHead + m_jobCnt) % QUEUE_SIZE];
+
+            job.func = func;
+            job.arg  = arg;
+            ++m_jobCnt;
+
+            isSuccessful = true;
+        }
+
+        unlock();
+
+        if (true == isSuccessful)
+        {
+            (void)xSemaphoreGive(m_xJobReady);
+        }
+        else
+        {
+            LOG_WARNING("Job queue is full.");
+        }
+    }
+
+    return isSuccessful;
+}
+
+void WorkerPool::cancel(const void* arg)
+{
+    if (nullptr == m_xMutex)
+    {
+        return;
+    }
+
+    lock();
+
+    /* Remove all pending jobs with this argument, but keep the order of the others. */
+    if (0U < m_jobCnt)
+    {
+        uint8_t readIdx = 0U;
+        uint8_t jobCnt  = 0U;
+
+        for(readIdx = 0U; readIdx < m_jobCnt; ++readIdx)
+        {
+            const Job& job = m_jobs[(m_jobHead + readIdx) % QUEUE_SIZE];
+
+            if (arg != job.arg)
+            {
+                m_jobs[(m_jobHead + jobCnt) % QUEUE_SIZE] = job;
+                ++jobCnt;
+            }
+        }
+
+        m_jobCnt = jobCnt;
+    }
+
+    unlock();
+
+    /* Wait until a running job with this argument is finished.
+     * A woken up waiter checks again, because the job may have been
+     * submitted again meanwhile.
+     */
+    while(true == waitForJob(arg))
+    {
+        ;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool WorkerPool::takeJob(Worker& worker, Job& job)
+{
+    bool isAvailable = false;
+
+    lock();
+
+    if (0U < m_jobCnt)
+    {
+        job = m_jobs[m_jobHead];
+
+        m_jobHead = (m_jobHead + 1U) % QUEUE_SIZE;
+        --m_jobCnt;
+
+        worker.isBusy   = true;
+        worker.arg      = job.arg;
+
+        /* Wake up the next worker, if there is still something to do. */
+        if (0U < m_jobCnt)
+        {
+            (void)xSemaphoreGive(m_xJobReady);
+        }
+
+        isAvailable = true;
+    }
+
+    unlock();
+
+    return isAvailable;
+}
+
+void WorkerPool::finishJob(Worker& worker)
+{
+    lock();
+
+    worker.isBusy   = false;
+    worker.arg      = nullptr;
+
+    if (0U < worker.waiterCnt)
+    {
+        (void)xSemaphoreGive(worker.xJobFinished);
+    }
+
+    unlock();
+
+    return;
+}
+
+bool WorkerPool::waitForJob(const void* arg)
+{
+    Worker* busyWorker  = nullptr;
+    uint8_t index       = 0U;
+
+    lock();
+
+    for(index = 0U; index < WORKER_NUM; ++index)
+    {
+        if ((true == m_workers[index].isBusy) &&
+            (arg == m_workers[index].arg))
+        {
+            busyWorker = &m_workers[index];
+        }
+    }
+
+    if (nullptr != busyWorker)
+    {
+        ++busyWorker->waiterCnt;
+    }
+
+    unlock();
+
+    if (nullptr != busyWorker)
+    {
+        (void)xSemaphoreTake(busyWorker->xJobFinished, portMAX_DELAY);
+
+        lock();
+
+        --busyWorker->waiterCnt;
+
+        /* The binary semaphore wakes up only one waiter, therefore it is passed on. */
+        if (0U < busyWorker->waiterCnt)
+        {
+            (void)xSemaphoreGive(busyWorker->xJobFinished);
+        }
+
+        unlock();
+    }
+
+    return (nullptr != busyWorker);
+}
+
+void WorkerPool::workerTask(void* parameters)
+{
+    Worker* worker = reinterpret_cast<Worker*>(parameters);
+
+    if ((nullptr != worker) &&
+        (nullptr != worker->pool) &&
+        (nullptr != worker->xSemaphore))
+    {
+        WorkerPool* pool = worker->pool;
+
+        (void)xSemaphoreTake(worker->xSemaphore, portMAX_DELAY);
+
+        while(false == pool->m_taskExit)
+        {
+            if (pdTRUE == xSemaphoreTake(pool->m_xJobReady, pdMS_TO_TICKS(JOB_WAIT_TIMEOUT)))
+            {
+                Job job;
+
+                if (true == pool->takeJob(*worker, job))
+                {
+                    job.func(job.arg);
+                    pool->finishJob(*worker);
+                }
+            }
+        }
+
+        (void)xSemaphoreGive(worker->xSemaphore);
+    }
+
+    vTaskDelete(nullptr);
+
+    return;
+}
+
+void WorkerPool::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTake(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void WorkerPool::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,244 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Worker pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup common
+ *
+ * @{
+ */
+
+#ifndef __WORKER_POOL_H__
+#define __WORKER_POOL_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The worker pool executes jobs, which shall not run in the context of the
+ * display task, e.g. file access, parsing or sensor reads. Jobs are executed
+ * in the order they were submitted by a small number of worker tasks.
+ *
+ * A job shall only publish its result back to the plugin under the plugin
+ * lock, after the slow part is done. This way the display task never waits
+ * for the slow part.
+ */
+class WorkerPool
+{
+public:
+
+    /**
+     * Job function prototype.
+     *
+     * @param[in] arg   Job argument
+     */
+    typedef void (*JobFunc)(void* arg);
+
+    /**
+     * Get worker pool instance.
+     *
+     * @return Worker pool instance
+     */
+    static WorkerPool& getInstance()
+    {
+        static WorkerPool instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Start the worker tasks.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool begin();
+
+    /**
+     * Stop the worker tasks. Pending jobs are discarded.
+     */
+    void end();
+
+    /**
+     * Submit a job.
+     *
+     * @param[in] func  Job function
+     * @param[in] arg   Job argument
+     *
+     * @return If successful queued, it will return true otherwise false.
+     */
+    bool submit(JobFunc func, void* arg);
+
+    /**
+     * Remove all pending jobs with the given argument and wait until a
+     * running job with it is finished. Call it before the argument is
+     * destroyed. Never call it from inside a job.
+     *
+     * @param[in] arg   Job argument
+     */
+    void cancel(const void* arg);
+
+    /** Number of worker tasks */
+    static const uint8_t    WORKER_NUM          = 2U;
+
+    /** Max. number of pending jobs */
+    static const uint8_t    QUEUE_SIZE          = 16U;
+
+    /** Worker task stack size in bytes */
+    static const uint32_t   TASK_STACK_SIZE     = 4096U;
+
+    /** Worker task priority, lower than the display task. */
+    static const UBaseType_t TASK_PRIORITY      = 1U;
+
+    /** Worker tasks may run on any core. */
+    static const BaseType_t TASK_RUN_CORE       = tskNO_AFFINITY;
+
+    /** Max. time in ms a worker waits for a job, before it checks for exit. */
+    static const uint32_t   JOB_WAIT_TIMEOUT    = 100U;
+
+private:
+
+    /** A job */
+    struct Job
+    {
+        JobFunc func;   /**< Job function */
+        void*   arg;    /**< Job argument */
+    };
+
+    /** A worker */
+    struct Worker
+    {
+        WorkerPool*         pool;           /**< Worker pool the worker belongs to */
+        TaskHandle_t        taskHandle;     /**< Worker task handle */
+        SemaphoreHandle_t   xSemaphore;     /**< Binary semaphore used to signal the task exit. */
+        SemaphoreHandle_t   xJobFinished;   /**< Binary semaphore used to signal waiting cancel calls, that the job is finished. */
+        uint8_t             waiterCnt;      /**< Number of cancel calls, which wait for the running job. */
+        bool                isBusy;         /**< Is the worker running a job? */
+        const void*         arg;            /**< Argument of the running job */
+    };
+
+    SemaphoreHandle_t   m_xMutex;               /**< Mutex to protect the job queue. */
+    SemaphoreHandle_t   m_xJobReady;            /**< Binary semaphore used to wake up a worker. */
+    Worker              m_workers[WORKER_NUM];  /**< Workers */
+    Job                 m_jobs[QUEUE_SIZE];     /**< Ring buffer with pending jobs */
+    uint8_t             m_jobHead;              /**< Index of the oldest pending job */
+    uint8_t             m_jobCnt;               /**< Number of pending jobs */
+    volatile bool       m_taskExit;             /**< Flag to signal the worker tasks to exit. */
+
+    /**
+     * Constructs the worker pool.
+     */
+    WorkerPool() :
+        m_xMutex(nullptr),
+        m_xJobReady(nullptr),
+        m_workers(),
+        m_jobs(),
+        m_jobHead(0U),
+        m_jobCnt(0U),
+        m_taskExit(false)
+    {
+    }
+
+    /**
+     * Destroys the worker pool.
+     */
+    ~WorkerPool()
+    {
+        /* Will never be called. */
+    }
+
+    WorkerPool(const WorkerPool& pool);
+    WorkerPool& operator=(const WorkerPool& pool);
+
+    /**
+     * Take the oldest pending job and mark the worker busy.
+     *
+     * @param[in]   worker  Worker, which will run the job
+     * @param[out]  job     Job
+     *
+     * @return If a job is available, it will return true otherwise false.
+     */
+    bool takeJob(Worker& worker, Job& job);
+
+    /**
+     * Mark the worker idle again and wake up the cancel calls, which wait
+     * for the job.
+     *
+     * @param[in] worker    Worker, which finished its job
+     */
+    void finishJob(Worker& worker);
+
+    /**
+     * Wait until the job with the given argument, which a worker is running,
+     * is finished. It returns immediately, if no worker runs a job with it.
+     *
+     * @param[in] arg   Job argument
+     *
+     * @return If it waited for a job, it will return true otherwise false.
+     */
+    bool waitForJob(const void* arg);
+
+    /**
+     * Worker task.
+     *
+     * @param[in] parameters    Task parameters
+     */
+    static void workerTask(void* parameters);
+
+    /**
+     * Lock the job queue.
+     */
+    void lock();
+
+    /**
+     * Unlock the job queue.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __WORKER_POOL_H__ */
+
+/** @} */
@@ -37,6 +37,7 @@
 #include "AmbientLightSensor.h"
 #include "Settings.h"
 #include "BrightnessCtrl.h"
+#include "JsonDocPool.h"
 
 #include <Logging.h>
 #include <ArduinoJson.h>
@@ -81,13 +82,17 @@ bool DisplayMgr::begin()
     {
         if (false == Settings::getInstance().open(true))
         {
-            m_maxSlots = Settings::getInstance().getMaxSlots().getDefault();
+            m_maxSlots          = Settings::getInstance().getMaxSlots().getDefault();
+            m_prepareTime       = Settings::getInstance().getSlotPrepareTime().getDefault();
+            m_hibernationTime   = Settings::getInstance().getHibernationTime().getDefault() * 1000U;
 
             LOG_WARNING("Using default number of max. slots.");
         }
         else
         {
-            m_maxSlots = Settings::getInstance().getMaxSlots().getValue();
+            m_maxSlots          = Settings::getInstance().getMaxSlots().getValue();
+            m_prepareTime       = Settings::getInstance().getSlotPrepareTime().getValue();
+            m_hibernationTime   = Settings::getInstance().getHibernationTime().getValue() * 1000U;
             Settings::getInstance().close();
         }
 
@@ -136,6 +141,25 @@ bool DisplayMgr::begin()
         }
     }
 
+    /* Pipelined rendering needs the canvas framebuffers, because the plugins
+     * must not draw directly into the frames.
+     */
+    if ((0 != CONFIG_DISPLAY_PIPELINED) &&
+        (nullptr == m_taskHandle))
+    {
+        if ((nullptr != m_currCanvas) &&
+            (true == createFrames()))
+        {
+            m_isPipelined = true;
+        }
+        else
+        {
+            m_isPipelined = false;
+
+            LOG_WARNING("Couldn't create frames for pipelined rendering.");
+        }
+    }
+
     /* Not started yet? */
     if ((nullptr == m_taskHandle) &&
         (nullptr != m_slots))
@@ -143,18 +167,29 @@ bool DisplayMgr::begin()
         /* Create mutex to lock/unlock display update */
         m_xMutex = xSemaphoreCreateRecursiveMutex();
 
+        /* Create mutex to lock/unlock LED matrix access */
+        m_xMatrixMutex = xSemaphoreCreateRecursiveMutex();
+
         /* Create binary semaphore to signal task exit. */
         m_xSemaphore = xSemaphoreCreateBinary();
 
+        if (true == m_isPipelined)
+        {
+            m_xPresentSemaphore = xSemaphoreCreateBinary();
+            m_xFrameReady       = xSemaphoreCreateBinary();
+        }
+
         if ((nullptr != m_xMutex) &&
-            (nullptr != m_xSemaphore))
+            (nullptr != m_xMatrixMutex) &&
+            (nullptr != m_xSemaphore) &&
+            ((false == m_isPipelined) || ((nullptr != m_xPresentSemaphore) && (nullptr != m_xFrameReady))))
         {
             BaseType_t  osRet   = pdFAIL;
 
             /* Task shall run */
             m_taskExit = false;
 
-            osRet = xTaskCreateUniversal(   updateTask,
+            osRet = xTaskCreateUniversal(   (true == m_isPipelined) ? renderTask : updateTask,
                                             "displayTask",
                                             TASK_STACKE_SIZE,
                                             this,
@@ -166,7 +201,33 @@ bool DisplayMgr::begin()
             if (pdPASS == osRet)
             {
                 (void)xSemaphoreGive(m_xSemaphore);
-                status = true;
+
+                if (false == m_isPipelined)
+                {
+                    status = true;
+                }
+                else
+                {
+                    osRet = xTaskCreateUniversal(   presentTask,
+                                                    "presentTask",
+                                                    PRESENT_TASK_STACK_SIZE,
+                                                    this,
+                                                    PRESENT_TASK_PRIORITY,
+                                                    &m_presentTaskHandle,
+                                                    PRESENT_TASK_RUN_CORE);
+
+                    /* Task successful created? */
+                    if (pdPASS == osRet)
+                    {
+                        (void)xSemaphoreGive(m_xPresentSemaphore);
+                        status = true;
+                    }
+                    else
+                    {
+                        /* Stop the render task again. */
+                        end();
+                    }
+                }
             }
         }
     }
@@ -180,11 +241,29 @@ bool DisplayMgr::begin()
             m_xMutex = nullptr;
         }
 
+        if (nullptr != m_xMatrixMutex)
+        {
+            vSemaphoreDelete(m_xMatrixMutex);
+            m_xMatrixMutex = nullptr;
+        }
+
         if (nullptr != m_xSemaphore)
         {
             vSemaphoreDelete(m_xSemaphore);
             m_xSemaphore = nullptr;
         }
+
+        if (nullptr != m_xPresentSemaphore)
+        {
+            vSemaphoreDelete(m_xPresentSemaphore);
+            m_xPresentSemaphore = nullptr;
+        }
+
+        if (nullptr != m_xFrameReady)
+        {
+            vSemaphoreDelete(m_xFrameReady);
+            m_xFrameReady = nullptr;
+        }
     }
     else
     {
@@ -207,6 +286,12 @@ void DisplayMgr::end()
         (void)xSemaphoreTake(m_xSemaphore, portMAX_DELAY);
         m_taskHandle = nullptr;
 
+        if (nullptr != m_presentTaskHandle)
+        {
+            (void)xSemaphoreTake(m_xPresentSemaphore, portMAX_DELAY);
+            m_presentTaskHandle = nullptr;
+        }
+
         LOG_INFO("DisplayMgr is down.");
 
         vSemaphoreDelete(m_xSemaphore);
@@ -214,6 +299,21 @@ void DisplayMgr::end()
 
         vSemaphoreDelete(m_xMutex);
         m_xMutex = nullptr;
+
+        vSemaphoreDelete(m_xMatrixMutex);
+        m_xMatrixMutex = nullptr;
+
+        if (nullptr != m_xPresentSemaphore)
+        {
+            vSemaphoreDelete(m_xPresentSemaphore);
+            m_xPresentSemaphore = nullptr;
+        }
+
+        if (nullptr != m_xFrameReady)
+        {
+            vSemaphoreDelete(m_xFrameReady);
+            m_xFrameReady = nullptr;
+        }
     }
 
     return;
@@ -244,7 +344,9 @@ bool DisplayMgr::getAutoBrightnessAdjustment(void)
 void DisplayMgr::setBrightness(uint8_t level)
 {
     lock();
+    lockMatrix();
     BrightnessCtrl::getInstance().setBrightness(level);
+    unlockMatrix();
     unlock();
 
     return;
@@ -354,6 +456,12 @@ bool DisplayMgr::uninstallPlugin(IPluginMaintenance* plugin)
                     m_selectedPlugin = nullptr;
                 }
 
+                /* Is this plugin prepared to be shown next? */
+                if (m_preparedPlugin == plugin)
+                {
+                    abortPreparedPlugin();
+                }
+
                 plugin->stop();
                 if (false == m_slots[slotId].setPlugin(nullptr))
                 {
@@ -632,7 +740,11 @@ void DisplayMgr::getFBCopy(uint32_t* fb, size_t length, uint8_t* slotId)
         int16_t     y       = 0;
         size_t      index   = 0;
 
-        lock();
+        /* Only the LED matrix is accessed, therefore there is no need to
+         * lock the whole display. This avoids to wait for the rendering,
+         * while pipelined rendering is active.
+         */
+        lockMatrix();
 
         /* Copy framebuffer after it is completely updated. */
         for(y = 0; y < matrix.getHeight(); ++y)
@@ -651,15 +763,38 @@ void DisplayMgr::getFBCopy(uint32_t* fb, size_t length, uint8_t* slotId)
 
         if (nullptr != slotId)
         {
-            *slotId = m_selectedSlot;
+            *slotId = m_presentedSlot;
         }
 
-        unlock();
+        unlockMatrix();
     }
 
     return;
 }
 
+uint32_t DisplayMgr::getReclaimedHeap(uint8_t& hibernatedPlugins)
+{
+    uint32_t    reclaimedHeap   = 0U;
+    uint8_t     index           = 0U;
+
+    hibernatedPlugins = 0U;
+
+    lock();
+
+    for(index = 0U; index < m_maxSlots; ++index)
+    {
+        if (true == m_slots[index].getHibernation().isHibernated())
+        {
+            reclaimedHeap += m_slots[index].getHibernation().getReclaimedHeap();
+            ++hibernatedPlugins;
+        }
+    }
+
+    unlock();
+
+    return reclaimedHeap;
+}
+
 /******************************************************************************
  * Protected Methods
  *****************************************************************************/
@@ -670,15 +805,29 @@ void DisplayMgr::getFBCopy(uint32_t* fb, size_t length, uint8_t* slotId)
 
 DisplayMgr::DisplayMgr() :
     m_xMutex(nullptr),
+    m_xMatrixMutex(nullptr),
     m_taskHandle(nullptr),
     m_taskExit(false),
     m_xSemaphore(nullptr),
+    m_isPipelined(false),
+    m_presentTaskHandle(nullptr),
+    m_xPresentSemaphore(nullptr),
+    m_xFrameReady(nullptr),
+    m_frames(),
+    m_freeFrames(),
+    m_renderedFrames(),
+    m_presentedSlot(SLOT_ID_INVALID),
+    m_frameListener(nullptr),
     m_slots(nullptr),
     m_maxSlots(0U),
     m_selectedSlot(SLOT_ID_INVALID),
     m_selectedPlugin(nullptr),
     m_requestedPlugin(nullptr),
+    m_preparedPlugin(nullptr),
     m_slotTimer(),
+    m_prepareTimer(),
+    m_prepareTime(0U),
+    m_hibernationTime(0U),
     m_displayFadeState(FADE_IN),
     m_currCanvas(nullptr),
     m_framebuffers(),
@@ -695,6 +844,12 @@ DisplayMgr::DisplayMgr() :
     {
         m_framebuffers[idx] = nullptr;
     }
+
+    for(idx = 0; idx < UTIL_ARRAY_NUM(m_frames); ++idx)
+    {
+        m_frames[idx].canvas = nullptr;
+        m_frames[idx].slotId = SLOT_ID_INVALID;
+    }
 }
 
 DisplayMgr::~DisplayMgr()
@@ -777,6 +932,122 @@ void DisplayMgr::startFadeOut()
     }
 }
 
+void DisplayMgr::startPrepareTimer(uint32_t duration)
+{
+    if ((0U == duration) ||
+        (m_prepareTime >= duration))
+    {
+        m_prepareTimer.stop();
+    }
+    else
+    {
+        m_prepareTimer.start(duration - m_prepareTime);
+    }
+
+    return;
+}
+
+void DisplayMgr::prepareSlot(uint8_t slotId)
+{
+    IPluginMaintenance* plugin = m_slots[slotId].getPlugin();
+
+    abortPreparedPlugin();
+
+    if (nullptr != plugin)
+    {
+        resumeSlot(slotId);
+        plugin->prepare();
+
+        /* Without framebuffers, the plugin can't be rendered offscreen.
+         * It will be set active as usual with the slot change.
+         */
+        if (nullptr != m_currCanvas)
+        {
+            Canvas* spareFb = nullptr;
+
+            /* The spare framebuffer is only used during fading. */
+            if (m_currCanvas == m_framebuffers[FB_ID_0])
+            {
+                spareFb = m_framebuffers[FB_ID_1];
+            }
+            else
+            {
+                spareFb = m_framebuffers[FB_ID_0];
+            }
+
+            plugin->active(*spareFb);
+            plugin->update(*spareFb);
+
+            m_preparedPlugin = plugin;
+        }
+    }
+
+    return;
+}
+
+void DisplayMgr::abortPreparedPlugin()
+{
+    if (nullptr != m_preparedPlugin)
+    {
+        m_preparedPlugin->inactive();
+        m_preparedPlugin = nullptr;
+    }
+
+    return;
+}
+
+void DisplayMgr::processHibernation(uint8_t slotId)
+{
+    Slot&               slot        = m_slots[slotId];
+    IPluginMaintenance* plugin      = slot.getPlugin();
+    Hibernation&        hibernation = slot.getHibernation();
+
+    /* Plugin visible or about to get visible? */
+    bool                isVisible   = (nullptr == plugin) ||
+                                      (m_selectedPlugin == plugin) ||
+                                      (m_preparedPlugin == plugin) ||
+                                      (m_requestedPlugin == plugin);
+
+    if (true == hibernation.isDue(isVisible, m_hibernationTime))
+    {
+        uint32_t freeHeapBefore = ESP.getFreeHeap();
+
+        if (true == plugin->hibernate())
+        {
+            uint32_t freeHeapAfter  = ESP.getFreeHeap();
+            uint32_t reclaimedHeap  = 0U;
+
+            /* Other tasks may allocate in the meantime. */
+            if (freeHeapAfter > freeHeapBefore)
+            {
+                reclaimedHeap = freeHeapAfter - freeHeapBefore;
+            }
+
+            hibernation.hibernated(reclaimedHeap);
+
+            LOG_INFO("Slot %u (%s) hibernated, %u byte reclaimed.", slotId, plugin->getName(), reclaimedHeap);
+        }
+    }
+
+    return;
+}
+
+void DisplayMgr::resumeSlot(uint8_t slotId)
+{
+    Slot&               slot    = m_slots[slotId];
+    IPluginMaintenance* plugin  = slot.getPlugin();
+
+    if ((true == slot.getHibernation().resume()) &&
+        (nullptr != plugin))
+    {
+        plugin->resume();
+
+        LOG_INFO("Slot %u (%s) resumed.", slotId, plugin->getName());
+    }
+
+    return;
+}
+
 void DisplayMgr::fadeInOut(IGfx& dst)
 {
     if ((nullptr != m_currCanvas) &&
@@ -832,15 +1103,9 @@ void DisplayMgr::fadeInOut(IGfx& dst)
     return;
 }
 
-void DisplayMgr::process()
+void DisplayMgr::render(IGfx& dst)
 {
-    LedMatrix&  matrix  = LedMatrix::getInstance();
-    uint8_t     index   = 0U;
-
-    lock();
-
-    /* Handle display brightness */
-    BrightnessCtrl::getInstance().process();
+    uint8_t index = 0U;
 
     /* Plugin requested to choose? */
     if (nullptr != m_requestedPlugin)
@@ -876,6 +1141,8 @@ void DisplayMgr::process()
                 {
                     m_slotTimer.start(duration);
                 }
+
+                startPrepareTimer(duration);
             }
             else
             {
@@ -906,6 +1173,7 @@ void DisplayMgr::process()
             m_selectedPlugin->inactive();
             m_selectedPlugin = nullptr;
             m_slotTimer.stop();
+            m_prepareTimer.stop();
 
             /* Fade old display content out */
             startFadeOut();
@@ -931,11 +1199,26 @@ void DisplayMgr::process()
                 m_selectedPlugin->inactive();
                 m_selectedPlugin = nullptr;
                 m_slotTimer.stop();
+                m_prepareTimer.stop();
 
                 /* Fade old display content out */
                 startFadeOut();
             }
         }
+        /* Time to prepare the plugin in the next slot? */
+        else if ((true == m_prepareTimer.isTimerRunning()) &&
+                 (true == m_prepareTimer.isTimeout()))
+        {
+            uint8_t slotId = nextSlot(m_selectedSlot);
+
+            m_prepareTimer.stop();
+
+            if ((m_selectedSlot != slotId) &&
+                (m_maxSlots > slotId))
+            {
+                prepareSlot(slotId);
+            }
+        }
         else
         {
             /* Nothing to do. */
@@ -972,13 +1255,28 @@ void DisplayMgr::process()
                 m_slotTimer.start(duration);
             }
 
-            if (nullptr != m_currCanvas)
+            startPrepareTimer(duration);
+
+            /* The prepared plugin is already active and its first frame is
+             * in the current canvas, which was the spare one before.
+             */
+            if (m_preparedPlugin == m_selectedPlugin)
             {
-                m_selectedPlugin->active(*m_currCanvas);
+                m_preparedPlugin = nullptr;
             }
             else
             {
-                m_selectedPlugin->active(matrix);
+                abortPreparedPlugin();
+                resumeSlot(m_selectedSlot);
+
+                if (nullptr != m_currCanvas)
+                {
+                    m_selectedPlugin->active(*m_currCanvas);
+                }
+                else
+                {
+                    m_selectedPlugin->active(dst);
+                }
             }
 
             LOG_INFO("Slot %u (%s) now active.", m_selectedSlot, m_selectedPlugin->getName());
@@ -986,11 +1284,13 @@ void DisplayMgr::process()
         /* No plugin is active, clear the display. */
         else
         {
+            abortPreparedPlugin();
+
             if (nullptr != m_currCanvas)
             {
                 m_currCanvas->fillScreen(ColorDef::BLACK);
             }
-            matrix.clear();
+            dst.fillScreen(ColorDef::BLACK);
         }
     }
 
@@ -1029,17 +1329,19 @@ void DisplayMgr::process()
         {
             plugin->process();
         }
+
+        processHibernation(index);
     }
 
     /* Update display (main canvas available) */
     if (nullptr != m_currCanvas)
     {
-        fadeInOut(matrix);
+        fadeInOut(dst);
     }
     /* Update display (main canvas not available) */
     else if (nullptr != m_selectedPlugin)
     {
-        m_selectedPlugin->update(matrix);
+        m_selectedPlugin->update(dst);
     }
     /* No plugin selected. */
     else
@@ -1048,14 +1350,161 @@ void DisplayMgr::process()
         ;
     }
 
+    return;
+}
+
+void DisplayMgr::process()
+{
+    LedMatrix& matrix = LedMatrix::getInstance();
+
+    lock();
+    lockMatrix();
+
+    /* Handle display brightness */
+    BrightnessCtrl::getInstance().process();
+
+    render(matrix);
+    m_presentedSlot = m_selectedSlot;
+
     delay(1U);
     matrix.show();
 
+    unlockMatrix();
     unlock();
 
     return;
 }
 
+void DisplayMgr::renderFrame(Frame& frame)
+{
+    lock();
+
+    /* Handle display brightness */
+    lockMatrix();
+    BrightnessCtrl::getInstance().process();
+    unlockMatrix();
+
+    render(*frame.canvas);
+    frame.slotId = m_selectedSlot;
+
+    unlock();
+
+    return;
+}
+
+void DisplayMgr::presentFrame(Frame& frame)
+{
+    LedMatrix& matrix = LedMatrix::getInstance();
+
+    lockMatrix();
+
+    frame.canvas->updateFromBuffer(matrix);
+    m_presentedSlot = frame.slotId;
+
+    matrix.show();
+
+    unlockMatrix();
+
+    return;
+}
+
+bool DisplayMgr::createFrames()
+{
+    bool    isSuccessful    = true;
+    uint8_t idx             = 0U;
+    Frame*  frame           = nullptr;
+
+    /* Frames still exist from a previous run? */
+    if (nullptr != m_frames[0].canvas)
+    {
+        /* Take all frames back, which are still in the queues. */
+        while(true == m_freeFrames.pop(frame))
+        {
+            ;
+        }
+
+        while(true == m_renderedFrames.pop(frame))
+        {
+            ;
+        }
+    }
+    else
+    {
+        for(idx = 0U; idx < UTIL_ARRAY_NUM(m_frames); ++idx)
+        {
+            m_frames[idx].canvas = new Canvas(LedMatrix::getInstance().getWidth(), LedMatrix::getInstance().getHeight(), 0, 0, true);
+
+            if (nullptr == m_frames[idx].canvas)
+            {
+                isSuccessful = false;
+                break;
+            }
+        }
+    }
+
+    if (false == isSuccessful)
+    {
+        destroyFrames();
+    }
+    else
+    {
+        for(idx = 0U; idx < UTIL_ARRAY_NUM(m_frames); ++idx)
+        {
+            m_frames[idx].slotId = SLOT_ID_INVALID;
+            (void)m_freeFrames.push(&m_frames[idx]);
+        }
+    }
+
+    return isSuccessful;
+}
+
+void DisplayMgr::destroyFrames()
+{
+    uint8_t idx = 0U;
+
+    for(idx = 0U; idx < UTIL_ARRAY_NUM(m_frames); ++idx)
+    {
+        if (nullptr != m_frames[idx].canvas)
+        {
+            delete m_frames[idx].canvas;
+            m_frames[idx].canvas = nullptr;
+        }
+    }
+
+    return;
+}
+
+uint32_t DisplayMgr::waitForLedMatrix()
+{
+    uint32_t    timestamp   = millis();
+    uint32_t    duration    = 0U;
+    bool        abort       = false;
+
+    /* Max. time needed to load the data into the pixels.
+     * Only a 1 ms tolerance is added, which should be enough.
+     */
+    const uint32_t  MAX_LOOP_TIME   = Board::LedMatrix::matrixLoadTime + 1U; /* ms */
+
+    while((false == LedMatrix::getInstance().isReady()) && (false == abort))
+    {
+        duration = millis() - timestamp;
+
+        if (MAX_LOOP_TIME <= duration)
+        {
+            abort = true;
+        }
+        else
+        {
+            /* Don't spin, it would starve the lower priority tasks and the
+             * idle task, which feeds the task watchdog.
+             */
+            delay(1U);
+        }
+    }
+
+    return duration;
+}
+
 void DisplayMgr::updateTask(void* parameters)
 {
     DisplayMgr* displayMgr = reinterpret_cast<DisplayMgr*>(parameters);
@@ -1067,34 +1516,73 @@ void DisplayMgr::updateTask(void* parameters)
 
         while(false == displayMgr->m_taskExit)
         {
-            uint32_t    timestamp   = 0U;
-            uint32_t    duration    = 0U;
-            bool        abort       = false;
-
-            /* Max. time needed to load the data into the pixels.
-             * Only a 1 ms tolerance is added, which should be enough.
-             */
-            const uint32_t  MAX_LOOP_TIME   = Board::LedMatrix::matrixLoadTime + 1U; /* ms */
+            uint32_t duration = 0U;
 
             /* Refresh display content periodically */
             displayMgr->process();
 
+            /* Notify about the shown frame, while the LED matrix is updated. */
+            if (nullptr != displayMgr->m_frameListener)
+            {
+                displayMgr->m_frameListener->onFrame();
+            }
+
             /* Wait until the physical update is ready to avoid flickering
              * and artifacts on the display, because of e.g. webserver flash
              * access.
              */
-            timestamp = millis();
-            while((false == LedMatrix::getInstance().isReady()) && (false == abort))
+            duration = waitForLedMatrix();
+
+            delay(TASK_PERIOD - duration);
+        }
+
+        (void)xSemaphoreGive(displayMgr->m_xSemaphore);
+    }
+
+    vTaskDelete(nullptr);
+
+    return;
+}
+
+void DisplayMgr::renderTask(void* parameters)
+{
+    DisplayMgr* displayMgr = reinterpret_cast<DisplayMgr*>(parameters);
+
+    if ((nullptr != displayMgr) &&
+        (nullptr != displayMgr->m_xSemaphore))
+    {
+        (void)xSemaphoreTake(displayMgr->m_xSemaphore, portMAX_DELAY);
+
+        while(false == displayMgr->m_taskExit)
+        {
+            uint32_t    timestamp   = millis();
+            uint32_t    duration    = 0U;
+            Frame*      frame       = nullptr;
+
+            /* Render the next frame, while the present task shows the current one.
+             * If no frame is free, the present task is behind and rendering is
+             * skipped in this cycle.
+             */
+            if (true == displayMgr->m_freeFrames.pop(frame))
             {
-                duration = millis() - timestamp;
+                displayMgr->renderFrame(*frame);
 
-                if (MAX_LOOP_TIME <= duration)
-                {
-                    abort = true;
-                }
+                /* There are not more frames than the queue can hold. */
+                (void)displayMgr->m_renderedFrames.push(frame);
+                (void)xSemaphoreGive(displayMgr->m_xFrameReady);
             }
 
-            delay(TASK_PERIOD - duration);
+            /* The processing time is part of the task period. */
+            duration = millis() - timestamp;
+
+            if (TASK_PERIOD > duration)
+            {
+                delay(TASK_PERIOD - duration);
+            }
+            else
+            {
+                delay(1U);
+            }
         }
 
         (void)xSemaphoreGive(displayMgr->m_xSemaphore);
@@ -1105,6 +1593,48 @@ void DisplayMgr::updateTask(void* parameters)
     return;
 }
 
+void DisplayMgr::presentTask(void* parameters)
+{
+    DisplayMgr* displayMgr = reinterpret_cast<DisplayMgr*>(parameters);
+
+    if ((nullptr != displayMgr) &&
+        (nullptr != displayMgr->m_xPresentSemaphore))
+    {
+        (void)xSemaphoreTake(displayMgr->m_xPresentSemaphore, portMAX_DELAY);
+
+        while(false == displayMgr->m_taskExit)
+        {
+            Frame* frame = nullptr;
+
+            /* Wait for a rendered frame, but not forever to be able to exit. */
+            (void)xSemaphoreTake(displayMgr->m_xFrameReady, pdMS_TO_TICKS(TASK_PERIOD));
+
+            while(true == displayMgr->m_renderedFrames.pop(frame))
+            {
+                displayMgr->presentFrame(*frame);
+
+                /* The frame content is in the LED matrix now, therefore it can be rendered again. */
+                (void)displayMgr->m_freeFrames.push(frame);
+
+                /* Notify about the shown frame, while the LED matrix is updated. */
+                if (nullptr != displayMgr->m_frameListener)
+                {
+                    displayMgr->m_frameListener->onFrame();
+                }
+
+                /* Wait until the physical update is ready, before the next frame is shown. */
+                (void)waitForLedMatrix();
+            }
+        }
+
+        (void)xSemaphoreGive(displayMgr->m_xPresentSemaphore);
+    }
+
+    vTaskDelete(nullptr);
+
+    return;
+}
+
 void DisplayMgr::lock()
 {
     if (nullptr != m_xMutex)
@@ -1125,6 +1655,26 @@ void DisplayMgr::unlock()
     return;
 }
 
+void DisplayMgr::lockMatrix()
+{
+    if (nullptr != m_xMatrixMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMatrixMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void DisplayMgr::unlockMatrix()
+{
+    if (nullptr != m_xMatrixMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMatrixMutex);
+    }
+
+    return;
+}
+
 void DisplayMgr::load()
 {
     Settings& settings = Settings::getInstance();
@@ -1148,7 +1698,7 @@ void DisplayMgr::load()
         else
         {
             const size_t            JSON_DOC_SIZE   = 512U;
-            DynamicJsonDocument     jsonDoc(JSON_DOC_SIZE);
+            PooledJsonDocument      jsonDoc(JSON_DOC_SIZE);
             DeserializationError    error           = deserializeJson(jsonDoc, config);
 
             if (true == jsonDoc.overflowed())
@@ -1203,7 +1753,7 @@ void DisplayMgr::save()
         uint8_t             slotId      = 0;
         Settings&           settings    = Settings::getInstance();
         const size_t        JSON_DOC_SIZE   = 512U;
-        DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+        PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
         JsonArray           jsonSlots   = jsonDoc.createNestedArray("slots");
 
         for(slotId = 0; slotId < m_maxSlots; ++slotId)
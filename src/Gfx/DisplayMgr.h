@@ -40,6 +40,24 @@
  * Compile Switches
  *****************************************************************************/
 
+/**
+ * Pipelined rendering: The plugins render the next frame on one core, while
+ * the current frame is shown on the LED matrix by the other core.
+ */
+#ifndef CONFIG_DISPLAY_PIPELINED
+#define CONFIG_DISPLAY_PIPELINED        (0)
+#endif
+
+/** MCU core where the plugins and the fading are processed. */
+#ifndef CONFIG_DISPLAY_RENDER_CORE
+#define CONFIG_DISPLAY_RENDER_CORE      (1)
+#endif
+
+/** MCU core where the LED matrix is updated, only used by pipelined rendering. */
+#ifndef CONFIG_DISPLAY_PRESENT_CORE
+#define CONFIG_DISPLAY_PRESENT_CORE     (0)
+#endif
+
 /******************************************************************************
  * Includes
  *****************************************************************************/
@@ -47,6 +65,7 @@
 #include <Canvas.h>
 #include <TextWidget.h>
 #include <SimpleTimer.hpp>
+#include <SpscQueue.hpp>
 #include <FadeLinear.h>
 #include <FadeMoveX.h>
 #include <FadeMoveY.h>
@@ -54,6 +73,7 @@
 #include "Board.h"
 #include "IPluginMaintenance.hpp"
 #include "Slot.h"
+#include "IFrameListener.hpp"
 
 /******************************************************************************
  * Macros
@@ -262,6 +282,27 @@ public:
      */
     void getFBCopy(uint32_t* fb, size_t length, uint8_t* slotId);
 
+    /**
+     * Set the listener, which is notified about every shown frame.
+     * Set it before the display task is started.
+     *
+     * @param[in] listener  Frame listener, use nullptr to remove it.
+     */
+    void setFrameListener(IFrameListener* listener)
+    {
+        m_frameListener = listener;
+        return;
+    }
+
+    /**
+     * Get the heap, which is currently reclaimed by hibernated plugins.
+     *
+     * @param[out] hibernatedPlugins    Number of hibernated plugins
+     *
+     * @return Reclaimed heap in byte
+     */
+    uint32_t getReclaimedHeap(uint8_t& hibernatedPlugins);
+
     /**
      * Get max. number of display slots, which can be used for plugins.
      *
@@ -282,19 +323,50 @@ public:
     static const uint32_t       TASK_PERIOD         = 20U;
 
     /** MCU core where the task shall run */
-    static const BaseType_t     TASK_RUN_CORE       = 1;
+    static const BaseType_t     TASK_RUN_CORE       = CONFIG_DISPLAY_RENDER_CORE;
 
     /** Task priority, note Arduino loop and AsyncTcp have lower priorities. */
     static const UBaseType_t    TASK_PRIORITY       = 4U;
 
+    /** Present task stack size in bytes, which includes the frame listener notification. */
+    static const uint32_t       PRESENT_TASK_STACK_SIZE = TASK_STACKE_SIZE;
+
+    /** MCU core where the present task shall run */
+    static const BaseType_t     PRESENT_TASK_RUN_CORE   = CONFIG_DISPLAY_PRESENT_CORE;
+
+    /** Present task priority, note AsyncTcp has a lower priority. */
+    static const UBaseType_t    PRESENT_TASK_PRIORITY   = 4U;
+
     /** If no ambient light sensor is available, the default brightness shall be 40%. */
     static const uint8_t        BRIGHTNESS_DEFAULT  = (UINT8_MAX * 40U) / 100U;
 
 private:
 
+    /**
+     * A frame, which is rendered by the render stage and shown by the
+     * present stage. Only used by pipelined rendering.
+     */
+    struct Frame
+    {
+        Canvas* canvas; /**< Frame content */
+        uint8_t slotId; /**< Id of the slot, which content is in the frame. */
+    };
+
+    /**
+     * Number of frames for pipelined rendering: one is rendered, one is shown
+     * and one can be queued in between.
+     */
+    static const uint8_t    FRAME_NUM   = 3U;
+
+    /** Queue of frames, which hands them over between the render and present stage. */
+    typedef SpscQueue<Frame*, FRAME_NUM>    FrameQueue;
+
     /** Mutex to lock/unlock display update. */
     SemaphoreHandle_t   m_xMutex;
 
+    /** Mutex to lock/unlock the LED matrix access. */
+    SemaphoreHandle_t   m_xMatrixMutex;
+
     /** Display update task handle */
     TaskHandle_t        m_taskHandle;
 
@@ -304,6 +376,33 @@ private:
     /** Binary semaphore used to signal the task exit. */
     SemaphoreHandle_t   m_xSemaphore;
 
+    /** Is pipelined rendering active? */
+    bool                m_isPipelined;
+
+    /** Present task handle, only used by pipelined rendering. */
+    TaskHandle_t        m_presentTaskHandle;
+
+    /** Binary semaphore used to signal the present task exit. */
+    SemaphoreHandle_t   m_xPresentSemaphore;
+
+    /** Binary semaphore used to signal the present task, that a frame was rendered. */
+    SemaphoreHandle_t   m_xFrameReady;
+
+    /** Frames for pipelined rendering. */
+    Frame               m_frames[FRAME_NUM];
+
+    /** Frames, which are free to render. The present stage is the producer, the render stage the consumer. */
+    FrameQueue          m_freeFrames;
+
+    /** Frames, which are rendered. The render stage is the producer, the present stage the consumer. */
+    FrameQueue          m_renderedFrames;
+
+    /** Id of the slot, which content is shown on the LED matrix. */
+    uint8_t             m_presentedSlot;
+
+    /** Listener, which is notified about every shown frame. */
+    IFrameListener*     m_frameListener;
+
     /** List of all slots with their connected plugins. */
     Slot*               m_slots;
 
@@ -319,9 +418,21 @@ private:
     /** Plugin which is requested to be activated immediately. */
     IPluginMaintenance* m_requestedPlugin;
 
+    /** Plugin in the next slot, which is already prepared and rendered offscreen. */
+    IPluginMaintenance* m_preparedPlugin;
+
     /** Timer, used for changing the slot after a specific duration. */
     SimpleTimer         m_slotTimer;
 
+    /** Timer, used to prepare the next slot before the slot changes. */
+    SimpleTimer         m_prepareTimer;
+
+    /** Time in ms before a slot change, when the next slot is prepared. */
+    uint32_t            m_prepareTime;
+
+    /** Time in ms a plugin must be invisible, until it is hibernated. 0 disables hibernation. */
+    uint32_t            m_hibernationTime;
+
     /** Display fade state */
     enum FadeState
     {
@@ -380,6 +491,44 @@ private:
      */
     void startFadeOut();
 
+    /**
+     * Start the prepare timer, derived from the slot duration.
+     * If the slot is infinite active or shorter than the prepare time,
+     * the prepare timer will be stopped.
+     *
+     * @param[in] duration  Slot duration in ms
+     */
+    void startPrepareTimer(uint32_t duration);
+
+    /**
+     * Prepare the plugin in the given slot. The plugin is set active and
+     * its first frame is rendered offscreen into the spare framebuffer,
+     * which becomes the current one with the next slot change.
+     *
+     * @param[in] slotId    Id of the slot, which will be shown next
+     */
+    void prepareSlot(uint8_t slotId);
+
+    /**
+     * Abort a prepared plugin, e.g. because a different slot is shown next.
+     */
+    void abortPreparedPlugin();
+
+    /**
+     * Hibernate the plugin in the given slot, if it was invisible for the
+     * hibernation time.
+     *
+     * @param[in] slotId    Slot id
+     */
+    void processHibernation(uint8_t slotId);
+
+    /**
+     * Resume the plugin in the given slot, if it is hibernated.
+     *
+     * @param[in] slotId    Slot id
+     */
+    void resumeSlot(uint8_t slotId);
+
     /**
      * Fade display content in/out.
      *
@@ -387,6 +536,13 @@ private:
      */
     void fadeInOut(IGfx& dst);
 
+    /**
+     * Handle which slot to show and render the display content.
+     *
+     * @param[in] dst   Destination, where the display content is rendered to.
+     */
+    void render(IGfx& dst);
+
     /**
      * Process the slots. This shall be called periodically in
      * a higher period than the DEFAULT_PERIOD.
@@ -395,6 +551,41 @@ private:
      */
     void process(void);
 
+    /**
+     * Render the display content into a frame. Used by pipelined rendering.
+     *
+     * @param[in] frame Frame
+     */
+    void renderFrame(Frame& frame);
+
+    /**
+     * Show a rendered frame on the LED matrix. Used by pipelined rendering.
+     *
+     * @param[in] frame Frame
+     */
+    void presentFrame(Frame& frame);
+
+    /**
+     * Create the frames for pipelined rendering and mark all of them as free.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool createFrames();
+
+    /**
+     * Destroy the frames for pipelined rendering.
+     */
+    void destroyFrames();
+
+    /**
+     * Wait until the physical update of the LED matrix is ready, but not longer
+     * than the time to load the data into the pixels. The task is blocked
+     * meanwhile, therefore the other tasks on the same core can run.
+     *
+     * @return Waiting time in ms
+     */
+    static uint32_t waitForLedMatrix();
+
     /**
      * Display update task is responsible to refresh the display content.
      *
@@ -402,6 +593,22 @@ private:
      */
     static void updateTask(void* parameters);
 
+    /**
+     * Render task, which renders the display content into frames.
+     * Used by pipelined rendering.
+     *
+     * @param[in]   parameters  Task parameters
+     */
+    static void renderTask(void* parameters);
+
+    /**
+     * Present task, which shows the rendered frames on the LED matrix.
+     * Used by pipelined rendering.
+     *
+     * @param[in]   parameters  Task parameters
+     */
+    static void presentTask(void* parameters);
+
     /**
      * Lock display and prevent the display update, which will be done in a
      * separate task.
@@ -413,6 +620,17 @@ private:
      */
     void unlock(void);
 
+    /**
+     * Lock the LED matrix access.
+     * If the display is locked as well, lock the display first.
+     */
+    void lockMatrix(void);
+
+    /**
+     * Unlock the LED matrix access.
+     */
+    void unlockMatrix(void);
+
     /**
      * Load display slot configuration from persistent memory.
      */
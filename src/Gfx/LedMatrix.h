@@ -146,6 +146,20 @@ public:
      */
     Color getColor(int16_t x, int16_t y) const final;
 
+    /**
+     * Get the index of a pixel in the LED strip, which depends on the
+     * panel topology.
+     *
+     * @param[in] x x-coordinate
+     * @param[in] y y-coordinate
+     *
+     * @return Index in the LED strip
+     */
+    uint16_t getStripIndex(int16_t x, int16_t y) const
+    {
+        return m_topo.Map(x, y);
+    }
+
 private:
 
     /** Pixel representation of the LED matrix */
@@ -69,7 +69,8 @@
 Slot::Slot() :
     m_plugin(nullptr),
     m_duration(DURATION_DEFAULT),
-    m_isLocked(false)
+    m_isLocked(false),
+    m_hibernation()
 {
 }
 
@@ -95,6 +96,8 @@ bool Slot::setPlugin(IPluginMaintenance* plugin)
 
         m_plugin = plugin;
 
+        (void)m_hibernation.resume();
+
         if (nullptr != m_plugin)
         {
             m_plugin->setSlot(this);
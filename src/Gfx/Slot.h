@@ -47,6 +47,8 @@
 #include "IPluginMaintenance.hpp"
 #include "ISlotPlugin.hpp"
 
+#include <Hibernation.hpp>
+
 /******************************************************************************
  * Macros
  *****************************************************************************/
@@ -128,6 +130,26 @@ public:
      */
     bool isLocked() const;
 
+    /**
+     * Get the hibernation state of the plugin in the slot.
+     *
+     * @return Hibernation state
+     */
+    Hibernation& getHibernation()
+    {
+        return m_hibernation;
+    }
+
+    /**
+     * Get the hibernation state of the plugin in the slot.
+     *
+     * @return Hibernation state
+     */
+    const Hibernation& getHibernation() const
+    {
+        return m_hibernation;
+    }
+
     /** Default duration in ms */
     static const uint32_t DURATION_DEFAULT  = 30000U;
 
@@ -136,6 +158,7 @@ private:
     IPluginMaintenance* m_plugin;   /**< Plugged in slot */
     uint32_t            m_duration; /**< Duration in ms, how long the plugin shall be active. */
     bool                m_isLocked; /**< Is slot locked or not. */
+    Hibernation         m_hibernation;  /**< Hibernation state of the plugin */
 
     Slot(const Slot& matrix);
     Slot& operator=(const Slot& matrix);
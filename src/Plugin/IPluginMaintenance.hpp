@@ -93,6 +93,7 @@ public:
     /**
      * Get plugin topics, which can be get/set via different communication
      * interfaces like REST, websocket, MQTT, etc.
+     * The topics shall not change during the lifetime of the plugin.
      * 
      * Example:
      * {
@@ -127,6 +128,20 @@ public:
      */
     virtual bool setTopic(const String& topic, const JsonObject& value) = 0;
 
+    /**
+     * Begin a topic update. Until the corresponding endTopicUpdate(), a changed
+     * configuration is not stored in the filesystem. This allows to set several
+     * topics with only one write access.
+     * Topic updates can be nested.
+     */
+    virtual void beginTopicUpdate() = 0;
+
+    /**
+     * End a topic update. At the end of the outermost topic update, a changed
+     * configuration is stored in the filesystem.
+     */
+    virtual void endTopicUpdate() = 0;
+
     /**
      * Is a upload request accepted or rejected?
      * 
@@ -181,9 +196,40 @@ public:
      * Process the plugin.
      * Overwrite it if your plugin has cyclic stuff to do without being in a
      * active slot.
+     * It is called by the display task, therefore it shall not block. Submit
+     * slow work like file access or sensor reads to the WorkerPool instead.
      */
     virtual void process() = 0;
 
+    /**
+     * This method will be called shortly before the plugin is set active,
+     * while the current slot is still shown. Right after it, the plugin is
+     * set active and updated once offscreen, so the first frame is ready
+     * before the transition starts.
+     * Overwrite it if your plugin needs to know this, e.g. to refresh its
+     * content.
+     */
+    virtual void prepare() = 0;
+
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The plugin shall free its heavy resources,
+     * like canvases and bitmaps, but keep its small state. They shall be
+     * rebuilt on demand, latest in active().
+     * Overwrite it if your plugin supports hibernation.
+     *
+     * @return If the plugin supports hibernation, it will return true otherwise false.
+     */
+    virtual bool hibernate() = 0;
+
+    /**
+     * This method will be called before a hibernated plugin is prepared or
+     * set active.
+     * Overwrite it if your plugin needs to rebuild something, which is not
+     * done in active().
+     */
+    virtual void resume() = 0;
+
     /**
      * This method will be called in case the plugin is set active, which means
      * it will be shown on the display in the next step.
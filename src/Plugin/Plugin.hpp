@@ -45,6 +45,7 @@
  *****************************************************************************/
 #include <stdint.h>
 #include <IGfx.hpp>
+#include <Canvas.h>
 #include <Util.h>
 #include "IPluginMaintenance.hpp"
 
@@ -145,6 +146,46 @@ public:
         return false;
     }
 
+    /**
+     * Begin a topic update. Until the corresponding endTopicUpdate(), a changed
+     * configuration is not stored in the filesystem. This allows to set several
+     * topics with only one write access.
+     * Topic updates can be nested.
+     */
+    void beginTopicUpdate() override
+    {
+        ++m_topicUpdateLevel;
+
+        return;
+    }
+
+    /**
+     * End a topic update. At the end of the outermost topic update, a changed
+     * configuration is stored in the filesystem.
+     */
+    void endTopicUpdate() override
+    {
+        if (0U < m_topicUpdateLevel)
+        {
+            --m_topicUpdateLevel;
+
+            if (0U == m_topicUpdateLevel)
+            {
+                lock();
+
+                if (true == m_isSaveConfigurationPending)
+                {
+                    m_isSaveConfigurationPending = false;
+                    (void)saveConfiguration();
+                }
+
+                unlock();
+            }
+        }
+
+        return;
+    }
+
     /**
      * Is a upload request accepted or rejected?
      * 
@@ -231,6 +272,44 @@ public:
         return;
     }
 
+    /**
+     * This method will be called shortly before the plugin is set active,
+     * while the current slot is still shown. Right after it, the plugin is
+     * set active and updated once offscreen, so the first frame is ready
+     * before the transition starts.
+     * Overwrite it if your plugin needs to know this, e.g. to refresh its
+     * content.
+     */
+    virtual void prepare() override
+    {
+        return;
+    }
+
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The plugin shall free its heavy resources,
+     * like canvases and bitmaps, but keep its small state. They shall be
+     * rebuilt on demand, latest in active().
+     * Overwrite it if your plugin supports hibernation.
+     *
+     * @return If the plugin supports hibernation, it will return true otherwise false.
+     */
+    virtual bool hibernate() override
+    {
+        return false;
+    }
+
+    /**
+     * This method will be called before a hibernated plugin is prepared or
+     * set active.
+     * Overwrite it if your plugin needs to rebuild something, which is not
+     * done in active().
+     */
+    virtual void resume() override
+    {
+        return;
+    }
+
     /**
      * This method will be called in case the plugin is set active, which means
      * it will be shown on the display in the next step.
@@ -280,7 +359,9 @@ protected:
     Plugin(const String& name, uint16_t uid) :
         m_uid(uid),
         m_name(name),
-        m_isEnabled(false)
+        m_isEnabled(false),
+        m_topicUpdateLevel(0U),
+        m_isSaveConfigurationPending(false)
     {
     }
 
@@ -308,11 +389,90 @@ protected:
         return generateFullPath(".json");
     }
 
+    /**
+     * Release a canvas, e.g. on hibernation. The widgets added to it are not
+     * destroyed, they just need to be added again to a new canvas.
+     *
+     * @param[in,out] canvas    Canvas, which to release. It is nullptr afterwards.
+     */
+    static void releaseCanvas(Canvas*& canvas)
+    {
+        if (nullptr != canvas)
+        {
+            delete canvas;
+            canvas = nullptr;
+        }
+
+        return;
+    }
+
+    /**
+     * Save the configuration in the filesystem.
+     * Overwrite it if your plugin has a persistent configuration.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    virtual bool saveConfiguration() const
+    {
+        return true;
+    }
+
+    /**
+     * Request to save the configuration in the filesystem. During a topic
+     * update, the configuration is saved at its end, otherwise immediately.
+     * The plugin must be locked.
+     */
+    void requestSaveConfiguration()
+    {
+        if (0U == m_topicUpdateLevel)
+        {
+            (void)saveConfiguration();
+        }
+        else
+        {
+            m_isSaveConfigurationPending = true;
+        }
+
+        return;
+    }
+
+    /**
+     * Is a requested save of the configuration still pending?
+     * A pending configuration must not be overwritten by loading it from
+     * the filesystem. The plugin must be locked.
+     *
+     * @return If pending, it will return true otherwise false.
+     */
+    bool isSaveConfigurationPending() const
+    {
+        return m_isSaveConfigurationPending;
+    }
+
+    /**
+     * Protect against concurrent access.
+     * Overwrite it if your plugin has a persistent configuration.
+     */
+    virtual void lock() const
+    {
+        return;
+    }
+
+    /**
+     * Unprotect against concurrent access.
+     * Overwrite it if your plugin has a persistent configuration.
+     */
+    virtual void unlock() const
+    {
+        return;
+    }
+
 private:
 
-    uint16_t    m_uid;          /**< Unique id */
-    String      m_name;         /**< Plugin name */
-    bool        m_isEnabled;    /**< Plugin is enabled or disabled */
+    uint16_t    m_uid;                          /**< Unique id */
+    String      m_name;                         /**< Plugin name */
+    bool        m_isEnabled;                    /**< Plugin is enabled or disabled */
+    uint8_t     m_topicUpdateLevel;             /**< Nesting level of the topic updates */
+    bool        m_isSaveConfigurationPending;   /**< Is saving the configuration requested during a topic update? */
 
     Plugin();
     Plugin(const Plugin& plugin);
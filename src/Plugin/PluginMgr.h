@@ -47,9 +47,7 @@
 #include "IPluginMaintenance.hpp"
 #include "DisplayMgr.h"
 #include "PluginFactory.h"
-
-#include <LinkedList.hpp>
-#include <ESPAsyncWebServer.h>
+#include "PluginTopicHandler.h"
 
 /******************************************************************************
  * Macros
@@ -62,6 +60,7 @@
 /**
  * The plugin manager installs a plugin in a display slot and register its web pages.
  * Or uninstalls a plugin and unregister its web pages.
+ * The REST API topics of all plugins are served by a single web handler.
  */
 class PluginMgr
 {
@@ -150,58 +149,15 @@ public:
 
 private:
 
-    /**
-     * Web handler data, which is necessary for the webserver handling.
-     */
-    struct WebHandlerData
-    {
-        AsyncCallbackWebHandler*    webHandler;     /**< Webhandler callback, necessary to remove it later again. */
-        String                      uri;            /**< URI where the handler is registered. */
-        bool                        isUploadError;  /**< If upload error happened, it will be true otherwise false. */
-        String                      fullPath;       /**< Full path of uploaded file. If empty, there is no file available. */
-        File                        fd;             /**< Upload file descriptor */
-
-        /**
-         * Initialize the web handler data.
-         */
-        WebHandlerData() :
-            webHandler(nullptr),
-            uri(),
-            isUploadError(false),
-            fullPath(),
-            fd()
-        {
-        }
-    };
-
-    /**
-     * Plugin object specific data, used for plugin management.
-     */
-    struct PluginObjData
-    {
-        static const uint8_t MAX_WEB_HANDLERS = 8U; /**< Max. number of web handlers. */
-
-        IPluginMaintenance* plugin;                         /**< Plugin object, where this data record belongs to. */
-        WebHandlerData      webHandlers[MAX_WEB_HANDLERS];  /**< Web data of the plugin, necessary to remove it later again. */
-
-        /**
-         * Initializes the plugin object data.
-         */
-        PluginObjData() :
-            plugin(nullptr),
-            webHandlers()
-        {
-        }
-    };
-
     PluginFactory               m_pluginFactory;    /**< The plugin factory with the plugin type registry. */
-    DLinkedList<PluginObjData*> m_pluginMeta;       /**< Plugin object management information. */
+    PluginTopicHandler          m_topicHandler;     /**< Web handler for all plugin topics */
 
     /**
      * Constructs the plugin manager.
      */
     PluginMgr() :
-        m_pluginFactory()
+        m_pluginFactory(),
+        m_topicHandler()
     {
     }
 
@@ -260,40 +216,6 @@ private:
      */
     void registerTopics(IPluginMaintenance* plugin);
 
-    /**
-     * Register a single topic of the given plugin depended on the used communication
-     * networks.
-     * 
-     * @param[in] metaData  The plugin meta data, which shall be handled.
-     * @param[in] topic     The topic.
-     */
-    void registerTopic(PluginObjData* metaData, const String& topic);
-
-    /**
-     * The web request handler handles all incoming HTTP requests for every plugin topic.
-     * 
-     * @param[in] request           The web request information from the client.
-     * @param[in] plugin            The responsible plugin, which is related to the request.
-     * @param[in] topic             The topic, which is requested.
-     * @param[in] webHandlerData    Plugin web handler data, which is related to this request.
-     */
-    void webReqHandler(AsyncWebServerRequest *request, IPluginMaintenance* plugin, const String& topic, WebHandlerData* webHandlerData);
-
-    /**
-     * File upload handler.
-     *
-     * @param[in] request           HTTP request.
-     * @param[in] filename          Name of the uploaded file.
-     * @param[in] index             Current file offset.
-     * @param[in] data              Next data part of file, starting at offset.
-     * @param[in] len               Data part size in byte.
-     * @param[in] final             Is final packet or not.
-     * @param[in] plugin            The responsible plugin, which is related to the upload.
-     * @param[in] topic             The topic, which is requested.
-     * @param[in] webHandlerData    Plugin web handler data, which is related to this upload.
-     */
-    void uploadHandler(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final, IPluginMaintenance* plugin, const String& topic, WebHandlerData* webHandlerData);
-
     /**
      * Unregister all topics depended on the used communication networks.
      * 
@@ -0,0 +1,761 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Plugin topic web handler
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "PluginTopicHandler.h"
+#include "RestApi.h"
+#include "FileSystem.h"
+#include "HttpStatus.h"
+#include "JsonDocPool.h"
+
+#include <Logging.h>
+#include <ArduinoJson.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** URI path between the REST API base URI and the plugin uid. */
+static const char   DISPLAY_UID_PATH[]  = "/display/uid/";
+
+/** URI path between the REST API base URI and the end of the batch request URI. */
+static const char   BATCH_PATH[]        = "/display/topics";
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+PluginTopicHandler::PluginTopicHandler() :
+    AsyncWebHandler(),
+    m_buckets(),
+    m_xMutex(nullptr)
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < BUCKETS; ++index)
+    {
+        m_buckets[index] = nullptr;
+    }
+
+    m_xMutex = xSemaphoreCreateRecursiveMutex();
+}
+
+PluginTopicHandler::~PluginTopicHandler()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < BUCKETS; ++index)
+    {
+        while(nullptr != m_buckets[index])
+        {
+            Entry* entry = m_buckets[index];
+
+            m_buckets[index] = entry->next;
+            delete entry;
+        }
+    }
+
+    if (nullptr != m_xMutex)
+    {
+        vSemaphoreDelete(m_xMutex);
+        m_xMutex = nullptr;
+    }
+}
+
+bool PluginTopicHandler::registerTopic(IPluginMaintenance* plugin, const String& topic)
+{
+    bool    isSuccessful    = false;
+    Entry*  entry           = nullptr;
+
+    if ((nullptr == plugin) ||
+        (false == topic.startsWith("/")))
+    {
+        return false;
+    }
+
+    lock();
+
+    if (nullptr != find(plugin->getUID(), topic.c_str()))
+    {
+        LOG_WARNING("[%s][%u] Topic %s already registered.", plugin->getName(), plugin->getUID(), topic.c_str());
+    }
+    else
+    {
+        entry = new Entry();
+
+        if (nullptr != entry)
+        {
+            uint8_t bucket = getBucket(plugin->getUID(), topic.c_str());
+
+            entry->uid          = plugin->getUID();
+            entry->topic        = topic;
+            entry->plugin       = plugin;
+            entry->next         = m_buckets[bucket];
+            m_buckets[bucket]   = entry;
+
+            LOG_INFO("[%s][%u] Register: %s", plugin->getName(), plugin->getUID(), topic.c_str());
+
+            isSuccessful = true;
+        }
+    }
+
+    unlock();
+
+    return isSuccessful;
+}
+
+void PluginTopicHandler::unregisterTopic(IPluginMaintenance* plugin, const String& topic)
+{
+    if (nullptr != plugin)
+    {
+        uint8_t bucket  = getBucket(plugin->getUID(), topic.c_str());
+        Entry** link    = nullptr;
+        bool    isFound = false;
+
+        lock();
+
+        link = &m_buckets[bucket];
+
+        while((false == isFound) && (nullptr != *link))
+        {
+            Entry* entry = *link;
+
+            if ((plugin == entry->plugin) &&
+                (0 == strcmp(entry->topic.c_str(), topic.c_str())))
+            {
+                LOG_INFO("[%s][%u] Unregister: %s", plugin->getName(), plugin->getUID(), topic.c_str());
+
+                /* Close a aborted upload. */
+                if (true == entry->fd)
+                {
+                    entry->fd.close();
+                }
+
+                *link = entry->next;
+                delete entry;
+
+                isFound = true;
+            }
+            else
+            {
+                link = &entry->next;
+            }
+        }
+
+        unlock();
+    }
+
+    return;
+}
+
+bool PluginTopicHandler::canHandle(AsyncWebServerRequest* request)
+{
+    bool isHandled = false;
+
+    if (nullptr != request)
+    {
+        lock();
+        isHandled = (nullptr != find(request));
+        unlock();
+
+        /* The webserver drops all request headers, which no handler is
+         * interested in. Keep the ETag of a conditional GET request.
+         */
+        if (true == isHandled)
+        {
+            request->addInterestingHeader("If-None-Match");
+        }
+        else if ((HTTP_POST == request->method()) &&
+                 (true == isBatchUrl(request->url())))
+        {
+            isHandled = true;
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    return isHandled;
+}
+
+void PluginTopicHandler::handleRequest(AsyncWebServerRequest* request)
+{
+    if (nullptr == request)
+    {
+        return;
+    }
+
+    if (true == isBatchUrl(request->url()))
+    {
+        handleBatchRequest(request);
+    }
+    else
+    {
+        handleTopicRequest(request);
+    }
+
+    return;
+}
+
+void PluginTopicHandler::handleUpload(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data, size_t len, bool final)
+{
+    Entry* entry = nullptr;
+
+    if (nullptr == request)
+    {
+        return;
+    }
+
+    lock();
+
+    entry = find(request);
+
+    if (nullptr == entry)
+    {
+        LOG_WARNING("Upload of %s to a unknown topic.", filename.c_str());
+    }
+    else
+    {
+        /* Begin of upload? */
+        if (0 == index)
+        {
+            LOG_INFO("Upload of %s (%d bytes) starts.", filename.c_str(), request->contentLength());
+            entry->isUploadError = false;
+            entry->fullPath.clear();
+
+            /* Ask plugin, whether the upload is allowed or not. */
+            if (false == entry->plugin->isUploadAccepted(entry->topic, filename, entry->fullPath))
+            {
+                LOG_WARNING("[%s][%u] Upload not supported.", entry->plugin->getName(), entry->uid);
+                entry->isUploadError = true;
+                entry->fullPath.clear();
+            }
+            else
+            {
+                /* Create a new file and overwrite a existing one. */
+                entry->fd = FILESYSTEM.open(entry->fullPath, "w");
+
+                if (false == entry->fd)
+                {
+                    LOG_ERROR("Couldn't create file: %s", entry->fullPath.c_str());
+                    entry->isUploadError = true;
+                    entry->fullPath.clear();
+                }
+            }
+        }
+
+        if (false == entry->isUploadError)
+        {
+            /* If file is open, write data to it. */
+            if (true == entry->fd)
+            {
+                if (len != entry->fd.write(data, len))
+                {
+                    LOG_ERROR("Less data written, upload aborted.");
+                    entry->isUploadError = true;
+                    entry->fullPath.clear();
+                    entry->fd.close();
+                }
+            }
+
+            /* Upload finished? */
+            if (true == final)
+            {
+                LOG_INFO("Upload of %s finished.", filename.c_str());
+
+                entry->fd.close();
+            }
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void PluginTopicHandler::handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total)
+{
+    if ((nullptr == request) ||
+        (nullptr == data))
+    {
+        return;
+    }
+
+    /* Only the batch request body is used. It is collected in the request
+     * and released together with it.
+     */
+    if (true == isBatchUrl(request->url()))
+    {
+        if ((0U == index) &&
+            (MAX_BATCH_SIZE >= total) &&
+            (nullptr == request->_tempObject))
+        {
+            request->_tempObject = malloc(total + 1U);
+        }
+
+        if ((nullptr != request->_tempObject) &&
+            (total >= (index + len)))
+        {
+            char* body = static_cast<char*>(request->_tempObject);
+
+            memcpy(&body[index], data, len);
+            body[index + len] = '\0';
+        }
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool PluginTopicHandler::parseUrl(const String& url, uint16_t& uid, const char*& topic)
+{
+    const size_t    BASE_URI_LENGTH         = sizeof(RestApi::BASE_URI) - 1U;
+    const size_t    DISPLAY_UID_PATH_LENGTH = sizeof(DISPLAY_UID_PATH) - 1U;
+    const uint8_t   MAX_DIGITS              = 5U;
+    const char*     str                     = url.c_str();
+    bool            isValid                 = false;
+
+    if ((0 == strncmp(str, RestApi::BASE_URI, BASE_URI_LENGTH)) &&
+        (0 == strncmp(&str[BASE_URI_LENGTH], DISPLAY_UID_PATH, DISPLAY_UID_PATH_LENGTH)))
+    {
+        const char* pos     = &str[BASE_URI_LENGTH + DISPLAY_UID_PATH_LENGTH];
+        uint32_t    value   = 0U;
+        uint8_t     digits  = 0U;
+
+        while(('0' <= *pos) && ('9' >= *pos) && (MAX_DIGITS > digits))
+        {
+            value = (value * 10U) + static_cast<uint32_t>(*pos - '0');
+            ++pos;
+            ++digits;
+        }
+
+        /* The topic follows directly after the uid. */
+        if ((0U < digits) &&
+            (UINT16_MAX >= value) &&
+            ('/' == *pos))
+        {
+            uid     = static_cast<uint16_t>(value);
+            topic   = pos;
+            isValid = true;
+        }
+    }
+
+    return isValid;
+}
+
+bool PluginTopicHandler::isBatchUrl(const String& url)
+{
+    const size_t    BASE_URI_LENGTH = sizeof(RestApi::BASE_URI) - 1U;
+    const char*     str             = url.c_str();
+
+    return ((0 == strncmp(str, RestApi::BASE_URI, BASE_URI_LENGTH)) &&
+            (0 == strcmp(&str[BASE_URI_LENGTH], BATCH_PATH)));
+}
+
+uint8_t PluginTopicHandler::getBucket(uint16_t uid, const char* topic)
+{
+    const uint32_t  FNV_PRIME   = 16777619U;
+    uint32_t        hash        = 2166136261U;  /* FNV-1a offset basis */
+
+    hash = (hash ^ (uid & 0xFFU)) * FNV_PRIME;
+    hash = (hash ^ (uid >> 8U)) * FNV_PRIME;
+
+    while('\0' != *topic)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*topic)) * FNV_PRIME;
+        ++topic;
+    }
+
+    return static_cast<uint8_t>(hash & (BUCKETS - 1U));
+}
+
+PluginTopicHandler::Entry* PluginTopicHandler::find(uint16_t uid, const char* topic) const
+{
+    Entry* entry = m_buckets[getBucket(uid, topic)];
+
+    while((nullptr != entry) &&
+          ((uid != entry->uid) || (0 != strcmp(entry->topic.c_str(), topic))))
+    {
+        entry = entry->next;
+    }
+
+    return entry;
+}
+
+PluginTopicHandler::Entry* PluginTopicHandler::find(AsyncWebServerRequest* request) const
+{
+    Entry*      entry   = nullptr;
+    uint16_t    uid     = 0U;
+    const char* topic   = nullptr;
+
+    if (true == parseUrl(request->url(), uid, topic))
+    {
+        entry = find(uid, topic);
+    }
+
+    return entry;
+}
+
+PluginTopicHandler::Entry* PluginTopicHandler::find(JsonVariantConst update) const
+{
+    Entry*              entry       = nullptr;
+    JsonVariantConst    jsonUid     = update["uid"];
+    JsonVariantConst    jsonTopic   = update["topic"];
+
+    if ((true == jsonUid.is<uint16_t>()) &&
+        (true == jsonTopic.is<const char*>()))
+    {
+        entry = find(jsonUid.as<uint16_t>(), jsonTopic.as<const char*>());
+    }
+
+    return entry;
+}
+
+void PluginTopicHandler::handleTopicRequest(AsyncWebServerRequest* request)
+{
+    const size_t        JSON_DOC_SIZE   = 512U;
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    JsonObject          dataObj         = jsonDoc.createNestedObject("data");
+    uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
+    Entry*              entry           = nullptr;
+
+    lock();
+
+    /* The topic may be unregistered since the request was accepted. */
+    entry = find(request);
+
+    if (nullptr == entry)
+    {
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+        jsonDoc.remove("data");
+
+        /* Prepare response */
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "Requested topic not supported.";
+        httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
+    }
+    else if (HTTP_GET == request->method())
+    {
+        if (false == entry->plugin->getTopic(entry->topic, dataObj))
+        {
+            JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+            jsonDoc.remove("data");
+
+            /* Prepare response */
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+            errorObj["msg"]     = "Requested topic not supported.";
+            httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
+        }
+        else
+        {
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+            httpStatusCode      = HttpStatus::STATUS_CODE_OK;
+        }
+    }
+    else if (HTTP_POST == request->method())
+    {
+        PooledJsonDocument  jsonDocPar(JSON_DOC_SIZE);
+        size_t              idx             = 0U;
+        bool                isSuccessful    = false;
+
+        /* Add arguments */
+        for(idx = 0U; idx < request->args(); ++idx)
+        {
+            jsonDocPar[request->argName(idx)] = request->arg(idx);
+        }
+
+        /* Add uploaded file */
+        if ((false == entry->isUploadError) &&
+            (false == entry->fullPath.isEmpty()))
+        {
+            jsonDocPar["fullPath"] = entry->fullPath;
+        }
+
+        /* Several changed values of the topic are stored at once. */
+        entry->plugin->beginTopicUpdate();
+        isSuccessful = entry->plugin->setTopic(entry->topic, jsonDocPar.as<JsonObject>());
+        entry->plugin->endTopicUpdate();
+
+        if (false == isSuccessful)
+        {
+            JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+            jsonDoc.remove("data");
+
+            /* Prepare response */
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+            errorObj["msg"]     = "Requested topic not supported or invalid data.";
+            httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
+        }
+        else
+        {
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+            httpStatusCode      = HttpStatus::STATUS_CODE_OK;
+        }
+    }
+    else
+    {
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+        jsonDoc.remove("data");
+
+        /* Prepare response */
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "HTTP method not supported.";
+        httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
+    }
+
+    unlock();
+
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
+
+    return;
+}
+
+void PluginTopicHandler::handleBatchRequest(AsyncWebServerRequest* request)
+{
+    const size_t        JSON_DOC_SIZE   = 2048U;
+    PooledJsonDocument  jsonDocBatch(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
+    char*               body            = static_cast<char*>(request->_tempObject);
+
+    if (nullptr == body)
+    {
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+        /* Prepare response */
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "Batch is missing or too large.";
+        httpStatusCode      = HttpStatus::STATUS_CODE_BAD_REQUEST;
+    }
+    else if ((DeserializationError::Ok != deserializeJson(jsonDocBatch, body)) ||
+             (false == jsonDocBatch.is<JsonArray>()))
+    {
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+        /* Prepare response */
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "Invalid batch.";
+        httpStatusCode      = HttpStatus::STATUS_CODE_BAD_REQUEST;
+    }
+    else
+    {
+        JsonArrayConst  updates     = jsonDocBatch.as<JsonArrayConst>();
+        size_t          index       = 0U;
+
+        lock();
+
+        /* A batch is rejected as a whole, if any update is invalid. Nothing
+         * is applied in this case.
+         */
+        if (false == isBatchValid(updates, index))
+        {
+            JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+            /* Prepare response */
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+            errorObj["msg"]     = "Invalid batch update, nothing applied.";
+            errorObj["index"]   = index;
+            httpStatusCode      = HttpStatus::STATUS_CODE_BAD_REQUEST;
+        }
+        else
+        {
+            JsonArray dataArray = jsonDoc.createNestedArray("data");
+
+            /* The topic updates are nested, therefore every plugin stores its
+             * configuration only once, at the end of its last topic update.
+             */
+            for(JsonVariantConst update : updates)
+            {
+                find(update)->plugin->beginTopicUpdate();
+            }
+
+            for(JsonVariantConst update : updates)
+            {
+                JsonObject resultObj = dataArray.createNestedObject();
+
+                setTopic(update, resultObj);
+            }
+
+            for(JsonVariantConst update : updates)
+            {
+                find(update)->plugin->endTopicUpdate();
+            }
+
+            jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+            httpStatusCode      = HttpStatus::STATUS_CODE_OK;
+        }
+
+        unlock();
+    }
+
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
+
+    return;
+}
+
+bool PluginTopicHandler::isBatchValid(JsonArrayConst updates, size_t& index) const
+{
+    bool isValid = true;
+
+    index = 0U;
+
+    for(JsonVariantConst update : updates)
+    {
+        if (true == isValid)
+        {
+            if ((nullptr == find(update)) ||
+                (false == update["data"].is<JsonObjectConst>()))
+            {
+                isValid = false;
+            }
+            else
+            {
+                ++index;
+            }
+        }
+    }
+
+    return isValid;
+}
+
+void PluginTopicHandler::setTopic(JsonVariantConst update, JsonObject& resultObj)
+{
+    const size_t        JSON_DOC_SIZE   = 512U;
+    PooledJsonDocument  jsonDocPar(JSON_DOC_SIZE);
+    Entry*              entry           = find(update);
+    JsonObjectConst     dataObj         = update["data"];
+
+    resultObj["uid"]    = update["uid"];
+    resultObj["topic"]  = update["topic"];
+
+    if ((nullptr != entry) &&
+        (false == dataObj.isNull()))
+    {
+        /* The topic data is provided like the arguments of a single topic
+         * request, which are always strings.
+         */
+        for(JsonPairConst pair : dataObj)
+        {
+            if (true == pair.value().is<const char*>())
+            {
+                jsonDocPar[pair.key().c_str()] = pair.value().as<const char*>();
+            }
+            else
+            {
+                String value;
+
+                (void)serializeJson(pair.value(), value);
+                jsonDocPar[pair.key().c_str()] = value;
+            }
+        }
+    }
+
+    if (nullptr == entry)
+    {
+        JsonObject errorObj = resultObj.createNestedObject("error");
+
+        resultObj["status"] = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "Requested topic not supported.";
+    }
+    else if ((true == dataObj.isNull()) ||
+             (false == entry->plugin->setTopic(entry->topic, jsonDocPar.as<JsonObject>())))
+    {
+        JsonObject errorObj = resultObj.createNestedObject("error");
+
+        resultObj["status"] = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = "Requested topic not supported or invalid data.";
+    }
+    else
+    {
+        resultObj["status"] = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+    }
+
+    return;
+}
+
+
+void PluginTopicHandler::lock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void PluginTopicHandler::unlock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,319 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Plugin topic web handler
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup plugin
+ *
+ * @{
+ */
+
+#ifndef __PLUGINTOPICHANDLER_H__
+#define __PLUGINTOPICHANDLER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include "IPluginMaintenance.hpp"
+
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * A single web handler for the REST API topics of all plugins, which are
+ * available at <base-uri>/display/uid/<plugin-uid><topic>.
+ *
+ * The plugin uid and the topic are parsed from the URL and looked up in a
+ * hash table. In comparison to one web handler per topic, the request
+ * matching effort doesn't depend on the number of installed plugins and
+ * registering or unregistering a topic doesn't walk the webserver handler
+ * list.
+ *
+ * Several topics of one or more plugins can be set at once with a batch
+ * request to <base-uri>/display/topics. The batch is applied without any
+ * other topic request in between and every plugin stores its configuration
+ * at most once, at the end of the batch.
+ */
+class PluginTopicHandler : public AsyncWebHandler
+{
+public:
+
+    /**
+     * Constructs the plugin topic handler.
+     */
+    PluginTopicHandler();
+
+    /**
+     * Destroys the plugin topic handler.
+     */
+    ~PluginTopicHandler();
+
+    /**
+     * Register a plugin topic.
+     *
+     * @param[in] plugin    The plugin, which provides the topic.
+     * @param[in] topic     The topic.
+     *
+     * @return If successful registered, it will return true otherwise false.
+     */
+    bool registerTopic(IPluginMaintenance* plugin, const String& topic);
+
+    /**
+     * Unregister a plugin topic.
+     *
+     * @param[in] plugin    The plugin, which provides the topic.
+     * @param[in] topic     The topic.
+     */
+    void unregisterTopic(IPluginMaintenance* plugin, const String& topic);
+
+    /**
+     * Checks whether the request can be handled.
+     *
+     * @param[in] request   Web request
+     *
+     * @return If request can be handled, it will return true otherwise false.
+     */
+    bool canHandle(AsyncWebServerRequest* request) final;
+
+    /**
+     * Handles the request.
+     *
+     * @param[in] request   Web request, which to handle.
+     */
+    void handleRequest(AsyncWebServerRequest* request) final;
+
+    /**
+     * Handles a file upload.
+     *
+     * @param[in] request   HTTP request.
+     * @param[in] filename  Name of the uploaded file.
+     * @param[in] index     Current file offset.
+     * @param[in] data      Next data part of file, starting at offset.
+     * @param[in] len       Data part size in byte.
+     * @param[in] final     Is final packet or not.
+     */
+    void handleUpload(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data, size_t len, bool final) final;
+
+    /**
+     * Handles the request body of a batch request.
+     *
+     * @param[in] request   HTTP request.
+     * @param[in] data      Next data part of the body, starting at index.
+     * @param[in] len       Data part size in byte.
+     * @param[in] index     Current body offset.
+     * @param[in] total     Body size in byte.
+     */
+    void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) final;
+
+    /**
+     * Non-trivial handler.
+     * This is important to control the HTTP body parsing. In case of a non-trivial
+     * handler, the webserver will parse the body and provides encoded parameters to
+     * the request handler.
+     */
+    bool isRequestHandlerTrivial() final
+    {
+        return false;
+    }
+
+    /**
+     * Number of hash buckets. Must be a power of 2.
+     */
+    static const uint8_t    BUCKETS         = 32U;
+
+    /**
+     * Max. size of a batch request body in byte.
+     */
+    static const size_t     MAX_BATCH_SIZE  = 4096U;
+
+private:
+
+    /**
+     * A registered topic, which is chained with all other topics in the
+     * same hash bucket.
+     */
+    struct Entry
+    {
+        uint16_t            uid;            /**< Plugin UID */
+        String              topic;          /**< Topic */
+        IPluginMaintenance* plugin;         /**< Plugin, which provides the topic. */
+        bool                isUploadError;  /**< If upload error happened, it will be true otherwise false. */
+        String              fullPath;       /**< Full path of uploaded file. If empty, there is no file available. */
+        File                fd;             /**< Upload file descriptor */
+        Entry*              next;           /**< Next entry in the same bucket */
+
+        /**
+         * Initialize the entry.
+         */
+        Entry() :
+            uid(0U),
+            topic(),
+            plugin(nullptr),
+            isUploadError(false),
+            fullPath(),
+            fd(),
+            next(nullptr)
+        {
+        }
+    };
+
+    Entry*              m_buckets[BUCKETS]; /**< Hash buckets */
+    SemaphoreHandle_t   m_xMutex;           /**< Mutex to protect the hash table. */
+
+    PluginTopicHandler(const PluginTopicHandler& handler);
+    PluginTopicHandler& operator=(const PluginTopicHandler& handler);
+
+    /**
+     * Parse the plugin uid and the topic from a request URL.
+     *
+     * @param[in]   url     Request URL
+     * @param[out]  uid     Plugin UID
+     * @param[out]  topic   Topic, which points into the URL.
+     *
+     * @return If the URL is a plugin topic URL, it will return true otherwise false.
+     */
+    static bool parseUrl(const String& url, uint16_t& uid, const char*& topic);
+
+    /**
+     * Is the request URL the batch request URL?
+     *
+     * @param[in] url   Request URL
+     *
+     * @return If it is the batch request URL, it will return true otherwise false.
+     */
+    static bool isBatchUrl(const String& url);
+
+    /**
+     * Get the hash bucket index of a topic.
+     *
+     * @param[in] uid   Plugin UID
+     * @param[in] topic Topic
+     *
+     * @return Bucket index
+     */
+    static uint8_t getBucket(uint16_t uid, const char* topic);
+
+    /**
+     * Find a registered topic.
+     * The hash table must be locked.
+     *
+     * @param[in] uid   Plugin UID
+     * @param[in] topic Topic
+     *
+     * @return If found, it will return the entry otherwise nullptr.
+     */
+    Entry* find(uint16_t uid, const char* topic) const;
+
+    /**
+     * Find the registered topic of a request.
+     * The hash table must be locked.
+     *
+     * @param[in] request   Web request
+     *
+     * @return If found, it will return the entry otherwise nullptr.
+     */
+    Entry* find(AsyncWebServerRequest* request) const;
+
+    /**
+     * Find the registered topic of a batch update.
+     * The hash table must be locked.
+     *
+     * @param[in] update    Batch update, which contains the plugin uid and the topic.
+     *
+     * @return If found, it will return the entry otherwise nullptr.
+     */
+    Entry* find(JsonVariantConst update) const;
+
+    /**
+     * Handles a request of a single topic.
+     *
+     * @param[in] request   Web request, which to handle.
+     */
+    void handleTopicRequest(AsyncWebServerRequest* request);
+
+    /**
+     * Handles a batch request, which sets several topics at once.
+     *
+     * @param[in] request   Web request, which to handle.
+     */
+    void handleBatchRequest(AsyncWebServerRequest* request);
+
+    /**
+     * Validate every update of a batch, before any of them is applied.
+     * A update is valid, if the topic is registered for the plugin and
+     * the topic data is present.
+     * The hash table must be locked.
+     *
+     * @param[in]   updates Batch updates
+     * @param[out]  index   Index of the first invalid update
+     *
+     * @return If all updates are valid, it will return true otherwise false.
+     */
+    bool isBatchValid(JsonArrayConst updates, size_t& index) const;
+
+    /**
+     * Set the topic of a single batch update.
+     * The hash table must be locked.
+     *
+     * @param[in]   update      Batch update
+     * @param[out]  resultObj   Result of the update
+     */
+    void setTopic(JsonVariantConst update, JsonObject& resultObj);
+
+    /**
+     * Protect against concurrent access.
+     */
+    void lock() const;
+
+    /**
+     * Unprotect against concurrent access.
+     */
+    void unlock() const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __PLUGINTOPICHANDLER_H__ */
+
+/** @} */
@@ -106,6 +106,21 @@ void BTCQuotePlugin::inactive()
     return;
 }
 
+bool BTCQuotePlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    m_bitmapWidget.clear();
+    m_client.releaseBuffers();
+
+    unlock();
+
+    return true;
+}
+
 void BTCQuotePlugin::update(IGfx& gfx)
 {
     lock();
@@ -210,25 +225,22 @@ bool BTCQuotePlugin::startHttpRequest()
 
 void BTCQuotePlugin::initHttpClient()
 {
-    m_client.regOnResponse([this](const HttpResponse& rsp){
-        size_t                          payloadSize             = 0U;
-        const char*                     payload                 = reinterpret_cast<const char*>(rsp.getPayload(payloadSize));
-        const size_t                    JSON_DOC_SIZE           = 512U;
-        DynamicJsonDocument             jsonDoc(JSON_DOC_SIZE);
-        const size_t                    FILTER_SIZE             = 128U;
-        StaticJsonDocument<FILTER_SIZE> filter;
-        DeserializationError            error;
-
-        filter["bpi"]["USD"]["rate_float"]      = true;
-        filter["bpi"]["USD"]["rate"]            = true;
-
-        if (true == filter.overflowed())
-        {
-            LOG_ERROR("Less memory for filter available.");
-        }
+    const size_t                    JSON_DOC_SIZE           = 512U;
+    const size_t                    FILTER_SIZE             = 128U;
+    StaticJsonDocument<FILTER_SIZE> filter;
+
+    filter["bpi"]["USD"]["rate_float"]      = true;
+    filter["bpi"]["USD"]["rate"]            = true;
+
+    if (true == filter.overflowed())
+    {
+        LOG_ERROR("Less memory for filter available.");
+    }
 
-        error = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(filter));
+    m_client.setPollPeriod(UPDATE_PERIOD);
 
+    /* The response is parsed while it is received, only the filtered values are kept. */
+    m_client.regOnJsonResponse(filter, JSON_DOC_SIZE, [this](const DeserializationError& error, JsonDocument& jsonDoc){
         if (DeserializationError::Ok != error.code())
         {
             LOG_ERROR("Invalid JSON message received: %s", error.c_str());
@@ -37,6 +37,7 @@
 #include "RestApi.h"
 #include "Util.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
 
 #include <ArduinoJson.h>
 #include <Logging.h>
@@ -185,18 +186,23 @@ void CountdownPlugin::inactive()
     return;
 }
 
-void CountdownPlugin::update(IGfx& gfx)
+bool CountdownPlugin::hibernate()
 {
     lock();
 
-    if ((true == m_cfgReloadTimer.isTimerRunning()) &&
-        (true == m_cfgReloadTimer.isTimeout()))
-    {
-        (void)loadConfiguration();
-        calculateDifferenceInDays();
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
 
-        m_cfgReloadTimer.restart();
-    }
+    m_bitmapWidget.clear();
+
+    unlock();
+
+    return true;
+}
+
+void CountdownPlugin::update(IGfx& gfx)
+{
+    lock();
 
     gfx.fillScreen(ColorDef::BLACK);
 
@@ -215,6 +221,43 @@ void CountdownPlugin::update(IGfx& gfx)
     return;
 }
 
+void CountdownPlugin::process()
+{
+    bool isReloadRequired = false;
+
+    lock();
+
+    if (true == m_isReloadDone)
+    {
+        applyReloadedConfiguration();
+    }
+
+    if ((true == m_cfgReloadTimer.isTimerRunning()) &&
+        (true == m_cfgReloadTimer.isTimeout()))
+    {
+        if (false == m_isReloadPending)
+        {
+            m_isReloadPending   = true;
+            isReloadRequired    = true;
+        }
+
+        m_cfgReloadTimer.restart();
+    }
+
+    unlock();
+
+    if (true == isReloadRequired)
+    {
+        /* If the worker pool is not available, reload it directly. */
+        if (false == WorkerPool::getInstance().submit(reloadJob, this))
+        {
+            reloadConfiguration();
+        }
+    }
+
+    return;
+}
+
 void CountdownPlugin::start()
 {
     lock();
@@ -285,7 +328,7 @@ void CountdownPlugin::setTargetDate(const DateDMY& targetDate)
         /* Always stores the configuration, otherwise it will be overwritten during
          * plugin activation.
          */
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -320,7 +363,7 @@ void CountdownPlugin::setTargetDayDescription(const TargetDayDescription& target
         /* Always stores the configuration, otherwise it will be overwritten during
          * plugin activation.
          */
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -341,7 +384,7 @@ bool CountdownPlugin::saveConfiguration() const
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     jsonDoc["day"]                  = m_targetDate.day;
@@ -364,11 +407,16 @@ bool CountdownPlugin::saveConfiguration() const
 }
 
 bool CountdownPlugin::loadConfiguration()
+{
+    return readConfiguration(m_targetDate, m_targetDateInformation);
+}
+
+bool CountdownPlugin::readConfiguration(DateDMY& targetDate, TargetDayDescription& targetDateInformation) const
 {
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
@@ -378,16 +426,60 @@ bool CountdownPlugin::loadConfiguration()
     }
     else
     {
-        m_targetDate.day                    = jsonDoc["day"].as<uint8_t>();
-        m_targetDate.month                  = jsonDoc["month"].as<uint8_t>();
-        m_targetDate.year                   = jsonDoc["year"].as<uint16_t>();
-        m_targetDateInformation.plural      = jsonDoc["descriptionPlural"].as<String>();
-        m_targetDateInformation.singular    = jsonDoc["descriptionSingular"].as<String>();
+        targetDate.day                  = jsonDoc["day"].as<uint8_t>();
+        targetDate.month                = jsonDoc["month"].as<uint8_t>();
+        targetDate.year                 = jsonDoc["year"].as<uint16_t>();
+        targetDateInformation.plural    = jsonDoc["descriptionPlural"].as<String>();
+        targetDateInformation.singular  = jsonDoc["descriptionSingular"].as<String>();
     }
 
     return status;
 }
 
+void CountdownPlugin::reloadConfiguration()
+{
+    /* The reload buffer is owned by the worker as long as the reload is
+     * pending and not done. The lock is only taken to mark it as done.
+     */
+    m_isReloadedValid = readConfiguration(m_reloadedTargetDate, m_reloadedTargetDateInformation);
+
+    lock();
+    m_isReloadDone = true;
+    unlock();
+
+    return;
+}
+
+void CountdownPlugin::applyReloadedConfiguration()
+{
+    /* A configuration, which is not saved yet, is newer than the loaded one. */
+    if ((true == m_isReloadedValid) &&
+        (false == isSaveConfigurationPending()))
+    {
+        m_targetDate            = m_reloadedTargetDate;
+        m_targetDateInformation = m_reloadedTargetDateInformation;
+    }
+
+    calculateDifferenceInDays();
+
+    m_isReloadDone      = false;
+    m_isReloadPending   = false;
+
+    return;
+}
+
+void CountdownPlugin::reloadJob(void* arg)
+{
+    CountdownPlugin* plugin = static_cast<CountdownPlugin*>(arg);
+
+    if (nullptr != plugin)
+    {
+        plugin->reloadConfiguration();
+    }
+
+    return;
+}
+
 void CountdownPlugin::calculateDifferenceInDays()
 {
     tm currentTime;
@@ -52,6 +52,7 @@
 #include <stdint.h>
 #include <TextWidget.h>
 #include <SimpleTimer.hpp>
+#include <WorkerPool.h>
 
 /******************************************************************************
  * Macros
@@ -185,7 +186,12 @@ public:
         m_targetDateInformation(),
         m_remainingDays(""),
         m_xMutex(nullptr),
-        m_cfgReloadTimer()
+        m_cfgReloadTimer(),
+        m_isReloadPending(false),
+        m_isReloadDone(false),
+        m_isReloadedValid(false),
+        m_reloadedTargetDate(),
+        m_reloadedTargetDateInformation()
     {
         /* Example data, used to generate the very first configuration file. */
         m_targetDate.day                    = 29;
@@ -197,7 +203,7 @@ public:
         /* Move the text widget one line lower for better look. */
         m_textWidget.move(0, 1);
 
-        m_xMutex = xSemaphoreCreateMutex();
+        m_xMutex = xSemaphoreCreateRecursiveMutex();
     }
 
     /**
@@ -205,6 +211,9 @@ public:
      */
     ~CountdownPlugin()
     {
+        /* A pending configuration reload must not access the plugin anymore. */
+        WorkerPool::getInstance().cancel(this);
+
         if (nullptr != m_iconCanvas)
         {
             delete m_iconCanvas;
@@ -288,6 +297,15 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and the icon
+     * is released. They are rebuilt in active().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -296,6 +314,13 @@ public:
      */
     void update(IGfx& gfx) final;
 
+    /**
+     * Process the plugin.
+     * The configuration is reloaded periodically by the worker pool, so the
+     * file access never delays the display update.
+     */
+    void process(void) final;
+
    /**
      * Stop the plugin.
      * Overwrite it if your plugin needs to know that it will be uninstalled.
@@ -387,17 +412,53 @@ private:
     String                      m_remainingDays;            /**< String used for displaying the remaining days untril the target date. */
     SemaphoreHandle_t           m_xMutex;                   /**< Mutex to protect against concurrent access. */
     SimpleTimer                 m_cfgReloadTimer;           /**< Timer is used to cyclic reload the configuration from persistent memory. */
+    bool                        m_isReloadPending;          /**< Is a configuration reload job pending? */
+    bool                        m_isReloadDone;             /**< Is the reloaded configuration ready to be applied? */
+    bool                        m_isReloadedValid;          /**< Was the configuration reloaded successful? */
+    DateDMY                     m_reloadedTargetDate;       /**< Reloaded target date, written by the worker only while a reload is pending. */
+    TargetDayDescription        m_reloadedTargetDateInformation; /**< Reloaded target date information, written by the worker only while a reload is pending. */
 
     /**
      * Saves current configuration to JSON file.
      */
-    bool saveConfiguration() const;
+    bool saveConfiguration() const final;
 
     /**
      * Load configuration from JSON file.
      */
     bool loadConfiguration();
 
+    /**
+     * Read configuration from JSON file, without touching the plugin state.
+     * Therefore it can be called without holding the lock.
+     *
+     * @param[out] targetDate               Target date
+     * @param[out] targetDateInformation    Target day description
+     *
+     * @return If successful read, it will return true otherwise false.
+     */
+    bool readConfiguration(DateDMY& targetDate, TargetDayDescription& targetDateInformation) const;
+
+    /**
+     * Reload the configuration into the reload buffer.
+     * Runs in the worker pool context. The rendered configuration is not
+     * touched, it is applied later by applyReloadedConfiguration().
+     */
+    void reloadConfiguration();
+
+    /**
+     * Apply the reloaded configuration to the plugin.
+     * Runs in the display task context with the plugin locked.
+     */
+    void applyReloadedConfiguration();
+
+    /**
+     * Configuration reload job, executed by the worker pool.
+     *
+     * @param[in] arg   Plugin instance
+     */
+    static void reloadJob(void* arg);
+
     /**
      * Calculates the difference between m_targetTime and m_currentTime in days.
      */
@@ -424,12 +485,12 @@ private:
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
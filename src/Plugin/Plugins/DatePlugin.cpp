@@ -123,6 +123,14 @@ void DatePlugin::inactive()
     return;
 }
 
+bool DatePlugin::hibernate()
+{
+    releaseCanvas(m_textCanvas);
+    releaseCanvas(m_lampCanvas);
+
+    return true;
+}
+
 void DatePlugin::update(IGfx& gfx)
 {
     if (false != m_isUpdateAvailable)
@@ -141,6 +141,14 @@ void DateTimePlugin::inactive()
     return;
 }
 
+bool DateTimePlugin::hibernate()
+{
+    releaseCanvas(m_textCanvas);
+    releaseCanvas(m_lampCanvas);
+
+    return true;
+}
+
 void DateTimePlugin::update(IGfx& gfx)
 {
     if (false != m_isUpdateAvailable)
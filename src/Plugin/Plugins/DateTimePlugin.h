@@ -142,6 +142,15 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and rebuilt
+     * in active().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
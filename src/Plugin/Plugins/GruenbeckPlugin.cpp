@@ -36,6 +36,7 @@
 #include "RestApi.h"
 #include "AsyncHttpClient.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
 
 #include <ArduinoJson.h>
 #include <Logging.h>
@@ -167,6 +168,21 @@ void GruenbeckPlugin::inactive()
     return;
 }
 
+bool GruenbeckPlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    m_bitmapWidget.clear();
+    m_client.releaseBuffers();
+
+    unlock();
+
+    return true;
+}
+
 void GruenbeckPlugin::update(IGfx& gfx)
 {
     lock();
@@ -287,7 +303,7 @@ void GruenbeckPlugin::setIPAddress(const String& ipAddress)
 {
     lock();
     m_ipAddress = ipAddress;
-    (void)saveConfiguration();
+    requestSaveConfiguration();
     unlock();
 
     return;
@@ -330,6 +346,8 @@ bool GruenbeckPlugin::startHttpRequest()
 
 void GruenbeckPlugin::initHttpClient()
 {
+    m_client.setPollPeriod(UPDATE_PERIOD);
+
     m_client.regOnResponse([this](const HttpResponse& rsp){
         /* Structure of response-payload for requesting D_Y_10_1
          *
@@ -396,7 +414,7 @@ bool GruenbeckPlugin::saveConfiguration() const
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     jsonDoc["gruenbeckIP"] = m_ipAddress;
@@ -419,7 +437,7 @@ bool GruenbeckPlugin::loadConfiguration()
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
@@ -186,6 +186,15 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and the icon
+     * is released. They are rebuilt in active().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -288,7 +297,7 @@ private:
     /**
      * Saves current configuration to JSON file.
      */
-    bool saveConfiguration() const;
+    bool saveConfiguration() const final;
 
     /**
      * Load configuration from JSON file.
@@ -298,12 +307,12 @@ private:
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
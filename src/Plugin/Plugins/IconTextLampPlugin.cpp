@@ -248,8 +248,12 @@ void IconTextLampPlugin::active(IGfx& gfx)
         {
             (void)m_iconCanvas->addWidget(m_bitmapWidget);
 
-            /* If there is already an icon in the filesystem, load it. */
-            (void)m_bitmapWidget.load(FILESYSTEM, getFileName());
+            /* If there is no icon yet, but already one in the filesystem, load it. */
+            if ((false == hasIcon()) &&
+                (true == m_bitmapWidget.load(FILESYSTEM, getFileName())))
+            {
+                m_iconFullPath = getFileName();
+            }
         }
     }
 
@@ -293,6 +297,40 @@ void IconTextLampPlugin::inactive()
     return;
 }
 
+bool IconTextLampPlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+    releaseCanvas(m_lampCanvas);
+
+    /* An icon from the filesystem can be reloaded, one from memory not. */
+    if (false == m_iconFullPath.isEmpty())
+    {
+        m_bitmapWidget.clear();
+    }
+
+    unlock();
+
+    return true;
+}
+
+void IconTextLampPlugin::resume()
+{
+    lock();
+
+    if ((false == hasIcon()) &&
+        (false == m_iconFullPath.isEmpty()))
+    {
+        (void)m_bitmapWidget.load(FILESYSTEM, m_iconFullPath);
+    }
+
+    unlock();
+
+    return;
+}
+
 void IconTextLampPlugin::update(IGfx& gfx)
 {
     lock();
@@ -347,6 +385,7 @@ void IconTextLampPlugin::setBitmap(const Color* bitmap, uint16_t width, uint16_t
     {
         lock();
         m_bitmapWidget.set(bitmap, width, height);
+        m_iconFullPath.clear();
         unlock();
     }
 
@@ -359,6 +398,12 @@ bool IconTextLampPlugin::loadBitmap(const String& filename)
 
     lock();
     status = m_bitmapWidget.load(FILESYSTEM, filename);
+
+    if (true == status)
+    {
+        m_iconFullPath = filename;
+    }
+
     unlock();
 
     return status;
@@ -403,6 +448,14 @@ String IconTextLampPlugin::getFileName()
     return generateFullPath(".bmp");
 }
 
+bool IconTextLampPlugin::hasIcon() const
+{
+    uint16_t width  = 0U;
+    uint16_t height = 0U;
+
+    return (nullptr != m_bitmapWidget.get(width, height));
+}
+
 void IconTextLampPlugin::lock() const
 {
     if (nullptr != m_xMutex)
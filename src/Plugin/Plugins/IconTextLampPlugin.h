@@ -81,6 +81,7 @@ public:
         m_textCanvas(nullptr),
         m_lampCanvas(nullptr),
         m_bitmapWidget(),
+        m_iconFullPath(),
         m_textWidget(),
         m_lampWidgets(),
         m_xMutex(nullptr)
@@ -198,6 +199,22 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and rebuilt
+     * in active(). An icon loaded from the filesystem is released too and
+     * reloaded in resume().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
+    /**
+     * This method will be called before the hibernated plugin is prepared or
+     * set active. It reloads the icon from the filesystem.
+     */
+    void resume() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -296,6 +313,7 @@ private:
     Canvas*                     m_textCanvas;               /**< Canvas used for the text widget. */
     Canvas*                     m_lampCanvas;               /**< Canvas used for the lamp widget. */
     BitmapWidget                m_bitmapWidget;             /**< Bitmap widget, used to show the icon. */
+    String                      m_iconFullPath;             /**< Full path of the icon file, used to reload it after hibernation. Empty if the icon is not from the filesystem. */
     TextWidget                  m_textWidget;               /**< Text widget, used for showing the text. */
     LampWidget                  m_lampWidgets[MAX_LAMPS];   /**< Lamp widgets, used to signal different things. */
     SemaphoreHandle_t           m_xMutex;                   /**< Mutex to protect against concurrent access. */
@@ -307,15 +325,22 @@ private:
      */
     String getFileName(void);
 
+    /**
+     * Is an icon available?
+     *
+     * @return If an icon is available, it will return true otherwise false.
+     */
+    bool hasIcon() const;
+
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
@@ -165,8 +165,12 @@ void IconTextPlugin::active(IGfx& gfx)
         {
             (void)m_iconCanvas->addWidget(m_bitmapWidget);
 
-            /* If there is already an icon in the filesystem, load it. */
-            (void)m_bitmapWidget.load(FILESYSTEM, getFileName());
+            /* If there is no icon yet, but already one in the filesystem, load it. */
+            if ((false == hasIcon()) &&
+                (true == m_bitmapWidget.load(FILESYSTEM, getFileName())))
+            {
+                m_iconFullPath = getFileName();
+            }
         }
     }
 
@@ -194,6 +198,39 @@ void IconTextPlugin::inactive()
     return;
 }
 
+bool IconTextPlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    /* An icon from the filesystem can be reloaded, one from memory not. */
+    if (false == m_iconFullPath.isEmpty())
+    {
+        m_bitmapWidget.clear();
+    }
+
+    unlock();
+
+    return true;
+}
+
+void IconTextPlugin::resume()
+{
+    lock();
+
+    if ((false == hasIcon()) &&
+        (false == m_iconFullPath.isEmpty()))
+    {
+        (void)m_bitmapWidget.load(FILESYSTEM, m_iconFullPath);
+    }
+
+    unlock();
+
+    return;
+}
+
 void IconTextPlugin::update(IGfx& gfx)
 {
     lock();
@@ -243,6 +280,7 @@ void IconTextPlugin::setBitmap(const Color* bitmap, uint16_t width, uint16_t hei
     {
         lock();
         m_bitmapWidget.set(bitmap, width, height);
+        m_iconFullPath.clear();
         unlock();
     }
 
@@ -255,6 +293,12 @@ bool IconTextPlugin::loadBitmap(const String& filename)
 
     lock();
     status = m_bitmapWidget.load(FILESYSTEM, filename);
+
+    if (true == status)
+    {
+        m_iconFullPath = filename;
+    }
+
     unlock();
 
     return status;
@@ -273,6 +317,14 @@ String IconTextPlugin::getFileName()
     return generateFullPath(".bmp");
 }
 
+bool IconTextPlugin::hasIcon() const
+{
+    uint16_t width  = 0U;
+    uint16_t height = 0U;
+
+    return (nullptr != m_bitmapWidget.get(width, height));
+}
+
 void IconTextPlugin::lock() const
 {
     if (nullptr != m_xMutex)
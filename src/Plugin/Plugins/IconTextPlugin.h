@@ -78,6 +78,7 @@ public:
         m_textCanvas(nullptr),
         m_iconCanvas(nullptr),
         m_bitmapWidget(),
+        m_iconFullPath(),
         m_textWidget(),
         m_isUploadError(false),
         m_xMutex(nullptr)
@@ -189,6 +190,22 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and rebuilt
+     * in active(). An icon loaded from the filesystem is released too and
+     * reloaded in resume().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
+    /**
+     * This method will be called before the hibernated plugin is prepared or
+     * set active. It reloads the icon from the filesystem.
+     */
+    void resume() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -254,6 +271,7 @@ private:
     Canvas*             m_textCanvas;       /**< Canvas used for the text widget. */
     Canvas*             m_iconCanvas;       /**< Canvas used for the bitmap widget. */
     BitmapWidget        m_bitmapWidget;     /**< Bitmap widget, used to show the icon. */
+    String              m_iconFullPath;     /**< Full path of the icon file, used to reload it after hibernation. Empty if the icon is not from the filesystem. */
     TextWidget          m_textWidget;       /**< Text widget, used for showing the text. */
     bool                m_isUploadError;    /**< Flag to signal a upload error. */
     SemaphoreHandle_t   m_xMutex;           /**< Mutex to protect against concurrent access. */
@@ -265,15 +283,22 @@ private:
      */
     String getFileName(void);
 
+    /**
+     * Is an icon available?
+     *
+     * @return If an icon is available, it will return true otherwise false.
+     */
+    bool hasIcon() const;
+
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
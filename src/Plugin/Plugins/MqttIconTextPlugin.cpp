@@ -0,0 +1,532 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT icon and text plugin
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MqttIconTextPlugin.h"
+#include "FileSystem.h"
+#include "JsonDocPool.h"
+
+#include <Logging.h>
+#include <ArduinoJson.h>
+#include <JsonFile.h>
+#include <Util.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/* Initialize plugin topic for the MQTT configuration. */
+const char* MqttIconTextPlugin::TOPIC_MQTT      = "/mqtt";
+
+/* Initialize plugin topic for the icon upload. */
+const char* MqttIconTextPlugin::TOPIC_ICON      = "/bitmap";
+
+/* Initialize default format string. */
+const char* MqttIconTextPlugin::DEFAULT_FORMAT  = "%s";
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void MqttIconTextPlugin::getTopics(JsonArray& topics) const
+{
+    (void)topics.add(TOPIC_MQTT);
+    (void)topics.add(TOPIC_ICON);
+}
+
+bool MqttIconTextPlugin::getTopic(const String& topic, JsonObject& value) const
+{
+    bool isSuccessful = false;
+
+    if (0U != topic.equals(TOPIC_MQTT))
+    {
+        value["topic"]  = getMqttTopic();
+        value["format"] = getFormat();
+
+        isSuccessful = true;
+    }
+
+    return isSuccessful;
+}
+
+bool MqttIconTextPlugin::setTopic(const String& topic, const JsonObject& value)
+{
+    bool isSuccessful = false;
+
+    if (0U != topic.equals(TOPIC_MQTT))
+    {
+        if (false == value["format"].isNull())
+        {
+            setFormat(value["format"].as<String>());
+            isSuccessful = true;
+        }
+
+        if (false == value["topic"].isNull())
+        {
+            setMqttTopic(value["topic"].as<String>());
+            isSuccessful = true;
+        }
+    }
+    else if (0U != topic.equals(TOPIC_ICON))
+    {
+        if (false == value["fullPath"].isNull())
+        {
+            String fullPath = value["fullPath"].as<String>();
+
+            lock();
+            isSuccessful = m_bitmapWidget.load(FILESYSTEM, fullPath);
+
+            if (true == isSuccessful)
+            {
+                m_iconFullPath = fullPath;
+            }
+
+            unlock();
+        }
+    }
+    else
+    {
+        ;
+    }
+
+    return isSuccessful;
+}
+
+bool MqttIconTextPlugin::isUploadAccepted(const String& topic, const String& srcFilename, String& dstFilename)
+{
+    bool isAccepted = false;
+
+    if (0U != topic.equals(TOPIC_ICON))
+    {
+        /* Accept upload of bitmap file. */
+        if (0U != srcFilename.endsWith(".bmp"))
+        {
+            dstFilename = getFileName();
+
+            isAccepted = true;
+        }
+    }
+
+    return isAccepted;
+}
+
+void MqttIconTextPlugin::start()
+{
+    lock();
+
+    /* Try to load configuration. If there is no configuration available, a default configuration
+     * will be created.
+     */
+    if (false == loadConfiguration())
+    {
+        if (false == saveConfiguration())
+        {
+            LOG_WARNING("Failed to create initial configuration file %s.", getFullPathToConfiguration().c_str());
+        }
+    }
+
+    unlock();
+
+    updateSubscription();
+
+    return;
+}
+
+void MqttIconTextPlugin::stop()
+{
+    String      configurationFilename   = getFullPathToConfiguration();
+    uint32_t    subscriptionId          = MqttClient::INVALID_ID;
+
+    lock();
+
+    subscriptionId      = m_subscriptionId;
+    m_subscriptionId    = MqttClient::INVALID_ID;
+
+    if (false != FILESYSTEM.remove(configurationFilename))
+    {
+        LOG_INFO("File %s removed", configurationFilename.c_str());
+    }
+
+    if (false != FILESYSTEM.remove(getFileName()))
+    {
+        LOG_INFO("File %s removed", getFileName().c_str());
+    }
+
+    unlock();
+
+    MqttClient::getInstance().unsubscribe(subscriptionId);
+
+    return;
+}
+
+void MqttIconTextPlugin::active(IGfx& gfx)
+{
+    lock();
+
+    if (nullptr == m_iconCanvas)
+    {
+        m_iconCanvas = new Canvas(ICON_WIDTH, ICON_HEIGHT, 0, 0);
+
+        if (nullptr != m_iconCanvas)
+        {
+            (void)m_iconCanvas->addWidget(m_bitmapWidget);
+
+            /* If there is no icon yet, but already one in the filesystem, load it. */
+            if ((false == hasIcon()) &&
+                (true == m_bitmapWidget.load(FILESYSTEM, getFileName())))
+            {
+                m_iconFullPath = getFileName();
+            }
+        }
+    }
+
+    if (nullptr == m_textCanvas)
+    {
+        m_textCanvas = new Canvas(gfx.getWidth() - ICON_WIDTH, gfx.getHeight(), ICON_WIDTH, 0);
+
+        if (nullptr != m_textCanvas)
+        {
+            (void)m_textCanvas->addWidget(m_textWidget);
+
+            /* Move the text widget one line lower for better look. */
+            m_textWidget.move(0, 1);
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void MqttIconTextPlugin::inactive()
+{
+    /* Nothing to do. */
+    return;
+}
+
+bool MqttIconTextPlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    /* An icon from the filesystem can be reloaded, one from memory not. */
+    if (false == m_iconFullPath.isEmpty())
+    {
+        m_bitmapWidget.clear();
+    }
+
+    unlock();
+
+    return true;
+}
+
+void MqttIconTextPlugin::resume()
+{
+    lock();
+
+    if ((false == hasIcon()) &&
+        (false == m_iconFullPath.isEmpty()))
+    {
+        (void)m_bitmapWidget.load(FILESYSTEM, m_iconFullPath);
+    }
+
+    unlock();
+
+    return;
+}
+
+void MqttIconTextPlugin::update(IGfx& gfx)
+{
+    lock();
+
+    gfx.fillScreen(ColorDef::BLACK);
+
+    if (nullptr != m_iconCanvas)
+    {
+        m_iconCanvas->update(gfx);
+    }
+
+    if (nullptr != m_textCanvas)
+    {
+        m_textCanvas->update(gfx);
+    }
+
+    unlock();
+
+    return;
+}
+
+String MqttIconTextPlugin::getMqttTopic() const
+{
+    String mqttTopic;
+
+    lock();
+    mqttTopic = m_mqttTopic;
+    unlock();
+
+    return mqttTopic;
+}
+
+void MqttIconTextPlugin::setMqttTopic(const String& mqttTopic)
+{
+    bool isChanged = false;
+
+    lock();
+
+    if (mqttTopic != m_mqttTopic)
+    {
+        m_mqttTopic = mqttTopic;
+        isChanged   = true;
+
+        requestSaveConfiguration();
+    }
+
+    unlock();
+
+    if (true == isChanged)
+    {
+        updateSubscription();
+    }
+
+    return;
+}
+
+String MqttIconTextPlugin::getFormat() const
+{
+    String format;
+
+    lock();
+    format = m_format;
+    unlock();
+
+    return format;
+}
+
+void MqttIconTextPlugin::setFormat(const String& format)
+{
+    lock();
+
+    if (format != m_format)
+    {
+        m_format = format;
+
+        requestSaveConfiguration();
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+String MqttIconTextPlugin::getFileName()
+{
+    return generateFullPath(".bmp");
+}
+
+bool MqttIconTextPlugin::hasIcon() const
+{
+    uint16_t width  = 0U;
+    uint16_t height = 0U;
+
+    return (nullptr != m_bitmapWidget.get(width, height));
+}
+
+void MqttIconTextPlugin::updateSubscription()
+{
+    MqttClient& mqttClient      = MqttClient::getInstance();
+    String      mqttTopic;
+    uint32_t    subscriptionId  = MqttClient::INVALID_ID;
+
+    lock();
+    mqttTopic           = m_mqttTopic;
+    subscriptionId      = m_subscriptionId;
+    m_subscriptionId    = MqttClient::INVALID_ID;
+    unlock();
+
+    mqttClient.unsubscribe(subscriptionId);
+    subscriptionId = MqttClient::INVALID_ID;
+
+    if (0U < mqttTopic.length())
+    {
+        /* The broker keeps the messages while the connection is lost. */
+        subscriptionId = mqttClient.subscribe(mqttTopic, MqttSession::QOS_1, [this](const char* topic, const uint8_t* payload, size_t size) {
+            UTIL_NOT_USED(topic);
+            showPayload(payload, size);
+        });
+    }
+
+    lock();
+    m_subscriptionId = subscriptionId;
+    unlock();
+
+    return;
+}
+
+void MqttIconTextPlugin::showPayload(const uint8_t* payload, size_t size)
+{
+    String  value;
+    String  text;
+    size_t  index   = 0U;
+
+    /* Only printable characters are shown. */
+    for(index = 0U; (index < size) && (MAX_PAYLOAD_SIZE > value.length()); ++index)
+    {
+        char character = static_cast<char>(payload[index]);
+
+        if ((' ' <= character) &&
+            ('~' >= character))
+        {
+            value += character;
+        }
+    }
+
+    lock();
+
+    text = m_format;
+    text.replace("%s", value);
+    m_textWidget.setFormatStr(text);
+
+    unlock();
+
+    return;
+}
+
+bool MqttIconTextPlugin::saveConfiguration() const
+{
+    bool                status                  = true;
+    JsonFile            jsonFile(FILESYSTEM);
+    const size_t        JSON_DOC_SIZE           = 512U;
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    String              configurationFilename   = getFullPathToConfiguration();
+
+    jsonDoc["topic"]    = m_mqttTopic;
+    jsonDoc["format"]   = m_format;
+
+    if (false == jsonFile.save(configurationFilename, jsonDoc))
+    {
+        LOG_WARNING("Failed to save file %s.", configurationFilename.c_str());
+        status = false;
+    }
+    else
+    {
+        LOG_INFO("File %s saved.", configurationFilename.c_str());
+    }
+
+    return status;
+}
+
+bool MqttIconTextPlugin::loadConfiguration()
+{
+    bool                status                  = true;
+    JsonFile            jsonFile(FILESYSTEM);
+    const size_t        JSON_DOC_SIZE           = 512U;
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    String              configurationFilename   = getFullPathToConfiguration();
+
+    if (false == jsonFile.load(configurationFilename, jsonDoc))
+    {
+        LOG_WARNING("Failed to load file %s.", configurationFilename.c_str());
+        status = false;
+    }
+    else if (false == jsonDoc["topic"].is<String>())
+    {
+        LOG_WARNING("topic not found or invalid type.");
+        status = false;
+    }
+    else if (false == jsonDoc["format"].is<String>())
+    {
+        LOG_WARNING("format not found or invalid type.");
+        status = false;
+    }
+    else
+    {
+        m_mqttTopic = jsonDoc["topic"].as<String>();
+        m_format    = jsonDoc["format"].as<String>();
+    }
+
+    return status;
+}
+
+void MqttIconTextPlugin::lock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void MqttIconTextPlugin::unlock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
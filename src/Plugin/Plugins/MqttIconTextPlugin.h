@@ -0,0 +1,359 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT icon and text plugin
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup plugin
+ *
+ * @{
+ */
+
+#ifndef __MQTTICONTEXTPLUGIN_H__
+#define __MQTTICONTEXTPLUGIN_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include "Plugin.hpp"
+#include "MqttClient.h"
+
+#include <FS.h>
+#include <Canvas.h>
+#include <BitmapWidget.h>
+#include <TextWidget.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Shows an icon (bitmap) on the left side in 8 x 8 and the payload of a MQTT
+ * topic as text on the right side. The text is formatted by a format string,
+ * which contains "%s" as placeholder for the payload.
+ * If the text is too long for the display width, it automatically scrolls.
+ */
+class MqttIconTextPlugin : public Plugin
+{
+public:
+
+    /**
+     * Constructs the plugin.
+     *
+     * @param[in] name  Plugin name
+     * @param[in] uid   Unique id
+     */
+    MqttIconTextPlugin(const String& name, uint16_t uid) :
+        Plugin(name, uid),
+        m_textCanvas(nullptr),
+        m_iconCanvas(nullptr),
+        m_bitmapWidget(),
+        m_iconFullPath(),
+        m_textWidget("-"),
+        m_mqttTopic(),
+        m_format(DEFAULT_FORMAT),
+        m_subscriptionId(MqttClient::INVALID_ID),
+        m_xMutex(nullptr)
+    {
+        m_xMutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    /**
+     * Destroys the plugin.
+     */
+    ~MqttIconTextPlugin()
+    {
+        /* Avoid getting a message after the object is destroyed. */
+        MqttClient::getInstance().unsubscribe(m_subscriptionId);
+
+        if (nullptr != m_iconCanvas)
+        {
+            delete m_iconCanvas;
+            m_iconCanvas = nullptr;
+        }
+
+        if (nullptr != m_textCanvas)
+        {
+            delete m_textCanvas;
+            m_textCanvas = nullptr;
+        }
+
+        if (nullptr != m_xMutex)
+        {
+            vSemaphoreDelete(m_xMutex);
+            m_xMutex = nullptr;
+        }
+    }
+
+    /**
+     * Plugin creation method, used to register on the plugin manager.
+     *
+     * @param[in] name  Plugin name
+     * @param[in] uid   Unique id
+     *
+     * @return If successful, it will return the pointer to the plugin instance, otherwise nullptr.
+     */
+    static IPluginMaintenance* create(const String& name, uint16_t uid)
+    {
+        return new MqttIconTextPlugin(name, uid);
+    }
+
+    /**
+     * Get plugin topics, which can be get/set via different communication
+     * interfaces like REST, websocket, MQTT, etc.
+     *
+     * Example:
+     * {
+     *     "topics": [
+     *         "/text"
+     *     ]
+     * }
+     *
+     * @param[out] topics   Topis in JSON format
+     */
+    void getTopics(JsonArray& topics) const final;
+
+    /**
+     * Get a topic data.
+     * Note, currently only JSON format is supported.
+     *
+     * @param[in]   topic   The topic which data shall be retrieved.
+     * @param[out]  value   The topic value in JSON format.
+     *
+     * @return If successful it will return true otherwise false.
+     */
+    bool getTopic(const String& topic, JsonObject& value) const final;
+
+    /**
+     * Set a topic data.
+     * Note, currently only JSON format is supported.
+     *
+     * @param[in]   topic   The topic which data shall be retrieved.
+     * @param[in]   value   The topic value in JSON format.
+     *
+     * @return If successful it will return true otherwise false.
+     */
+    bool setTopic(const String& topic, const JsonObject& value) final;
+
+    /**
+     * Is a upload request accepted or rejected?
+     *
+     * @param[in] topic         The topic which the upload belongs to.
+     * @param[in] srcFilename   Name of the file, which will be uploaded if accepted.
+     * @param[in] dstFilename   The destination filename, after storing the uploaded file.
+     *
+     * @return If accepted it will return true otherwise false.
+     */
+    bool isUploadAccepted(const String& topic, const String& srcFilename, String& dstFilename) final;
+
+    /**
+     * Start the plugin.
+     * Overwrite it if your plugin needs to know that it was installed.
+     */
+    void start() final;
+
+    /**
+     * Stop the plugin.
+     * Overwrite it if your plugin needs to know that it will be uninstalled.
+     */
+    void stop() final;
+
+    /**
+     * This method will be called in case the plugin is set active, which means
+     * it will be shown on the display in the next step.
+     *
+     * @param[in] gfx   Display graphics interface
+     */
+    void active(IGfx& gfx) final;
+
+    /**
+     * This method will be called in case the plugin is set inactive, which means
+     * it won't be shown on the display anymore.
+     */
+    void inactive() final;
+
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and rebuilt
+     * in active(). An icon loaded from the filesystem is released too and
+     * reloaded in resume().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
+    /**
+     * This method will be called before the hibernated plugin is prepared or
+     * set active. It reloads the icon from the filesystem.
+     */
+    void resume() final;
+
+    /**
+     * Update the display.
+     * The scheduler will call this method periodically.
+     *
+     * @param[in] gfx   Display graphics interface
+     */
+    void update(IGfx& gfx) final;
+
+    /**
+     * Get the subscribed MQTT topic.
+     *
+     * @return MQTT topic filter
+     */
+    String getMqttTopic() const;
+
+    /**
+     * Set the MQTT topic, which to subscribe. It may contain wildcards.
+     *
+     * @param[in] mqttTopic MQTT topic filter
+     */
+    void setMqttTopic(const String& mqttTopic);
+
+    /**
+     * Get the format string.
+     *
+     * @return Format string
+     */
+    String getFormat() const;
+
+    /**
+     * Set the format string. It may contain text format tags and "%s" as
+     * placeholder for the payload.
+     *
+     * @param[in] format    Format string
+     */
+    void setFormat(const String& format);
+
+private:
+
+    /**
+     * Plugin topic, used for the MQTT configuration.
+     */
+    static const char*      TOPIC_MQTT;
+
+    /**
+     * Plugin topic, used for the icon upload.
+     */
+    static const char*      TOPIC_ICON;
+
+    /**
+     * Default format string.
+     */
+    static const char*      DEFAULT_FORMAT;
+
+    /**
+     * Icon width in pixels.
+     */
+    static const uint16_t   ICON_WIDTH          = 8U;
+
+    /**
+     * Icon height in pixels.
+     */
+    static const uint16_t   ICON_HEIGHT         = 8U;
+
+    /**
+     * Max. number of payload characters, which are shown.
+     */
+    static const size_t     MAX_PAYLOAD_SIZE    = 64U;
+
+    Canvas*             m_textCanvas;       /**< Canvas used for the text widget. */
+    Canvas*             m_iconCanvas;       /**< Canvas used for the bitmap widget. */
+    BitmapWidget        m_bitmapWidget;     /**< Bitmap widget, used to show the icon. */
+    String              m_iconFullPath;     /**< Full path of the icon file, used to reload it after hibernation. Empty if the icon is not from the filesystem. */
+    TextWidget          m_textWidget;       /**< Text widget, used for showing the text. */
+    String              m_mqttTopic;        /**< Subscribed MQTT topic filter */
+    String              m_format;           /**< Format string of the shown text */
+    uint32_t            m_subscriptionId;   /**< MQTT subscription id */
+    SemaphoreHandle_t   m_xMutex;           /**< Mutex to protect against concurrent access. */
+
+    /**
+     * Get image filename with path.
+     *
+     * @return Image filename with path.
+     */
+    String getFileName(void);
+
+    /**
+     * Is an icon available?
+     *
+     * @return If an icon is available, it will return true otherwise false.
+     */
+    bool hasIcon() const;
+
+    /**
+     * Subscribe the configured MQTT topic.
+     * Don't call it with the plugin locked, because the MQTT client calls
+     * the message callback with its own lock held.
+     */
+    void updateSubscription();
+
+    /**
+     * Show a received payload.
+     *
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     */
+    void showPayload(const uint8_t* payload, size_t size);
+
+    /**
+     * Saves current configuration to JSON file.
+     */
+    bool saveConfiguration() const final;
+
+    /**
+     * Load configuration from JSON file.
+     */
+    bool loadConfiguration();
+
+    /**
+     * Protect against concurrent access.
+     */
+    void lock(void) const final;
+
+    /**
+     * Unprotect against concurrent access.
+     */
+    void unlock(void) const final;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MQTTICONTEXTPLUGIN_H__ */
+
+/** @} */
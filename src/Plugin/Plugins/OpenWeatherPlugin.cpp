@@ -35,6 +35,9 @@
 #include "OpenWeatherPlugin.h"
 #include "RestApi.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
+
+#include <Board.h>
 
 #include <Logging.h>
 #include <ArduinoJson.h>
@@ -243,6 +246,34 @@ void OpenWeatherPlugin::process()
     return;
 }
 
+void OpenWeatherPlugin::prepare()
+{
+    lock();
+
+    /* The weather data is refreshed ahead of the slot change, if there is no
+     * valid data or it doesn't match the changed configuration. This way the
+     * response may be received, before the plugin is shown.
+     */
+    if ((true == m_isRefreshNeeded) ||
+        (true == m_configurationHasChanged))
+    {
+        if (false == startHttpRequest())
+        {
+            m_requestTimer.start(UPDATE_PERIOD_SHORT);
+        }
+        else
+        {
+            m_requestTimer.start(UPDATE_PERIOD);
+        }
+    }
+
+    createCanvases(Board::LedMatrix::width, Board::LedMatrix::height);
+
+    unlock();
+
+    return;
+}
+
 void OpenWeatherPlugin::setSlot(const ISlotPlugin* slotInterf)
 {
     m_slotInterf = slotInterf;
@@ -252,44 +283,24 @@ void OpenWeatherPlugin::setSlot(const ISlotPlugin* slotInterf)
 void OpenWeatherPlugin::active(IGfx& gfx)
 {
     lock();
-    if(true == m_configurationHasChanged)
+    /* A configuration, which is not saved yet, is newer than the stored one. */
+    if ((true == m_configurationHasChanged) &&
+        (false == isSaveConfigurationPending()))
     {
         (void)loadConfiguration();
     }
 
     gfx.fillScreen(ColorDef::BLACK);
 
-    if (nullptr == m_iconCanvas)
-    {
-        m_iconCanvas = new Canvas(ICON_WIDTH, ICON_HEIGHT, 0, 0);
-
-        if (nullptr != m_iconCanvas)
-        {
-            (void)m_iconCanvas->addWidget(m_bitmapWidget);
-
-            /* Load icon from filesystem. */
-            (void)m_bitmapWidget.load(FILESYSTEM, IMAGE_PATH_STD_ICON);
+    /* Usually already done by prepare(). */
+    createCanvases(gfx.getWidth(), gfx.getHeight());
 
-            m_iconCanvas->update(gfx);
-        }
-    }
-    else
+    if (nullptr != m_iconCanvas)
     {
         m_iconCanvas->update(gfx);
     }
 
-    if (nullptr == m_textCanvas)
-    {
-        m_textCanvas = new Canvas(gfx.getWidth() - ICON_WIDTH, gfx.getHeight(), ICON_WIDTH, 0);
-
-        if (nullptr != m_textCanvas)
-        {
-            (void)m_textCanvas->addWidget(m_textWidget);
-
-            m_textCanvas->update(gfx);
-        }
-    }
-    else
+    if (nullptr != m_textCanvas)
     {
         m_textCanvas->update(gfx);
     }
@@ -356,7 +367,7 @@ void OpenWeatherPlugin::setApiKey(const String& apiKey)
         m_apiKey                    = apiKey;
         m_configurationHasChanged   = true;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -384,7 +395,7 @@ void OpenWeatherPlugin::setLatitude(const String& latitude)
         m_latitude                  = latitude;
         m_configurationHasChanged   = true;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -412,7 +423,7 @@ void OpenWeatherPlugin::setLongitude(const String& longitude)
         m_longitude                 = longitude;
         m_configurationHasChanged   = true;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -440,7 +451,7 @@ void OpenWeatherPlugin::setAdditionalInformation(const OtherWeatherInformation&
         m_additionalInformation     = additionalInformation;
         m_configurationHasChanged   = true;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -468,7 +479,7 @@ void OpenWeatherPlugin::setUnits(const String& units)
         m_units                     = units;
         m_configurationHasChanged   = true;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -642,30 +653,31 @@ bool OpenWeatherPlugin::startHttpRequest()
 
 void OpenWeatherPlugin::initHttpClient()
 {
-    m_client.regOnResponse([this](const HttpResponse& rsp){
-        size_t                          payloadSize             = 0U;
-        const char*                     payload                 = reinterpret_cast<const char*>(rsp.getPayload(payloadSize));
-        const size_t                    JSON_DOC_SIZE           = 256;
-        DynamicJsonDocument             jsonDoc(JSON_DOC_SIZE);
-        const size_t                    FILTER_SIZE             = 128U;
-        StaticJsonDocument<FILTER_SIZE> filter;
-        JsonObject                      filterCurrent           = filter.createNestedObject("current");
-        DeserializationError            error;
-
-        /* See https://openweathermap.org/api/one-call-api for an example of API response. */
-        filterCurrent["temp"]                  = true;
-        filterCurrent["uvi"]                   = true;
-        filterCurrent["humidity"]              = true;
-        filterCurrent["wind_speed"]            = true;
-        filterCurrent["weather"][0]["icon"]    = true;
-        
-        if (true == filter.overflowed())
-        {
-            LOG_ERROR("Less memory for filter available.");
-        }
+    const size_t                    JSON_DOC_SIZE           = 256;
+    const size_t                    FILTER_SIZE             = 128U;
+    StaticJsonDocument<FILTER_SIZE> filter;
+    JsonObject                      filterCurrent           = filter.createNestedObject("current");
+
+    /* See https://openweathermap.org/api/one-call-api for an example of API response. */
+    filterCurrent["temp"]                  = true;
+    filterCurrent["uvi"]                   = true;
+    filterCurrent["humidity"]              = true;
+    filterCurrent["wind_speed"]            = true;
+    filterCurrent["weather"][0]["icon"]    = true;
 
-        error = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(filter));
+    if (true == filter.overflowed())
+    {
+        LOG_ERROR("Less memory for filter available.");
+    }
+
+    m_client.setPollPeriod(UPDATE_PERIOD);
 
+    /* The response is small, because only the current weather is requested.
+     * Its compression would cost more heap for the decompression window
+     * than it saves. It is parsed while it is received, only the filtered
+     * values are kept.
+     */
+    m_client.regOnJsonResponse(filter, JSON_DOC_SIZE, [this](const DeserializationError& error, JsonDocument& jsonDoc){
         if (DeserializationError::Ok != error.code())
         {
             LOG_WARNING("JSON parse error: %s", error.c_str());
@@ -747,6 +759,7 @@ void OpenWeatherPlugin::initHttpClient()
 				
 				lock();
                 m_currentWeatherIcon = weatherConditionIcon;
+                m_isRefreshNeeded = false;
 				unlock();
                 updateDisplay(false);
             }
@@ -774,16 +787,45 @@ void OpenWeatherPlugin::initHttpClient()
 
         lock();
         m_isConnectionError = true;
+        m_isRefreshNeeded = true;
         unlock();
     });
 }
 
+void OpenWeatherPlugin::createCanvases(int16_t width, int16_t height)
+{
+    if (nullptr == m_iconCanvas)
+    {
+        m_iconCanvas = new Canvas(ICON_WIDTH, ICON_HEIGHT, 0, 0);
+
+        if (nullptr != m_iconCanvas)
+        {
+            (void)m_iconCanvas->addWidget(m_bitmapWidget);
+
+            /* Load icon from filesystem. */
+            (void)m_bitmapWidget.load(FILESYSTEM, IMAGE_PATH_STD_ICON);
+        }
+    }
+
+    if (nullptr == m_textCanvas)
+    {
+        m_textCanvas = new Canvas(width - ICON_WIDTH, height, ICON_WIDTH, 0);
+
+        if (nullptr != m_textCanvas)
+        {
+            (void)m_textCanvas->addWidget(m_textWidget);
+        }
+    }
+
+    return;
+}
+
 bool OpenWeatherPlugin::saveConfiguration() const
 {
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     jsonDoc["apiKey"]   = m_apiKey;
@@ -810,7 +852,7 @@ bool OpenWeatherPlugin::loadConfiguration()
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
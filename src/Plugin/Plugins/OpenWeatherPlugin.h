@@ -97,7 +97,8 @@ public:
         m_slotInterf(nullptr),
         m_configurationHasChanged(false),
         m_durationCounter(0u),
-        m_isUpdateAvailable(false)
+        m_isUpdateAvailable(false),
+        m_isRefreshNeeded(true)
     {
         /* Move the text widget one line lower for better look. */
         m_textWidget.move(0, 1);
@@ -213,7 +214,14 @@ public:
      * active slot.
      */
     void process(void) final;
-    
+
+    /**
+     * This method will be called shortly before the plugin is set active,
+     * while the current slot is still shown. The weather data is refreshed,
+     * if necessary and the canvases are allocated ahead.
+     */
+    void prepare() final;
+
     /**
      * Set the slot interface, which the plugin can used to request information
      * from the slot, it is plugged in.
@@ -402,6 +410,15 @@ private:
     bool                        m_configurationHasChanged;  /**< Flag to indicate whether the configuration has changed. */
     uint8_t                     m_durationCounter;          /**< Variable to count the Plugin duration in DURATION_TICK_PERIOD ticks. */
     bool                        m_isUpdateAvailable;        /**< Flag to indicate an updated date value. */
+    bool                        m_isRefreshNeeded;          /**< Is a refresh of the weather data needed, because no valid data is available? */
+
+    /**
+     * Create the canvases with their widgets, if not already done.
+     *
+     * @param[in] width     Display width in pixel
+     * @param[in] height    Display height in pixel
+     */
+    void createCanvases(int16_t width, int16_t height);
 
     /**
      * Updates the text and icon, which to be displayed.
@@ -430,7 +447,7 @@ private:
     /**
      * Saves current configuration to JSON file.
      */
-    bool saveConfiguration() const;
+    bool saveConfiguration() const final;
 
     /**
      * Load configuration from JSON file.
@@ -440,12 +457,12 @@ private:
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
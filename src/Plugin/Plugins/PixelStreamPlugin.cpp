@@ -0,0 +1,399 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pixel stream plugin
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "PixelStreamPlugin.h"
+#include "FileSystem.h"
+#include "JsonDocPool.h"
+
+#include <Board.h>
+#include <ArduinoJson.h>
+#include <Logging.h>
+#include <JsonFile.h>
+#include <Util.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/* Initialize plugin topic for the stream configuration. */
+const char* PixelStreamPlugin::TOPIC_STREAM     = "/stream";
+
+/* Initialize plugin topic for the receiver statistics. */
+const char* PixelStreamPlugin::TOPIC_STATISTICS = "/statistics";
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void PixelStreamPlugin::getTopics(JsonArray& topics) const
+{
+    (void)topics.add(TOPIC_STREAM);
+    (void)topics.add(TOPIC_STATISTICS);
+}
+
+bool PixelStreamPlugin::getTopic(const String& topic, JsonObject& value) const
+{
+    bool isSuccessful = false;
+
+    if (0U != topic.equals(TOPIC_STREAM))
+    {
+        value["universe"]   = getUniverse();
+        value["layout"]     = static_cast<uint8_t>(getLayout());
+
+        isSuccessful = true;
+    }
+    else if (0U != topic.equals(TOPIC_STATISTICS))
+    {
+        PixelStreamReceiver::Statistics statistics;
+
+        lock();
+        m_receiver.getStatistics(statistics);
+        unlock();
+
+        value["packets"]            = statistics.packets;
+        value["invalidPackets"]     = statistics.invalidPackets;
+        value["lostPackets"]        = statistics.lostPackets;
+        value["outOfOrderPackets"]  = statistics.outOfOrderPackets;
+        value["frames"]             = statistics.frames;
+        value["incompleteFrames"]   = statistics.incompleteFrames;
+        value["droppedFrames"]      = statistics.droppedFrames;
+        value["avgLatency"]         = statistics.avgLatency;
+        value["maxLatency"]         = statistics.maxLatency;
+
+        isSuccessful = true;
+    }
+
+    return isSuccessful;
+}
+
+bool PixelStreamPlugin::setTopic(const String& topic, const JsonObject& value)
+{
+    bool isSuccessful = false;
+
+    if (0U != topic.equals(TOPIC_STREAM))
+    {
+        /* The parameters are received as strings. */
+        if (false == value["universe"].isNull())
+        {
+            String      universeStr = value["universe"].as<String>();
+            uint16_t    universe    = 0U;
+
+            if (true == Util::strToUInt16(universeStr, universe))
+            {
+                setUniverse(universe);
+                isSuccessful = true;
+            }
+        }
+
+        if (false == value["layout"].isNull())
+        {
+            String  layoutStr   = value["layout"].as<String>();
+            uint8_t layout      = 0U;
+
+            if ((true == Util::strToUInt8(layoutStr, layout)) &&
+                (PixelStreamReceiver::LAYOUT_MAX > layout))
+            {
+                setLayout(static_cast<PixelStreamReceiver::Layout>(layout));
+                isSuccessful = true;
+            }
+        }
+    }
+
+    return isSuccessful;
+}
+
+void PixelStreamPlugin::start()
+{
+    lock();
+
+    /* Try to load configuration. If there is no configuration available, a default configuration
+     * will be created.
+     */
+    if (false == loadConfiguration())
+    {
+        if (false == saveConfiguration())
+        {
+            LOG_WARNING("Failed to create initial configuration file %s.", getFullPathToConfiguration().c_str());
+        }
+    }
+
+    m_isStarted = true;
+    beginReceiver();
+
+    unlock();
+
+    return;
+}
+
+void PixelStreamPlugin::stop()
+{
+    String configurationFilename = getFullPathToConfiguration();
+
+    lock();
+
+    m_isStarted = false;
+    m_receiver.end();
+
+    if (false != FILESYSTEM.remove(configurationFilename))
+    {
+        LOG_INFO("File %s removed", configurationFilename.c_str());
+    }
+
+    unlock();
+
+    return;
+}
+
+void PixelStreamPlugin::process()
+{
+    lock();
+    m_receiver.process();
+    unlock();
+
+    return;
+}
+
+void PixelStreamPlugin::active(IGfx& gfx)
+{
+    lock();
+
+    /* Until the first frame is complete, the display stays dark. */
+    if (false == m_receiver.draw(gfx))
+    {
+        gfx.fillScreen(ColorDef::BLACK);
+    }
+
+    unlock();
+
+    return;
+}
+
+void PixelStreamPlugin::inactive()
+{
+    /* Nothing to do. */
+    return;
+}
+
+void PixelStreamPlugin::update(IGfx& gfx)
+{
+    lock();
+
+    if (false == m_receiver.draw(gfx))
+    {
+        gfx.fillScreen(ColorDef::BLACK);
+    }
+
+    unlock();
+
+    return;
+}
+
+uint16_t PixelStreamPlugin::getUniverse() const
+{
+    uint16_t universe;
+
+    lock();
+    universe = m_universe;
+    unlock();
+
+    return universe;
+}
+
+void PixelStreamPlugin::setUniverse(uint16_t universe)
+{
+    lock();
+
+    if (universe != m_universe)
+    {
+        m_universe = universe;
+
+        beginReceiver();
+        requestSaveConfiguration();
+    }
+
+    unlock();
+
+    return;
+}
+
+PixelStreamReceiver::Layout PixelStreamPlugin::getLayout() const
+{
+    PixelStreamReceiver::Layout layout;
+
+    lock();
+    layout = m_layout;
+    unlock();
+
+    return layout;
+}
+
+void PixelStreamPlugin::setLayout(PixelStreamReceiver::Layout layout)
+{
+    lock();
+
+    if (layout != m_layout)
+    {
+        m_layout = layout;
+
+        beginReceiver();
+        requestSaveConfiguration();
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void PixelStreamPlugin::beginReceiver()
+{
+    /* Only a started plugin receives, otherwise the configuration is just kept. */
+    if (true == m_isStarted)
+    {
+        if (false == m_receiver.begin(Board::LedMatrix::width, Board::LedMatrix::height, m_universe, m_layout))
+        {
+            LOG_WARNING("Failed to start pixel stream receiver.");
+        }
+    }
+
+    return;
+}
+
+bool PixelStreamPlugin::saveConfiguration() const
+{
+    bool                status                  = true;
+    JsonFile            jsonFile(FILESYSTEM);
+    const size_t        JSON_DOC_SIZE           = 256U;
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    String              configurationFilename   = getFullPathToConfiguration();
+
+    jsonDoc["universe"] = m_universe;
+    jsonDoc["layout"]   = static_cast<uint8_t>(m_layout);
+
+    if (false == jsonFile.save(configurationFilename, jsonDoc))
+    {
+        LOG_WARNING("Failed to save file %s.", configurationFilename.c_str());
+        status = false;
+    }
+    else
+    {
+        LOG_INFO("File %s saved.", configurationFilename.c_str());
+    }
+
+    return status;
+}
+
+bool PixelStreamPlugin::loadConfiguration()
+{
+    bool                status                  = true;
+    JsonFile            jsonFile(FILESYSTEM);
+    const size_t        JSON_DOC_SIZE           = 256U;
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+    String              configurationFilename   = getFullPathToConfiguration();
+
+    if (false == jsonFile.load(configurationFilename, jsonDoc))
+    {
+        LOG_WARNING("Failed to load file %s.", configurationFilename.c_str());
+        status = false;
+    }
+    else if (false == jsonDoc["universe"].is<uint16_t>())
+    {
+        LOG_WARNING("universe not found or invalid type.");
+        status = false;
+    }
+    else if ((false == jsonDoc["layout"].is<uint8_t>()) ||
+             (PixelStreamReceiver::LAYOUT_MAX <= jsonDoc["layout"].as<uint8_t>()))
+    {
+        LOG_WARNING("layout not found or invalid.");
+        status = false;
+    }
+    else
+    {
+        m_universe  = jsonDoc["universe"].as<uint16_t>();
+        m_layout    = static_cast<PixelStreamReceiver::Layout>(jsonDoc["layout"].as<uint8_t>());
+    }
+
+    return status;
+}
+
+void PixelStreamPlugin::lock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void PixelStreamPlugin::unlock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
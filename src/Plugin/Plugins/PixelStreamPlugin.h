@@ -0,0 +1,272 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pixel stream plugin
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup plugin
+ *
+ * @{
+ */
+
+#ifndef __PIXELSTREAMPLUGIN_H__
+#define __PIXELSTREAMPLUGIN_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include "Plugin.hpp"
+#include "PixelStreamReceiver.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Shows the pixels, which a light show controller streams via DDP, E1.31
+ * (sACN) or Art-Net. The packets are received and processed, even if the
+ * plugin is not active, therefore it shows always the latest frame.
+ */
+class PixelStreamPlugin : public Plugin
+{
+public:
+
+    /**
+     * Constructs the plugin.
+     *
+     * @param[in] name  Plugin name
+     * @param[in] uid   Unique id
+     */
+    PixelStreamPlugin(const String& name, uint16_t uid) :
+        Plugin(name, uid),
+        m_receiver(),
+        m_universe(DEFAULT_UNIVERSE),
+        m_layout(PixelStreamReceiver::LAYOUT_TOPOLOGY),
+        m_isStarted(false),
+        m_xMutex(nullptr)
+    {
+        m_xMutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    /**
+     * Destroys the plugin.
+     */
+    ~PixelStreamPlugin()
+    {
+        m_receiver.end();
+
+        if (nullptr != m_xMutex)
+        {
+            vSemaphoreDelete(m_xMutex);
+            m_xMutex = nullptr;
+        }
+    }
+
+    /**
+     * Plugin creation method, used to register on the plugin manager.
+     *
+     * @param[in] name  Plugin name
+     * @param[in] uid   Unique id
+     *
+     * @return If successful, it will return the pointer to the plugin instance, otherwise nullptr.
+     */
+    static IPluginMaintenance* create(const String& name, uint16_t uid)
+    {
+        return new PixelStreamPlugin(name, uid);
+    }
+
+    /**
+     * Get plugin topics, which can be get/set via different communication
+     * interfaces like REST, websocket, MQTT, etc.
+     *
+     * Example:
+     * {
+     *     "topics": [
+     *         "/text"
+     *     ]
+     * }
+     *
+     * @param[out] topics   Topis in JSON format
+     */
+    void getTopics(JsonArray& topics) const final;
+
+    /**
+     * Get a topic data.
+     * Note, currently only JSON format is supported.
+     *
+     * @param[in]   topic   The topic which data shall be retrieved.
+     * @param[out]  value   The topic value in JSON format.
+     *
+     * @return If successful it will return true otherwise false.
+     */
+    bool getTopic(const String& topic, JsonObject& value) const final;
+
+    /**
+     * Set a topic data.
+     * Note, currently only JSON format is supported.
+     *
+     * @param[in]   topic   The topic which data shall be retrieved.
+     * @param[in]   value   The topic value in JSON format.
+     *
+     * @return If successful it will return true otherwise false.
+     */
+    bool setTopic(const String& topic, const JsonObject& value) final;
+
+    /**
+     * Start the plugin.
+     * Overwrite it if your plugin needs to know that it was installed.
+     */
+    void start() final;
+
+    /**
+     * Stop the plugin.
+     * Overwrite it if your plugin needs to know that it will be uninstalled.
+     */
+    void stop() final;
+
+    /**
+     * Process the plugin.
+     * All received packets are processed, to show the latest frame in the
+     * next update.
+     */
+    void process(void) final;
+
+    /**
+     * This method will be called in case the plugin is set active, which means
+     * it will be shown on the display in the next step.
+     *
+     * @param[in] gfx   Display graphics interface
+     */
+    void active(IGfx& gfx) final;
+
+    /**
+     * This method will be called in case the plugin is set inactive, which means
+     * it won't be shown on the display anymore.
+     */
+    void inactive() final;
+
+    /**
+     * Update the display.
+     * The scheduler will call this method periodically.
+     *
+     * @param[in] gfx   Display graphics interface
+     */
+    void update(IGfx& gfx) final;
+
+    /**
+     * Get the first universe, which is used by E1.31 and Art-Net.
+     *
+     * @return Universe
+     */
+    uint16_t getUniverse() const;
+
+    /**
+     * Set the first universe, which is used by E1.31 and Art-Net.
+     *
+     * @param[in] universe  Universe
+     */
+    void setUniverse(uint16_t universe);
+
+    /**
+     * Get the pixel mapping to the display.
+     *
+     * @return Layout
+     */
+    PixelStreamReceiver::Layout getLayout() const;
+
+    /**
+     * Set the pixel mapping to the display.
+     *
+     * @param[in] layout    Layout
+     */
+    void setLayout(PixelStreamReceiver::Layout layout);
+
+private:
+
+    /**
+     * Plugin topic, used for the stream configuration.
+     */
+    static const char*      TOPIC_STREAM;
+
+    /**
+     * Plugin topic, used to get the receiver statistics.
+     */
+    static const char*      TOPIC_STATISTICS;
+
+    /**
+     * Default first universe.
+     */
+    static const uint16_t   DEFAULT_UNIVERSE    = 1U;
+
+    PixelStreamReceiver         m_receiver;     /**< Pixel stream receiver */
+    uint16_t                    m_universe;     /**< First universe (E1.31 and Art-Net) */
+    PixelStreamReceiver::Layout m_layout;       /**< Pixel mapping to the display */
+    bool                        m_isStarted;    /**< Is the plugin started? */
+    SemaphoreHandle_t           m_xMutex;       /**< Mutex to protect against concurrent access. */
+
+    /**
+     * Start receiving with the current configuration.
+     */
+    void beginReceiver();
+
+    /**
+     * Saves current configuration to JSON file.
+     */
+    bool saveConfiguration() const final;
+
+    /**
+     * Load configuration from JSON file.
+     */
+    bool loadConfiguration();
+
+    /**
+     * Protect against concurrent access.
+     */
+    void lock(void) const final;
+
+    /**
+     * Unprotect against concurrent access.
+     */
+    void unlock(void) const final;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __PIXELSTREAMPLUGIN_H__ */
+
+/** @} */
@@ -39,10 +39,12 @@
 #include "RestApi.h"
 #include "time.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
 
 #include <ArduinoJson.h>
 #include <Logging.h>
 #include <JsonFile.h>
+#include <Util.h>
 
 /******************************************************************************
  * Compiler Switches
@@ -70,6 +72,9 @@ const char* ShellyPlugSPlugin::IMAGE_PATH   = "/images/plug.bmp";
 /* Initialize plugin topic. */
 const char* ShellyPlugSPlugin::TOPIC        = "/ipAddress";
 
+/* Initialize plugin topic for the MQTT topic. */
+const char* ShellyPlugSPlugin::TOPIC_MQTT   = "/mqttTopic";
+
 /******************************************************************************
  * Public Methods
  *****************************************************************************/
@@ -77,6 +82,7 @@ const char* ShellyPlugSPlugin::TOPIC        = "/ipAddress";
 void ShellyPlugSPlugin::getTopics(JsonArray& topics) const
 {
     (void)topics.add(TOPIC);
+    (void)topics.add(TOPIC_MQTT);
 }
 
 bool ShellyPlugSPlugin::getTopic(const String& topic, JsonObject& value) const
@@ -91,6 +97,12 @@ bool ShellyPlugSPlugin::getTopic(const String& topic, JsonObject& value) const
 
         isSuccessful = true;
     }
+    else if (0U != topic.equals(TOPIC_MQTT))
+    {
+        value["mqttTopic"] = getMqttTopic();
+
+        isSuccessful = true;
+    }
 
     return isSuccessful;
 }
@@ -114,6 +126,14 @@ bool ShellyPlugSPlugin::setTopic(const String& topic, const JsonObject& value)
             setIPAddress(ipAddress);
         }
     }
+    else if (0U != topic.equals(TOPIC_MQTT))
+    {
+        if (false == value["set"].isNull())
+        {
+            setMqttTopic(value["set"].as<String>());
+            isSuccessful = true;
+        }
+    }
 
     return isSuccessful;
 }
@@ -161,6 +181,21 @@ void ShellyPlugSPlugin::inactive()
     return;
 }
 
+bool ShellyPlugSPlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    m_bitmapWidget.clear();
+    m_client.releaseBuffers();
+
+    unlock();
+
+    return true;
+}
+
 void ShellyPlugSPlugin::update(IGfx& gfx)
 {
     lock();
@@ -198,28 +233,26 @@ void ShellyPlugSPlugin::start()
     }
 
     initHttpClient();
-    if (false == startHttpRequest())
-    {
-        m_requestTimer.start(UPDATE_PERIOD_SHORT);
-    }
-    else
-    {
-        m_requestTimer.start(UPDATE_PERIOD);
-    }
 
     unlock();
 
+    updateSubscription();
+
     return;
 }
 
 void ShellyPlugSPlugin::stop()
 {
-    String configurationFilename = getFullPathToConfiguration();
+    String      configurationFilename   = getFullPathToConfiguration();
+    uint32_t    subscriptionId          = MqttClient::INVALID_ID;
 
     lock();
 
     m_requestTimer.stop();
 
+    subscriptionId      = m_subscriptionId;
+    m_subscriptionId    = MqttClient::INVALID_ID;
+
     if (false != FILESYSTEM.remove(configurationFilename))
     {
         LOG_INFO("File %s removed", configurationFilename.c_str());
@@ -227,6 +260,8 @@ void ShellyPlugSPlugin::stop()
 
     unlock();
 
+    MqttClient::getInstance().unsubscribe(subscriptionId);
+
     return;
 }
 
@@ -260,7 +295,7 @@ void ShellyPlugSPlugin::setIPAddress(const String& ipAddress)
     {
         m_ipAddress = ipAddress;
 
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
     unlock();
 
@@ -278,6 +313,41 @@ String ShellyPlugSPlugin::getIPAddress() const
     return ipAddress;
 }
 
+void ShellyPlugSPlugin::setMqttTopic(const String& mqttTopic)
+{
+    bool isChanged = false;
+
+    lock();
+
+    if (mqttTopic != m_mqttTopic)
+    {
+        m_mqttTopic = mqttTopic;
+        isChanged   = true;
+
+        requestSaveConfiguration();
+    }
+
+    unlock();
+
+    if (true == isChanged)
+    {
+        updateSubscription();
+    }
+
+    return;
+}
+
+String ShellyPlugSPlugin::getMqttTopic() const
+{
+    String mqttTopic;
+
+    lock();
+    mqttTopic = m_mqttTopic;
+    unlock();
+
+    return mqttTopic;
+}
+
 /******************************************************************************
  * Protected Methods
  *****************************************************************************/
@@ -311,24 +381,21 @@ bool ShellyPlugSPlugin::startHttpRequest()
 }
 void ShellyPlugSPlugin::initHttpClient()
 {
-    m_client.regOnResponse([this](const HttpResponse& rsp){
-        size_t                          payloadSize             = 0U;
-        const char*                     payload                 = reinterpret_cast<const char*>(rsp.getPayload(payloadSize));
-        const size_t                    JSON_DOC_SIZE           = 512U;
-        DynamicJsonDocument             jsonDoc(JSON_DOC_SIZE);
-        const size_t                    FILTER_SIZE             = 128U;
-        StaticJsonDocument<FILTER_SIZE> filter;
-        DeserializationError            error;
-
-        filter["power"] = true;
-
-        if (true == filter.overflowed())
-        {
-            LOG_ERROR("Less memory for filter available.");
-        }
-        
-        error = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(filter));
+    const size_t                    JSON_DOC_SIZE           = 512U;
+    const size_t                    FILTER_SIZE             = 128U;
+    StaticJsonDocument<FILTER_SIZE> filter;
+
+    filter["power"] = true;
 
+    if (true == filter.overflowed())
+    {
+        LOG_ERROR("Less memory for filter available.");
+    }
+
+    m_client.setPollPeriod(UPDATE_PERIOD);
+
+    /* The response is parsed while it is received, only the filtered values are kept. */
+    m_client.regOnJsonResponse(filter, JSON_DOC_SIZE, [this](const DeserializationError& error, JsonDocument& jsonDoc){
         if (DeserializationError::Ok != error.code())
         {
             LOG_WARNING("JSON parse error: %s", error.c_str());
@@ -339,29 +406,7 @@ void ShellyPlugSPlugin::initHttpClient()
         }
         else
         {
-            float       powerRaw                = jsonDoc["power"].as<float>();
-            String      power;
-            const char* reducePrecision;
-            char        powerReducedPrecison[6] = { 0 };
-
-            if (powerRaw < 99.99f)
-            {
-                reducePrecision = (powerRaw > 9.9f) ? "%.1f" : "%.2f";
-            }
-            else
-            {
-                reducePrecision = "%.0f";
-            }
-            
-            (void)snprintf(powerReducedPrecison, sizeof(powerReducedPrecison), reducePrecision, powerRaw);
-
-            power = "\\calign";
-            power += powerReducedPrecison;
-            power += " W";
-            
-            lock();
-            m_textWidget.setFormatStr(power);
-            unlock();
+            updatePower(jsonDoc["power"].as<float>());
 
             if (true == jsonDoc.overflowed())
             {
@@ -379,15 +424,109 @@ void ShellyPlugSPlugin::initHttpClient()
     });
 }
 
+void ShellyPlugSPlugin::updatePower(float powerRaw)
+{
+    String      power;
+    const char* reducePrecision;
+    char        powerReducedPrecison[6] = { 0 };
+
+    if (powerRaw < 99.99f)
+    {
+        reducePrecision = (powerRaw > 9.9f) ? "%.1f" : "%.2f";
+    }
+    else
+    {
+        reducePrecision = "%.0f";
+    }
+
+    (void)snprintf(powerReducedPrecison, sizeof(powerReducedPrecison), reducePrecision, powerRaw);
+
+    power = "\\calign";
+    power += powerReducedPrecison;
+    power += " W";
+
+    lock();
+    m_textWidget.setFormatStr(power);
+    unlock();
+
+    return;
+}
+
+void ShellyPlugSPlugin::updateSubscription()
+{
+    MqttClient& mqttClient      = MqttClient::getInstance();
+    String      mqttTopic;
+    uint32_t    subscriptionId  = MqttClient::INVALID_ID;
+
+    lock();
+    mqttTopic           = m_mqttTopic;
+    subscriptionId      = m_subscriptionId;
+    m_subscriptionId    = MqttClient::INVALID_ID;
+    unlock();
+
+    mqttClient.unsubscribe(subscriptionId);
+    subscriptionId = MqttClient::INVALID_ID;
+
+    if (0U < mqttTopic.length())
+    {
+        /* The power is published periodically and on change, therefore a lost one is not repeated. */
+        subscriptionId = mqttClient.subscribe(mqttTopic, MqttSession::QOS_0, [this](const char* topic, const uint8_t* payload, size_t size) {
+            char    value[16U];
+            char*   end     = nullptr;
+            size_t  length  = (size < (sizeof(value) - 1U)) ? size : (sizeof(value) - 1U);
+            float   powerRaw;
+
+            UTIL_NOT_USED(topic);
+
+            memcpy(value, payload, length);
+            value[length] = '\0';
+
+            powerRaw = strtof(value, &end);
+
+            if (value == end)
+            {
+                LOG_WARNING("Invalid power received.");
+            }
+            else
+            {
+                updatePower(powerRaw);
+            }
+        });
+    }
+
+    lock();
+
+    m_subscriptionId = subscriptionId;
+
+    /* Without MQTT the power is requested periodically. */
+    if (MqttClient::INVALID_ID != subscriptionId)
+    {
+        m_requestTimer.stop();
+    }
+    else if (false == m_requestTimer.isTimerRunning())
+    {
+        m_requestTimer.start(0U);
+    }
+    else
+    {
+        ;
+    }
+
+    unlock();
+
+    return;
+}
+
 bool ShellyPlugSPlugin::saveConfiguration() const
 {
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
-    jsonDoc["shellyPlugSIP"] = m_ipAddress;
+    jsonDoc["shellyPlugSIP"]    = m_ipAddress;
+    jsonDoc["mqttTopic"]        = m_mqttTopic;
     
     if (false == jsonFile.save(configurationFilename, jsonDoc))
     {
@@ -407,7 +546,7 @@ bool ShellyPlugSPlugin::loadConfiguration()
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
@@ -423,6 +562,12 @@ bool ShellyPlugSPlugin::loadConfiguration()
     else
     {
         m_ipAddress = jsonDoc["shellyPlugSIP"].as<String>();
+
+        /* Not available in older configurations. */
+        if (true == jsonDoc["mqttTopic"].is<String>())
+        {
+            m_mqttTopic = jsonDoc["mqttTopic"].as<String>();
+        }
     }
 
     return status;
@@ -45,6 +45,7 @@
  * Includes
  *****************************************************************************/
 #include "AsyncHttpClient.h"
+#include "MqttClient.h"
 #include "Plugin.hpp"
 
 #include <Canvas.h>
@@ -63,6 +64,10 @@
 
 /**
  * Shows the current AC power being drawn via a Shelly PlugS, in watts.
+ *
+ * If a MQTT topic is configured, the power is received via MQTT as soon as
+ * the Shelly PlugS publishes it. Otherwise it is requested periodically via
+ * HTTP.
  */
 class ShellyPlugSPlugin : public Plugin
 {
@@ -83,7 +88,9 @@ public:
         m_ipAddress("192.168.1.123"), /* Example data */
         m_client(),
         m_xMutex(nullptr),
-        m_requestTimer()
+        m_requestTimer(),
+        m_mqttTopic(),
+        m_subscriptionId(MqttClient::INVALID_ID)
     {
         /* Move the text widget one line lower for better look. */
         m_textWidget.move(0, 1);
@@ -100,6 +107,9 @@ public:
          * object is destroyed.
          */
         m_client.abort();
+
+        /* Same for the MQTT messages. */
+        MqttClient::getInstance().unsubscribe(m_subscriptionId);
         
         if (nullptr != m_iconCanvas)
         {
@@ -184,6 +194,15 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and the icon
+     * is released. They are rebuilt in active().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -225,6 +244,21 @@ public:
      */
     void setIPAddress(const String& ipAddress);
 
+    /**
+     * Get MQTT topic of the power.
+     *
+     * @return MQTT topic
+     */
+    String getMqttTopic() const;
+
+    /**
+     * Set MQTT topic of the power, e.g. shellies/shellyplug-s-XXXXXX/relay/0/power.
+     * If empty, the power is requested via HTTP.
+     *
+     * @param[in] mqttTopic MQTT topic
+     */
+    void setMqttTopic(const String& mqttTopic);
+
 private:
 
     /**
@@ -247,6 +281,11 @@ private:
      */
     static const char*      TOPIC;
 
+    /**
+     * Plugin topic, used for the MQTT topic exchange.
+     */
+    static const char*      TOPIC_MQTT;
+
     /**
      * Period in ms for requesting power consumption from the Shelly PlugS.
      * This is used in case the last request to the server was successful.
@@ -267,6 +306,8 @@ private:
     AsyncHttpClient             m_client;                   /**< Asynchronous HTTP client. */
     SemaphoreHandle_t           m_xMutex;                   /**< Mutex to protect against concurrent access. */
     SimpleTimer                 m_requestTimer;             /**< Timer is used for cyclic ShellyPlugS  http request. */
+    String                      m_mqttTopic;                /**< MQTT topic of the power, empty if not used. */
+    uint32_t                    m_subscriptionId;           /**< MQTT subscription id */
 
     /**
      * Request new data.
@@ -280,10 +321,25 @@ private:
      */
     void initHttpClient(void);
 
+    /**
+     * Show the power.
+     *
+     * @param[in] powerRaw  Power in W
+     */
+    void updatePower(float powerRaw);
+
+    /**
+     * Subscribe the configured MQTT topic. If there is none, the power is
+     * requested periodically via HTTP.
+     * Don't call it with the plugin locked, because the MQTT client calls
+     * the message callback with its own lock held.
+     */
+    void updateSubscription();
+
     /**
      * Saves current configuration to JSON file.
      */
-    bool saveConfiguration() const;
+    bool saveConfiguration() const final;
 
     /**
      * Load configuration from JSON file.
@@ -293,12 +349,12 @@ private:
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
@@ -39,6 +39,9 @@
 #include "RestApi.h"
 #include "time.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
+
+#include <Board.h>
 
 #include <ArduinoJson.h>
 #include <Logging.h>
@@ -146,31 +149,17 @@ void SunrisePlugin::active(IGfx& gfx)
 
     gfx.fillScreen(ColorDef::BLACK);
 
-    if (nullptr == m_iconCanvas)
-    {
-        m_iconCanvas = new Canvas(ICON_WIDTH, ICON_HEIGHT, 0, 0);
-
-        if (nullptr != m_iconCanvas)
-        {
-            (void)m_iconCanvas->addWidget(m_bitmapWidget);
-
-            /* Load  icon from filesystem. */
-            (void)m_bitmapWidget.load(FILESYSTEM, IMAGE_PATH);
+    /* Usually already done by prepare(). */
+    createCanvases(gfx.getWidth(), gfx.getHeight());
 
-            m_iconCanvas->update(gfx);
-        }
+    if (nullptr != m_iconCanvas)
+    {
+        m_iconCanvas->update(gfx);
     }
 
-    if (nullptr == m_textCanvas)
+    if (nullptr != m_textCanvas)
     {
-        m_textCanvas = new Canvas(gfx.getWidth() - ICON_WIDTH, gfx.getHeight(), ICON_WIDTH, 0);
-
-        if (nullptr != m_textCanvas)
-        {
-            (void)m_textCanvas->addWidget(m_textWidget);
-
-            m_textCanvas->update(gfx);
-        }
+        m_textCanvas->update(gfx);
     }
 
     unlock();
@@ -183,6 +172,21 @@ void SunrisePlugin::inactive()
     return;
 }
 
+bool SunrisePlugin::hibernate()
+{
+    lock();
+
+    releaseCanvas(m_iconCanvas);
+    releaseCanvas(m_textCanvas);
+
+    m_bitmapWidget.clear();
+    m_client.releaseBuffers();
+
+    unlock();
+
+    return true;
+}
+
 void SunrisePlugin::update(IGfx& gfx)
 {
     lock();
@@ -274,6 +278,33 @@ void SunrisePlugin::process()
     return;
 }
 
+void SunrisePlugin::prepare()
+{
+    lock();
+
+    /* The times are refreshed ahead of the slot change, if there are no
+     * valid times or they don't match the changed location. This way the
+     * response may be received, before the plugin is shown.
+     */
+    if (true == m_isRefreshNeeded)
+    {
+        if (false == startHttpRequest())
+        {
+            m_requestTimer.start(UPDATE_PERIOD_SHORT);
+        }
+        else
+        {
+            m_requestTimer.start(UPDATE_PERIOD);
+        }
+    }
+
+    createCanvases(Board::LedMatrix::width, Board::LedMatrix::height);
+
+    unlock();
+
+    return;
+}
+
 void SunrisePlugin::getLocation(String& longitude, String&latitude) const
 {
     lock();
@@ -296,10 +327,13 @@ void SunrisePlugin::setLocation(const String& longitude, const String& latitude)
         m_longitude = longitude;
         m_latitude  = latitude;
 
+        /* The times of the old location are outdated. */
+        m_isRefreshNeeded = true;
+
         /* Always stores the configuration, otherwise it will be overwritten during
          * plugin activation.
          */
-        (void)saveConfiguration();
+        requestSaveConfiguration();
     }
 
     unlock();
@@ -337,44 +371,41 @@ bool SunrisePlugin::startHttpRequest()
 
 void SunrisePlugin::initHttpClient()
 {
-    m_client.regOnResponse([this](const HttpResponse& rsp){
-        size_t                          payloadSize             = 0U;
-        const char*                     payload                 = reinterpret_cast<const char*>(rsp.getPayload(payloadSize));
-        const size_t                    JSON_DOC_SIZE           = 512U;
-        DynamicJsonDocument             jsonDoc(JSON_DOC_SIZE);
-        const size_t                    FILTER_SIZE             = 128U;
-        StaticJsonDocument<FILTER_SIZE> filter;
-        DeserializationError            error;
-
-        /* Example:
-        * {
-        *   "results":
-        *   {
-        *     "sunrise":"2015-05-21T05:05:35+00:00",
-        *     "sunset":"2015-05-21T19:22:59+00:00",
-        *     "solar_noon":"2015-05-21T12:14:17+00:00",
-        *     "day_length":51444,
-        *     "civil_twilight_begin":"2015-05-21T04:36:17+00:00",
-        *     "civil_twilight_end":"2015-05-21T19:52:17+00:00",
-        *     "nautical_twilight_begin":"2015-05-21T04:00:13+00:00",
-        *     "nautical_twilight_end":"2015-05-21T20:28:21+00:00",
-        *     "astronomical_twilight_begin":"2015-05-21T03:20:49+00:00",
-        *     "astronomical_twilight_end":"2015-05-21T21:07:45+00:00"
-        *   },
-        *    "status":"OK"
-        * }
-        */
-
-        filter["results"]["sunrise"]    = true;
-        filter["results"]["sunset"]     = true;
-
-        if (true == filter.overflowed())
-        {
-            LOG_ERROR("Less memory for filter available.");
-        }
+    const size_t                    JSON_DOC_SIZE           = 512U;
+    const size_t                    FILTER_SIZE             = 128U;
+    StaticJsonDocument<FILTER_SIZE> filter;
+
+    /* Example:
+    * {
+    *   "results":
+    *   {
+    *     "sunrise":"2015-05-21T05:05:35+00:00",
+    *     "sunset":"2015-05-21T19:22:59+00:00",
+    *     "solar_noon":"2015-05-21T12:14:17+00:00",
+    *     "day_length":51444,
+    *     "civil_twilight_begin":"2015-05-21T04:36:17+00:00",
+    *     "civil_twilight_end":"2015-05-21T19:52:17+00:00",
+    *     "nautical_twilight_begin":"2015-05-21T04:00:13+00:00",
+    *     "nautical_twilight_end":"2015-05-21T20:28:21+00:00",
+    *     "astronomical_twilight_begin":"2015-05-21T03:20:49+00:00",
+    *     "astronomical_twilight_end":"2015-05-21T21:07:45+00:00"
+    *   },
+    *    "status":"OK"
+    * }
+    */
+
+    filter["results"]["sunrise"]    = true;
+    filter["results"]["sunset"]     = true;
+
+    if (true == filter.overflowed())
+    {
+        LOG_ERROR("Less memory for filter available.");
+    }
 
-        error = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(filter));
+    m_client.setPollPeriod(UPDATE_PERIOD);
 
+    /* The response is parsed while it is received, only the filtered values are kept. */
+    m_client.regOnJsonResponse(filter, JSON_DOC_SIZE, [this](const DeserializationError& error, JsonDocument& jsonDoc){
         if (DeserializationError::Ok != error.code())
         {
             LOG_ERROR("Invalid JSON message received: %s", error.c_str());
@@ -396,6 +427,7 @@ void SunrisePlugin::initHttpClient()
 
             m_relevantResponsePart = sunrise + " / " + sunset;
             m_textWidget.setFormatStr(m_relevantResponsePart);
+            m_isRefreshNeeded = false;
 
             unlock();
 
@@ -411,6 +443,34 @@ void SunrisePlugin::initHttpClient()
     });
 }
 
+void SunrisePlugin::createCanvases(int16_t width, int16_t height)
+{
+    if (nullptr == m_iconCanvas)
+    {
+        m_iconCanvas = new Canvas(ICON_WIDTH, ICON_HEIGHT, 0, 0);
+
+        if (nullptr != m_iconCanvas)
+        {
+            (void)m_iconCanvas->addWidget(m_bitmapWidget);
+
+            /* Load  icon from filesystem. */
+            (void)m_bitmapWidget.load(FILESYSTEM, IMAGE_PATH);
+        }
+    }
+
+    if (nullptr == m_textCanvas)
+    {
+        m_textCanvas = new Canvas(width - ICON_WIDTH, height, ICON_WIDTH, 0);
+
+        if (nullptr != m_textCanvas)
+        {
+            (void)m_textCanvas->addWidget(m_textWidget);
+        }
+    }
+
+    return;
+}
+
 String SunrisePlugin::addCurrentTimezoneValues(const String& dateTimeString) const
 {
     tm          gmTimeInfo;
@@ -439,7 +499,7 @@ bool SunrisePlugin::saveConfiguration() const
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     jsonDoc["longitude"]    = m_longitude;
@@ -463,7 +523,7 @@ bool SunrisePlugin::loadConfiguration()
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
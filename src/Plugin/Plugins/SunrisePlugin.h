@@ -90,7 +90,8 @@ public:
         m_relevantResponsePart(""),
         m_client(),
         m_xMutex(nullptr),
-        m_requestTimer()
+        m_requestTimer(),
+        m_isRefreshNeeded(true)
     {
         /* Move the text widget one line lower for better look. */
         m_textWidget.move(0, 1);
@@ -191,6 +192,15 @@ public:
      */
     void inactive() final;
 
+    /**
+     * This method will be called in case the plugin was invisible for the
+     * configured hibernation time. The canvases are destroyed and the icon
+     * is released. They are rebuilt in active().
+     *
+     * @return Hibernation is supported, therefore it returns always true.
+     */
+    bool hibernate() final;
+
     /**
      * Update the display.
      * The scheduler will call this method periodically.
@@ -218,6 +228,13 @@ public:
      */
     void process(void) final;
 
+    /**
+     * This method will be called shortly before the plugin is set active,
+     * while the current slot is still shown. The sunrise and sunset times
+     * are refreshed, if necessary and the canvases are allocated ahead.
+     */
+    void prepare() final;
+
     /**
      * Get geo location.
      *
@@ -279,6 +296,7 @@ private:
     SimpleTimer                 m_requestDataTimer;         /**< Timer, used for cyclic request of new data. */
     SemaphoreHandle_t           m_xMutex;                   /**< Mutex to protect against concurrent access. */
     SimpleTimer                 m_requestTimer;             /**< Timer is used for cyclic sunrise/sunset http request. */
+    bool                        m_isRefreshNeeded;          /**< Is a refresh needed, because no valid data is available or the location changed? */
 
     /**
      * Request new data.
@@ -292,6 +310,14 @@ private:
      */
     void initHttpClient(void);
 
+    /**
+     * Create the canvases with their widgets, if not already done.
+     *
+     * @param[in] width     Display width in pixel
+     * @param[in] height    Display height in pixel
+     */
+    void createCanvases(int16_t width, int16_t height);
+
     /**
      * Add the daylight saving (if available) and GMT offset values to the given
      * date/time string.
@@ -306,7 +332,7 @@ private:
     /**
      * Saves current configuration to JSON file.
      */
-    bool saveConfiguration() const;
+    bool saveConfiguration() const final;
 
     /**
      * Load configuration from JSON file.
@@ -316,12 +342,12 @@ private:
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
 };
 
 /******************************************************************************
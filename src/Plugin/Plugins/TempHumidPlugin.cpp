@@ -133,6 +133,8 @@ void TempHumidPlugin::update(IGfx& gfx)
     bool showPage                   = false;
     char valueReducedPrecison[6]    = { 0 };    /* Holds a value in lower precision for display. */
 
+    lock();
+
     if (false == m_timer.isTimerRunning())
     {
         m_timer.start(m_pageTime);
@@ -193,29 +195,43 @@ void TempHumidPlugin::update(IGfx& gfx)
         }
     }
 
+    unlock();
+
     return;
 }
 
-void TempHumidPlugin::process() 
+void TempHumidPlugin::process()
 {
-    /* Read only if update period not reached or sensor has never been read. */
-    if ((false == m_sensorUpdateTimer.isTimerRunning()) ||
-        (true == m_sensorUpdateTimer.isTimeout()))
+    bool isReadRequired = false;
+
+    lock();
+
+    if (true == m_isReadDone)
     {
-        float   humidity    = m_dht.getHumidity();
-        float   temperature = m_dht.getTemperature();
+        applySensorValues();
+    }
 
-        /* Only accept if both values could be read. */
-        if ( (!isnan(humidity)) && (!isnan(temperature)) ) 
-        {
-            m_humid = humidity;
-            m_temp  = temperature;
+    /* Read only if update period not reached or sensor has never been read. */
+    if ((false == m_isReadPending) &&
+        ((false == m_sensorUpdateTimer.isTimerRunning()) ||
+         (true == m_sensorUpdateTimer.isTimeout())))
+    {
+        m_isReadPending = true;
+        isReadRequired  = true;
+    }
 
-            LOG_INFO("Got new temp. h: %f, t: %f", m_humid, m_temp);
+    unlock();
 
-            m_sensorUpdateTimer.start(SENSOR_UPDATE_PERIOD);
+    if (true == isReadRequired)
+    {
+        /* If the worker pool is not available, read it directly. */
+        if (false == WorkerPool::getInstance().submit(readSensorJob, this))
+        {
+            readSensor();
         }
     }
+
+    return;
 }
 
 void TempHumidPlugin::start()
@@ -252,6 +268,52 @@ void TempHumidPlugin::unlock() const
     return;
 }
 
+void TempHumidPlugin::readSensor()
+{
+    /* The read buffer is owned by the worker as long as the read is
+     * pending and not done. The lock is only taken to mark it as done.
+     */
+    m_readHumid = m_dht.getHumidity();
+    m_readTemp  = m_dht.getTemperature();
+
+    lock();
+    m_isReadDone = true;
+    unlock();
+
+    return;
+}
+
+void TempHumidPlugin::applySensorValues()
+{
+    /* Only accept if both values could be read. */
+    if ( (!isnan(m_readHumid)) && (!isnan(m_readTemp)) )
+    {
+        m_humid = m_readHumid;
+        m_temp  = m_readTemp;
+
+        LOG_INFO("Got new temp. h: %f, t: %f", m_humid, m_temp);
+
+        m_sensorUpdateTimer.start(SENSOR_UPDATE_PERIOD);
+    }
+
+    m_isReadDone    = false;
+    m_isReadPending = false;
+
+    return;
+}
+
+void TempHumidPlugin::readSensorJob(void* arg)
+{
+    TempHumidPlugin* plugin = static_cast<TempHumidPlugin*>(arg);
+
+    if (nullptr != plugin)
+    {
+        plugin->readSensor();
+    }
+
+    return;
+}
+
 /******************************************************************************
  * External Functions
  *****************************************************************************/
@@ -48,6 +48,7 @@
 
 #include <DHTesp.h>
 #include <SimpleTimer.hpp>
+#include <WorkerPool.h>
 
 #include <Canvas.h>
 #include <BitmapWidget.h>
@@ -94,12 +95,16 @@ public:
         m_humid(0.0F),
         m_temp(0.0F),
         m_sensorUpdateTimer(),
+        m_isReadPending(false),
+        m_isReadDone(false),
+        m_readHumid(NAN),
+        m_readTemp(NAN),
         m_slotInterf(nullptr)
     {
         /* Move the text widget one line lower for better look. */
         m_textWidget.move(0, 1);
 
-        m_xMutex = xSemaphoreCreateMutex();        
+        m_xMutex = xSemaphoreCreateRecursiveMutex();
     }
 
     /**
@@ -117,6 +122,9 @@ public:
      */
     ~TempHumidPlugin()
     {
+        /* A pending sensor read must not access the plugin anymore. */
+        WorkerPool::getInstance().cancel(this);
+
         if (nullptr != m_iconCanvas)
         {
             delete m_iconCanvas;
@@ -181,10 +189,10 @@ public:
 
     /**
      * Process the plugin.
-     * Overwrite it if your plugin has cyclic stuff to do without being in a
-     * active slot.
+     * The sensor is read by the worker pool, because a read blocks for
+     * several milliseconds and would delay the display update.
      */
-    void process(void) final;    
+    void process(void) final;
 
 private:
     /**
@@ -225,18 +233,41 @@ private:
     float                       m_humid;                    /**< Last sensor humidity value */
     float                       m_temp;                     /**< Last sensor temperature value */
     SimpleTimer                 m_sensorUpdateTimer;        /**< Time used for cyclic sensor reading. */
+    bool                        m_isReadPending;            /**< Is a sensor read job pending? */
+    bool                        m_isReadDone;               /**< Are the read sensor values ready to be applied? */
+    float                       m_readHumid;                /**< Read humidity value, written by the worker only while a read is pending. */
+    float                       m_readTemp;                 /**< Read temperature value, written by the worker only while a read is pending. */
     const ISlotPlugin*          m_slotInterf;               /**< Slot interface */
 
     /**
      * Protect against concurrent access.
      */
-    void lock(void) const;
+    void lock(void) const final;
 
     /**
      * Unprotect against concurrent access.
      */
-    void unlock(void) const;
+    void unlock(void) const final;
+
+    /**
+     * Read the sensor into the read buffer.
+     * Runs in the worker pool context. The rendered values are not
+     * touched, they are applied later by applySensorValues().
+     */
+    void readSensor();
+
+    /**
+     * Apply the read sensor values to the plugin.
+     * Runs in the display task context with the plugin locked.
+     */
+    void applySensorValues();
 
+    /**
+     * Sensor read job, executed by the worker pool.
+     *
+     * @param[in] arg   Plugin instance
+     */
+    static void readSensorJob(void* arg);
 };
 
 /******************************************************************************
@@ -35,6 +35,7 @@
 #include "VolumioPlugin.h"
 #include "RestApi.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
 
 #include <Logging.h>
 #include <ArduinoJson.h>
@@ -311,7 +312,7 @@ void VolumioPlugin::setHost(const String& host)
 {
     lock();
     m_volumioHost = host;
-    (void)saveConfiguration();
+    requestSaveConfiguration();
     unlock();
 
     return;
@@ -351,29 +352,26 @@ bool VolumioPlugin::startHttpRequest()
 
 void VolumioPlugin::initHttpClient()
 {
-    m_client.regOnResponse([this](const HttpResponse& rsp){
-        size_t                          payloadSize             = 0U;
-        const char*                     payload                 = reinterpret_cast<const char*>(rsp.getPayload(payloadSize));
-        const size_t                    JSON_DOC_SIZE           = 512U;
-        DynamicJsonDocument             jsonDoc(JSON_DOC_SIZE);
-        const size_t                    FILTER_SIZE             = 128U;
-        StaticJsonDocument<FILTER_SIZE> filter;
-        DeserializationError            error;
-
-        filter["artist"]    = true;
-        filter["duration"]  = true;
-        filter["seek"]      = true;
-        filter["service"]   = true;
-        filter["status"]    = true;
-        filter["title"]     = true;
-        
-        if (true == filter.overflowed())
-        {
-            LOG_ERROR("Less memory for filter available.");
-        }
+    const size_t                    JSON_DOC_SIZE           = 512U;
+    const size_t                    FILTER_SIZE             = 128U;
+    StaticJsonDocument<FILTER_SIZE> filter;
+
+    filter["artist"]    = true;
+    filter["duration"]  = true;
+    filter["seek"]      = true;
+    filter["service"]   = true;
+    filter["status"]    = true;
+    filter["title"]     = true;
+
+    if (true == filter.overflowed())
+    {
+        LOG_ERROR("Less memory for filter available.");
+    }
 
-        error = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(filter));
+    m_client.setPollPeriod(UPDATE_PERIOD);
 
+    /* The response is parsed while it is received, only the filtered values are kept. */
+    m_client.regOnJsonResponse(filter, JSON_DOC_SIZE, [this](const DeserializationError& error, JsonDocument& jsonDoc){
         if (DeserializationError::Ok != error.code())
         {
             LOG_WARNING("JSON parse error: %s", error.c_str());
@@ -546,7 +544,7 @@ bool VolumioPlugin::saveConfiguration() const
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     jsonDoc["host"] = m_volumioHost;
@@ -569,7 +567,7 @@ bool VolumioPlugin::loadConfiguration()
     bool                status                  = true;
     JsonFile            jsonFile(FILESYSTEM);
     const size_t        JSON_DOC_SIZE           = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     String              configurationFilename   = getFullPathToConfiguration();
 
     if (false == jsonFile.load(configurationFilename, jsonDoc))
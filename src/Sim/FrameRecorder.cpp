@@ -0,0 +1,318 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Frame recorder for the host simulation
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "FrameRecorder.h"
+#include "DisplayMgr.h"
+#include "LedMatrix.h"
+
+#include <Logging.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static void writeRgb888(FILE* fd, const uint32_t* framebuffer, size_t length);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+FrameRecorder::FrameRecorder() :
+    m_path(),
+    m_format(FORMAT_NONE),
+    m_timingFd(nullptr),
+    m_rawFd(nullptr),
+    m_framebuffer(nullptr),
+    m_framebufferLen(0U),
+    m_frameCnt(0U),
+    m_lastFrame(),
+    m_sumProcessingTime(0U),
+    m_maxProcessingTime(0U)
+{
+    m_path[0] = '\0';
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    end();
+}
+
+bool FrameRecorder::begin(const char* path, Format format)
+{
+    bool    status                  = true;
+    char    fileName[FILE_NAME_MAX_LEN];
+
+    end();
+
+    if (nullptr == path)
+    {
+        path = ".";
+    }
+
+    strncpy(m_path, path, sizeof(m_path) - 1U);
+    m_path[sizeof(m_path) - 1U] = '\0';
+
+    m_format            = format;
+    m_framebufferLen    = LedMatrix::getInstance().getWidth() * LedMatrix::getInstance().getHeight();
+    m_framebuffer       = new uint32_t[m_framebufferLen];
+
+    (void)snprintf(fileName, sizeof(fileName), "%s/timing.csv", m_path);
+    m_timingFd = fopen(fileName, "w");
+
+    if (nullptr == m_timingFd)
+    {
+        LOG_ERROR("Couldn't create %s.", fileName);
+        status = false;
+    }
+    else
+    {
+        fprintf(m_timingFd, "frame;timestamp [ms];processing time [us];slot\n");
+    }
+
+    if ((true == status) &&
+        (FORMAT_RAW == m_format))
+    {
+        (void)snprintf(fileName, sizeof(fileName), "%s/frames.raw", m_path);
+        m_rawFd = fopen(fileName, "wb");
+
+        if (nullptr == m_rawFd)
+        {
+            LOG_ERROR("Couldn't create %s.", fileName);
+            status = false;
+        }
+    }
+
+    if (false == status)
+    {
+        end();
+    }
+    else
+    {
+        m_frameCnt              = 0U;
+        m_sumProcessingTime     = 0U;
+        m_maxProcessingTime     = 0U;
+        m_lastFrame             = WallClock::now();
+
+        NeoPixelShowHook::set(onShow, this);
+    }
+
+    return status;
+}
+
+void FrameRecorder::end()
+{
+    NeoPixelShowHook::set(nullptr, nullptr);
+
+    if (nullptr != m_timingFd)
+    {
+        fclose(m_timingFd);
+        m_timingFd = nullptr;
+    }
+
+    if (nullptr != m_rawFd)
+    {
+        fclose(m_rawFd);
+        m_rawFd = nullptr;
+    }
+
+    if (nullptr != m_framebuffer)
+    {
+        delete[] m_framebuffer;
+        m_framebuffer       = nullptr;
+        m_framebufferLen    = 0U;
+    }
+
+    return;
+}
+
+uint32_t FrameRecorder::getAvgProcessingTime() const
+{
+    uint32_t avg = 0U;
+
+    if (0U < m_frameCnt)
+    {
+        avg = static_cast<uint32_t>(m_sumProcessingTime / m_frameCnt);
+    }
+
+    return avg;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void FrameRecorder::record()
+{
+    WallClock::time_point   now             = WallClock::now();
+    uint32_t                processingTime  = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastFrame).count());
+    uint8_t                 slotId          = DisplayMgr::SLOT_ID_INVALID;
+
+    /* The display manager lock is already held by the display task, which
+     * shows the frame. Its a recursive lock, so there is no deadlock.
+     */
+    DisplayMgr::getInstance().getFBCopy(m_framebuffer, m_framebufferLen, &slotId);
+
+    if (nullptr != m_timingFd)
+    {
+        fprintf(m_timingFd, "%u;%lu;%u;%u\n", m_frameCnt, millis(), processingTime, slotId);
+    }
+
+    switch(m_format)
+    {
+    case FORMAT_PPM:
+        writePpm();
+        break;
+
+    case FORMAT_RAW:
+        writeRaw();
+        break;
+
+    case FORMAT_NONE:
+        /* fall through */
+    default:
+        break;
+    }
+
+    m_sumProcessingTime += processingTime;
+
+    if (m_maxProcessingTime < processingTime)
+    {
+        m_maxProcessingTime = processingTime;
+    }
+
+    ++m_frameCnt;
+
+    /* Don't account the time for writing the frame to the next frame. */
+    m_lastFrame = WallClock::now();
+
+    return;
+}
+
+void FrameRecorder::writePpm()
+{
+    char    fileName[FILE_NAME_MAX_LEN];
+    FILE*   fd          = nullptr;
+
+    (void)snprintf(fileName, sizeof(fileName), "%s/frame_%06u.ppm", m_path, m_frameCnt);
+    fd = fopen(fileName, "wb");
+
+    if (nullptr == fd)
+    {
+        LOG_ERROR("Couldn't create %s.", fileName);
+    }
+    else
+    {
+        fprintf(fd, "P6\n%d %d\n255\n", LedMatrix::getInstance().getWidth(), LedMatrix::getInstance().getHeight());
+        writeRgb888(fd, m_framebuffer, m_framebufferLen);
+        fclose(fd);
+    }
+
+    return;
+}
+
+void FrameRecorder::writeRaw()
+{
+    if (nullptr != m_rawFd)
+    {
+        writeRgb888(m_rawFd, m_framebuffer, m_framebufferLen);
+    }
+
+    return;
+}
+
+void FrameRecorder::onShow(void* arg)
+{
+    FrameRecorder* recorder = static_cast<FrameRecorder*>(arg);
+
+    if (nullptr != recorder)
+    {
+        recorder->record();
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Write framebuffer in RGB888 format, row by row.
+ *
+ * @param[in] fd            File descriptor
+ * @param[in] framebuffer   Framebuffer with colors in RGB888 format
+ * @param[in] length        Number of pixels
+ */
+static void writeRgb888(FILE* fd, const uint32_t* framebuffer, size_t length)
+{
+    size_t index = 0U;
+
+    for(index = 0U; index < length; ++index)
+    {
+        uint8_t rgb[3U];
+
+        rgb[0U] = static_cast<uint8_t>((framebuffer[index] >> 16U) & 0xFFU);
+        rgb[1U] = static_cast<uint8_t>((framebuffer[index] >>  8U) & 0xFFU);
+        rgb[2U] = static_cast<uint8_t>((framebuffer[index] >>  0U) & 0xFFU);
+
+        (void)fwrite(rgb, sizeof(rgb), 1U, fd);
+    }
+
+    return;
+}
@@ -0,0 +1,191 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Frame recorder for the host simulation
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup sim
+ *
+ * @{
+ */
+
+#ifndef __FRAMERECORDER_H__
+#define __FRAMERECORDER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The frame recorder hooks into the virtual LED strip and records every
+ * frame, which is shown on the LED matrix.
+ *
+ * Per frame the following timing information is written to "timing.csv":
+ * - The frame number.
+ * - The virtual timestamp in ms.
+ * - The host time in us, which was needed since the last frame. In virtual
+ *   time this is the processing time of one display cycle, because waiting
+ *   costs no host time.
+ * - The id of the selected slot.
+ */
+class FrameRecorder
+{
+public:
+
+    /** Frame output formats */
+    enum Format
+    {
+        FORMAT_NONE = 0,    /**< Only timing information is recorded. */
+        FORMAT_PPM,         /**< One binary PPM file per frame. */
+        FORMAT_RAW          /**< All frames in one file, RGB888 row by row. */
+    };
+
+    /**
+     * Constructs the frame recorder.
+     */
+    FrameRecorder();
+
+    /**
+     * Destroys the frame recorder.
+     */
+    ~FrameRecorder();
+
+    /**
+     * Start recording.
+     *
+     * @param[in] path      Existing output directory
+     * @param[in] format    Frame output format
+     *
+     * @return If successful started, it will return true otherwise false.
+     */
+    bool begin(const char* path, Format format);
+
+    /**
+     * Stop recording.
+     */
+    void end();
+
+    /**
+     * Get number of recorded frames.
+     *
+     * @return Number of frames
+     */
+    uint32_t getFrameCount() const
+    {
+        return m_frameCnt;
+    }
+
+    /**
+     * Get the average host processing time per frame in us.
+     *
+     * @return Average processing time in us
+     */
+    uint32_t getAvgProcessingTime() const;
+
+    /**
+     * Get the max. host processing time per frame in us.
+     *
+     * @return Max. processing time in us
+     */
+    uint32_t getMaxProcessingTime() const
+    {
+        return m_maxProcessingTime;
+    }
+
+private:
+
+    /** Host wall clock, used to measure the processing time. */
+    typedef std::chrono::steady_clock   WallClock;
+
+    /** Max. length of a file path. */
+    static const size_t     PATH_MAX_LEN        = 256U;
+
+    /**
+     * Max. length of a output file name, which is the output directory with
+     * the longest file name "/frame_<uint32>.ppm" in the worst case.
+     */
+    static const size_t     FILE_NAME_MAX_LEN   = PATH_MAX_LEN + 24U;
+
+    char                    m_path[PATH_MAX_LEN];   /**< Output directory */
+    Format                  m_format;               /**< Frame output format */
+    FILE*                   m_timingFd;             /**< Timing file */
+    FILE*                   m_rawFd;                /**< Raw frame file */
+    uint32_t*               m_framebuffer;          /**< Framebuffer copy */
+    size_t                  m_framebufferLen;       /**< Number of pixels in the framebuffer */
+    uint32_t                m_frameCnt;             /**< Number of recorded frames */
+    WallClock::time_point   m_lastFrame;            /**< Wall clock time of the last frame */
+    uint64_t                m_sumProcessingTime;    /**< Sum of all processing times in us */
+    uint32_t                m_maxProcessingTime;    /**< Max. processing time in us */
+
+    FrameRecorder(const FrameRecorder& recorder);
+    FrameRecorder& operator=(const FrameRecorder& recorder);
+
+    /**
+     * Record the current frame.
+     */
+    void record();
+
+    /**
+     * Write the current frame as PPM file.
+     */
+    void writePpm();
+
+    /**
+     * Write the current frame to the raw file.
+     */
+    void writeRaw();
+
+    /**
+     * Show hook, called by the virtual LED strip.
+     *
+     * @param[in] arg   Frame recorder instance
+     */
+    static void onShow(void* arg);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __FRAMERECORDER_H__ */
+
+/** @} */
@@ -0,0 +1,250 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP response payload benchmark for the host simulation
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpRspBenchmark.h"
+#include "HttpResponse.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/** Benchmark result of a single scenario. */
+typedef struct
+{
+    uint64_t    sumTime;        /**< Sum of all processing times in us */
+    uint32_t    allocations;    /**< Number of payload buffer allocations per response */
+    size_t      peakHeap;       /**< Peak payload buffer heap per response in byte */
+
+} BenchmarkResult;
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static bool receiveResponse(HttpResponse& rsp, const uint8_t* payload, size_t payloadSize, bool isSizeKnown, BenchmarkResult& result);
+static bool runScenario(const char* name, const uint8_t* payload, size_t payloadSize, bool isSizeKnown, uint32_t iterations);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Max. TCP segment size in byte, which the HTTP client receives at once. */
+static const size_t SEGMENT_SIZE    = 1436U;
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+bool HttpRspBenchmark::run(size_t payloadSize, uint32_t iterations)
+{
+    bool        isSuccessful    = false;
+    uint8_t*    payload         = new uint8_t[payloadSize];
+
+    if ((nullptr != payload) &&
+        (0U < iterations))
+    {
+        size_t index = 0U;
+
+        for(index = 0U; index < payloadSize; ++index)
+        {
+            payload[index] = static_cast<uint8_t>('a' + (index % 26U));
+        }
+
+        printf("Payload: %zu byte, segment: %zu byte, responses: %u\n", payloadSize, SEGMENT_SIZE, iterations);
+        printf("%-16s %12s %12s %14s\n", "Scenario", "Time [us]", "Allocations", "Peak heap [B]");
+
+        isSuccessful = runScenario("Content-Length", payload, payloadSize, true, iterations);
+
+        if (true == isSuccessful)
+        {
+            isSuccessful = runScenario("Unknown length", payload, payloadSize, false, iterations);
+        }
+    }
+
+    if (nullptr != payload)
+    {
+        delete[] payload;
+    }
+
+    return isSuccessful;
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Receive a single response payload segment by segment.
+ *
+ * @param[in]   rsp         HTTP response
+ * @param[in]   payload     Payload
+ * @param[in]   payloadSize Payload size in byte
+ * @param[in]   isSizeKnown Is the payload size known in advance (Content-Length)?
+ * @param[out]  result      Number of allocations and peak heap
+ *
+ * @return If the payload was received completely, it will return true otherwise false.
+ */
+static bool receiveResponse(HttpResponse& rsp, const uint8_t* payload, size_t payloadSize, bool isSizeKnown, BenchmarkResult& result)
+{
+    bool            isSuccessful    = false;
+    size_t          index           = 0U;
+    size_t          capacity        = 0U;
+    const uint8_t*  rspPayload      = nullptr;
+    size_t          rspPayloadSize  = 0U;
+
+    result.allocations  = 0U;
+    result.peakHeap     = 0U;
+
+    if (true == isSizeKnown)
+    {
+        (void)rsp.reservePayload(payloadSize);
+    }
+
+    while(payloadSize > index)
+    {
+        size_t  copySize    = payloadSize - index;
+        size_t  newCapacity = 0U;
+
+        if (SEGMENT_SIZE < copySize)
+        {
+            copySize = SEGMENT_SIZE;
+        }
+
+        rsp.addPayload(&payload[index], copySize);
+        index += copySize;
+
+        newCapacity = rsp.getPayloadCapacity();
+
+        /* During a resize the old and the new buffer are allocated. */
+        if (capacity != newCapacity)
+        {
+            ++result.allocations;
+
+            if (result.peakHeap < (capacity + newCapacity))
+            {
+                result.peakHeap = capacity + newCapacity;
+            }
+
+            capacity = newCapacity;
+        }
+    }
+
+    /* The reservation happened already before the first segment. */
+    if ((true == isSizeKnown) &&
+        (0U == result.allocations))
+    {
+        result.allocations  = 1U;
+        result.peakHeap     = capacity;
+    }
+
+    rspPayload = rsp.getPayload(rspPayloadSize);
+
+    if ((nullptr != rspPayload) &&
+        (payloadSize == rspPayloadSize) &&
+        (0 == memcmp(rspPayload, payload, payloadSize)))
+    {
+        isSuccessful = true;
+    }
+
+    rsp.clear();
+
+    return isSuccessful;
+}
+
+/**
+ * Run a single benchmark scenario and print the result.
+ *
+ * @param[in] name          Scenario name
+ * @param[in] payload       Payload
+ * @param[in] payloadSize   Payload size in byte
+ * @param[in] isSizeKnown   Is the payload size known in advance (Content-Length)?
+ * @param[in] iterations    Number of responses
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+static bool runScenario(const char* name, const uint8_t* payload, size_t payloadSize, bool isSizeKnown, uint32_t iterations)
+{
+    bool            isSuccessful    = true;
+    HttpResponse    rsp;
+    BenchmarkResult result;
+    uint32_t        iteration       = 0U;
+
+    result.sumTime      = 0U;
+    result.allocations  = 0U;
+    result.peakHeap     = 0U;
+
+    for(iteration = 0U; (iteration < iterations) && (true == isSuccessful); ++iteration)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        isSuccessful = receiveResponse(rsp, payload, payloadSize, isSizeKnown, result);
+
+        result.sumTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    if (false == isSuccessful)
+    {
+        printf("%-16s payload mismatch\n", name);
+    }
+    else
+    {
+        printf("%-16s %12.2f %12u %14zu\n", name, static_cast<double>(result.sumTime) / iterations, result.allocations, result.peakHeap);
+    }
+
+    return isSuccessful;
+}
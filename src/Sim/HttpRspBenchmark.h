@@ -0,0 +1,91 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP response payload benchmark for the host simulation
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup sim
+ *
+ * @{
+ */
+
+#ifndef __HTTPRSPBENCHMARK_H__
+#define __HTTPRSPBENCHMARK_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The benchmark feeds a response payload in TCP segment sized parts into a
+ * HTTP response, the same way as the asynchronous HTTP client does it.
+ * It measures the host processing time, the number of payload buffer
+ * allocations and the peak heap, which is required for the payload buffers.
+ * The peak heap includes the old and the new buffer during a resize.
+ */
+namespace HttpRspBenchmark
+{
+
+/** Default payload size in byte, which is about a OpenWeather one-call response. */
+static const size_t DEFAULT_PAYLOAD_SIZE    = 20U * 1024U;
+
+/** Default number of responses per scenario. */
+static const uint32_t DEFAULT_ITERATIONS    = 1000U;
+
+/**
+ * Run the benchmark and print the results to the standard output.
+ *
+ * @param[in] payloadSize   Payload size in byte
+ * @param[in] iterations    Number of responses per scenario
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+extern bool run(size_t payloadSize, uint32_t iterations);
+
+}
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTPRSPBENCHMARK_H__ */
+
+/** @} */
@@ -0,0 +1,1331 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT session benchmark
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MqttBenchmark.h"
+#include "MqttSession.h"
+
+#include <VirtualClock.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/** Message, which is queued by the broker for a client. */
+typedef struct
+{
+    std::string             topic;      /**< Topic name */
+    std::vector<uint8_t>    payload;    /**< Payload */
+    uint8_t                 qos;        /**< Quality of service */
+    uint16_t                packetId;   /**< Packet id of a QoS 1 message */
+    bool                    isSent;     /**< Is it sent and waits for the acknowledge? */
+
+} BrokerMessage;
+
+/** Subscription of a client at the broker. */
+typedef struct
+{
+    std::string filter; /**< Topic filter */
+    uint8_t     qos;    /**< Max. quality of service */
+
+} BrokerSubscription;
+
+/** Client session at the broker, which is kept while the client is offline. */
+typedef struct
+{
+    std::string                     clientId;       /**< Client identifier */
+    bool                            isConnected;    /**< Is the client connected? */
+    std::vector<BrokerSubscription> subscriptions;  /**< Subscriptions */
+    std::deque<BrokerMessage>       outbox;         /**< Messages to the client */
+    uint16_t                        nextPacketId;   /**< Next packet id */
+    std::vector<uint8_t>*           tx;             /**< Stream to the client, if connected. */
+
+} BrokerSession;
+
+/** Connection between a client and the broker. */
+typedef struct
+{
+    std::vector<uint8_t>    rx;         /**< Received stream, which is not handled yet. */
+    std::vector<uint8_t>    tx;         /**< Stream to the client */
+    BrokerSession*          session;    /**< Session after the connect */
+
+} Connection;
+
+/**
+ * Minimal MQTT 3.1.1 broker, which supports QoS 0 and 1, persistent sessions
+ * and the keep alive ping. Retained messages and wills are not supported.
+ */
+class Broker
+{
+public:
+
+    /**
+     * Constructs the broker.
+     */
+    Broker() :
+        m_sessions(),
+        m_pings(0U),
+        m_isPingMuted(false)
+    {
+    }
+
+    /**
+     * Destroys the broker.
+     */
+    ~Broker()
+    {
+        size_t index = 0U;
+
+        for(index = 0U; index < m_sessions.size(); ++index)
+        {
+            delete m_sessions[index];
+        }
+    }
+
+    /**
+     * Receive a stream from a client.
+     *
+     * @param[in] connection    Connection of the client
+     * @param[in] data          Data
+     * @param[in] size          Data size in byte
+     *
+     * @return If the stream is valid, it will return true otherwise false.
+     */
+    bool receive(Connection& connection, const uint8_t* data, size_t size);
+
+    /**
+     * The connection to a client is lost or closed.
+     *
+     * @param[in] connection    Connection of the client
+     */
+    void disconnect(Connection& connection);
+
+    /**
+     * Get number of received pings.
+     *
+     * @return Number of pings
+     */
+    uint32_t getPings() const
+    {
+        return m_pings;
+    }
+
+    /**
+     * Enable/Disable the ping response.
+     *
+     * @param[in] isMuted   If true, the pings are not answered.
+     */
+    void setPingMuted(bool isMuted)
+    {
+        m_isPingMuted = isMuted;
+    }
+
+private:
+
+    std::vector<BrokerSession*> m_sessions;     /**< All sessions */
+    uint32_t                    m_pings;        /**< Number of received pings */
+    bool                        m_isPingMuted;  /**< Are the pings not answered? */
+
+    Broker(const Broker& broker);
+    Broker& operator=(const Broker& broker);
+
+    /**
+     * Handle a complete packet.
+     *
+     * @param[in] connection    Connection of the client
+     * @param[in] header        Fixed header byte
+     * @param[in] body          Variable header and payload
+     * @param[in] length        Length of variable header and payload in byte
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handlePacket(Connection& connection, uint8_t header, const uint8_t* body, size_t length);
+
+    /**
+     * Route a message to all matching subscriptions.
+     *
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     * @param[in] qos       Quality of service of the message
+     */
+    void route(const std::string& topic, const uint8_t* payload, size_t size, uint8_t qos);
+
+    /**
+     * Send all not sent messages of a session, if the client is connected.
+     *
+     * @param[in] session   Session
+     */
+    void flush(BrokerSession& session);
+};
+
+/**
+ * MQTT client, which uses a MQTT session to communicate with the broker and
+ * verifies the received messages.
+ */
+class Client
+{
+public:
+
+    /**
+     * Constructs the client.
+     *
+     * @param[in] broker    Broker
+     * @param[in] clientId  Client identifier
+     */
+    Client(Broker& broker, const char* clientId) :
+        m_broker(broker),
+        m_clientId(clientId),
+        m_session(),
+        m_connection(),
+        m_isConnAck(false),
+        m_isSessionPresent(false),
+        m_received(0U),
+        m_errors(0U)
+    {
+        m_connection.session = nullptr;
+        m_session.setFunctions(sessionSend, sessionConnAck, sessionMessage, this);
+    }
+
+    /**
+     * Destroys the client.
+     */
+    ~Client()
+    {
+    }
+
+    /**
+     * Connect to the broker.
+     *
+     * @param[in] keepAlive     Keep alive period in s
+     * @param[in] cleanSession  Shall the broker discard a previous session?
+     *
+     * @return If connected, it will return true otherwise false.
+     */
+    bool connect(uint16_t keepAlive, bool cleanSession);
+
+    /**
+     * Disconnect from the broker.
+     */
+    void disconnect();
+
+    /**
+     * Deliver the stream from the broker to the session.
+     *
+     * @param[in] maxChunk  Max. fragment size in byte. 0 delivers all at once.
+     *
+     * @return If something was delivered, it will return true otherwise false.
+     */
+    bool deliver(size_t maxChunk);
+
+    /**
+     * Get MQTT session.
+     *
+     * @return MQTT session
+     */
+    MqttSession& getSession()
+    {
+        return m_session;
+    }
+
+    /**
+     * Has the broker a stored session after the last connect?
+     *
+     * @return If a session is present, it will return true otherwise false.
+     */
+    bool isSessionPresent() const
+    {
+        return m_isSessionPresent;
+    }
+
+    /**
+     * Get number of received messages.
+     *
+     * @return Number of received messages
+     */
+    uint32_t getReceived() const
+    {
+        return m_received;
+    }
+
+    /**
+     * Get number of received messages, which are not expected.
+     *
+     * @return Number of errors
+     */
+    uint32_t getErrors() const
+    {
+        return m_errors;
+    }
+
+private:
+
+    Broker&         m_broker;           /**< Broker */
+    const char*     m_clientId;         /**< Client identifier */
+    MqttSession     m_session;          /**< MQTT session */
+    Connection      m_connection;       /**< Connection to the broker */
+    bool            m_isConnAck;        /**< Is the connection acknowledged? */
+    bool            m_isSessionPresent; /**< Has the broker a stored session? */
+    uint32_t        m_received;         /**< Number of received messages */
+    uint32_t        m_errors;           /**< Number of not expected messages */
+
+    Client(const Client& client);
+    Client& operator=(const Client& client);
+
+    /**
+     * MQTT session send function.
+     *
+     * @param[in] arg   Client
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    static size_t sessionSend(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * MQTT session connection acknowledge function.
+     *
+     * @param[in] arg               Client
+     * @param[in] isSessionPresent  Has the broker a stored session?
+     */
+    static void sessionConnAck(void* arg, bool isSessionPresent);
+
+    /**
+     * MQTT session message function. The payload shall contain the sequence
+     * number of the message, which is the expected topic part too.
+     *
+     * @param[in] arg       Client
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     */
+    static void sessionMessage(void* arg, const char* topic, const uint8_t* payload, size_t size);
+};
+
+/** Benchmark scenario */
+typedef struct
+{
+    const char*         name;       /**< Scenario name */
+    MqttSession::QoS    qos;        /**< Quality of service */
+    size_t              maxChunk;   /**< Max. fragment size in byte, 0 for complete packets */
+
+} Scenario;
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static size_t putLength(uint8_t* buffer, size_t length);
+static void putPacket(std::vector<uint8_t>& stream, uint8_t header, const std::vector<uint8_t>& body);
+static void putString(std::vector<uint8_t>& body, const std::string& str);
+static bool getString(const uint8_t* body, size_t length, size_t& index, std::string& str);
+static void buildPayload(uint32_t sequence, char* payload, size_t size);
+static bool deliverAll(Client& first, Client& second, size_t maxChunk);
+static bool runScenario(const Scenario& scenario, uint32_t messages);
+static bool runPersistentSession(uint32_t messages);
+static bool runKeepAlive();
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Topic filter of the subscriber */
+static const char*      TOPIC_FILTER        = "bench/+/value";
+
+/** Payload size in byte */
+static const size_t     PAYLOAD_SIZE        = 32U;
+
+/** Max. number of messages, which are queued by the broker while the subscriber is offline. */
+static const uint32_t   MAX_OFFLINE         = 1000U;
+
+/** Benchmark scenarios */
+static const Scenario   SCENARIOS[]         =
+{
+    { "QoS 0",              MqttSession::QOS_0, 0U },
+    { "QoS 1",              MqttSession::QOS_1, 0U },
+    { "QoS 1 fragmented",   MqttSession::QOS_1, 7U }
+};
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool Broker::receive(Connection& connection, const uint8_t* data, size_t size)
+{
+    bool    isValid     = true;
+    bool    isComplete  = true;
+
+    connection.rx.insert(connection.rx.end(), data, data + size);
+
+    /* Handle all complete packets. */
+    while((true == isValid) && (true == isComplete))
+    {
+        size_t  length      = 0U;
+        size_t  pos         = 1U;
+        bool    isLength    = false;
+
+        while((false == isLength) && (pos < connection.rx.size()) && (5U > pos))
+        {
+            length |= static_cast<size_t>(connection.rx[pos] & 0x7FU) << (7U * (pos - 1U));
+            isLength = (0U == (connection.rx[pos] & 0x80U));
+            ++pos;
+        }
+
+        if ((false == isLength) ||
+            ((pos + length) > connection.rx.size()))
+        {
+            isComplete = false;
+        }
+        else
+        {
+            std::vector<uint8_t> packet(connection.rx.begin(), connection.rx.begin() + pos + length);
+
+            connection.rx.erase(connection.rx.begin(), connection.rx.begin() + pos + length);
+            isValid = handlePacket(connection, packet[0U], &packet[pos], length);
+        }
+    }
+
+    return isValid;
+}
+
+void Broker::disconnect(Connection& connection)
+{
+    if (nullptr != connection.session)
+    {
+        std::deque<BrokerMessage>::iterator it = connection.session->outbox.begin();
+
+        /* Not acknowledged messages are sent again after the reconnect. */
+        while(connection.session->outbox.end() != it)
+        {
+            if (0U == it->qos)
+            {
+                it = connection.session->outbox.erase(it);
+            }
+            else
+            {
+                it->isSent = false;
+                ++it;
+            }
+        }
+
+        connection.session->isConnected = false;
+        connection.session->tx          = nullptr;
+        connection.session              = nullptr;
+    }
+
+    connection.rx.clear();
+    connection.tx.clear();
+
+    return;
+}
+
+bool Broker::handlePacket(Connection& connection, uint8_t header, const uint8_t* body, size_t length)
+{
+    bool                    isValid = true;
+    uint8_t                 type    = header & 0xF0U;
+    std::vector<uint8_t>    rsp;
+
+    if ((0x10U != type) &&
+        (nullptr == connection.session))
+    {
+        /* The first packet shall be CONNECT. */
+        isValid = false;
+    }
+    /* CONNECT */
+    else if (0x10U == type)
+    {
+        size_t      index           = 0U;
+        std::string protocol;
+        std::string clientId;
+        uint8_t     flags           = 0U;
+        bool        isSessionPresent = false;
+        size_t      sessionIndex    = 0U;
+
+        if ((false == getString(body, length, index, protocol)) ||
+            ((index + 4U) > length))
+        {
+            isValid = false;
+        }
+        else
+        {
+            flags   = body[index + 1U];
+            index  += 4U;
+
+            if (false == getString(body, length, index, clientId))
+            {
+                isValid = false;
+            }
+        }
+
+        if (true == isValid)
+        {
+            BrokerSession* session = nullptr;
+
+            for(sessionIndex = 0U; sessionIndex < m_sessions.size(); ++sessionIndex)
+            {
+                if (clientId == m_sessions[sessionIndex]->clientId)
+                {
+                    session = m_sessions[sessionIndex];
+                }
+            }
+
+            if (nullptr == session)
+            {
+                session = new BrokerSession();
+                session->clientId       = clientId;
+                session->nextPacketId   = 1U;
+                m_sessions.push_back(session);
+            }
+            /* Clean session */
+            else if (0U != (flags & 0x02U))
+            {
+                session->subscriptions.clear();
+                session->outbox.clear();
+            }
+            else
+            {
+                isSessionPresent = true;
+            }
+
+            session->isConnected    = true;
+            session->tx             = &connection.tx;
+            connection.session      = session;
+
+            rsp.push_back((true == isSessionPresent) ? 1U : 0U);
+            rsp.push_back(0U);
+            putPacket(connection.tx, 0x20U, rsp);
+
+            flush(*session);
+        }
+    }
+    /* PUBLISH */
+    else if (0x30U == type)
+    {
+        uint8_t     qos     = (header >> 1U) & 0x03U;
+        size_t      index   = 0U;
+        std::string topic;
+
+        if (false == getString(body, length, index, topic))
+        {
+            isValid = false;
+        }
+        else if (0U < qos)
+        {
+            if ((index + 2U) > length)
+            {
+                isValid = false;
+            }
+            else
+            {
+                rsp.push_back(body[index]);
+                rsp.push_back(body[index + 1U]);
+                index += 2U;
+
+                /* PUBACK */
+                putPacket(connection.tx, 0x40U, rsp);
+            }
+        }
+        else
+        {
+            ;
+        }
+
+        if (true == isValid)
+        {
+            route(topic, &body[index], length - index, qos);
+        }
+    }
+    /* PUBACK */
+    else if (0x40U == type)
+    {
+        uint16_t                            packetId    = 0U;
+        std::deque<BrokerMessage>::iterator it          = connection.session->outbox.begin();
+        bool                                isFound     = false;
+
+        if (2U != length)
+        {
+            isValid = false;
+        }
+        else
+        {
+            packetId = (static_cast<uint16_t>(body[0U]) << 8U) | body[1U];
+
+            while((false == isFound) && (connection.session->outbox.end() != it))
+            {
+                if ((true == it->isSent) &&
+                    (packetId == it->packetId))
+                {
+                    (void)connection.session->outbox.erase(it);
+                    isFound = true;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+    /* SUBSCRIBE */
+    else if (0x80U == type)
+    {
+        size_t index = 2U;
+
+        if (2U > length)
+        {
+            isValid = false;
+        }
+        else
+        {
+            rsp.push_back(body[0U]);
+            rsp.push_back(body[1U]);
+        }
+
+        while((true == isValid) && (index < length))
+        {
+            BrokerSubscription subscription;
+
+            if ((false == getString(body, length, index, subscription.filter)) ||
+                (index >= length))
+            {
+                isValid = false;
+            }
+            else
+            {
+                subscription.qos = (1U < body[index]) ? 1U : body[index];
+                ++index;
+
+                connection.session->subscriptions.push_back(subscription);
+                rsp.push_back(subscription.qos);
+            }
+        }
+
+        if (true == isValid)
+        {
+            /* SUBACK */
+            putPacket(connection.tx, 0x90U, rsp);
+        }
+    }
+    /* UNSUBSCRIBE */
+    else if (0xA0U == type)
+    {
+        size_t index = 2U;
+
+        if (2U > length)
+        {
+            isValid = false;
+        }
+        else
+        {
+            rsp.push_back(body[0U]);
+            rsp.push_back(body[1U]);
+        }
+
+        while((true == isValid) && (index < length))
+        {
+            std::string filter;
+
+            if (false == getString(body, length, index, filter))
+            {
+                isValid = false;
+            }
+            else
+            {
+                std::vector<BrokerSubscription>::iterator it = connection.session->subscriptions.begin();
+
+                while(connection.session->subscriptions.end() != it)
+                {
+                    if (filter == it->filter)
+                    {
+                        it = connection.session->subscriptions.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+        }
+
+        if (true == isValid)
+        {
+            /* UNSUBACK */
+            putPacket(connection.tx, 0xB0U, rsp);
+        }
+    }
+    /* PINGREQ */
+    else if (0xC0U == type)
+    {
+        ++m_pings;
+
+        if (false == m_isPingMuted)
+        {
+            /* PINGRESP */
+            putPacket(connection.tx, 0xD0U, rsp);
+        }
+    }
+    /* DISCONNECT */
+    else if (0xE0U == type)
+    {
+        disconnect(connection);
+    }
+    else
+    {
+        isValid = false;
+    }
+
+    return isValid;
+}
+
+void Broker::route(const std::string& topic, const uint8_t* payload, size_t size, uint8_t qos)
+{
+    size_t sessionIndex = 0U;
+
+    for(sessionIndex = 0U; sessionIndex < m_sessions.size(); ++sessionIndex)
+    {
+        BrokerSession&  session     = *m_sessions[sessionIndex];
+        size_t          subIndex    = 0U;
+        bool            isMatching  = false;
+        uint8_t         maxQos      = 0U;
+
+        for(subIndex = 0U; subIndex < session.subscriptions.size(); ++subIndex)
+        {
+            if (true == MqttSession::isTopicMatching(session.subscriptions[subIndex].filter.c_str(), topic.c_str()))
+            {
+                isMatching  = true;
+                maxQos      = (session.subscriptions[subIndex].qos > maxQos) ? session.subscriptions[subIndex].qos : maxQos;
+            }
+        }
+
+        /* A QoS 0 message is not queued for a offline client. */
+        if ((true == isMatching) &&
+            ((true == session.isConnected) || ((0U < qos) && (0U < maxQos))))
+        {
+            BrokerMessage message;
+
+            message.topic       = topic;
+            message.payload.assign(payload, payload + size);
+            message.qos         = (qos < maxQos) ? qos : maxQos;
+            message.packetId    = 0U;
+            message.isSent      = false;
+
+            session.outbox.push_back(message);
+            flush(session);
+        }
+    }
+
+    return;
+}
+
+void Broker::flush(BrokerSession& session)
+{
+    std::deque<BrokerMessage>::iterator it = session.outbox.begin();
+
+    while((true == session.isConnected) && (session.outbox.end() != it))
+    {
+        if (true == it->isSent)
+        {
+            ++it;
+        }
+        else
+        {
+            std::vector<uint8_t>    body;
+            uint8_t                 header  = 0x30U | static_cast<uint8_t>(it->qos << 1U);
+
+            putString(body, it->topic);
+
+            if (0U < it->qos)
+            {
+                /* A message, which was already sent, is marked as duplicate. */
+                if (0U == it->packetId)
+                {
+                    it->packetId = session.nextPacketId;
+                    ++session.nextPacketId;
+
+                    if (0U == session.nextPacketId)
+                    {
+                        session.nextPacketId = 1U;
+                    }
+                }
+                else
+                {
+                    header |= 0x08U;
+                }
+
+                body.push_back(static_cast<uint8_t>(it->packetId >> 8U));
+                body.push_back(static_cast<uint8_t>(it->packetId & 0xFFU));
+            }
+
+            body.insert(body.end(), it->payload.begin(), it->payload.end());
+            putPacket(*session.tx, header, body);
+
+            if (0U == it->qos)
+            {
+                it = session.outbox.erase(it);
+            }
+            else
+            {
+                it->isSent = true;
+                ++it;
+            }
+        }
+    }
+
+    return;
+}
+
+bool Client::connect(uint16_t keepAlive, bool cleanSession)
+{
+    m_isConnAck         = false;
+    m_isSessionPresent  = false;
+
+    if (true == m_session.begin(m_clientId, "", "", keepAlive, cleanSession))
+    {
+        (void)deliver(0U);
+    }
+
+    return (true == m_isConnAck) && (MqttSession::STATE_CONNECTED == m_session.getState());
+}
+
+void Client::disconnect()
+{
+    m_session.end(true);
+    m_broker.disconnect(m_connection);
+
+    return;
+}
+
+bool Client::deliver(size_t maxChunk)
+{
+    bool isDelivered = false;
+
+    while(false == m_connection.tx.empty())
+    {
+        std::vector<uint8_t>    stream;
+        size_t                  index   = 0U;
+
+        /* The session may send while receiving, which appends to the stream. */
+        stream.swap(m_connection.tx);
+
+        while(index < stream.size())
+        {
+            size_t chunk = stream.size() - index;
+
+            if ((0U < maxChunk) &&
+                (maxChunk < chunk))
+            {
+                chunk = 1U + (static_cast<size_t>(rand()) % maxChunk);
+            }
+
+            if (false == m_session.receive(&stream[index], chunk))
+            {
+                ++m_errors;
+            }
+
+            index += chunk;
+        }
+
+        isDelivered = true;
+    }
+
+    return isDelivered;
+}
+
+size_t Client::sessionSend(void* arg, const uint8_t* data, size_t size)
+{
+    Client* client = static_cast<Client*>(arg);
+
+    if (false == client->m_broker.receive(client->m_connection, data, size))
+    {
+        ++client->m_errors;
+    }
+
+    return size;
+}
+
+void Client::sessionConnAck(void* arg, bool isSessionPresent)
+{
+    Client* client = static_cast<Client*>(arg);
+
+    client->m_isConnAck         = true;
+    client->m_isSessionPresent  = isSessionPresent;
+
+    return;
+}
+
+void Client::sessionMessage(void* arg, const char* topic, const uint8_t* payload, size_t size)
+{
+    Client* client = static_cast<Client*>(arg);
+    char    expectedTopic[32U];
+    char    expectedPayload[PAYLOAD_SIZE];
+
+    (void)snprintf(expectedTopic, sizeof(expectedTopic), "bench/%u/value", client->m_received % 4U);
+    buildPayload(client->m_received, expectedPayload, sizeof(expectedPayload));
+
+    if ((0 != strcmp(expectedTopic, topic)) ||
+        (sizeof(expectedPayload) != size) ||
+        (0 != memcmp(expectedPayload, payload, size)))
+    {
+        ++client->m_errors;
+    }
+
+    ++client->m_received;
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+bool MqttBenchmark::run(uint32_t messages)
+{
+    bool    isSuccessful    = (0U < messages);
+    uint8_t index           = 0U;
+
+    /* The fragments are random, but the same in every run. */
+    srand(1U);
+
+    if (true == isSuccessful)
+    {
+        printf("Messages: %u per scenario, payload %zu byte\n", messages, PAYLOAD_SIZE);
+        printf("%-18s %8s %8s %7s %10s %10s %12s\n",
+            "Scenario", "Sent", "Received", "Errors", "Avg [us]", "Max [us]", "Messages/s");
+    }
+
+    for(index = 0U; (index < (sizeof(SCENARIOS) / sizeof(SCENARIOS[0U]))) && (true == isSuccessful); ++index)
+    {
+        isSuccessful = runScenario(SCENARIOS[index], messages);
+    }
+
+    if (true == isSuccessful)
+    {
+        isSuccessful = runPersistentSession(messages);
+    }
+
+    if (true == isSuccessful)
+    {
+        isSuccessful = runKeepAlive();
+    }
+
+    return isSuccessful;
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Put the remaining length of a packet.
+ *
+ * @param[out]  buffer  Buffer with at least 4 bytes
+ * @param[in]   length  Remaining length
+ *
+ * @return Number of bytes
+ */
+static size_t putLength(uint8_t* buffer, size_t length)
+{
+    size_t count = 0U;
+
+    do
+    {
+        uint8_t value = static_cast<uint8_t>(length & 0x7FU);
+
+        length >>= 7U;
+
+        if (0U < length)
+        {
+            value |= 0x80U;
+        }
+
+        buffer[count] = value;
+        ++count;
+    }
+    while(0U < length);
+
+    return count;
+}
+
+/**
+ * Append a packet to a stream.
+ *
+ * @param[in,out]   stream  Stream
+ * @param[in]       header  Fixed header byte
+ * @param[in]       body    Variable header and payload
+ */
+static void putPacket(std::vector<uint8_t>& stream, uint8_t header, const std::vector<uint8_t>& body)
+{
+    uint8_t length[4U];
+    size_t  count   = putLength(length, body.size());
+
+    stream.push_back(header);
+    stream.insert(stream.end(), length, length + count);
+    stream.insert(stream.end(), body.begin(), body.end());
+
+    return;
+}
+
+/**
+ * Append a string with length prefix.
+ *
+ * @param[in,out]   body    Packet body
+ * @param[in]       str     String
+ */
+static void putString(std::vector<uint8_t>& body, const std::string& str)
+{
+    body.push_back(static_cast<uint8_t>(str.size() >> 8U));
+    body.push_back(static_cast<uint8_t>(str.size() & 0xFFU));
+    body.insert(body.end(), str.begin(), str.end());
+
+    return;
+}
+
+/**
+ * Get a string with length prefix.
+ *
+ * @param[in]       body    Packet body
+ * @param[in]       length  Packet body length in byte
+ * @param[in,out]   index   Index of the string, afterwards behind it
+ * @param[out]      str     String
+ *
+ * @return If the string is complete, it will return true otherwise false.
+ */
+static bool getString(const uint8_t* body, size_t length, size_t& index, std::string& str)
+{
+    bool isValid = false;
+
+    if ((index + 2U) <= length)
+    {
+        size_t strLength = (static_cast<size_t>(body[index]) << 8U) | body[index + 1U];
+
+        if ((index + 2U + strLength) <= length)
+        {
+            str.assign(reinterpret_cast<const char*>(&body[index + 2U]), strLength);
+            index   += 2U + strLength;
+            isValid  = true;
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * Build the payload of a message. It is not terminated.
+ *
+ * @param[in]   sequence    Sequence number of the message
+ * @param[out]  payload     Payload
+ * @param[in]   size        Payload size in byte
+ */
+static void buildPayload(uint32_t sequence, char* payload, size_t size)
+{
+    char    buffer[PAYLOAD_SIZE + 1U];
+    size_t  index   = 0U;
+
+    (void)snprintf(buffer, sizeof(buffer), "{\"seq\":%u,\"value\":%u}", sequence, sequence * 7U);
+
+    for(index = strlen(buffer); index < size; ++index)
+    {
+        buffer[index] = ' ';
+    }
+
+    memcpy(payload, buffer, size);
+
+    return;
+}
+
+/**
+ * Deliver the streams of two clients, until there is nothing more to
+ * deliver.
+ *
+ * @param[in] first     First client
+ * @param[in] second    Second client
+ * @param[in] maxChunk  Max. fragment size in byte. 0 delivers all at once.
+ *
+ * @return If both clients have no errors, it will return true otherwise false.
+ */
+static bool deliverAll(Client& first, Client& second, size_t maxChunk)
+{
+    bool isDelivered = true;
+
+    while(true == isDelivered)
+    {
+        isDelivered = first.deliver(maxChunk);
+
+        if (true == second.deliver(maxChunk))
+        {
+            isDelivered = true;
+        }
+    }
+
+    return (0U == first.getErrors()) && (0U == second.getErrors());
+}
+
+/**
+ * Run a benchmark scenario. Every message is published and delivered to the
+ * subscriber, before the next message is published. The measured time is
+ * from publishing until the subscriber got it, including the acknowledges.
+ *
+ * @param[in] scenario  Scenario
+ * @param[in] messages  Number of messages
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+static bool runScenario(const Scenario& scenario, uint32_t messages)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Broker      broker;
+    Client      publisher(broker, "publisher");
+    Client      subscriber(broker, "subscriber");
+    uint32_t    sent            = 0U;
+    uint64_t    sum             = 0U;
+    uint64_t    max             = 0U;
+    bool        isSuccessful    = true;
+    uint32_t    sequence        = 0U;
+
+    if ((false == publisher.connect(0U, true)) ||
+        (false == subscriber.connect(0U, true)) ||
+        (false == subscriber.getSession().subscribe(TOPIC_FILTER, scenario.qos)) ||
+        (false == deliverAll(publisher, subscriber, scenario.maxChunk)))
+    {
+        printf("%-18s connection failed.\n", scenario.name);
+        isSuccessful = false;
+    }
+
+    for(sequence = 0U; (sequence < messages) && (true == isSuccessful); ++sequence)
+    {
+        char                topic[32U];
+        char                payload[PAYLOAD_SIZE];
+        Clock::time_point   start;
+        uint64_t            duration    = 0U;
+
+        (void)snprintf(topic, sizeof(topic), "bench/%u/value", sequence % 4U);
+        buildPayload(sequence, payload, sizeof(payload));
+
+        start = Clock::now();
+
+        if (true == publisher.getSession().publish(topic, reinterpret_cast<const uint8_t*>(payload), sizeof(payload), scenario.qos, false))
+        {
+            ++sent;
+        }
+
+        if (false == deliverAll(publisher, subscriber, scenario.maxChunk))
+        {
+            isSuccessful = false;
+        }
+
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+        sum += duration;
+        max  = (duration > max) ? duration : max;
+    }
+
+    if (true == isSuccessful)
+    {
+        /* All messages shall be received and acknowledged. */
+        if ((messages != sent) ||
+            (messages != subscriber.getReceived()) ||
+            (0U != publisher.getSession().getInflightCount()) ||
+            (0U != subscriber.getErrors()))
+        {
+            isSuccessful = false;
+        }
+
+        printf("%-18s %8u %8u %7u %10.2f %10llu %12.0f\n",
+            scenario.name,
+            sent,
+            subscriber.getReceived(),
+            subscriber.getErrors(),
+            static_cast<double>(sum) / messages,
+            static_cast<unsigned long long>(max),
+            (0U < sum) ? ((static_cast<double>(messages) * 1000000.0) / sum) : 0.0);
+    }
+
+    return isSuccessful;
+}
+
+/**
+ * The subscriber uses a persistent session and goes offline. The broker
+ * shall queue the QoS 1 messages and deliver all of them after the
+ * reconnect, without subscribing again.
+ *
+ * @param[in] messages  Number of messages, limited to MAX_OFFLINE.
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+static bool runPersistentSession(uint32_t messages)
+{
+    Broker      broker;
+    Client      publisher(broker, "publisher");
+    Client      subscriber(broker, "subscriber");
+    uint32_t    offline         = (MAX_OFFLINE < messages) ? MAX_OFFLINE : messages;
+    uint32_t    sequence        = 0U;
+    bool        isSuccessful    = true;
+
+    if ((false == publisher.connect(0U, true)) ||
+        (false == subscriber.connect(0U, false)) ||
+        (false == subscriber.getSession().subscribe(TOPIC_FILTER, MqttSession::QOS_1)) ||
+        (false == deliverAll(publisher, subscriber, 0U)))
+    {
+        isSuccessful = false;
+    }
+    else
+    {
+        subscriber.disconnect();
+    }
+
+    for(sequence = 0U; (sequence < offline) && (true == isSuccessful); ++sequence)
+    {
+        char topic[32U];
+        char payload[PAYLOAD_SIZE];
+
+        (void)snprintf(topic, sizeof(topic), "bench/%u/value", sequence % 4U);
+        buildPayload(sequence, payload, sizeof(payload));
+
+        if ((false == publisher.getSession().publish(topic, reinterpret_cast<const uint8_t*>(payload), sizeof(payload), MqttSession::QOS_1, false)) ||
+            (false == deliverAll(publisher, subscriber, 0U)))
+        {
+            isSuccessful = false;
+        }
+    }
+
+    /* The queued messages are delivered directly after the connection acknowledge. */
+    if ((true == isSuccessful) &&
+        ((false == subscriber.connect(0U, false)) ||
+         (false == deliverAll(publisher, subscriber, 0U)) ||
+         (false == subscriber.isSessionPresent()) ||
+         (offline != subscriber.getReceived())))
+    {
+        isSuccessful = false;
+    }
+
+    printf("%-18s %8u %8u %7u %s\n",
+        "Persistent session",
+        offline,
+        subscriber.getReceived(),
+        subscriber.getErrors(),
+        (true == isSuccessful) ? "ok" : "failed");
+
+    return isSuccessful;
+}
+
+/**
+ * The session shall send a ping after the keep alive period and shall
+ * detect a missing ping response. The time is simulated.
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+static bool runKeepAlive()
+{
+    const uint16_t          KEEP_ALIVE      = 10U;
+    const uint64_t          PERIOD          = static_cast<uint64_t>(KEEP_ALIVE) * 1000000U;
+    VirtualClock&           clock           = VirtualClock::getInstance();
+    VirtualClock::Mode      mode            = clock.getMode();
+    Broker                  broker;
+    Client                  client(broker, "client");
+    bool                    isSuccessful    = true;
+
+    clock.setMode(VirtualClock::MODE_VIRTUAL);
+
+    if (false == client.connect(KEEP_ALIVE, true))
+    {
+        isSuccessful = false;
+    }
+
+    /* No ping within the keep alive period. */
+    if (true == isSuccessful)
+    {
+        clock.advanceTo(clock.getMicros() + PERIOD - 1000U);
+        isSuccessful = (true == client.getSession().process()) && (0U == broker.getPings());
+    }
+
+    /* Ping after the keep alive period, which is answered. */
+    if (true == isSuccessful)
+    {
+        clock.advanceTo(clock.getMicros() + 1000U);
+        isSuccessful = (true == client.getSession().process()) && (1U == broker.getPings());
+        (void)client.deliver(0U);
+    }
+
+    /* The next ping is not answered. */
+    if (true == isSuccessful)
+    {
+        broker.setPingMuted(true);
+        clock.advanceTo(clock.getMicros() + PERIOD);
+        isSuccessful = (true == client.getSession().process()) && (2U == broker.getPings());
+    }
+
+    /* The missing response is detected after the keep alive period. */
+    if (true == isSuccessful)
+    {
+        clock.advanceTo(clock.getMicros() + PERIOD - 1000U);
+        isSuccessful = (true == client.getSession().process());
+
+        clock.advanceTo(clock.getMicros() + 1000U);
+        isSuccessful = (true == isSuccessful) &&
+                       (false == client.getSession().process()) &&
+                       (MqttSession::STATE_ERROR == client.getSession().getState());
+    }
+
+    clock.setMode(mode);
+
+    printf("%-18s %8u pings %s\n",
+        "Keep alive",
+        broker.getPings(),
+        (true == isSuccessful) ? "ok" : "failed");
+
+    return isSuccessful;
+}
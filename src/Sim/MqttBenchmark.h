@@ -0,0 +1,96 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT session benchmark
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup sim
+ *
+ * @{
+ */
+
+#ifndef __MQTTBENCHMARK_H__
+#define __MQTTBENCHMARK_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The benchmark connects a publishing and a subscribing MQTT session to a
+ * minimal MQTT 3.1.1 broker, which runs in the same process. Like a local
+ * Mosquitto instance, the broker routes the messages, keeps persistent
+ * sessions and answers the pings. The byte streams are exchanged directly,
+ * therefore the results show the cost of the client and not of the network.
+ *
+ * Scenarios:
+ * - QoS 0 and QoS 1 messages, every packet delivered at once.
+ * - QoS 1 messages, delivered in random fragments of a few bytes.
+ * - Persistent session: the subscriber goes offline, the broker queues the
+ *   QoS 1 messages and delivers them after the reconnect.
+ * - Keep alive: the ping is sent in time and a missing ping response is
+ *   detected. The time is simulated with the virtual clock.
+ *
+ * Every received message is checked for the expected topic and payload.
+ */
+namespace MqttBenchmark
+{
+
+/** Default number of messages per scenario. */
+static const uint32_t DEFAULT_MESSAGES  = 10000U;
+
+/**
+ * Run the benchmark and print the results to the standard output.
+ *
+ * @param[in] messages  Number of messages per scenario
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+extern bool run(uint32_t messages);
+
+}
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MQTTBENCHMARK_H__ */
+
+/** @} */
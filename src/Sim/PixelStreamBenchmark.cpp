@@ -0,0 +1,604 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pixel stream receiver benchmark
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "PixelStreamBenchmark.h"
+#include "PixelStreamReceiver.h"
+#include "LedMatrix.h"
+
+#include <Canvas.h>
+#include <VirtualClock.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/** Benchmark scenario */
+typedef struct
+{
+    const char*                         name;       /**< Scenario name */
+    PixelStreamReceiver::Protocol       protocol;   /**< Protocol */
+    bool                                isSync;     /**< Is the frame completed by a synchronization packet? */
+    PixelStreamReceiver::Layout         layout;     /**< Pixel mapping */
+
+} Scenario;
+
+/** Light show controller stand-in, which sends the frames. */
+typedef struct
+{
+    int                 socketFd;   /**< UDP socket */
+    struct sockaddr_in  addr;       /**< Receiver address */
+    uint8_t             sequence;   /**< Sequence number of the last packet */
+    uint32_t            sent;       /**< Number of sent packets */
+
+} Sender;
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static void getPixel(uint32_t frame, uint32_t pixel, uint8_t* rgb);
+static void send(Sender& sender, const std::vector<uint8_t>& packet);
+static void buildDdp(std::vector<uint8_t>& packet, uint8_t sequence, uint32_t frame, uint32_t first, uint32_t count, bool isLast);
+static void buildE131(std::vector<uint8_t>& packet, uint8_t sequence, uint16_t universe, uint32_t frame, uint32_t first, uint32_t count, bool isSync);
+static void buildE131Sync(std::vector<uint8_t>& packet, uint8_t sequence);
+static void buildArtNet(std::vector<uint8_t>& packet, uint8_t sequence, uint16_t universe, uint32_t frame, uint32_t first, uint32_t count);
+static void buildArtSync(std::vector<uint8_t>& packet);
+static void sendFrame(const Scenario& scenario, Sender& sender, uint32_t frame, uint32_t pixelCount, bool isLossy, bool isDuplicated);
+static uint32_t verifyFrame(const Scenario& scenario, Canvas& canvas, uint32_t frame);
+static bool runScenario(const Scenario& scenario, uint32_t frames);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Every n-th frame, the last data packet is not sent. */
+static const uint32_t   LOSS_PERIOD         = 16U;
+
+/** Every n-th frame, the first data packet is sent twice. */
+static const uint32_t   DUPLICATE_PERIOD    = 20U;
+
+/** First universe */
+static const uint16_t   UNIVERSE            = 1U;
+
+/** Benchmark scenarios */
+static const Scenario   SCENARIOS[]         =
+{
+    { "DDP",            PixelStreamReceiver::PROTOCOL_DDP,      false,  PixelStreamReceiver::LAYOUT_TOPOLOGY    },
+    { "E1.31 sync",     PixelStreamReceiver::PROTOCOL_E131,     true,   PixelStreamReceiver::LAYOUT_TOPOLOGY    },
+    { "E1.31",          PixelStreamReceiver::PROTOCOL_E131,     false,  PixelStreamReceiver::LAYOUT_ROW_MAJOR   },
+    { "Art-Net sync",   PixelStreamReceiver::PROTOCOL_ARTNET,   true,   PixelStreamReceiver::LAYOUT_TOPOLOGY    }
+};
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+bool PixelStreamBenchmark::run(uint32_t frames)
+{
+    bool    isSuccessful    = (0U < frames);
+    uint8_t index           = 0U;
+
+    /* The latency is measured with the receiver timestamps. */
+    VirtualClock::getInstance().setMode(VirtualClock::MODE_REALTIME);
+
+    if (true == isSuccessful)
+    {
+        printf("Frames: %u per scenario\n", frames);
+        printf("%-14s %7s %7s %7s %7s %7s %10s %10s %10s %9s\n",
+            "Scenario", "Shown", "Lost", "Late", "Incompl", "Errors", "Proc [us]", "Avg [us]", "Max [us]", "Packets");
+    }
+
+    for(index = 0U; (index < (sizeof(SCENARIOS) / sizeof(SCENARIOS[0U]))) && (true == isSuccessful); ++index)
+    {
+        isSuccessful = runScenario(SCENARIOS[index], frames);
+    }
+
+    return isSuccessful;
+}
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Get the color of a pixel in a frame.
+ *
+ * @param[in]   frame   Frame number
+ * @param[in]   pixel   Pixel index in the stream
+ * @param[out]  rgb     RGB888 color
+ */
+static void getPixel(uint32_t frame, uint32_t pixel, uint8_t* rgb)
+{
+    rgb[0U] = static_cast<uint8_t>(pixel + frame);
+    rgb[1U] = static_cast<uint8_t>((pixel * 3U) + (frame * 7U));
+    rgb[2U] = static_cast<uint8_t>(frame ^ pixel);
+
+    return;
+}
+
+/**
+ * Send a packet to the receiver.
+ *
+ * @param[in] sender    Sender
+ * @param[in] packet    Packet
+ */
+static void send(Sender& sender, const std::vector<uint8_t>& packet)
+{
+    if (0 < sendto(sender.socketFd, packet.data(), packet.size(), 0, reinterpret_cast<const struct sockaddr*>(&sender.addr), sizeof(sender.addr)))
+    {
+        ++sender.sent;
+    }
+
+    return;
+}
+
+/**
+ * Build a DDP packet.
+ *
+ * @param[out]  packet      Packet
+ * @param[in]   sequence    Sequence number [1; 15]
+ * @param[in]   frame       Frame number
+ * @param[in]   first       First pixel
+ * @param[in]   count       Number of pixels
+ * @param[in]   isLast      Is it the last packet of the frame?
+ */
+static void buildDdp(std::vector<uint8_t>& packet, uint8_t sequence, uint32_t frame, uint32_t first, uint32_t count, bool isLast)
+{
+    const size_t    HEADER_SIZE = 10U;
+    uint32_t        offset      = first * 3U;
+    uint32_t        length      = count * 3U;
+    uint32_t        pixel       = 0U;
+
+    packet.assign(HEADER_SIZE + length, 0U);
+
+    packet[0U] = (true == isLast) ? 0x41U : 0x40U;
+    packet[1U] = sequence;
+    packet[2U] = 0x0BU;
+    packet[3U] = 1U;
+    packet[4U] = static_cast<uint8_t>(offset >> 24U);
+    packet[5U] = static_cast<uint8_t>(offset >> 16U);
+    packet[6U] = static_cast<uint8_t>(offset >> 8U);
+    packet[7U] = static_cast<uint8_t>(offset);
+    packet[8U] = static_cast<uint8_t>(length >> 8U);
+    packet[9U] = static_cast<uint8_t>(length);
+
+    for(pixel = 0U; pixel < count; ++pixel)
+    {
+        getPixel(frame, first + pixel, &packet[HEADER_SIZE + (pixel * 3U)]);
+    }
+
+    return;
+}
+
+/**
+ * Build a E1.31 data packet.
+ *
+ * @param[out]  packet      Packet
+ * @param[in]   sequence    Sequence number
+ * @param[in]   universe    Universe
+ * @param[in]   frame       Frame number
+ * @param[in]   first       First pixel
+ * @param[in]   count       Number of pixels
+ * @param[in]   isSync      Shall the receiver wait for a synchronization packet?
+ */
+static void buildE131(std::vector<uint8_t>& packet, uint8_t sequence, uint16_t universe, uint32_t frame, uint32_t first, uint32_t count, bool isSync)
+{
+    const size_t    HEADER_SIZE = 126U;
+    const uint8_t   ACN_ID[]    = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0U, 0U, 0U };
+    uint16_t        length      = static_cast<uint16_t>(count * 3U);
+    uint16_t        size        = static_cast<uint16_t>(HEADER_SIZE + length);
+    uint32_t        pixel       = 0U;
+
+    packet.assign(size, 0U);
+
+    /* Root layer */
+    packet[1U]      = 0x10U;
+    memcpy(&packet[4U], ACN_ID, sizeof(ACN_ID));
+    packet[16U]     = static_cast<uint8_t>(0x70U | ((size - 16U) >> 8U));
+    packet[17U]     = static_cast<uint8_t>(size - 16U);
+    packet[21U]     = 0x04U;
+
+    /* Framing layer */
+    packet[38U]     = static_cast<uint8_t>(0x70U | ((size - 38U) >> 8U));
+    packet[39U]     = static_cast<uint8_t>(size - 38U);
+    packet[43U]     = 0x02U;
+    memcpy(&packet[44U], "PIXELIX benchmark", 17U);
+    packet[108U]    = 100U;
+    packet[110U]    = (true == isSync) ? 1U : 0U;
+    packet[111U]    = sequence;
+    packet[113U]    = static_cast<uint8_t>(universe >> 8U);
+    packet[114U]    = static_cast<uint8_t>(universe);
+
+    /* DMP layer */
+    packet[115U]    = static_cast<uint8_t>(0x70U | ((size - 115U) >> 8U));
+    packet[116U]    = static_cast<uint8_t>(size - 115U);
+    packet[117U]    = 0x02U;
+    packet[118U]    = 0xA1U;
+    packet[122U]    = 0x01U;
+    packet[123U]    = static_cast<uint8_t>((length + 1U) >> 8U);
+    packet[124U]    = static_cast<uint8_t>(length + 1U);
+
+    for(pixel = 0U; pixel < count; ++pixel)
+    {
+        getPixel(frame, first + pixel, &packet[HEADER_SIZE + (pixel * 3U)]);
+    }
+
+    return;
+}
+
+/**
+ * Build a E1.31 synchronization packet.
+ *
+ * @param[out]  packet      Packet
+ * @param[in]   sequence    Sequence number
+ */
+static void buildE131Sync(std::vector<uint8_t>& packet, uint8_t sequence)
+{
+    const size_t    SIZE        = 49U;
+    const uint8_t   ACN_ID[]    = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0U, 0U, 0U };
+
+    packet.assign(SIZE, 0U);
+
+    /* Root layer */
+    packet[1U]  = 0x10U;
+    memcpy(&packet[4U], ACN_ID, sizeof(ACN_ID));
+    packet[16U] = 0x70U;
+    packet[17U] = static_cast<uint8_t>(SIZE - 16U);
+    packet[21U] = 0x08U;
+
+    /* Framing layer */
+    packet[38U] = 0x70U;
+    packet[39U] = static_cast<uint8_t>(SIZE - 38U);
+    packet[43U] = 0x01U;
+    packet[44U] = sequence;
+    packet[46U] = 1U;
+
+    return;
+}
+
+/**
+ * Build a ArtDmx packet.
+ *
+ * @param[out]  packet      Packet
+ * @param[in]   sequence    Sequence number [1; 255]
+ * @param[in]   universe    Universe
+ * @param[in]   frame       Frame number
+ * @param[in]   first       First pixel
+ * @param[in]   count       Number of pixels
+ */
+static void buildArtNet(std::vector<uint8_t>& packet, uint8_t sequence, uint16_t universe, uint32_t frame, uint32_t first, uint32_t count)
+{
+    const size_t    HEADER_SIZE = 18U;
+    uint16_t        length      = static_cast<uint16_t>(count * 3U);
+    uint32_t        pixel       = 0U;
+
+    packet.assign(HEADER_SIZE + length, 0U);
+
+    memcpy(&packet[0U], "Art-Net", 8U);
+    packet[9U]  = 0x50U;
+    packet[11U] = 14U;
+    packet[12U] = sequence;
+    packet[14U] = static_cast<uint8_t>(universe);
+    packet[15U] = static_cast<uint8_t>(universe >> 8U);
+    packet[16U] = static_cast<uint8_t>(length >> 8U);
+    packet[17U] = static_cast<uint8_t>(length);
+
+    for(pixel = 0U; pixel < count; ++pixel)
+    {
+        getPixel(frame, first + pixel, &packet[HEADER_SIZE + (pixel * 3U)]);
+    }
+
+    return;
+}
+
+/**
+ * Build a ArtSync packet.
+ *
+ * @param[out]  packet      Packet
+ */
+static void buildArtSync(std::vector<uint8_t>& packet)
+{
+    packet.assign(14U, 0U);
+
+    memcpy(&packet[0U], "Art-Net", 8U);
+    packet[9U]  = 0x52U;
+    packet[11U] = 14U;
+
+    return;
+}
+
+/**
+ * Send a frame. It is split in packets of one universe.
+ *
+ * @param[in] scenario      Scenario
+ * @param[in] sender        Sender
+ * @param[in] frame         Frame number
+ * @param[in] pixelCount    Number of pixels
+ * @param[in] isLossy       Shall the last data packet be lost?
+ * @param[in] isDuplicated  Shall the first data packet be sent twice?
+ */
+static void sendFrame(const Scenario& scenario, Sender& sender, uint32_t frame, uint32_t pixelCount, bool isLossy, bool isDuplicated)
+{
+    std::vector<uint8_t>    packet;
+    uint32_t                first   = 0U;
+    uint16_t                index   = 0U;
+
+    while(pixelCount > first)
+    {
+        uint32_t    count   = pixelCount - first;
+        bool        isLast  = false;
+
+        if (PixelStreamReceiver::PIXELS_PER_UNIVERSE < count)
+        {
+            count = PixelStreamReceiver::PIXELS_PER_UNIVERSE;
+        }
+
+        isLast = (pixelCount == (first + count));
+
+        switch(scenario.protocol)
+        {
+        case PixelStreamReceiver::PROTOCOL_DDP:
+            sender.sequence = (15U <= sender.sequence) ? 1U : (sender.sequence + 1U);
+            buildDdp(packet, sender.sequence, frame, first, count, isLast);
+            break;
+
+        case PixelStreamReceiver::PROTOCOL_E131:
+            buildE131(packet, static_cast<uint8_t>(frame), UNIVERSE + index, frame, first, count, scenario.isSync);
+            break;
+
+        case PixelStreamReceiver::PROTOCOL_ARTNET:
+            buildArtNet(packet, static_cast<uint8_t>((frame % 255U) + 1U), UNIVERSE + index, frame, first, count);
+            break;
+
+        default:
+            break;
+        }
+
+        if ((false == isLast) ||
+            (false == isLossy))
+        {
+            send(sender, packet);
+        }
+
+        if ((0U == first) &&
+            (true == isDuplicated))
+        {
+            send(sender, packet);
+        }
+
+        first += count;
+        ++index;
+    }
+
+    if (true == scenario.isSync)
+    {
+        if (PixelStreamReceiver::PROTOCOL_E131 == scenario.protocol)
+        {
+            buildE131Sync(packet, static_cast<uint8_t>(frame));
+        }
+        else
+        {
+            buildArtSync(packet);
+        }
+
+        send(sender, packet);
+    }
+
+    return;
+}
+
+/**
+ * Verify the drawn frame.
+ *
+ * @param[in] scenario  Scenario
+ * @param[in] canvas    Canvas with the drawn frame
+ * @param[in] frame     Frame number
+ *
+ * @return Number of wrong pixels
+ */
+static uint32_t verifyFrame(const Scenario& scenario, Canvas& canvas, uint32_t frame)
+{
+    LedMatrix&  matrix  = LedMatrix::getInstance();
+    uint32_t    errors  = 0U;
+    int16_t     x       = 0;
+    int16_t     y       = 0;
+
+    for(y = 0; y < canvas.getHeight(); ++y)
+    {
+        for(x = 0; x < canvas.getWidth(); ++x)
+        {
+            uint32_t    pixel   = static_cast<uint32_t>(y) * canvas.getWidth() + x;
+            Color       color   = canvas.getColor(x, y);
+            uint8_t     rgb[3U];
+
+            if (PixelStreamReceiver::LAYOUT_TOPOLOGY == scenario.layout)
+            {
+                pixel = matrix.getStripIndex(x, y);
+            }
+
+            getPixel(frame, pixel, rgb);
+
+            if ((rgb[0U] != color.getRed()) ||
+                (rgb[1U] != color.getGreen()) ||
+                (rgb[2U] != color.getBlue()))
+            {
+                ++errors;
+            }
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * Run a single scenario and print the result.
+ *
+ * @param[in] scenario  Scenario
+ * @param[in] frames    Number of frames
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+static bool runScenario(const Scenario& scenario, uint32_t frames)
+{
+    const uint16_t                  PORTS[PixelStreamReceiver::PROTOCOL_MAX] =
+    {
+        PixelStreamReceiver::DDP_PORT,
+        PixelStreamReceiver::E131_PORT,
+        PixelStreamReceiver::ARTNET_PORT
+    };
+    LedMatrix&                      matrix          = LedMatrix::getInstance();
+    uint32_t                        pixelCount      = static_cast<uint32_t>(matrix.getWidth()) * matrix.getHeight();
+    PixelStreamReceiver*            receiver        = new PixelStreamReceiver();
+    Canvas                          canvas(matrix.getWidth(), matrix.getHeight(), 0, 0, true);
+    Sender                          sender;
+    PixelStreamReceiver::Statistics statistics;
+    uint32_t                        lost            = 0U;
+    uint32_t                        duplicated      = 0U;
+    uint32_t                        errors          = 0U;
+    uint64_t                        processTime     = 0U;
+    uint32_t                        frame           = 0U;
+    bool                            isSuccessful    = false;
+
+    sender.socketFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sender.sequence = 0U;
+    sender.sent     = 0U;
+
+    memset(&sender.addr, 0, sizeof(sender.addr));
+    sender.addr.sin_family      = AF_INET;
+    sender.addr.sin_port        = htons(PORTS[scenario.protocol]);
+    sender.addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((nullptr != receiver) &&
+        (0 <= sender.socketFd) &&
+        (true == receiver->begin(matrix.getWidth(), matrix.getHeight(), UNIVERSE, scenario.layout)))
+    {
+        isSuccessful = true;
+
+        for(frame = 0U; frame < frames; ++frame)
+        {
+            /* The loss is detected by the next frame, therefore never in the last one. */
+            bool isLossy        = ((LOSS_PERIOD - 1U) == (frame % LOSS_PERIOD)) && ((frame + 1U) < frames);
+            bool isDuplicated   = ((DUPLICATE_PERIOD - 1U) == (frame % DUPLICATE_PERIOD));
+
+            std::chrono::steady_clock::time_point begin;
+
+            sendFrame(scenario, sender, frame, pixelCount, isLossy, isDuplicated);
+
+            begin = std::chrono::steady_clock::now();
+            receiver->process();
+            (void)receiver->draw(canvas);
+            processTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+            if (true == isLossy)
+            {
+                ++lost;
+            }
+            /* A frame with a lost packet is not verified. */
+            else
+            {
+                errors += verifyFrame(scenario, canvas, frame);
+            }
+
+            if (true == isDuplicated)
+            {
+                ++duplicated;
+            }
+        }
+
+        receiver->getStatistics(statistics);
+
+        printf("%-14s %7u %7u %7u %7u %7u %10.1f %10u %10u %9u\n",
+            scenario.name,
+            statistics.frames,
+            statistics.lostPackets,
+            statistics.outOfOrderPackets,
+            statistics.incompleteFrames,
+            errors,
+            static_cast<double>(processTime) / frames,
+            statistics.avgLatency,
+            statistics.maxLatency,
+            sender.sent);
+
+        if ((0U != errors) ||
+            (lost != statistics.lostPackets) ||
+            (duplicated != statistics.outOfOrderPackets) ||
+            (0U != statistics.invalidPackets) ||
+            (sender.sent != (statistics.packets)))
+        {
+            printf("%-14s failed, expected %u lost and %u late packets.\n", scenario.name, lost, duplicated);
+            isSuccessful = false;
+        }
+    }
+    else
+    {
+        printf("%-14s failed to start.\n", scenario.name);
+    }
+
+    if (0 <= sender.socketFd)
+    {
+        (void)close(sender.socketFd);
+    }
+
+    delete receiver;
+
+    return isSuccessful;
+}
@@ -0,0 +1,96 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Pixel stream receiver benchmark
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup sim
+ *
+ * @{
+ */
+
+#ifndef __PIXELSTREAMBENCHMARK_H__
+#define __PIXELSTREAMBENCHMARK_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The benchmark sends frames via UDP on the local host to the pixel stream
+ * receiver, like a light show controller does. Per scenario one protocol is
+ * used:
+ * - DDP, the last packet of a frame has the push flag.
+ * - E1.31 with synchronization packets.
+ * - E1.31 without synchronization.
+ * - Art-Net with ArtSync.
+ *
+ * Periodically the last data packet of a frame is not sent and a packet is
+ * sent twice. The receiver shall detect exactly these lost and duplicated
+ * packets. After every frame the receiver processes the packets and draws
+ * the frame, which is compared with the sent one.
+ *
+ * The processing time per frame is measured, as well as the latency from
+ * the first received packet of a frame until it is drawn.
+ */
+namespace PixelStreamBenchmark
+{
+
+/** Default number of frames per scenario. */
+static const uint32_t DEFAULT_FRAMES    = 1000U;
+
+/**
+ * Run the benchmark and print the results to the standard output.
+ *
+ * @param[in] frames    Number of frames per scenario
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+extern bool run(uint32_t frames);
+
+}
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __PIXELSTREAMBENCHMARK_H__ */
+
+/** @} */
@@ -0,0 +1,518 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Headless host simulation of the display pipeline
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * The display manager, the fade effects and the plugins, which don't need
+ * any network, run on the host against a virtual LED matrix. Time is virtual
+ * per default, which means a 30 s run takes only as long as the pure
+ * processing. Together with a seeded random number generator every run
+ * produces exactly the same frames, which can be diffed.
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <Arduino.h>
+#include <VirtualClock.h>
+#include <Logging.h>
+#include <LogSinkPrinter.h>
+#include <ArduinoJson.h>
+#include <getopt.h>
+#include <vector>
+
+#include "DisplayMgr.h"
+#include "PluginFactory.h"
+#include "FrameRecorder.h"
+#include "HttpRspBenchmark.h"
+#include "TlsBenchmark.h"
+#include "PixelStreamBenchmark.h"
+#include "MqttBenchmark.h"
+
+#include "FirePlugin.h"
+#include "GameOfLifePlugin.h"
+#include "JustTextPlugin.h"
+#include "RainbowPlugin.h"
+#include "SysMsgPlugin.h"
+#include "TestPlugin.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Prints to the standard output.
+ */
+class StdOutPrinter : public Print
+{
+public:
+
+    /**
+     * Constructs the printer.
+     */
+    StdOutPrinter()
+    {
+    }
+
+    /**
+     * Destroys the printer.
+     */
+    ~StdOutPrinter()
+    {
+    }
+
+    /**
+     * Write a single byte.
+     *
+     * @param[in] data  Byte
+     *
+     * @return Number of written bytes.
+     */
+    size_t write(uint8_t data) final
+    {
+        return (EOF == putchar(data)) ? 0U : 1U;
+    }
+};
+
+/** Simulation configuration */
+typedef struct
+{
+    uint32_t                duration;       /**< Simulation duration in ms */
+    unsigned long           seed;           /**< Random number generator seed */
+    String                  plugins;        /**< Comma separated list of plugin names */
+    uint32_t                slotDuration;   /**< Slot duration in ms */
+    DisplayMgr::FadeEffect  fadeEffect;     /**< Fade effect */
+    const char*             outputPath;     /**< Output directory */
+    FrameRecorder::Format   format;         /**< Frame output format */
+    bool                    isRealtime;     /**< Run in realtime or in virtual time */
+    const char*             text;           /**< Text for the JustTextPlugin */
+    size_t                  benchmarkSize;  /**< HTTP response benchmark payload size in byte, 0 for simulation */
+    uint32_t                tlsConnections; /**< TLS handshake benchmark connections per scenario, 0 for simulation */
+    uint32_t                streamFrames;   /**< Pixel stream benchmark frames per scenario, 0 for simulation */
+    uint32_t                mqttMessages;   /**< MQTT benchmark messages per scenario, 0 for simulation */
+
+} SimConfig;
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static void showUsage(const char* progName);
+static bool parseArgs(int argc, char** argv, SimConfig& cfg);
+static void installPlugins(PluginFactory& factory, const SimConfig& cfg, std::vector<IPluginMaintenance*>& plugins);
+static void uninstallPlugins(PluginFactory& factory, std::vector<IPluginMaintenance*>& plugins);
+
+/******************************************************************************
+ * Variables
+ *****************************************************************************/
+
+/** Standard output printer */
+static StdOutPrinter    gStdOutPrinter;
+
+/** Standard output log sink */
+static LogSinkPrinter   gLogSinkStdOut("StdOut", &gStdOutPrinter);
+
+/** Default simulation duration in ms */
+static const uint32_t   DEFAULT_DURATION        = 30000U;
+
+/** Default random number generator seed */
+static const uint32_t   DEFAULT_SEED            = 1U;
+
+/** Default slot duration in ms */
+static const uint32_t   DEFAULT_SLOT_DURATION   = 5000U;
+
+/** Default plugins, which are installed. */
+static const char*      DEFAULT_PLUGINS         = "FirePlugin,GameOfLifePlugin,JustTextPlugin,RainbowPlugin,TestPlugin";
+
+/******************************************************************************
+ * External functions
+ *****************************************************************************/
+
+/**
+ * Program entry point.
+ *
+ * @param[in] argc  Number of arguments
+ * @param[in] argv  Arguments
+ *
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    int                                 status      = 0;
+    SimConfig                           cfg;
+    PluginFactory                       factory;
+    FrameRecorder                       recorder;
+    std::vector<IPluginMaintenance*>    plugins;
+
+    cfg.duration        = DEFAULT_DURATION;
+    cfg.seed            = DEFAULT_SEED;
+    cfg.plugins         = DEFAULT_PLUGINS;
+    cfg.slotDuration    = DEFAULT_SLOT_DURATION;
+    cfg.fadeEffect      = DisplayMgr::FADE_EFFECT_LINEAR;
+    cfg.outputPath      = ".";
+    cfg.format          = FrameRecorder::FORMAT_PPM;
+    cfg.isRealtime      = false;
+    cfg.text            = nullptr;
+    cfg.benchmarkSize   = 0U;
+    cfg.tlsConnections  = 0U;
+    cfg.streamFrames    = 0U;
+    cfg.mqttMessages    = 0U;
+
+    if (false == parseArgs(argc, argv, cfg))
+    {
+        showUsage(argv[0]);
+        status = 1;
+    }
+    else if (0U < cfg.benchmarkSize)
+    {
+        if (false == HttpRspBenchmark::run(cfg.benchmarkSize, HttpRspBenchmark::DEFAULT_ITERATIONS))
+        {
+            status = 1;
+        }
+    }
+    else if (0U < cfg.tlsConnections)
+    {
+        if (false == TlsBenchmark::run(cfg.tlsConnections))
+        {
+            status = 1;
+        }
+    }
+    else if (0U < cfg.streamFrames)
+    {
+        if (false == PixelStreamBenchmark::run(cfg.streamFrames))
+        {
+            status = 1;
+        }
+    }
+    else if (0U < cfg.mqttMessages)
+    {
+        if (false == MqttBenchmark::run(cfg.mqttMessages))
+        {
+            status = 1;
+        }
+    }
+    else
+    {
+        VirtualClock::getInstance().setMode((true == cfg.isRealtime) ? VirtualClock::MODE_REALTIME : VirtualClock::MODE_VIRTUAL);
+        randomSeed(cfg.seed);
+
+        if (true == Logging::getInstance().registerSink(&gLogSinkStdOut))
+        {
+            (void)Logging::getInstance().selectSink("StdOut");
+        }
+
+        Logging::getInstance().setLogLevel(Logging::LOGLEVEL_INFO);
+
+        factory.registerPlugin("FirePlugin", FirePlugin::create);
+        factory.registerPlugin("GameOfLifePlugin", GameOfLifePlugin::create);
+        factory.registerPlugin("JustTextPlugin", JustTextPlugin::create);
+        factory.registerPlugin("RainbowPlugin", RainbowPlugin::create);
+        factory.registerPlugin("SysMsgPlugin", SysMsgPlugin::create);
+        factory.registerPlugin("TestPlugin", TestPlugin::create);
+
+        if (false == recorder.begin(cfg.outputPath, cfg.format))
+        {
+            status = 1;
+        }
+        else if (false == DisplayMgr::getInstance().begin())
+        {
+            LOG_ERROR("Failed to start display manager.");
+            recorder.end();
+            status = 1;
+        }
+        else
+        {
+            installPlugins(factory, cfg, plugins);
+            DisplayMgr::getInstance().activateNextFadeEffect(cfg.fadeEffect);
+
+            /* Let the display task run. */
+            delay(cfg.duration);
+
+            DisplayMgr::getInstance().end();
+            recorder.end();
+
+            printf("Frames: %u\n", recorder.getFrameCount());
+            printf("Avg. processing time: %u us\n", recorder.getAvgProcessingTime());
+            printf("Max. processing time: %u us\n", recorder.getMaxProcessingTime());
+
+            uninstallPlugins(factory, plugins);
+        }
+    }
+
+    return status;
+}
+
+/******************************************************************************
+ * Local functions
+ *****************************************************************************/
+
+/**
+ * Show program usage.
+ *
+ * @param[in] progName  Program name
+ */
+static void showUsage(const char* progName)
+{
+    printf("Usage: %s [options]\n", progName);
+    printf("  -d <ms>       Simulation duration in ms (default %u).\n", DEFAULT_DURATION);
+    printf("  -s <seed>     Random number generator seed (default %u).\n", DEFAULT_SEED);
+    printf("  -p <plugins>  Comma separated list of plugins (default %s).\n", DEFAULT_PLUGINS);
+    printf("  -t <ms>       Slot duration in ms (default %u).\n", DEFAULT_SLOT_DURATION);
+    printf("  -f <effect>   Fade effect 0: none, 1: linear, 2: move x, 3: move y (default 1).\n");
+    printf("  -o <path>     Existing output directory (default .).\n");
+    printf("  -F <format>   Frame output format: ppm, raw or none (default ppm).\n");
+    printf("  -r            Run in realtime instead of virtual time.\n");
+    printf("  -T <text>     Text, shown by the JustTextPlugin.\n");
+    printf("  -b <size>     Run the HTTP response payload benchmark with the payload size in byte and exit (e.g. %zu).\n", HttpRspBenchmark::DEFAULT_PAYLOAD_SIZE);
+    printf("  -H <count>    Run the TLS handshake benchmark with the number of connections per scenario and exit (e.g. %u).\n", TlsBenchmark::DEFAULT_CONNECTIONS);
+    printf("  -U <frames>   Run the UDP pixel stream benchmark with the number of frames per scenario and exit (e.g. %u).\n", PixelStreamBenchmark::DEFAULT_FRAMES);
+    printf("  -M <messages> Run the MQTT session benchmark with the number of messages per scenario and exit (e.g. %u).\n", MqttBenchmark::DEFAULT_MESSAGES);
+
+    return;
+}
+
+/**
+ * Parse program arguments.
+ *
+ * @param[in]   argc    Number of arguments
+ * @param[in]   argv    Arguments
+ * @param[out]  cfg     Simulation configuration
+ *
+ * @return If all arguments are valid, it will return true otherwise false.
+ */
+static bool parseArgs(int argc, char** argv, SimConfig& cfg)
+{
+    bool    isValid = true;
+    int     option  = 0;
+
+    while((true == isValid) && (-1 != (option = getopt(argc, argv, "d:s:p:t:f:o:F:rT:b:H:U:M:"))))
+    {
+        switch(option)
+        {
+        case 'd':
+            cfg.duration = strtoul(optarg, nullptr, 0);
+            break;
+
+        case 's':
+            cfg.seed = strtoul(optarg, nullptr, 0);
+            break;
+
+        case 'p':
+            cfg.plugins = optarg;
+            break;
+
+        case 't':
+            cfg.slotDuration = strtoul(optarg, nullptr, 0);
+            break;
+
+        case 'f':
+            {
+                unsigned long fadeEffect = strtoul(optarg, nullptr, 0);
+
+                if (DisplayMgr::FADE_EFFECT_MOVE_Y < fadeEffect)
+                {
+                    isValid = false;
+                }
+                else
+                {
+                    cfg.fadeEffect = static_cast<DisplayMgr::FadeEffect>(fadeEffect);
+                }
+            }
+            break;
+
+        case 'o':
+            cfg.outputPath = optarg;
+            break;
+
+        case 'F':
+            if (0 == strcmp(optarg, "ppm"))
+            {
+                cfg.format = FrameRecorder::FORMAT_PPM;
+            }
+            else if (0 == strcmp(optarg, "raw"))
+            {
+                cfg.format = FrameRecorder::FORMAT_RAW;
+            }
+            else if (0 == strcmp(optarg, "none"))
+            {
+                cfg.format = FrameRecorder::FORMAT_NONE;
+            }
+            else
+            {
+                isValid = false;
+            }
+            break;
+
+        case 'r':
+            cfg.isRealtime = true;
+            break;
+
+        case 'T':
+            cfg.text = optarg;
+            break;
+
+        case 'b':
+            cfg.benchmarkSize = strtoul(optarg, nullptr, 0);
+
+            if (0U == cfg.benchmarkSize)
+            {
+                isValid = false;
+            }
+            break;
+
+        case 'H':
+            cfg.tlsConnections = strtoul(optarg, nullptr, 0);
+
+            if (0U == cfg.tlsConnections)
+            {
+                isValid = false;
+            }
+            break;
+
+        case 'U':
+            cfg.streamFrames = strtoul(optarg, nullptr, 0);
+
+            if (0U == cfg.streamFrames)
+            {
+                isValid = false;
+            }
+            break;
+
+        case 'M':
+            cfg.mqttMessages = strtoul(optarg, nullptr, 0);
+
+            if (0U == cfg.mqttMessages)
+            {
+                isValid = false;
+            }
+            break;
+
+        default:
+            isValid = false;
+            break;
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * Create and install all configured plugins. Every plugin gets its own slot
+ * in the order of the list.
+ *
+ * @param[in]   factory Plugin factory
+ * @param[in]   cfg     Simulation configuration
+ * @param[out]  plugins Installed plugins
+ */
+static void installPlugins(PluginFactory& factory, const SimConfig& cfg, std::vector<IPluginMaintenance*>& plugins)
+{
+    const char* name    = cfg.plugins.c_str();
+
+    while('\0' != *name)
+    {
+        const char*         end     = strchr(name, ',');
+        size_t              len     = (nullptr == end) ? strlen(name) : static_cast<size_t>(end - name);
+        String              pluginName;
+        IPluginMaintenance* plugin  = nullptr;
+        size_t              index   = 0U;
+
+        for(index = 0U; index < len; ++index)
+        {
+            pluginName += name[index];
+        }
+
+        plugin = factory.createPlugin(pluginName);
+
+        if (nullptr == plugin)
+        {
+            LOG_WARNING("Unknown plugin %s.", pluginName.c_str());
+        }
+        else
+        {
+            uint8_t slotId = DisplayMgr::getInstance().installPlugin(plugin);
+
+            if (DisplayMgr::SLOT_ID_INVALID == slotId)
+            {
+                LOG_WARNING("No free slot for %s.", pluginName.c_str());
+                factory.destroyPlugin(plugin);
+            }
+            else
+            {
+                (void)DisplayMgr::getInstance().setSlotDuration(slotId, cfg.slotDuration, false);
+
+                if ((nullptr != cfg.text) &&
+                    (0 == strcmp(plugin->getName(), "JustTextPlugin")))
+                {
+                    const size_t        JSON_DOC_SIZE   = 512U;
+                    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+                    JsonObject          jsonObj         = jsonDoc.to<JsonObject>();
+
+                    jsonObj["show"] = cfg.text;
+                    (void)plugin->setTopic("/text", jsonObj);
+                }
+
+                plugin->enable();
+                plugins.push_back(plugin);
+            }
+        }
+
+        name += len;
+
+        if (',' == *name)
+        {
+            ++name;
+        }
+    }
+
+    return;
+}
+
+/**
+ * Uninstall and destroy all plugins.
+ *
+ * @param[in]       factory Plugin factory
+ * @param[in,out]   plugins Installed plugins
+ */
+static void uninstallPlugins(PluginFactory& factory, std::vector<IPluginMaintenance*>& plugins)
+{
+    std::vector<IPluginMaintenance*>::iterator it;
+
+    for(it = plugins.begin(); it != plugins.end(); ++it)
+    {
+        (void)DisplayMgr::getInstance().uninstallPlugin(*it);
+        factory.destroyPlugin(*it);
+    }
+
+    plugins.clear();
+
+    return;
+}
@@ -0,0 +1,93 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS handshake benchmark for the host simulation
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup sim
+ *
+ * @{
+ */
+
+#ifndef __TLSBENCHMARK_H__
+#define __TLSBENCHMARK_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The benchmark connects the TLS client of the HTTP connection pool to a
+ * local TLS stand-in server, which runs in the same process. The records
+ * are exchanged in memory, so only the processing costs are measured.
+ *
+ * Per scenario a number of connections is established, each exchanges a
+ * short request and response and is closed afterwards:
+ * - Full handshake, without a cached session.
+ * - Resumption by session id, the server issues no tickets.
+ * - Resumption by session ticket.
+ *
+ * For client and server the processing time per handshake is measured, as
+ * well as the number of bytes, which are exchanged during the handshake.
+ */
+namespace TlsBenchmark
+{
+
+/** Default number of connections per scenario. */
+static const uint32_t DEFAULT_CONNECTIONS   = 100U;
+
+/**
+ * Run the benchmark and print the results to the standard output.
+ *
+ * @param[in] connections   Number of connections per scenario
+ *
+ * @return If successful, it will return true otherwise false.
+ */
+extern bool run(uint32_t connections);
+
+}
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __TLSBENCHMARK_H__ */
+
+/** @} */
@@ -40,6 +40,9 @@
 #include "ClockDrv.h"
 #include "ButtonDrv.h"
 #include "DisplayMgr.h"
+#include "HttpRequestScheduler.h"
+#include "DnsCache.h"
+#include "MqttClient.h"
 
 #include "ConnectingState.h"
 #include "RestartState.h"
@@ -81,6 +84,9 @@ void ConnectedState::entry(StateMachine& sm)
 
     LOG_INFO("Connected.");
 
+    /* The network and its resolver may be different than before. */
+    DnsCache::getInstance().clear();
+
     /* Get hostname. */
     if (false == Settings::getInstance().open(true))
     {
@@ -109,6 +115,9 @@ void ConnectedState::entry(StateMachine& sm)
         /* Start the ClockDriver */
         ClockDrv::getInstance().init();
 
+        /* Connect to the MQTT broker, if configured. */
+        MqttClient::getInstance().begin();
+
         /* Show hostname and IP. */
         infoStr += WiFi.getHostname(); /* Don't believe its the same as set before. */
         infoStr += " IP: ";
@@ -128,6 +137,15 @@ void ConnectedState::process(StateMachine& sm)
     /* Handle update, there may be one in the background. */
     UpdateMgr::getInstance().process();
 
+    /* Start the admitted outgoing HTTP requests. */
+    HttpRequestScheduler::getInstance().process();
+
+    /* Refresh the used DNS cache entries before they expire. */
+    DnsCache::getInstance().process();
+
+    /* Keep the MQTT connection alive and reconnect if lost. */
+    MqttClient::getInstance().process();
+
     /* Restart requested by update manager? This may happen after a successful received
      * new firmware or filesystem binary.
      */
@@ -156,6 +174,8 @@ void ConnectedState::exit(StateMachine& sm)
 {
     UTIL_NOT_USED(sm);
 
+    MqttClient::getInstance().end();
+
     /* Disconnect all connections */
     (void)WiFi.disconnect();
 
@@ -50,6 +50,7 @@
 #include "PluginMgr.h"
 #include "WebConfig.h"
 #include "FileSystem.h"
+#include "WorkerPool.h"
 
 #include "APState.h"
 #include "ConnectingState.h"
@@ -69,7 +70,9 @@
 #include "IconTextLampPlugin.h"
 #include "IconTextPlugin.h"
 #include "JustTextPlugin.h"
+#include "MqttIconTextPlugin.h"
 #include "OpenWeatherPlugin.h"
+#include "PixelStreamPlugin.h"
 #include "RainbowPlugin.h"
 #include "ShellyPlugSPlugin.h"
 #include "SunrisePlugin.h"
@@ -128,6 +131,12 @@ void InitState::entry(StateMachine& sm)
         LOG_FATAL("Couldn't mount the filesystem.");
         isError = true;
     }
+    /* Start worker pool, which executes plugin jobs beside the display task. */
+    else if (false == WorkerPool::getInstance().begin())
+    {
+        LOG_FATAL("Couldn't start the worker pool.");
+        isError = true;
+    }
     else
     {
         /* Prepare everything for the plugins. */
@@ -379,7 +388,9 @@ void InitState::registerPlugins()
     pluginMgr.registerPlugin("IconTextLampPlugin", IconTextLampPlugin::create);
     pluginMgr.registerPlugin("IconTextPlugin", IconTextPlugin::create);
     pluginMgr.registerPlugin("JustTextPlugin", JustTextPlugin::create);
+    pluginMgr.registerPlugin("MqttIconTextPlugin", MqttIconTextPlugin::create);
     pluginMgr.registerPlugin("OpenWeatherPlugin", OpenWeatherPlugin::create);
+    pluginMgr.registerPlugin("PixelStreamPlugin", PixelStreamPlugin::create);
     pluginMgr.registerPlugin("RainbowPlugin", RainbowPlugin::create);
     pluginMgr.registerPlugin("ShellyPlugSPlugin", ShellyPlugSPlugin::create);
     pluginMgr.registerPlugin("SunrisePlugin", SunrisePlugin::create);
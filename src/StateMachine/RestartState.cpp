@@ -34,6 +34,7 @@
  *****************************************************************************/
 #include "RestartState.h"
 #include "DisplayMgr.h"
+#include "WorkerPool.h"
 #include "LedMatrix.h"
 #include "Board.h"
 #include "MyWebServer.h"
@@ -93,6 +94,9 @@ void RestartState::process(StateMachine& sm)
         UpdateMgr::getInstance().end();
         MDNS.end();
 
+        /* Stop worker pool, before the jobs lose the filesystem. */
+        WorkerPool::getInstance().end();
+
         /* Unmount filesystem */
         FILESYSTEM.end();
 
@@ -33,6 +33,13 @@
  * Includes
  *****************************************************************************/
 #include "AsyncHttpClient.h"
+#include "HttpConnectionPool.h"
+#include "HttpCache.h"
+#include "HttpBodyParser.h"
+#include "HttpRequestScheduler.h"
+#include "DnsCache.h"
+#include "WorkerPool.h"
+#include "JsonDocPool.h"
 
 #include <Util.h>
 #include <Logging.h>
@@ -63,12 +70,16 @@
  *****************************************************************************/
 
 AsyncHttpClient::AsyncHttpClient() :
-    m_tcpClient(),
+    m_tcpClient(nullptr),
     m_onRspCallback(nullptr),
+    m_onJsonRspCallback(nullptr),
+    m_jsonFilter(nullptr),
+    m_jsonDocSize(0U),
     m_onClosedCallback(),
     m_onErrorCallback(),
     m_hostname(),
     m_port(0U),
+    m_isSecure(false),
     m_base64Authorization(),
     m_uri(),
     m_headers(),
@@ -76,58 +87,63 @@ AsyncHttpClient::AsyncHttpClient() :
     m_method(),
     m_userAgent("AsyncHttpClient"),
     m_isHttpVer10(false),
-    m_isKeepAlive(false),
+    m_isKeepAlive(true),
     m_urlEncodedPars(),
     m_payload(nullptr),
     m_payloadSize(0U),
+    m_isCacheEnabled(true),
+    m_cacheKey(),
+    m_isCompressionEnabled(false),
+    m_pollPeriod(0U),
+    m_isInsecure(false),
+    m_addrSource(ADDR_SOURCE_NONE),
+    m_isRetryable(false),
     m_rspPart(RESPONSE_PART_STATUS_LINE),
     m_rsp(),
     m_rspLine(),
     m_transferCoding(TRANSFER_CODING_IDENTITY),
     m_contentLength(0U),
+    m_isRspReusable(false),
+    m_isRspCacheable(false),
     m_contentIndex(0U),
     m_chunkSize(0U),
     m_chunkIndex(0U),
-    m_chunkBodyPart(CHUNK_SIZE)
+    m_chunkBodyPart(CHUNK_SIZE),
+    m_bodyStream(),
+    m_isBodyStreamed(false),
+    m_isJsonParserBusy(false),
+    m_xJsonParserDone(xSemaphoreCreateBinary()),
+    m_inflater(nullptr)
 {
-    m_tcpClient.onConnect(  [this](void* arg, AsyncClient* client)
-                            {
-                                UTIL_NOT_USED(arg);
-
-                                onConnect(client);
-                            });
-
-    m_tcpClient.onDisconnect(   [this](void* arg, AsyncClient* client)
-                                {
-                                    UTIL_NOT_USED(arg);
-
-                                    onDisconnect(client);
-                                });
-
-    m_tcpClient.onError(    [this](void* arg, AsyncClient* client, int8_t error)
-                            {
-                                UTIL_NOT_USED(arg);
-
-                                onError(client, error);
-                            });
+}
 
-    m_tcpClient.onData( [this](void* arg, AsyncClient* client, void* data, size_t len)
-                        {
-                            UTIL_NOT_USED(arg);
+AsyncHttpClient::~AsyncHttpClient()
+{
+    /* The request scheduler and the connection pool shall not call back anymore.
+     * A pending retry shall not acquire a connection anymore.
+     */
+    HttpRequestScheduler::getInstance().cancel(this);
+    WorkerPool::getInstance().cancel(this);
+    releaseConnection(false);
 
-                            onData(client, static_cast<uint8_t*>(data), len);
-                        });
+    /* A running JSON parser and a pending job must be finished, before the client is destroyed. */
+    m_bodyStream.abort();
+    waitForJsonParser();
+    WorkerPool::getInstance().cancel(this);
 
-    m_tcpClient.onTimeout(  [this](void* arg, AsyncClient* client, uint32_t timeout)
-                            {
-                                UTIL_NOT_USED(arg);
+    if (nullptr != m_xJsonParserDone)
+    {
+        vSemaphoreDelete(m_xJsonParserDone);
+        m_xJsonParserDone = nullptr;
+    }
 
-                                onTimeout(client, timeout);
-                            });
-}
+    if (nullptr != m_jsonFilter)
+    {
+        delete m_jsonFilter;
+        m_jsonFilter = nullptr;
+    }
 
-AsyncHttpClient::~AsyncHttpClient()
-{
+    endRspDecoding();
 }
 
 bool AsyncHttpClient::begin(const String& url)
@@ -150,6 +166,10 @@ bool AsyncHttpClient::begin(const String& url)
     {
         int begin = 0;
 
+        /* The request may go to a different host. If the last response
+         * didn't allow to reuse the connection, its not needed anymore.
+         */
+        releaseConnection(false);
         clear();
 
         /* Get protocol http or https */
@@ -159,11 +179,13 @@ bool AsyncHttpClient::begin(const String& url)
         /* Determine port from protocol */
         if (protocol == "http")
         {
-            m_port = HTTP_PORT;
+            m_port      = HTTP_PORT;
+            m_isSecure  = false;
         }
         else if (protocol == "https")
         {
-            m_port = HTTPS_PORT;
+            m_port      = HTTPS_PORT;
+            m_isSecure  = true;
         }
         else
         {
@@ -269,29 +291,79 @@ void AsyncHttpClient::end()
     clear();
 }
 
+void AsyncHttpClient::releaseBuffers()
+{
+    /* The buffers are in use as long as a request is pending or the
+     * JSON parser still reads the last response body.
+     */
+    if ((false == m_isReqOpen) &&
+        (false == isJsonParserBusy()))
+    {
+        m_rsp.releaseBuffers();
+        m_rspLine = String();
+        m_bodyStream.end();
+        endRspDecoding();
+    }
+}
+
 bool AsyncHttpClient::connect()
 {
-    return m_tcpClient.connect(m_hostname.c_str(), m_port);
+    bool status = false;
+
+    if (true == acquireConnection())
+    {
+        status = connectToServer();
+    }
+
+    return status;
 }
 
 void AsyncHttpClient::disconnect()
 {
-    m_tcpClient.close();
+    if (nullptr != m_tcpClient)
+    {
+        m_tcpClient->close();
+    }
 }
 
 void AsyncHttpClient::abort()
 {
-    m_tcpClient.abort();
+    /* A pending retry shall not acquire a connection anymore. */
+    HttpRequestScheduler::getInstance().cancel(this);
+    WorkerPool::getInstance().cancel(this);
+    releaseConnection(false);
+
+    /* A running JSON parser and a pending job shall not call back anymore. */
+    m_bodyStream.abort();
+    waitForJsonParser();
+    WorkerPool::getInstance().cancel(this);
+
+    /* No callback will finish a pending request. */
+    m_isReqOpen = false;
 }
 
 bool AsyncHttpClient::isConnected()
 {
-    return m_tcpClient.connected();
+    bool isConnected = false;
+
+    if (nullptr != m_tcpClient)
+    {
+        isConnected = m_tcpClient->connected();
+    }
+
+    return isConnected;
 }
 
 bool AsyncHttpClient::isDisconnected()
 {
-    return m_tcpClient.disconnected();
+    bool isDisconnected = true;
+
+    if (nullptr != m_tcpClient)
+    {
+        isDisconnected = m_tcpClient->disconnected();
+    }
+
+    return isDisconnected;
 }
 
 void AsyncHttpClient::setHttpVersion(bool useHttp10)
@@ -304,6 +376,31 @@ void AsyncHttpClient::setKeepAlive(bool keepAlive)
     m_isKeepAlive = keepAlive;
 }
 
+void AsyncHttpClient::setCache(bool isEnabled)
+{
+    m_isCacheEnabled = isEnabled;
+}
+
+void AsyncHttpClient::setCompression(bool isEnabled)
+{
+    m_isCompressionEnabled = isEnabled;
+}
+
+void AsyncHttpClient::setPollPeriod(uint32_t period)
+{
+    m_pollPeriod = period;
+}
+
+void AsyncHttpClient::setInsecure(bool isInsecure)
+{
+    if (true == isInsecure)
+    {
+        LOG_WARNING("Server certificate verification disabled.");
+    }
+
+    m_isInsecure = isInsecure;
+}
+
 void AsyncHttpClient::addHeader(const String& name, const String& value)
 {
     /* Only add header if not handled by the client itself. */
@@ -352,6 +449,34 @@ void AsyncHttpClient::regOnResponse(const OnResponse& onResponse)
     m_onRspCallback = onResponse;
 }
 
+void AsyncHttpClient::regOnJsonResponse(const JsonDocument& filter, size_t jsonDocSize, const OnJsonResponse& onJsonRsp)
+{
+    if (nullptr != m_jsonFilter)
+    {
+        delete m_jsonFilter;
+    }
+
+    m_jsonFilter = new DynamicJsonDocument(filter.capacity());
+
+    if (nullptr == m_jsonFilter)
+    {
+        LOG_ERROR("Couldn't allocate JSON filter.");
+        m_onJsonRspCallback = nullptr;
+    }
+    else
+    {
+        (void)m_jsonFilter->set(filter);
+
+        if (true == m_jsonFilter->overflowed())
+        {
+            LOG_ERROR("Less memory for filter available.");
+        }
+
+        m_jsonDocSize       = jsonDocSize;
+        m_onJsonRspCallback = onJsonRsp;
+    }
+}
+
 void AsyncHttpClient::regOnClosed(const OnClosed& onClosed)
 {
     m_onClosedCallback = onClosed;
@@ -372,15 +497,27 @@ bool AsyncHttpClient::GET()
         m_payload       = nullptr;
         m_payloadSize   = 0U;
 
-        if (false == isConnected())
+        m_cacheKey.clear();
+
+        /* URL encoded parameters are sent in the body, which is not part of the key. */
+        if ((true == m_isCacheEnabled) &&
+            (true == m_urlEncodedPars.isEmpty()))
+        {
+            m_cacheKey  = m_hostname;
+            m_cacheKey += ":";
+            m_cacheKey += m_port;
+            m_cacheKey += m_uri;
+        }
+
+        if ((false == m_cacheKey.isEmpty()) &&
+            (true == HttpCache::getInstance().isFresh(m_cacheKey)) &&
+            (true == startCachedResponse()))
         {
-            status = connect();
-            m_isReqOpen = status;
+            status = true;
         }
         else
         {
-            status = sendRequest();
-            m_isReqOpen = false;
+            status = submitRequest();
         }
     }
 
@@ -397,16 +534,9 @@ bool AsyncHttpClient::POST(const uint8_t* payload, size_t size)
         m_payload       = payload;
         m_payloadSize   = size;
 
-        if (false == isConnected())
-        {
-            status = connect();
-            m_isReqOpen = status;
-        }
-        else
-        {
-            status = sendRequest();
-            m_isReqOpen = false;
-        }
+        m_cacheKey.clear();
+
+        status = submitRequest();
     }
 
     return status;
@@ -420,6 +550,8 @@ bool AsyncHttpClient::POST(const String& payload)
     {
         m_method = "POST";
 
+        m_cacheKey.clear();
+
         if (true == payload.isEmpty())
         {
             m_payload       = nullptr;
@@ -431,16 +563,7 @@ bool AsyncHttpClient::POST(const String& payload)
             m_payloadSize   = payload.length();
         }
 
-        if (false == isConnected())
-        {
-            status = connect();
-            m_isReqOpen = status;
-        }
-        else
-        {
-            status = sendRequest();
-            m_isReqOpen = false;
-        }
+        status = submitRequest();
     }
 
     return status;
@@ -458,6 +581,14 @@ void AsyncHttpClient::onConnect(AsyncClient* client)
 {
     LOG_INFO("Connected.");
 
+    /* The next connections to this host don't need to resolve it again. */
+    if (ADDR_SOURCE_RESOLVER == m_addrSource)
+    {
+        DnsCache::getInstance().storeResolved(m_hostname, client->remoteIP());
+    }
+
+    m_addrSource = ADDR_SOURCE_NONE;
+
     /* Is there a queued request, which to send? */
     if (true == m_isReqOpen)
     {
@@ -475,8 +606,14 @@ void AsyncHttpClient::onDisconnect(AsyncClient* client)
     UTIL_NOT_USED(client);
 
     LOG_INFO("Disconnected.");
-    clear();
-    notifyClosed();
+    releaseConnection(false);
+
+    if (false == retryRequest())
+    {
+        HttpRequestScheduler::getInstance().finish(this, nullptr);
+        clear();
+        notifyClosed();
+    }
 }
 
 void AsyncHttpClient::onError(AsyncClient* client, int8_t error)
@@ -493,7 +630,26 @@ void AsyncHttpClient::onError(AsyncClient* client, int8_t error)
         LOG_WARNING("Error occurred: %d", error);
     }
 
-    notifyError();
+    /* Connection establishment failed? */
+    if ((ADDR_SOURCE_RESOLVER == m_addrSource) &&
+        (ERR_DNS_FAILED == error))
+    {
+        DnsCache::getInstance().storeUnresolvable(m_hostname);
+    }
+    /* The cached address may be outdated, resolve it again next time. */
+    else if (ADDR_SOURCE_CACHE == m_addrSource)
+    {
+        DnsCache::getInstance().remove(m_hostname);
+    }
+
+    m_addrSource = ADDR_SOURCE_NONE;
+
+    /* A failed kept alive connection is retried after the disconnect. */
+    if (false == m_isRetryable)
+    {
+        notifyError();
+    }
+
     disconnect();
 }
 
@@ -502,6 +658,7 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
     size_t      index       = 0U;
     const char* asciiData   = reinterpret_cast<const char*>(data);
     bool        isError     = false;
+    bool        isRspDone   = false;
 
     /* RFC2616 - Response = Status-Line
      *                      *(( general-header
@@ -513,16 +670,19 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
 
     LOG_INFO("onData(): len = %u", len);
 
-    while((len > index) && (false == isError))
+    /* The server received the request, it must not be sent again. */
+    m_isRetryable = false;
+
+    while((len > index) && (false == isError) && (false == isRspDone))
     {
         switch(m_rspPart)
         {
         case RESPONSE_PART_STATUS_LINE:
             if (true == parseRspStatusLine(asciiData, len, index))
             {
-                LOG_INFO("Rsp. HTTP-Version: %s", m_rsp.getHttpVersion().c_str());
+                LOG_INFO("Rsp. HTTP-Version: %s", m_rsp.getHttpVersion());
                 LOG_INFO("Rsp. Status-Code: %u", m_rsp.getStatusCode());
-                LOG_INFO("Rsp. Reason-Phrase: %s", m_rsp.getReasonPhrase().c_str());
+                LOG_INFO("Rsp. Reason-Phrase: %s", m_rsp.getReasonPhrase());
 
                 m_rspPart = RESPONSE_PART_HEADER;
             }
@@ -543,15 +703,89 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
                     client->close();
                     isError = true;
                 }
+                /* RFC7230 - 3.3.3. Message Body Length
+                 * A 204 or 304 response never contains a body.
+                 */
+                else if ((204U == m_rsp.getStatusCode()) ||
+                         (304U == m_rsp.getStatusCode()))
+                {
+                    if ((304U == m_rsp.getStatusCode()) &&
+                        (false == m_cacheKey.isEmpty()))
+                    {
+                        HttpResponse cachedRsp;
+
+                        if (false == HttpCache::getInstance().revalidate(m_cacheKey, m_rsp, cachedRsp))
+                        {
+                            LOG_WARNING("Not modified, but not cached anymore.");
+                        }
+                        else
+                        {
+                            LOG_INFO("Not modified, use cached response.");
+                            m_rsp = cachedRsp;
+                        }
+                    }
+
+                    notifyResponse();
+                    isRspDone = true;
+
+                    m_rspPart = RESPONSE_PART_STATUS_LINE;
+                    m_rsp.clear();
+                    m_contentLength = 0U;
+                }
+                /* A empty body completes the response immediately, because
+                 * no further data is received on a kept alive connection.
+                 */
+                else if ((TRANSFER_CODING_IDENTITY == m_transferCoding) &&
+                         (true == m_rsp.isContentLengthKnown()) &&
+                         (0U == m_contentLength))
+                {
+                    /* There is nothing to decode. */
+                    endRspDecoding();
+
+                    notifyResponse();
+                    isRspDone = true;
+
+                    m_rspPart = RESPONSE_PART_STATUS_LINE;
+                    m_rsp.clear();
+                }
                 else if (TRANSFER_CODING_IDENTITY == m_transferCoding)
                 {
                     /* "Content-Length" may be missing. */
-                    if (0U == m_contentLength)
+                    if (false == m_rsp.isContentLengthKnown())
                     {
                         m_contentLength = len - index;
                     }
+
+                    beginRspBody();
+
+                    /* The payload size is known, therefore allocate the
+                     * payload buffer only once, instead of extending it
+                     * with every received segment. But only if it is
+                     * reasonable, otherwise it grows with the received data.
+                     */
+                    if ((false == m_isBodyStreamed) || (true == m_isRspCacheable))
+                    {
+                        if ((ESP.getMaxAllocHeap() / PAYLOAD_RESERVE_DIVISOR) < m_contentLength)
+                        {
+                            LOG_WARNING("%u byte payload is not reserved, it grows.", m_contentLength);
+                        }
+                        else if (false == m_rsp.reservePayload(m_contentLength))
+                        {
+                            LOG_ERROR("Not enough heap for %u byte payload.", m_contentLength);
+                        }
+                        else
+                        {
+                            ;
+                        }
+                    }
+
+                    m_rspPart = RESPONSE_PART_BODY;
+                }
+                else
+                {
+                    beginRspBody();
+                    m_rspPart = RESPONSE_PART_BODY;
                 }
-                m_rspPart = RESPONSE_PART_BODY;
             }
             break;
 
@@ -561,6 +795,7 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
                 if (true == parseChunkedResponse(data, len, index))
                 {
                     notifyResponse();
+                    isRspDone = true;
 
                     m_transferCoding = TRANSFER_CODING_IDENTITY;
                     m_rspPart = RESPONSE_PART_STATUS_LINE;
@@ -582,13 +817,14 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
                     copySize = available;
                 }
 
-                m_rsp.addPayload(&data[index], copySize);
+                addRspBody(&data[index], copySize);
                 m_contentIndex += copySize;
                 index += copySize;
 
                 if (m_contentLength <= m_contentIndex)
                 {
                     notifyResponse();
+                    isRspDone = true;
 
                     m_rspPart = RESPONSE_PART_STATUS_LINE;
                     m_rsp.clear();
@@ -605,6 +841,22 @@ void AsyncHttpClient::onData(AsyncClient* client, const uint8_t* data, size_t le
             break;
         }
     }
+
+    /* If the server keeps the connection alive, give it back to the pool.
+     * Otherwise the server will close it.
+     */
+    if (true == isRspDone)
+    {
+        if (len > index)
+        {
+            LOG_WARNING("Unexpected data after response.");
+            client->close();
+        }
+        else if (true == m_isRspReusable)
+        {
+            releaseConnection(true);
+        }
+    }
 }
 
 void AsyncHttpClient::onTimeout(AsyncClient* client, uint32_t timeout)
@@ -615,14 +867,231 @@ void AsyncHttpClient::onTimeout(AsyncClient* client, uint32_t timeout)
     client->close();
 }
 
+bool AsyncHttpClient::acquireConnection(bool isNew)
+{
+    if (nullptr == m_tcpClient)
+    {
+        m_tcpClient = HttpConnectionPool::getInstance().acquire(m_hostname, m_port, m_isSecure, m_isInsecure, this, isNew);
+    }
+
+    return (nullptr != m_tcpClient);
+}
+
+void AsyncHttpClient::releaseConnection(bool keepAlive)
+{
+    if (nullptr != m_tcpClient)
+    {
+        HttpConnectionPool::getInstance().release(m_tcpClient, keepAlive);
+        m_tcpClient = nullptr;
+    }
+
+    return;
+}
+
+bool AsyncHttpClient::submitRequest()
+{
+    bool status = HttpRequestScheduler::getInstance().submit(this, m_hostname, m_cacheKey, m_pollPeriod);
+
+    /* The request is pending until the scheduler starts it. */
+    m_isReqOpen = status;
+
+    return status;
+}
+
+bool AsyncHttpClient::startRequest(bool isNewConnection)
+{
+    bool status = false;
+
+    if (false == acquireConnection(isNewConnection))
+    {
+        status = false;
+    }
+    /* Kept alive connection available? */
+    else if (true == m_tcpClient->connected())
+    {
+        LOG_INFO("Send request via kept alive connection.");
+
+        m_isReqOpen = false;
+        status = sendRequest();
+
+        if (false == status)
+        {
+            releaseConnection(false);
+        }
+        else
+        {
+            /* Only a idempotent request may be sent twice. */
+            m_isRetryable = (m_method == "GET");
+        }
+    }
+    else
+    {
+        status = connectToServer();
+        m_isReqOpen = status;
+
+        if (false == status)
+        {
+            releaseConnection(false);
+        }
+    }
+
+    return status;
+}
+
+bool AsyncHttpClient::connectToServer()
+{
+    bool        status  = false;
+    IPAddress   addr;
+
+    switch(DnsCache::getInstance().lookup(m_hostname, addr))
+    {
+    case DnsCache::RESULT_RESOLVED:
+        m_addrSource    = ADDR_SOURCE_CACHE;
+        status          = m_tcpClient->connect(addr, m_port);
+        break;
+
+    case DnsCache::RESULT_UNRESOLVABLE:
+        LOG_WARNING("Hostname %s can't be resolved.", m_hostname.c_str());
+        m_addrSource    = ADDR_SOURCE_NONE;
+        status          = false;
+        break;
+
+    case DnsCache::RESULT_UNKNOWN:
+        /* fall through */
+    default:
+        m_addrSource    = ADDR_SOURCE_RESOLVER;
+        status          = m_tcpClient->connect(m_hostname.c_str(), m_port);
+        break;
+    }
+
+    if (false == status)
+    {
+        m_addrSource = ADDR_SOURCE_NONE;
+    }
+
+    return status;
+}
+
+bool AsyncHttpClient::onRequestStart()
+{
+    bool status = startRequest();
+
+    if (false == status)
+    {
+        m_isReqOpen = false;
+
+        /* The application expects a callback for the request, but the
+         * scheduler lock is held. Therefore notify it asynchronously.
+         */
+        if (false == WorkerPool::getInstance().submit(requestFailedJob, this))
+        {
+            LOG_WARNING("Request failure not notified.");
+        }
+    }
+
+    return status;
+}
+
+void AsyncHttpClient::onRequestCoalesced(const HttpResponse& rsp)
+{
+    m_rsp = rsp;
+
+    if (false == deliverResponse())
+    {
+        LOG_WARNING("Coalesced response not delivered.");
+    }
+
+    return;
+}
+
+void AsyncHttpClient::requestFailedJob(void* arg)
+{
+    AsyncHttpClient* client = static_cast<AsyncHttpClient*>(arg);
+
+    if (nullptr != client)
+    {
+        client->notifyError();
+        client->notifyClosed();
+    }
+
+    return;
+}
+
+bool AsyncHttpClient::retryRequest()
+{
+    bool status = false;
+
+    if (true == m_isRetryable)
+    {
+        m_isRetryable = false;
+
+        LOG_INFO("Kept alive connection failed, retry on a new connection.");
+
+        /* The TCP client must not connect again inside its own event handler. */
+        status = WorkerPool::getInstance().submit(retryRequestJob, this);
+
+        if (false == status)
+        {
+            notifyError();
+        }
+    }
+
+    return status;
+}
+
+void AsyncHttpClient::retryRequestJob(void* arg)
+{
+    AsyncHttpClient* client = static_cast<AsyncHttpClient*>(arg);
+
+    if ((nullptr != client) &&
+        (false == client->startRequest(true)))
+    {
+        HttpRequestScheduler::getInstance().finish(client, nullptr);
+        client->clear();
+        client->notifyError();
+        client->notifyClosed();
+    }
+
+    return;
+}
+
 bool AsyncHttpClient::sendRequest()
 {
     bool        status      = false;
     String      request;
+    String      eTag;
+    String      lastModified;
+    size_t      requestSize = REQUEST_CONST_SIZE;
     const char* PROTOCOL    = "HTTP";
     const char* SP          = " ";
     const char* CRLF        = "\r\n";
 
+    /* RFC7232 - Conditional request with the validators of the cached response */
+    if (false == m_cacheKey.isEmpty())
+    {
+        (void)HttpCache::getInstance().getValidators(m_cacheKey, eTag, lastModified);
+    }
+
+    /* The request header is assembled in a single buffer, which is
+     * allocated once with the max. size. Otherwise it would be
+     * reallocated several times during assembly.
+     */
+    m_base64Authorization.replace("\n", "");
+
+    requestSize += m_method.length();
+    requestSize += m_uri.length();
+    requestSize += m_hostname.length();
+    requestSize += m_userAgent.length();
+    requestSize += m_base64Authorization.length();
+    requestSize += eTag.length();
+    requestSize += lastModified.length();
+    requestSize += m_headers.length();
+
+    if (0U == request.reserve(requestSize))
+    {
+        LOG_WARNING("Not enough heap for %u byte request header.", requestSize);
+    }
+
     /* RFC2616
      * Request = Request-Line
      *           * (( general-header
@@ -706,15 +1175,26 @@ bool AsyncHttpClient::sendRequest()
 
     if (false == m_isHttpVer10)
     {
-        /* By the client supported transfer codings. */
+        /* By the client supported content and transfer codings.
+         * The decompression window needs up to 32 KB heap, therefore
+         * compression is only requested, if its available.
+         */
         request += "Accept-Encoding: ";
-        request += "identity;q=1,chunked;q=0.1,*;q=0";
+
+        if ((true == m_isCompressionEnabled) &&
+            ((Inflater::MAX_WINDOW_SIZE + COMPRESSION_HEAP_RESERVE) <= ESP.getMaxAllocHeap()))
+        {
+            request += "gzip;q=1,deflate;q=0.9,identity;q=0.5,chunked;q=0.1,*;q=0";
+        }
+        else
+        {
+            request += "identity;q=1,chunked;q=0.1,*;q=0";
+        }
         request += CRLF;
     }
 
     if (0U < m_base64Authorization.length())
     {
-        m_base64Authorization.replace("\n", "");
         request += "Authorization: Basic ";
         request += m_base64Authorization;
         request += CRLF;
@@ -749,18 +1229,36 @@ bool AsyncHttpClient::sendRequest()
         m_payloadSize   = m_urlEncodedPars.length();
     }
 
+    /* RFC7232 - Conditional request */
+    if (false == eTag.isEmpty())
+    {
+        request += "If-None-Match: ";
+        request += eTag;
+        request += CRLF;
+    }
+
+    if (false == lastModified.isEmpty())
+    {
+        request += "If-Modified-Since: ";
+        request += lastModified;
+        request += CRLF;
+    }
+
     request += m_headers;
     request += CRLF;
 
     /* Send header */
-    status = (request.length() == m_tcpClient.write(request.c_str(), request.length()));
+    if (nullptr != m_tcpClient)
+    {
+        status = (request.length() == HttpConnectionPool::getInstance().write(m_tcpClient, request.c_str(), request.length()));
+    }
 
     /* Send payload */
     if ((true == status) &&
         (nullptr != m_payload) &&
         (0U < m_payloadSize))
     {
-        status = (m_payloadSize == m_tcpClient.write(reinterpret_cast<const char*>(m_payload), m_payloadSize, 0));
+        status = (m_payloadSize == HttpConnectionPool::getInstance().write(m_tcpClient, reinterpret_cast<const char*>(m_payload), m_payloadSize, 0));
     }
 
     return status;
@@ -770,18 +1268,25 @@ void AsyncHttpClient::clear()
 {
     m_hostname.clear();
     m_port = 0U;
+    m_isSecure = false;
     m_base64Authorization.clear();
     m_uri.clear();
     m_headers.clear();
     m_urlEncodedPars.clear();
 
     m_isReqOpen = false;
+    m_isRetryable = false;
+
+    abortRspBody();
+    endRspDecoding();
 
     m_rspPart = RESPONSE_PART_STATUS_LINE;
     m_rsp.clear();
     m_rspLine.clear();
     m_transferCoding = TRANSFER_CODING_IDENTITY;
     m_contentLength = 0U;
+    m_isRspReusable = false;
+    m_isRspCacheable = false;
     m_contentIndex = 0U;
     m_chunkSize = 0U;
     m_chunkIndex = 0U;
@@ -822,56 +1327,90 @@ bool AsyncHttpClient::isEOL(const String& str, size_t& len)
 
 bool AsyncHttpClient::handleRspHeader()
 {
-    bool    isSuccess = true;
-    String  value;
+    bool    isSuccess               = true;
+    bool    isContentLengthKnown    = m_rsp.isContentLengthKnown();
 
-    /* Connection = "Connection" ":" 1#(connection-token)
-     * connection-token = token
-     *
-     * HTTP/1.1 defines the "close" connection option for the sender to
+    /* RFC7230 - 6.3. Persistence
+     * A HTTP/1.1 connection persists, unless the "close" connection option
+     * is received. A HTTP/1.0 connection persists only, if the "keep-alive"
+     * connection option is received.
+     */
+    m_isRspReusable = m_isKeepAlive;
+
+    if (0 == strcmp(m_rsp.getHttpVersion(), "HTTP/1.0"))
+    {
+        m_isRspReusable = false;
+    }
+
+    /* HTTP/1.1 defines the "close" connection option for the sender to
      * signal that the connection will be closed after completion of the
      * response.
      */
-    value = m_rsp.getHeader("Connection");
+    if (HttpResponse::CONNECTION_OPTION_CLOSE == m_rsp.getConnectionOption())
+    {
+        m_isRspReusable = false;
+    }
+    else if ((true == m_isKeepAlive) &&
+             (HttpResponse::CONNECTION_OPTION_KEEP_ALIVE == m_rsp.getConnectionOption()))
+    {
+        m_isRspReusable = true;
+    }
 
-    if (false == value.isEmpty())
+    /* The well-known header fields are already parsed by the response. */
+    m_contentLength = m_rsp.getContentLength();
+
+    /* A 204 or 304 response never contains a body. */
+    if ((204U == m_rsp.getStatusCode()) ||
+        (304U == m_rsp.getStatusCode()))
     {
-        /* Server closes the connection after the response? */
-        if (0 <= value.indexOf("close"))
-        {
-            /* Client want a permanent connection? */
-            if (true == m_isKeepAlive)
-            {
-                LOG_WARNING("Connection can not be kept-alive.");
-                m_isKeepAlive = false;
-            }
-        }
+        isContentLengthKnown = true;
     }
 
-    value = m_rsp.getHeader("Content-Length");
+    /* Only IDENTITY (default) and CHUNKED transfer coding are supported. */
+    if (HttpResponse::TRANSFER_CODING_CHUNKED == m_rsp.getTransferCoding())
+    {
+        m_transferCoding = TRANSFER_CODING_CHUNCKED;
+    }
+    else if (HttpResponse::TRANSFER_CODING_UNSUPPORTED == m_rsp.getTransferCoding())
+    {
+        isSuccess = false;
+    }
 
-    if (false == value.isEmpty())
+    /* RFC7231 - 3.1.2.2. Content-Encoding
+     * A 204 or 304 response has no body, which could be decoded.
+     */
+    if ((true == isSuccess) &&
+        (204U != m_rsp.getStatusCode()) &&
+        (304U != m_rsp.getStatusCode()))
     {
-        m_contentLength = value.toInt();
+        isSuccess = beginRspDecoding(m_rsp.getContentCoding());
     }
-    else
+
+    /* Without "Content-Length" the end of a identity coded body is
+     * signalled only by closing the connection.
+     */
+    if ((TRANSFER_CODING_IDENTITY == m_transferCoding) &&
+        (false == isContentLengthKnown))
     {
-        m_contentLength = 0U;
+        m_isRspReusable = false;
     }
 
-    value = m_rsp.getHeader("Transfer-Encoding");
+    /* Store only responses, which fit into the cache. A cached response,
+     * which the server doesn't allow to cache anymore, is removed.
+     */
+    m_isRspCacheable = false;
 
-    if (false == value.isEmpty())
+    if ((false == m_cacheKey.isEmpty()) &&
+        (200U == m_rsp.getStatusCode()))
     {
-        /* Only IDENTITY (default) and CHUNKED transfer coding are supported. */
-        if (0U != value.equalsIgnoreCase("chunked"))
+        if ((true == HttpCache::isCacheable(m_rsp, (false == m_base64Authorization.isEmpty()))) &&
+            ((false == isContentLengthKnown) || (HttpCache::MAX_ENTRY_SIZE >= m_contentLength)))
         {
-            m_transferCoding = TRANSFER_CODING_CHUNCKED;
+            m_isRspCacheable = true;
         }
-        /* Unsupported transfer coding */
         else
         {
-            isSuccess = false;
+            HttpCache::getInstance().remove(m_cacheKey);
         }
     }
 
@@ -920,7 +1459,7 @@ bool AsyncHttpClient::parseChunkedResponseChunkData(const uint8_t* data, size_t
         copySize = available;
     }
 
-    m_rsp.addPayload(&data[index], copySize);
+    addRspBody(&data[index], copySize);
     index += copySize;
     m_chunkIndex += copySize;
 
@@ -1024,10 +1563,11 @@ bool AsyncHttpClient::parseChunkedResponse(const uint8_t* data, size_t len, size
                 }
                 else
                 {
+                    /* The payload buffer grows geometrically with the
+                     * received chunk data, because the number of chunks
+                     * is unknown.
+                     */
                     m_chunkBodyPart = CHUNK_DATA;
-
-                    /* Extend response payload */
-                    m_rsp.extendPayload(m_chunkSize);
                 }
             }
             break;
@@ -1124,11 +1664,341 @@ bool AsyncHttpClient::parseRspHeader(const char* data, size_t len, size_t& index
     return isHeaderEOF;
 }
 
+void AsyncHttpClient::beginRspBody()
+{
+    m_isBodyStreamed = false;
+
+    /* A response, which is shared with identical requests, is buffered.
+     * The JSON parser runs in the persistent HTTP body parser task already
+     * before the first byte of the body is received. Therefore it doesn't
+     * depend on other jobs and doesn't occupy a worker during the whole
+     * reception.
+     */
+    if ((nullptr != m_onJsonRspCallback) &&
+        (nullptr != m_jsonFilter) &&
+        (nullptr != m_xJsonParserDone) &&
+        (false == isJsonParserBusy()) &&
+        (false == HttpRequestScheduler::getInstance().isCoalesced(this)) &&
+        (true == m_bodyStream.begin()))
+    {
+        m_isJsonParserBusy = true;
+
+        if (false == HttpBodyParser::getInstance().start(jsonParserJob, this))
+        {
+            /* Fallback: Buffer the body and parse it after reception. */
+            m_isJsonParserBusy = false;
+            m_bodyStream.end();
+        }
+        else
+        {
+            m_isBodyStreamed = true;
+        }
+    }
+
+    return;
+}
+
+void AsyncHttpClient::addRspBody(const uint8_t* data, size_t size)
+{
+    if (nullptr == m_inflater)
+    {
+        addDecodedRspBody(data, size);
+    }
+    else if (Inflater::STATUS_ERROR == m_inflater->write(data, size))
+    {
+        LOG_ERROR("Invalid compressed response body.");
+
+        /* The body is corrupt, therefore don't provide or cache it.
+         * The inflater stays in error state and discards the rest.
+         */
+        abortRspBody();
+        m_isRspCacheable = false;
+        m_rsp.clearPayload();
+    }
+
+    return;
+}
+
+void AsyncHttpClient::addDecodedRspBody(const uint8_t* data, size_t size)
+{
+    if (false == m_isBodyStreamed)
+    {
+        m_rsp.addPayload(data, size);
+    }
+    else
+    {
+        /* The streamed body is kept too, if it shall be cached. */
+        if (true == m_isRspCacheable)
+        {
+            size_t payloadSize = 0U;
+
+            (void)m_rsp.getPayload(payloadSize);
+
+            if (HttpCache::MAX_ENTRY_SIZE < (payloadSize + size))
+            {
+                m_isRspCacheable = false;
+                m_rsp.clearPayload();
+            }
+            else
+            {
+                m_rsp.addPayload(data, size);
+            }
+        }
+
+        if (size > m_bodyStream.write(data, size))
+        {
+            LOG_ERROR("JSON parser doesn't consume the response body.");
+            abortRspBody();
+        }
+    }
+
+    return;
+}
+
+void AsyncHttpClient::inflaterOutput(void* arg, const uint8_t* data, size_t size)
+{
+    AsyncHttpClient* client = static_cast<AsyncHttpClient*>(arg);
+
+    if (nullptr != client)
+    {
+        client->addDecodedRspBody(data, size);
+    }
+
+    return;
+}
+
+bool AsyncHttpClient::beginRspDecoding(HttpResponse::ContentCoding contentCoding)
+{
+    bool                isSuccess       = true;
+    bool                isCompressed    = true;
+    Inflater::Format    format          = Inflater::FORMAT_RAW;
+
+    endRspDecoding();
+
+    /* RFC7230 - 4.2. Compression Codings
+     * Servers send for "deflate" the zlib format or the raw deflate format,
+     * the inflater accepts both.
+     */
+    if (HttpResponse::CONTENT_CODING_IDENTITY == contentCoding)
+    {
+        isCompressed = false;
+    }
+    else if (HttpResponse::CONTENT_CODING_GZIP == contentCoding)
+    {
+        format = Inflater::FORMAT_GZIP;
+    }
+    else if (HttpResponse::CONTENT_CODING_DEFLATE == contentCoding)
+    {
+        format = Inflater::FORMAT_ZLIB;
+    }
+    /* Unsupported content coding */
+    else
+    {
+        isCompressed    = false;
+        isSuccess       = false;
+    }
+
+    if (true == isCompressed)
+    {
+        m_inflater = new Inflater();
+
+        if (nullptr == m_inflater)
+        {
+            LOG_ERROR("Not enough heap for the inflater.");
+            isSuccess = false;
+        }
+        else
+        {
+            (void)m_inflater->begin(format, inflaterOutput, this);
+        }
+    }
+
+    return isSuccess;
+}
+
+void AsyncHttpClient::endRspDecoding()
+{
+    if (nullptr != m_inflater)
+    {
+        delete m_inflater;
+        m_inflater = nullptr;
+    }
+
+    return;
+}
+
+void AsyncHttpClient::abortRspBody()
+{
+    if (true == m_isBodyStreamed)
+    {
+        m_bodyStream.abort();
+        m_isBodyStreamed = false;
+    }
+
+    return;
+}
+
+void AsyncHttpClient::parseJsonRspBody()
+{
+    PooledJsonDocument      jsonDoc(m_jsonDocSize);
+    DeserializationError    error   = deserializeJson(jsonDoc, m_bodyStream, DeserializationOption::Filter(*m_jsonFilter));
+
+    /* The parser stops after the JSON root element, but the producer
+     * shall not block because of the rest of the body.
+     */
+    m_bodyStream.drain();
+
+    if (false == m_bodyStream.isAborted())
+    {
+        m_onJsonRspCallback(error, jsonDoc);
+    }
+
+    m_bodyStream.end();
+
+    return;
+}
+
+void AsyncHttpClient::jsonParserJob(void* parameters)
+{
+    AsyncHttpClient* client = static_cast<AsyncHttpClient*>(parameters);
+
+    if (nullptr != client)
+    {
+        client->parseJsonRspBody();
+
+        /* The client may be destroyed right after, therefore it is not used anymore. */
+        (void)xSemaphoreGive(client->m_xJsonParserDone);
+    }
+
+    return;
+}
+
+bool AsyncHttpClient::isJsonParserBusy()
+{
+    /* The end of the JSON parser is taken only once. */
+    if ((true == m_isJsonParserBusy) &&
+        (pdTRUE == xSemaphoreTake(m_xJsonParserDone, 0U)))
+    {
+        m_isJsonParserBusy = false;
+    }
+
+    return m_isJsonParserBusy;
+}
+
+void AsyncHttpClient::waitForJsonParser()
+{
+    if (true == m_isJsonParserBusy)
+    {
+        (void)xSemaphoreTake(m_xJsonParserDone, portMAX_DELAY);
+        m_isJsonParserBusy = false;
+    }
+
+    return;
+}
+
+bool AsyncHttpClient::startCachedResponse()
+{
+    bool status = false;
+
+    if (true == HttpCache::getInstance().getResponse(m_cacheKey, m_rsp))
+    {
+        LOG_INFO("Use fresh cached response.");
+
+        status = deliverResponse();
+    }
+
+    return status;
+}
+
+bool AsyncHttpClient::deliverResponse()
+{
+    bool status = false;
+
+    m_isRspCacheable    = false;
+    m_isReqOpen         = true;
+
+    status = WorkerPool::getInstance().submit(deliverResponseJob, this);
+
+    if (false == status)
+    {
+        m_isReqOpen = false;
+        m_rsp.clear();
+    }
+
+    return status;
+}
+
+void AsyncHttpClient::deliverResponseJob(void* arg)
+{
+    AsyncHttpClient* client = static_cast<AsyncHttpClient*>(arg);
+
+    if (nullptr != client)
+    {
+        client->notifyResponse();
+        client->m_rsp.clear();
+        client->m_isReqOpen = false;
+    }
+
+    return;
+}
+
 void AsyncHttpClient::notifyResponse()
 {
-    if (nullptr != m_onRspCallback)
+    bool isBodyValid = true;
+
+    /* The rest of a compressed body is provided at the end of the data. */
+    if (nullptr != m_inflater)
+    {
+        if (Inflater::STATUS_DONE != m_inflater->finish())
+        {
+            LOG_ERROR("Incomplete or invalid compressed response body.");
+            isBodyValid = false;
+        }
+
+        endRspDecoding();
+    }
+
+    /* The application shall never get a truncated body. The request is
+     * finished as failed, therefore identical requests don't get it either.
+     */
+    if (false == isBodyValid)
     {
-        m_onRspCallback(m_rsp);
+        m_isRspCacheable = false;
+        abortRspBody();
+        HttpRequestScheduler::getInstance().finish(this, nullptr);
+        notifyError();
+    }
+    else
+    {
+        if (true == m_isRspCacheable)
+        {
+            HttpCache::getInstance().store(m_cacheKey, m_rsp);
+            m_isRspCacheable = false;
+        }
+
+        /* Free the request slot and share the response with identical requests. */
+        HttpRequestScheduler::getInstance().finish(this, &m_rsp);
+
+        /* Streamed body? The JSON parser notifies the application. */
+        if (true == m_isBodyStreamed)
+        {
+            m_bodyStream.close();
+            m_isBodyStreamed = false;
+        }
+        else if ((nullptr != m_onJsonRspCallback) &&
+                 (nullptr != m_jsonFilter))
+        {
+            size_t                  payloadSize = 0U;
+            const char*             payload     = reinterpret_cast<const char*>(m_rsp.getPayload(payloadSize));
+            PooledJsonDocument      jsonDoc(m_jsonDocSize);
+            DeserializationError    error       = deserializeJson(jsonDoc, payload, payloadSize, DeserializationOption::Filter(*m_jsonFilter));
+
+            m_onJsonRspCallback(error, jsonDoc);
+        }
+        else if (nullptr != m_onRspCallback)
+        {
+            m_onRspCallback(m_rsp);
+        }
     }
 }
 
@@ -1275,6 +2145,14 @@ const char* AsyncHttpClient::errorToStr(int8_t error)
         errorDescription = "Illegal argument.";
         break;
 
+    case ERR_DNS_FAILED:
+        errorDescription = "DNS failed.";
+        break;
+
+    case HttpConnectionPool::ERR_TLS_FAILED:
+        errorDescription = "TLS failed.";
+        break;
+
     default:
         break;
     }
@@ -45,8 +45,14 @@
  *****************************************************************************/
 #include <FreeRTOS.h>
 #include <AsyncTCP.h>
+#include <ArduinoJson.h>
 
 #include "HttpResponse.h"
+#include "HttpBodyStream.h"
+#include "IHttpConnectionListener.hpp"
+#include "IHttpRequestHandler.hpp"
+
+#include <Inflater.h>
 
 /******************************************************************************
  * Macros
@@ -59,11 +65,24 @@
 /**
  * Asynchronous HTTP client
  *
+ * The TCP connection is taken from the shared connection pool. If the
+ * server keeps the connection alive, it is given back to the pool after
+ * the response and reused by the next request to the same host.
+ *
+ * Every request is admitted by the request scheduler, which limits the
+ * number of parallel requests and coalesces identical GET requests.
+ *
+ * If compression is enabled, gzip and deflate coded response bodies are
+ * decompressed while they are received. The decompressed body takes the
+ * same way as a uncompressed one.
+ *
  * Used RFCs:
+ * - RFC1950, RFC1951, RFC1952 (zlib, deflate, gzip)
  * - RFC2616 (obsolete, because of RFC7230)
  * - RFC7230
+ * - RFC7231
  */
-class AsyncHttpClient
+class AsyncHttpClient : public IHttpConnectionListener, public IHttpRequestHandler
 {
 public:
 
@@ -72,6 +91,13 @@ public:
      */
     typedef std::function<void(const HttpResponse& rsp)> OnResponse;
 
+    /**
+     * Prototype of HTTP response callback for a JSON response, which was
+     * parsed while it was received. The JSON document contains only the
+     * values, which passed the filter.
+     */
+    typedef std::function<void(const DeserializationError& error, JsonDocument& jsonDoc)> OnJsonResponse;
+
     /**
      * Prototype of HTTP response callback for a closed connection.
      */
@@ -107,6 +133,14 @@ public:
      */
     void end();
 
+    /**
+     * Release the buffers of the last response, e.g. if the user is
+     * hibernated. The request parameters are kept.
+     * It does nothing, while a request is pending.
+     * Never call it from inside a callback.
+     */
+    void releaseBuffers();
+
     /**
      * Establish TCP connection.
      *
@@ -121,6 +155,7 @@ public:
 
     /**
      * Abort TCP connection (non-gracefully) and avoid any follow up callback.
+     * Never call it from inside a callback.
      */
     void abort();
 
@@ -147,11 +182,53 @@ public:
 
     /**
      * Keep connection alive or close it after a request.
+     * Default is keep alive. A kept alive connection is given back to the
+     * connection pool after the response.
      *
      * @param[in] keepAlive Keep alive (true) or close (false) it.
      */
     void setKeepAlive(bool keepAlive);
 
+    /**
+     * Enable or disable the HTTP cache for GET requests. Default is enabled.
+     * A fresh cached response is provided without any request and a
+     * validated one after the server responded with "304 Not Modified".
+     *
+     * @param[in] isEnabled Enable (true) or disable (false) the cache.
+     */
+    void setCache(bool isEnabled);
+
+    /**
+     * Enable or disable compressed responses. Default is disabled.
+     * If enabled, the server is asked for a gzip or deflate coded response
+     * body, but only if there is enough heap for the decompression window.
+     * The window takes up to 32 KB during the reception, therefore enable
+     * it only for large responses.
+     *
+     * @param[in] isEnabled Enable (true) or disable (false) compression.
+     */
+    void setCompression(bool isEnabled);
+
+    /**
+     * Set the period of a periodic request (poll). The request scheduler
+     * delays the start of a periodic request by a random jitter, which
+     * depends on the period. Default is 0 for a one-off request, which is
+     * started without delay.
+     *
+     * @param[in] period    Period in ms
+     */
+    void setPollPeriod(uint32_t period);
+
+    /**
+     * Skip the verification of the server certificate of https requests.
+     * Default is disabled, the server certificate is verified against the
+     * trusted CA certificates. Enable it only for servers in the local
+     * network, which have a self-signed certificate.
+     *
+     * @param[in] isInsecure    Skip (true) or do (false) the verification.
+     */
+    void setInsecure(bool isInsecure);
+
     /**
      * Add header to request header.
      *
@@ -189,6 +266,25 @@ public:
      */
     void regOnResponse(const OnResponse& onResponse);
 
+    /**
+     * Register callback function on JSON response reception.
+     *
+     * The response body is not buffered completely. Instead it is fed while
+     * receiving into a filtered JSON parser, which runs in the HTTP body
+     * parser task. Only the filtered values are kept, which results in a much
+     * lower peak memory for large responses. If the task is busy with another
+     * response, the body is buffered and parsed after reception as fallback.
+     * The callback is called in the context of the HTTP body parser task.
+     *
+     * If registered, the callback for a complete received response is not
+     * called anymore.
+     *
+     * @param[in] filter        JSON filter, which will be copied.
+     * @param[in] jsonDocSize   Size of the JSON document in byte, which contains the filtered values.
+     * @param[in] onJsonRsp     Callback
+     */
+    void regOnJsonResponse(const JsonDocument& filter, size_t jsonDocSize, const OnJsonResponse& onJsonRsp);
+
     /**
      * Register callback function on closed connection.
      *
@@ -267,12 +363,47 @@ private:
     /** HTTPS port */
     static const uint16_t   HTTPS_PORT  = 443U;
 
-    AsyncClient     m_tcpClient;            /**< Asynchronous TCP client */
+    /**
+     * Heap in byte, which shall be left beside the decompression window.
+     * Otherwise no compressed response is requested.
+     */
+    static const uint32_t   COMPRESSION_HEAP_RESERVE    = 16384U;
+
+    /**
+     * The payload buffer is only allocated up front for the announced
+     * content length, if it takes at most this fraction (1/x) of the largest
+     * free heap block. A larger payload buffer grows with the received data,
+     * so a wrong or hostile "Content-Length" can't exhaust the heap at once.
+     */
+    static const uint32_t   PAYLOAD_RESERVE_DIVISOR     = 2U;
+
+    /**
+     * Max. size in byte of the constant parts of the request header,
+     * which is used to pre-size the request buffer.
+     */
+    static const size_t     REQUEST_CONST_SIZE          = 384U;
+
+    /** Error id of the TCP client, if the hostname couldn't be resolved. */
+    static const int8_t     ERR_DNS_FAILED              = -55;
+
+    /** Source of the server address for the pending connection */
+    enum AddrSource
+    {
+        ADDR_SOURCE_NONE = 0,   /**< No connection pending */
+        ADDR_SOURCE_RESOLVER,   /**< Hostname is resolved by the TCP client. */
+        ADDR_SOURCE_CACHE       /**< Address is taken from the DNS cache. */
+    };
+
+    AsyncClient*    m_tcpClient;            /**< Asynchronous TCP client, provided by the connection pool */
     OnResponse      m_onRspCallback;        /**< Callback which to call for a complete response. */
+    OnJsonResponse  m_onJsonRspCallback;    /**< Callback which to call for a parsed JSON response. */
+    DynamicJsonDocument* m_jsonFilter;      /**< JSON filter for the response body */
+    size_t          m_jsonDocSize;          /**< JSON document size in byte for the filtered response body */
     OnClosed        m_onClosedCallback;     /**< Callback which to call for a closed connection. */
     OnError         m_onErrorCallback;      /**< Callback which to call for a connection error. */
     String          m_hostname;             /**< Server hostname */
     uint16_t        m_port;                 /**< Server port */
+    bool            m_isSecure;             /**< Is the connection secured by TLS (https)? */
     String          m_base64Authorization;  /**< Authorization BASE64 encoded */
     String          m_uri;                  /**< Request URI */
     String          m_headers;              /**< Additional request headers */
@@ -284,16 +415,30 @@ private:
     String          m_urlEncodedPars;       /**< URL encoded paramters (application/x-www-form-urlencoded) */
     const uint8_t*  m_payload;              /**< Request payload */
     size_t          m_payloadSize;          /**< Request payload size in byte */
+    bool            m_isCacheEnabled;       /**< Is the HTTP cache enabled for GET requests? */
+    String          m_cacheKey;             /**< Cache key of the current request, empty if not cached. */
+    bool            m_isCompressionEnabled; /**< Shall compressed responses be requested? */
+    uint32_t        m_pollPeriod;           /**< Period in ms of a periodic request, 0 for a one-off request. */
+    bool            m_isInsecure;           /**< Is the verification of the server certificate skipped? */
+    AddrSource      m_addrSource;           /**< Source of the server address for the pending connection */
+    bool            m_isRetryable;          /**< Shall the request be retried on a new connection, if the kept alive one fails? */
 
     ResponsePart    m_rspPart;              /**< Current parsing part of the response */
     HttpResponse    m_rsp;                  /**< Response */
     String          m_rspLine;              /**< Single line, used for response parsing */
     TransferCoding  m_transferCoding;       /**< Transfer coding */
     size_t          m_contentLength;        /**< Content length in byte */
+    bool            m_isRspReusable;        /**< Can the connection be reused after the current response? */
+    bool            m_isRspCacheable;       /**< Shall the current response be stored in the HTTP cache? */
     size_t          m_contentIndex;         /**< Content index */
     size_t          m_chunkSize;            /**< Chunk size in byte */
     size_t          m_chunkIndex;           /**< Chunk body index */
     ChunkBodyPart   m_chunkBodyPart;        /**< Current part of chunked response */
+    HttpBodyStream  m_bodyStream;           /**< Stream to the JSON parser */
+    bool            m_isBodyStreamed;       /**< Is the current response body streamed to the JSON parser? */
+    bool            m_isJsonParserBusy;     /**< Is the JSON parser running or its end not taken yet? */
+    SemaphoreHandle_t m_xJsonParserDone;    /**< Binary semaphore, given by the JSON parser at its end. */
+    Inflater*       m_inflater;             /**< Inflater for a compressed response body, only allocated if necessary. */
 
     AsyncHttpClient(const AsyncHttpClient& client);
     AsyncHttpClient& operator=(const AsyncHttpClient& client);
@@ -303,14 +448,14 @@ private:
      *
      * @param[in] client    TCP client
      */
-    void onConnect(AsyncClient* client);
+    void onConnect(AsyncClient* client) final;
 
     /**
      * This method is called by the TCP client if a connection is disconnected.
      *
      * @param[in] client    TCP client
      */
-    void onDisconnect(AsyncClient* client);
+    void onDisconnect(AsyncClient* client) final;
 
     /**
      * This method is called by the TCP client if a error occurred.
@@ -318,7 +463,7 @@ private:
      * @param[in] client    TCP client
      * @param[in] error     Error id
      */
-    void onError(AsyncClient* client, int8_t error);
+    void onError(AsyncClient* client, int8_t error) final;
 
     /**
      * This method is called by the TCP client if data is received.
@@ -327,7 +472,7 @@ private:
      * @param[in] data      Data stream
      * @param[in] len       Data size in byte
      */
-    void onData(AsyncClient* client, const uint8_t* data, size_t len);
+    void onData(AsyncClient* client, const uint8_t* data, size_t len) final;
 
     /**
      * This method is called by the TCP client if ACK timeout happens.
@@ -335,7 +480,89 @@ private:
      * @param[in] client    TCP client
      * @param[in] timeout   Timeout value in ms
      */
-    void onTimeout(AsyncClient* client, uint32_t timeout);
+    void onTimeout(AsyncClient* client, uint32_t timeout) final;
+
+    /**
+     * Acquire a connection from the connection pool, if not already done.
+     *
+     * @param[in] isNew Acquire a new connection instead of a kept alive one.
+     *
+     * @return If a connection is available, it will return true otherwise false.
+     */
+    bool acquireConnection(bool isNew = false);
+
+    /**
+     * Give the connection back to the connection pool.
+     *
+     * @param[in] keepAlive Keep the connection alive for reuse (true) or close it (false).
+     */
+    void releaseConnection(bool keepAlive);
+
+    /**
+     * Submit the prepared request to the request scheduler.
+     *
+     * @return If the request is queued, it will return true otherwise false.
+     */
+    bool submitRequest();
+
+    /**
+     * Start the prepared request. If a kept alive connection is available,
+     * the request is sent immediately, otherwise after the connection is
+     * established.
+     *
+     * @param[in] isNewConnection   Send the request via a new connection, instead of a kept alive one.
+     *
+     * @return If the request is sent or pending, it will return true otherwise false.
+     */
+    bool startRequest(bool isNewConnection = false);
+
+    /**
+     * Connect to the server. The server address is taken from the DNS
+     * cache, otherwise the hostname is resolved by the TCP client.
+     *
+     * @return If the connection procedure is pending, it will return true otherwise false.
+     */
+    bool connectToServer();
+
+    /**
+     * This method is called by the request scheduler, if the request is
+     * admitted.
+     *
+     * @return If the request is started, it will return true otherwise false.
+     */
+    bool onRequestStart() final;
+
+    /**
+     * This method is called by the request scheduler with the response of
+     * a identical request, instead of starting the request.
+     *
+     * @param[in] rsp   Complete response
+     */
+    void onRequestCoalesced(const HttpResponse& rsp) final;
+
+    /**
+     * Worker pool job, which notifies the application about a request,
+     * which failed to start.
+     *
+     * @param[in] arg   HTTP client instance
+     */
+    static void requestFailedJob(void* arg);
+
+    /**
+     * A kept alive connection may be closed by the server, while the request
+     * is sent. If no response byte was received yet, a idempotent request
+     * is retried once on a new connection.
+     *
+     * @return If the retry is pending, it will return true otherwise false.
+     */
+    bool retryRequest();
+
+    /**
+     * Worker pool job, which retries the request on a new connection.
+     *
+     * @param[in] arg   HTTP client instance
+     */
+    static void retryRequestJob(void* arg);
 
     /**
      * Send request to host.
@@ -443,6 +670,113 @@ private:
      */
     bool parseRspHeader(const char* data, size_t len, size_t& index);
 
+    /**
+     * Prepare the reception of the response body. If a JSON response
+     * callback is registered and the HTTP body parser task is idle, the JSON
+     * parser will be started there and the body will be streamed to it.
+     */
+    void beginRspBody();
+
+    /**
+     * Add received response body data. A compressed body is decompressed
+     * first.
+     *
+     * @param[in] data  Body data
+     * @param[in] size  Body data size in byte
+     */
+    void addRspBody(const uint8_t* data, size_t size);
+
+    /**
+     * Add decompressed or uncompressed response body data.
+     *
+     * @param[in] data  Body data
+     * @param[in] size  Body data size in byte
+     */
+    void addDecodedRspBody(const uint8_t* data, size_t size);
+
+    /**
+     * Inflater output function, which gets the decompressed response body.
+     *
+     * @param[in] arg   HTTP client instance
+     * @param[in] data  Decompressed body data
+     * @param[in] size  Decompressed body data size in byte
+     */
+    static void inflaterOutput(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * Prepare the decompression of the response body, according to its
+     * content coding.
+     *
+     * @param[in] contentCoding Content coding of the response body
+     *
+     * @return If the content coding is supported, it will return true otherwise false.
+     */
+    bool beginRspDecoding(HttpResponse::ContentCoding contentCoding);
+
+    /**
+     * Stop decompression of the response body and release the inflater.
+     */
+    void endRspDecoding();
+
+    /**
+     * Stop streaming the response body to the JSON parser, if it is running.
+     */
+    void abortRspBody();
+
+    /**
+     * Parse the streamed response body and notify the application.
+     * It runs in the context of the HTTP body parser task.
+     */
+    void parseJsonRspBody();
+
+    /**
+     * JSON parser, which parses the streamed response body. It runs in the
+     * HTTP body parser task and is started before the first byte of the
+     * body is received.
+     *
+     * @param[in] parameters    HTTP client instance
+     */
+    static void jsonParserJob(void* parameters);
+
+    /**
+     * Is the JSON parser still running?
+     * It must not be called by the JSON parser itself.
+     *
+     * @return If the JSON parser is running, it will return true otherwise false.
+     */
+    bool isJsonParserBusy();
+
+    /**
+     * Wait until the JSON parser is finished.
+     * It must not be called by the JSON parser itself.
+     */
+    void waitForJsonParser();
+
+    /**
+     * Provide the fresh cached response to the application, instead of
+     * sending the request.
+     *
+     * @return If the cached response is provided, it will return true otherwise false.
+     */
+    bool startCachedResponse();
+
+    /**
+     * Provide the response, which was not received by this client, to the
+     * application. The application is notified in the context of the worker
+     * pool, like for a received response.
+     *
+     * @return If the response is provided, it will return true otherwise false.
+     */
+    bool deliverResponse();
+
+    /**
+     * Worker pool job, which notifies the application about a response,
+     * which was not received by this client.
+     *
+     * @param[in] arg   HTTP client instance
+     */
+    static void deliverResponseJob(void* arg);
+
     /**
      * This method will be called for every complete response and provides
      * it to the application, depended on whether a application callback
@@ -38,6 +38,8 @@
 #include "CaptivePortalHandler.h"
 #include "FileSystem.h"
 #include "Settings.h"
+#include "TmplIndex.h"
+#include "WebConfig.h"
 
 /******************************************************************************
  * Compiler Switches
@@ -105,6 +107,8 @@ void CaptivePortal::init(AsyncWebServer& srv)
         Settings::getInstance().close();
     }
 
+    (void)TmplIndex::getInstance().load();
+
     /* Serve files with static content with enabled cache control.
      * The client may cache files from filesystem for 1 hour.
      */
@@ -112,6 +116,18 @@ void CaptivePortal::init(AsyncWebServer& srv)
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/images/", FILESYSTEM, "/images/", "max-age=3600")
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
+
+    /* Javascript and stylesheet files, which are referenced with their content
+     * hash as version (see scripts/prepareDataDir.py), never change. The client
+     * may cache them for 1 year without revalidation. Files requested without
+     * version are served by the next handlers.
+     */
+    (void)srv.serveStatic("/js/", FILESYSTEM, "/js/", WebConfig::VERSIONED_FILE_CACHE_CONTROL)
+        .setFilter([](AsyncWebServerRequest* request) { return request->hasParam(WebConfig::VERSION_PARAM); })
+        .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
+    (void)srv.serveStatic("/style/", FILESYSTEM, "/style/", WebConfig::VERSIONED_FILE_CACHE_CONTROL)
+        .setFilter([](AsyncWebServerRequest* request) { return request->hasParam(WebConfig::VERSION_PARAM); })
+        .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/js/", FILESYSTEM, "/js/", "max-age=3600")
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/style/", FILESYSTEM, "/style/", "max-age=3600")
@@ -36,6 +36,7 @@
 #include "Settings.h"
 #include "HttpStatus.h"
 #include "FileSystem.h"
+#include "TmplIndex.h"
 
 /******************************************************************************
  * Compiler Switches
@@ -115,7 +116,7 @@ void CaptivePortalHandler::handleRequest(AsyncWebServerRequest* request)
     }
     else if (HTTP_GET == request->method())
     {
-        request->send(FILESYSTEM, "/cp/captivePortal.html", "text/html", false, captivePortalPageProcessor);
+        TmplIndex::getInstance().send(request, "/cp/captivePortal.html", "text/html", captivePortalPageProcessor);
     }
     else
     {
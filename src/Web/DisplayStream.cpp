@@ -0,0 +1,742 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Display stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "DisplayStream.h"
+#include "DisplayMgr.h"
+
+#include <Logging.h>
+#include <Util.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void DisplayStream::init(AsyncWebSocket& server)
+{
+    const IPAddress LOOPBACK(127U, 0U, 0U, 1U);
+
+    m_server = &server;
+
+    /* The display task wakes up the AsyncTCP context via a loopback
+     * connection, to deliver the encoded frames there.
+     */
+    if (nullptr == m_wakeupServer)
+    {
+        m_wakeupServer = new AsyncServer(LOOPBACK, WAKEUP_PORT);
+
+        if (nullptr == m_wakeupServer)
+        {
+            LOG_ERROR("Display stream wakeup server not available.");
+        }
+        else
+        {
+            m_wakeupServer->onClient(onWakeupConnect, this);
+            m_wakeupServer->begin();
+        }
+    }
+
+    if (nullptr == m_wakeupClient)
+    {
+        m_wakeupClient = new AsyncClient();
+
+        if (nullptr == m_wakeupClient)
+        {
+            LOG_ERROR("Display stream wakeup client not available.");
+        }
+        else
+        {
+            m_wakeupClient->setNoDelay(true);
+            m_wakeupClient->onDisconnect(onWakeupClientDisconnect, this);
+            m_wakeupClient->onError(onWakeupClientError, this);
+            (void)m_wakeupClient->connect(LOOPBACK, WAKEUP_PORT);
+        }
+    }
+
+    DisplayMgr::getInstance().setFrameListener(this);
+
+    return;
+}
+
+bool DisplayStream::subscribe(uint32_t clientId, FrameEncoder::PixelFormat format, uint8_t maxFps)
+{
+    bool        isSuccessful    = false;
+    Subscriber* subscriber      = nullptr;
+    uint8_t     index           = 0U;
+
+    if ((FrameEncoder::PIXEL_FORMAT_MAX <= format) ||
+        (0U == maxFps) ||
+        (MAX_FPS < maxFps))
+    {
+        return false;
+    }
+
+    lock();
+
+    for(index = 0U; (index < MAX_SUBSCRIBERS) && (nullptr == subscriber); ++index)
+    {
+        if ((true == m_subscribers[index].isUsed) &&
+            (clientId == m_subscribers[index].clientId))
+        {
+            subscriber = &m_subscribers[index];
+        }
+    }
+
+    for(index = 0U; (index < MAX_SUBSCRIBERS) && (nullptr == subscriber); ++index)
+    {
+        if (false == m_subscribers[index].isUsed)
+        {
+            subscriber = &m_subscribers[index];
+
+            subscriber->isUsed      = true;
+            subscriber->clientId    = clientId;
+            ++m_subscriberCnt;
+        }
+    }
+
+    if (nullptr == subscriber)
+    {
+        LOG_WARNING("Display stream has no free subscription for client %u.", clientId);
+    }
+    else
+    {
+        /* The first frame is a key frame and sent immediately. */
+        subscriber->format      = format;
+        subscriber->period      = 1000U / maxFps;
+        subscriber->timestamp   = millis() - subscriber->period;
+        subscriber->frameNo     = 0U;
+
+        isSuccessful = true;
+    }
+
+    unlock();
+
+    return isSuccessful;
+}
+
+void DisplayStream::unsubscribe(uint32_t clientId)
+{
+    uint8_t index       = 0U;
+    uint8_t formatCnt[FrameEncoder::PIXEL_FORMAT_MAX];
+
+    lock();
+
+    memset(formatCnt, 0, sizeof(formatCnt));
+
+    for(index = 0U; index < MAX_SUBSCRIBERS; ++index)
+    {
+        Subscriber& subscriber = m_subscribers[index];
+
+        if (true == subscriber.isUsed)
+        {
+            if (clientId == subscriber.clientId)
+            {
+                subscriber.isUsed = false;
+                --m_subscriberCnt;
+            }
+            else
+            {
+                ++formatCnt[subscriber.format];
+            }
+        }
+    }
+
+    /* Release the reference frames, which are not needed anymore. */
+    for(index = 0U; index < FrameEncoder::PIXEL_FORMAT_MAX; ++index)
+    {
+        if (0U == formatCnt[index])
+        {
+            m_encoders[index].end();
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void DisplayStream::onFrame()
+{
+    uint32_t    due[FrameEncoder::PIXEL_FORMAT_MAX];
+    bool        isDue       = false;
+    uint32_t    timestamp   = 0U;
+    uint8_t     index       = 0U;
+
+    /* Nobody subscribed? The not locked access is fine, because in the worst
+     * case a new subscriber gets its first frame one period later.
+     */
+    if ((nullptr == m_server) ||
+        (0U == m_subscriberCnt))
+    {
+        return;
+    }
+
+    lock();
+
+    memset(due, 0, sizeof(due));
+    timestamp = millis();
+
+    /* The display task period jitters, therefore a subscriber is due half a
+     * period earlier. Otherwise every second possible frame would be skipped.
+     */
+    for(index = 0U; index < MAX_SUBSCRIBERS; ++index)
+    {
+        Subscriber& subscriber = m_subscribers[index];
+
+        if ((true == subscriber.isUsed) &&
+            (subscriber.period <= ((timestamp - subscriber.timestamp) + (DisplayMgr::TASK_PERIOD / 2U))))
+        {
+            due[subscriber.format] |= (1U << index);
+            isDue = true;
+        }
+    }
+
+    if (true == isDue)
+    {
+        uint8_t slotId = DisplayMgr::SLOT_ID_INVALID;
+
+        DisplayMgr::getInstance().getFBCopy(m_framebuffer, PIXEL_COUNT, &slotId);
+
+        for(index = 0U; index < FrameEncoder::PIXEL_FORMAT_MAX; ++index)
+        {
+            if (0U != due[index])
+            {
+                encode(static_cast<FrameEncoder::PixelFormat>(index), slotId, due[index]);
+            }
+        }
+
+        wakeup();
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+DisplayStream::DisplayStream() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_server(nullptr),
+    m_subscribers(),
+    m_subscriberCnt(0U),
+    m_encoders(),
+    m_framebuffer(),
+    m_frame(),
+    m_droppedFrames(0U),
+    m_deliveries(),
+    m_sentBuffers(),
+    m_wakeupServer(nullptr),
+    m_wakeupClient(nullptr),
+    m_isWakeupPending(false),
+    m_wakeupTimestamp(0U)
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_SUBSCRIBERS; ++index)
+    {
+        m_subscribers[index].isUsed = false;
+    }
+
+    for(index = 0U; index < FrameEncoder::PIXEL_FORMAT_MAX; ++index)
+    {
+        m_encoders[index].setStream(true);
+        releaseDelivery(m_deliveries[index]);
+    }
+
+    for(index = 0U; index < MAX_SENT_BUFFERS; ++index)
+    {
+        m_sentBuffers[index] = nullptr;
+    }
+}
+
+void DisplayStream::encode(FrameEncoder::PixelFormat format, uint8_t slotId, uint32_t due)
+{
+    FrameEncoder&   encoder         = m_encoders[format];
+    Delivery&       delivery        = m_deliveries[format];
+    const uint32_t  REF_FRAME_NO    = encoder.getFrameNo();
+    const uint32_t  TIMESTAMP       = millis();
+    size_t          frameSize       = 0U;
+    uint8_t         index           = 0U;
+
+    for(index = 0U; index < MAX_SUBSCRIBERS; ++index)
+    {
+        if (0U != (due & (1U << index)))
+        {
+            m_subscribers[index].timestamp = TIMESTAMP;
+        }
+    }
+
+    /* A frame, which is not delivered yet, is replaced by the newer one.
+     * Its subscribers get the newer one instead.
+     */
+    if (nullptr != delivery.frameBuffer)
+    {
+        ++m_droppedFrames;
+    }
+
+    due |= delivery.due;
+    releaseDelivery(delivery);
+
+    if (true == encoder.begin(Board::LedMatrix::width, Board::LedMatrix::height, format))
+    {
+        /* Every streamed frame is a delta to the previous one, if possible. */
+        frameSize = encoder.encode(m_frame, sizeof(m_frame), m_framebuffer, slotId, REF_FRAME_NO);
+    }
+
+    if (0U < frameSize)
+    {
+        bool isKeyFrameNeeded = false;
+
+        delivery.frameBuffer    = makeBuffer(frameSize);
+        delivery.isDelta        = (FrameEncoder::ENCODING_DELTA == encoder.getEncoding());
+        delivery.refFrameNo     = REF_FRAME_NO;
+        delivery.frameNo        = encoder.getFrameNo();
+        delivery.due            = due;
+
+        if (false == delivery.isDelta)
+        {
+            delivery.keyFrameBuffer = delivery.frameBuffer;
+        }
+        else
+        {
+            /* Only a subscriber with the reference frame can take the delta
+             * frame. The key frame is encoded once for all others.
+             */
+            for(index = 0U; (index < MAX_SUBSCRIBERS) && (false == isKeyFrameNeeded); ++index)
+            {
+                if ((0U != (due & (1U << index))) &&
+                    (REF_FRAME_NO != m_subscribers[index].frameNo))
+                {
+                    isKeyFrameNeeded = true;
+                }
+            }
+
+            if (true == isKeyFrameNeeded)
+            {
+                delivery.keyFrameBuffer = makeBuffer(encoder.encodeKeyFrame(m_frame, sizeof(m_frame), slotId));
+            }
+        }
+    }
+
+    return;
+}
+
+AsyncWebSocketMessageBuffer* DisplayStream::makeBuffer(size_t size)
+{
+    AsyncWebSocketMessageBuffer* buffer = nullptr;
+
+    if (0U < size)
+    {
+        /* Not created by the websocket server, otherwise the AsyncTCP context
+         * would release it in parallel.
+         */
+        buffer = new AsyncWebSocketMessageBuffer(m_frame, size);
+
+        if ((nullptr != buffer) &&
+            (nullptr == buffer->get()))
+        {
+            delete buffer;
+            buffer = nullptr;
+        }
+
+        if (nullptr == buffer)
+        {
+            LOG_WARNING("Display stream frame dropped, out of memory.");
+        }
+    }
+
+    return buffer;
+}
+
+void DisplayStream::wakeup()
+{
+    const uint8_t WAKEUP = 0U;
+
+    lock();
+
+    /* A pending wakeup delivers the new frames too. But if it is pending
+     * too long, it is considered lost and armed again.
+     */
+    if ((true == m_isWakeupPending) &&
+        (WAKEUP_TIMEOUT <= (millis() - m_wakeupTimestamp)))
+    {
+        LOG_WARNING("Display stream wakeup lost.");
+        m_isWakeupPending = false;
+    }
+
+    if ((false == m_isWakeupPending) &&
+        (nullptr != m_wakeupClient))
+    {
+        if (true == m_wakeupClient->disconnected())
+        {
+            /* The frames are delivered with the next wakeup. */
+            (void)m_wakeupClient->connect(IPAddress(127U, 0U, 0U, 1U), WAKEUP_PORT);
+        }
+        else if (0U < m_wakeupClient->write(reinterpret_cast<const char*>(&WAKEUP), sizeof(WAKEUP)))
+        {
+            m_isWakeupPending = true;
+            m_wakeupTimestamp = millis();
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void DisplayStream::deliver()
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    m_isWakeupPending = false;
+
+    /* Make room for the new message buffers first. */
+    releaseBuffers();
+
+    for(index = 0U; index < FrameEncoder::PIXEL_FORMAT_MAX; ++index)
+    {
+        if (nullptr != m_deliveries[index].frameBuffer)
+        {
+            deliver(m_deliveries[index]);
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void DisplayStream::deliver(Delivery& delivery)
+{
+    uint8_t index = 0U;
+
+    /* Every message buffer is kept, until it is sent. If there is no room
+     * to keep them, the frame is dropped instead.
+     */
+    if (2U > getFreeSentBuffers())
+    {
+        ++m_droppedFrames;
+        releaseDelivery(delivery);
+    }
+    else
+    {
+        for(index = 0U; index < MAX_SUBSCRIBERS; ++index)
+        {
+            Subscriber& subscriber = m_subscribers[index];
+
+            /* The subscriber may be unsubscribed in the meantime. */
+            if ((0U != (delivery.due & (1U << index))) &&
+                (true == subscriber.isUsed))
+            {
+                AsyncWebSocketClient*           client  = m_server->client(subscriber.clientId);
+                AsyncWebSocketMessageBuffer*    buffer  = delivery.keyFrameBuffer;
+
+                /* Only a subscriber with the reference frame can take the delta frame. */
+                if ((true == delivery.isDelta) &&
+                    (delivery.refFrameNo == subscriber.frameNo))
+                {
+                    buffer = delivery.frameBuffer;
+                }
+
+                /* Client still connected and frame available? */
+                if ((nullptr != client) &&
+                    (nullptr != buffer))
+                {
+                    /* Drop the frame instead of queueing it. Because the subscriber
+                     * misses the reference frame now, it gets a key frame next time.
+                     */
+                    if (true == isBackedUp(client, buffer->length()))
+                    {
+                        ++m_droppedFrames;
+                    }
+                    else
+                    {
+                        client->binary(buffer);
+                        subscriber.frameNo = delivery.frameNo;
+                    }
+                }
+            }
+        }
+
+        keepBuffer(delivery.frameBuffer);
+
+        if (delivery.frameBuffer != delivery.keyFrameBuffer)
+        {
+            keepBuffer(delivery.keyFrameBuffer);
+        }
+
+        delivery.frameBuffer    = nullptr;
+        delivery.keyFrameBuffer = nullptr;
+        releaseDelivery(delivery);
+    }
+
+    return;
+}
+
+void DisplayStream::keepBuffer(AsyncWebSocketMessageBuffer* buffer)
+{
+    uint8_t index = 0U;
+
+    if (nullptr != buffer)
+    {
+        /* Not queued by any websocket client? */
+        if (true == buffer->canDelete())
+        {
+            delete buffer;
+        }
+        else
+        {
+            for(index = 0U; (index < MAX_SENT_BUFFERS) && (nullptr != buffer); ++index)
+            {
+                if (nullptr == m_sentBuffers[index])
+                {
+                    m_sentBuffers[index] = buffer;
+                    buffer = nullptr;
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+void DisplayStream::releaseBuffers()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_SENT_BUFFERS; ++index)
+    {
+        if ((nullptr != m_sentBuffers[index]) &&
+            (true == m_sentBuffers[index]->canDelete()))
+        {
+            delete m_sentBuffers[index];
+            m_sentBuffers[index] = nullptr;
+        }
+    }
+
+    return;
+}
+
+uint8_t DisplayStream::getFreeSentBuffers() const
+{
+    uint8_t index   = 0U;
+    uint8_t cnt     = 0U;
+
+    for(index = 0U; index < MAX_SENT_BUFFERS; ++index)
+    {
+        if (nullptr == m_sentBuffers[index])
+        {
+            ++cnt;
+        }
+    }
+
+    return cnt;
+}
+
+void DisplayStream::releaseDelivery(Delivery& delivery)
+{
+    if (nullptr != delivery.frameBuffer)
+    {
+        delete delivery.frameBuffer;
+    }
+
+    if ((nullptr != delivery.keyFrameBuffer) &&
+        (delivery.frameBuffer != delivery.keyFrameBuffer))
+    {
+        delete delivery.keyFrameBuffer;
+    }
+
+    delivery.frameBuffer    = nullptr;
+    delivery.keyFrameBuffer = nullptr;
+    delivery.isDelta        = false;
+    delivery.refFrameNo     = 0U;
+    delivery.frameNo        = 0U;
+    delivery.due            = 0U;
+
+    return;
+}
+
+bool DisplayStream::isBackedUp(AsyncWebSocketClient* client, size_t size)
+{
+    bool            isBackedUp  = false;
+    AsyncClient*    tcpClient   = client->client();
+
+    /* The websocket messages are only queued, if the TCP send buffer is full.
+     * Therefore if the TCP send buffer can take the whole frame, the queue
+     * is empty or will be soon.
+     */
+    if ((WS_CONNECTED != client->status()) ||
+        (false == client->canSend()) ||
+        (nullptr == tcpClient) ||
+        (size > tcpClient->space()))
+    {
+        isBackedUp = true;
+    }
+
+    return isBackedUp;
+}
+
+void DisplayStream::onWakeupConnect(void* arg, AsyncClient* client)
+{
+    if (nullptr != client)
+    {
+        client->onData(onWakeupData, arg);
+        client->onDisconnect(onWakeupDisconnect, arg);
+    }
+
+    return;
+}
+
+void DisplayStream::onWakeupData(void* arg, AsyncClient* client, void* data, size_t len)
+{
+    DisplayStream* stream = static_cast<DisplayStream*>(arg);
+
+    UTIL_NOT_USED(client);
+    UTIL_NOT_USED(data);
+    UTIL_NOT_USED(len);
+
+    if (nullptr != stream)
+    {
+        stream->deliver();
+    }
+
+    return;
+}
+
+void DisplayStream::onWakeupDisconnect(void* arg, AsyncClient* client)
+{
+    DisplayStream* stream = static_cast<DisplayStream*>(arg);
+
+    LOG_WARNING("Display stream wakeup connection closed.");
+
+    delete client;
+
+    /* The pending wakeup may be lost. The frames are delivered right now,
+     * which arms the wakeup again.
+     */
+    if (nullptr != stream)
+    {
+        stream->deliver();
+    }
+
+    return;
+}
+
+void DisplayStream::onWakeupClientDisconnect(void* arg, AsyncClient* client)
+{
+    DisplayStream* stream = static_cast<DisplayStream*>(arg);
+
+    UTIL_NOT_USED(client);
+
+    /* The pending wakeup is lost. The frames are delivered right now, which
+     * arms the wakeup again. The display task connects again with the next
+     * wakeup.
+     */
+    if (nullptr != stream)
+    {
+        stream->deliver();
+    }
+
+    return;
+}
+
+void DisplayStream::onWakeupClientError(void* arg, AsyncClient* client, int8_t error)
+{
+    LOG_WARNING("Display stream wakeup error: %d", error);
+
+    onWakeupClientDisconnect(arg, client);
+
+    return;
+}
+
+void DisplayStream::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void DisplayStream::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
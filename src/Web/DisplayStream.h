@@ -0,0 +1,354 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Display stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __DISPLAY_STREAM_H__
+#define __DISPLAY_STREAM_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <FrameEncoder.h>
+
+#include "Board.h"
+#include "IFrameListener.hpp"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The display stream pushes the display content to all subscribed websocket
+ * clients, each with its own max. frame rate.
+ *
+ * It is driven by the display task. A frame is encoded once per pixel format
+ * into a websocket message buffer, which is shared by all subscribers. It is
+ * a delta frame to the last streamed frame. A subscriber, which didn't get
+ * the last streamed frame, gets the same frame encoded as key frame, which
+ * is shared too.
+ *
+ * The websocket clients are not thread-safe. Therefore the encoded frames
+ * are handed over to the AsyncTCP context, which queues them and releases
+ * the message buffers after they are sent. The display task wakes it up
+ * via a loopback connection. A broken or lost wakeup is detected and
+ * armed again, therefore the delivery never gets stuck.
+ *
+ * If the send queue of a subscriber is backed up, its frame is dropped
+ * instead of queueing it. It gets a key frame, as soon as it can send again.
+ */
+class DisplayStream : public IFrameListener
+{
+public:
+
+    /**
+     * Get display stream instance.
+     *
+     * @return Display stream instance
+     */
+    static DisplayStream& getInstance()
+    {
+        static DisplayStream instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Initialize the display stream and register it on the display manager.
+     *
+     * @param[in] server    Websocket server, where the subscribers are connected.
+     */
+    void init(AsyncWebSocket& server);
+
+    /**
+     * Subscribe a websocket client or change its subscription. The next
+     * frame is a key frame.
+     *
+     * @param[in] clientId  Websocket client id
+     * @param[in] format    Pixel format
+     * @param[in] maxFps    Max. frame rate in frames per second
+     *
+     * @return If successful subscribed, it will return true otherwise false.
+     */
+    bool subscribe(uint32_t clientId, FrameEncoder::PixelFormat format, uint8_t maxFps);
+
+    /**
+     * Unsubscribe a websocket client.
+     *
+     * @param[in] clientId  Websocket client id
+     */
+    void unsubscribe(uint32_t clientId);
+
+    /**
+     * Encode the shown frame for the subscribers, which are due, and hand
+     * it over to the AsyncTCP context.
+     * It is called by the display task.
+     */
+    void onFrame() final;
+
+    /**
+     * Get the number of frames, which were dropped because of a backed up
+     * send queue.
+     *
+     * @return Number of dropped frames
+     */
+    uint32_t getDroppedFrames() const
+    {
+        return m_droppedFrames;
+    }
+
+    /** Max. number of subscribers */
+    static const uint8_t    MAX_SUBSCRIBERS = 8U;
+
+    /** Max. frame rate in frames per second */
+    static const uint8_t    MAX_FPS         = 50U;
+
+private:
+
+    /** Number of pixels */
+    static const size_t     PIXEL_COUNT     = Board::LedMatrix::width * Board::LedMatrix::height;
+
+    /** Max. frame size in byte */
+    static const size_t     MAX_FRAME_SIZE  = FrameEncoder::HEADER_SIZE + (PIXEL_COUNT * FrameEncoder::MAX_BYTES_PER_PIXEL);
+
+    /** Max. number of message buffers, which are queued by websocket clients. */
+    static const uint8_t    MAX_SENT_BUFFERS = 16U;
+
+    /** Port of the loopback connection, which wakes up the AsyncTCP context. */
+    static const uint16_t   WAKEUP_PORT     = 8189U;
+
+    /** Max. time in ms a wakeup may be pending, before it is considered lost. */
+    static const uint32_t   WAKEUP_TIMEOUT  = 500U;
+
+    /** A subscribed websocket client */
+    struct Subscriber
+    {
+        bool                        isUsed;     /**< Is the subscription used? */
+        uint32_t                    clientId;   /**< Websocket client id */
+        FrameEncoder::PixelFormat   format;     /**< Pixel format */
+        uint32_t                    period;     /**< Min. period between two frames in ms */
+        uint32_t                    timestamp;  /**< Timestamp in ms of the last sent frame */
+        uint32_t                    frameNo;    /**< Number of the last sent frame, 0 if none. */
+    };
+
+    /** A encoded frame, which waits for the delivery in the AsyncTCP context. */
+    struct Delivery
+    {
+        AsyncWebSocketMessageBuffer*    frameBuffer;    /**< Frame, delta or key frame */
+        AsyncWebSocketMessageBuffer*    keyFrameBuffer; /**< Key frame for subscribers without the reference frame */
+        bool                            isDelta;        /**< Is the frame a delta frame? */
+        uint32_t                        refFrameNo;     /**< Number of the reference frame */
+        uint32_t                        frameNo;        /**< Frame number */
+        uint32_t                        due;            /**< Due subscribers, one bit per subscriber. */
+    };
+
+    SemaphoreHandle_t   m_xMutex;                                   /**< Mutex to protect the subscribers. */
+    AsyncWebSocket*     m_server;                                   /**< Websocket server */
+    Subscriber          m_subscribers[MAX_SUBSCRIBERS];             /**< Subscribers */
+    uint8_t             m_subscriberCnt;                            /**< Number of subscribers */
+    FrameEncoder        m_encoders[FrameEncoder::PIXEL_FORMAT_MAX]; /**< Frame encoder per pixel format */
+    uint32_t            m_framebuffer[PIXEL_COUNT];                 /**< Framebuffer copy */
+    uint8_t             m_frame[MAX_FRAME_SIZE];                    /**< Encoded frame */
+    uint32_t            m_droppedFrames;                            /**< Number of dropped frames */
+    Delivery            m_deliveries[FrameEncoder::PIXEL_FORMAT_MAX];   /**< Frame per pixel format, which waits for the delivery. */
+    AsyncWebSocketMessageBuffer*    m_sentBuffers[MAX_SENT_BUFFERS];    /**< Message buffers, which are queued by websocket clients. */
+    AsyncServer*        m_wakeupServer;                             /**< Loopback server, which is woken up in the AsyncTCP context. */
+    AsyncClient*        m_wakeupClient;                             /**< Loopback client, which wakes up the AsyncTCP context. */
+    bool                m_isWakeupPending;                          /**< Is a wakeup pending? */
+    uint32_t            m_wakeupTimestamp;                          /**< Timestamp in ms of the pending wakeup */
+
+    /**
+     * Constructs the display stream.
+     */
+    DisplayStream();
+
+    /**
+     * Destroys the display stream.
+     */
+    ~DisplayStream()
+    {
+        /* Will never be called. */
+    }
+
+    DisplayStream(const DisplayStream& stream);
+    DisplayStream& operator=(const DisplayStream& stream);
+
+    /**
+     * Encode the frame in the given pixel format for all due subscribers,
+     * which use this pixel format. A not delivered frame is replaced.
+     * It is called by the display task.
+     *
+     * @param[in] format    Pixel format
+     * @param[in] slotId    Id of slot, which shows the frame.
+     * @param[in] due       Due subscribers, one bit per subscriber.
+     */
+    void encode(FrameEncoder::PixelFormat format, uint8_t slotId, uint32_t due);
+
+    /**
+     * Create a shared message buffer with the encoded frame.
+     *
+     * @param[in] size  Frame size in byte
+     *
+     * @return Message buffer. If not available, it will return nullptr.
+     */
+    AsyncWebSocketMessageBuffer* makeBuffer(size_t size);
+
+    /**
+     * Wake up the AsyncTCP context to deliver the encoded frames.
+     * It is called by the display task.
+     */
+    void wakeup();
+
+    /**
+     * Queue the encoded frames for all due subscribers and release the
+     * message buffers, which are sent.
+     * It is called in the AsyncTCP context.
+     */
+    void deliver();
+
+    /**
+     * Queue the encoded frame for its due subscribers.
+     * It is called in the AsyncTCP context.
+     *
+     * @param[in] delivery  Encoded frame
+     */
+    void deliver(Delivery& delivery);
+
+    /**
+     * Keep the message buffer until it is sent to all websocket clients.
+     *
+     * @param[in] buffer    Message buffer
+     */
+    void keepBuffer(AsyncWebSocketMessageBuffer* buffer);
+
+    /**
+     * Release the message buffers, which are sent to all websocket clients.
+     */
+    void releaseBuffers();
+
+    /**
+     * Get the number of free entries in the list of sent message buffers.
+     *
+     * @return Number of free entries
+     */
+    uint8_t getFreeSentBuffers() const;
+
+    /**
+     * Release the message buffers of a not queued frame.
+     *
+     * @param[in] delivery  Encoded frame
+     */
+    static void releaseDelivery(Delivery& delivery);
+
+    /**
+     * Is the send queue of the websocket client backed up?
+     *
+     * @param[in] client    Websocket client
+     * @param[in] size      Size of the next message in byte
+     *
+     * @return If backed up, it will return true otherwise false.
+     */
+    static bool isBackedUp(AsyncWebSocketClient* client, size_t size);
+
+    /**
+     * Called by the loopback server, after the wakeup connection is accepted.
+     *
+     * @param[in] arg       Display stream
+     * @param[in] client    Accepted connection
+     */
+    static void onWakeupConnect(void* arg, AsyncClient* client);
+
+    /**
+     * Called in the AsyncTCP context, after the display task woke it up.
+     *
+     * @param[in] arg       Display stream
+     * @param[in] client    Accepted connection
+     * @param[in] data      Received data
+     * @param[in] len       Length of received data in byte
+     */
+    static void onWakeupData(void* arg, AsyncClient* client, void* data, size_t len);
+
+    /**
+     * Called after the accepted wakeup connection is disconnected.
+     *
+     * @param[in] arg       Display stream
+     * @param[in] client    Accepted connection
+     */
+    static void onWakeupDisconnect(void* arg, AsyncClient* client);
+
+    /**
+     * Called after the wakeup client is disconnected.
+     *
+     * @param[in] arg       Display stream
+     * @param[in] client    Wakeup client
+     */
+    static void onWakeupClientDisconnect(void* arg, AsyncClient* client);
+
+    /**
+     * Called after a error of the wakeup client happened.
+     *
+     * @param[in] arg       Display stream
+     * @param[in] client    Wakeup client
+     * @param[in] error     Error code
+     */
+    static void onWakeupClientError(void* arg, AsyncClient* client, int8_t error);
+
+    /**
+     * Lock the subscribers.
+     */
+    void lock();
+
+    /**
+     * Unlock the subscribers.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __DISPLAY_STREAM_H__ */
+
+/** @} */
@@ -0,0 +1,382 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  DNS cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "DnsCache.h"
+#include "WorkerPool.h"
+
+#include <WiFi.h>
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void DnsCache::process()
+{
+    uint8_t     index   = 0U;
+    uint32_t    now     = millis();
+
+    lock();
+
+    /* Only one hostname is resolved at a time in the background. */
+    while((false == m_isRefreshBusy) && (MAX_ENTRIES > index))
+    {
+        Entry& entry = m_entries[index];
+
+        if (false == entry.hostname.isEmpty())
+        {
+            uint32_t age = now - entry.timestamp;
+
+            if (entry.ttl <= age)
+            {
+                freeEntry(index);
+            }
+            else if ((true == entry.isResolved) &&
+                     (true == entry.isUsed) &&
+                     ((entry.ttl - age) <= REFRESH_TIME))
+            {
+                m_refreshHostname   = entry.hostname;
+                m_isRefreshBusy     = true;
+
+                if (false == WorkerPool::getInstance().submit(refreshJob, this))
+                {
+                    m_isRefreshBusy = false;
+                }
+            }
+        }
+
+        ++index;
+    }
+
+    unlock();
+
+    return;
+}
+
+DnsCache::Result DnsCache::lookup(const String& hostname, IPAddress& addr)
+{
+    Result  result  = RESULT_UNKNOWN;
+    uint8_t index   = 0U;
+
+    lock();
+
+    index = find(hostname);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry&      entry   = m_entries[index];
+        uint32_t    now     = millis();
+
+        if (entry.ttl <= (now - entry.timestamp))
+        {
+            freeEntry(index);
+        }
+        else
+        {
+            entry.lastUsed  = now;
+            entry.isUsed    = true;
+
+            if (true == entry.isResolved)
+            {
+                addr    = entry.addr;
+                result  = RESULT_RESOLVED;
+            }
+            else
+            {
+                result  = RESULT_UNRESOLVABLE;
+            }
+        }
+    }
+
+    unlock();
+
+    return result;
+}
+
+void DnsCache::storeResolved(const String& hostname, const IPAddress& addr)
+{
+    store(hostname, addr, true, TTL);
+
+    return;
+}
+
+void DnsCache::storeUnresolvable(const String& hostname)
+{
+    store(hostname, IPAddress(), false, NEGATIVE_TTL);
+
+    return;
+}
+
+void DnsCache::remove(const String& hostname)
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    index = find(hostname);
+
+    if (MAX_ENTRIES > index)
+    {
+        freeEntry(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+void DnsCache::clear()
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    for(index = 0U; index < MAX_ENTRIES; ++index)
+    {
+        freeEntry(index);
+    }
+
+    /* A running background resolution belongs to the old network. */
+    ++m_generation;
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+DnsCache::DnsCache() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_entries(),
+    m_refreshHostname(),
+    m_isRefreshBusy(false),
+    m_generation(0U)
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_ENTRIES; ++index)
+    {
+        Entry& entry = m_entries[index];
+
+        entry.isResolved    = false;
+        entry.timestamp     = 0U;
+        entry.ttl           = 0U;
+        entry.lastUsed      = 0U;
+        entry.isUsed        = false;
+    }
+}
+
+uint8_t DnsCache::find(const String& hostname) const
+{
+    uint8_t index   = 0U;
+    bool    isFound = false;
+
+    while((MAX_ENTRIES > index) && (false == isFound))
+    {
+        if ((false == m_entries[index].hostname.isEmpty()) &&
+            (0U != m_entries[index].hostname.equalsIgnoreCase(hostname)))
+        {
+            isFound = true;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    return index;
+}
+
+void DnsCache::store(const String& hostname, const IPAddress& addr, bool isResolved, uint32_t ttl)
+{
+    uint8_t index = 0U;
+
+    if (false == hostname.isEmpty())
+    {
+        lock();
+
+        index = find(hostname);
+
+        /* Take a free entry or replace the least recently used one. */
+        if (MAX_ENTRIES <= index)
+        {
+            uint32_t    now         = millis();
+            uint8_t     freeIndex   = MAX_ENTRIES;
+            uint8_t     lruIndex    = 0U;
+
+            for(index = 0U; index < MAX_ENTRIES; ++index)
+            {
+                if (true == m_entries[index].hostname.isEmpty())
+                {
+                    freeIndex = index;
+                }
+                else if ((now - m_entries[index].lastUsed) > (now - m_entries[lruIndex].lastUsed))
+                {
+                    lruIndex = index;
+                }
+            }
+
+            index = (MAX_ENTRIES != freeIndex) ? freeIndex : lruIndex;
+        }
+
+        m_entries[index].hostname   = hostname;
+        m_entries[index].addr       = addr;
+        m_entries[index].isResolved = isResolved;
+        m_entries[index].timestamp  = millis();
+        m_entries[index].ttl        = ttl;
+        m_entries[index].lastUsed   = m_entries[index].timestamp;
+        m_entries[index].isUsed     = false;
+
+        unlock();
+    }
+
+    return;
+}
+
+void DnsCache::freeEntry(uint8_t index)
+{
+    if (MAX_ENTRIES > index)
+    {
+        m_entries[index].hostname.clear();
+        m_entries[index].isResolved = false;
+        m_entries[index].isUsed     = false;
+    }
+
+    return;
+}
+
+void DnsCache::refresh()
+{
+    String      hostname;
+    uint32_t    generation  = 0U;
+    IPAddress   addr;
+
+    lock();
+    hostname    = m_refreshHostname;
+    generation  = m_generation;
+    unlock();
+
+    /* Blocks until the resolver responds, therefore the lock is not held. */
+    if (1 != WiFi.hostByName(hostname.c_str(), addr))
+    {
+        LOG_WARNING("Couldn't refresh address of %s.", hostname.c_str());
+    }
+    else
+    {
+        lock();
+
+        /* Don't revive a entry, which was removed in the meantime. */
+        if ((generation == m_generation) &&
+            (MAX_ENTRIES > find(hostname)))
+        {
+            LOG_INFO("Refreshed address of %s.", hostname.c_str());
+            store(hostname, addr, true, TTL);
+        }
+
+        unlock();
+    }
+
+    lock();
+    m_isRefreshBusy = false;
+    unlock();
+
+    return;
+}
+
+void DnsCache::refreshJob(void* arg)
+{
+    DnsCache* cache = static_cast<DnsCache*>(arg);
+
+    if (nullptr != cache)
+    {
+        cache->refresh();
+    }
+
+    return;
+}
+
+void DnsCache::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void DnsCache::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
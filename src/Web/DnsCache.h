@@ -0,0 +1,246 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  DNS cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __DNS_CACHE_H__
+#define __DNS_CACHE_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <IPAddress.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The DNS cache keeps the resolved addresses of the hosts, which are used
+ * by the outgoing connections. It is shared by all clients:
+ * - A resolved address is valid for a limited time. Shortly before it
+ *   expires, it is resolved again in the background, if it was used in
+ *   the meantime.
+ * - A hostname, which can't be resolved, is remembered for a short time,
+ *   so that a unavailable host doesn't cause a DNS request with every poll.
+ * - The number of entries is limited, the least recently used one is
+ *   replaced.
+ *
+ * After a WiFi reconnect the cache must be cleared, because the network
+ * and its resolver may be different.
+ */
+class DnsCache
+{
+public:
+
+    /** Lookup result */
+    enum Result
+    {
+        RESULT_UNKNOWN = 0,     /**< Hostname is not cached, it must be resolved. */
+        RESULT_RESOLVED,        /**< Hostname is resolved. */
+        RESULT_UNRESOLVABLE     /**< Hostname couldn't be resolved recently. */
+    };
+
+    /**
+     * Get DNS cache instance.
+     *
+     * @return DNS cache instance
+     */
+    static DnsCache& getInstance()
+    {
+        static DnsCache instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Process the cache and refresh the used entries shortly before
+     * they expire. Call it periodically, as long as the network is
+     * available.
+     */
+    void process();
+
+    /**
+     * Lookup a hostname.
+     *
+     * @param[in]  hostname  Hostname
+     * @param[out] addr      Resolved address, only valid if resolved.
+     *
+     * @return Lookup result
+     */
+    Result lookup(const String& hostname, IPAddress& addr);
+
+    /**
+     * Store a resolved hostname, e.g. after a connection was established
+     * by hostname.
+     *
+     * @param[in] hostname  Hostname
+     * @param[in] addr      Resolved address
+     */
+    void storeResolved(const String& hostname, const IPAddress& addr);
+
+    /**
+     * Store a hostname, which couldn't be resolved.
+     *
+     * @param[in] hostname  Hostname
+     */
+    void storeUnresolvable(const String& hostname);
+
+    /**
+     * Remove a hostname, e.g. because its address is not reachable anymore.
+     *
+     * @param[in] hostname  Hostname
+     */
+    void remove(const String& hostname);
+
+    /**
+     * Remove all entries.
+     */
+    void clear();
+
+    /** Max. number of cached hostnames */
+    static const uint8_t    MAX_ENTRIES     = 8U;
+
+    /** Time to live in ms of a resolved address */
+    static const uint32_t   TTL             = 5U * 60U * 1000U;
+
+    /** Time to live in ms of a unresolvable hostname */
+    static const uint32_t   NEGATIVE_TTL    = 30U * 1000U;
+
+    /** Time in ms before expiration, when a used address is resolved again. */
+    static const uint32_t   REFRESH_TIME    = 30U * 1000U;
+
+private:
+
+    /** Cached hostname */
+    struct Entry
+    {
+        String      hostname;       /**< Hostname, empty if the entry is unused. */
+        IPAddress   addr;           /**< Resolved address */
+        bool        isResolved;     /**< Is the hostname resolved? */
+        uint32_t    timestamp;      /**< Timestamp in ms of the resolution */
+        uint32_t    ttl;            /**< Time to live in ms */
+        uint32_t    lastUsed;       /**< Timestamp in ms of the last lookup */
+        bool        isUsed;         /**< Was it looked up since the resolution? */
+    };
+
+    SemaphoreHandle_t   m_xMutex;                   /**< Mutex to protect the entries. */
+    Entry               m_entries[MAX_ENTRIES];     /**< Cached hostnames */
+    String              m_refreshHostname;          /**< Hostname, which is resolved in the background. */
+    bool                m_isRefreshBusy;            /**< Is a background resolution running? */
+    uint32_t            m_generation;               /**< Incremented with every clear, to drop outdated background results. */
+
+    /**
+     * Constructs the DNS cache.
+     */
+    DnsCache();
+
+    /**
+     * Destroys the DNS cache.
+     */
+    ~DnsCache()
+    {
+        /* Will never be called. */
+    }
+
+    DnsCache(const DnsCache& cache);
+    DnsCache& operator=(const DnsCache& cache);
+
+    /**
+     * Find the entry of a hostname.
+     *
+     * @param[in] hostname  Hostname
+     *
+     * @return Index of the entry. If not found, it will return MAX_ENTRIES.
+     */
+    uint8_t find(const String& hostname) const;
+
+    /**
+     * Store a hostname. A existing entry is replaced, otherwise a free or
+     * the least recently used entry is taken.
+     *
+     * @param[in] hostname      Hostname
+     * @param[in] addr          Resolved address
+     * @param[in] isResolved    Is the hostname resolved?
+     * @param[in] ttl           Time to live in ms
+     */
+    void store(const String& hostname, const IPAddress& addr, bool isResolved, uint32_t ttl);
+
+    /**
+     * Free a entry.
+     *
+     * @param[in] index Index of the entry
+     */
+    void freeEntry(uint8_t index);
+
+    /**
+     * Resolve the hostname in the background and update its entry.
+     * It runs in the context of the worker pool.
+     */
+    void refresh();
+
+    /**
+     * Worker pool job, which resolves a hostname in the background.
+     *
+     * @param[in] arg   DNS cache instance
+     */
+    static void refreshJob(void* arg);
+
+    /**
+     * Lock the cache.
+     */
+    void lock();
+
+    /**
+     * Unlock the cache.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __DNS_CACHE_H__ */
+
+/** @} */
\ No newline at end of file
@@ -0,0 +1,143 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP body parser
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpBodyParser.h"
+
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool HttpBodyParser::start(ParseFunc func, void* arg)
+{
+    bool isStarted = false;
+
+    if ((nullptr != func) &&
+        (true == createTask()) &&
+        (pdTRUE == xSemaphoreTake(m_xIdle, 0U)))
+    {
+        /* The parser task is idle, therefore it doesn't access the job now. */
+        m_func  = func;
+        m_arg   = arg;
+
+        (void)xSemaphoreGive(m_xJobReady);
+        isStarted = true;
+    }
+
+    return isStarted;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool HttpBodyParser::createTask()
+{
+    if ((nullptr == m_taskHandle) &&
+        (nullptr != m_xIdle) &&
+        (nullptr != m_xJobReady))
+    {
+        if (pdPASS != xTaskCreateUniversal(parserTask,
+                                           "bodyParser",
+                                           TASK_STACK_SIZE,
+                                           this,
+                                           TASK_PRIORITY,
+                                           &m_taskHandle,
+                                           TASK_RUN_CORE))
+        {
+            LOG_ERROR("Couldn't create HTTP body parser task.");
+            m_taskHandle = nullptr;
+        }
+    }
+
+    return (nullptr != m_taskHandle);
+}
+
+void HttpBodyParser::parserTask(void* parameters)
+{
+    HttpBodyParser* parser = reinterpret_cast<HttpBodyParser*>(parameters);
+
+    if (nullptr != parser)
+    {
+        while(true)
+        {
+            if (pdTRUE == xSemaphoreTake(parser->m_xJobReady, portMAX_DELAY))
+            {
+                parser->m_func(parser->m_arg);
+
+                parser->m_func  = nullptr;
+                parser->m_arg   = nullptr;
+
+                (void)xSemaphoreGive(parser->m_xIdle);
+            }
+        }
+    }
+
+    vTaskDelete(nullptr);
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
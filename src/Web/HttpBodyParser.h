@@ -0,0 +1,168 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP body parser
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __HTTP_BODY_PARSER_H__
+#define __HTTP_BODY_PARSER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The HTTP body parser provides a single persistent task, which parses
+ * streamed response bodies, e.g. with the JSON parser. It parses one body
+ * at a time. The task is created with the first body and lives until the
+ * system restarts, therefore its stack is not allocated per response.
+ *
+ * A parse job is not queued. If the task is busy, the caller shall buffer
+ * the body and parse it after reception instead.
+ */
+class HttpBodyParser
+{
+public:
+
+    /**
+     * Parse function prototype. It runs in the context of the parser task.
+     *
+     * @param[in] arg   Parse function argument
+     */
+    typedef void (*ParseFunc)(void* arg);
+
+    /**
+     * Get HTTP body parser instance.
+     *
+     * @return HTTP body parser instance
+     */
+    static HttpBodyParser& getInstance()
+    {
+        static HttpBodyParser instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Start to parse a body in the parser task, if it is idle.
+     * It shall be called only by the TCP task.
+     *
+     * @param[in] func  Parse function
+     * @param[in] arg   Parse function argument
+     *
+     * @return If the parser task runs the parse function, it will return true otherwise false.
+     */
+    bool start(ParseFunc func, void* arg);
+
+    /** Parser task stack size in byte */
+    static const uint32_t       TASK_STACK_SIZE = 4096U;
+
+    /**
+     * Parser task priority, higher than the worker pool, but lower
+     * than the TCP task and the display task.
+     */
+    static const UBaseType_t    TASK_PRIORITY   = 2U;
+
+    /** Parser task may run on any core. */
+    static const BaseType_t     TASK_RUN_CORE   = tskNO_AFFINITY;
+
+private:
+
+    SemaphoreHandle_t   m_xIdle;        /**< Binary semaphore, given if the parser task is idle. */
+    SemaphoreHandle_t   m_xJobReady;    /**< Binary semaphore used to wake up the parser task. */
+    TaskHandle_t        m_taskHandle;   /**< Parser task handle */
+    ParseFunc           m_func;         /**< Parse function of the current body */
+    void*               m_arg;          /**< Parse function argument of the current body */
+
+    /**
+     * Constructs the HTTP body parser.
+     */
+    HttpBodyParser() :
+        m_xIdle(xSemaphoreCreateBinary()),
+        m_xJobReady(xSemaphoreCreateBinary()),
+        m_taskHandle(nullptr),
+        m_func(nullptr),
+        m_arg(nullptr)
+    {
+        if (nullptr != m_xIdle)
+        {
+            (void)xSemaphoreGive(m_xIdle);
+        }
+    }
+
+    /**
+     * Destroys the HTTP body parser.
+     */
+    ~HttpBodyParser()
+    {
+        /* Will never be called. */
+    }
+
+    HttpBodyParser(const HttpBodyParser& parser);
+    HttpBodyParser& operator=(const HttpBodyParser& parser);
+
+    /**
+     * Create the parser task, if not already done.
+     *
+     * @return If the parser task is available, it will return true otherwise false.
+     */
+    bool createTask();
+
+    /**
+     * Parser task, which runs one parse function after the other.
+     *
+     * @param[in] parameters    HTTP body parser instance
+     */
+    static void parserTask(void* parameters);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_BODY_PARSER_H__ */
+
+/** @} */
@@ -0,0 +1,407 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP body stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpBodyStream.h"
+
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+HttpBodyStream::HttpBodyStream() :
+    m_xMutex(xSemaphoreCreateMutex()),
+    m_xDataAvailable(xSemaphoreCreateBinary()),
+    m_buffer(nullptr),
+    m_bufferSize(0U),
+    m_rdIndex(0U),
+    m_count(0U),
+    m_isClosed(true),
+    m_isAborted(false),
+    m_readCache(),
+    m_readCacheIndex(0U),
+    m_readCacheCount(0U)
+{
+}
+
+HttpBodyStream::~HttpBodyStream()
+{
+    end();
+
+    if (nullptr != m_xDataAvailable)
+    {
+        vSemaphoreDelete(m_xDataAvailable);
+        m_xDataAvailable = nullptr;
+    }
+
+    if (nullptr != m_xMutex)
+    {
+        vSemaphoreDelete(m_xMutex);
+        m_xMutex = nullptr;
+    }
+}
+
+bool HttpBodyStream::begin()
+{
+    bool isSuccessful = false;
+
+    if ((nullptr != m_xMutex) &&
+        (nullptr != m_xDataAvailable))
+    {
+        lock();
+
+        /* A enlarged ring buffer of the last body is not kept. */
+        if ((nullptr != m_buffer) &&
+            (BUFFER_SIZE != m_bufferSize))
+        {
+            delete[] m_buffer;
+            m_buffer = nullptr;
+        }
+
+        if (nullptr == m_buffer)
+        {
+            m_buffer        = new uint8_t[BUFFER_SIZE];
+            m_bufferSize    = BUFFER_SIZE;
+        }
+
+        if (nullptr != m_buffer)
+        {
+            m_rdIndex           = 0U;
+            m_count             = 0U;
+            m_isClosed          = false;
+            m_isAborted         = false;
+            m_readCacheIndex    = 0U;
+            m_readCacheCount    = 0U;
+
+            isSuccessful = true;
+        }
+
+        unlock();
+
+        /* Discard signals of the last body. */
+        (void)xSemaphoreTake(m_xDataAvailable, 0U);
+    }
+
+    return isSuccessful;
+}
+
+void HttpBodyStream::end()
+{
+    lock();
+
+    if (nullptr != m_buffer)
+    {
+        delete[] m_buffer;
+        m_buffer = nullptr;
+    }
+
+    m_bufferSize    = 0U;
+    m_rdIndex       = 0U;
+    m_count         = 0U;
+    m_isClosed      = true;
+
+    unlock();
+
+    return;
+}
+
+size_t HttpBodyStream::write(const uint8_t* data, size_t size)
+{
+    size_t  written     = 0U;
+    bool    isStopped   = (nullptr == data);
+
+    lock();
+
+    while((size > written) && (false == isStopped) && (false == m_isAborted))
+    {
+        if ((nullptr == m_buffer) ||
+            (true == m_isClosed))
+        {
+            isStopped = true;
+        }
+        /* The consumer is behind, but the producer shall not wait. */
+        else if ((m_bufferSize <= m_count) &&
+                 (false == grow()))
+        {
+            isStopped = true;
+        }
+        else
+        {
+            size_t wrIndex  = (m_rdIndex + m_count) % m_bufferSize;
+            size_t copySize = m_bufferSize - m_count;
+
+            /* Copy only up to the end of the ring buffer, the rest in the next round. */
+            if ((m_bufferSize - wrIndex) < copySize)
+            {
+                copySize = m_bufferSize - wrIndex;
+            }
+
+            if ((size - written) < copySize)
+            {
+                copySize = size - written;
+            }
+
+            memcpy(&m_buffer[wrIndex], &data[written], copySize);
+            m_count += copySize;
+            written += copySize;
+        }
+    }
+
+    unlock();
+
+    if (0U < written)
+    {
+        (void)xSemaphoreGive(m_xDataAvailable);
+    }
+
+    return written;
+}
+
+void HttpBodyStream::close()
+{
+    m_isClosed = true;
+    (void)xSemaphoreGive(m_xDataAvailable);
+
+    return;
+}
+
+void HttpBodyStream::abort()
+{
+    m_isAborted = true;
+    (void)xSemaphoreGive(m_xDataAvailable);
+
+    return;
+}
+
+int HttpBodyStream::read()
+{
+    int data = -1;
+
+    if ((m_readCacheIndex < m_readCacheCount) ||
+        (true == fillReadCache()))
+    {
+        data = m_readCache[m_readCacheIndex];
+        ++m_readCacheIndex;
+    }
+
+    return data;
+}
+
+size_t HttpBodyStream::readBytes(char* buffer, size_t length)
+{
+    size_t index = 0U;
+
+    if (nullptr != buffer)
+    {
+        bool isEOS = false;
+
+        while((length > index) && (false == isEOS))
+        {
+            int data = read();
+
+            if (0 > data)
+            {
+                isEOS = true;
+            }
+            else
+            {
+                buffer[index] = static_cast<char>(data);
+                ++index;
+            }
+        }
+    }
+
+    return index;
+}
+
+void HttpBodyStream::drain()
+{
+    while(0 <= read())
+    {
+        m_readCacheIndex = m_readCacheCount;
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+bool HttpBodyStream::grow()
+{
+    bool    isSuccessful    = false;
+    size_t  newSize         = m_bufferSize * 2U;
+
+    if (MAX_BUFFER_SIZE < newSize)
+    {
+        newSize = MAX_BUFFER_SIZE;
+    }
+
+    if (m_bufferSize < newSize)
+    {
+        uint8_t* newBuffer = new uint8_t[newSize];
+
+        if (nullptr != newBuffer)
+        {
+            /* Unwrap the ring buffer content. */
+            size_t firstPart = m_bufferSize - m_rdIndex;
+
+            if (m_count < firstPart)
+            {
+                firstPart = m_count;
+            }
+
+            memcpy(newBuffer, &m_buffer[m_rdIndex], firstPart);
+            memcpy(&newBuffer[firstPart], m_buffer, m_count - firstPart);
+
+            delete[] m_buffer;
+
+            m_buffer        = newBuffer;
+            m_bufferSize    = newSize;
+            m_rdIndex       = 0U;
+
+            isSuccessful = true;
+        }
+    }
+
+    return isSuccessful;
+}
+
+bool HttpBodyStream::fillReadCache()
+{
+    bool isAvailable    = false;
+    bool isEOS          = false;
+
+    m_readCacheIndex = 0U;
+    m_readCacheCount = 0U;
+
+    while((false == isAvailable) && (false == isEOS) && (false == m_isAborted))
+    {
+        lock();
+
+        if ((nullptr != m_buffer) &&
+            (0U < m_count))
+        {
+            size_t copySize = m_count;
+
+            /* Copy only up to the end of the ring buffer, the rest in the next round. */
+            if ((m_bufferSize - m_rdIndex) < copySize)
+            {
+                copySize = m_bufferSize - m_rdIndex;
+            }
+
+            if (READ_CACHE_SIZE < copySize)
+            {
+                copySize = READ_CACHE_SIZE;
+            }
+
+            memcpy(m_readCache, &m_buffer[m_rdIndex], copySize);
+            m_rdIndex = (m_rdIndex + copySize) % m_bufferSize;
+            m_count -= copySize;
+            m_readCacheCount = copySize;
+
+            isAvailable = true;
+        }
+        else if ((nullptr == m_buffer) ||
+                 (true == m_isClosed))
+        {
+            isEOS = true;
+        }
+
+        unlock();
+
+        /* Wait until the producer wrote data or closed the stream. */
+        if ((false == isAvailable) &&
+            (false == isEOS) &&
+            (pdTRUE != xSemaphoreTake(m_xDataAvailable, pdMS_TO_TICKS(READ_TIMEOUT))))
+        {
+            isEOS = true;
+        }
+    }
+
+    return isAvailable;
+}
+
+void HttpBodyStream::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTake(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void HttpBodyStream::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,214 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP body stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __HTTP_BODY_STREAM_H__
+#define __HTTP_BODY_STREAM_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * A byte stream between the TCP receive context, which writes the HTTP
+ * response body and a consumer task, which reads it, e.g. the JSON parser.
+ * Usually only a small ring buffer is used, independent of the body size.
+ *
+ * The writer never blocks, because it runs in the TCP task. If the consumer
+ * is behind, the ring buffer grows up to MAX_BUFFER_SIZE. Only if this is
+ * not enough, the data is not accepted anymore.
+ *
+ * It provides read() and readBytes(), therefore it can be used as custom
+ * reader for ArduinoJson.
+ */
+class HttpBodyStream
+{
+public:
+
+    /**
+     * Constructs the stream.
+     */
+    HttpBodyStream();
+
+    /**
+     * Destroys the stream.
+     */
+    ~HttpBodyStream();
+
+    /**
+     * Open the stream for a new body. Any old data is discarded.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool begin();
+
+    /**
+     * Release the ring buffer. Call it after the consumer finished reading.
+     */
+    void end();
+
+    /**
+     * Write data to the stream. It never blocks. If the ring buffer is full,
+     * it will be enlarged.
+     *
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of written bytes. Less than size, if the max. buffer size is reached or in case of abort.
+     */
+    size_t write(const uint8_t* data, size_t size);
+
+    /**
+     * Signal the end of the body. The consumer reads the remaining data and
+     * gets a end of stream afterwards.
+     */
+    void close();
+
+    /**
+     * Abort the stream. The producer and the consumer return immediately.
+     */
+    void abort();
+
+    /**
+     * Is the stream aborted?
+     *
+     * @return If aborted, it will return true otherwise false.
+     */
+    bool isAborted() const
+    {
+        return m_isAborted;
+    }
+
+    /**
+     * Read a single byte. If no data is available, it will block until
+     * data is written, the stream is closed or the read timeout elapsed.
+     *
+     * @return Byte or -1 at the end of the stream.
+     */
+    int read();
+
+    /**
+     * Read several bytes.
+     *
+     * @param[out] buffer   Buffer
+     * @param[in]  length   Buffer size in byte
+     *
+     * @return Number of read bytes. Less than length at the end of the stream.
+     */
+    size_t readBytes(char* buffer, size_t length);
+
+    /**
+     * Read and discard all data until the end of the stream.
+     */
+    void drain();
+
+    /** Initial ring buffer size in byte, about one TCP segment. */
+    static const size_t     BUFFER_SIZE     = 2048U;
+
+    /** Max. ring buffer size in byte, if the consumer is behind. */
+    static const size_t     MAX_BUFFER_SIZE = 16384U;
+
+    /** Max. number of bytes the consumer takes from the ring buffer at once. */
+    static const size_t     READ_CACHE_SIZE = 64U;
+
+    /** Max. time in ms the consumer waits for data. */
+    static const uint32_t   READ_TIMEOUT    = 10000U;
+
+private:
+
+    SemaphoreHandle_t   m_xMutex;                       /**< Mutex to protect the ring buffer. */
+    SemaphoreHandle_t   m_xDataAvailable;               /**< Binary semaphore, given if data was written or the stream closed. */
+    uint8_t*            m_buffer;                       /**< Ring buffer */
+    size_t              m_bufferSize;                   /**< Ring buffer size in byte */
+    size_t              m_rdIndex;                      /**< Ring buffer read index */
+    size_t              m_count;                        /**< Number of bytes in the ring buffer */
+    volatile bool       m_isClosed;                     /**< Is the end of the body written? */
+    volatile bool       m_isAborted;                    /**< Is the stream aborted? */
+    uint8_t             m_readCache[READ_CACHE_SIZE];   /**< Consumer side cache, to avoid locking per byte. */
+    size_t              m_readCacheIndex;               /**< Read index in the cache */
+    size_t              m_readCacheCount;               /**< Number of bytes in the cache */
+
+    HttpBodyStream(const HttpBodyStream& stream);
+    HttpBodyStream& operator=(const HttpBodyStream& stream);
+
+    /**
+     * Enlarge the ring buffer to the double size, but not above
+     * MAX_BUFFER_SIZE. The ring buffer must be locked.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool grow();
+
+    /**
+     * Fill the consumer side cache from the ring buffer.
+     * Blocks until data is available, the end of the stream is reached or
+     * the read timeout elapsed.
+     *
+     * @return If data is available, it will return true otherwise false.
+     */
+    bool fillReadCache();
+
+    /**
+     * Lock the ring buffer.
+     */
+    void lock();
+
+    /**
+     * Unlock the ring buffer.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_BODY_STREAM_H__ */
+
+/** @} */
@@ -0,0 +1,483 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP response cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpCache.h"
+
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static bool getDirectiveValue(const String& value, const char* directive, uint32_t& seconds);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool HttpCache::isFresh(const String& key)
+{
+    bool    isFresh = false;
+    uint8_t index   = 0U;
+
+    lock();
+
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry* entry = m_entries[index];
+
+        if ((true == entry->hasMaxAge) &&
+            ((millis() - entry->timestamp) < entry->maxAge))
+        {
+            isFresh = true;
+        }
+    }
+
+    unlock();
+
+    return isFresh;
+}
+
+bool HttpCache::getResponse(const String& key, HttpResponse& rsp)
+{
+    bool    isAvailable = false;
+    uint8_t index       = 0U;
+
+    lock();
+
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry* entry = m_entries[index];
+
+        entry->lastUsed = millis();
+        rsp             = entry->rsp;
+        isAvailable     = true;
+    }
+
+    unlock();
+
+    return isAvailable;
+}
+
+bool HttpCache::getValidators(const String& key, String& eTag, String& lastModified)
+{
+    bool    isAvailable = false;
+    uint8_t index       = 0U;
+
+    lock();
+
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry* entry = m_entries[index];
+
+        eTag            = entry->eTag;
+        lastModified    = entry->lastModified;
+        isAvailable     = true;
+    }
+
+    unlock();
+
+    return isAvailable;
+}
+
+bool HttpCache::isCacheable(HttpResponse& rsp, bool isAuthorized)
+{
+    bool        isCacheable     = false;
+    String      cacheControl    = rsp.getHeader("Cache-Control");
+    uint32_t    maxAge          = 0U;
+
+    /* RFC7234 - 3. Storing Responses in Caches
+     * Only successful responses are cached and only if the server allows it.
+     */
+    if ((200U == rsp.getStatusCode()) &&
+        (0 > cacheControl.indexOf("no-store")) &&
+        (0 > cacheControl.indexOf("private")))
+    {
+        /* RFC7234 - 3.2. Storing Responses to Authenticated Requests
+         * The cache is shared, therefore a response to a request with
+         * credentials is only stored, if the server explicit allows it.
+         */
+        if ((true == isAuthorized) &&
+            (0 > cacheControl.indexOf("public")))
+        {
+            isCacheable = false;
+        }
+        /* A response without validators must be at least fresh for a while. */
+        else if ((false == rsp.getHeader("ETag").isEmpty()) ||
+                 (false == rsp.getHeader("Last-Modified").isEmpty()))
+        {
+            isCacheable = true;
+        }
+        else if ((0 > cacheControl.indexOf("no-cache")) &&
+                 (true == getDirectiveValue(cacheControl, "max-age", maxAge)) &&
+                 (0U < maxAge))
+        {
+            isCacheable = true;
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    return isCacheable;
+}
+
+void HttpCache::store(const String& key, HttpResponse& rsp)
+{
+    size_t  size    = 0U;
+    uint8_t index   = 0U;
+
+    (void)rsp.getPayload(size);
+
+    lock();
+
+    /* Replace a outdated response. */
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        removeEntry(index);
+    }
+
+    if (MAX_ENTRY_SIZE < size)
+    {
+        LOG_INFO("Response too large for cache: %u byte.", size);
+    }
+    else
+    {
+        index = makeRoom(size);
+
+        if (MAX_ENTRIES > index)
+        {
+            Entry* entry = new Entry();
+
+            if (nullptr == entry)
+            {
+                LOG_ERROR("Couldn't allocate cache entry.");
+            }
+            else
+            {
+                entry->key          = key;
+                entry->eTag         = (nullptr == rsp.getETag()) ? "" : rsp.getETag();
+                entry->lastModified = rsp.getHeader("Last-Modified");
+                entry->lastUsed     = millis();
+                entry->size         = size;
+                entry->rsp          = rsp;
+
+                updateFreshness(*entry, rsp);
+
+                m_entries[index]    = entry;
+                m_size             += size;
+
+                LOG_INFO("Cached %s (%u byte).", key.c_str(), size);
+            }
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+bool HttpCache::revalidate(const String& key, HttpResponse& notModifiedRsp, HttpResponse& rsp)
+{
+    bool    isAvailable = false;
+    uint8_t index       = 0U;
+
+    lock();
+
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry* entry = m_entries[index];
+
+        updateFreshness(*entry, notModifiedRsp);
+
+        entry->lastUsed = millis();
+        rsp             = entry->rsp;
+        isAvailable     = true;
+    }
+
+    unlock();
+
+    return isAvailable;
+}
+
+void HttpCache::remove(const String& key)
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    index = find(key);
+
+    if (MAX_ENTRIES > index)
+    {
+        removeEntry(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+HttpCache::HttpCache() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_entries(),
+    m_size(0U)
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_ENTRIES; ++index)
+    {
+        m_entries[index] = nullptr;
+    }
+}
+
+uint8_t HttpCache::find(const String& key) const
+{
+    uint8_t index   = 0U;
+    bool    isFound = false;
+
+    while((MAX_ENTRIES > index) && (false == isFound))
+    {
+        if ((nullptr != m_entries[index]) &&
+            (key == m_entries[index]->key))
+        {
+            isFound = true;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    return index;
+}
+
+void HttpCache::removeEntry(uint8_t index)
+{
+    if ((MAX_ENTRIES > index) &&
+        (nullptr != m_entries[index]))
+    {
+        m_size -= m_entries[index]->size;
+
+        delete m_entries[index];
+        m_entries[index] = nullptr;
+    }
+
+    return;
+}
+
+uint8_t HttpCache::makeRoom(size_t size)
+{
+    uint8_t freeIndex   = MAX_ENTRIES;
+    bool    isFinished  = false;
+
+    while(false == isFinished)
+    {
+        uint32_t    now         = millis();
+        uint8_t     lruIndex    = MAX_ENTRIES;
+        uint8_t     index       = 0U;
+
+        freeIndex = MAX_ENTRIES;
+
+        for(index = 0U; index < MAX_ENTRIES; ++index)
+        {
+            if (nullptr == m_entries[index])
+            {
+                freeIndex = index;
+            }
+            else if ((MAX_ENTRIES == lruIndex) ||
+                     ((now - m_entries[index]->lastUsed) > (now - m_entries[lruIndex]->lastUsed)))
+            {
+                lruIndex = index;
+            }
+        }
+
+        if ((MAX_ENTRIES != freeIndex) &&
+            ((m_size + size) <= MAX_SIZE))
+        {
+            isFinished = true;
+        }
+        /* Remove least recently used response. */
+        else if (MAX_ENTRIES != lruIndex)
+        {
+            removeEntry(lruIndex);
+        }
+        /* Cache is empty, but still not enough room. */
+        else
+        {
+            freeIndex   = MAX_ENTRIES;
+            isFinished  = true;
+        }
+    }
+
+    return freeIndex;
+}
+
+void HttpCache::updateFreshness(Entry& entry, HttpResponse& rsp)
+{
+    String      cacheControl    = rsp.getHeader("Cache-Control");
+    String      ageValue        = rsp.getHeader("Age");
+    uint32_t    maxAge          = 0U;
+    uint32_t    age             = 0U;
+
+    /* RFC7234 - 4.2.1. Calculating Freshness Lifetime
+     * Only the "max-age" directive is considered. A response with "no-cache"
+     * must always be validated by the server.
+     */
+    entry.hasMaxAge = false;
+    entry.maxAge    = 0U;
+    entry.timestamp = millis();
+
+    if ((0 > cacheControl.indexOf("no-cache")) &&
+        (true == getDirectiveValue(cacheControl, "max-age", maxAge)))
+    {
+        /* The response may already be some time in a intermediate cache. */
+        if (false == ageValue.isEmpty())
+        {
+            age = static_cast<uint32_t>(ageValue.toInt());
+        }
+
+        if (maxAge > age)
+        {
+            uint32_t lifetime = maxAge - age;
+
+            /* Avoid a overflow of the lifetime in ms. */
+            if (MAX_FRESHNESS < lifetime)
+            {
+                lifetime = MAX_FRESHNESS;
+            }
+
+            entry.hasMaxAge = true;
+            entry.maxAge    = lifetime * 1000U;
+        }
+    }
+
+    return;
+}
+
+void HttpCache::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void HttpCache::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Get the value of a Cache-Control directive, e.g. "max-age=3600".
+ *
+ * @param[in]   value       Cache-Control header value
+ * @param[in]   directive   Directive name
+ * @param[out]  seconds     Directive value in s
+ *
+ * @return If the directive is available, it will return true otherwise false.
+ */
+static bool getDirectiveValue(const String& value, const char* directive, uint32_t& seconds)
+{
+    bool    isAvailable = false;
+    int     index       = value.indexOf(directive);
+
+    if (0 <= index)
+    {
+        index += strlen(directive);
+
+        if ('=' == value[index])
+        {
+            long number = value.substring(index + 1).toInt();
+
+            if (0 <= number)
+            {
+                seconds     = static_cast<uint32_t>(number);
+                isAvailable = true;
+            }
+        }
+    }
+
+    return isAvailable;
+}
@@ -0,0 +1,263 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP response cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __HTTP_CACHE_H__
+#define __HTTP_CACHE_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+
+#include "HttpResponse.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The HTTP cache keeps successful GET responses in RAM, according to
+ * RFC7234. A cached response is used
+ * - without any request, as long as it is fresh ("Cache-Control: max-age"),
+ * - after the server confirmed with "304 Not Modified", that it is still
+ *   valid ("ETag" and "Last-Modified" validators).
+ *
+ * The cache is shared by all requests. Therefore a response is not stored,
+ * if it is private or if the request carried credentials and the response
+ * is not explicit public.
+ *
+ * The cache is limited in the number of entries and in the payload size.
+ * If it is full, the least recently used entry is removed.
+ */
+class HttpCache
+{
+public:
+
+    /**
+     * Get HTTP cache instance.
+     *
+     * @return HTTP cache instance
+     */
+    static HttpCache& getInstance()
+    {
+        static HttpCache instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Is a fresh response for the given key available? A fresh response
+     * can be used without asking the server.
+     *
+     * @param[in] key   Cache key
+     *
+     * @return If a fresh response is available, it will return true otherwise false.
+     */
+    bool isFresh(const String& key);
+
+    /**
+     * Get the cached response.
+     *
+     * @param[in]   key Cache key
+     * @param[out]  rsp Cached response
+     *
+     * @return If a response is available, it will return true otherwise false.
+     */
+    bool getResponse(const String& key, HttpResponse& rsp);
+
+    /**
+     * Get the validators of the cached response, which are used for a
+     * conditional request.
+     *
+     * @param[in]   key             Cache key
+     * @param[out]  eTag            Entity tag, may be empty.
+     * @param[out]  lastModified    Last modification date, may be empty.
+     *
+     * @return If a response is available, it will return true otherwise false.
+     */
+    bool getValidators(const String& key, String& eTag, String& lastModified);
+
+    /**
+     * Is the response allowed to be cached and does it provide at least
+     * a validator or a freshness lifetime? Only the header is considered,
+     * not the payload.
+     *
+     * @param[in] rsp           Response with status line and headers
+     * @param[in] isAuthorized  Did the request carry credentials?
+     *
+     * @return If the response is cacheable, it will return true otherwise false.
+     */
+    static bool isCacheable(HttpResponse& rsp, bool isAuthorized);
+
+    /**
+     * Store a complete response. A already cached response with the same
+     * key is replaced.
+     *
+     * @param[in] key   Cache key
+     * @param[in] rsp   Complete response
+     */
+    void store(const String& key, HttpResponse& rsp);
+
+    /**
+     * Revalidate the cached response with a "304 Not Modified" response
+     * and get it. The freshness lifetime is updated by the 304 response.
+     *
+     * @param[in]   key             Cache key
+     * @param[in]   notModifiedRsp  Received "304 Not Modified" response
+     * @param[out]  rsp             Cached response
+     *
+     * @return If a response is available, it will return true otherwise false.
+     */
+    bool revalidate(const String& key, HttpResponse& notModifiedRsp, HttpResponse& rsp);
+
+    /**
+     * Remove the cached response.
+     *
+     * @param[in] key   Cache key
+     */
+    void remove(const String& key);
+
+    /** Max. number of cached responses */
+    static const uint8_t    MAX_ENTRIES     = 8U;
+
+    /** Max. payload size in byte of all cached responses */
+    static const size_t     MAX_SIZE        = 12U * 1024U;
+
+    /** Max. payload size in byte of a single cached response */
+    static const size_t     MAX_ENTRY_SIZE  = 4U * 1024U;
+
+private:
+
+    /**
+     * Max. freshness lifetime in s. It keeps the lifetime in ms below the
+     * half millis() range, therefore the elapsed time can be compared.
+     */
+    static const uint32_t   MAX_FRESHNESS   = (UINT32_MAX / 2U) / 1000U;
+
+    /** A cached response */
+    struct Entry
+    {
+        String          key;            /**< Cache key */
+        String          eTag;           /**< Entity tag */
+        String          lastModified;   /**< Last modification date */
+        bool            hasMaxAge;      /**< Is the freshness lifetime known? */
+        uint32_t        maxAge;         /**< Freshness lifetime in ms */
+        uint32_t        timestamp;      /**< Timestamp in ms of the last validation */
+        uint32_t        lastUsed;       /**< Timestamp in ms of the last usage */
+        size_t          size;           /**< Payload size in byte */
+        HttpResponse    rsp;            /**< Response */
+    };
+
+    SemaphoreHandle_t   m_xMutex;               /**< Mutex to protect the entries. */
+    Entry*              m_entries[MAX_ENTRIES]; /**< Cached responses */
+    size_t              m_size;                 /**< Payload size in byte of all cached responses */
+
+    /**
+     * Constructs the HTTP cache.
+     */
+    HttpCache();
+
+    /**
+     * Destroys the HTTP cache.
+     */
+    ~HttpCache()
+    {
+        /* Will never be called. */
+    }
+
+    HttpCache(const HttpCache& cache);
+    HttpCache& operator=(const HttpCache& cache);
+
+    /**
+     * Find the entry with the given key.
+     *
+     * @param[in] key   Cache key
+     *
+     * @return Index of the entry. If not found, it will return MAX_ENTRIES.
+     */
+    uint8_t find(const String& key) const;
+
+    /**
+     * Remove the entry at the given index.
+     *
+     * @param[in] index Index of the entry
+     */
+    void removeEntry(uint8_t index);
+
+    /**
+     * Remove least recently used entries, until the given number of bytes
+     * and a free entry are available.
+     *
+     * @param[in] size  Required payload size in byte
+     *
+     * @return Index of a free entry.
+     */
+    uint8_t makeRoom(size_t size);
+
+    /**
+     * Update the freshness lifetime of a entry by the response headers.
+     *
+     * @param[in] entry Entry
+     * @param[in] rsp   Response with headers
+     */
+    static void updateFreshness(Entry& entry, HttpResponse& rsp);
+
+    /**
+     * Lock the cache.
+     */
+    void lock();
+
+    /**
+     * Unlock the cache.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_CACHE_H__ */
+
+/** @} */
@@ -0,0 +1,631 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP connection pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpConnectionPool.h"
+
+#include <Logging.h>
+#include <Util.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+AsyncClient* HttpConnectionPool::acquire(const String& hostname, uint16_t port, bool isSecure, bool isInsecure, IHttpConnectionListener* listener, bool isNew)
+{
+    Connection* connection  = nullptr;
+    uint8_t     index       = 0U;
+
+    if (nullptr == listener)
+    {
+        return nullptr;
+    }
+
+    lock();
+
+    /* Reuse a idle connection to the same host. */
+    for(index = 0U; (index < MAX_CONNECTIONS) && (nullptr == connection) && (false == isNew); ++index)
+    {
+        Connection& candidate = m_connections[index];
+
+        if ((false == candidate.isInUse) &&
+            (nullptr != candidate.client) &&
+            (true == candidate.client->connected()) &&
+            (port == candidate.port) &&
+            (isSecure == candidate.isSecure) &&
+            (((true == isSecure) && (true == isInsecure)) == candidate.isInsecure) &&
+            (hostname == candidate.hostname))
+        {
+            connection = &candidate;
+
+            LOG_INFO("Reuse connection to %s:%u.", hostname.c_str(), port);
+        }
+    }
+
+    if (nullptr == connection)
+    {
+        connection = findFreeConnection();
+
+        if (nullptr != connection)
+        {
+            if (nullptr == connection->client)
+            {
+                connection->client = new AsyncClient();
+
+                if (nullptr != connection->client)
+                {
+                    connection->client->onConnect(onConnect, connection);
+                    connection->client->onDisconnect(onDisconnect, connection);
+                    connection->client->onError(onError, connection);
+                    connection->client->onData(onData, connection);
+                    connection->client->onTimeout(onTimeout, connection);
+                    connection->client->onAck(onAck, connection);
+                }
+            }
+
+            /* The TLS client is kept for the next secure connection in this slot. */
+            if ((true == isSecure) &&
+                (nullptr == connection->tls))
+            {
+                connection->tls = new TlsClient();
+            }
+
+            if ((nullptr == connection->client) ||
+                ((true == isSecure) && (nullptr == connection->tls)))
+            {
+                connection = nullptr;
+            }
+            else
+            {
+                connection->hostname    = hostname;
+                connection->port        = port;
+                connection->isSecure    = isSecure;
+                connection->isInsecure  = (true == isSecure) && (true == isInsecure);
+            }
+        }
+    }
+
+    if (nullptr == connection)
+    {
+        LOG_WARNING("No free connection for %s:%u.", hostname.c_str(), port);
+    }
+    else
+    {
+        connection->listener    = listener;
+        connection->isInUse     = true;
+
+        /* The idle timeout applies only to idle connections. */
+        connection->client->setRxTimeout(0U);
+    }
+
+    unlock();
+
+    return (nullptr == connection) ? nullptr : connection->client;
+}
+
+void HttpConnectionPool::release(AsyncClient* client, bool keepAlive)
+{
+    uint8_t index = 0U;
+
+    if (nullptr == client)
+    {
+        return;
+    }
+
+    lock();
+
+    for(index = 0U; index < MAX_CONNECTIONS; ++index)
+    {
+        Connection& connection = m_connections[index];
+
+        if (client == connection.client)
+        {
+            connection.listener = nullptr;
+            connection.isInUse  = false;
+            connection.lastUsed = millis();
+
+            if ((true == keepAlive) &&
+                (true == client->connected()) &&
+                ((false == connection.isSecure) || (TlsClient::STATE_CONNECTED == connection.tls->getState())))
+            {
+                /* The TCP client closes the connection, if nothing is received within the timeout. */
+                client->setRxTimeout(IDLE_TIMEOUT);
+            }
+            else
+            {
+                /* Notify the server about the closing TLS session before the connection is closed. */
+                if (nullptr != connection.tls)
+                {
+                    connection.tls->end();
+                }
+
+                client->close(true);
+            }
+
+            /* The listener may be destroyed after the release. If it is
+             * notified by another task right now, wait until it returns.
+             * A release inside the notification itself must not wait.
+             */
+            while ((0U < connection.notifyCnt) &&
+                   (xTaskGetCurrentTaskHandle() != connection.notifier))
+            {
+                connection.isWaiting = true;
+                unlock();
+                (void)xSemaphoreTake(connection.xNotified, portMAX_DELAY);
+                lock();
+            }
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+size_t HttpConnectionPool::write(AsyncClient* client, const char* data, size_t size, uint8_t apiflags)
+{
+    size_t      written     = 0U;
+    Connection* connection  = nullptr;
+
+    if ((nullptr == client) ||
+        (nullptr == data))
+    {
+        return 0U;
+    }
+
+    lock();
+    connection = findConnection(client);
+    unlock();
+
+    if (nullptr == connection)
+    {
+        written = 0U;
+    }
+    else if (true == connection->isSecure)
+    {
+        written = connection->tls->write(reinterpret_cast<const uint8_t*>(data), size);
+    }
+    else
+    {
+        written = client->write(data, size, apiflags);
+    }
+
+    return written;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+HttpConnectionPool::HttpConnectionPool() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_connections()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_CONNECTIONS; ++index)
+    {
+        Connection& connection = m_connections[index];
+
+        connection.client   = nullptr;
+        connection.port     = 0U;
+        connection.isSecure = false;
+        connection.isInsecure   = false;
+        connection.tls      = nullptr;
+        connection.listener     = nullptr;
+        connection.isInUse      = false;
+        connection.lastUsed     = 0U;
+        connection.notifyCnt    = 0U;
+        connection.notifier     = nullptr;
+        connection.isWaiting    = false;
+        connection.xNotified    = xSemaphoreCreateBinary();
+    }
+}
+
+HttpConnectionPool::Connection* HttpConnectionPool::findFreeConnection()
+{
+    Connection* connection  = nullptr;
+    Connection* lru         = nullptr;
+    uint32_t    now         = millis();
+    uint8_t     index       = 0U;
+
+    for(index = 0U; (index < MAX_CONNECTIONS) && (nullptr == connection); ++index)
+    {
+        Connection& candidate = m_connections[index];
+
+        if (false == candidate.isInUse)
+        {
+            /* Never used or closed idle connection? */
+            if ((nullptr == candidate.client) ||
+                (false == candidate.client->connected()))
+            {
+                connection = &candidate;
+            }
+            else if ((nullptr == lru) ||
+                     ((now - candidate.lastUsed) > (now - lru->lastUsed)))
+            {
+                lru = &candidate;
+            }
+        }
+    }
+
+    /* Close the least recently used idle connection and take its slot. */
+    if ((nullptr == connection) &&
+        (nullptr != lru))
+    {
+        LOG_INFO("Close idle connection to %s:%u.", lru->hostname.c_str(), lru->port);
+
+        if (nullptr != lru->tls)
+        {
+            lru->tls->end();
+        }
+
+        lru->client->close(true);
+        connection = lru;
+    }
+
+    return connection;
+}
+
+IHttpConnectionListener* HttpConnectionPool::beginNotification(void* arg)
+{
+    IHttpConnectionListener*    listener    = nullptr;
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    if (nullptr != connection)
+    {
+        lock();
+
+        listener = connection->listener;
+
+        if (nullptr != listener)
+        {
+            ++connection->notifyCnt;
+            connection->notifier = xTaskGetCurrentTaskHandle();
+        }
+
+        unlock();
+    }
+
+    return listener;
+}
+
+void HttpConnectionPool::endNotification(void* arg, IHttpConnectionListener* listener)
+{
+    Connection* connection = static_cast<Connection*>(arg);
+
+    if ((nullptr != connection) &&
+        (nullptr != listener))
+    {
+        lock();
+
+        --connection->notifyCnt;
+
+        if ((0U == connection->notifyCnt) &&
+            (true == connection->isWaiting))
+        {
+            connection->isWaiting = false;
+            (void)xSemaphoreGive(connection->xNotified);
+        }
+
+        unlock();
+    }
+
+    return;
+}
+
+HttpConnectionPool::Connection* HttpConnectionPool::findConnection(AsyncClient* client)
+{
+    Connection* connection  = nullptr;
+    uint8_t     index       = 0U;
+
+    for(index = 0U; (index < MAX_CONNECTIONS) && (nullptr == connection); ++index)
+    {
+        if (client == m_connections[index].client)
+        {
+            connection = &m_connections[index];
+        }
+    }
+
+    return connection;
+}
+
+void HttpConnectionPool::handleTlsFailure(Connection* connection)
+{
+    IHttpConnectionListener* listener = beginNotification(connection);
+
+    if (nullptr != listener)
+    {
+        listener->onError(connection->client, ERR_TLS_FAILED);
+    }
+
+    endNotification(connection, listener);
+
+    connection->tls->end();
+    connection->client->close(true);
+
+    return;
+}
+
+void HttpConnectionPool::onConnect(void* arg, AsyncClient* client)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    /* A secure connection is established for the listener after the TLS handshake. */
+    if ((nullptr != connection) &&
+        (true == connection->isSecure))
+    {
+        if (false == connection->tls->begin(connection->hostname, connection->port, tlsSend, connection, connection->isInsecure))
+        {
+            getInstance().handleTlsFailure(connection);
+        }
+    }
+    else if (nullptr != listener)
+    {
+        listener->onConnect(client);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::onDisconnect(void* arg, AsyncClient* client)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    if ((nullptr != connection) &&
+        (nullptr != connection->tls))
+    {
+        connection->tls->end();
+    }
+
+    /* A idle connection was closed by the server or by the idle timeout.
+     * Nothing to do, because its slot is free again.
+     */
+    if (nullptr != listener)
+    {
+        listener->onDisconnect(client);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::onError(void* arg, AsyncClient* client, int8_t error)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    if ((nullptr != connection) &&
+        (nullptr != connection->tls))
+    {
+        connection->tls->end();
+    }
+
+    if (nullptr != listener)
+    {
+        listener->onError(client, error);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::onData(void* arg, AsyncClient* client, void* data, size_t len)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    if ((nullptr != connection) &&
+        (true == connection->isSecure))
+    {
+        TlsClient*  tls         = connection->tls;
+        bool        isHandshake = (TlsClient::STATE_HANDSHAKE == tls->getState());
+
+        /* The decrypted data is forwarded by the TLS client. */
+        if (false == tls->receive(static_cast<const uint8_t*>(data), len, tlsReceive, connection))
+        {
+            if (TlsClient::STATE_CLOSED == tls->getState())
+            {
+                client->close(true);
+            }
+            else
+            {
+                getInstance().handleTlsFailure(connection);
+            }
+        }
+        else if ((true == isHandshake) &&
+                 (TlsClient::STATE_CONNECTED == tls->getState()) &&
+                 (nullptr != listener))
+        {
+            listener->onConnect(client);
+        }
+    }
+    else if (nullptr != listener)
+    {
+        listener->onData(client, static_cast<const uint8_t*>(data), len);
+    }
+    /* A idle connection shall not receive data. */
+    else if (nullptr != client)
+    {
+        client->close(true);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::onTimeout(void* arg, AsyncClient* client, uint32_t timeout)
+{
+    IHttpConnectionListener* listener = getInstance().beginNotification(arg);
+
+    if (nullptr != listener)
+    {
+        listener->onTimeout(client, timeout);
+    }
+    else if (nullptr != client)
+    {
+        client->close(true);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::onAck(void* arg, AsyncClient* client, size_t len, uint32_t time)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    UTIL_NOT_USED(len);
+    UTIL_NOT_USED(time);
+
+    if ((nullptr != connection) &&
+        (true == connection->isSecure))
+    {
+        TlsClient*  tls         = connection->tls;
+        bool        isHandshake = (TlsClient::STATE_HANDSHAKE == tls->getState());
+
+        if (false == tls->flush())
+        {
+            getInstance().handleTlsFailure(connection);
+        }
+        /* The last handshake message may be sent after the acknowledge. */
+        else if ((true == isHandshake) &&
+                 (TlsClient::STATE_CONNECTED == tls->getState()) &&
+                 (nullptr != listener))
+        {
+            listener->onConnect(client);
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+size_t HttpConnectionPool::tlsSend(void* arg, const uint8_t* data, size_t size)
+{
+    size_t      written     = 0U;
+    Connection* connection  = static_cast<Connection*>(arg);
+
+    if (nullptr != connection)
+    {
+        written = connection->client->write(reinterpret_cast<const char*>(data), size);
+    }
+
+    return written;
+}
+
+void HttpConnectionPool::tlsReceive(void* arg, const uint8_t* data, size_t size)
+{
+    IHttpConnectionListener*    listener    = getInstance().beginNotification(arg);
+    Connection*                 connection  = static_cast<Connection*>(arg);
+
+    if (nullptr != listener)
+    {
+        listener->onData(connection->client, data, size);
+    }
+    /* A idle connection shall not receive data. */
+    else if (nullptr != connection)
+    {
+        connection->client->close(true);
+    }
+
+    getInstance().endNotification(arg, listener);
+
+    return;
+}
+
+void HttpConnectionPool::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void HttpConnectionPool::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
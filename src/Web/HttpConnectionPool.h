@@ -0,0 +1,325 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP connection pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __HTTP_CONNECTION_POOL_H__
+#define __HTTP_CONNECTION_POOL_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <AsyncTCP.h>
+
+#include "IHttpConnectionListener.hpp"
+#include "TlsClient.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The HTTP connection pool provides the TCP connections for all HTTP clients.
+ * A connection, which was kept alive by the server, is returned to the pool
+ * after the response and reused by the next request to the same host and
+ * port, independent of the HTTP client instance. This saves the DNS lookup
+ * and the TCP handshake.
+ *
+ * The number of connections is limited. A idle connection is closed by the
+ * pool after the idle timeout or if its slot is needed for another host.
+ *
+ * A secure connection is encrypted by TLS. The listener is notified about
+ * the established connection after the TLS handshake and gets only the
+ * decrypted data. A kept alive secure connection keeps its TLS session,
+ * therefore reusing it saves the handshake too.
+ *
+ * The listener is notified without holding the pool lock, because it may
+ * use the pool or other locks in its handlers. After a connection is
+ * released, its listener is never called again, therefore it may be
+ * destroyed right after the release.
+ */
+class HttpConnectionPool
+{
+public:
+
+    /**
+     * Get connection pool instance.
+     *
+     * @return Connection pool instance
+     */
+    static HttpConnectionPool& getInstance()
+    {
+        static HttpConnectionPool instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Acquire a connection for the given host and port. If a idle connection
+     * to the host is available, it will be provided and is already connected.
+     * Otherwise a disconnected one is provided and the caller has to connect.
+     * All events of the connection are forwarded to the listener, until it
+     * is released.
+     *
+     * @param[in] hostname      Server hostname
+     * @param[in] port          Server port
+     * @param[in] isSecure      Shall the connection be secured by TLS?
+     * @param[in] isInsecure    Skip the verification of the server certificate of a secure connection?
+     * @param[in] listener      Listener for the connection events
+     * @param[in] isNew         Provide a new connection instead of a idle one.
+     *
+     * @return TCP client. If no connection is available, it will return nullptr.
+     */
+    AsyncClient* acquire(const String& hostname, uint16_t port, bool isSecure, bool isInsecure, IHttpConnectionListener* listener, bool isNew = false);
+
+    /**
+     * Release a connection. If it shall be kept alive and is still connected,
+     * it will become idle and can be reused. Otherwise it will be closed.
+     * No further events are forwarded to the listener. If the listener is
+     * notified by another task in the meantime, it waits until the
+     * notification is finished.
+     *
+     * @param[in] client    TCP client
+     * @param[in] keepAlive Keep the connection alive for reuse (true) or close it (false).
+     */
+    void release(AsyncClient* client, bool keepAlive);
+
+    /**
+     * Send data via a acquired connection. The data of a secure connection
+     * is encrypted.
+     *
+     * @param[in] client    TCP client
+     * @param[in] data      Data
+     * @param[in] size      Data size in byte
+     * @param[in] apiflags  TCP client write flags, only used for not secure connections.
+     *
+     * @return Number of sent bytes
+     */
+    size_t write(AsyncClient* client, const char* data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+
+    /** Error id, which is reported to the listener, if the TLS handshake or the decryption failed. */
+    static const int8_t     ERR_TLS_FAILED  = -56;
+
+    /** Max. number of connections, in use and idle. */
+    static const uint8_t    MAX_CONNECTIONS = 6U;
+
+    /** Idle connections are closed after this timeout in s without received data. */
+    static const uint32_t   IDLE_TIMEOUT    = 15U;
+
+private:
+
+    /** A pooled connection */
+    struct Connection
+    {
+        AsyncClient*                client;     /**< TCP client */
+        String                      hostname;   /**< Server hostname */
+        uint16_t                    port;       /**< Server port */
+        bool                        isSecure;   /**< Is the connection secured by TLS? */
+        bool                        isInsecure; /**< Is the server certificate of the secure connection not verified? */
+        TlsClient*                  tls;        /**< TLS client, only allocated for secure connections. */
+        IHttpConnectionListener*    listener;   /**< Listener, only set while the connection is in use. */
+        bool                        isInUse;    /**< Is the connection in use? */
+        uint32_t                    lastUsed;   /**< Timestamp in ms of the last release */
+        uint8_t                     notifyCnt;  /**< Number of listener notifications in progress */
+        TaskHandle_t                notifier;   /**< Task, which notifies the listener */
+        bool                        isWaiting;  /**< Is a release waiting for the end of the notifications? */
+        SemaphoreHandle_t           xNotified;  /**< Signals the end of the notifications to the waiting release. */
+    };
+
+    SemaphoreHandle_t   m_xMutex;                           /**< Mutex to protect the connections. */
+    Connection          m_connections[MAX_CONNECTIONS];     /**< Connections */
+
+    /**
+     * Constructs the connection pool.
+     */
+    HttpConnectionPool();
+
+    /**
+     * Destroys the connection pool.
+     */
+    ~HttpConnectionPool()
+    {
+        /* Will never be called. */
+    }
+
+    HttpConnectionPool(const HttpConnectionPool& pool);
+    HttpConnectionPool& operator=(const HttpConnectionPool& pool);
+
+    /**
+     * Find the connection slot for a new connection. A unused slot is
+     * preferred, otherwise the least recently used idle connection is closed.
+     *
+     * @return Connection slot. If all connections are in use, it will return nullptr.
+     */
+    Connection* findFreeConnection();
+
+    /**
+     * Begin a notification of the listener of a connection. As long as the
+     * notification is in progress, a release by another task waits.
+     * If a listener is returned, the notification must be finished by
+     * endNotification().
+     *
+     * @param[in] arg   Connection
+     *
+     * @return Listener. If the connection is idle, it will return nullptr.
+     */
+    IHttpConnectionListener* beginNotification(void* arg);
+
+    /**
+     * End the notification of the listener of a connection.
+     *
+     * @param[in] arg       Connection
+     * @param[in] listener  Listener, returned by beginNotification().
+     */
+    void endNotification(void* arg, IHttpConnectionListener* listener);
+
+    /**
+     * Find the connection of a TCP client.
+     *
+     * @param[in] client    TCP client
+     *
+     * @return Connection. If not found, it will return nullptr.
+     */
+    Connection* findConnection(AsyncClient* client);
+
+    /**
+     * Handle a TLS failure of a connection. The listener is notified and the
+     * connection is closed.
+     *
+     * @param[in] connection    Connection
+     */
+    void handleTlsFailure(Connection* connection);
+
+    /**
+     * TCP client connect event handler.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     */
+    static void onConnect(void* arg, AsyncClient* client);
+
+    /**
+     * TCP client disconnect event handler.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     */
+    static void onDisconnect(void* arg, AsyncClient* client);
+
+    /**
+     * TCP client error event handler.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     * @param[in] error     Error id
+     */
+    static void onError(void* arg, AsyncClient* client, int8_t error);
+
+    /**
+     * TCP client data event handler.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     * @param[in] data      Data stream
+     * @param[in] len       Data size in byte
+     */
+    static void onData(void* arg, AsyncClient* client, void* data, size_t len);
+
+    /**
+     * TCP client ACK timeout event handler.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     * @param[in] timeout   Timeout value in ms
+     */
+    static void onTimeout(void* arg, AsyncClient* client, uint32_t timeout);
+
+    /**
+     * TCP client ACK event handler. The acknowledged data frees space in
+     * the transport, which is used to send a pending TLS record.
+     *
+     * @param[in] arg       Connection
+     * @param[in] client    TCP client
+     * @param[in] len       Number of acknowledged bytes
+     * @param[in] time      Round trip time in ms
+     */
+    static void onAck(void* arg, AsyncClient* client, size_t len, uint32_t time);
+
+    /**
+     * TLS client send function, which sends the encrypted data.
+     *
+     * @param[in] arg   Connection
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    static size_t tlsSend(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * TLS client receive function, which forwards the decrypted data.
+     *
+     * @param[in] arg   Connection
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     */
+    static void tlsReceive(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * Lock the connections.
+     */
+    void lock();
+
+    /**
+     * Unlock the connections.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_CONNECTION_POOL_H__ */
+
+/** @} */
@@ -0,0 +1,532 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP request scheduler
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpRequestScheduler.h"
+
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void HttpRequestScheduler::process()
+{
+    uint8_t     running = 0U;
+    uint8_t     index   = 0U;
+    uint32_t    now     = millis();
+
+    lock();
+
+    for(index = 0U; index < MAX_REQUESTS; ++index)
+    {
+        if (STATE_RUNNING == m_requests[index].state)
+        {
+            ++running;
+        }
+    }
+
+    /* Start the due requests, as long as the limit is not reached.
+     * The lock is kept, so that a request can not be cancelled and its
+     * handler destroyed during the start.
+     */
+    for(index = 0U; (index < MAX_REQUESTS) && (MAX_RUNNING > running); ++index)
+    {
+        Request& request = m_requests[index];
+
+        if ((STATE_QUEUED == request.state) &&
+            ((now - request.timestamp) >= request.delay) &&
+            (0U == getBackoff(request.hostname)))
+        {
+            request.state = STATE_RUNNING;
+
+            if (false == request.handler->onRequestStart())
+            {
+                LOG_WARNING("Request to %s failed to start.", request.hostname.c_str());
+
+                updateHost(request.hostname, true);
+                freeRequest(index);
+            }
+            else
+            {
+                ++running;
+            }
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+bool HttpRequestScheduler::submit(IHttpRequestHandler* handler, const String& hostname, const String& key, uint32_t period)
+{
+    bool    isQueued    = false;
+    uint8_t index       = 0U;
+    uint8_t freeIndex   = MAX_REQUESTS;
+    uint8_t leaderIndex = MAX_REQUESTS;
+
+    if (nullptr == handler)
+    {
+        return false;
+    }
+
+    lock();
+
+    /* A handler has only one request at a time. */
+    index = find(handler);
+
+    if (MAX_REQUESTS > index)
+    {
+        freeRequest(index);
+    }
+
+    for(index = 0U; index < MAX_REQUESTS; ++index)
+    {
+        Request& request = m_requests[index];
+
+        if (STATE_FREE == request.state)
+        {
+            freeIndex = index;
+        }
+        else if ((MAX_REQUESTS == leaderIndex) &&
+                 (false == key.isEmpty()) &&
+                 (true == request.isJoinable) &&
+                 ((STATE_QUEUED == request.state) || (STATE_RUNNING == request.state)) &&
+                 (key == request.key))
+        {
+            leaderIndex = index;
+        }
+    }
+
+    if (true == isCircuitOpen(hostname))
+    {
+        LOG_WARNING("Requests to %s are suspended.", hostname.c_str());
+    }
+    else if (MAX_REQUESTS == freeIndex)
+    {
+        LOG_WARNING("Too many requests.");
+    }
+    else
+    {
+        Request& request = m_requests[freeIndex];
+
+        request.handler     = handler;
+        request.hostname    = hostname;
+        request.key         = key;
+        request.jitter      = period / JITTER_DIVIDER;
+        request.isJoinable  = false;
+        request.leader      = nullptr;
+
+        if (JITTER_MAX < request.jitter)
+        {
+            request.jitter = JITTER_MAX;
+        }
+
+        if (MAX_REQUESTS != leaderIndex)
+        {
+            LOG_INFO("Request joins a identical request.");
+
+            request.state   = STATE_FOLLOWING;
+            request.leader  = m_requests[leaderIndex].handler;
+        }
+        else
+        {
+            queue(request);
+        }
+
+        isQueued = true;
+    }
+
+    unlock();
+
+    return isQueued;
+}
+
+void HttpRequestScheduler::finish(IHttpRequestHandler* handler, const HttpResponse* rsp)
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    index = find(handler);
+
+    if ((MAX_REQUESTS > index) &&
+        (STATE_RUNNING == m_requests[index].state))
+    {
+        bool isFailed = (nullptr == rsp);
+
+        /* A overloaded server shall get a break too. */
+        if ((false == isFailed) &&
+            ((429U == rsp->getStatusCode()) || (500U <= rsp->getStatusCode())))
+        {
+            isFailed = true;
+        }
+
+        updateHost(m_requests[index].hostname, isFailed);
+
+        /* Provide the response to all identical requests. */
+        if (nullptr != rsp)
+        {
+            uint8_t followerIndex = 0U;
+
+            for(followerIndex = 0U; followerIndex < MAX_REQUESTS; ++followerIndex)
+            {
+                Request& follower = m_requests[followerIndex];
+
+                if ((STATE_FOLLOWING == follower.state) &&
+                    (handler == follower.leader))
+                {
+                    follower.handler->onRequestCoalesced(*rsp);
+                    freeRequest(followerIndex);
+                }
+            }
+        }
+
+        freeRequest(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+void HttpRequestScheduler::cancel(IHttpRequestHandler* handler)
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    index = find(handler);
+
+    if (MAX_REQUESTS > index)
+    {
+        freeRequest(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+bool HttpRequestScheduler::isCoalesced(IHttpRequestHandler* handler)
+{
+    bool    isCoalesced = false;
+    uint8_t index       = 0U;
+
+    lock();
+
+    index = find(handler);
+
+    if (MAX_REQUESTS > index)
+    {
+        uint8_t followerIndex = 0U;
+
+        m_requests[index].isJoinable = false;
+
+        for(followerIndex = 0U; (followerIndex < MAX_REQUESTS) && (false == isCoalesced); ++followerIndex)
+        {
+            if ((STATE_FOLLOWING == m_requests[followerIndex].state) &&
+                (handler == m_requests[followerIndex].leader))
+            {
+                isCoalesced = true;
+            }
+        }
+    }
+
+    unlock();
+
+    return isCoalesced;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+HttpRequestScheduler::HttpRequestScheduler() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_requests(),
+    m_hosts()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_REQUESTS; ++index)
+    {
+        Request& request = m_requests[index];
+
+        request.handler     = nullptr;
+        request.state       = STATE_FREE;
+        request.timestamp   = 0U;
+        request.delay       = 0U;
+        request.jitter      = 0U;
+        request.isJoinable  = false;
+        request.leader      = nullptr;
+    }
+
+    for(index = 0U; index < MAX_HOSTS; ++index)
+    {
+        Host& host = m_hosts[index];
+
+        host.failures   = 0U;
+        host.timestamp  = 0U;
+        host.backoff    = 0U;
+    }
+}
+
+uint8_t HttpRequestScheduler::find(const IHttpRequestHandler* handler) const
+{
+    uint8_t index   = 0U;
+    bool    isFound = false;
+
+    while((MAX_REQUESTS > index) && (false == isFound))
+    {
+        if ((STATE_FREE != m_requests[index].state) &&
+            (handler == m_requests[index].handler))
+        {
+            isFound = true;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    return index;
+}
+
+void HttpRequestScheduler::freeRequest(uint8_t index)
+{
+    uint8_t followerIndex   = 0U;
+    Request& request        = m_requests[index];
+
+    /* The identical requests have to be sent on their own now. */
+    for(followerIndex = 0U; followerIndex < MAX_REQUESTS; ++followerIndex)
+    {
+        Request& follower = m_requests[followerIndex];
+
+        if ((STATE_FOLLOWING == follower.state) &&
+            (request.handler == follower.leader))
+        {
+            follower.leader = nullptr;
+            queue(follower);
+        }
+    }
+
+    request.handler = nullptr;
+    request.state   = STATE_FREE;
+    request.hostname.clear();
+    request.key.clear();
+
+    return;
+}
+
+void HttpRequestScheduler::queue(Request& request)
+{
+    request.state       = STATE_QUEUED;
+    request.timestamp   = millis();
+    request.delay       = 0U;
+    request.isJoinable  = true;
+
+    if (0U < request.jitter)
+    {
+        request.delay = static_cast<uint32_t>(random(0, request.jitter + 1U));
+    }
+
+    return;
+}
+
+uint8_t HttpRequestScheduler::findHost(const String& hostname) const
+{
+    uint8_t index   = 0U;
+    bool    isFound = false;
+
+    while((MAX_HOSTS > index) && (false == isFound))
+    {
+        if ((0U < m_hosts[index].failures) &&
+            (hostname == m_hosts[index].hostname))
+        {
+            isFound = true;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    return index;
+}
+
+uint32_t HttpRequestScheduler::getBackoff(const String& hostname) const
+{
+    uint32_t    backoff = 0U;
+    uint8_t     index   = findHost(hostname);
+
+    if (MAX_HOSTS > index)
+    {
+        const Host& host    = m_hosts[index];
+        uint32_t    elapsed = millis() - host.timestamp;
+
+        if (host.backoff > elapsed)
+        {
+            backoff = host.backoff - elapsed;
+        }
+    }
+
+    return backoff;
+}
+
+bool HttpRequestScheduler::isCircuitOpen(const String& hostname) const
+{
+    bool    isOpen  = false;
+    uint8_t index   = findHost(hostname);
+
+    /* After the backoff a single request may try again (half-open). */
+    if ((MAX_HOSTS > index) &&
+        (CIRCUIT_THRESHOLD <= m_hosts[index].failures) &&
+        (0U < getBackoff(hostname)))
+    {
+        isOpen = true;
+    }
+
+    return isOpen;
+}
+
+void HttpRequestScheduler::updateHost(const String& hostname, bool isFailed)
+{
+    uint8_t index = findHost(hostname);
+
+    if (false == isFailed)
+    {
+        /* Success resets the statistic and frees the entry. */
+        if (MAX_HOSTS > index)
+        {
+            m_hosts[index].failures = 0U;
+            m_hosts[index].hostname.clear();
+        }
+    }
+    else
+    {
+        /* Only hosts with failures are tracked. */
+        if (MAX_HOSTS == index)
+        {
+            index = 0U;
+
+            while((MAX_HOSTS > index) && (0U < m_hosts[index].failures))
+            {
+                ++index;
+            }
+
+            if (MAX_HOSTS > index)
+            {
+                m_hosts[index].hostname = hostname;
+            }
+        }
+
+        if (MAX_HOSTS > index)
+        {
+            Host&   host    = m_hosts[index];
+            uint8_t shift   = 0U;
+
+            if (UINT8_MAX > host.failures)
+            {
+                ++host.failures;
+            }
+
+            shift           = host.failures - 1U;
+            host.backoff    = BACKOFF_MAX;
+            host.timestamp  = millis();
+
+            if ((16U > shift) &&
+                ((BACKOFF_BASE << shift) < BACKOFF_MAX))
+            {
+                host.backoff = BACKOFF_BASE << shift;
+            }
+
+            LOG_WARNING("Request to %s failed %u times, backoff %u ms.", hostname.c_str(), host.failures, host.backoff);
+        }
+    }
+
+    return;
+}
+
+void HttpRequestScheduler::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void HttpRequestScheduler::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,289 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP request scheduler
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __HTTP_REQUEST_SCHEDULER_H__
+#define __HTTP_REQUEST_SCHEDULER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+
+#include "HttpResponse.h"
+#include "IHttpRequestHandler.hpp"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The HTTP request scheduler admits all outgoing requests of the HTTP
+ * clients:
+ * - Only a limited number of requests run at the same time, the others
+ *   are queued.
+ * - A periodic request (poll) is delayed by a random jitter, so that
+ *   requests of plugins with the same period don't start all at once, e.g.
+ *   after boot or a WiFi reconnect. The jitter scales with the period.
+ *   A one-off request, e.g. a user action, is started without delay.
+ * - After a failed request, the next requests to the same host are delayed
+ *   by a exponential backoff. After several failures in a row, new requests
+ *   to the host are rejected until the backoff expired (circuit breaker).
+ * - A GET request, which is identical to a queued or running one, is not
+ *   sent again. Its handler gets a copy of the response instead.
+ */
+class HttpRequestScheduler
+{
+public:
+
+    /**
+     * Get request scheduler instance.
+     *
+     * @return Request scheduler instance
+     */
+    static HttpRequestScheduler& getInstance()
+    {
+        static HttpRequestScheduler instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Process the queued requests and start the admitted ones.
+     * Call it periodically, as long as the network is available.
+     */
+    void process();
+
+    /**
+     * Submit a request. It is started later via the handler.
+     *
+     * @param[in] handler   Request handler
+     * @param[in] hostname  Server hostname
+     * @param[in] key       Identifies identical GET requests. If empty, the request is never coalesced.
+     * @param[in] period    Period in ms of a periodic request. 0 for a one-off request, which is not delayed.
+     *
+     * @return If the request is queued, it will return true otherwise false.
+     */
+    bool submit(IHttpRequestHandler* handler, const String& hostname, const String& key, uint32_t period = 0U);
+
+    /**
+     * Finish a running request. Identical requests get a copy of the response.
+     *
+     * @param[in] handler   Request handler
+     * @param[in] rsp       Complete response or nullptr if the request failed.
+     */
+    void finish(IHttpRequestHandler* handler, const HttpResponse* rsp);
+
+    /**
+     * Remove a request, independent of its state.
+     *
+     * @param[in] handler   Request handler
+     */
+    void cancel(IHttpRequestHandler* handler);
+
+    /**
+     * Does the response of the running request have to be copied to
+     * identical requests? After this call, no further request can join it,
+     * because the caller decides now how to receive the response.
+     *
+     * @param[in] handler   Request handler
+     *
+     * @return If the response is shared, it will return true otherwise false.
+     */
+    bool isCoalesced(IHttpRequestHandler* handler);
+
+    /** Max. number of submitted requests */
+    static const uint8_t    MAX_REQUESTS        = 12U;
+
+    /** Max. number of requests, which run at the same time */
+    static const uint8_t    MAX_RUNNING         = 2U;
+
+    /** Max. random start delay of a periodic request in ms */
+    static const uint32_t   JITTER_MAX          = 2000U;
+
+    /** The random start delay of a periodic request is limited to its period divided by it. */
+    static const uint32_t   JITTER_DIVIDER      = 10U;
+
+    /** Max. number of hosts, whose failures are tracked */
+    static const uint8_t    MAX_HOSTS           = 8U;
+
+    /** Backoff in ms after the first failure, doubled with every further failure */
+    static const uint32_t   BACKOFF_BASE        = 5000U;
+
+    /** Max. backoff in ms */
+    static const uint32_t   BACKOFF_MAX         = 15U * 60U * 1000U;
+
+    /** Number of failures in a row, which open the circuit breaker */
+    static const uint8_t    CIRCUIT_THRESHOLD   = 3U;
+
+private:
+
+    /** Request state */
+    enum State
+    {
+        STATE_FREE = 0, /**< Unused request entry */
+        STATE_QUEUED,   /**< Request waits for admission */
+        STATE_RUNNING,  /**< Request is running */
+        STATE_FOLLOWING /**< Request waits for the response of a identical request */
+    };
+
+    /** A submitted request */
+    struct Request
+    {
+        IHttpRequestHandler*    handler;    /**< Request handler */
+        String                  hostname;   /**< Server hostname */
+        String                  key;        /**< Key to identify identical requests */
+        State                   state;      /**< Request state */
+        uint32_t                timestamp;  /**< Timestamp in ms of the submission */
+        uint32_t                delay;      /**< Start delay in ms */
+        uint32_t                jitter;     /**< Max. random start delay in ms */
+        bool                    isJoinable; /**< Can identical requests still join? */
+        IHttpRequestHandler*    leader;     /**< Handler of the identical request, which is sent. */
+    };
+
+    /** Failure statistic of a host */
+    struct Host
+    {
+        String                  hostname;   /**< Server hostname */
+        uint8_t                 failures;   /**< Number of failures in a row */
+        uint32_t                timestamp;  /**< Timestamp in ms of the last failure */
+        uint32_t                backoff;    /**< Backoff in ms */
+    };
+
+    SemaphoreHandle_t   m_xMutex;                   /**< Mutex to protect the requests and hosts. */
+    Request             m_requests[MAX_REQUESTS];   /**< Submitted requests */
+    Host                m_hosts[MAX_HOSTS];         /**< Failure statistics of hosts */
+
+    /**
+     * Constructs the request scheduler.
+     */
+    HttpRequestScheduler();
+
+    /**
+     * Destroys the request scheduler.
+     */
+    ~HttpRequestScheduler()
+    {
+        /* Will never be called. */
+    }
+
+    HttpRequestScheduler(const HttpRequestScheduler& scheduler);
+    HttpRequestScheduler& operator=(const HttpRequestScheduler& scheduler);
+
+    /**
+     * Find the request of the given handler.
+     *
+     * @param[in] handler   Request handler
+     *
+     * @return Index of the request. If not found, it will return MAX_REQUESTS.
+     */
+    uint8_t find(const IHttpRequestHandler* handler) const;
+
+    /**
+     * Free a request. All requests, which follow it, are queued again to
+     * be sent on their own.
+     *
+     * @param[in] index Index of the request
+     */
+    void freeRequest(uint8_t index);
+
+    /**
+     * Queue a request with a random start delay, limited by its jitter.
+     *
+     * @param[in] request   Request
+     */
+    void queue(Request& request);
+
+    /**
+     * Find the failure statistic of a host.
+     *
+     * @param[in] hostname  Server hostname
+     *
+     * @return Index of the host. If not found, it will return MAX_HOSTS.
+     */
+    uint8_t findHost(const String& hostname) const;
+
+    /**
+     * Get the remaining backoff of a host.
+     *
+     * @param[in] hostname  Server hostname
+     *
+     * @return Remaining backoff in ms
+     */
+    uint32_t getBackoff(const String& hostname) const;
+
+    /**
+     * Is the circuit breaker of a host open?
+     *
+     * @param[in] hostname  Server hostname
+     *
+     * @return If new requests to the host shall be rejected, it will return true otherwise false.
+     */
+    bool isCircuitOpen(const String& hostname) const;
+
+    /**
+     * Update the failure statistic of a host by the result of a request.
+     *
+     * @param[in] hostname  Server hostname
+     * @param[in] isFailed  Request failed (true) or succeeded (false)
+     */
+    void updateHost(const String& hostname, bool isFailed);
+
+    /**
+     * Lock the scheduler.
+     */
+    void lock();
+
+    /**
+     * Unlock the scheduler.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __HTTP_REQUEST_SCHEDULER_H__ */
+
+/** @} */
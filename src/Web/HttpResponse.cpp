@@ -34,6 +34,11 @@
  *****************************************************************************/
 #include "HttpResponse.h"
 
+#include <Logging.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
 /******************************************************************************
  * Compiler Switches
  *****************************************************************************/
@@ -50,6 +55,11 @@
  * Prototypes
  *****************************************************************************/
 
+static bool isEqualIgnoreCase(const char* str1, const char* str2);
+static bool isEqualIgnoreCase(const char* str1, size_t len1, const char* str2);
+static bool isWhitespace(char value);
+static bool hasToken(const char* list, size_t len, const char* token);
+
 /******************************************************************************
  * Local Variables
  *****************************************************************************/
@@ -62,47 +72,68 @@ HttpResponse& HttpResponse::operator=(const HttpResponse& rsp)
 {
     if (this != &rsp)
     {
-        DLinkedListConstIterator<HttpHeader*>   it(rsp.m_headers);
+        clearHeaders();
 
-        m_httpVersion   = rsp.m_httpVersion;
         m_statusCode    = rsp.m_statusCode;
-        m_reasonPhrase  = rsp.m_reasonPhrase;
 
-        if (nullptr != m_payload)
+        /* Only the used part of the header buffer is copied. */
+        if ((nullptr != rsp.m_headerBuffer) &&
+            (0U < rsp.m_headerBufferWrIndex))
         {
-            delete[] m_payload;
-        }
+            if (m_headerBufferSize < rsp.m_headerBufferWrIndex)
+            {
+                if (nullptr != m_headerBuffer)
+                {
+                    delete[] m_headerBuffer;
+                    m_headerBufferSize = 0U;
+                }
 
-        if (nullptr != rsp.m_payload)
-        {
-            m_payload = new uint8_t[rsp.m_size];
+                m_headerBuffer = new char[rsp.m_headerBufferWrIndex];
 
-            if (nullptr == m_payload)
-            {
-                m_size = 0U;
-                m_wrIndex = 0U;
+                if (nullptr != m_headerBuffer)
+                {
+                    m_headerBufferSize = rsp.m_headerBufferWrIndex;
+                }
             }
-            else
+
+            if (nullptr != m_headerBuffer)
             {
-                memcpy(m_payload, rsp.m_payload, rsp.m_size);
-                m_size = rsp.m_size;
-                m_wrIndex = rsp.m_wrIndex;
+                uint8_t index = 0U;
+
+                memcpy(m_headerBuffer, rsp.m_headerBuffer, rsp.m_headerBufferWrIndex);
+                m_headerBufferWrIndex   = rsp.m_headerBufferWrIndex;
+                m_httpVersionOffset     = rsp.m_httpVersionOffset;
+                m_reasonPhraseOffset    = rsp.m_reasonPhraseOffset;
+                m_headerCnt             = rsp.m_headerCnt;
+                m_eTagIndex             = rsp.m_eTagIndex;
+
+                for(index = 0U; index < m_headerCnt; ++index)
+                {
+                    m_headerIndex[index] = rsp.m_headerIndex[index];
+                }
             }
         }
 
-        if (true == it.first())
+        m_contentLength         = rsp.m_contentLength;
+        m_isContentLengthKnown  = rsp.m_isContentLengthKnown;
+        m_transferCoding        = rsp.m_transferCoding;
+        m_connectionOption      = rsp.m_connectionOption;
+        m_contentCoding         = rsp.m_contentCoding;
+
+        clearPayload();
+
+        /* Only the received payload is copied, not the reserved capacity. */
+        if ((nullptr != rsp.m_payload) &&
+            (0U < rsp.m_wrIndex))
         {
-            do
-            {
-                HttpHeader* header = new HttpHeader;
+            m_payload = new uint8_t[rsp.m_wrIndex];
 
-                if (nullptr != header)
-                {
-                    *header = **it.current();
-                    (void)m_headers.append(header);
-                }
+            if (nullptr != m_payload)
+            {
+                memcpy(m_payload, rsp.m_payload, rsp.m_wrIndex);
+                m_size = rsp.m_wrIndex;
+                m_wrIndex = rsp.m_wrIndex;
             }
-            while(true == it.next());
         }
     }
 
@@ -113,84 +144,164 @@ void HttpResponse::clear()
 {
     clearHeaders();
     clearPayload();
-    m_wrIndex = 0U;
+}
+
+void HttpResponse::releaseBuffers()
+{
+    clear();
+
+    if (nullptr != m_headerBuffer)
+    {
+        delete[] m_headerBuffer;
+        m_headerBuffer = nullptr;
+    }
+
+    m_headerBufferSize = 0U;
 }
 
 void HttpResponse::addStatusLine(const String& line)
 {
-    const char* SP          = " ";
-    int         idx         = 0;
-    int         begin       = 0;
-    String      statusCode;
+    const char* str     = line.c_str();
+    size_t      idx     = 0U;
+    size_t      begin   = 0U;
 
     /* Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF */
 
     /* HTTP-Version */
-    idx             = line.indexOf(SP);
-    m_httpVersion   = line.substring(begin, idx);
+    while(('\0' != str[idx]) && (' ' != str[idx]))
+    {
+        ++idx;
+    }
+
+    (void)appendToHeaderBuffer(&str[begin], idx - begin, m_httpVersionOffset);
 
     /* Overstep all spaces */
-    while(('\0' != line[idx]) && (' ' == line[idx]))
+    while(' ' == str[idx])
     {
         ++idx;
     }
-    begin = idx;
 
     /* Status-Code */
-    idx             = line.indexOf(SP, begin);
-    statusCode      = line.substring(begin, idx);
-    m_statusCode    = statusCode.toInt();
+    m_statusCode = static_cast<uint16_t>(strtoul(&str[idx], nullptr, 10));
+
+    while(('\0' != str[idx]) && (' ' != str[idx]))
+    {
+        ++idx;
+    }
 
     /* Overstep all spaces */
-    while(('\0' != line[idx]) && (' ' == line[idx]))
+    while(' ' == str[idx])
     {
         ++idx;
     }
     begin = idx;
 
     /* Reason-Phrase */
-    m_reasonPhrase  = line.substring(begin);
+    (void)appendToHeaderBuffer(&str[begin], line.length() - begin, m_reasonPhraseOffset);
 }
 
 void HttpResponse::addHeader(const String& line)
 {
-    HttpHeader* header = new HttpHeader(line);
-
-    if (nullptr != header)
+    const char* str         = line.c_str();
+    size_t      len         = line.length();
+    size_t      nameEnd     = 0U;
+    size_t      valueBegin  = 0U;
+    size_t      valueEnd    = len;
+
+    /* header-field = field-name ":" OWS field-value OWS */
+    while((nameEnd < len) && (':' != str[nameEnd]))
     {
-        m_headers.append(header);
+        ++nameEnd;
     }
-}
 
-void HttpResponse::extendPayload(size_t size)
-{
-    uint8_t* tmp = m_payload;
+    if ((0U < nameEnd) &&
+        (nameEnd < len))
+    {
+        valueBegin = nameEnd + 1U;
 
-    m_payload = new uint8_t[m_size + size];
+        while((valueBegin < len) && (true == isWhitespace(str[valueBegin])))
+        {
+            ++valueBegin;
+        }
 
-    if (nullptr != m_payload)
-    {
-        m_size += size;
-    }
+        /* There may be CRLF at the end, which must be removed. */
+        while((valueEnd > valueBegin) && (true == isWhitespace(str[valueEnd - 1U])))
+        {
+            --valueEnd;
+        }
 
-    if ((nullptr != m_payload) &&
-        (nullptr != tmp))
-    {
-        memcpy(m_payload, tmp, m_wrIndex);
+        /* The header fields, which are necessary to receive the body, are
+         * evaluated even if the field can't be stored anymore.
+         */
+        parseWellKnownHeader(str, nameEnd, &str[valueBegin], valueEnd - valueBegin);
+
+        if (MAX_HEADERS <= m_headerCnt)
+        {
+            LOG_WARNING("Too many HTTP header fields, %.*s dropped.", static_cast<int>(nameEnd), str);
+        }
+        else
+        {
+            HeaderIndex&    header          = m_headerIndex[m_headerCnt];
+            size_t          headerBufWrIdx  = m_headerBufferWrIndex;
+
+            if ((true == appendToHeaderBuffer(str, nameEnd, header.nameOffset)) &&
+                (true == appendToHeaderBuffer(&str[valueBegin], valueEnd - valueBegin, header.valueOffset)))
+            {
+                if (true == isEqualIgnoreCase(str, nameEnd, "ETag"))
+                {
+                    m_eTagIndex = m_headerCnt;
+                }
+
+                ++m_headerCnt;
+            }
+            else
+            {
+                LOG_WARNING("HTTP header buffer full, %.*s dropped.", static_cast<int>(nameEnd), str);
+
+                /* Drop a partly stored header field. */
+                m_headerBufferWrIndex = headerBufWrIdx;
+            }
+        }
     }
+}
 
-    if (nullptr != tmp)
+bool HttpResponse::reservePayload(size_t size)
+{
+    bool isSuccessful = true;
+
+    if ((m_size - m_wrIndex) < size)
     {
-        delete[] tmp;
+        isSuccessful = resizePayload(m_wrIndex + size);
     }
+
+    return isSuccessful;
 }
 
 void HttpResponse::addPayload(const uint8_t* payload, size_t size)
 {
-    if ((nullptr == m_payload) ||
-        ((m_size - m_wrIndex) < size))
+    if ((m_size - m_wrIndex) < size)
     {
-        extendPayload(size);
+        size_t  required    = m_wrIndex + size;
+        size_t  capacity    = 2U * m_size;
+
+        if (PAYLOAD_MIN_CAPACITY > capacity)
+        {
+            capacity = PAYLOAD_MIN_CAPACITY;
+        }
+
+        if (required > capacity)
+        {
+            capacity = required;
+        }
+
+        /* If the geometric growth fails, try it with the required size
+         * at least, because the heap may be fragmented.
+         */
+        if ((false == resizePayload(capacity)) &&
+            (required < capacity))
+        {
+            (void)resizePayload(required);
+        }
     }
 
     if ((nullptr != m_payload) &&
@@ -201,9 +312,11 @@ void HttpResponse::addPayload(const uint8_t* payload, size_t size)
     }
 }
 
-String HttpResponse::getHttpVersion() const
+const char* HttpResponse::getHttpVersion() const
 {
-    return m_httpVersion;
+    const char* httpVersion = getFromHeaderBuffer(m_httpVersionOffset);
+
+    return (nullptr == httpVersion) ? "" : httpVersion;
 }
 
 uint16_t HttpResponse::getStatusCode() const
@@ -211,42 +324,62 @@ uint16_t HttpResponse::getStatusCode() const
     return m_statusCode;
 }
 
-String HttpResponse::getReasonPhrase() const
+const char* HttpResponse::getReasonPhrase() const
 {
-    return m_reasonPhrase;
+    const char* reasonPhrase = getFromHeaderBuffer(m_reasonPhraseOffset);
+
+    return (nullptr == reasonPhrase) ? "" : reasonPhrase;
 }
 
-String HttpResponse::getHeader(const String& name)
+String HttpResponse::getHeader(const String& name) const
 {
-    String                              value;
-    DLinkedListIterator<HttpHeader*>    it(m_headers);
+    String      value;
+    const char* fieldValue  = findHeader(name.c_str());
 
-    if (true == it.first())
+    if (nullptr != fieldValue)
     {
-        HttpHeader* hdr     = nullptr;
-        bool        isFound = false;
+        value = fieldValue;
+    }
 
-        do
-        {
-            hdr = *it.current();
+    return value;
+}
 
-            if ((nullptr != hdr) &&
-                (0U != hdr->getName().equalsIgnoreCase(name)))
+const char* HttpResponse::findHeader(const char* name) const
+{
+    const char* value   = nullptr;
+    uint8_t     index   = 0U;
+
+    if (nullptr != name)
+    {
+        while((nullptr == value) && (index < m_headerCnt))
+        {
+            if (true == isEqualIgnoreCase(getFromHeaderBuffer(m_headerIndex[index].nameOffset), name))
             {
-                value = hdr->getValue();
-                isFound = true;
+                value = getFromHeaderBuffer(m_headerIndex[index].valueOffset);
             }
+
+            ++index;
         }
-        while((false == isFound) &&
-                (true == it.next()));
     }
 
     return value;
 }
 
+const char* HttpResponse::getETag() const
+{
+    const char* eTag = nullptr;
+
+    if (MAX_HEADERS > m_eTagIndex)
+    {
+        eTag = getFromHeaderBuffer(m_headerIndex[m_eTagIndex].valueOffset);
+    }
+
+    return eTag;
+}
+
 const uint8_t* HttpResponse::getPayload(size_t& size) const
 {
-    size = m_size;
+    size = m_wrIndex;
     return m_payload;
 }
 
@@ -260,14 +393,156 @@ const uint8_t* HttpResponse::getPayload(size_t& size) const
 
 void HttpResponse::clearHeaders()
 {
-    DLinkedListIterator<HttpHeader*> it(m_headers);
+    m_statusCode            = 0U;
+    m_headerBufferWrIndex   = 0U;
+    m_httpVersionOffset     = NO_OFFSET;
+    m_reasonPhraseOffset    = NO_OFFSET;
+    m_headerCnt             = 0U;
+    m_contentLength         = 0U;
+    m_isContentLengthKnown  = false;
+    m_transferCoding        = TRANSFER_CODING_IDENTITY;
+    m_connectionOption      = CONNECTION_OPTION_NONE;
+    m_contentCoding         = CONTENT_CODING_IDENTITY;
+    m_eTagIndex             = MAX_HEADERS;
+}
+
+bool HttpResponse::appendToHeaderBuffer(const char* str, size_t len, uint16_t& offset)
+{
+    bool    isSuccessful    = true;
+    size_t  required        = m_headerBufferWrIndex + len + 1U;
 
-    while(true == it.first())
+    if (m_headerBufferSize < required)
     {
-        HttpHeader* header = *it.current();
+        size_t  capacity    = 2U * m_headerBufferSize;
+        char*   buffer      = nullptr;
 
-        it.remove();
-        delete header;
+        if (HEADER_BUFFER_MIN_CAPACITY > capacity)
+        {
+            capacity = HEADER_BUFFER_MIN_CAPACITY;
+        }
+
+        if (required > capacity)
+        {
+            capacity = required;
+        }
+
+        if (HEADER_BUFFER_MAX_CAPACITY < capacity)
+        {
+            capacity = HEADER_BUFFER_MAX_CAPACITY;
+        }
+
+        if (required <= capacity)
+        {
+            buffer = new char[capacity];
+        }
+
+        if (nullptr == buffer)
+        {
+            isSuccessful = false;
+        }
+        else
+        {
+            if (nullptr != m_headerBuffer)
+            {
+                memcpy(buffer, m_headerBuffer, m_headerBufferWrIndex);
+                delete[] m_headerBuffer;
+            }
+
+            m_headerBuffer      = buffer;
+            m_headerBufferSize  = capacity;
+        }
+    }
+
+    if (true == isSuccessful)
+    {
+        memcpy(&m_headerBuffer[m_headerBufferWrIndex], str, len);
+        m_headerBuffer[m_headerBufferWrIndex + len] = '\0';
+
+        offset                  = static_cast<uint16_t>(m_headerBufferWrIndex);
+        m_headerBufferWrIndex  += len + 1U;
+    }
+
+    return isSuccessful;
+}
+
+const char* HttpResponse::getFromHeaderBuffer(uint16_t offset) const
+{
+    const char* str = nullptr;
+
+    if ((NO_OFFSET != offset) &&
+        (m_headerBufferWrIndex > offset))
+    {
+        str = &m_headerBuffer[offset];
+    }
+
+    return str;
+}
+
+void HttpResponse::parseWellKnownHeader(const char* name, size_t nameLen, const char* value, size_t valueLen)
+{
+    if (true == isEqualIgnoreCase(name, nameLen, "Content-Length"))
+    {
+        /* The received line is terminated, strtoul() stops at the first non-digit. */
+        m_contentLength         = strtoul(value, nullptr, 10);
+        m_isContentLengthKnown  = true;
+    }
+    /* Only IDENTITY (default) and CHUNKED transfer coding are supported. */
+    else if (true == isEqualIgnoreCase(name, nameLen, "Transfer-Encoding"))
+    {
+        if (true == isEqualIgnoreCase(value, valueLen, "chunked"))
+        {
+            m_transferCoding = TRANSFER_CODING_CHUNKED;
+        }
+        else
+        {
+            m_transferCoding = TRANSFER_CODING_UNSUPPORTED;
+        }
+    }
+    /* Connection = "Connection" ":" 1#(connection-token)
+     * Connection options are case-insensitive, see RFC7230 - 6.1.
+     */
+    else if (true == isEqualIgnoreCase(name, nameLen, "Connection"))
+    {
+        if (true == hasToken(value, valueLen, "close"))
+        {
+            m_connectionOption = CONNECTION_OPTION_CLOSE;
+        }
+        else if (true == hasToken(value, valueLen, "keep-alive"))
+        {
+            m_connectionOption = CONNECTION_OPTION_KEEP_ALIVE;
+        }
+        else
+        {
+            ;
+        }
+    }
+    /* RFC7230 - 4.2.3. Gzip Coding
+     * "x-gzip" shall be handled as "gzip".
+     */
+    else if (true == isEqualIgnoreCase(name, nameLen, "Content-Encoding"))
+    {
+        if ((0U == valueLen) ||
+            (true == isEqualIgnoreCase(value, valueLen, "identity")))
+        {
+            m_contentCoding = CONTENT_CODING_IDENTITY;
+        }
+        else if ((true == isEqualIgnoreCase(value, valueLen, "gzip")) ||
+                 (true == isEqualIgnoreCase(value, valueLen, "x-gzip")))
+        {
+            m_contentCoding = CONTENT_CODING_GZIP;
+        }
+        else if (true == isEqualIgnoreCase(value, valueLen, "deflate"))
+        {
+            m_contentCoding = CONTENT_CODING_DEFLATE;
+        }
+        else
+        {
+            m_contentCoding = CONTENT_CODING_UNSUPPORTED;
+        }
+    }
+    else
+    {
+        ;
     }
 }
 
@@ -280,6 +555,29 @@ void HttpResponse::clearPayload()
     }
 
     m_size = 0U;
+    m_wrIndex = 0U;
+}
+
+bool HttpResponse::resizePayload(size_t capacity)
+{
+    bool        isSuccessful    = false;
+    uint8_t*    payload         = new uint8_t[capacity];
+
+    if (nullptr != payload)
+    {
+        if (nullptr != m_payload)
+        {
+            memcpy(payload, m_payload, m_wrIndex);
+            delete[] m_payload;
+        }
+
+        m_payload = payload;
+        m_size = capacity;
+
+        isSuccessful = true;
+    }
+
+    return isSuccessful;
 }
 
 /******************************************************************************
@@ -289,3 +587,118 @@ void HttpResponse::clearPayload()
 /******************************************************************************
  * Local Functions
  *****************************************************************************/
+
+/**
+ * Compare two strings case insensitive.
+ *
+ * @param[in] str1  String 1
+ * @param[in] str2  String 2
+ *
+ * @return If both are equal, it will return true otherwise false.
+ */
+static bool isEqualIgnoreCase(const char* str1, const char* str2)
+{
+    bool isEqual = false;
+
+    if ((nullptr != str1) &&
+        (nullptr != str2))
+    {
+        while(('\0' != *str1) &&
+              (tolower(static_cast<unsigned char>(*str1)) == tolower(static_cast<unsigned char>(*str2))))
+        {
+            ++str1;
+            ++str2;
+        }
+
+        isEqual = (*str1 == *str2);
+    }
+
+    return isEqual;
+}
+
+/**
+ * Compare a not terminated string with a terminated string case insensitive.
+ *
+ * @param[in] str1  String 1, which is not terminated
+ * @param[in] len1  Length of string 1 in byte
+ * @param[in] str2  String 2, which is terminated
+ *
+ * @return If both are equal, it will return true otherwise false.
+ */
+static bool isEqualIgnoreCase(const char* str1, size_t len1, const char* str2)
+{
+    bool isEqual = false;
+
+    if ((nullptr != str1) &&
+        (nullptr != str2))
+    {
+        size_t idx = 0U;
+
+        while((idx < len1) &&
+              ('\0' != str2[idx]) &&
+              (tolower(static_cast<unsigned char>(str1[idx])) == tolower(static_cast<unsigned char>(str2[idx]))))
+        {
+            ++idx;
+        }
+
+        isEqual = ((idx == len1) && ('\0' == str2[idx]));
+    }
+
+    return isEqual;
+}
+
+/**
+ * Is the character a optional whitespace or a line terminator?
+ *
+ * @param[in] value Character
+ *
+ * @return If its a whitespace, it will return true otherwise false.
+ */
+static bool isWhitespace(char value)
+{
+    return ((' ' == value) || ('\t' == value) || ('\r' == value) || ('\n' == value));
+}
+
+/**
+ * Is the token part of a comma separated token list? The token is compared
+ * case insensitive.
+ *
+ * @param[in] list  Token list, which is not terminated
+ * @param[in] len   Length of the token list in byte
+ * @param[in] token Token
+ *
+ * @return If the token is found, it will return true otherwise false.
+ */
+static bool hasToken(const char* list, size_t len, const char* token)
+{
+    bool    isFound = false;
+    size_t  begin   = 0U;
+
+    while((false == isFound) && (begin < len))
+    {
+        size_t end      = begin;
+        size_t next     = 0U;
+
+        while((end < len) && (',' != list[end]))
+        {
+            ++end;
+        }
+
+        next = end + 1U;
+
+        while((begin < end) && (true == isWhitespace(list[begin])))
+        {
+            ++begin;
+        }
+
+        while((end > begin) && (true == isWhitespace(list[end - 1U])))
+        {
+            --end;
+        }
+
+        isFound = isEqualIgnoreCase(&list[begin], end - begin, token);
+        begin   = next;
+    }
+
+    return isFound;
+}
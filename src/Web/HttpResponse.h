@@ -44,9 +44,6 @@
  * Includes
  *****************************************************************************/
 #include <WString.h>
-#include <LinkedList.hpp>
-
-#include "HttpHeader.h"
 
 /******************************************************************************
  * Macros
@@ -58,19 +55,62 @@
 
 /**
  * Http response
+ *
+ * The status line and all header fields are stored in a single contiguous
+ * header buffer, which is referenced by a small offset index. This avoids
+ * a allocation per header field. The header buffer is kept by clear() and
+ * reused by the next response.
+ *
+ * The header fields, which are necessary to receive the body, are parsed
+ * once while the header is added.
  */
 class HttpResponse
 {
 public:
 
+    /** Transfer codings, according to the "Transfer-Encoding" header field. */
+    enum TransferCoding
+    {
+        TRANSFER_CODING_IDENTITY = 0,   /**< No transfer coding */
+        TRANSFER_CODING_CHUNKED,        /**< Chunked transfer coding */
+        TRANSFER_CODING_UNSUPPORTED     /**< Unsupported transfer coding */
+    };
+
+    /** Connection options, according to the "Connection" header field. */
+    enum ConnectionOption
+    {
+        CONNECTION_OPTION_NONE = 0,     /**< No connection option */
+        CONNECTION_OPTION_CLOSE,        /**< Server closes the connection after the response. */
+        CONNECTION_OPTION_KEEP_ALIVE    /**< Server keeps the connection alive. */
+    };
+
+    /** Content codings, according to the "Content-Encoding" header field. */
+    enum ContentCoding
+    {
+        CONTENT_CODING_IDENTITY = 0,    /**< No content coding */
+        CONTENT_CODING_GZIP,            /**< Gzip content coding */
+        CONTENT_CODING_DEFLATE,         /**< Deflate content coding */
+        CONTENT_CODING_UNSUPPORTED      /**< Unsupported content coding */
+    };
+
     /**
      * Construct a empty response.
      */
     HttpResponse() :
-        m_httpVersion(),
         m_statusCode(0U),
-        m_reasonPhrase(),
-        m_headers(),
+        m_headerBuffer(nullptr),
+        m_headerBufferSize(0U),
+        m_headerBufferWrIndex(0U),
+        m_httpVersionOffset(NO_OFFSET),
+        m_reasonPhraseOffset(NO_OFFSET),
+        m_headerIndex(),
+        m_headerCnt(0U),
+        m_contentLength(0U),
+        m_isContentLengthKnown(false),
+        m_transferCoding(TRANSFER_CODING_IDENTITY),
+        m_connectionOption(CONNECTION_OPTION_NONE),
+        m_contentCoding(CONTENT_CODING_IDENTITY),
+        m_eTagIndex(MAX_HEADERS),
         m_payload(nullptr),
         m_size(0U),
         m_wrIndex(0U)
@@ -83,6 +123,12 @@ public:
     ~HttpResponse()
     {
         clear();
+
+        if (nullptr != m_headerBuffer)
+        {
+            delete[] m_headerBuffer;
+            m_headerBuffer = nullptr;
+        }
     }
 
     /**
@@ -91,10 +137,20 @@ public:
      * @param[in] rsp   Response
      */
     HttpResponse(const HttpResponse& rsp) :
-        m_httpVersion(),
         m_statusCode(0U),
-        m_reasonPhrase(),
-        m_headers(),
+        m_headerBuffer(nullptr),
+        m_headerBufferSize(0U),
+        m_headerBufferWrIndex(0U),
+        m_httpVersionOffset(NO_OFFSET),
+        m_reasonPhraseOffset(NO_OFFSET),
+        m_headerIndex(),
+        m_headerCnt(0U),
+        m_contentLength(0U),
+        m_isContentLengthKnown(false),
+        m_transferCoding(TRANSFER_CODING_IDENTITY),
+        m_connectionOption(CONNECTION_OPTION_NONE),
+        m_contentCoding(CONTENT_CODING_IDENTITY),
+        m_eTagIndex(MAX_HEADERS),
         m_payload(nullptr),
         m_size(0U),
         m_wrIndex(0U)
@@ -116,6 +172,12 @@ public:
      */
     void clear();
 
+    /**
+     * Clear response and release its header buffer too.
+     * The header buffer is kept by clear() to be reused by the next response.
+     */
+    void releaseBuffers();
+
     /**
      * Add status line during parsing the response.
      *
@@ -131,14 +193,21 @@ public:
     void addHeader(const String& line);
 
     /**
-     * Extend payload size in bytes.
+     * Reserve payload buffer for the given number of additional bytes.
+     * If the payload size is known in advance, e.g. by the Content-Length,
+     * this results in a single allocation with the exact size.
      *
-     * @param[in] size  Size in bytes
+     * @param[in] size  Number of additional bytes
+     *
+     * @return If successful, it will return true otherwise false.
      */
-    void extendPayload(size_t size);
+    bool reservePayload(size_t size);
 
     /**
      * Add a complete payload or add it several times partly.
+     * If the payload buffer is too small, it will grow geometrically.
+     * This keeps the number of allocations and copies low, in case the
+     * payload size is not known in advance.
      *
      * @param[in] payload   Complete or partly payload
      * @param[in] size      Payload size in byte
@@ -147,10 +216,11 @@ public:
 
     /**
      * Get HTTP version.
+     * The returned string is valid until the response is changed.
      *
      * @return HTTP version
      */
-    String getHttpVersion() const;
+    const char* getHttpVersion() const;
 
     /**
      * Get status code.
@@ -161,17 +231,98 @@ public:
 
     /**
      * Get reason phrase.
+     * The returned string is valid until the response is changed.
      *
      * @return Reason phrase
      */
-    String getReasonPhrase() const;
+    const char* getReasonPhrase() const;
 
     /**
      * Get header field value.
      *
      * @param[in] name  Field name
+     *
+     * @return Field value. If the header field is not available, it will be empty.
+     */
+    String getHeader(const String& name) const;
+
+    /**
+     * Get header field value, without copying it.
+     * The returned string is valid until the response is changed.
+     *
+     * @param[in] name  Field name
+     *
+     * @return Field value. If the header field is not available, it will return nullptr.
      */
-    String getHeader(const String& name);
+    const char* findHeader(const char* name) const;
+
+    /**
+     * Get number of header fields.
+     *
+     * @return Number of header fields
+     */
+    uint8_t getHeaderCount() const
+    {
+        return m_headerCnt;
+    }
+
+    /**
+     * Is the content length known by the "Content-Length" header field?
+     *
+     * @return If the content length is known, it will return true otherwise false.
+     */
+    bool isContentLengthKnown() const
+    {
+        return m_isContentLengthKnown;
+    }
+
+    /**
+     * Get content length, provided by the "Content-Length" header field.
+     *
+     * @return Content length in byte. If unknown, it will return 0.
+     */
+    size_t getContentLength() const
+    {
+        return m_contentLength;
+    }
+
+    /**
+     * Get transfer coding, provided by the "Transfer-Encoding" header field.
+     *
+     * @return Transfer coding
+     */
+    TransferCoding getTransferCoding() const
+    {
+        return m_transferCoding;
+    }
+
+    /**
+     * Get connection option, provided by the "Connection" header field.
+     *
+     * @return Connection option
+     */
+    ConnectionOption getConnectionOption() const
+    {
+        return m_connectionOption;
+    }
+
+    /**
+     * Get content coding, provided by the "Content-Encoding" header field.
+     *
+     * @return Content coding
+     */
+    ContentCoding getContentCoding() const
+    {
+        return m_contentCoding;
+    }
+
+    /**
+     * Get entity tag, provided by the "ETag" header field.
+     * The returned string is valid until the response is changed.
+     *
+     * @return Entity tag. If not available, it will return nullptr.
+     */
+    const char* getETag() const;
 
     /**
      * Get payload.
@@ -182,25 +333,111 @@ public:
      */
     const uint8_t* getPayload(size_t& size) const;
 
+    /**
+     * Get payload buffer capacity. It may be greater than the payload size.
+     *
+     * @return Payload buffer capacity in byte
+     */
+    size_t getPayloadCapacity() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Clears the payload. Status line and headers are kept.
+     */
+    void clearPayload();
+
+    /** Max. number of header fields. Further header fields are dropped. */
+    static const uint8_t        MAX_HEADERS                 = 32U;
+
+    /** Max. header buffer capacity in byte. Further header fields are dropped. */
+    static const size_t         HEADER_BUFFER_MAX_CAPACITY  = 4096U;
+
 private:
 
-    String                      m_httpVersion;  /**< HTTP version */
-    uint16_t                    m_statusCode;   /**< Status code */
-    String                      m_reasonPhrase; /**< Reason phrase */
-    DLinkedList<HttpHeader*>    m_headers;      /**< List of headers */
-    uint8_t*                    m_payload;      /**< Payload */
-    size_t                      m_size;         /**< Payload size in byte */
-    size_t                      m_wrIndex;      /**< Payload write index */
+    /** Min. payload buffer capacity in byte, used for the first allocation. */
+    static const size_t         PAYLOAD_MIN_CAPACITY        = 512U;
+
+    /** Min. header buffer capacity in byte, used for the first allocation. */
+    static const size_t         HEADER_BUFFER_MIN_CAPACITY  = 256U;
+
+    /** Offset, which marks a not available string in the header buffer. */
+    static const uint16_t       NO_OFFSET                   = UINT16_MAX;
+
+    /**
+     * Header field, which references its name and value in the header
+     * buffer. Both are zero terminated.
+     */
+    struct HeaderIndex
+    {
+        uint16_t    nameOffset;     /**< Offset of the field name */
+        uint16_t    valueOffset;    /**< Offset of the field value */
+    };
+
+    uint16_t            m_statusCode;                   /**< Status code */
+    char*               m_headerBuffer;                 /**< Header buffer with status line and header fields */
+    size_t              m_headerBufferSize;             /**< Header buffer capacity in byte */
+    size_t              m_headerBufferWrIndex;          /**< Header buffer write index */
+    uint16_t            m_httpVersionOffset;            /**< Offset of the HTTP version */
+    uint16_t            m_reasonPhraseOffset;           /**< Offset of the reason phrase */
+    HeaderIndex         m_headerIndex[MAX_HEADERS];     /**< Header field index */
+    uint8_t             m_headerCnt;                    /**< Number of header fields */
+    size_t              m_contentLength;                /**< Content length in byte */
+    bool                m_isContentLengthKnown;         /**< Is the content length known? */
+    TransferCoding      m_transferCoding;               /**< Transfer coding */
+    ConnectionOption    m_connectionOption;             /**< Connection option */
+    ContentCoding       m_contentCoding;                /**< Content coding */
+    uint8_t             m_eTagIndex;                    /**< Header field index of the entity tag */
+    uint8_t*            m_payload;                      /**< Payload */
+    size_t              m_size;                         /**< Payload buffer capacity in byte */
+    size_t              m_wrIndex;                      /**< Payload write index */
 
     /**
-     * Clear headers.
+     * Clear headers. The header buffer is kept for the next response.
      */
     void clearHeaders();
 
     /**
-     * Clears the payload.
+     * Append a string to the header buffer and terminate it.
+     *
+     * @param[in]  str      String, not terminated
+     * @param[in]  len      String length
+     * @param[out] offset   Offset of the string in the header buffer
+     *
+     * @return If successful, it will return true otherwise false.
      */
-    void clearPayload();
+    bool appendToHeaderBuffer(const char* str, size_t len, uint16_t& offset);
+
+    /**
+     * Get string from the header buffer.
+     *
+     * @param[in] offset    Offset of the string in the header buffer
+     *
+     * @return String. If not available, it will return nullptr.
+     */
+    const char* getFromHeaderBuffer(uint16_t offset) const;
+
+    /**
+     * Parse the header fields, which are necessary to receive the body.
+     * They are parsed from the received line, independent of whether the
+     * header field can be stored or not.
+     *
+     * @param[in] name      Header field name
+     * @param[in] nameLen   Header field name length in byte
+     * @param[in] value     Header field value
+     * @param[in] valueLen  Header field value length in byte
+     */
+    void parseWellKnownHeader(const char* name, size_t nameLen, const char* value, size_t valueLen);
+
+    /**
+     * Resize the payload buffer. The already received payload is kept.
+     *
+     * @param[in] capacity  New payload buffer capacity in byte
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool resizePayload(size_t capacity);
 };
 
 /******************************************************************************
@@ -0,0 +1,127 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP connection listener interface
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __IHTTPCONNECTIONLISTENER_HPP__
+#define __IHTTPCONNECTIONLISTENER_HPP__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <AsyncTCP.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The connection pool forwards all events of a acquired TCP connection to
+ * its current listener.
+ */
+class IHttpConnectionListener
+{
+public:
+
+    /**
+     * Destroys the interface.
+     */
+    virtual ~IHttpConnectionListener()
+    {
+    }
+
+    /**
+     * This method is called if a connection is successful established.
+     *
+     * @param[in] client    TCP client
+     */
+    virtual void onConnect(AsyncClient* client) = 0;
+
+    /**
+     * This method is called if a connection is disconnected.
+     *
+     * @param[in] client    TCP client
+     */
+    virtual void onDisconnect(AsyncClient* client) = 0;
+
+    /**
+     * This method is called if a error occurred.
+     *
+     * @param[in] client    TCP client
+     * @param[in] error     Error id
+     */
+    virtual void onError(AsyncClient* client, int8_t error) = 0;
+
+    /**
+     * This method is called if data is received.
+     *
+     * @param[in] client    TCP client
+     * @param[in] data      Data stream
+     * @param[in] len       Data size in byte
+     */
+    virtual void onData(AsyncClient* client, const uint8_t* data, size_t len) = 0;
+
+    /**
+     * This method is called if ACK timeout happens.
+     *
+     * @param[in] client    TCP client
+     * @param[in] timeout   Timeout value in ms
+     */
+    virtual void onTimeout(AsyncClient* client, uint32_t timeout) = 0;
+
+protected:
+
+    /**
+     * Constructs the interface.
+     */
+    IHttpConnectionListener()
+    {
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __IHTTPCONNECTIONLISTENER_HPP__ */
+
+/** @} */
@@ -0,0 +1,106 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  HTTP request handler interface
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __IHTTPREQUESTHANDLER_HPP__
+#define __IHTTPREQUESTHANDLER_HPP__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "HttpResponse.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The request scheduler starts a submitted request via this interface,
+ * as soon as it is admitted.
+ */
+class IHttpRequestHandler
+{
+public:
+
+    /**
+     * Destroys the interface.
+     */
+    virtual ~IHttpRequestHandler()
+    {
+    }
+
+    /**
+     * This method is called if the request is admitted and shall be started.
+     * It is called with the scheduler lock held, therefore no application
+     * callback must be called directly.
+     *
+     * @return If the request is started, it will return true otherwise false.
+     */
+    virtual bool onRequestStart() = 0;
+
+    /**
+     * This method is called instead of starting the request, if a identical
+     * request of a other handler was sent and its response is available.
+     * It is called with the scheduler lock held, therefore no application
+     * callback must be called directly.
+     *
+     * @param[in] rsp   Complete response
+     */
+    virtual void onRequestCoalesced(const HttpResponse& rsp) = 0;
+
+protected:
+
+    /**
+     * Constructs the interface.
+     */
+    IHttpRequestHandler()
+    {
+    }
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __IHTTPREQUESTHANDLER_HPP__ */
+
+/** @} */
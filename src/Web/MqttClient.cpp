@@ -0,0 +1,601 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT client
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MqttClient.h"
+#include "Settings.h"
+
+#include <Logging.h>
+#include <Util.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void MqttClient::begin()
+{
+    Settings& settings = Settings::getInstance();
+
+    lock();
+
+    if (false == settings.open(true))
+    {
+        LOG_WARNING("Use default MQTT settings.");
+
+        m_hostname  = settings.getMqttBroker().getDefault();
+        m_port      = static_cast<uint16_t>(settings.getMqttPort().getDefault());
+        m_user      = settings.getMqttUser().getDefault();
+        m_password  = settings.getMqttPassword().getDefault();
+        m_clientId  = settings.getHostname().getDefault();
+    }
+    else
+    {
+        m_hostname  = settings.getMqttBroker().getValue();
+        m_port      = static_cast<uint16_t>(settings.getMqttPort().getValue());
+        m_user      = settings.getMqttUser().getValue();
+        m_password  = settings.getMqttPassword().getValue();
+        m_clientId  = settings.getHostname().getValue();
+
+        settings.close();
+    }
+
+    if (0U == m_hostname.length())
+    {
+        LOG_INFO("No MQTT broker configured.");
+        m_state = STATE_DISABLED;
+    }
+    else
+    {
+        if (nullptr == m_tcpClient)
+        {
+            m_tcpClient = new AsyncClient();
+
+            if (nullptr != m_tcpClient)
+            {
+                m_tcpClient->onConnect(onConnect, this);
+                m_tcpClient->onDisconnect(onDisconnect, this);
+                m_tcpClient->onError(onError, this);
+                m_tcpClient->onData(onData, this);
+                m_tcpClient->onTimeout(onTimeout, this);
+            }
+        }
+
+        if (nullptr == m_tcpClient)
+        {
+            LOG_ERROR("Failed to create MQTT connection.");
+            m_state = STATE_DISABLED;
+        }
+        else
+        {
+            /* Connect in the next process cycle. */
+            m_state     = STATE_DISCONNECTED;
+            m_backoff   = MIN_BACKOFF;
+            m_reconnectTimer.start(0U);
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+void MqttClient::end()
+{
+    lock();
+
+    if (STATE_DISABLED != m_state)
+    {
+        m_reconnectTimer.stop();
+
+        if (STATE_DISCONNECTED != m_state)
+        {
+            m_session.end(m_tcpClient->connected());
+        }
+
+        /* Set before closing, so the disconnect event doesn't schedule a reconnect. */
+        m_state = STATE_DISABLED;
+        m_tcpClient->close(true);
+    }
+
+    unlock();
+
+    return;
+}
+
+void MqttClient::process()
+{
+    lock();
+
+    if (STATE_DISCONNECTED == m_state)
+    {
+        if ((true == m_reconnectTimer.isTimerRunning()) &&
+            (true == m_reconnectTimer.isTimeout()))
+        {
+            m_reconnectTimer.stop();
+            connect();
+        }
+    }
+    else if (STATE_DISABLED != m_state)
+    {
+        if (false == m_session.process())
+        {
+            LOG_WARNING("MQTT connection lost.");
+            m_tcpClient->close(true);
+        }
+    }
+    else
+    {
+        ;
+    }
+
+    unlock();
+
+    return;
+}
+
+uint32_t MqttClient::subscribe(const String& filter, MqttSession::QoS qos, const MessageCallback& callback)
+{
+    uint32_t    id      = INVALID_ID;
+    uint8_t     index   = 0U;
+
+    if ((0U == filter.length()) ||
+        (nullptr == callback))
+    {
+        return INVALID_ID;
+    }
+
+    lock();
+
+    for(index = 0U; (index < MAX_SUBSCRIPTIONS) && (INVALID_ID == id); ++index)
+    {
+        Subscription& subscription = m_subscriptions[index];
+
+        if (INVALID_ID == subscription.id)
+        {
+            id = m_nextId;
+
+            ++m_nextId;
+            if (INVALID_ID == m_nextId)
+            {
+                m_nextId = INVALID_ID + 1U;
+            }
+
+            subscription.id             = id;
+            subscription.filter         = filter;
+            subscription.qos            = qos;
+            subscription.callback       = callback;
+            subscription.isSubscribed   = false;
+        }
+    }
+
+    if (INVALID_ID == id)
+    {
+        LOG_WARNING("No free MQTT subscription for %s.", filter.c_str());
+    }
+    /* If not connected, it will be subscribed after the connection is established. */
+    else if (STATE_CONNECTED == m_state)
+    {
+        subscribePending();
+    }
+    else
+    {
+        ;
+    }
+
+    unlock();
+
+    return id;
+}
+
+void MqttClient::unsubscribe(uint32_t id)
+{
+    uint8_t index = 0U;
+
+    if (INVALID_ID == id)
+    {
+        return;
+    }
+
+    lock();
+
+    for(index = 0U; index < MAX_SUBSCRIPTIONS; ++index)
+    {
+        Subscription& subscription = m_subscriptions[index];
+
+        if (id == subscription.id)
+        {
+            uint8_t otherIndex  = 0U;
+            bool    isShared    = false;
+
+            /* Another subscription of the same filter keeps it at the broker. */
+            for(otherIndex = 0U; otherIndex < MAX_SUBSCRIPTIONS; ++otherIndex)
+            {
+                if ((otherIndex != index) &&
+                    (INVALID_ID != m_subscriptions[otherIndex].id) &&
+                    (subscription.filter == m_subscriptions[otherIndex].filter))
+                {
+                    isShared = true;
+                }
+            }
+
+            if ((false == isShared) &&
+                (true == subscription.isSubscribed) &&
+                (STATE_CONNECTED == m_state))
+            {
+                (void)m_session.unsubscribe(subscription.filter.c_str());
+            }
+
+            subscription.id             = INVALID_ID;
+            subscription.filter         = "";
+            subscription.callback       = nullptr;
+            subscription.isSubscribed   = false;
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+bool MqttClient::publish(const String& topic, const String& payload, MqttSession::QoS qos, bool retain)
+{
+    bool status = false;
+
+    lock();
+
+    if (STATE_DISABLED != m_state)
+    {
+        status = m_session.publish(topic.c_str(), reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length(), qos, retain);
+    }
+
+    unlock();
+
+    return status;
+}
+
+MqttClient::State MqttClient::getState() const
+{
+    State state;
+
+    lock();
+    state = m_state;
+    unlock();
+
+    return state;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+MqttClient::MqttClient() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_tcpClient(nullptr),
+    m_session(),
+    m_state(STATE_DISABLED),
+    m_hostname(),
+    m_port(0U),
+    m_user(),
+    m_password(),
+    m_clientId(),
+    m_backoff(MIN_BACKOFF),
+    m_reconnectTimer(),
+    m_nextId(INVALID_ID + 1U),
+    m_subscriptions()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_SUBSCRIPTIONS; ++index)
+    {
+        m_subscriptions[index].id           = INVALID_ID;
+        m_subscriptions[index].qos          = MqttSession::QOS_0;
+        m_subscriptions[index].isSubscribed = false;
+    }
+
+    m_session.setFunctions(sessionSend, sessionConnAck, sessionMessage, this);
+}
+
+void MqttClient::connect()
+{
+    LOG_INFO("Connect to MQTT broker %s:%u.", m_hostname.c_str(), m_port);
+
+    m_state = STATE_CONNECTING;
+
+    if (false == m_tcpClient->connect(m_hostname.c_str(), m_port))
+    {
+        LOG_WARNING("Failed to connect to MQTT broker.");
+        scheduleReconnect();
+    }
+
+    return;
+}
+
+void MqttClient::scheduleReconnect()
+{
+    /* A failed connection attempt may be reported twice, by error and disconnect. */
+    if ((STATE_DISABLED != m_state) &&
+        (STATE_DISCONNECTED != m_state))
+    {
+        /* The random part avoids that several clients reconnect at the same time. */
+        uint32_t period = m_backoff + static_cast<uint32_t>(random(static_cast<long>(m_backoff / 4U) + 1L));
+
+        LOG_INFO("Reconnect to MQTT broker in %u ms.", period);
+
+        m_state = STATE_DISCONNECTED;
+        m_reconnectTimer.start(period);
+
+        m_backoff *= 2U;
+        if (MAX_BACKOFF < m_backoff)
+        {
+            m_backoff = MAX_BACKOFF;
+        }
+    }
+
+    return;
+}
+
+void MqttClient::subscribePending()
+{
+    uint8_t index   = 0U;
+    bool    status  = true;
+
+    for(index = 0U; (index < MAX_SUBSCRIPTIONS) && (true == status); ++index)
+    {
+        Subscription& subscription = m_subscriptions[index];
+
+        if ((INVALID_ID != subscription.id) &&
+            (false == subscription.isSubscribed))
+        {
+            status = m_session.subscribe(subscription.filter.c_str(), subscription.qos);
+
+            if (true == status)
+            {
+                subscription.isSubscribed = true;
+            }
+        }
+    }
+
+    return;
+}
+
+void MqttClient::onConnect(void* arg, AsyncClient* client)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    if (nullptr != mqttClient)
+    {
+        mqttClient->lock();
+
+        /* The session is persistent, so the broker keeps the subscriptions and messages. */
+        if (false == mqttClient->m_session.begin(mqttClient->m_clientId, mqttClient->m_user, mqttClient->m_password, KEEP_ALIVE, false))
+        {
+            client->close(true);
+        }
+
+        mqttClient->unlock();
+    }
+
+    return;
+}
+
+void MqttClient::onDisconnect(void* arg, AsyncClient* client)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    UTIL_NOT_USED(client);
+
+    if (nullptr != mqttClient)
+    {
+        mqttClient->lock();
+
+        LOG_INFO("Disconnected from MQTT broker.");
+
+        mqttClient->m_session.end(false);
+        mqttClient->scheduleReconnect();
+
+        mqttClient->unlock();
+    }
+
+    return;
+}
+
+void MqttClient::onError(void* arg, AsyncClient* client, int8_t error)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    UTIL_NOT_USED(client);
+
+    LOG_WARNING("MQTT connection error: %d", error);
+
+    if (nullptr != mqttClient)
+    {
+        mqttClient->lock();
+
+        /* A failed connection establishment is not followed by a disconnect event. */
+        if (MqttSession::STATE_IDLE == mqttClient->m_session.getState())
+        {
+            mqttClient->scheduleReconnect();
+        }
+
+        mqttClient->unlock();
+    }
+
+    return;
+}
+
+void MqttClient::onData(void* arg, AsyncClient* client, void* data, size_t len)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    if (nullptr != mqttClient)
+    {
+        mqttClient->lock();
+
+        if (false == mqttClient->m_session.receive(static_cast<const uint8_t*>(data), len))
+        {
+            client->close(true);
+        }
+
+        mqttClient->unlock();
+    }
+
+    return;
+}
+
+void MqttClient::onTimeout(void* arg, AsyncClient* client, uint32_t timeout)
+{
+    UTIL_NOT_USED(arg);
+
+    LOG_WARNING("MQTT connection timeout after %u ms.", timeout);
+    client->close(true);
+
+    return;
+}
+
+size_t MqttClient::sessionSend(void* arg, const uint8_t* data, size_t size)
+{
+    MqttClient* mqttClient  = static_cast<MqttClient*>(arg);
+    size_t      written     = 0U;
+
+    if ((nullptr != mqttClient) &&
+        (nullptr != mqttClient->m_tcpClient) &&
+        (size <= mqttClient->m_tcpClient->space()))
+    {
+        written = mqttClient->m_tcpClient->write(reinterpret_cast<const char*>(data), size, ASYNC_WRITE_FLAG_COPY);
+    }
+
+    return written;
+}
+
+void MqttClient::sessionConnAck(void* arg, bool isSessionPresent)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    if (nullptr != mqttClient)
+    {
+        LOG_INFO("Connected to MQTT broker, session present: %u.", isSessionPresent);
+
+        mqttClient->m_state     = STATE_CONNECTED;
+        mqttClient->m_backoff   = MIN_BACKOFF;
+
+        /* Without a stored session, the broker doesn't know the subscriptions anymore. */
+        if (false == isSessionPresent)
+        {
+            uint8_t index = 0U;
+
+            for(index = 0U; index < MAX_SUBSCRIPTIONS; ++index)
+            {
+                mqttClient->m_subscriptions[index].isSubscribed = false;
+            }
+        }
+
+        mqttClient->subscribePending();
+    }
+
+    return;
+}
+
+void MqttClient::sessionMessage(void* arg, const char* topic, const uint8_t* payload, size_t size)
+{
+    MqttClient* mqttClient = static_cast<MqttClient*>(arg);
+
+    if (nullptr != mqttClient)
+    {
+        uint8_t index = 0U;
+
+        for(index = 0U; index < MAX_SUBSCRIPTIONS; ++index)
+        {
+            Subscription& subscription = mqttClient->m_subscriptions[index];
+
+            if ((INVALID_ID != subscription.id) &&
+                (true == MqttSession::isTopicMatching(subscription.filter.c_str(), topic)))
+            {
+                subscription.callback(topic, payload, size);
+            }
+        }
+    }
+
+    return;
+}
+
+void MqttClient::lock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void MqttClient::unlock() const
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
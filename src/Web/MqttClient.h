@@ -0,0 +1,331 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT client
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __MQTT_CLIENT_H__
+#define __MQTT_CLIENT_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <functional>
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <SimpleTimer.hpp>
+
+#include "MqttSession.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The MQTT client keeps one connection to the broker, which is configured in
+ * the settings, and shares it with all plugins. A plugin subscribes a topic
+ * filter with a callback, which is called for every matching message.
+ *
+ * The session is persistent, therefore the broker keeps the subscriptions
+ * and the QoS 1 messages while the connection is lost. The connection is
+ * established again with a exponential backoff. Besides the keep alive
+ * ping, there is no traffic without messages.
+ */
+class MqttClient
+{
+public:
+
+    /**
+     * Message callback. The topic and the payload are only valid during the
+     * call and the payload is not terminated.
+     *
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     */
+    typedef std::function<void(const char* topic, const uint8_t* payload, size_t size)> MessageCallback;
+
+    /** Connection state */
+    enum State
+    {
+        STATE_DISABLED = 0,     /**< No broker configured or stopped */
+        STATE_DISCONNECTED,     /**< Wait for the next connection attempt. */
+        STATE_CONNECTING,       /**< Connection establishment in progress */
+        STATE_CONNECTED         /**< Connected to the broker */
+    };
+
+    /**
+     * Get MQTT client instance.
+     *
+     * @return MQTT client instance
+     */
+    static MqttClient& getInstance()
+    {
+        static MqttClient instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Start the client with the broker configuration from the settings.
+     * Call it after the network connection is established.
+     */
+    void begin();
+
+    /**
+     * Disconnect from the broker and stop the client.
+     */
+    void end();
+
+    /**
+     * Process the connection establishment and the keep alive handling.
+     * Call it periodically.
+     */
+    void process();
+
+    /**
+     * Subscribe a topic filter. The subscription is kept over reconnects,
+     * until it is unsubscribed. It can be called any time, even if the client
+     * is not connected.
+     *
+     * The callback is called in the context of the TCP task, with the
+     * client locked. Therefore don't subscribe or unsubscribe while holding
+     * a lock, which the callback takes too.
+     *
+     * @param[in] filter    Topic filter, may contain the wildcards '+' and '#'.
+     * @param[in] qos       Max. quality of service for the messages
+     * @param[in] callback  Message callback
+     *
+     * @return Subscription id. If no subscription is available, it will return INVALID_ID.
+     */
+    uint32_t subscribe(const String& filter, MqttSession::QoS qos, const MessageCallback& callback);
+
+    /**
+     * Unsubscribe.
+     *
+     * @param[in] id    Subscription id
+     */
+    void unsubscribe(uint32_t id);
+
+    /**
+     * Publish a message.
+     *
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] qos       Quality of service
+     * @param[in] retain    Shall the broker retain the message?
+     *
+     * @return If successful sent or queued, it will return true otherwise false.
+     */
+    bool publish(const String& topic, const String& payload, MqttSession::QoS qos, bool retain);
+
+    /**
+     * Get connection state.
+     *
+     * @return Connection state
+     */
+    State getState() const;
+
+    /** Invalid subscription id */
+    static const uint32_t   INVALID_ID          = 0U;
+
+    /** Max. number of subscriptions */
+    static const uint8_t    MAX_SUBSCRIPTIONS   = 16U;
+
+    /** Keep alive period in s */
+    static const uint16_t   KEEP_ALIVE          = 60U;
+
+    /** Min. period in ms between two connection attempts */
+    static const uint32_t   MIN_BACKOFF         = 1000U;
+
+    /** Max. period in ms between two connection attempts */
+    static const uint32_t   MAX_BACKOFF         = 60000U;
+
+private:
+
+    /** A subscription of a topic filter */
+    struct Subscription
+    {
+        uint32_t            id;             /**< Subscription id, INVALID_ID if unused. */
+        String              filter;         /**< Topic filter */
+        MqttSession::QoS    qos;            /**< Max. quality of service */
+        MessageCallback     callback;       /**< Message callback */
+        bool                isSubscribed;   /**< Is the filter subscribed at the broker? */
+    };
+
+    mutable SemaphoreHandle_t   m_xMutex;                               /**< Mutex to protect the client. */
+    AsyncClient*                m_tcpClient;                            /**< TCP client */
+    MqttSession                 m_session;                              /**< MQTT session */
+    State                       m_state;                                /**< Connection state */
+    String                      m_hostname;                             /**< Broker hostname */
+    uint16_t                    m_port;                                 /**< Broker port */
+    String                      m_user;                                 /**< User name */
+    String                      m_password;                             /**< Password */
+    String                      m_clientId;                             /**< Client identifier */
+    uint32_t                    m_backoff;                              /**< Period in ms until the next connection attempt */
+    SimpleTimer                 m_reconnectTimer;                       /**< Timer for the next connection attempt */
+    uint32_t                    m_nextId;                               /**< Next subscription id */
+    Subscription                m_subscriptions[MAX_SUBSCRIPTIONS];     /**< Subscriptions */
+
+    /**
+     * Constructs the MQTT client.
+     */
+    MqttClient();
+
+    /**
+     * Destroys the MQTT client.
+     */
+    ~MqttClient()
+    {
+        /* Will never be called. */
+    }
+
+    MqttClient(const MqttClient& client);
+    MqttClient& operator=(const MqttClient& client);
+
+    /**
+     * Connect to the broker.
+     */
+    void connect();
+
+    /**
+     * Schedule the next connection attempt. The period is doubled with
+     * every failed attempt.
+     */
+    void scheduleReconnect();
+
+    /**
+     * Subscribe all filters at the broker, which are not subscribed yet.
+     */
+    void subscribePending();
+
+    /**
+     * TCP client connect event handler.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] client    TCP client
+     */
+    static void onConnect(void* arg, AsyncClient* client);
+
+    /**
+     * TCP client disconnect event handler.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] client    TCP client
+     */
+    static void onDisconnect(void* arg, AsyncClient* client);
+
+    /**
+     * TCP client error event handler.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] client    TCP client
+     * @param[in] error     Error id
+     */
+    static void onError(void* arg, AsyncClient* client, int8_t error);
+
+    /**
+     * TCP client data event handler.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] client    TCP client
+     * @param[in] data      Data stream
+     * @param[in] len       Data size in byte
+     */
+    static void onData(void* arg, AsyncClient* client, void* data, size_t len);
+
+    /**
+     * TCP client ACK timeout event handler.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] client    TCP client
+     * @param[in] timeout   Timeout value in ms
+     */
+    static void onTimeout(void* arg, AsyncClient* client, uint32_t timeout);
+
+    /**
+     * MQTT session send function.
+     *
+     * @param[in] arg   MQTT client
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    static size_t sessionSend(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * MQTT session connection acknowledge function.
+     *
+     * @param[in] arg               MQTT client
+     * @param[in] isSessionPresent  Has the broker a stored session?
+     */
+    static void sessionConnAck(void* arg, bool isSessionPresent);
+
+    /**
+     * MQTT session message function. The message is forwarded to all
+     * matching subscriptions.
+     *
+     * @param[in] arg       MQTT client
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     */
+    static void sessionMessage(void* arg, const char* topic, const uint8_t* payload, size_t size);
+
+    /**
+     * Lock the client.
+     */
+    void lock() const;
+
+    /**
+     * Unlock the client.
+     */
+    void unlock() const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MQTT_CLIENT_H__ */
+
+/** @} */
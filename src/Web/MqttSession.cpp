@@ -0,0 +1,1039 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT session
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "MqttSession.h"
+
+#include <Arduino.h>
+#include <Logging.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/** MQTT control packet types, incl. the fixed flags. */
+enum PacketType
+{
+    PACKET_CONNECT      = 0x10, /**< Client request to connect */
+    PACKET_CONNACK      = 0x20, /**< Connect acknowledgment */
+    PACKET_PUBLISH      = 0x30, /**< Publish message */
+    PACKET_PUBACK       = 0x40, /**< Publish acknowledgment */
+    PACKET_SUBSCRIBE    = 0x82, /**< Subscribe request */
+    PACKET_SUBACK       = 0x90, /**< Subscribe acknowledgment */
+    PACKET_UNSUBSCRIBE  = 0xA2, /**< Unsubscribe request */
+    PACKET_UNSUBACK     = 0xB0, /**< Unsubscribe acknowledgment */
+    PACKET_PINGREQ      = 0xC0, /**< Ping request */
+    PACKET_PINGRESP     = 0xD0, /**< Ping response */
+    PACKET_DISCONNECT   = 0xE0  /**< Client is disconnecting */
+};
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Mask of the packet type in the fixed header byte. */
+static const uint8_t    PACKET_TYPE_MASK        = 0xF0U;
+
+/** Publish flag: duplicate delivery */
+static const uint8_t    PUBLISH_FLAG_DUP        = 0x08U;
+
+/** Publish flag: retain */
+static const uint8_t    PUBLISH_FLAG_RETAIN     = 0x01U;
+
+/** Connect flag: user name */
+static const uint8_t    CONNECT_FLAG_USER       = 0x80U;
+
+/** Connect flag: password */
+static const uint8_t    CONNECT_FLAG_PASSWORD   = 0x40U;
+
+/** Connect flag: clean session */
+static const uint8_t    CONNECT_FLAG_CLEAN      = 0x02U;
+
+/** Protocol level of MQTT v3.1.1 */
+static const uint8_t    PROTOCOL_LEVEL          = 4U;
+
+/** SUBACK return code, which signals a failure. */
+static const uint8_t    SUBACK_FAILURE          = 0x80U;
+
+/** Max. number of bytes of the remaining length. */
+static const uint8_t    MAX_LENGTH_BYTES        = 4U;
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+MqttSession::MqttSession() :
+    m_sendFunc(nullptr),
+    m_connAckFunc(nullptr),
+    m_messageFunc(nullptr),
+    m_arg(nullptr),
+    m_state(STATE_IDLE),
+    m_keepAlive(0U),
+    m_nextPacketId(1U),
+    m_connectTimestamp(0U),
+    m_lastTxTimestamp(0U),
+    m_lastRxTimestamp(0U),
+    m_pingTimestamp(0U),
+    m_isPingPending(false),
+    m_rxState(RX_STATE_HEADER),
+    m_rxHeader(0U),
+    m_rxLength(0U),
+    m_rxLengthBytes(0U),
+    m_rxIndex(0U),
+    m_rxBuffer(),
+    m_txBuffer(),
+    m_topic(),
+    m_inflight()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_INFLIGHT; ++index)
+    {
+        m_inflight[index].packetId  = 0U;
+        m_inflight[index].packet    = nullptr;
+        m_inflight[index].size      = 0U;
+        m_inflight[index].isSent    = false;
+    }
+}
+
+MqttSession::~MqttSession()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_INFLIGHT; ++index)
+    {
+        releaseInflight(m_inflight[index]);
+    }
+}
+
+void MqttSession::setFunctions(SendFunc sendFunc, ConnAckFunc connAckFunc, MessageFunc messageFunc, void* arg)
+{
+    m_sendFunc      = sendFunc;
+    m_connAckFunc   = connAckFunc;
+    m_messageFunc   = messageFunc;
+    m_arg           = arg;
+
+    return;
+}
+
+bool MqttSession::begin(const String& clientId, const String& user, const String& password, uint16_t keepAlive, bool cleanSession)
+{
+    const char  PROTOCOL_NAME[] = "MQTT";
+    bool        isUser          = (0U < user.length());
+    bool        isPassword      = (true == isUser) && (0U < password.length());
+    uint8_t     flags           = 0U;
+    size_t      length          = 0U;
+    size_t      index           = 0U;
+    uint8_t     inflightIndex   = 0U;
+
+    if (nullptr == m_sendFunc)
+    {
+        return false;
+    }
+
+    /* A clean session discards the not acknowledged messages too. */
+    for(inflightIndex = 0U; inflightIndex < MAX_INFLIGHT; ++inflightIndex)
+    {
+        if (true == cleanSession)
+        {
+            releaseInflight(m_inflight[inflightIndex]);
+        }
+        else
+        {
+            m_inflight[inflightIndex].isSent = false;
+        }
+    }
+
+    m_keepAlive     = keepAlive;
+    m_rxState       = RX_STATE_HEADER;
+    m_isPingPending = false;
+
+    /* Variable header: protocol name, level, flags and keep alive. Payload: client id, user, password. */
+    length = 2U + (sizeof(PROTOCOL_NAME) - 1U) + 1U + 1U + 2U + 2U + clientId.length();
+
+    if (true == isUser)
+    {
+        flags |= CONNECT_FLAG_USER;
+        length += 2U + user.length();
+    }
+
+    if (true == isPassword)
+    {
+        flags |= CONNECT_FLAG_PASSWORD;
+        length += 2U + password.length();
+    }
+
+    if (true == cleanSession)
+    {
+        flags |= CONNECT_FLAG_CLEAN;
+    }
+
+    index = putFixedHeader(PACKET_CONNECT, length);
+
+    if (0U == index)
+    {
+        LOG_WARNING("Connect request too long.");
+        m_state = STATE_ERROR;
+    }
+    else
+    {
+        index = putString(index, PROTOCOL_NAME, sizeof(PROTOCOL_NAME) - 1U);
+        m_txBuffer[index] = PROTOCOL_LEVEL;
+        ++index;
+        m_txBuffer[index] = flags;
+        ++index;
+        m_txBuffer[index] = static_cast<uint8_t>(keepAlive >> 8U);
+        ++index;
+        m_txBuffer[index] = static_cast<uint8_t>(keepAlive & 0xFFU);
+        ++index;
+        index = putString(index, clientId.c_str(), clientId.length());
+
+        if (true == isUser)
+        {
+            index = putString(index, user.c_str(), user.length());
+        }
+
+        if (true == isPassword)
+        {
+            index = putString(index, password.c_str(), password.length());
+        }
+
+        m_state             = STATE_CONNECTING;
+        m_connectTimestamp  = millis();
+        m_lastRxTimestamp   = m_connectTimestamp;
+
+        if (false == send(m_txBuffer, index))
+        {
+            m_state = STATE_ERROR;
+        }
+    }
+
+    return (STATE_CONNECTING == m_state);
+}
+
+void MqttSession::end(bool isConnected)
+{
+    const uint8_t   DISCONNECT[]    = { PACKET_DISCONNECT, 0x00U };
+    uint8_t         index           = 0U;
+
+    if ((STATE_CONNECTED == m_state) &&
+        (true == isConnected))
+    {
+        (void)send(DISCONNECT, sizeof(DISCONNECT));
+    }
+
+    for(index = 0U; index < MAX_INFLIGHT; ++index)
+    {
+        m_inflight[index].isSent = false;
+    }
+
+    m_state         = STATE_IDLE;
+    m_rxState       = RX_STATE_HEADER;
+    m_isPingPending = false;
+
+    return;
+}
+
+bool MqttSession::receive(const uint8_t* data, size_t size)
+{
+    bool    isValid = (STATE_CONNECTING == m_state) || (STATE_CONNECTED == m_state);
+    size_t  index   = 0U;
+
+    if (nullptr == data)
+    {
+        return false;
+    }
+
+    while((true == isValid) && (index < size))
+    {
+        if (RX_STATE_HEADER == m_rxState)
+        {
+            size_t      pos                 = index + 1U;
+            size_t      length              = 0U;
+            uint8_t     lengthBytes         = 0U;
+            bool        isLengthComplete    = false;
+
+            /* Decode the remaining length, as far as it is available. */
+            while((false == isLengthComplete) && (pos < size) && (MAX_LENGTH_BYTES > lengthBytes))
+            {
+                length |= static_cast<size_t>(data[pos] & 0x7FU) << (7U * lengthBytes);
+                isLengthComplete = (0U == (data[pos] & 0x80U));
+                ++pos;
+                ++lengthBytes;
+            }
+
+            if ((false == isLengthComplete) &&
+                (MAX_LENGTH_BYTES <= lengthBytes))
+            {
+                LOG_WARNING("Invalid remaining length.");
+                isValid = false;
+            }
+            /* The whole packet is available, therefore it is handled without copying. */
+            else if ((true == isLengthComplete) &&
+                     (length <= (size - pos)))
+            {
+                isValid = handlePacket(data[index], &data[pos], length);
+                index   = pos + length;
+            }
+            /* Reassemble the packet. */
+            else
+            {
+                m_rxHeader      = data[index];
+                m_rxLength      = 0U;
+                m_rxLengthBytes = 0U;
+                m_rxIndex       = 0U;
+                m_rxState       = RX_STATE_LENGTH;
+                ++index;
+            }
+        }
+        else if (RX_STATE_LENGTH == m_rxState)
+        {
+            uint8_t value = data[index];
+
+            m_rxLength |= static_cast<size_t>(value & 0x7FU) << (7U * m_rxLengthBytes);
+            ++m_rxLengthBytes;
+            ++index;
+
+            if (0U == (value & 0x80U))
+            {
+                if (0U == m_rxLength)
+                {
+                    isValid     = handlePacket(m_rxHeader, m_rxBuffer, 0U);
+                    m_rxState   = RX_STATE_HEADER;
+                }
+                else
+                {
+                    m_rxState   = RX_STATE_BODY;
+                }
+            }
+            else if (MAX_LENGTH_BYTES <= m_rxLengthBytes)
+            {
+                LOG_WARNING("Invalid remaining length.");
+                isValid = false;
+            }
+            else
+            {
+                ;
+            }
+        }
+        else
+        {
+            size_t available    = size - index;
+            size_t missing      = m_rxLength - m_rxIndex;
+            size_t chunk        = (available < missing) ? available : missing;
+
+            /* Only the begin of a too long packet is kept. */
+            if (MAX_PACKET_SIZE > m_rxIndex)
+            {
+                size_t free = MAX_PACKET_SIZE - m_rxIndex;
+
+                memcpy(&m_rxBuffer[m_rxIndex], &data[index], (chunk < free) ? chunk : free);
+            }
+
+            m_rxIndex   += chunk;
+            index       += chunk;
+
+            if (m_rxLength == m_rxIndex)
+            {
+                if (MAX_PACKET_SIZE >= m_rxLength)
+                {
+                    isValid = handlePacket(m_rxHeader, m_rxBuffer, m_rxLength);
+                }
+                else
+                {
+                    uint8_t qos         = (m_rxHeader >> 1U) & 0x03U;
+                    size_t  topicLength = (static_cast<size_t>(m_rxBuffer[0U]) << 8U) | m_rxBuffer[1U];
+
+                    LOG_WARNING("Packet with %u bytes discarded.", m_rxLength);
+
+                    /* The broker shall not send a discarded message again. */
+                    if ((PACKET_PUBLISH == (m_rxHeader & PACKET_TYPE_MASK)) &&
+                        (QOS_1 == qos) &&
+                        ((2U + topicLength + 2U) <= MAX_PACKET_SIZE))
+                    {
+                        uint16_t packetId = (static_cast<uint16_t>(m_rxBuffer[2U + topicLength]) << 8U) | m_rxBuffer[3U + topicLength];
+
+                        isValid = sendAck(PACKET_PUBACK, packetId);
+                    }
+                }
+
+                m_rxState = RX_STATE_HEADER;
+            }
+        }
+    }
+
+    if (false == isValid)
+    {
+        m_state = STATE_ERROR;
+    }
+
+    return isValid;
+}
+
+bool MqttSession::process()
+{
+    bool        isAlive = true;
+    uint32_t    now     = millis();
+
+    if (STATE_CONNECTING == m_state)
+    {
+        if (CONNACK_TIMEOUT <= (now - m_connectTimestamp))
+        {
+            LOG_WARNING("Connect acknowledge timeout.");
+            m_state = STATE_ERROR;
+        }
+    }
+    else if ((STATE_CONNECTED == m_state) &&
+             (0U < m_keepAlive))
+    {
+        uint32_t period = static_cast<uint32_t>(m_keepAlive) * 1000U;
+
+        if (true == m_isPingPending)
+        {
+            if (period <= (now - m_pingTimestamp))
+            {
+                LOG_WARNING("Ping response timeout.");
+                m_state = STATE_ERROR;
+            }
+        }
+        /* The broker expects a packet within the keep alive period. Checking the
+         * received packets too detects a broken connection, even if the client
+         * sends periodically.
+         */
+        else if ((period <= (now - m_lastTxTimestamp)) ||
+                 (period <= (now - m_lastRxTimestamp)))
+        {
+            const uint8_t PINGREQ[] = { PACKET_PINGREQ, 0x00U };
+
+            if (false == send(PINGREQ, sizeof(PINGREQ)))
+            {
+                m_state = STATE_ERROR;
+            }
+            else
+            {
+                m_isPingPending = true;
+                m_pingTimestamp = now;
+            }
+        }
+        else
+        {
+            ;
+        }
+    }
+    else
+    {
+        ;
+    }
+
+    if (STATE_ERROR == m_state)
+    {
+        isAlive = false;
+    }
+
+    return isAlive;
+}
+
+bool MqttSession::subscribe(const char* filter, QoS qos)
+{
+    bool    status  = false;
+    size_t  length  = 0U;
+    size_t  index   = 0U;
+
+    if ((nullptr == filter) ||
+        (STATE_CONNECTED != m_state))
+    {
+        return false;
+    }
+
+    length  = strlen(filter);
+    index   = putFixedHeader(PACKET_SUBSCRIBE, 2U + 2U + length + 1U);
+
+    if (0U != index)
+    {
+        uint16_t packetId = getPacketId();
+
+        m_txBuffer[index] = static_cast<uint8_t>(packetId >> 8U);
+        ++index;
+        m_txBuffer[index] = static_cast<uint8_t>(packetId & 0xFFU);
+        ++index;
+        index = putString(index, filter, length);
+        m_txBuffer[index] = static_cast<uint8_t>(qos);
+        ++index;
+
+        status = send(m_txBuffer, index);
+    }
+
+    return status;
+}
+
+bool MqttSession::unsubscribe(const char* filter)
+{
+    bool    status  = false;
+    size_t  length  = 0U;
+    size_t  index   = 0U;
+
+    if ((nullptr == filter) ||
+        (STATE_CONNECTED != m_state))
+    {
+        return false;
+    }
+
+    length  = strlen(filter);
+    index   = putFixedHeader(PACKET_UNSUBSCRIBE, 2U + 2U + length);
+
+    if (0U != index)
+    {
+        uint16_t packetId = getPacketId();
+
+        m_txBuffer[index] = static_cast<uint8_t>(packetId >> 8U);
+        ++index;
+        m_txBuffer[index] = static_cast<uint8_t>(packetId & 0xFFU);
+        ++index;
+        index = putString(index, filter, length);
+
+        status = send(m_txBuffer, index);
+    }
+
+    return status;
+}
+
+bool MqttSession::publish(const char* topic, const uint8_t* payload, size_t size, QoS qos, bool retain)
+{
+    bool        status      = false;
+    size_t      topicLength = 0U;
+    size_t      index       = 0U;
+    uint8_t     header      = PACKET_PUBLISH | (static_cast<uint8_t>(qos) << 1U);
+    uint16_t    packetId    = 0U;
+    Inflight*   inflight    = nullptr;
+
+    if ((nullptr == topic) ||
+        ((nullptr == payload) && (0U < size)))
+    {
+        return false;
+    }
+
+    if (true == retain)
+    {
+        header |= PUBLISH_FLAG_RETAIN;
+    }
+
+    /* A QoS 0 message is only sent, if connected. A QoS 1 message needs a free slot. */
+    if (QOS_0 == qos)
+    {
+        if (STATE_CONNECTED != m_state)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        uint8_t inflightIndex = 0U;
+
+        for(inflightIndex = 0U; (inflightIndex < MAX_INFLIGHT) && (nullptr == inflight); ++inflightIndex)
+        {
+            if (0U == m_inflight[inflightIndex].packetId)
+            {
+                inflight = &m_inflight[inflightIndex];
+            }
+        }
+
+        if (nullptr == inflight)
+        {
+            LOG_WARNING("Too many not acknowledged messages.");
+            return false;
+        }
+
+        packetId = getPacketId();
+    }
+
+    topicLength = strlen(topic);
+    index       = putFixedHeader(header, 2U + topicLength + ((QOS_0 == qos) ? 0U : 2U) + size);
+
+    if (0U == index)
+    {
+        LOG_WARNING("Message too long.");
+    }
+    else
+    {
+        index = putString(index, topic, topicLength);
+
+        if (QOS_0 != qos)
+        {
+            m_txBuffer[index] = static_cast<uint8_t>(packetId >> 8U);
+            ++index;
+            m_txBuffer[index] = static_cast<uint8_t>(packetId & 0xFFU);
+            ++index;
+        }
+
+        if (0U < size)
+        {
+            memcpy(&m_txBuffer[index], payload, size);
+            index += size;
+        }
+
+        if (QOS_0 == qos)
+        {
+            status = send(m_txBuffer, index);
+        }
+        else
+        {
+            inflight->packet = new uint8_t[index];
+
+            if (nullptr != inflight->packet)
+            {
+                memcpy(inflight->packet, m_txBuffer, index);
+                inflight->packetId  = packetId;
+                inflight->size      = index;
+                inflight->isSent    = false;
+
+                /* If not connected, it is sent after the connection is acknowledged. */
+                if (STATE_CONNECTED == m_state)
+                {
+                    status = sendInflight();
+                }
+                else
+                {
+                    status = true;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+uint8_t MqttSession::getInflightCount() const
+{
+    uint8_t index   = 0U;
+    uint8_t count   = 0U;
+
+    for(index = 0U; index < MAX_INFLIGHT; ++index)
+    {
+        if (0U != m_inflight[index].packetId)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+bool MqttSession::isTopicMatching(const char* filter, const char* topic)
+{
+    bool isMatching = false;
+    bool isFinished = false;
+
+    if ((nullptr == filter) ||
+        (nullptr == topic))
+    {
+        return false;
+    }
+
+    /* Topics beginning with '$' are not matched by a wildcard at the first level. */
+    if (('$' == topic[0U]) &&
+        (('+' == filter[0U]) || ('#' == filter[0U])))
+    {
+        return false;
+    }
+
+    while(false == isFinished)
+    {
+        /* The multi level wildcard matches the rest. */
+        if ('#' == *filter)
+        {
+            isMatching = true;
+            isFinished = true;
+        }
+        /* The single level wildcard matches one level. */
+        else if ('+' == *filter)
+        {
+            while(('\0' != *topic) && ('/' != *topic))
+            {
+                ++topic;
+            }
+
+            ++filter;
+        }
+        else if (*filter == *topic)
+        {
+            if ('\0' == *filter)
+            {
+                isMatching = true;
+                isFinished = true;
+            }
+            else
+            {
+                ++filter;
+                ++topic;
+            }
+        }
+        /* "a/#" matches its parent level "a" too. */
+        else if (('\0' == *topic) &&
+                 (0 == strcmp(filter, "/#")))
+        {
+            isMatching = true;
+            isFinished = true;
+        }
+        else
+        {
+            isFinished = true;
+        }
+    }
+
+    return isMatching;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+uint16_t MqttSession::getPacketId()
+{
+    uint16_t packetId = m_nextPacketId;
+
+    ++m_nextPacketId;
+
+    /* Packet identifier 0 is not allowed. */
+    if (0U == m_nextPacketId)
+    {
+        m_nextPacketId = 1U;
+    }
+
+    return packetId;
+}
+
+bool MqttSession::send(const uint8_t* packet, size_t size)
+{
+    bool status = false;
+
+    if (nullptr != m_sendFunc)
+    {
+        status = (size == m_sendFunc(m_arg, packet, size));
+
+        if (true == status)
+        {
+            m_lastTxTimestamp = millis();
+        }
+        else
+        {
+            LOG_WARNING("Failed to send %u bytes.", size);
+        }
+    }
+
+    return status;
+}
+
+size_t MqttSession::putFixedHeader(uint8_t header, size_t length)
+{
+    size_t index    = 0U;
+    size_t value    = length;
+
+    m_txBuffer[index] = header;
+    ++index;
+
+    do
+    {
+        uint8_t encoded = static_cast<uint8_t>(value & 0x7FU);
+
+        value >>= 7U;
+
+        if (0U < value)
+        {
+            encoded |= 0x80U;
+        }
+
+        m_txBuffer[index] = encoded;
+        ++index;
+    }
+    while((0U < value) && (MAX_LENGTH_BYTES >= index));
+
+    if ((0U < value) ||
+        (MAX_PACKET_SIZE < (index + length)))
+    {
+        index = 0U;
+    }
+
+    return index;
+}
+
+size_t MqttSession::putString(size_t index, const char* str, size_t length)
+{
+    m_txBuffer[index] = static_cast<uint8_t>(length >> 8U);
+    ++index;
+    m_txBuffer[index] = static_cast<uint8_t>(length & 0xFFU);
+    ++index;
+    memcpy(&m_txBuffer[index], str, length);
+
+    return index + length;
+}
+
+bool MqttSession::sendInflight()
+{
+    bool    status  = true;
+    uint8_t index   = 0U;
+
+    for(index = 0U; (index < MAX_INFLIGHT) && (true == status); ++index)
+    {
+        Inflight& inflight = m_inflight[index];
+
+        if ((0U != inflight.packetId) &&
+            (false == inflight.isSent))
+        {
+            status = send(inflight.packet, inflight.size);
+
+            if (true == status)
+            {
+                inflight.isSent = true;
+
+                /* Every further transmission is a duplicate. */
+                inflight.packet[0U] |= PUBLISH_FLAG_DUP;
+            }
+        }
+    }
+
+    return status;
+}
+
+void MqttSession::releaseInflight(Inflight& inflight)
+{
+    if (nullptr != inflight.packet)
+    {
+        delete[] inflight.packet;
+        inflight.packet = nullptr;
+    }
+
+    inflight.packetId   = 0U;
+    inflight.size       = 0U;
+    inflight.isSent     = false;
+
+    return;
+}
+
+bool MqttSession::handlePacket(uint8_t header, const uint8_t* body, size_t length)
+{
+    bool    isValid = true;
+    uint8_t type    = header & PACKET_TYPE_MASK;
+
+    m_lastRxTimestamp   = millis();
+    m_isPingPending     = false;
+
+    if (STATE_CONNECTING == m_state)
+    {
+        if ((PACKET_CONNACK != type) ||
+            (2U != length))
+        {
+            LOG_WARNING("Connect acknowledge expected.");
+            isValid = false;
+        }
+        else if (0U != body[1U])
+        {
+            LOG_WARNING("Connection refused: %u", body[1U]);
+            isValid = false;
+        }
+        else
+        {
+            bool isSessionPresent = (0U != (body[0U] & 0x01U));
+
+            m_state = STATE_CONNECTED;
+
+            /* Continue with the not acknowledged messages of the last session. */
+            isValid = sendInflight();
+
+            if ((true == isValid) &&
+                (nullptr != m_connAckFunc))
+            {
+                m_connAckFunc(m_arg, isSessionPresent);
+            }
+        }
+    }
+    else
+    {
+        switch(type)
+        {
+        case PACKET_PUBLISH:
+            isValid = handlePublish(header, body, length);
+            break;
+
+        case PACKET_PUBACK:
+            if (2U > length)
+            {
+                isValid = false;
+            }
+            else
+            {
+                uint16_t    packetId    = (static_cast<uint16_t>(body[0U]) << 8U) | body[1U];
+                uint8_t     index       = 0U;
+
+                for(index = 0U; index < MAX_INFLIGHT; ++index)
+                {
+                    if (packetId == m_inflight[index].packetId)
+                    {
+                        releaseInflight(m_inflight[index]);
+                    }
+                }
+            }
+            break;
+
+        case PACKET_SUBACK:
+            if (3U > length)
+            {
+                isValid = false;
+            }
+            else
+            {
+                size_t index = 0U;
+
+                for(index = 2U; index < length; ++index)
+                {
+                    if (SUBACK_FAILURE == body[index])
+                    {
+                        LOG_WARNING("Subscription refused.");
+                    }
+                }
+            }
+            break;
+
+        case PACKET_UNSUBACK:
+            /* fall through */
+        case PACKET_PINGRESP:
+            /* Nothing to do. */
+            break;
+
+        default:
+            LOG_WARNING("Unexpected packet 0x%02X.", header);
+            isValid = false;
+            break;
+        }
+    }
+
+    return isValid;
+}
+
+bool MqttSession::handlePublish(uint8_t header, const uint8_t* body, size_t length)
+{
+    bool        isValid     = true;
+    uint8_t     qos         = (header >> 1U) & 0x03U;
+    size_t      topicLength = 0U;
+    size_t      index       = 2U;
+    uint16_t    packetId    = 0U;
+
+    /* Only QoS 0 and 1 are subscribed. */
+    if ((QOS_1 < qos) ||
+        (2U > length))
+    {
+        return false;
+    }
+
+    topicLength = (static_cast<size_t>(body[0U]) << 8U) | body[1U];
+
+    if ((index + topicLength + ((QOS_0 == qos) ? 0U : 2U)) > length)
+    {
+        LOG_WARNING("Invalid message.");
+        isValid = false;
+    }
+    else
+    {
+        const uint8_t* topic = &body[index];
+
+        index += topicLength;
+
+        if (QOS_0 != qos)
+        {
+            packetId = (static_cast<uint16_t>(body[index]) << 8U) | body[index + 1U];
+            index += 2U;
+        }
+
+        if (MAX_TOPIC_SIZE < topicLength)
+        {
+            LOG_WARNING("Topic too long, message discarded.");
+        }
+        else if (nullptr != m_messageFunc)
+        {
+            /* Only the topic is copied, to terminate it. */
+            memcpy(m_topic, topic, topicLength);
+            m_topic[topicLength] = '\0';
+
+            m_messageFunc(m_arg, m_topic, &body[index], length - index);
+        }
+        else
+        {
+            ;
+        }
+
+        /* The message is acknowledged after it was handled. */
+        if (QOS_0 != qos)
+        {
+            isValid = sendAck(PACKET_PUBACK, packetId);
+        }
+    }
+
+    return isValid;
+}
+
+bool MqttSession::sendAck(uint8_t header, uint16_t packetId)
+{
+    uint8_t ack[4U] =
+    {
+        header,
+        0x02U,
+        static_cast<uint8_t>(packetId >> 8U),
+        static_cast<uint8_t>(packetId & 0xFFU)
+    };
+
+    return send(ack, sizeof(ack));
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,398 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  MQTT session
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __MQTT_SESSION_H__
+#define __MQTT_SESSION_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <WString.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The MQTT session implements the client side of MQTT v3.1.1 over a already
+ * established connection, independent of the transport. The packets are
+ * sent with the send function, the received data is fed in.
+ *
+ * Supported are QoS 0 and 1 in both directions. A QoS 1 message, which is
+ * published, is kept until the broker acknowledged it and is sent again
+ * after a reconnect. With a persistent session (clean session flag not set)
+ * the broker keeps the subscriptions and the QoS 1 messages for the client,
+ * while it is disconnected.
+ *
+ * A received message is provided without copying, if the whole packet is
+ * in the received data. Only packets, which are split over several received
+ * parts, are reassembled in the receive buffer.
+ *
+ * The session is not thread-safe, its owner has to protect it.
+ */
+class MqttSession
+{
+public:
+
+    /**
+     * Send function, which sends data to the broker.
+     *
+     * @param[in] arg   Argument
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    typedef size_t (*SendFunc)(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * Connection acknowledge function, called after the broker accepted
+     * the connection.
+     *
+     * @param[in] arg               Argument
+     * @param[in] isSessionPresent  Has the broker a stored session of the client?
+     */
+    typedef void (*ConnAckFunc)(void* arg, bool isSessionPresent);
+
+    /**
+     * Message function, called for every received message. The payload is
+     * only valid during the call.
+     *
+     * @param[in] arg       Argument
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     */
+    typedef void (*MessageFunc)(void* arg, const char* topic, const uint8_t* payload, size_t size);
+
+    /** Session state */
+    enum State
+    {
+        STATE_IDLE = 0,     /**< Not started */
+        STATE_CONNECTING,   /**< Connect request sent, wait for the acknowledge. */
+        STATE_CONNECTED,    /**< Accepted by the broker, messages can be exchanged. */
+        STATE_ERROR         /**< Failed, the connection shall be closed. */
+    };
+
+    /** Quality of service */
+    enum QoS
+    {
+        QOS_0 = 0,  /**< At most once delivery */
+        QOS_1       /**< At least once delivery */
+    };
+
+    /**
+     * Constructs the MQTT session.
+     */
+    MqttSession();
+
+    /**
+     * Destroys the MQTT session.
+     */
+    ~MqttSession();
+
+    /**
+     * Set the functions, which are called by the session.
+     *
+     * @param[in] sendFunc      Send function
+     * @param[in] connAckFunc   Connection acknowledge function, may be nullptr.
+     * @param[in] messageFunc   Message function, may be nullptr.
+     * @param[in] arg           Argument of the functions
+     */
+    void setFunctions(SendFunc sendFunc, ConnAckFunc connAckFunc, MessageFunc messageFunc, void* arg);
+
+    /**
+     * Start the session by sending the connect request. The transport must
+     * be already connected.
+     *
+     * @param[in] clientId      Client identifier, shall be unique per broker.
+     * @param[in] user          User name, empty if not used.
+     * @param[in] password      Password, empty if not used.
+     * @param[in] keepAlive     Keep alive period in s, 0 disables it.
+     * @param[in] cleanSession  Shall the broker discard a stored session (true) or keep it (false)?
+     *
+     * @return If successful sent, it will return true otherwise false.
+     */
+    bool begin(const String& clientId, const String& user, const String& password, uint16_t keepAlive, bool cleanSession);
+
+    /**
+     * Stop the session. If connected, a disconnect notification is sent
+     * before. Not acknowledged QoS 1 messages are kept for the next session,
+     * if it is a persistent one.
+     *
+     * @param[in] isConnected   Is the transport still connected?
+     */
+    void end(bool isConnected);
+
+    /**
+     * Feed received data in.
+     *
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return If the session is still usable, it will return true otherwise false.
+     */
+    bool receive(const uint8_t* data, size_t size);
+
+    /**
+     * Process the keep alive handling. Call it periodically.
+     *
+     * @return If the connection is alive, it will return true otherwise false.
+     */
+    bool process();
+
+    /**
+     * Subscribe a topic filter.
+     *
+     * @param[in] filter    Topic filter, may contain wildcards.
+     * @param[in] qos       Max. quality of service for the messages
+     *
+     * @return If successful sent, it will return true otherwise false.
+     */
+    bool subscribe(const char* filter, QoS qos);
+
+    /**
+     * Unsubscribe a topic filter.
+     *
+     * @param[in] filter    Topic filter
+     *
+     * @return If successful sent, it will return true otherwise false.
+     */
+    bool unsubscribe(const char* filter);
+
+    /**
+     * Publish a message. A QoS 1 message is kept until the broker
+     * acknowledged it. It is sent after connection, if the session is not
+     * connected yet.
+     *
+     * @param[in] topic     Topic name
+     * @param[in] payload   Payload
+     * @param[in] size      Payload size in byte
+     * @param[in] qos       Quality of service
+     * @param[in] retain    Shall the broker retain the message?
+     *
+     * @return If successful sent or queued, it will return true otherwise false.
+     */
+    bool publish(const char* topic, const uint8_t* payload, size_t size, QoS qos, bool retain);
+
+    /**
+     * Get session state.
+     *
+     * @return Session state
+     */
+    State getState() const
+    {
+        return m_state;
+    }
+
+    /**
+     * Get the number of published QoS 1 messages, which are not acknowledged
+     * by the broker yet.
+     *
+     * @return Number of messages
+     */
+    uint8_t getInflightCount() const;
+
+    /**
+     * Does the topic name match the topic filter? The filter may contain the
+     * single level wildcard '+' and the multi level wildcard '#'.
+     *
+     * @param[in] filter    Topic filter
+     * @param[in] topic     Topic name
+     *
+     * @return If matching, it will return true otherwise false.
+     */
+    static bool isTopicMatching(const char* filter, const char* topic);
+
+    /** Max. size in byte of a packet, which is received or sent. */
+    static const size_t     MAX_PACKET_SIZE     = 1024U;
+
+    /** Max. topic length in characters. */
+    static const size_t     MAX_TOPIC_SIZE      = 128U;
+
+    /** Max. number of published QoS 1 messages, which are not acknowledged yet. */
+    static const uint8_t    MAX_INFLIGHT        = 4U;
+
+    /** Timeout in ms for the connection acknowledge. */
+    static const uint32_t   CONNACK_TIMEOUT     = 5000U;
+
+private:
+
+    /** Receive state */
+    enum RxState
+    {
+        RX_STATE_HEADER = 0,    /**< Wait for the fixed header byte. */
+        RX_STATE_LENGTH,        /**< Receive the remaining length. */
+        RX_STATE_BODY           /**< Receive the variable header and payload. */
+    };
+
+    /** A published QoS 1 message, which is not acknowledged yet. */
+    struct Inflight
+    {
+        uint16_t    packetId;   /**< Packet identifier, 0 if unused. */
+        uint8_t*    packet;     /**< Complete packet */
+        size_t      size;       /**< Packet size in byte */
+        bool        isSent;     /**< Is the packet sent in the current session? */
+    };
+
+    SendFunc    m_sendFunc;                         /**< Send function */
+    ConnAckFunc m_connAckFunc;                      /**< Connection acknowledge function */
+    MessageFunc m_messageFunc;                      /**< Message function */
+    void*       m_arg;                              /**< Argument of the functions */
+    State       m_state;                            /**< Session state */
+    uint16_t    m_keepAlive;                        /**< Keep alive period in s */
+    uint16_t    m_nextPacketId;                     /**< Next packet identifier */
+    uint32_t    m_connectTimestamp;                 /**< Timestamp in ms of the connect request */
+    uint32_t    m_lastTxTimestamp;                  /**< Timestamp in ms of the last sent packet */
+    uint32_t    m_lastRxTimestamp;                  /**< Timestamp in ms of the last received packet */
+    uint32_t    m_pingTimestamp;                    /**< Timestamp in ms of the pending ping request */
+    bool        m_isPingPending;                    /**< Is a ping request not answered yet? */
+    RxState     m_rxState;                          /**< Receive state */
+    uint8_t     m_rxHeader;                         /**< Fixed header byte of the received packet */
+    size_t      m_rxLength;                         /**< Remaining length of the received packet */
+    uint8_t     m_rxLengthBytes;                    /**< Number of received remaining length bytes */
+    size_t      m_rxIndex;                          /**< Number of received body bytes */
+    uint8_t     m_rxBuffer[MAX_PACKET_SIZE];        /**< Buffer to reassemble a split packet */
+    uint8_t     m_txBuffer[MAX_PACKET_SIZE];        /**< Buffer to build a packet */
+    char        m_topic[MAX_TOPIC_SIZE + 1U];       /**< Topic of the received message */
+    Inflight    m_inflight[MAX_INFLIGHT];           /**< Not acknowledged QoS 1 messages */
+
+    MqttSession(const MqttSession& session);
+    MqttSession& operator=(const MqttSession& session);
+
+    /**
+     * Get the next packet identifier.
+     *
+     * @return Packet identifier
+     */
+    uint16_t getPacketId();
+
+    /**
+     * Send a packet.
+     *
+     * @param[in] packet    Packet
+     * @param[in] size      Packet size in byte
+     *
+     * @return If successful sent, it will return true otherwise false.
+     */
+    bool send(const uint8_t* packet, size_t size);
+
+    /**
+     * Build the fixed header in the transmit buffer.
+     *
+     * @param[in] header    Fixed header byte
+     * @param[in] length    Remaining length
+     *
+     * @return Size of the fixed header in byte. If the length is too long, it will return 0.
+     */
+    size_t putFixedHeader(uint8_t header, size_t length);
+
+    /**
+     * Put a string with its length in front into the transmit buffer.
+     *
+     * @param[in] index     Index in the transmit buffer
+     * @param[in] str       String
+     * @param[in] length    String length
+     *
+     * @return Index after the string
+     */
+    size_t putString(size_t index, const char* str, size_t length);
+
+    /**
+     * Send the published QoS 1 messages, which are not sent in the current
+     * session yet. After the first transmission, a message is marked as
+     * duplicate for every further one.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool sendInflight();
+
+    /**
+     * Release a published QoS 1 message.
+     *
+     * @param[in] inflight  Message
+     */
+    void releaseInflight(Inflight& inflight);
+
+    /**
+     * Handle a complete received packet.
+     *
+     * @param[in] header    Fixed header byte
+     * @param[in] body      Variable header and payload
+     * @param[in] length    Remaining length
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handlePacket(uint8_t header, const uint8_t* body, size_t length);
+
+    /**
+     * Handle a received message.
+     *
+     * @param[in] header    Fixed header byte
+     * @param[in] body      Variable header and payload
+     * @param[in] length    Remaining length
+     *
+     * @return If the message is valid, it will return true otherwise false.
+     */
+    bool handlePublish(uint8_t header, const uint8_t* body, size_t length);
+
+    /**
+     * Send a acknowledge with packet identifier.
+     *
+     * @param[in] header    Fixed header byte
+     * @param[in] packetId  Packet identifier
+     *
+     * @return If successful sent, it will return true otherwise false.
+     */
+    bool sendAck(uint8_t header, uint16_t packetId);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __MQTT_SESSION_H__ */
+
+/** @} */
@@ -43,6 +43,8 @@
 #include "RestApi.h"
 #include "PluginMgr.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
+#include "TmplIndex.h"
 
 #include <WiFi.h>
 #include <Esp.h>
@@ -88,7 +90,7 @@ static void displayPage(AsyncWebServerRequest* request);
 static void editPage(AsyncWebServerRequest* request);
 static void indexPage(AsyncWebServerRequest* request);
 static void infoPage(AsyncWebServerRequest* request);
-static bool storeSetting(KeyValue* parameter, const String& value, DynamicJsonDocument& jsonDoc);
+static bool storeSetting(KeyValue* parameter, const String& value, JsonDocument& jsonDoc);
 static void settingsPage(AsyncWebServerRequest* request);
 static void updatePage(AsyncWebServerRequest* request);
 static void uploadPage(AsyncWebServerRequest* request);
@@ -199,6 +201,8 @@ void Pages::init(AsyncWebServer& srv)
         Settings::getInstance().close();
     }
 
+    (void)TmplIndex::getInstance().load();
+
     (void)srv.on("/about.html", HTTP_GET, aboutPage)
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.on("/debug.html", HTTP_GET, debugPage)
@@ -236,6 +240,18 @@ void Pages::init(AsyncWebServer& srv)
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/images/", FILESYSTEM, "/images/", "max-age=3600")
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
+
+    /* Javascript and stylesheet files, which are referenced with their content
+     * hash as version (see scripts/prepareDataDir.py), never change. The client
+     * may cache them for 1 year without revalidation. Files requested without
+     * version are served by the next handlers.
+     */
+    (void)srv.serveStatic("/js/", FILESYSTEM, "/js/", WebConfig::VERSIONED_FILE_CACHE_CONTROL)
+        .setFilter([](AsyncWebServerRequest* request) { return request->hasParam(WebConfig::VERSION_PARAM); })
+        .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
+    (void)srv.serveStatic("/style/", FILESYSTEM, "/style/", WebConfig::VERSIONED_FILE_CACHE_CONTROL)
+        .setFilter([](AsyncWebServerRequest* request) { return request->hasParam(WebConfig::VERSION_PARAM); })
+        .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/js/", FILESYSTEM, "/js/", "max-age=3600")
         .setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());
     (void)srv.serveStatic("/style/", FILESYSTEM, "/style/", "max-age=3600")
@@ -256,7 +272,7 @@ void Pages::init(AsyncWebServer& srv)
                                 return;
                             }
 
-                            request->send(FILESYSTEM, uri, "text/html", false, tmplPageProcessor);
+                            TmplIndex::getInstance().send(request, uri, "text/html", tmplPageProcessor);
 
                         }).setAuthentication(webLoginUser.c_str(), webLoginPassword.c_str());;
 
@@ -280,7 +296,7 @@ void Pages::error(AsyncWebServerRequest* request)
 
     LOG_INFO("Invalid web request: %s", request->url().c_str());
 
-    request->send(FILESYSTEM, "/error.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/error.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -415,7 +431,7 @@ static void aboutPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/about.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/about.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -432,7 +448,7 @@ static void debugPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/debug.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/debug.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -449,7 +465,7 @@ static void displayPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/display.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/display.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -466,7 +482,7 @@ static void editPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/edit.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/edit.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -483,7 +499,7 @@ static void indexPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/index.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/index.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -500,7 +516,7 @@ static void infoPage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/info.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/info.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -514,7 +530,7 @@ static void infoPage(AsyncWebServerRequest* request)
  *
  * @return If successful stored, it will return true otherwise false.
  */
-static bool storeSetting(KeyValue* parameter, const String& value, DynamicJsonDocument& jsonDoc)
+static bool storeSetting(KeyValue* parameter, const String& value, JsonDocument& jsonDoc)
 {
     bool status = true;
 
@@ -740,7 +756,7 @@ static void settingsPage(AsyncWebServerRequest* request)
     {
         KeyValue**          list            = Settings::getInstance().getList();
         const size_t        JSON_DOC_SIZE   = 512U;
-        DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+        PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
         String              rsp;
 
         if (false == Settings::getInstance().open(false))
@@ -809,7 +825,7 @@ static void settingsPage(AsyncWebServerRequest* request)
     }
     else if (HTTP_GET == request->method())
     {
-        request->send(FILESYSTEM, "/settings.html", "text/html", false, tmplPageProcessor);
+        TmplIndex::getInstance().send(request, "/settings.html", "text/html", tmplPageProcessor);
     }
     else
     {
@@ -831,7 +847,7 @@ static void updatePage(AsyncWebServerRequest* request)
         return;
     }
 
-    request->send(FILESYSTEM, "/update.html", "text/html", false, tmplPageProcessor);
+    TmplIndex::getInstance().send(request, "/update.html", "text/html", tmplPageProcessor);
 
     return;
 }
@@ -1183,7 +1199,7 @@ namespace tmpl
             KeyValue**          list            = Settings::getInstance().getList();
             uint8_t             index           = 0U;
             const size_t        JSON_DOC_SIZE   = 4096U;
-            DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+            PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
             result.clear();
             for(index = 0U; index < Settings::KEY_VALUE_PAIR_NUM; ++index)
@@ -0,0 +1,929 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Realtime pixel stream receiver
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "PixelStreamReceiver.h"
+#include "LedMatrix.h"
+
+#include <Arduino.h>
+#include <Logging.h>
+#include <Util.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+static uint16_t getUInt16BE(const uint8_t* data);
+static uint16_t getUInt16LE(const uint8_t* data);
+static uint32_t getUInt32BE(const uint8_t* data);
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** DDP header size in bytes, without timecode. */
+static const size_t     DDP_HEADER_SIZE         = 10U;
+
+/** DDP header size in bytes, with timecode. */
+static const size_t     DDP_HEADER_SIZE_TC      = 14U;
+
+/** DDP protocol version 1 */
+static const uint8_t    DDP_VERSION_1           = 0x40U;
+
+/** DDP protocol version mask */
+static const uint8_t    DDP_VERSION_MASK        = 0xC0U;
+
+/** DDP flag: Timecode is part of the header. */
+static const uint8_t    DDP_FLAG_TIMECODE       = 0x10U;
+
+/** DDP flag: Reply */
+static const uint8_t    DDP_FLAG_REPLY          = 0x04U;
+
+/** DDP flag: Query */
+static const uint8_t    DDP_FLAG_QUERY          = 0x02U;
+
+/** DDP flag: Push, the frame is complete. */
+static const uint8_t    DDP_FLAG_PUSH           = 0x01U;
+
+/** DDP data type: RGB, 8 bit per color */
+static const uint8_t    DDP_TYPE_RGB24          = 0x0BU;
+
+/** DDP destination: Default output device */
+static const uint8_t    DDP_ID_DISPLAY          = 1U;
+
+/** DDP destination: All devices */
+static const uint8_t    DDP_ID_ALL              = 255U;
+
+/** E1.31 offset of the DMX data in a data packet */
+static const size_t     E131_DATA_OFFSET        = 126U;
+
+/** E1.31 synchronization packet size */
+static const size_t     E131_SYNC_SIZE          = 49U;
+
+/** E1.31 ACN packet identifier */
+static const uint8_t    E131_ACN_ID[]           = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0x00U, 0x00U, 0x00U };
+
+/** E1.31 root layer vector: Data packet */
+static const uint32_t   E131_VECTOR_ROOT_DATA   = 0x00000004U;
+
+/** E1.31 root layer vector: Extended packet */
+static const uint32_t   E131_VECTOR_ROOT_EXT    = 0x00000008U;
+
+/** E1.31 framing layer vector: Data packet */
+static const uint32_t   E131_VECTOR_DATA        = 0x00000002U;
+
+/** E1.31 framing layer vector: Synchronization packet */
+static const uint32_t   E131_VECTOR_SYNC        = 0x00000001U;
+
+/** E1.31 DMP layer vector: Set property */
+static const uint8_t    E131_VECTOR_DMP         = 0x02U;
+
+/** E1.31 DMP address and data type */
+static const uint8_t    E131_ADDRESS_TYPE       = 0xA1U;
+
+/** E1.31 option: Preview data, which shall not be shown. */
+static const uint8_t    E131_OPTION_PREVIEW     = 0x80U;
+
+/** E1.31 option: The stream is terminated. */
+static const uint8_t    E131_OPTION_TERMINATED  = 0x40U;
+
+/** Art-Net offset of the DMX data in a ArtDmx packet */
+static const size_t     ARTNET_DATA_OFFSET      = 18U;
+
+/** Art-Net header size (id, opcode and protocol version) */
+static const size_t     ARTNET_HEADER_SIZE      = 12U;
+
+/** Art-Net packet identifier */
+static const uint8_t    ARTNET_ID[]             = { 'A', 'r', 't', '-', 'N', 'e', 't', 0x00U };
+
+/** Art-Net min. protocol version */
+static const uint16_t   ARTNET_VERSION          = 14U;
+
+/** Art-Net opcode: ArtDmx */
+static const uint16_t   ARTNET_OP_DMX           = 0x5000U;
+
+/** Art-Net opcode: ArtSync */
+static const uint16_t   ARTNET_OP_SYNC          = 0x5200U;
+
+/**
+ * Late packets within this window of sequence numbers are discarded. A
+ * larger step back is considered as restart of the sender (E1.31 6.7.2).
+ */
+static const int16_t    SEQUENCE_WINDOW         = 20;
+
+/** Number of bytes per RGB pixel */
+static const uint8_t    BYTES_PER_PIXEL         = 3U;
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+PixelStreamReceiver::PixelStreamReceiver() :
+    m_width(0U),
+    m_height(0U),
+    m_universe(0U),
+    m_universes(0U),
+    m_pixelMap(nullptr),
+    m_sockets(),
+    m_frames(),
+    m_rxFrame(0U),
+    m_isRxFrameEmpty(true),
+    m_rxUniverses(0U),
+    m_rxTimestamp(0U),
+    m_isFrameAvailable(false),
+    m_isFrameNew(false),
+    m_frameTimestamp(0U),
+    m_protocol(PROTOCOL_DDP),
+    m_sequences(),
+    m_isArtSync(false),
+    m_artSyncTimestamp(0U),
+    m_statistics(),
+    m_latencySum(0U),
+    m_latencyCount(0U),
+    m_packet()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < PROTOCOL_MAX; ++index)
+    {
+        m_sockets[index] = -1;
+    }
+
+    m_frames[0U] = nullptr;
+    m_frames[1U] = nullptr;
+
+    resetStatistics();
+}
+
+PixelStreamReceiver::~PixelStreamReceiver()
+{
+    end();
+}
+
+bool PixelStreamReceiver::begin(uint16_t width, uint16_t height, uint16_t universe, Layout layout)
+{
+    const uint16_t  PORTS[PROTOCOL_MAX] = { DDP_PORT, E131_PORT, ARTNET_PORT };
+    uint32_t        pixelCount          = static_cast<uint32_t>(width) * height;
+    uint32_t        universes           = (pixelCount + PIXELS_PER_UNIVERSE - 1U) / PIXELS_PER_UNIVERSE;
+    bool            isSuccessful        = true;
+    uint8_t         index               = 0U;
+
+    end();
+
+    if ((0U == pixelCount) ||
+        (LAYOUT_MAX <= layout))
+    {
+        return false;
+    }
+
+    if (MAX_UNIVERSES < universes)
+    {
+        LOG_WARNING("Only %u universes are mapped to the display.", MAX_UNIVERSES);
+        universes = MAX_UNIVERSES;
+    }
+
+    m_width     = width;
+    m_height    = height;
+    m_universe  = universe;
+    m_universes = static_cast<uint8_t>(universes);
+
+    m_frames[0U] = new uint8_t[pixelCount * BYTES_PER_PIXEL];
+    m_frames[1U] = new uint8_t[pixelCount * BYTES_PER_PIXEL];
+
+    if (LAYOUT_TOPOLOGY == layout)
+    {
+        m_pixelMap = new uint16_t[pixelCount];
+    }
+
+    if ((nullptr == m_frames[0U]) ||
+        (nullptr == m_frames[1U]) ||
+        ((LAYOUT_TOPOLOGY == layout) && (nullptr == m_pixelMap)))
+    {
+        LOG_ERROR("Not enough memory for the pixel stream.");
+        isSuccessful = false;
+    }
+    else
+    {
+        memset(m_frames[0U], 0, pixelCount * BYTES_PER_PIXEL);
+        memset(m_frames[1U], 0, pixelCount * BYTES_PER_PIXEL);
+
+        /* The received pixels are in the order of the LED matrix wiring. */
+        if (nullptr != m_pixelMap)
+        {
+            LedMatrix&  matrix  = LedMatrix::getInstance();
+            uint32_t    pixel   = 0U;
+            int16_t     x       = 0;
+            int16_t     y       = 0;
+
+            for(pixel = 0U; pixel < pixelCount; ++pixel)
+            {
+                m_pixelMap[pixel] = static_cast<uint16_t>(pixel);
+            }
+
+            if ((matrix.getWidth() != width) ||
+                (matrix.getHeight() != height))
+            {
+                LOG_WARNING("Display size differs from the LED matrix, pixels are row by row.");
+            }
+            else
+            {
+                for(y = 0; y < height; ++y)
+                {
+                    for(x = 0; x < width; ++x)
+                    {
+                        uint16_t stripIndex = matrix.getStripIndex(x, y);
+
+                        if (pixelCount > stripIndex)
+                        {
+                            m_pixelMap[stripIndex] = static_cast<uint16_t>(y * width + x);
+                        }
+                    }
+                }
+            }
+        }
+
+        for(index = 0U; index < PROTOCOL_MAX; ++index)
+        {
+            m_sockets[index] = openSocket(PORTS[index]);
+
+            if (0 > m_sockets[index])
+            {
+                isSuccessful = false;
+            }
+        }
+
+        if (0 <= m_sockets[PROTOCOL_E131])
+        {
+            joinMulticastGroups(m_sockets[PROTOCOL_E131]);
+        }
+    }
+
+    if (false == isSuccessful)
+    {
+        end();
+    }
+
+    return isSuccessful;
+}
+
+void PixelStreamReceiver::end()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < PROTOCOL_MAX; ++index)
+    {
+        if (0 <= m_sockets[index])
+        {
+            (void)close(m_sockets[index]);
+            m_sockets[index] = -1;
+        }
+    }
+
+    for(index = 0U; index < UTIL_ARRAY_NUM(m_frames); ++index)
+    {
+        if (nullptr != m_frames[index])
+        {
+            delete[] m_frames[index];
+            m_frames[index] = nullptr;
+        }
+    }
+
+    if (nullptr != m_pixelMap)
+    {
+        delete[] m_pixelMap;
+        m_pixelMap = nullptr;
+    }
+
+    for(index = 0U; index < MAX_UNIVERSES; ++index)
+    {
+        m_sequences[index].isValid = false;
+    }
+
+    m_rxFrame           = 0U;
+    m_isRxFrameEmpty    = true;
+    m_rxUniverses       = 0U;
+    m_isFrameAvailable  = false;
+    m_isFrameNew        = false;
+    m_isArtSync         = false;
+
+    return;
+}
+
+void PixelStreamReceiver::process()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < PROTOCOL_MAX; ++index)
+    {
+        uint8_t count   = 0U;
+        ssize_t ret     = 1;
+
+        while((0 <= m_sockets[index]) && (0 < ret) && (MAX_PACKETS_PER_PROCESS > count))
+        {
+            ret = recvfrom(m_sockets[index], m_packet, sizeof(m_packet), MSG_DONTWAIT, nullptr, nullptr);
+
+            if (0 < ret)
+            {
+                (void)handlePacket(static_cast<Protocol>(index), m_packet, static_cast<size_t>(ret));
+            }
+
+            ++count;
+        }
+    }
+
+    /* Leave the Art-Net synchronous mode, if the controller stopped to send ArtSync. */
+    if ((true == m_isArtSync) &&
+        (ARTSYNC_TIMEOUT <= (millis() - m_artSyncTimestamp)))
+    {
+        m_isArtSync = false;
+    }
+
+    return;
+}
+
+bool PixelStreamReceiver::draw(IGfx& gfx)
+{
+    const uint8_t*  frame   = nullptr;
+    int16_t         x       = 0;
+    int16_t         y       = 0;
+    int16_t         width   = 0;
+    int16_t         height  = 0;
+
+    if (false == m_isFrameAvailable)
+    {
+        return false;
+    }
+
+    if (true == m_isFrameNew)
+    {
+        uint32_t latency = micros() - m_frameTimestamp;
+
+        m_latencySum += latency;
+        ++m_latencyCount;
+
+        if (m_statistics.maxLatency < latency)
+        {
+            m_statistics.maxLatency = latency;
+        }
+
+        m_isFrameNew = false;
+    }
+
+    /* The frame, which is not received, is the complete one. */
+    frame   = m_frames[1U - m_rxFrame];
+    width   = (gfx.getWidth() < m_width) ? gfx.getWidth() : m_width;
+    height  = (gfx.getHeight() < m_height) ? gfx.getHeight() : m_height;
+
+    for(y = 0; y < height; ++y)
+    {
+        const uint8_t* pixel = &frame[static_cast<uint32_t>(y) * m_width * BYTES_PER_PIXEL];
+
+        for(x = 0; x < width; ++x)
+        {
+            gfx.drawPixel(x, y, Color(pixel[0U], pixel[1U], pixel[2U]));
+            pixel += BYTES_PER_PIXEL;
+        }
+    }
+
+    return true;
+}
+
+bool PixelStreamReceiver::handlePacket(Protocol protocol, const uint8_t* packet, size_t size)
+{
+    bool isValid = false;
+
+    if ((nullptr == packet) ||
+        (nullptr == m_frames[0U]))
+    {
+        return false;
+    }
+
+    selectProtocol(protocol);
+
+    switch(protocol)
+    {
+    case PROTOCOL_DDP:
+        isValid = handleDdp(packet, size);
+        break;
+
+    case PROTOCOL_E131:
+        isValid = handleE131(packet, size);
+        break;
+
+    case PROTOCOL_ARTNET:
+        isValid = handleArtNet(packet, size);
+        break;
+
+    default:
+        break;
+    }
+
+    if (true == isValid)
+    {
+        ++m_statistics.packets;
+    }
+    else
+    {
+        ++m_statistics.invalidPackets;
+    }
+
+    return isValid;
+}
+
+void PixelStreamReceiver::getStatistics(Statistics& statistics) const
+{
+    statistics = m_statistics;
+
+    if (0U < m_latencyCount)
+    {
+        statistics.avgLatency = static_cast<uint32_t>(m_latencySum / m_latencyCount);
+    }
+
+    return;
+}
+
+void PixelStreamReceiver::resetStatistics()
+{
+    m_statistics.packets            = 0U;
+    m_statistics.invalidPackets     = 0U;
+    m_statistics.lostPackets        = 0U;
+    m_statistics.outOfOrderPackets  = 0U;
+    m_statistics.frames             = 0U;
+    m_statistics.incompleteFrames   = 0U;
+    m_statistics.droppedFrames      = 0U;
+    m_statistics.avgLatency         = 0U;
+    m_statistics.maxLatency         = 0U;
+    m_latencySum                    = 0U;
+    m_latencyCount                  = 0U;
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+int PixelStreamReceiver::openSocket(uint16_t port)
+{
+    int                 socketFd    = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    int                 option      = 1;
+    struct sockaddr_in  addr;
+
+    if (0 > socketFd)
+    {
+        LOG_ERROR("Failed to create socket for UDP port %u.", port);
+    }
+    else
+    {
+        (void)setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family         = AF_INET;
+        addr.sin_port           = htons(port);
+        addr.sin_addr.s_addr    = htonl(INADDR_ANY);
+
+        if (0 != bind(socketFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)))
+        {
+            LOG_ERROR("Failed to bind UDP port %u.", port);
+            (void)close(socketFd);
+            socketFd = -1;
+        }
+    }
+
+    return socketFd;
+}
+
+void PixelStreamReceiver::joinMulticastGroups(int socketFd)
+{
+    uint8_t index = 0U;
+
+    /* E1.31 multicast address: 239.255.<universe high byte>.<universe low byte> */
+    for(index = 0U; index < m_universes; ++index)
+    {
+        struct ip_mreq  mreq;
+        uint16_t        universe    = m_universe + index;
+
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr.s_addr   = htonl(0xEFFF0000U | universe);
+        mreq.imr_interface.s_addr   = htonl(INADDR_ANY);
+
+        if (0 != setsockopt(socketFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)))
+        {
+            LOG_WARNING("Failed to join E1.31 multicast group of universe %u.", universe);
+        }
+    }
+
+    return;
+}
+
+bool PixelStreamReceiver::handleDdp(const uint8_t* packet, size_t size)
+{
+    bool        isValid     = false;
+    uint8_t     flags       = 0U;
+    size_t      headerSize  = DDP_HEADER_SIZE;
+    uint32_t    offset      = 0U;
+    uint16_t    length      = 0U;
+
+    if (DDP_HEADER_SIZE > size)
+    {
+        return false;
+    }
+
+    flags = packet[0U];
+
+    if (0U != (flags & DDP_FLAG_TIMECODE))
+    {
+        headerSize = DDP_HEADER_SIZE_TC;
+    }
+
+    offset = getUInt32BE(&packet[4U]);
+    length = getUInt16BE(&packet[8U]);
+
+    /* Only pixel data for the display is supported, no queries and no configuration. */
+    if ((DDP_VERSION_1 == (flags & DDP_VERSION_MASK)) &&
+        (0U == (flags & (DDP_FLAG_REPLY | DDP_FLAG_QUERY))) &&
+        ((0U == packet[2U]) || (1U == packet[2U]) || (DDP_TYPE_RGB24 == packet[2U])) &&
+        ((DDP_ID_DISPLAY == packet[3U]) || (DDP_ID_ALL == packet[3U])) &&
+        (headerSize <= size) &&
+        (length <= (size - headerSize)) &&
+        (0U == (offset % BYTES_PER_PIXEL)))
+    {
+        uint8_t sequence = packet[1U] & 0x0FU;
+
+        isValid = true;
+
+        /* Sequence number 0 means, the sender doesn't use them. */
+        if ((0U == sequence) ||
+            (true == checkSequence(m_sequences[0U], sequence, 1U, 15U)))
+        {
+            writePixels(offset / BYTES_PER_PIXEL, &packet[headerSize], length / BYTES_PER_PIXEL);
+
+            if (0U != (flags & DDP_FLAG_PUSH))
+            {
+                completeFrame();
+            }
+        }
+    }
+
+    return isValid;
+}
+
+bool PixelStreamReceiver::handleE131(const uint8_t* packet, size_t size)
+{
+    bool        isValid     = false;
+    uint32_t    rootVector  = 0U;
+
+    /* Root layer */
+    if ((E131_SYNC_SIZE > size) ||
+        (0x0010U != getUInt16BE(&packet[0U])) ||
+        (0U != getUInt16BE(&packet[2U])) ||
+        (0 != memcmp(&packet[4U], E131_ACN_ID, sizeof(E131_ACN_ID))))
+    {
+        return false;
+    }
+
+    rootVector = getUInt32BE(&packet[18U]);
+
+    /* Data packet */
+    if ((E131_VECTOR_ROOT_DATA == rootVector) &&
+        (E131_DATA_OFFSET <= size) &&
+        (E131_VECTOR_DATA == getUInt32BE(&packet[40U])) &&
+        (E131_VECTOR_DMP == packet[117U]) &&
+        (E131_ADDRESS_TYPE == packet[118U]))
+    {
+        uint16_t    syncAddress = getUInt16BE(&packet[109U]);
+        uint8_t     sequence    = packet[111U];
+        uint8_t     options     = packet[112U];
+        uint16_t    universe    = getUInt16BE(&packet[113U]);
+        uint16_t    count       = getUInt16BE(&packet[123U]);
+        uint8_t     startCode   = packet[125U];
+
+        /* The property value count includes the start code. */
+        if ((0U < count) &&
+            ((E131_DATA_OFFSET - 1U + count) <= size))
+        {
+            isValid = true;
+
+            /* Only DMX data of the mapped universes, no preview data and
+             * no other start codes, like per-address priority.
+             */
+            if ((m_universe <= universe) &&
+                ((universe - m_universe) < m_universes) &&
+                (0U == (options & (E131_OPTION_PREVIEW | E131_OPTION_TERMINATED))) &&
+                (0U == startCode) &&
+                (true == checkSequence(m_sequences[universe - m_universe], sequence, 0U, 256U)))
+            {
+                writeUniverse(universe, &packet[E131_DATA_OFFSET], count - 1U, 0U != syncAddress);
+            }
+        }
+    }
+    /* Synchronization packet */
+    else if ((E131_VECTOR_ROOT_EXT == rootVector) &&
+             (E131_VECTOR_SYNC == getUInt32BE(&packet[40U])))
+    {
+        isValid = true;
+
+        completeFrame();
+    }
+
+    return isValid;
+}
+
+bool PixelStreamReceiver::handleArtNet(const uint8_t* packet, size_t size)
+{
+    bool        isValid = false;
+    uint16_t    opCode  = 0U;
+
+    if ((ARTNET_HEADER_SIZE > size) ||
+        (0 != memcmp(&packet[0U], ARTNET_ID, sizeof(ARTNET_ID))) ||
+        (ARTNET_VERSION > getUInt16BE(&packet[10U])))
+    {
+        return false;
+    }
+
+    opCode = getUInt16LE(&packet[8U]);
+
+    if ((ARTNET_OP_DMX == opCode) &&
+        (ARTNET_DATA_OFFSET <= size))
+    {
+        uint8_t     sequence    = packet[12U];
+        uint16_t    universe    = (static_cast<uint16_t>(packet[15U] & 0x7FU) << 8U) | packet[14U];
+        uint16_t    length      = getUInt16BE(&packet[16U]);
+
+        if (length <= (size - ARTNET_DATA_OFFSET))
+        {
+            isValid = true;
+
+            /* Sequence number 0 means, the sender doesn't use them. */
+            if ((m_universe <= universe) &&
+                ((universe - m_universe) < m_universes) &&
+                ((0U == sequence) || (true == checkSequence(m_sequences[universe - m_universe], sequence, 1U, 255U))))
+            {
+                writeUniverse(universe, &packet[ARTNET_DATA_OFFSET], length, m_isArtSync);
+            }
+        }
+    }
+    else if (ARTNET_OP_SYNC == opCode)
+    {
+        isValid = true;
+
+        m_isArtSync         = true;
+        m_artSyncTimestamp  = millis();
+
+        completeFrame();
+    }
+
+    return isValid;
+}
+
+bool PixelStreamReceiver::checkSequence(Sequence& sequence, uint8_t number, uint8_t first, uint16_t count)
+{
+    bool    isAccepted  = true;
+    int16_t diff        = 0;
+
+    if (true == sequence.isValid)
+    {
+        /* Distance in the sequence number range, considering the wrap around. */
+        diff = static_cast<int16_t>((static_cast<int16_t>(number - first) - static_cast<int16_t>(sequence.number - first) + count) % count);
+
+        if ((count / 2) < diff)
+        {
+            diff -= count;
+        }
+
+        /* Duplicated or late packet? A larger step back is a restart of the sender. */
+        if ((0 >= diff) &&
+            (-SEQUENCE_WINDOW < diff))
+        {
+            ++m_statistics.outOfOrderPackets;
+            isAccepted = false;
+        }
+        /* Gap in the sequence? */
+        else if (1 < diff)
+        {
+            m_statistics.lostPackets += diff - 1;
+        }
+    }
+
+    if (true == isAccepted)
+    {
+        sequence.isValid    = true;
+        sequence.number     = number;
+    }
+
+    return isAccepted;
+}
+
+void PixelStreamReceiver::writeUniverse(uint16_t universe, const uint8_t* data, size_t size, bool isSynchronous)
+{
+    uint8_t     index       = static_cast<uint8_t>(universe - m_universe);
+    uint32_t    mask        = 1UL << index;
+    uint32_t    allMask     = (MAX_UNIVERSES <= m_universes) ? UINT32_MAX : ((1UL << m_universes) - 1UL);
+    uint32_t    count       = size / BYTES_PER_PIXEL;
+
+    /* Without synchronization, a universe which is received twice starts the next frame. */
+    if ((false == isSynchronous) &&
+        (0U != (m_rxUniverses & mask)))
+    {
+        completeFrame();
+    }
+
+    if (PIXELS_PER_UNIVERSE < count)
+    {
+        count = PIXELS_PER_UNIVERSE;
+    }
+
+    writePixels(static_cast<uint32_t>(index) * PIXELS_PER_UNIVERSE, data, count);
+    m_rxUniverses |= mask;
+
+    if ((false == isSynchronous) &&
+        (allMask == m_rxUniverses))
+    {
+        completeFrame();
+    }
+
+    return;
+}
+
+void PixelStreamReceiver::writePixels(uint32_t index, const uint8_t* data, uint32_t count)
+{
+    uint32_t    pixelCount  = static_cast<uint32_t>(m_width) * m_height;
+    uint8_t*    frame       = m_frames[m_rxFrame];
+    uint32_t    pixel       = 0U;
+
+    if (true == m_isRxFrameEmpty)
+    {
+        m_rxTimestamp       = micros();
+        m_isRxFrameEmpty    = false;
+    }
+
+    for(pixel = 0U; (pixel < count) && ((index + pixel) < pixelCount); ++pixel)
+    {
+        uint32_t dst = index + pixel;
+
+        if (nullptr != m_pixelMap)
+        {
+            dst = m_pixelMap[dst];
+        }
+
+        memcpy(&frame[dst * BYTES_PER_PIXEL], &data[pixel * BYTES_PER_PIXEL], BYTES_PER_PIXEL);
+    }
+
+    return;
+}
+
+void PixelStreamReceiver::completeFrame()
+{
+    uint32_t    allMask     = (MAX_UNIVERSES <= m_universes) ? UINT32_MAX : ((1UL << m_universes) - 1UL);
+    uint32_t    frameSize   = static_cast<uint32_t>(m_width) * m_height * BYTES_PER_PIXEL;
+
+    /* Nothing received since the last frame? */
+    if (true == m_isRxFrameEmpty)
+    {
+        return;
+    }
+
+    if (true == m_isFrameNew)
+    {
+        ++m_statistics.droppedFrames;
+    }
+
+    if ((PROTOCOL_DDP != m_protocol) &&
+        (allMask != m_rxUniverses))
+    {
+        ++m_statistics.incompleteFrames;
+    }
+
+    ++m_statistics.frames;
+
+    m_isFrameAvailable  = true;
+    m_isFrameNew        = true;
+    m_frameTimestamp    = m_rxTimestamp;
+
+    /* Swap the frames. The next frame starts with the content of the complete
+     * one, because a packet may be lost or the controller updates only parts.
+     */
+    m_rxFrame = 1U - m_rxFrame;
+    memcpy(m_frames[m_rxFrame], m_frames[1U - m_rxFrame], frameSize);
+
+    m_isRxFrameEmpty    = true;
+    m_rxUniverses       = 0U;
+
+    return;
+}
+
+void PixelStreamReceiver::selectProtocol(Protocol protocol)
+{
+    uint8_t index = 0U;
+
+    if (protocol != m_protocol)
+    {
+        m_protocol      = protocol;
+        m_rxUniverses   = 0U;
+
+        for(index = 0U; index < MAX_UNIVERSES; ++index)
+        {
+            m_sequences[index].isValid = false;
+        }
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
+
+/**
+ * Get a 16-bit value in big endian byte order.
+ *
+ * @param[in] data  Data
+ *
+ * @return Value
+ */
+static uint16_t getUInt16BE(const uint8_t* data)
+{
+    return (static_cast<uint16_t>(data[0U]) << 8U) | data[1U];
+}
+
+/**
+ * Get a 16-bit value in little endian byte order.
+ *
+ * @param[in] data  Data
+ *
+ * @return Value
+ */
+static uint16_t getUInt16LE(const uint8_t* data)
+{
+    return (static_cast<uint16_t>(data[1U]) << 8U) | data[0U];
+}
+
+/**
+ * Get a 32-bit value in big endian byte order.
+ *
+ * @param[in] data  Data
+ *
+ * @return Value
+ */
+static uint32_t getUInt32BE(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[0U]) << 24U) |
+           (static_cast<uint32_t>(data[1U]) << 16U) |
+           (static_cast<uint32_t>(data[2U]) << 8U) |
+           data[3U];
+}
@@ -0,0 +1,345 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Realtime pixel stream receiver
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __PIXEL_STREAM_RECEIVER_H__
+#define __PIXEL_STREAM_RECEIVER_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <IGfx.hpp>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The pixel stream receiver listens on UDP for pixel data, sent by a light
+ * show controller. Supported protocols are DDP, E1.31 (sACN) and Art-Net.
+ *
+ * The pixel data of a packet is written directly into the frame, which is
+ * currently received. A frame is complete on
+ * - a DDP packet with the push flag,
+ * - a E1.31 synchronization packet or a ArtSync packet,
+ * - the last missing universe, if the controller doesn't synchronize.
+ *
+ * A complete frame replaces the frame, which is ready to show. If it was not
+ * shown yet, it is dropped. Frames are never queued, which keeps the added
+ * latency at minimum.
+ *
+ * Packets are checked by their sequence number. Duplicated and late packets
+ * are discarded, gaps are counted as lost packets.
+ *
+ * The receiver is not thread-safe, all methods shall be called in the
+ * same context.
+ */
+class PixelStreamReceiver
+{
+public:
+
+    /**
+     * Supported protocols.
+     */
+    enum Protocol
+    {
+        PROTOCOL_DDP = 0,   /**< Distributed Display Protocol */
+        PROTOCOL_E131,      /**< E1.31 (sACN) */
+        PROTOCOL_ARTNET,    /**< Art-Net */
+        PROTOCOL_MAX        /**< Number of protocols */
+    };
+
+    /**
+     * Mapping of the received pixels to the display.
+     */
+    enum Layout
+    {
+        LAYOUT_TOPOLOGY = 0,    /**< Pixels are in the order of the LED matrix wiring. */
+        LAYOUT_ROW_MAJOR,       /**< Pixels are row by row, starting top left. */
+        LAYOUT_MAX              /**< Number of layouts */
+    };
+
+    /**
+     * Receiver statistics.
+     */
+    struct Statistics
+    {
+        uint32_t    packets;            /**< Number of valid packets */
+        uint32_t    invalidPackets;     /**< Number of invalid or not supported packets */
+        uint32_t    lostPackets;        /**< Number of lost packets, derived from the sequence numbers */
+        uint32_t    outOfOrderPackets;  /**< Number of discarded duplicated or late packets */
+        uint32_t    frames;             /**< Number of frames, which are ready to show */
+        uint32_t    incompleteFrames;   /**< Number of frames, which universes were not all received */
+        uint32_t    droppedFrames;      /**< Number of frames, which were replaced before shown */
+        uint32_t    avgLatency;         /**< Avg. latency in us from the first packet of a frame until it is shown */
+        uint32_t    maxLatency;         /**< Max. latency in us from the first packet of a frame until it is shown */
+    };
+
+    /**
+     * Constructs the pixel stream receiver.
+     */
+    PixelStreamReceiver();
+
+    /**
+     * Destroys the pixel stream receiver.
+     */
+    ~PixelStreamReceiver();
+
+    /**
+     * Start receiving. If already started, it will be restarted.
+     *
+     * @param[in] width     Display width in pixels
+     * @param[in] height    Display height in pixels
+     * @param[in] universe  First universe, used by E1.31 and Art-Net
+     * @param[in] layout    Pixel mapping to the display
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool begin(uint16_t width, uint16_t height, uint16_t universe, Layout layout);
+
+    /**
+     * Stop receiving and release all resources.
+     */
+    void end();
+
+    /**
+     * Process all received packets. Call it periodically, at least once
+     * before every draw().
+     */
+    void process();
+
+    /**
+     * Draw the last complete frame.
+     *
+     * @param[in] gfx   Graphics interface
+     *
+     * @return If no frame was received yet, it will return false otherwise true.
+     */
+    bool draw(IGfx& gfx);
+
+    /**
+     * Handle a single packet. It is used by process() and can be used to
+     * feed packets, which are received in a different way.
+     *
+     * @param[in] protocol  Protocol of the packet
+     * @param[in] packet    Packet data
+     * @param[in] size      Packet size in bytes
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handlePacket(Protocol protocol, const uint8_t* packet, size_t size);
+
+    /**
+     * Get the statistics.
+     *
+     * @param[out] statistics   Statistics
+     */
+    void getStatistics(Statistics& statistics) const;
+
+    /**
+     * Reset the statistics.
+     */
+    void resetStatistics();
+
+    /** DDP UDP port */
+    static const uint16_t   DDP_PORT                = 4048U;
+
+    /** E1.31 UDP port */
+    static const uint16_t   E131_PORT               = 5568U;
+
+    /** Art-Net UDP port */
+    static const uint16_t   ARTNET_PORT             = 6454U;
+
+    /** Number of RGB pixels in a E1.31 and Art-Net universe. */
+    static const uint16_t   PIXELS_PER_UNIVERSE     = 170U;
+
+    /** Max. number of universes, which are mapped to the display. */
+    static const uint8_t    MAX_UNIVERSES           = 32U;
+
+    /** Max. UDP packet size in bytes. */
+    static const size_t     MAX_PACKET_SIZE         = 1472U;
+
+    /** Max. number of packets, which are processed in one process() call. */
+    static const uint8_t    MAX_PACKETS_PER_PROCESS = 32U;
+
+    /**
+     * Art-Net synchronous mode is left, if no ArtSync is received within
+     * this time in ms.
+     */
+    static const uint32_t   ARTSYNC_TIMEOUT         = 4000U;
+
+private:
+
+    /** Sequence number state of a universe. */
+    struct Sequence
+    {
+        bool    isValid;    /**< Is a sequence number received? */
+        uint8_t number;     /**< Last received sequence number */
+    };
+
+    uint16_t    m_width;                        /**< Display width in pixels */
+    uint16_t    m_height;                       /**< Display height in pixels */
+    uint16_t    m_universe;                     /**< First universe */
+    uint8_t     m_universes;                    /**< Number of universes, which cover the display */
+    uint16_t*   m_pixelMap;                     /**< Maps the received pixel index to the display pixel index, nullptr for row-major. */
+    int         m_sockets[PROTOCOL_MAX];        /**< UDP sockets per protocol */
+    uint8_t*    m_frames[2U];                   /**< Frame buffers (RGB888) */
+    uint8_t     m_rxFrame;                      /**< Index of the frame, which is received. */
+    bool        m_isRxFrameEmpty;               /**< Is no data in the received frame yet? */
+    uint32_t    m_rxUniverses;                  /**< Bitmask of the universes, received for the current frame. */
+    uint32_t    m_rxTimestamp;                  /**< Timestamp in us of the first packet of the received frame. */
+    bool        m_isFrameAvailable;             /**< Is a complete frame available? */
+    bool        m_isFrameNew;                   /**< Is the complete frame not shown yet? */
+    uint32_t    m_frameTimestamp;               /**< Timestamp in us of the first packet of the complete frame. */
+    Protocol    m_protocol;                     /**< Protocol of the last packet */
+    Sequence    m_sequences[MAX_UNIVERSES];     /**< Sequence numbers per universe, DDP uses the first one. */
+    bool        m_isArtSync;                    /**< Is Art-Net in synchronous mode? */
+    uint32_t    m_artSyncTimestamp;             /**< Timestamp in ms of the last ArtSync */
+    Statistics  m_statistics;                   /**< Statistics */
+    uint64_t    m_latencySum;                   /**< Sum of all latencies in us */
+    uint32_t    m_latencyCount;                 /**< Number of shown frames, which latency is summed up */
+    uint8_t     m_packet[MAX_PACKET_SIZE];      /**< Receive buffer */
+
+    PixelStreamReceiver(const PixelStreamReceiver& receiver);
+    PixelStreamReceiver& operator=(const PixelStreamReceiver& receiver);
+
+    /**
+     * Open a UDP socket.
+     *
+     * @param[in] port  UDP port
+     *
+     * @return Socket. If failed, it will return -1.
+     */
+    int openSocket(uint16_t port);
+
+    /**
+     * Join the E1.31 multicast groups of all universes, which cover the
+     * display.
+     *
+     * @param[in] socketFd  E1.31 socket
+     */
+    void joinMulticastGroups(int socketFd);
+
+    /**
+     * Handle a DDP packet.
+     *
+     * @param[in] packet    Packet data
+     * @param[in] size      Packet size in bytes
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handleDdp(const uint8_t* packet, size_t size);
+
+    /**
+     * Handle a E1.31 packet.
+     *
+     * @param[in] packet    Packet data
+     * @param[in] size      Packet size in bytes
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handleE131(const uint8_t* packet, size_t size);
+
+    /**
+     * Handle a Art-Net packet.
+     *
+     * @param[in] packet    Packet data
+     * @param[in] size      Packet size in bytes
+     *
+     * @return If the packet is valid, it will return true otherwise false.
+     */
+    bool handleArtNet(const uint8_t* packet, size_t size);
+
+    /**
+     * Check the sequence number of a packet.
+     *
+     * @param[in] sequence  Sequence number state
+     * @param[in] number    Received sequence number
+     * @param[in] first     First valid sequence number
+     * @param[in] count     Number of valid sequence numbers
+     *
+     * @return If the packet shall be processed, it will return true otherwise false.
+     */
+    bool checkSequence(Sequence& sequence, uint8_t number, uint8_t first, uint16_t count);
+
+    /**
+     * Write the DMX data of a universe to the received frame.
+     *
+     * @param[in] universe      Universe
+     * @param[in] data          DMX data
+     * @param[in] size          DMX data size in bytes
+     * @param[in] isSynchronous Is the frame completed by a synchronization packet?
+     */
+    void writeUniverse(uint16_t universe, const uint8_t* data, size_t size, bool isSynchronous);
+
+    /**
+     * Write pixels to the received frame.
+     *
+     * @param[in] index Index of the first pixel
+     * @param[in] data  RGB888 pixel data
+     * @param[in] count Number of pixels
+     */
+    void writePixels(uint32_t index, const uint8_t* data, uint32_t count);
+
+    /**
+     * The received frame is complete, it replaces the frame which is
+     * ready to show.
+     */
+    void completeFrame();
+
+    /**
+     * Start a new frame, after the protocol changed.
+     *
+     * @param[in] protocol  Protocol of the received packet
+     */
+    void selectProtocol(Protocol protocol);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __PIXEL_STREAM_RECEIVER_H__ */
+
+/** @} */
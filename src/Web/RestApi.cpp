@@ -41,12 +41,14 @@
 #include "PluginMgr.h"
 #include "WiFiUtil.h"
 #include "FileSystem.h"
+#include "JsonDocPool.h"
 
 #include <Util.h>
 #include <WiFi.h>
 #include <ArduinoJson.h>
 #include <Esp.h>
 #include <Logging.h>
+#include <memory>
 
 /******************************************************************************
  * Compiler Switches
@@ -60,6 +62,691 @@
  * Types and classes
  *****************************************************************************/
 
+/**
+ * Print sink, which doesn't store the content, but calculates a FNV-1a hash
+ * of it and counts the characters. It is used to derive the ETag of a JSON
+ * document without serializing it into a buffer.
+ */
+class HashPrint : public Print
+{
+public:
+
+    /**
+     * Constructs a empty hash sink.
+     */
+    HashPrint() :
+        Print(),
+        m_hash(FNV_OFFSET_BASIS),
+        m_length(0U)
+    {
+    }
+
+    /**
+     * Destroys the hash sink.
+     */
+    ~HashPrint()
+    {
+    }
+
+    /**
+     * Add a single character to the hash.
+     *
+     * @param[in] data  Character
+     *
+     * @return Number of processed characters
+     */
+    size_t write(uint8_t data) final
+    {
+        m_hash ^= data;
+        m_hash *= FNV_PRIME;
+        ++m_length;
+
+        return 1U;
+    }
+
+    /**
+     * Add several characters to the hash.
+     *
+     * @param[in] buffer    Characters
+     * @param[in] size      Number of characters
+     *
+     * @return Number of processed characters
+     */
+    size_t write(const uint8_t* buffer, size_t size) final
+    {
+        size_t idx = 0U;
+
+        for(idx = 0U; idx < size; ++idx)
+        {
+            m_hash ^= buffer[idx];
+            m_hash *= FNV_PRIME;
+        }
+
+        m_length += size;
+
+        return size;
+    }
+
+    /**
+     * Get the hash of all characters so far.
+     *
+     * @return Hash
+     */
+    uint32_t getHash() const
+    {
+        return m_hash;
+    }
+
+    /**
+     * Get the number of characters so far.
+     *
+     * @return Number of characters
+     */
+    size_t getLength() const
+    {
+        return m_length;
+    }
+
+private:
+
+    static const uint32_t   FNV_OFFSET_BASIS    = 2166136261UL; /**< FNV-1a offset basis */
+    static const uint32_t   FNV_PRIME           = 16777619UL;   /**< FNV-1a prime */
+
+    uint32_t    m_hash;     /**< Hash of the content */
+    size_t      m_length;   /**< Content length in characters */
+
+    HashPrint(const HashPrint& print);
+    HashPrint& operator=(const HashPrint& print);
+};
+
+/**
+ * Directory listing, which is sent part by part as chunked response.
+ * Only one directory entry is serialized at once, therefore the memory
+ * consumption doesn't depend on the number of files in the directory.
+ */
+class DirListing
+{
+public:
+
+    /**
+     * Constructs the directory listing.
+     *
+     * @param[in] path      Path of the directory
+     * @param[in] preCount  Number of entries, which to skip at the begin.
+     * @param[in] count     Max. number of listed entries
+     */
+    DirListing(const String& path, uint32_t preCount, uint32_t count) :
+        m_fdRoot(FILESYSTEM.open(path, "r")),
+        m_preCount(preCount),
+        m_count(count),
+        m_state(STATE_HEAD),
+        m_isFirst(true),
+        m_part(),
+        m_partIdx(0U)
+    {
+        if (false == m_fdRoot)
+        {
+            LOG_WARNING("Invalid path.");
+            m_count = 0U;
+        }
+        else if (false == m_fdRoot.isDirectory())
+        {
+            LOG_WARNING("Requested path is not a directory.");
+            m_count = 0U;
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    /**
+     * Destroys the directory listing.
+     */
+    ~DirListing()
+    {
+        m_fdRoot.close();
+    }
+
+    /**
+     * Fill the response buffer with the next part of the listing.
+     *
+     * @param[in] buffer    Response buffer
+     * @param[in] maxLen    Response buffer size in byte
+     *
+     * @return Number of written bytes. If 0, the listing is complete.
+     */
+    size_t fill(uint8_t* buffer, size_t maxLen)
+    {
+        size_t  written = 0U;
+        bool    isEnd   = false;
+
+        while((written < maxLen) && (false == isEnd))
+        {
+            if (m_part.length() <= m_partIdx)
+            {
+                isEnd = (false == nextPart());
+            }
+            else
+            {
+                size_t len = m_part.length() - m_partIdx;
+
+                if ((maxLen - written) < len)
+                {
+                    len = maxLen - written;
+                }
+
+                memcpy(&buffer[written], &m_part.c_str()[m_partIdx], len);
+                written     += len;
+                m_partIdx   += len;
+            }
+        }
+
+        return written;
+    }
+
+private:
+
+    /** Listing state */
+    enum State
+    {
+        STATE_HEAD = 0, /**< Begin of the JSON document */
+        STATE_ENTRIES,  /**< Directory entries */
+        STATE_DONE      /**< JSON document completed */
+    };
+
+    /** Size of the JSON document for a single directory entry */
+    static const size_t JSON_ENTRY_SIZE = JSON_OBJECT_SIZE(3);
+
+    File        m_fdRoot;   /**< Directory */
+    uint32_t    m_preCount; /**< Number of entries, which are still to skip. */
+    uint32_t    m_count;    /**< Number of entries, which may still be listed. */
+    State       m_state;    /**< Listing state */
+    bool        m_isFirst;  /**< Is the next entry the first one? */
+    String      m_part;     /**< Current serialized part */
+    size_t      m_partIdx;  /**< Number of already sent characters of the current part */
+
+    DirListing(const DirListing& listing);
+    DirListing& operator=(const DirListing& listing);
+
+    /**
+     * Serialize the next part of the listing.
+     *
+     * @return If a part is available, it will return true otherwise false.
+     */
+    bool nextPart()
+    {
+        bool isAvailable = true;
+
+        m_part      = "";
+        m_partIdx   = 0U;
+
+        if (STATE_HEAD == m_state)
+        {
+            m_part  = "{\"data\":[";
+            m_state = STATE_ENTRIES;
+        }
+        else if (STATE_ENTRIES == m_state)
+        {
+            File fd;
+
+            if (0U < m_count)
+            {
+                fd = m_fdRoot.openNextFile();
+
+                /* Page handling */
+                while((true == fd) && (0U < m_preCount))
+                {
+                    --m_preCount;
+                    fd.close();
+                    fd = m_fdRoot.openNextFile();
+                }
+            }
+
+            if (false == fd)
+            {
+                char tail[24];
+
+                (void)snprintf(tail, sizeof(tail), "],\"status\":%u}", static_cast<uint8_t>(RestApi::STATUS_CODE_OK));
+
+                m_part  = tail;
+                m_state = STATE_DONE;
+            }
+            else
+            {
+                StaticJsonDocument<JSON_ENTRY_SIZE> jsonDoc;
+                String                              entry;
+
+                jsonDoc["name"] = fd.name();
+                jsonDoc["size"] = fd.size();
+
+                if (true == fd.isDirectory())
+                {
+                    jsonDoc["type"] = "dir";
+                }
+                else
+                {
+                    jsonDoc["type"] = "file";
+                }
+
+                (void)serializeJson(jsonDoc, entry);
+                fd.close();
+
+                /* The entries are separated by comma. */
+                if (false == m_isFirst)
+                {
+                    m_part = ",";
+                }
+
+                m_part      += entry;
+                m_isFirst   = false;
+                --m_count;
+            }
+        }
+        else
+        {
+            isAvailable = false;
+        }
+
+        return isAvailable;
+    }
+};
+
+/**
+ * Part of a file, which is sent as response content of a range request.
+ * The file is read part by part, therefore the memory consumption doesn't
+ * depend on the size of the range.
+ */
+class FileRange
+{
+public:
+
+    /**
+     * Constructs the file range.
+     *
+     * @param[in] fd        File, which is already positioned at the begin of the range.
+     * @param[in] length    Range length in byte
+     */
+    FileRange(File& fd, size_t length) :
+        m_fd(fd),
+        m_length(length)
+    {
+    }
+
+    /**
+     * Destroys the file range.
+     */
+    ~FileRange()
+    {
+        m_fd.close();
+    }
+
+    /**
+     * Fill the response buffer with the next part of the range.
+     *
+     * @param[in] buffer    Response buffer
+     * @param[in] maxLen    Response buffer size in byte
+     *
+     * @return Number of written bytes. If 0, the range is complete.
+     */
+    size_t fill(uint8_t* buffer, size_t maxLen)
+    {
+        size_t len = m_length;
+
+        if (maxLen < len)
+        {
+            len = maxLen;
+        }
+
+        if (0U < len)
+        {
+            len = m_fd.read(buffer, len);
+            m_length -= len;
+        }
+
+        return len;
+    }
+
+private:
+
+    File    m_fd;       /**< File */
+    size_t  m_length;   /**< Number of bytes, which are still to send. */
+
+    FileRange(const FileRange& range);
+    FileRange& operator=(const FileRange& range);
+};
+
+/**
+ * File upload, which writes the received data with a write-behind buffer
+ * to the filesystem. The received data is collected until the next flash
+ * sector boundary of the file is reached. Therefore the filesystem is
+ * written in sector aligned parts, independent of the size of the received
+ * TCP segments.
+ *
+ * An upload can be continued at an offset. The offset must be equal to the
+ * current file size, which is the number of bytes received so far. If the
+ * connection breaks, the received data is written and the client continues
+ * the upload later from there.
+ *
+ * Only one upload at a time is supported.
+ */
+class FileUpload
+{
+public:
+
+    /**
+     * Constructs the file upload.
+     */
+    FileUpload() :
+        m_request(nullptr),
+        m_fd(),
+        m_buffer(nullptr),
+        m_bufferLen(0U),
+        m_size(0U),
+        m_httpStatusCode(HttpStatus::STATUS_CODE_OK),
+        m_errorMsg()
+    {
+    }
+
+    /**
+     * Destroys the file upload.
+     */
+    ~FileUpload()
+    {
+        abort();
+    }
+
+    /**
+     * Begin the upload of a file.
+     *
+     * @param[in] request   HTTP request, which owns the upload.
+     * @param[in] path      Path of the file
+     * @param[in] offset    Offset in byte, where the upload starts. If 0, the file will be overwritten.
+     */
+    void begin(AsyncWebServerRequest* request, const String& path, uint32_t offset)
+    {
+        abort();
+
+        m_request           = request;
+        m_bufferLen         = 0U;
+        m_size              = 0U;
+        m_httpStatusCode    = HttpStatus::STATUS_CODE_OK;
+        m_errorMsg          = "";
+
+        if (0U == offset)
+        {
+            m_fd = FILESYSTEM.open(path, "w");
+        }
+        else if (true == FILESYSTEM.exists(path))
+        {
+            m_fd = FILESYSTEM.open(path, "a");
+        }
+        else
+        {
+            ;
+        }
+
+        if (false == m_fd)
+        {
+            if (0U == offset)
+            {
+                setError(HttpStatus::STATUS_CODE_BAD_REQUEST, "Couldn't open file.");
+            }
+            else
+            {
+                setError(HttpStatus::STATUS_CODE_CONFLICT, "Offset doesn't match the file size.");
+            }
+        }
+        else
+        {
+            m_size = m_fd.size();
+
+            if (offset != m_size)
+            {
+                setError(HttpStatus::STATUS_CODE_CONFLICT, "Offset doesn't match the file size.");
+            }
+            else
+            {
+                m_buffer = new uint8_t[BUFFER_SIZE];
+
+                if (nullptr == m_buffer)
+                {
+                    setError(HttpStatus::STATUS_CODE_INTERNAL_SERVER_ERROR, "Out of memory.");
+                }
+                else
+                {
+                    LOG_INFO("Receiving file %s at offset %u.", path.c_str(), offset);
+                }
+            }
+        }
+
+        return;
+    }
+
+    /**
+     * Write the next part of the file.
+     *
+     * @param[in] data  Data
+     * @param[in] len   Data size in byte
+     */
+    void write(const uint8_t* data, size_t len)
+    {
+        while((0U < len) && (true == isInProgress()))
+        {
+            /* Collect the data until the next sector boundary of the file. */
+            size_t part = BUFFER_SIZE - ((m_size + m_bufferLen) % BUFFER_SIZE);
+
+            if (len < part)
+            {
+                part = len;
+            }
+
+            memcpy(&m_buffer[m_bufferLen], data, part);
+            m_bufferLen += part;
+            data        += part;
+            len         -= part;
+
+            if (0U == ((m_size + m_bufferLen) % BUFFER_SIZE))
+            {
+                flush();
+            }
+        }
+
+        return;
+    }
+
+    /**
+     * End the upload. The file is completely written.
+     */
+    void end()
+    {
+        if (true == isInProgress())
+        {
+            flush();
+        }
+
+        /* Still in progress, means no error happened. */
+        if (true == isInProgress())
+        {
+            LOG_INFO("File %s successful written.", m_fd.name());
+        }
+
+        close();
+
+        return;
+    }
+
+    /**
+     * Abort the upload. The data received so far is kept, therefore the
+     * upload can be continued later.
+     */
+    void abort()
+    {
+        if (true == isInProgress())
+        {
+            flush();
+            LOG_WARNING("File %s upload aborted at %u byte.", m_fd.name(), m_size);
+        }
+
+        close();
+        m_request = nullptr;
+
+        return;
+    }
+
+    /**
+     * Release the upload, after the result was sent to the client.
+     */
+    void release()
+    {
+        abort();
+
+        return;
+    }
+
+    /**
+     * Is the upload owned by the request?
+     *
+     * @param[in] request   HTTP request
+     *
+     * @return If the request owns the upload, it will return true otherwise false.
+     */
+    bool isOwner(const AsyncWebServerRequest* request) const
+    {
+        return (request == m_request);
+    }
+
+    /**
+     * Is a upload in progress?
+     *
+     * @return If a upload is in progress, it will return true otherwise false.
+     */
+    bool isInProgress() const
+    {
+        return (nullptr != m_buffer);
+    }
+
+    /**
+     * Get the number of bytes, which are written to the file.
+     *
+     * @return File size in byte
+     */
+    uint32_t getSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Get the HTTP status code of the upload result.
+     *
+     * @return HTTP status code
+     */
+    uint32_t getHttpStatusCode() const
+    {
+        return m_httpStatusCode;
+    }
+
+    /**
+     * Get the error message of the upload result.
+     *
+     * @return Error message. If empty, there was no error.
+     */
+    const String& getErrorMsg() const
+    {
+        return m_errorMsg;
+    }
+
+    /**
+     * Size of the write-behind buffer in byte. It corresponds to the
+     * flash sector size.
+     */
+    static const size_t BUFFER_SIZE = 4096U;
+
+private:
+
+    AsyncWebServerRequest*  m_request;          /**< HTTP request, which owns the upload. */
+    File                    m_fd;               /**< Upload file descriptor */
+    uint8_t*                m_buffer;           /**< Write-behind buffer */
+    size_t                  m_bufferLen;        /**< Number of bytes in the write-behind buffer */
+    uint32_t                m_size;             /**< Number of bytes, which are written to the file. */
+    uint32_t                m_httpStatusCode;   /**< HTTP status code of the upload result */
+    String                  m_errorMsg;         /**< Error message of the upload result */
+
+    FileUpload(const FileUpload& upload);
+    FileUpload& operator=(const FileUpload& upload);
+
+    /**
+     * Write the buffered data to the file.
+     */
+    void flush()
+    {
+        if (0U < m_bufferLen)
+        {
+            size_t len     = m_bufferLen;
+            size_t written = m_fd.write(m_buffer, len);
+
+            m_size      += written;
+            m_bufferLen = 0U;
+
+            if (len != written)
+            {
+                setError(HttpStatus::STATUS_CODE_INSUFFICIENT_STORAGE, "Couldn't write file.");
+            }
+        }
+
+        return;
+    }
+
+    /**
+     * Close the file and release the write-behind buffer.
+     */
+    void close()
+    {
+        if (true == m_fd)
+        {
+            m_fd.close();
+        }
+
+        if (nullptr != m_buffer)
+        {
+            delete[] m_buffer;
+            m_buffer = nullptr;
+        }
+
+        m_bufferLen = 0U;
+
+        return;
+    }
+
+    /**
+     * Set the upload result to an error. The upload is stopped, but the
+     * request keeps the ownership until the result is sent.
+     *
+     * @param[in] httpStatusCode    HTTP status code
+     * @param[in] msg               Error message
+     */
+    void setError(uint32_t httpStatusCode, const char* msg)
+    {
+        LOG_WARNING("File upload failed: %s", msg);
+
+        m_httpStatusCode    = httpStatusCode;
+        m_errorMsg          = msg;
+
+        close();
+
+        return;
+    }
+};
+
+/** Result of the range header parsing. */
+typedef enum
+{
+    RANGE_IGNORED = 0,      /**< Range is not supported or invalid, therefore the whole file is sent. */
+    RANGE_SATISFIABLE,      /**< Range is satisfiable. */
+    RANGE_NOT_SATISFIABLE   /**< Range is not satisfiable. */
+
+} RangeResult;
+
 /******************************************************************************
  * Prototypes
  *****************************************************************************/
@@ -70,6 +757,8 @@ static void handlePlugin(AsyncWebServerRequest* request);
 static void handleButton(AsyncWebServerRequest* request);
 static void handleFilesystem(AsyncWebServerRequest* request);
 static void handleFileGet(AsyncWebServerRequest* request);
+static RangeResult parseRange(const String& range, uint32_t fileSize, uint32_t& first, uint32_t& last);
+static void sendFileRange(AsyncWebServerRequest* request, const String& path, const String& range);
 static String getContentType(const String& filename);
 static void handleFilePost(AsyncWebServerRequest* request);
 static void uploadHandler(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final);
@@ -79,6 +768,9 @@ static void handleFileDelete(AsyncWebServerRequest* request);
  * Local Variables
  *****************************************************************************/
 
+/** File upload, which is currently received. */
+static FileUpload   gFileUpload;
+
 /******************************************************************************
  * Public Methods
  *****************************************************************************/
@@ -116,9 +808,8 @@ void RestApi::init(AsyncWebServer& srv)
  */
 void RestApi::error(AsyncWebServerRequest* request)
 {
-    String              content;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     JsonObject          errorObj        = jsonDoc.createNestedObject("error");
 
@@ -132,6 +823,25 @@ void RestApi::error(AsyncWebServerRequest* request)
     errorObj["msg"]     = "Invalid path requested.";
     httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
 
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
+
+    return;
+}
+
+void RestApi::sendJsonDoc(AsyncWebServerRequest* request, uint32_t httpStatusCode, const JsonDocument& jsonDoc)
+{
+    const char* CONTENT_TYPE    = "application/json";
+    const char* IF_NONE_MATCH   = "If-None-Match";
+    bool        isPretty        = false;
+    bool        isNotModified   = false;
+    size_t      length          = 0U;
+    String      etag;
+
+    if (nullptr == request)
+    {
+        return;
+    }
+
     if (true == jsonDoc.overflowed())
     {
         LOG_ERROR("JSON document has less memory available.");
@@ -141,8 +851,86 @@ void RestApi::error(AsyncWebServerRequest* request)
         LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
     }
 
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    isPretty = request->hasArg("pretty");
+
+    /* Only the successful GET response can be cached by the client. */
+    if ((HTTP_GET == request->method()) &&
+        (HttpStatus::STATUS_CODE_OK == httpStatusCode))
+    {
+        HashPrint   hashPrint;
+        char        etagBuffer[16];
+
+        /* The hash is calculated over the compact serialization, independent
+         * of the requested format. Therefore the ETag is weak.
+         */
+        (void)serializeJson(jsonDoc, hashPrint);
+        (void)snprintf(etagBuffer, sizeof(etagBuffer), "W/\"%08x\"", hashPrint.getHash());
+
+        etag    = etagBuffer;
+        length  = hashPrint.getLength();
+
+        if (true == request->hasHeader(IF_NONE_MATCH))
+        {
+            AsyncWebHeader* header = request->getHeader(IF_NONE_MATCH);
+
+            if ((nullptr != header) &&
+                (etag == header->value()))
+            {
+                isNotModified = true;
+            }
+        }
+    }
+    else
+    {
+        length = measureJson(jsonDoc);
+    }
+
+    if (true == isNotModified)
+    {
+        AsyncWebServerResponse* response = request->beginResponse(HttpStatus::STATUS_CODE_NOT_MODIFIED);
+
+        if (nullptr != response)
+        {
+            response->addHeader("ETag", etag);
+        }
+
+        request->send(response);
+    }
+    else
+    {
+        AsyncResponseStream* response = nullptr;
+
+        if (true == isPretty)
+        {
+            length = measureJsonPretty(jsonDoc);
+        }
+
+        /* Allocate the stream buffer with the exact content size,
+         * to avoid any reallocation during serialization.
+         */
+        response = request->beginResponseStream(CONTENT_TYPE, length);
+
+        if (nullptr != response)
+        {
+            response->setCode(httpStatusCode);
+
+            if (false == etag.isEmpty())
+            {
+                response->addHeader("ETag", etag);
+            }
+
+            if (true == isPretty)
+            {
+                (void)serializeJsonPretty(jsonDoc, *response);
+            }
+            else
+            {
+                (void)serializeJson(jsonDoc, *response);
+            }
+        }
+
+        request->send(response);
+    }
 
     return;
 }
@@ -159,10 +947,9 @@ void RestApi::error(AsyncWebServerRequest* request)
  */
 static void handleStatus(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -222,17 +1009,7 @@ static void handleStatus(AsyncWebServerRequest* request)
         httpStatusCode          = HttpStatus::STATUS_CODE_OK;
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
@@ -245,10 +1022,9 @@ static void handleStatus(AsyncWebServerRequest* request)
  */
 static void handleSlots(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 1024U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -295,17 +1071,7 @@ static void handleSlots(AsyncWebServerRequest* request)
         httpStatusCode      = HttpStatus::STATUS_CODE_OK;
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
@@ -320,9 +1086,8 @@ static void handleSlots(AsyncWebServerRequest* request)
  */
 static void handlePlugin(AsyncWebServerRequest* request)
 {
-    String              content;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
 
     if (nullptr == request)
@@ -496,17 +1261,7 @@ static void handlePlugin(AsyncWebServerRequest* request)
         httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
@@ -520,10 +1275,9 @@ static void handlePlugin(AsyncWebServerRequest* request)
  */
 static void handleButton(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -579,35 +1333,25 @@ static void handleButton(AsyncWebServerRequest* request)
         httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
 
 /**
  * List files of given directory (?dir=<path>).
- * 
+ * The files are listed in pages (?page=<page>) with a default of 15 files
+ * per page (?count=<number of files>).
+ *
+ * The listing is streamed as chunked response, one directory entry after
+ * another, therefore large directories don't need a large JSON document.
+ *
  * GET \c "/api/v1/fs"
  *
  * @param[in] request   HTTP request
  */
 static void handleFilesystem(AsyncWebServerRequest* request)
 {
-    String              content;
-    uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
-    const size_t        JSON_DOC_SIZE   = 2048U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
-
     if (nullptr == request)
     {
         return;
@@ -615,112 +1359,70 @@ static void handleFilesystem(AsyncWebServerRequest* request)
 
     if (HTTP_GET != request->method())
     {
-        JsonObject errorObj = jsonDoc.createNestedObject("error");
+        uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_NOT_FOUND;
+        const size_t        JSON_DOC_SIZE   = 512U;
+        PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+        JsonObject          errorObj        = jsonDoc.createNestedObject("error");
 
         /* Prepare response */
         jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
         errorObj["msg"]     = "HTTP method not supported.";
-        httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
+
+        RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
     }
     else
     {
-        const String&   path                = request->arg("dir");
-        const String&   pageStr             = request->arg("page");
-        File            fdRoot              = FILESYSTEM.open(path, "r");
-        JsonArray       jsonData            = jsonDoc.createNestedArray("data");
-        const uint32_t  DEFAULT_MAX_FILES   = 15U;
-        uint32_t        count               = DEFAULT_MAX_FILES;
-        uint32_t        page                = 0U;
-        uint32_t        preCount            = page * count;
+        const String&               path                = request->arg("dir");
+        const String&               pageStr             = request->arg("page");
+        const String&               countStr            = request->arg("count");
+        const uint32_t              DEFAULT_MAX_FILES   = 15U;
+        uint32_t                    count               = DEFAULT_MAX_FILES;
+        uint32_t                    page                = 0U;
+        std::shared_ptr<DirListing> listing;
+
+        if (false == countStr.isEmpty())
+        {
+            if (false == Util::strToUInt32(countStr, count))
+            {
+                count = DEFAULT_MAX_FILES;
+            }
+        }
 
         if (false == pageStr.isEmpty())
         {
-            if (true == Util::strToUInt32(pageStr, page))
+            if (false == Util::strToUInt32(pageStr, page))
             {
-                preCount = page * count;
+                page = 0U;
             }
         }
 
-        if (false == fdRoot)
+        listing.reset(new DirListing(path, page * count, count));
+
+        if (nullptr == listing)
         {
-            LOG_WARNING("Invalid path.");
+            request->send(HttpStatus::STATUS_CODE_INTERNAL_SERVER_ERROR);
         }
         else
         {
-            if (false == fdRoot.isDirectory())
-            {
-                LOG_WARNING("Requested path is not a directory.");
-            }
-            else
-            {
-                File fd = fdRoot.openNextFile();
-
-                while((true == fd) && (0U < count))
+            /* The listing is destroyed together with the response. */
+            AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+                [listing](uint8_t* buffer, size_t maxLen, size_t index) -> size_t
                 {
-                    /* Page handling */
-                    if (0U < preCount)
-                    {
-                        --preCount;
-                    }
-                    else
-                    {
-                        JsonObject jsonFile = jsonData.createNestedObject();
-
-                        jsonFile["name"] = String(fd.name());
-                        jsonFile["size"] = fd.size();
-
-                        if (true == fd.isDirectory())
-                        {
-                            jsonFile["type"] = "dir";
-                        }
-                        else
-                        {
-                            jsonFile["type"] = "file";
-                        }
-
-                        --count;
-                    }
-
-                    fd.close();
-
-                    if (0U < count)
-                    {
-                        fd = fdRoot.openNextFile();
-                    }
-                }
-            }
+                    UTIL_NOT_USED(index);
+                    return listing->fill(buffer, maxLen);
+                });
 
-            if (true == jsonDoc.overflowed())
-            {
-                LOG_WARNING("JSON document has less memory.");
-            }
-
-            fdRoot.close();
+            request->send(response);
         }
-
-        /* Prepare response */
-        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
-
-        httpStatusCode      = HttpStatus::STATUS_CODE_OK;
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
-
     return;
 }
 
 /**
  * Read file from filesystem (?path=<path>).
+ * A part of the file can be requested with the range header, e.g.
+ * "Range: bytes=1024-2047".
  * 
  * GET \c "/api/v1/fs/file"
  *
@@ -728,10 +1430,9 @@ static void handleFilesystem(AsyncWebServerRequest* request)
  */
 static void handleFileGet(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -747,17 +1448,7 @@ static void handleFileGet(AsyncWebServerRequest* request)
         errorObj["msg"]     = "HTTP method not supported.";
         httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
 
-        if (true == jsonDoc.overflowed())
-        {
-            LOG_ERROR("JSON document has less memory available.");
-        }
-        else
-        {
-            LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-        }
-
-        (void)serializeJsonPretty(jsonDoc, content);
-        request->send(httpStatusCode, "application/json", content);
+        RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
     }
     else
     {
@@ -774,21 +1465,224 @@ static void handleFileGet(AsyncWebServerRequest* request)
             errorObj["msg"]     = String("Invalid path ") + path;
             httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
 
-            if (true == jsonDoc.overflowed())
+            RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
+        }
+        else
+        {
+            AsyncWebHeader* header = request->getHeader("Range");
+
+            if (nullptr != header)
+            {
+                sendFileRange(request, path, header->value());
+            }
+            else
+            {
+                AsyncWebServerResponse* response = request->beginResponse(FILESYSTEM, path, getContentType(path));
+
+                if (nullptr != response)
+                {
+                    response->addHeader("Accept-Ranges", "bytes");
+                }
+
+                request->send(response);
+            }
+        }
+    }
+
+    return;
+}
+
+/**
+ * Parse the value of a range header. Only a single byte range is supported,
+ * e.g. "bytes=0-499", "bytes=500-" or the last 500 bytes "bytes=-500".
+ *
+ * @param[in]   range       Value of the range header
+ * @param[in]   fileSize    File size in byte
+ * @param[out]  first       Position of the first byte in the range
+ * @param[out]  last        Position of the last byte in the range
+ *
+ * @return Parsing result
+ */
+static RangeResult parseRange(const String& range, uint32_t fileSize, uint32_t& first, uint32_t& last)
+{
+    const char*     UNIT        = "bytes=";
+    RangeResult     result      = RANGE_IGNORED;
+    int             sepIdx      = range.indexOf('-');
+
+    /* Multiple ranges are not supported, in this case the whole file is sent. */
+    if ((true == range.startsWith(UNIT)) &&
+        (0 > range.indexOf(',')) &&
+        (0 <= sepIdx))
+    {
+        String      firstStr    = range.substring(strlen(UNIT), sepIdx);
+        String      lastStr     = range.substring(sepIdx + 1);
+        uint32_t    firstValue  = 0U;
+        uint32_t    lastValue   = 0U;
+
+        firstStr.trim();
+        lastStr.trim();
+
+        /* Suffix range, which contains the last bytes? */
+        if (true == firstStr.isEmpty())
+        {
+            if (true == Util::strToUInt32(lastStr, lastValue))
+            {
+                if ((0U == lastValue) ||
+                    (0U == fileSize))
+                {
+                    result = RANGE_NOT_SATISFIABLE;
+                }
+                else
+                {
+                    if (fileSize < lastValue)
+                    {
+                        lastValue = fileSize;
+                    }
+
+                    first   = fileSize - lastValue;
+                    last    = fileSize - 1U;
+                    result  = RANGE_SATISFIABLE;
+                }
+            }
+        }
+        else if (true == Util::strToUInt32(firstStr, firstValue))
+        {
+            bool isValid = true;
+
+            /* Without last position, the range ends with the file. */
+            if (true == lastStr.isEmpty())
+            {
+                lastValue = UINT32_MAX;
+            }
+            else
+            {
+                isValid = Util::strToUInt32(lastStr, lastValue);
+            }
+
+            /* A invalid range is ignored. */
+            if ((false == isValid) ||
+                (firstValue > lastValue))
+            {
+                ;
+            }
+            else if (fileSize <= firstValue)
             {
-                LOG_ERROR("JSON document has less memory available.");
+                result = RANGE_NOT_SATISFIABLE;
             }
             else
             {
-                LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
+                if (fileSize <= lastValue)
+                {
+                    lastValue = fileSize - 1U;
+                }
+
+                first   = firstValue;
+                last    = lastValue;
+                result  = RANGE_SATISFIABLE;
             }
+        }
+        else
+        {
+            ;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Send a part of a file, requested by the range header.
+ * If the range is not supported, the whole file will be sent.
+ *
+ * @param[in] request   HTTP request
+ * @param[in] path      Path of the file
+ * @param[in] range     Value of the range header
+ */
+static void sendFileRange(AsyncWebServerRequest* request, const String& path, const String& range)
+{
+    File        fd          = FILESYSTEM.open(path, "r");
+    uint32_t    fileSize    = 0U;
+    uint32_t    first       = 0U;
+    uint32_t    last        = 0U;
+    RangeResult result      = RANGE_IGNORED;
+    char        contentRange[40];
+
+    if (false == fd)
+    {
+        request->send(HttpStatus::STATUS_CODE_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    fileSize    = fd.size();
+    result      = parseRange(range, fileSize, first, last);
+
+    if (RANGE_IGNORED == result)
+    {
+        AsyncWebServerResponse* response = nullptr;
+
+        fd.close();
+
+        response = request->beginResponse(FILESYSTEM, path, getContentType(path));
+
+        if (nullptr != response)
+        {
+            response->addHeader("Accept-Ranges", "bytes");
+        }
+
+        request->send(response);
+    }
+    else if (RANGE_NOT_SATISFIABLE == result)
+    {
+        AsyncWebServerResponse* response = request->beginResponse(HttpStatus::STATUS_CODE_RANGE_NOT_SATISFIABLE);
 
-            (void)serializeJsonPretty(jsonDoc, content);
-            request->send(httpStatusCode, "application/json", content);
+        fd.close();
+
+        if (nullptr != response)
+        {
+            (void)snprintf(contentRange, sizeof(contentRange), "bytes */%u", fileSize);
+            response->addHeader("Content-Range", contentRange);
+        }
+
+        request->send(response);
+    }
+    else if (false == fd.seek(first))
+    {
+        fd.close();
+        request->send(HttpStatus::STATUS_CODE_INTERNAL_SERVER_ERROR);
+    }
+    else
+    {
+        size_t                      length      = last - first + 1U;
+        std::shared_ptr<FileRange>  fileRange;
+
+        LOG_INFO("File range %u-%u of %u byte requested.", first, last, fileSize);
+
+        fileRange.reset(new FileRange(fd, length));
+
+        if (nullptr == fileRange)
+        {
+            fd.close();
+            request->send(HttpStatus::STATUS_CODE_INTERNAL_SERVER_ERROR);
         }
         else
         {
-            request->send(FILESYSTEM, path, getContentType(path));
+            /* The file range is destroyed together with the response. */
+            AsyncWebServerResponse* response = request->beginResponse(getContentType(path), length,
+                [fileRange](uint8_t* buffer, size_t maxLen, size_t index) -> size_t
+                {
+                    UTIL_NOT_USED(index);
+                    return fileRange->fill(buffer, maxLen);
+                });
+
+            if (nullptr != response)
+            {
+                (void)snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u", first, last, fileSize);
+                response->setCode(HttpStatus::STATUS_CODE_PARTIAL_CONTENT);
+                response->addHeader("Content-Range", contentRange);
+                response->addHeader("Accept-Ranges", "bytes");
+            }
+
+            request->send(response);
         }
     }
 
@@ -863,10 +1757,9 @@ static String getContentType(const String& filename)
  */
 static void handleFilePost(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -882,35 +1775,59 @@ static void handleFilePost(AsyncWebServerRequest* request)
         errorObj["msg"]     = "HTTP method not supported.";
         httpStatusCode      = HttpStatus::STATUS_CODE_NOT_FOUND;
     }
-    else
+    else if (false == gFileUpload.isOwner(request))
     {
-        JsonObject dataObj = jsonDoc.createNestedObject("data");
-
-        UTIL_NOT_USED(dataObj);
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
 
         /* Prepare response */
-        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
 
-        httpStatusCode      = HttpStatus::STATUS_CODE_OK;
+        if (true == gFileUpload.isInProgress())
+        {
+            errorObj["msg"] = "Another upload is in progress.";
+            httpStatusCode  = HttpStatus::STATUS_CODE_CONFLICT;
+        }
+        else
+        {
+            errorObj["msg"] = "File is missing.";
+            httpStatusCode  = HttpStatus::STATUS_CODE_BAD_REQUEST;
+        }
     }
-
-    if (true == jsonDoc.overflowed())
+    else if (false == gFileUpload.getErrorMsg().isEmpty())
     {
-        LOG_ERROR("JSON document has less memory available.");
+        JsonObject errorObj = jsonDoc.createNestedObject("error");
+
+        /* Prepare response */
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_NOT_FOUND);
+        errorObj["msg"]     = gFileUpload.getErrorMsg();
+        errorObj["size"]    = gFileUpload.getSize();
+        httpStatusCode      = gFileUpload.getHttpStatusCode();
+
+        gFileUpload.release();
     }
     else
     {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
+        JsonObject dataObj = jsonDoc.createNestedObject("data");
+
+        /* Prepare response */
+        dataObj["size"]     = gFileUpload.getSize();
+        jsonDoc["status"]   = static_cast<uint8_t>(RestApi::STATUS_CODE_OK);
+
+        httpStatusCode      = HttpStatus::STATUS_CODE_OK;
+
+        gFileUpload.release();
     }
 
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
 
 /**
  * File upload handler.
+ * A interrupted upload is continued with the offset (?offset=<offset>),
+ * which is the number of bytes received so far. It corresponds to the
+ * current file size.
  *
  * @param[in] request   HTTP request.
  * @param[in] filename  Name of the uploaded file.
@@ -921,47 +1838,50 @@ static void handleFilePost(AsyncWebServerRequest* request)
  */
 static void uploadHandler(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final)
 {
-    static File fd;
-    bool        isError = false;
-
     /* Begin of upload? */
     if (0 == index)
     {
-        fd = FILESYSTEM.open(filename, "w");
-
-        if (false == fd)
+        /* Only one upload at a time is supported. */
+        if (true == gFileUpload.isInProgress())
         {
-            isError = true;
+            LOG_WARNING("File %s rejected, because another upload is in progress.", filename.c_str());
         }
         else
         {
-            LOG_INFO("Receiving file %s.", filename.c_str());
-        }
-    }
-
-    if (true == fd)
-    {
-        (void)fd.write(data, len);
-    }
+            const String&   offsetStr   = request->arg("offset");
+            uint32_t        offset      = 0U;
 
-    if ((true == final) &&
-        (false == isError))
-    {        
-        LOG_INFO("File %s successful written.", filename.c_str());
+            if (false == offsetStr.isEmpty())
+            {
+                if (false == Util::strToUInt32(offsetStr, offset))
+                {
+                    /* Invalid offset, which never matches a file size. */
+                    offset = UINT32_MAX;
+                }
+            }
 
-        fd.close();
-    }
-    else if (true == isError)
-    {
-        LOG_INFO("File %s upload aborted.", filename.c_str());
+            gFileUpload.begin(request, filename, offset);
 
-        fd.close();
+            /* If the connection breaks, the data received so far is kept. */
+            request->onDisconnect(
+                [request]()
+                {
+                    if (true == gFileUpload.isOwner(request))
+                    {
+                        gFileUpload.abort();
+                    }
+                });
+        }
     }
 
-    if (true == isError)
+    if (true == gFileUpload.isOwner(request))
     {
-        /* Inform client about abort.*/
-        request->send(HttpStatus::STATUS_CODE_BAD_REQUEST, "text/plain", "Upload aborted.");
+        gFileUpload.write(data, len);
+
+        if (true == final)
+        {
+            gFileUpload.end();
+        }
     }
 
     return;
@@ -976,10 +1896,9 @@ static void uploadHandler(AsyncWebServerRequest *request, const String& filename
  */
 static void handleFileDelete(AsyncWebServerRequest* request)
 {
-    String              content;
     uint32_t            httpStatusCode  = HttpStatus::STATUS_CODE_OK;
     const size_t        JSON_DOC_SIZE   = 512U;
-    DynamicJsonDocument jsonDoc(JSON_DOC_SIZE);
+    PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
 
     if (nullptr == request)
     {
@@ -1023,17 +1942,7 @@ static void handleFileDelete(AsyncWebServerRequest* request)
         }
     }
 
-    if (true == jsonDoc.overflowed())
-    {
-        LOG_ERROR("JSON document has less memory available.");
-    }
-    else
-    {
-        LOG_INFO("JSON document size: %u", jsonDoc.memoryUsage());
-    }
-
-    (void)serializeJsonPretty(jsonDoc, content);
-    request->send(httpStatusCode, "application/json", content);
+    RestApi::sendJsonDoc(request, httpStatusCode, jsonDoc);
 
     return;
 }
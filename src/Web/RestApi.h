@@ -44,6 +44,7 @@
  * Includes
  *****************************************************************************/
 #include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
 #include <stdint.h>
 
 /** REST pages installer */
@@ -91,6 +92,23 @@ void init(AsyncWebServer& srv);
  */
 void error(AsyncWebServerRequest* request);
 
+/**
+ * Send a JSON document as response.
+ *
+ * The document is serialized compact, unless the request contains the
+ * "pretty" argument. It is serialized directly into the response stream,
+ * which is allocated with the exact content size.
+ *
+ * A successful GET response gets a weak ETag, derived from the content. If
+ * the client requests it with the same ETag in If-None-Match, only
+ * 304 (Not Modified) without content is sent.
+ *
+ * @param[in] request           HTTP request
+ * @param[in] httpStatusCode    HTTP status code
+ * @param[in] jsonDoc           JSON document, which to send.
+ */
+void sendJsonDoc(AsyncWebServerRequest* request, uint32_t httpStatusCode, const JsonDocument& jsonDoc);
+
 }
 
 #endif  /* __RESTAPI_H__ */
@@ -0,0 +1,490 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS client
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "TlsClient.h"
+#include "TlsContextPool.h"
+#include "TlsSessionCache.h"
+
+#include <Logging.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+TlsClient::TlsClient() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_ssl(nullptr),
+    m_state(STATE_IDLE),
+    m_hostname(),
+    m_port(0U),
+    m_sendFunc(nullptr),
+    m_sendArg(nullptr),
+    m_rxData(nullptr),
+    m_rxSize(0U),
+    m_rxIndex(0U),
+    m_isInsecure(false),
+    m_isTxPending(false),
+    m_isResumed(false),
+    m_handshakeStart(0U),
+    m_handshakeDuration(0U),
+    m_readBuffer()
+{
+}
+
+TlsClient::~TlsClient()
+{
+    end();
+
+    if (nullptr != m_xMutex)
+    {
+        vSemaphoreDelete(m_xMutex);
+        m_xMutex = nullptr;
+    }
+}
+
+bool TlsClient::begin(const String& hostname, uint16_t port, SendFunc sendFunc, void* arg, bool isInsecure)
+{
+    bool isSuccessful = false;
+
+    if (nullptr == sendFunc)
+    {
+        return false;
+    }
+
+    lock();
+
+    /* A previous connection may be still open. */
+    end();
+
+    m_ssl = TlsContextPool::getInstance().acquire(isInsecure);
+
+    if (nullptr != m_ssl)
+    {
+        int ret = mbedtls_ssl_set_hostname(m_ssl, hostname.c_str());
+
+        if (0 != ret)
+        {
+            LOG_ERROR("TLS hostname %s invalid: -0x%04X", hostname.c_str(), -ret);
+            end();
+        }
+        else
+        {
+            mbedtls_ssl_set_bio(m_ssl, this, bioSend, bioReceive, nullptr);
+
+            m_hostname          = hostname;
+            m_port              = port;
+            m_sendFunc          = sendFunc;
+            m_sendArg           = arg;
+            m_isInsecure        = isInsecure;
+            m_isTxPending       = false;
+            m_isResumed         = false;
+            m_handshakeStart    = millis();
+            m_handshakeDuration = 0U;
+            m_state             = STATE_HANDSHAKE;
+
+            /* The session of a not verified server is not cached, otherwise
+             * a verifying client could resume it without verification.
+             */
+            if (false == m_isInsecure)
+            {
+                (void)TlsSessionCache::getInstance().load(m_hostname, m_port, m_ssl);
+            }
+            else
+            {
+                LOG_WARNING("TLS server certificate of %s:%u is not verified.", m_hostname.c_str(), m_port);
+            }
+
+            /* Send the client hello. */
+            handshake();
+
+            isSuccessful = (STATE_HANDSHAKE == m_state);
+        }
+    }
+
+    unlock();
+
+    return isSuccessful;
+}
+
+void TlsClient::end()
+{
+    lock();
+
+    if (nullptr != m_ssl)
+    {
+        /* Notify the server, otherwise it may not resume the session later. */
+        if (STATE_CONNECTED == m_state)
+        {
+            (void)mbedtls_ssl_close_notify(m_ssl);
+        }
+
+        TlsContextPool::getInstance().release(m_ssl);
+        m_ssl = nullptr;
+    }
+
+    m_state         = STATE_IDLE;
+    m_sendFunc      = nullptr;
+    m_sendArg       = nullptr;
+    m_isTxPending   = false;
+
+    unlock();
+
+    return;
+}
+
+bool TlsClient::receive(const uint8_t* data, size_t size, ReceiveFunc receiveFunc, void* arg)
+{
+    bool isPending = true;
+    bool isUsable  = false;
+
+    lock();
+
+    m_rxData    = data;
+    m_rxSize    = (nullptr == data) ? 0U : size;
+    m_rxIndex   = 0U;
+
+    if (STATE_HANDSHAKE == m_state)
+    {
+        handshake();
+    }
+
+    unlock();
+
+    /* The decrypted data is provided without lock, because the receiver
+     * may write a response or end the connection.
+     */
+    while(true == isPending)
+    {
+        int ret = 0;
+
+        lock();
+
+        if (STATE_CONNECTED != m_state)
+        {
+            isPending = false;
+        }
+        else
+        {
+            ret = mbedtls_ssl_read(m_ssl, m_readBuffer, sizeof(m_readBuffer));
+
+            /* Positive values are the size of the decrypted data, which is provided below. */
+            if ((MBEDTLS_ERR_SSL_WANT_READ == ret) ||
+                (MBEDTLS_ERR_SSL_WANT_WRITE == ret))
+            {
+                isPending = false;
+            }
+            else if ((0 == ret) ||
+                     (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret))
+            {
+                m_state     = STATE_CLOSED;
+                isPending   = false;
+            }
+            else if (0 > ret)
+            {
+                LOG_ERROR("TLS read from %s:%u failed: -0x%04X", m_hostname.c_str(), m_port, -ret);
+                m_state     = STATE_ERROR;
+                isPending   = false;
+            }
+        }
+
+        unlock();
+
+        if ((0 < ret) &&
+            (nullptr != receiveFunc))
+        {
+            receiveFunc(arg, m_readBuffer, static_cast<size_t>(ret));
+        }
+    }
+
+    lock();
+
+    m_rxData    = nullptr;
+    m_rxSize    = 0U;
+    m_rxIndex   = 0U;
+    isUsable    = (STATE_CLOSED != m_state) && (STATE_ERROR != m_state);
+
+    unlock();
+
+    return isUsable;
+}
+
+size_t TlsClient::write(const uint8_t* data, size_t size)
+{
+    size_t index = 0U;
+
+    if (nullptr == data)
+    {
+        return 0U;
+    }
+
+    lock();
+
+    /* The pending record must be sent first, to keep the order. */
+    if ((STATE_CONNECTED == m_state) &&
+        (true == m_isTxPending))
+    {
+        flushRecord();
+    }
+
+    while((STATE_CONNECTED == m_state) && (false == m_isTxPending) && (size > index))
+    {
+        size_t  len     = size - index;
+        int     maxLen  = mbedtls_ssl_get_max_out_record_payload(m_ssl);
+        int     ret     = 0;
+
+        /* Determine the part, which fits into one record. */
+        if ((0 < maxLen) &&
+            (static_cast<size_t>(maxLen) < len))
+        {
+            len = static_cast<size_t>(maxLen);
+        }
+
+        ret = mbedtls_ssl_write(m_ssl, &data[index], len);
+
+        if (0 < ret)
+        {
+            index += static_cast<size_t>(ret);
+        }
+        /* The record is already encrypted and kept in the TLS context,
+         * until the transport has space again. Therefore the data is sent.
+         */
+        else if (MBEDTLS_ERR_SSL_WANT_WRITE == ret)
+        {
+            index          += len;
+            m_isTxPending   = true;
+        }
+        else
+        {
+            LOG_ERROR("TLS write to %s:%u failed: -0x%04X", m_hostname.c_str(), m_port, -ret);
+            m_state = STATE_ERROR;
+        }
+    }
+
+    unlock();
+
+    return index;
+}
+
+bool TlsClient::flush()
+{
+    bool isUsable = false;
+
+    lock();
+
+    if (STATE_HANDSHAKE == m_state)
+    {
+        handshake();
+    }
+    else if ((STATE_CONNECTED == m_state) &&
+             (true == m_isTxPending))
+    {
+        flushRecord();
+    }
+    else
+    {
+        ;
+    }
+
+    isUsable = (STATE_CLOSED != m_state) && (STATE_ERROR != m_state);
+
+    unlock();
+
+    return isUsable;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+void TlsClient::handshake()
+{
+    int ret = mbedtls_ssl_handshake(m_ssl);
+
+    if (0 == ret)
+    {
+        m_handshakeDuration = millis() - m_handshakeStart;
+        m_isResumed         = (false == m_isInsecure) && (true == TlsSessionCache::getInstance().store(m_hostname, m_port, m_ssl));
+        m_state             = STATE_CONNECTED;
+
+        LOG_INFO("TLS handshake with %s:%u %s in %u ms.",
+            m_hostname.c_str(),
+            m_port,
+            (true == m_isResumed) ? "resumed" : "done",
+            m_handshakeDuration);
+    }
+    /* Otherwise the handshake waits for more data from the server. */
+    else if ((MBEDTLS_ERR_SSL_WANT_READ != ret) &&
+             (MBEDTLS_ERR_SSL_WANT_WRITE != ret))
+    {
+        LOG_ERROR("TLS handshake with %s:%u failed: -0x%04X", m_hostname.c_str(), m_port, -ret);
+
+        /* The server may not accept the cached session anymore. */
+        TlsSessionCache::getInstance().remove(m_hostname, m_port);
+        m_state = STATE_ERROR;
+    }
+
+    return;
+}
+
+void TlsClient::flushRecord()
+{
+    /* A pending record is sent by repeating the write. The data is not
+     * read again, because it is already encrypted in the TLS context.
+     * Therefore no data is given, which avoids a further record.
+     */
+    int ret = mbedtls_ssl_write(m_ssl, m_readBuffer, 0U);
+
+    if (0 <= ret)
+    {
+        m_isTxPending = false;
+    }
+    else if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+    {
+        LOG_ERROR("TLS write to %s:%u failed: -0x%04X", m_hostname.c_str(), m_port, -ret);
+        m_state = STATE_ERROR;
+    }
+    else
+    {
+        ;
+    }
+
+    return;
+}
+
+int TlsClient::bioSend(void* ctx, const unsigned char* buf, size_t len)
+{
+    int         ret     = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    TlsClient*  client  = static_cast<TlsClient*>(ctx);
+
+    if ((nullptr != client) &&
+        (nullptr != client->m_sendFunc))
+    {
+        size_t written = client->m_sendFunc(client->m_sendArg, buf, len);
+
+        if (0U == written)
+        {
+            ret = MBEDTLS_ERR_SSL_WANT_WRITE;
+        }
+        else
+        {
+            ret = static_cast<int>(written);
+        }
+    }
+
+    return ret;
+}
+
+int TlsClient::bioReceive(void* ctx, unsigned char* buf, size_t len)
+{
+    int         ret     = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    TlsClient*  client  = static_cast<TlsClient*>(ctx);
+
+    if (nullptr != client)
+    {
+        size_t available = client->m_rxSize - client->m_rxIndex;
+
+        /* Everything fed in is consumed, wait for the next part. */
+        if (0U == available)
+        {
+            ret = MBEDTLS_ERR_SSL_WANT_READ;
+        }
+        else
+        {
+            if (len > available)
+            {
+                len = available;
+            }
+
+            memcpy(buf, &client->m_rxData[client->m_rxIndex], len);
+            client->m_rxIndex += len;
+
+            ret = static_cast<int>(len);
+        }
+    }
+
+    return ret;
+}
+
+void TlsClient::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void TlsClient::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
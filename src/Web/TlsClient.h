@@ -0,0 +1,276 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS client
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __TLS_CLIENT_H__
+#define __TLS_CLIENT_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>
+#include <mbedtls/ssl.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The TLS client secures a established connection, independent of the
+ * transport. The encrypted records are sent with the send function, the
+ * received ones are fed in and the decrypted data is provided via the
+ * receive function. Nothing blocks, the handshake proceeds with every
+ * received part.
+ *
+ * The TLS context is taken from the TLS context pool for the lifetime of
+ * the secured connection. The session of the server is taken from the
+ * TLS session cache, so that the handshake is abbreviated if the server
+ * resumes it.
+ *
+ * If the transport has no space for a encrypted record, the record is kept
+ * in the TLS context and sent by flush(), after the transport has space
+ * again.
+ */
+class TlsClient
+{
+public:
+
+    /**
+     * Send function, which sends encrypted data to the server.
+     *
+     * @param[in] arg   Argument
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    typedef size_t (*SendFunc)(void* arg, const uint8_t* data, size_t size);
+
+    /**
+     * Receive function, which gets decrypted data from the server.
+     *
+     * @param[in] arg   Argument
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     */
+    typedef void (*ReceiveFunc)(void* arg, const uint8_t* data, size_t size);
+
+    /** Connection state */
+    enum State
+    {
+        STATE_IDLE = 0,     /**< Not started */
+        STATE_HANDSHAKE,    /**< Handshake in progress */
+        STATE_CONNECTED,    /**< Secured, data can be exchanged. */
+        STATE_CLOSED,       /**< Closed by the server */
+        STATE_ERROR         /**< Failed */
+    };
+
+    /**
+     * Constructs the TLS client.
+     */
+    TlsClient();
+
+    /**
+     * Destroys the TLS client.
+     */
+    ~TlsClient();
+
+    /**
+     * Start the handshake with the server. The transport must be already
+     * connected.
+     *
+     * @param[in] hostname      Server hostname, used for the certificate verification and the session cache.
+     * @param[in] port          Server port, used for the session cache.
+     * @param[in] sendFunc      Send function
+     * @param[in] arg           Argument of the send function
+     * @param[in] isInsecure    Skip the verification of the server certificate?
+     *
+     * @return If successful started, it will return true otherwise false.
+     */
+    bool begin(const String& hostname, uint16_t port, SendFunc sendFunc, void* arg, bool isInsecure = false);
+
+    /**
+     * Stop and release the TLS context. It can be called any time.
+     */
+    void end();
+
+    /**
+     * Feed received encrypted data in. During the handshake it continues the
+     * handshake, afterwards it provides the decrypted data.
+     *
+     * @param[in] data          Data
+     * @param[in] size          Data size in byte
+     * @param[in] receiveFunc   Receive function for the decrypted data
+     * @param[in] arg           Argument of the receive function
+     *
+     * @return If the connection is still usable, it will return true otherwise false.
+     */
+    bool receive(const uint8_t* data, size_t size, ReceiveFunc receiveFunc, void* arg);
+
+    /**
+     * Encrypt and send data. If the transport has no space, one encrypted
+     * record is kept pending and the data is considered as sent. Further
+     * data is not accepted until the pending record is flushed.
+     *
+     * @param[in] data  Data
+     * @param[in] size  Data size in byte
+     *
+     * @return Number of sent bytes
+     */
+    size_t write(const uint8_t* data, size_t size);
+
+    /**
+     * Send the pending handshake message or the pending record. Call it
+     * after the transport has space again, e.g. after sent data was
+     * acknowledged by the server.
+     *
+     * @return If the connection is still usable, it will return true otherwise false.
+     */
+    bool flush();
+
+    /**
+     * Get connection state.
+     *
+     * @return Connection state
+     */
+    State getState() const
+    {
+        return m_state;
+    }
+
+    /**
+     * Was the session of the last handshake resumed?
+     *
+     * @return If resumed, it will return true otherwise false.
+     */
+    bool isResumed() const
+    {
+        return m_isResumed;
+    }
+
+    /**
+     * Get the duration of the last handshake.
+     *
+     * @return Duration in ms
+     */
+    uint32_t getHandshakeDuration() const
+    {
+        return m_handshakeDuration;
+    }
+
+    /** Size in byte of the buffer for decrypted data. */
+    static const size_t READ_BUFFER_SIZE = 512U;
+
+private:
+
+    SemaphoreHandle_t       m_xMutex;                       /**< Mutex to protect the TLS context. */
+    mbedtls_ssl_context*    m_ssl;                          /**< TLS context, provided by the context pool */
+    State                   m_state;                        /**< Connection state */
+    String                  m_hostname;                     /**< Server hostname */
+    uint16_t                m_port;                         /**< Server port */
+    SendFunc                m_sendFunc;                     /**< Send function */
+    void*                   m_sendArg;                      /**< Argument of the send function */
+    const uint8_t*          m_rxData;                       /**< Received data, which is fed in. */
+    size_t                  m_rxSize;                       /**< Received data size in byte */
+    size_t                  m_rxIndex;                      /**< Index of the next received byte, which to process. */
+    bool                    m_isInsecure;                   /**< Is the verification of the server certificate skipped? */
+    bool                    m_isTxPending;                  /**< Is a encrypted record pending, because the transport had no space? */
+    bool                    m_isResumed;                    /**< Was the session resumed? */
+    uint32_t                m_handshakeStart;               /**< Timestamp in ms of the handshake start */
+    uint32_t                m_handshakeDuration;            /**< Duration in ms of the last handshake */
+    uint8_t                 m_readBuffer[READ_BUFFER_SIZE]; /**< Buffer for decrypted data */
+
+    TlsClient(const TlsClient& client);
+    TlsClient& operator=(const TlsClient& client);
+
+    /**
+     * Continue the handshake.
+     */
+    void handshake();
+
+    /**
+     * Send the pending record.
+     */
+    void flushRecord();
+
+    /**
+     * Send function of the TLS context.
+     *
+     * @param[in] ctx   TLS client
+     * @param[in] buf   Data
+     * @param[in] len   Data size in byte
+     *
+     * @return Number of sent bytes or error code
+     */
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+
+    /**
+     * Receive function of the TLS context.
+     *
+     * @param[in] ctx   TLS client
+     * @param[in] buf   Buffer
+     * @param[in] len   Buffer size in byte
+     *
+     * @return Number of received bytes or error code
+     */
+    static int bioReceive(void* ctx, unsigned char* buf, size_t len);
+
+    /**
+     * Lock the TLS context.
+     */
+    void lock();
+
+    /**
+     * Unlock the TLS context.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __TLS_CLIENT_H__ */
+
+/** @} */
@@ -0,0 +1,368 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS context pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "TlsContextPool.h"
+#include "CaCertificates.h"
+
+#include <Logging.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/** Personalization string of the random number generator. */
+static const char   RNG_PERSONALIZATION[]   = "pixelix-tls";
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool TlsContextPool::setCaCertificates(const char* pem)
+{
+    bool isSuccessful = false;
+
+    if (nullptr == pem)
+    {
+        return false;
+    }
+
+    lock();
+
+    mbedtls_x509_crt_free(&m_caChain);
+    mbedtls_x509_crt_init(&m_caChain);
+
+    /* The length must include the string termination for PEM. */
+    if (0 != mbedtls_x509_crt_parse(&m_caChain, reinterpret_cast<const unsigned char*>(pem), strlen(pem) + 1U))
+    {
+        LOG_ERROR("Invalid CA certificates.");
+
+        mbedtls_x509_crt_free(&m_caChain);
+        mbedtls_x509_crt_init(&m_caChain);
+        m_isCaAvailable = false;
+    }
+    else
+    {
+        m_isCaAvailable = true;
+        isSuccessful    = true;
+    }
+
+    if (true == m_isConfigured)
+    {
+        mbedtls_ssl_conf_ca_chain(&m_config, &m_caChain, nullptr);
+    }
+
+    unlock();
+
+    return isSuccessful;
+}
+
+mbedtls_ssl_context* TlsContextPool::acquire(bool isInsecure)
+{
+    Context*    context         = nullptr;
+    uint8_t     index           = 0U;
+    bool        isSetupFailed   = false;
+
+    lock();
+
+    if ((false == m_isConfigured) &&
+        (true == configure()))
+    {
+        m_isConfigured = true;
+    }
+
+    if (true == m_isConfigured)
+    {
+        /* Prefer a context, which buffers are already allocated. */
+        for(index = 0U; (index < MAX_CONTEXTS) && (nullptr == context); ++index)
+        {
+            Context& candidate = m_contexts[index];
+
+            if ((false == candidate.isInUse) &&
+                (true == candidate.isSetup) &&
+                (isInsecure == candidate.isInsecure))
+            {
+                context = &candidate;
+            }
+        }
+
+        /* If the setup fails because of missing heap, no need to try the other ones. */
+        for(index = 0U; (index < MAX_CONTEXTS) && (nullptr == context) && (false == isSetupFailed); ++index)
+        {
+            Context& candidate = m_contexts[index];
+
+            if (false == candidate.isInUse)
+            {
+                int ret = 0;
+
+                /* A context, which is setup with the other configuration, is setup again. */
+                if (true == candidate.isSetup)
+                {
+                    mbedtls_ssl_free(&candidate.ssl);
+                    candidate.isSetup = false;
+                }
+
+                mbedtls_ssl_init(&candidate.ssl);
+                ret = mbedtls_ssl_setup(&candidate.ssl, (true == isInsecure) ? &m_insecureConfig : &m_config);
+
+                if (0 != ret)
+                {
+                    LOG_ERROR("TLS context setup failed: -0x%04X", -ret);
+                    mbedtls_ssl_free(&candidate.ssl);
+                    isSetupFailed = true;
+                }
+                else
+                {
+                    candidate.isSetup       = true;
+                    candidate.isInsecure    = isInsecure;
+                    context                 = &candidate;
+                }
+            }
+        }
+    }
+
+    if (nullptr == context)
+    {
+        LOG_WARNING("No free TLS context.");
+    }
+    else
+    {
+        context->isInUse = true;
+    }
+
+    unlock();
+
+    return (nullptr == context) ? nullptr : &context->ssl;
+}
+
+void TlsContextPool::release(mbedtls_ssl_context* ssl)
+{
+    uint8_t index       = 0U;
+    bool    isIdleSetup = false;
+
+    if (nullptr == ssl)
+    {
+        return;
+    }
+
+    lock();
+
+    /* Is there already a released context with allocated buffers? */
+    for(index = 0U; index < MAX_CONTEXTS; ++index)
+    {
+        Context& context = m_contexts[index];
+
+        if ((false == context.isInUse) &&
+            (true == context.isSetup))
+        {
+            isIdleSetup = true;
+        }
+    }
+
+    for(index = 0U; index < MAX_CONTEXTS; ++index)
+    {
+        Context& context = m_contexts[index];
+
+        if ((true == context.isInUse) &&
+            (ssl == &context.ssl))
+        {
+            context.isInUse = false;
+
+            /* Keep the buffers of only one released context. */
+            if ((true == isIdleSetup) ||
+                (0 != mbedtls_ssl_session_reset(ssl)))
+            {
+                mbedtls_ssl_free(ssl);
+                context.isSetup = false;
+            }
+        }
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+TlsContextPool::TlsContextPool() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_isConfigured(false),
+    m_isCaAvailable(false),
+    m_entropy(),
+    m_ctrDrbg(),
+    m_caChain(),
+    m_config(),
+    m_insecureConfig(),
+    m_contexts()
+{
+    uint8_t index = 0U;
+
+    mbedtls_x509_crt_init(&m_caChain);
+
+    for(index = 0U; index < MAX_CONTEXTS; ++index)
+    {
+        Context& context = m_contexts[index];
+
+        context.isSetup     = false;
+        context.isInUse     = false;
+        context.isInsecure  = false;
+    }
+}
+
+bool TlsContextPool::configure()
+{
+    bool    isSuccessful    = false;
+    int     ret             = 0;
+
+    mbedtls_entropy_init(&m_entropy);
+    mbedtls_ctr_drbg_init(&m_ctrDrbg);
+    mbedtls_ssl_config_init(&m_config);
+    mbedtls_ssl_config_init(&m_insecureConfig);
+
+    /* Without CA certificates no server certificate could be verified. */
+    if ((false == m_isCaAvailable) &&
+        (false == setCaCertificates(CaCertificates::getPem())))
+    {
+        LOG_WARNING("No CA certificates, secure connections will fail.");
+    }
+
+    ret = mbedtls_ctr_drbg_seed(&m_ctrDrbg,
+                                mbedtls_entropy_func,
+                                &m_entropy,
+                                reinterpret_cast<const unsigned char*>(RNG_PERSONALIZATION),
+                                sizeof(RNG_PERSONALIZATION) - 1U);
+
+    if (0 != ret)
+    {
+        LOG_ERROR("TLS random number generator seed failed: -0x%04X", -ret);
+    }
+    else
+    {
+        isSuccessful = configure(m_config, MBEDTLS_SSL_VERIFY_REQUIRED);
+
+        if (true == isSuccessful)
+        {
+            isSuccessful = configure(m_insecureConfig, MBEDTLS_SSL_VERIFY_NONE);
+        }
+    }
+
+    if (false == isSuccessful)
+    {
+        mbedtls_ssl_config_free(&m_insecureConfig);
+        mbedtls_ssl_config_free(&m_config);
+        mbedtls_ctr_drbg_free(&m_ctrDrbg);
+        mbedtls_entropy_free(&m_entropy);
+    }
+
+    return isSuccessful;
+}
+
+bool TlsContextPool::configure(mbedtls_ssl_config& config, int authMode)
+{
+    bool    isSuccessful    = false;
+    int     ret             = mbedtls_ssl_config_defaults(&config,
+                                                          MBEDTLS_SSL_IS_CLIENT,
+                                                          MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                          MBEDTLS_SSL_PRESET_DEFAULT);
+
+    if (0 != ret)
+    {
+        LOG_ERROR("TLS configuration failed: -0x%04X", -ret);
+    }
+    else
+    {
+        mbedtls_ssl_conf_rng(&config, mbedtls_ctr_drbg_random, &m_ctrDrbg);
+        mbedtls_ssl_conf_ca_chain(&config, &m_caChain, nullptr);
+        mbedtls_ssl_conf_authmode(&config, authMode);
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_conf_session_tickets(&config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif  /* defined(MBEDTLS_SSL_SESSION_TICKETS) */
+
+        isSuccessful = true;
+    }
+
+    return isSuccessful;
+}
+
+void TlsContextPool::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void TlsContextPool::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
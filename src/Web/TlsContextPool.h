@@ -0,0 +1,195 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS context pool
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __TLS_CONTEXT_POOL_H__
+#define __TLS_CONTEXT_POOL_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/x509_crt.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The TLS context pool provides the TLS contexts for all secure connections.
+ * All contexts share one client configuration, one random number generator
+ * and the trusted CA certificates. The server certificate is always verified,
+ * except a client explicit requests an insecure context. Insecure contexts
+ * use a separate configuration, which skips the verification.
+ *
+ * The record buffers of a TLS context are allocated once and kept, when the
+ * context is released. The next handshake reuses them, which avoids to
+ * fragment the heap with large allocations on every connection. Only one
+ * released context keeps its buffers, the buffers of any further released
+ * context are freed.
+ */
+class TlsContextPool
+{
+public:
+
+    /**
+     * Get TLS context pool instance.
+     *
+     * @return TLS context pool instance
+     */
+    static TlsContextPool& getInstance()
+    {
+        static TlsContextPool instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Set the trusted CA certificates. The server certificate is verified
+     * against them. If no CA certificates are set, the built-in ones are
+     * used, see CaCertificates.
+     * Set them during startup, before the first secure connection is
+     * established.
+     *
+     * @param[in] pem   CA certificates in PEM format
+     *
+     * @return If successful set, it will return true otherwise false.
+     */
+    bool setCaCertificates(const char* pem);
+
+    /**
+     * Acquire a TLS context. It is reset and ready for a new handshake.
+     *
+     * @param[in] isInsecure    Skip the verification of the server certificate?
+     *                          Use it only for servers in the local network,
+     *                          which have a self-signed certificate.
+     *
+     * @return TLS context. If no context is available, it will return nullptr.
+     */
+    mbedtls_ssl_context* acquire(bool isInsecure = false);
+
+    /**
+     * Release a TLS context.
+     *
+     * @param[in] ssl   TLS context
+     */
+    void release(mbedtls_ssl_context* ssl);
+
+    /** Max. number of TLS contexts, in use and released. */
+    static const uint8_t    MAX_CONTEXTS    = 2U;
+
+private:
+
+    /** A pooled TLS context */
+    struct Context
+    {
+        mbedtls_ssl_context ssl;        /**< TLS context */
+        bool                isSetup;    /**< Is the context setup and its buffers allocated? */
+        bool                isInUse;    /**< Is the context in use? */
+        bool                isInsecure; /**< Is the context setup with the insecure configuration? */
+    };
+
+    SemaphoreHandle_t           m_xMutex;                   /**< Mutex to protect the contexts. */
+    bool                        m_isConfigured;             /**< Is the shared configuration initialized? */
+    bool                        m_isCaAvailable;            /**< Are CA certificates available? */
+    mbedtls_entropy_context     m_entropy;                  /**< Entropy source */
+    mbedtls_ctr_drbg_context    m_ctrDrbg;                  /**< Random number generator */
+    mbedtls_x509_crt            m_caChain;                  /**< Trusted CA certificates */
+    mbedtls_ssl_config          m_config;                   /**< Shared client configuration */
+    mbedtls_ssl_config          m_insecureConfig;           /**< Shared client configuration without server verification */
+    Context                     m_contexts[MAX_CONTEXTS];   /**< TLS contexts */
+
+    /**
+     * Constructs the TLS context pool.
+     */
+    TlsContextPool();
+
+    /**
+     * Destroys the TLS context pool.
+     */
+    ~TlsContextPool()
+    {
+        /* Will never be called. */
+    }
+
+    TlsContextPool(const TlsContextPool& pool);
+    TlsContextPool& operator=(const TlsContextPool& pool);
+
+    /**
+     * Initialize the shared configurations and the random number generator.
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool configure();
+
+    /**
+     * Initialize a shared client configuration.
+     *
+     * @param[in] config    Client configuration
+     * @param[in] authMode  Verification mode of the server certificate
+     *
+     * @return If successful, it will return true otherwise false.
+     */
+    bool configure(mbedtls_ssl_config& config, int authMode);
+
+    /**
+     * Lock the contexts.
+     */
+    void lock();
+
+    /**
+     * Unlock the contexts.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __TLS_CONTEXT_POOL_H__ */
+
+/** @} */
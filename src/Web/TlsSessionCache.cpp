@@ -0,0 +1,320 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS session cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "TlsSessionCache.h"
+
+#include <Logging.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool TlsSessionCache::load(const String& hostname, uint16_t port, mbedtls_ssl_context* ssl)
+{
+    bool    isLoaded    = false;
+    uint8_t index       = 0U;
+
+    if (nullptr == ssl)
+    {
+        return false;
+    }
+
+    lock();
+
+    index = find(hostname, port);
+
+    if (MAX_ENTRIES > index)
+    {
+        Entry&      entry   = m_entries[index];
+        uint32_t    now     = millis();
+
+        if (entry.ttl <= (now - entry.timestamp))
+        {
+            freeEntry(index);
+        }
+        else if (0 != mbedtls_ssl_set_session(ssl, &entry.session))
+        {
+            freeEntry(index);
+        }
+        else
+        {
+            entry.lastUsed  = now;
+            isLoaded        = true;
+        }
+    }
+
+    unlock();
+
+    return isLoaded;
+}
+
+bool TlsSessionCache::store(const String& hostname, uint16_t port, const mbedtls_ssl_context* ssl)
+{
+    bool                isResumed   = false;
+    uint8_t             index       = 0U;
+    mbedtls_ssl_session session;
+
+    if ((nullptr == ssl) ||
+        (true == hostname.isEmpty()))
+    {
+        return false;
+    }
+
+    mbedtls_ssl_session_init(&session);
+
+    if (0 == mbedtls_ssl_get_session(ssl, &session))
+    {
+        uint32_t now = millis();
+
+        lock();
+
+        index = find(hostname, port);
+
+        if (MAX_ENTRIES > index)
+        {
+            /* A resumed session has the same master secret. */
+            if (0 == memcmp(m_entries[index].session.master, session.master, sizeof(session.master)))
+            {
+                isResumed = true;
+            }
+        }
+        /* Take a free entry or replace the least recently used one. */
+        else
+        {
+            uint8_t lru = 0U;
+
+            index = 0U;
+            while((MAX_ENTRIES > index) && (false == m_entries[index].hostname.isEmpty()))
+            {
+                if ((now - m_entries[index].lastUsed) > (now - m_entries[lru].lastUsed))
+                {
+                    lru = index;
+                }
+
+                ++index;
+            }
+
+            if (MAX_ENTRIES <= index)
+            {
+                index = lru;
+            }
+        }
+
+        Entry& entry = m_entries[index];
+
+        /* A resumed session keeps its original lifetime. The server may
+         * have issued a new ticket, therefore the session is replaced anyway.
+         */
+        if (false == isResumed)
+        {
+            entry.timestamp = now;
+            entry.ttl       = TTL;
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+            if ((0U < session.ticket_lifetime) &&
+                ((TTL / 1000U) > session.ticket_lifetime))
+            {
+                entry.ttl = session.ticket_lifetime * 1000U;
+            }
+#endif  /* defined(MBEDTLS_SSL_SESSION_TICKETS) */
+        }
+
+        /* The session is moved into the entry, it contains no references to itself. */
+        mbedtls_ssl_session_free(&entry.session);
+        memcpy(&entry.session, &session, sizeof(session));
+        mbedtls_ssl_session_init(&session);
+
+        entry.hostname  = hostname;
+        entry.port      = port;
+        entry.lastUsed  = now;
+
+        unlock();
+    }
+
+    mbedtls_ssl_session_free(&session);
+
+    return isResumed;
+}
+
+void TlsSessionCache::remove(const String& hostname, uint16_t port)
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    index = find(hostname, port);
+
+    if (MAX_ENTRIES > index)
+    {
+        freeEntry(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+void TlsSessionCache::clear()
+{
+    uint8_t index = 0U;
+
+    lock();
+
+    for(index = 0U; index < MAX_ENTRIES; ++index)
+    {
+        freeEntry(index);
+    }
+
+    unlock();
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+TlsSessionCache::TlsSessionCache() :
+    m_xMutex(xSemaphoreCreateRecursiveMutex()),
+    m_entries()
+{
+    uint8_t index = 0U;
+
+    for(index = 0U; index < MAX_ENTRIES; ++index)
+    {
+        Entry& entry = m_entries[index];
+
+        entry.port      = 0U;
+        entry.timestamp = 0U;
+        entry.ttl       = 0U;
+        entry.lastUsed  = 0U;
+
+        mbedtls_ssl_session_init(&entry.session);
+    }
+}
+
+uint8_t TlsSessionCache::find(const String& hostname, uint16_t port) const
+{
+    uint8_t index   = 0U;
+    bool    isFound = false;
+
+    while((MAX_ENTRIES > index) && (false == isFound))
+    {
+        if ((false == m_entries[index].hostname.isEmpty()) &&
+            (port == m_entries[index].port) &&
+            (0U != m_entries[index].hostname.equalsIgnoreCase(hostname)))
+        {
+            isFound = true;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    return index;
+}
+
+void TlsSessionCache::freeEntry(uint8_t index)
+{
+    if (MAX_ENTRIES > index)
+    {
+        Entry& entry = m_entries[index];
+
+        entry.hostname.clear();
+        entry.port      = 0U;
+        entry.timestamp = 0U;
+        entry.ttl       = 0U;
+        entry.lastUsed  = 0U;
+
+        /* The session contains the master secret, which shall not remain in memory. */
+        mbedtls_ssl_session_free(&entry.session);
+        mbedtls_ssl_session_init(&entry.session);
+    }
+
+    return;
+}
+
+void TlsSessionCache::lock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreTakeRecursive(m_xMutex, portMAX_DELAY);
+    }
+
+    return;
+}
+
+void TlsSessionCache::unlock()
+{
+    if (nullptr != m_xMutex)
+    {
+        (void)xSemaphoreGiveRecursive(m_xMutex);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,192 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  TLS session cache
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __TLS_SESSION_CACHE_H__
+#define __TLS_SESSION_CACHE_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <mbedtls/ssl.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The TLS session cache keeps the last negotiated session per host and port.
+ * A new connection to the same server offers it, which allows the server to
+ * resume the session with a abbreviated handshake, either by session ticket
+ * or by session id. No key exchange and no certificate verification is
+ * necessary then.
+ *
+ * A session is valid for a limited time, which is shortened to the ticket
+ * lifetime, if the server provides one. The number of entries is limited,
+ * the least recently used one is replaced.
+ */
+class TlsSessionCache
+{
+public:
+
+    /**
+     * Get TLS session cache instance.
+     *
+     * @return TLS session cache instance
+     */
+    static TlsSessionCache& getInstance()
+    {
+        static TlsSessionCache instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Offer the cached session of the server to a new handshake.
+     *
+     * @param[in] hostname  Server hostname
+     * @param[in] port      Server port
+     * @param[in] ssl       TLS context, before the handshake
+     *
+     * @return If a session is offered, it will return true otherwise false.
+     */
+    bool load(const String& hostname, uint16_t port, mbedtls_ssl_context* ssl);
+
+    /**
+     * Store the session of a completed handshake.
+     *
+     * @param[in] hostname  Server hostname
+     * @param[in] port      Server port
+     * @param[in] ssl       TLS context, after the handshake
+     *
+     * @return If the handshake resumed the cached session, it will return true otherwise false.
+     */
+    bool store(const String& hostname, uint16_t port, const mbedtls_ssl_context* ssl);
+
+    /**
+     * Remove the session of a server, e.g. because the handshake failed.
+     *
+     * @param[in] hostname  Server hostname
+     * @param[in] port      Server port
+     */
+    void remove(const String& hostname, uint16_t port);
+
+    /**
+     * Remove all sessions.
+     */
+    void clear();
+
+    /** Max. number of cached sessions */
+    static const uint8_t    MAX_ENTRIES     = 4U;
+
+    /** Max. time to live in ms of a session */
+    static const uint32_t   TTL             = 60U * 60U * 1000U;
+
+private:
+
+    /** Cached session */
+    struct Entry
+    {
+        String              hostname;   /**< Server hostname, empty if the entry is unused. */
+        uint16_t            port;       /**< Server port */
+        mbedtls_ssl_session session;    /**< Negotiated session */
+        uint32_t            timestamp;  /**< Timestamp in ms of the negotiation */
+        uint32_t            ttl;        /**< Time to live in ms */
+        uint32_t            lastUsed;   /**< Timestamp in ms of the last handshake */
+    };
+
+    SemaphoreHandle_t   m_xMutex;                   /**< Mutex to protect the entries. */
+    Entry               m_entries[MAX_ENTRIES];     /**< Cached sessions */
+
+    /**
+     * Constructs the TLS session cache.
+     */
+    TlsSessionCache();
+
+    /**
+     * Destroys the TLS session cache.
+     */
+    ~TlsSessionCache()
+    {
+        /* Will never be called. */
+    }
+
+    TlsSessionCache(const TlsSessionCache& cache);
+    TlsSessionCache& operator=(const TlsSessionCache& cache);
+
+    /**
+     * Find the entry of a server.
+     *
+     * @param[in] hostname  Server hostname
+     * @param[in] port      Server port
+     *
+     * @return Index of the entry. If not found, it will return MAX_ENTRIES.
+     */
+    uint8_t find(const String& hostname, uint16_t port) const;
+
+    /**
+     * Free a entry.
+     *
+     * @param[in] index Index of the entry
+     */
+    void freeEntry(uint8_t index);
+
+    /**
+     * Lock the cache.
+     */
+    void lock();
+
+    /**
+     * Unlock the cache.
+     */
+    void unlock();
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __TLS_SESSION_CACHE_H__ */
+
+/** @} */
@@ -0,0 +1,398 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Template index of the web pages
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "TmplIndex.h"
+#include "FileSystem.h"
+#include "JsonFile.h"
+#include "JsonDocPool.h"
+
+#include <Logging.h>
+#include <Util.h>
+#include <ArduinoJson.h>
+#include <memory>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/**
+ * Templated web page, which is sent part by part as chunked response.
+ * The file content is copied up to the next placeholder and only the
+ * placeholder is read and substituted.
+ */
+class TmplPage
+{
+public:
+
+    /**
+     * Constructs the templated web page.
+     *
+     * @param[in] fd            Opened web page file
+     * @param[in] placeholders  Offset and length of every placeholder
+     * @param[in] count         Number of placeholders
+     * @param[in] processor     Template processor
+     */
+    TmplPage(File& fd, const uint32_t* placeholders, uint8_t count, AwsTemplateProcessor processor) :
+        m_fd(fd),
+        m_placeholders(placeholders),
+        m_count(count),
+        m_processor(processor),
+        m_filePos(0U),
+        m_index(0U),
+        m_value(),
+        m_valueIdx(0U)
+    {
+    }
+
+    /**
+     * Destroys the templated web page.
+     */
+    ~TmplPage()
+    {
+        m_fd.close();
+    }
+
+    /**
+     * Fill the response buffer with the next part of the web page.
+     *
+     * @param[in] buffer    Response buffer
+     * @param[in] maxLen    Response buffer size in byte
+     *
+     * @return Number of written bytes. If 0, the web page is complete.
+     */
+    size_t fill(uint8_t* buffer, size_t maxLen)
+    {
+        size_t  written = 0U;
+        bool    isEnd   = false;
+
+        while((written < maxLen) && (false == isEnd))
+        {
+            /* Placeholder value not completely sent yet? */
+            if (m_value.length() > m_valueIdx)
+            {
+                size_t len = m_value.length() - m_valueIdx;
+
+                if ((maxLen - written) < len)
+                {
+                    len = maxLen - written;
+                }
+
+                memcpy(&buffer[written], &m_value.c_str()[m_valueIdx], len);
+                written     += len;
+                m_valueIdx  += len;
+            }
+            /* Next placeholder reached? */
+            else if ((m_count > m_index) &&
+                     (m_placeholders[2U * m_index] == m_filePos))
+            {
+                substitute();
+            }
+            /* Copy the file content up to the next placeholder. */
+            else
+            {
+                size_t len = maxLen - written;
+
+                if ((m_count > m_index) &&
+                    ((m_placeholders[2U * m_index] - m_filePos) < len))
+                {
+                    len = m_placeholders[2U * m_index] - m_filePos;
+                }
+
+                len = m_fd.read(&buffer[written], len);
+
+                if (0U == len)
+                {
+                    isEnd = true;
+                }
+                else
+                {
+                    written     += len;
+                    m_filePos   += len;
+                }
+            }
+        }
+
+        return written;
+    }
+
+private:
+
+    File                    m_fd;           /**< Web page file */
+    const uint32_t*         m_placeholders; /**< Offset and length of every placeholder */
+    uint8_t                 m_count;        /**< Number of placeholders */
+    AwsTemplateProcessor    m_processor;    /**< Template processor */
+    size_t                  m_filePos;      /**< Current file position */
+    uint8_t                 m_index;        /**< Index of the next placeholder */
+    String                  m_value;        /**< Value of the current placeholder */
+    size_t                  m_valueIdx;     /**< Number of already sent characters of the value */
+
+    TmplPage(const TmplPage& page);
+    TmplPage& operator=(const TmplPage& page);
+
+    /**
+     * Read the current placeholder and substitute it by its value.
+     * If the file content is not a placeholder, because the file was changed
+     * with the same size, the content will be kept.
+     */
+    void substitute()
+    {
+        char    placeholder[TmplIndex::MAX_PLACEHOLDER_LENGTH + 1U];
+        size_t  len = m_fd.read(reinterpret_cast<uint8_t*>(placeholder), m_placeholders[2U * m_index + 1U]);
+
+        placeholder[len] = '\0';
+
+        if ((2U < len) &&
+            ('~' == placeholder[0U]) &&
+            ('~' == placeholder[len - 1U]))
+        {
+            placeholder[len - 1U] = '\0';
+            m_value = m_processor(String(&placeholder[1U]));
+        }
+        else
+        {
+            m_value = placeholder;
+        }
+
+        m_valueIdx  = 0U;
+        m_filePos  += len;
+        ++m_index;
+
+        return;
+    }
+};
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/* Initialize template index filename. */
+const char* TmplIndex::FILE_NAME    = "/tmplIndex.json";
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+bool TmplIndex::load()
+{
+    bool isSuccessful = true;
+
+    if (false == m_isLoaded)
+    {
+        const size_t        JSON_DOC_SIZE   = 4096U;
+        PooledJsonDocument  jsonDoc(JSON_DOC_SIZE);
+        JsonFile            jsonFile(FILESYSTEM);
+
+        m_isLoaded = true;
+
+        if (false == jsonFile.load(FILE_NAME, jsonDoc))
+        {
+            LOG_WARNING("Template index %s not available.", FILE_NAME);
+            isSuccessful = false;
+        }
+        else
+        {
+            for (JsonPair jsonPair : jsonDoc.as<JsonObject>())
+            {
+                Page* page = createPage(jsonPair.key().c_str(), jsonPair.value());
+
+                if (nullptr == page)
+                {
+                    LOG_WARNING("Template index of %s is invalid.", jsonPair.key().c_str());
+                }
+                else
+                {
+                    page->next  = m_pages;
+                    m_pages     = page;
+                }
+            }
+        }
+    }
+
+    return isSuccessful;
+}
+
+void TmplIndex::send(AsyncWebServerRequest* request, const String& path, const String& contentType, AwsTemplateProcessor processor) const
+{
+    const Page*                 page = find(path);
+    std::shared_ptr<TmplPage>   tmplPage;
+
+    if (nullptr == request)
+    {
+        return;
+    }
+
+    if (nullptr != page)
+    {
+        File fd = FILESYSTEM.open(path, "r");
+
+        /* A changed web page is not covered by the index anymore. */
+        if ((true == fd) &&
+            (page->size == fd.size()))
+        {
+            tmplPage.reset(new TmplPage(fd, page->placeholders, page->count, processor));
+        }
+        else
+        {
+            fd.close();
+        }
+    }
+
+    if (nullptr == tmplPage)
+    {
+        request->send(FILESYSTEM, path, contentType, false, processor);
+    }
+    else
+    {
+        /* The web page is destroyed together with the response. */
+        AsyncWebServerResponse* response = request->beginChunkedResponse(contentType,
+            [tmplPage](uint8_t* buffer, size_t maxLen, size_t index) -> size_t
+            {
+                UTIL_NOT_USED(index);
+                return tmplPage->fill(buffer, maxLen);
+            });
+
+        request->send(response);
+    }
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+TmplIndex::Page* TmplIndex::createPage(const char* path, JsonVariantConst jsonPage)
+{
+    JsonVariantConst    jsonSize            = jsonPage["size"];
+    JsonArrayConst      jsonPlaceholders    = jsonPage["tmpl"];
+    size_t              count               = jsonPlaceholders.size() / 2U;
+    Page*               page                = nullptr;
+
+    if ((true == jsonSize.is<uint32_t>()) &&
+        (0U < count) &&
+        (UINT8_MAX >= count))
+    {
+        page = new Page();
+
+        if (nullptr != page)
+        {
+            page->placeholders = new uint32_t[2U * count];
+
+            if (nullptr == page->placeholders)
+            {
+                delete page;
+                page = nullptr;
+            }
+        }
+    }
+
+    if (nullptr != page)
+    {
+        size_t  index   = 0U;
+        size_t  minPos  = 0U;
+        bool    isValid = true;
+
+        page->path  = path;
+        page->size  = jsonSize.as<uint32_t>();
+        page->count = static_cast<uint8_t>(count);
+
+        /* The placeholders must be in ascending order and inside the file. */
+        while((2U * count > index) && (true == isValid))
+        {
+            uint32_t offset = jsonPlaceholders[index].as<uint32_t>();
+            uint32_t length = jsonPlaceholders[index + 1U].as<uint32_t>();
+
+            if ((minPos > offset) ||
+                (3U > length) ||
+                (MAX_PLACEHOLDER_LENGTH < length) ||
+                (page->size < (offset + length)))
+            {
+                isValid = false;
+            }
+            else
+            {
+                page->placeholders[index]       = offset;
+                page->placeholders[index + 1U]  = length;
+
+                minPos  = offset + length;
+                index  += 2U;
+            }
+        }
+
+        if (false == isValid)
+        {
+            delete[] page->placeholders;
+            delete page;
+            page = nullptr;
+        }
+    }
+
+    return page;
+}
+
+const TmplIndex::Page* TmplIndex::find(const String& path) const
+{
+    const Page* page = m_pages;
+
+    while((nullptr != page) && (path != page->path))
+    {
+        page = page->next;
+    }
+
+    return page;
+}
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
@@ -0,0 +1,186 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Template index of the web pages
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __TMPL_INDEX_H__
+#define __TMPL_INDEX_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include <stdint.h>
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * The template index contains the position of every placeholder in the
+ * templated web pages. It is created together with the filesystem image
+ * (see scripts/prepareDataDir.py).
+ *
+ * A web page, which is listed in the index, is sent without scanning its
+ * content for placeholders. The file is copied up to the next placeholder
+ * and only the placeholder is substituted by the template processor.
+ *
+ * A web page, which is not listed or was changed since the index was
+ * created, is sent by the webserver template engine like before.
+ */
+class TmplIndex
+{
+public:
+
+    /**
+     * Get template index instance.
+     *
+     * @return Template index instance
+     */
+    static TmplIndex& getInstance()
+    {
+        static TmplIndex instance; /* singleton idiom to force initialization in the first usage. */
+
+        return instance;
+    }
+
+    /**
+     * Load the template index from the filesystem.
+     * It is loaded only once, all further calls will be ignored.
+     *
+     * @return If successful loaded, it will return true otherwise false.
+     */
+    bool load();
+
+    /**
+     * Send a templated web page.
+     *
+     * @param[in] request       HTTP request
+     * @param[in] path          Path of the web page in the filesystem
+     * @param[in] contentType   Content type
+     * @param[in] processor     Template processor, which provides the placeholder values.
+     */
+    void send(AsyncWebServerRequest* request, const String& path, const String& contentType, AwsTemplateProcessor processor) const;
+
+    /** Filename of the template index in the filesystem. */
+    static const char*      FILE_NAME;
+
+    /** Max. placeholder length in byte, including the delimiters. */
+    static const uint8_t    MAX_PLACEHOLDER_LENGTH  = 34U;
+
+private:
+
+    /**
+     * A templated web page.
+     */
+    struct Page
+    {
+        String      path;           /**< Path of the web page in the filesystem */
+        size_t      size;           /**< File size in byte, when the index was created. */
+        uint8_t     count;          /**< Number of placeholders */
+        uint32_t*   placeholders;   /**< Offset and length of every placeholder */
+        Page*       next;           /**< Next templated web page */
+
+        /**
+         * Initialize the web page.
+         */
+        Page() :
+            path(),
+            size(0U),
+            count(0U),
+            placeholders(nullptr),
+            next(nullptr)
+        {
+        }
+    };
+
+    bool    m_isLoaded; /**< Is the template index loaded? */
+    Page*   m_pages;    /**< Templated web pages */
+
+    /**
+     * Constructs the template index.
+     */
+    TmplIndex() :
+        m_isLoaded(false),
+        m_pages(nullptr)
+    {
+    }
+
+    /**
+     * Destroys the template index.
+     */
+    ~TmplIndex()
+    {
+        /* Will never be called. */
+    }
+
+    TmplIndex(const TmplIndex& index);
+    TmplIndex& operator=(const TmplIndex& index);
+
+    /**
+     * Create a templated web page from its template index entry.
+     *
+     * @param[in] path      Path of the web page in the filesystem
+     * @param[in] jsonPage  Template index entry of the web page
+     *
+     * @return If the entry is valid, it will return the web page otherwise nullptr.
+     */
+    static Page* createPage(const char* path, JsonVariantConst jsonPage);
+
+    /**
+     * Find a templated web page.
+     *
+     * @param[in] path  Path of the web page in the filesystem
+     *
+     * @return If found, it will return the web page otherwise nullptr.
+     */
+    const Page* find(const String& path) const;
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __TMPL_INDEX_H__ */
+
+/** @} */
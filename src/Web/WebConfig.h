@@ -67,6 +67,15 @@ static const uint32_t   WEBSOCKET_PORT          = 80U;
 /** Websocket path */
 static const char       WEBSOCKET_PATH[]        = "/ws";
 
+/** Query parameter, which contains the content hash of a versioned file. */
+static const char       VERSION_PARAM[]         = "v";
+
+/**
+ * Cache control of versioned files. A changed file gets a new version,
+ * therefore the client may cache them for 1 year without revalidation.
+ */
+static const char       VERSIONED_FILE_CACHE_CONTROL[]  = "max-age=31536000, immutable";
+
 /** Arduino OTA port */
 static const uint32_t   ARDUINO_OTA_PORT        = 3232U;
 
@@ -48,9 +48,12 @@
 #include "WsCmdIperf.h"
 #include "WsCmdButton.h"
 #include "WsCmdEffect.h"
+#include "WsCmdStream.h"
+#include "DisplayStream.h"
 
 #include <Logging.h>
 #include <Util.h>
+#include <string.h>
 
 /******************************************************************************
  * Compiler Switches
@@ -111,22 +114,29 @@ static WsCmdButton          gWsCmdButton;
 /** Websocket control fade effects */
 static WsCmdEffect          gWsCmdEffect;
 
-/** Websocket command list */
+/** Websocket subscribe display stream command */
+static WsCmdStream          gWsCmdStream;
+
+/**
+ * Websocket command list, sorted by command string (strcmp order) for the
+ * binary search.
+ */
 static WsCmd*       gWsCommands[] =
 {
+    &gWsCmdBrightness,
+    &gWsCmdButton,
+    &gWsCmdEffect,
     &gWsCmdGetDisp,
-    &gWsCmdSlots,
-    &gWsCmdPlugins,
     &gWsCmdInstall,
-    &gWsCmdUninstall,
-    &gWsCmdReset,
-    &gWsCmdBrightness,
+    &gWsCmdIperf,
     &gWsCmdLog,
     &gWsCmdMove,
+    &gWsCmdPlugins,
+    &gWsCmdReset,
+    &gWsCmdSlots,
     &gWsCmdSlotDuration,
-    &gWsCmdIperf,
-    &gWsCmdButton,
-    &gWsCmdEffect
+    &gWsCmdStream,
+    &gWsCmdUninstall
 };
 
 /******************************************************************************
@@ -137,6 +147,16 @@ void WebSocketSrv::init(AsyncWebServer& srv)
 {
     String      webLoginUser;
     String      webLoginPassword;
+    uint8_t     index               = 0U;
+
+    /* The command lookup requires a sorted command list. */
+    for(index = 1U; index < UTIL_ARRAY_NUM(gWsCommands); ++index)
+    {
+        if (0 <= strcmp(gWsCommands[index - 1U]->getCmd().c_str(), gWsCommands[index]->getCmd().c_str()))
+        {
+            LOG_ERROR("Websocket command %s is not sorted.", gWsCommands[index]->getCmd().c_str());
+        }
+    }
 
     if (false == Settings::getInstance().open(true))
     {
@@ -160,6 +180,9 @@ void WebSocketSrv::init(AsyncWebServer& srv)
     /* Register websocket on webserver */
     srv.addHandler(&m_webSocket);
 
+    /* Push the display content to the subscribed clients. */
+    DisplayStream::getInstance().init(m_webSocket);
+
     return;
 }
 
@@ -223,7 +246,30 @@ void WebSocketSrv::onConnect(AsyncWebSocket* server, AsyncWebSocketClient* clien
 
 void WebSocketSrv::onDisconnect(AsyncWebSocket* server, AsyncWebSocketClient* client)
 {
+    uint8_t index = 0U;
+
     LOG_INFO("ws[%s][%u] Client disconnected.", server->url(), client->id());
+
+    /* Release data, which the commands keep per client. */
+    for(index = 0U; index < UTIL_ARRAY_NUM(gWsCommands); ++index)
+    {
+        gWsCommands[index]->onDisconnect(client->id());
+    }
+
+    /* Release a fragmented message of the client. */
+    for(index = 0U; index < MAX_CLIENTS; ++index)
+    {
+        Message& msg = m_messages[index];
+
+        if ((true == msg.isUsed) &&
+            (client->id() == msg.clientId))
+        {
+            delete[] msg.buffer;
+            msg.buffer  = nullptr;
+            msg.isUsed  = false;
+        }
+    }
+
     return;
 }
 
@@ -265,44 +311,165 @@ void WebSocketSrv::onData(AsyncWebSocket* server, AsyncWebSocketClient* client,
         LOG_ERROR("ws[%s][%u] Frame info is missing.", server->url(), client->id());
         server->close(client->id(), 0U, "Frame info is missing.");
     }
-    /* No text frame? */
-    else if (WS_TEXT != info->opcode)
+    /* No text or binary message? */
+    else if ((WS_TEXT != info->message_opcode) &&
+             (WS_BINARY != info->message_opcode))
     {
-        LOG_ERROR("ws[%s][%u] Not supported message type received: %u", server->url(), client->id(), info->opcode);
+        LOG_ERROR("ws[%s][%u] Not supported message type received: %u", server->url(), client->id(), info->message_opcode);
         server->close(client->id(), 0U, "Not supported message type.");
     }
     /* Is the whole message in a single frame and we got all of it's data? */
     else if ((0U < info->final) &&
-                (0U == info->index) &&
-                (len == info->len ))
+             (0U == info->num) &&
+             (0U == info->index) &&
+             (len == info->len))
     {
-        /* Empty text message? */
+        /* Empty message? */
         if ((nullptr == data) ||
             (0U == len))
         {
             LOG_WARNING("ws[%s][%u] Message: -", server->url(), client->id());
         }
-        /* Handle text message */
+        else if (MAX_MSG_SIZE < len)
+        {
+            LOG_WARNING("ws[%s][%u] Message too long: %u bytes", server->url(), client->id(), len);
+            client->text("NACK;\"Message too long.\"");
+        }
+        /* Handle message */
         else
         {
-            handleMsg(server, client, reinterpret_cast<const char*>(data), len);
+            /* All websocket events are handled in the same context,
+             * therefore one buffer is sufficient.
+             */
+            memcpy(m_msg, data, len);
+            m_msg[len] = '\0';
+
+            handleMsg(server, client, info->message_opcode, m_msg, len);
         }
     }
     /* Message is comprised of multiple frames or the frame is split into multiple packets */
     else
     {
-        LOG_ERROR("ws[%s][%u] Fragmented messages not supported.", server->url(), client->id());
-        server->close(client->id(), 0U, "Not supported message type.");
+        reassembleMsg(server, client, info, data, len);
+    }
+
+    return;
+}
+
+void WebSocketSrv::reassembleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsFrameInfo* info, const uint8_t* data, size_t len)
+{
+    Message* msg = getMessage(client->id());
+
+    if (nullptr == msg)
+    {
+        LOG_ERROR("ws[%s][%u] No buffer for fragmented message.", server->url(), client->id());
+        server->close(client->id(), 0U, "No buffer for fragmented message.");
+    }
+    else
+    {
+        /* First data of a new message? */
+        if ((0U == info->num) &&
+            (0U == info->index))
+        {
+            msg->opcode     = info->message_opcode;
+            msg->size       = 0U;
+            msg->isTooLong  = false;
+        }
+
+        if ((false == msg->isTooLong) &&
+            (nullptr != data) &&
+            (0U < len))
+        {
+            if (nullptr == msg->buffer)
+            {
+                msg->buffer = new char[MAX_MSG_SIZE + 1U];
+            }
+
+            if (nullptr == msg->buffer)
+            {
+                LOG_ERROR("ws[%s][%u] Out of memory.", server->url(), client->id());
+                msg->isTooLong = true;
+            }
+            else if ((MAX_MSG_SIZE - msg->size) < len)
+            {
+                LOG_WARNING("ws[%s][%u] Message too long.", server->url(), client->id());
+                msg->isTooLong = true;
+            }
+            else
+            {
+                memcpy(&msg->buffer[msg->size], data, len);
+                msg->size += len;
+            }
+        }
+
+        /* Last data of the message? */
+        if ((0U < info->final) &&
+            ((info->index + len) == info->len))
+        {
+            if (true == msg->isTooLong)
+            {
+                client->text("NACK;\"Message too long.\"");
+            }
+            else if (0U == msg->size)
+            {
+                LOG_WARNING("ws[%s][%u] Message: -", server->url(), client->id());
+            }
+            else
+            {
+                msg->buffer[msg->size] = '\0';
+
+                handleMsg(server, client, msg->opcode, msg->buffer, msg->size);
+            }
+
+            msg->size       = 0U;
+            msg->isTooLong  = false;
+        }
     }
 
     return;
 }
 
-void WebSocketSrv::handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, const char* msg, size_t msgLen)
+WebSocketSrv::Message* WebSocketSrv::getMessage(uint32_t clientId)
+{
+    Message*    msg     = nullptr;
+    Message*    freeMsg = nullptr;
+    uint8_t     index   = 0U;
+
+    for(index = 0U; (index < MAX_CLIENTS) && (nullptr == msg); ++index)
+    {
+        if (false == m_messages[index].isUsed)
+        {
+            if (nullptr == freeMsg)
+            {
+                freeMsg = &m_messages[index];
+            }
+        }
+        else if (clientId == m_messages[index].clientId)
+        {
+            msg = &m_messages[index];
+        }
+    }
+
+    if ((nullptr == msg) &&
+        (nullptr != freeMsg))
+    {
+        msg = freeMsg;
+
+        msg->isUsed     = true;
+        msg->clientId   = clientId;
+        msg->opcode     = WS_TEXT;
+        msg->size       = 0U;
+        msg->isTooLong  = false;
+    }
+
+    return msg;
+}
+
+void WebSocketSrv::handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t opcode, char* msg, size_t msgLen)
 {
     size_t      msgIndex    = 0U;
-    String      cmd;
-    String      par;
+    const char* cmd         = nullptr;
+    bool        isParAvail  = false;
     WsCmd*      wsCmd       = nullptr;
     const char  DELIMITER   = ';';
 
@@ -321,58 +488,65 @@ void WebSocketSrv::handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* clien
     }
 
     /* Get command string */
+    cmd = &msg[msgIndex];
+
     while((msgLen > msgIndex) && (DELIMITER != msg[msgIndex]))
     {
-        cmd += msg[msgIndex];
         ++msgIndex;
     }
 
-    /* Command string not empty? */
-    if (0 < cmd.length())
+    /* Terminate command string and overstep delimiter */
+    if (msgLen > msgIndex)
     {
-        uint8_t index = 0U;
+        msg[msgIndex] = '\0';
+        ++msgIndex;
 
-        /* Find command object */
-        while((nullptr == wsCmd) && (index < UTIL_ARRAY_NUM(gWsCommands)))
-        {
-            if (cmd == gWsCommands[index]->getCmd())
-            {
-                wsCmd = gWsCommands[index];
-            }
+        isParAvail = true;
+    }
 
-            ++index;
-        }
+    /* Command string not empty? */
+    if ('\0' != cmd[0])
+    {
+        wsCmd = findCmd(cmd);
 
         /* Command not found? */
         if (nullptr == wsCmd)
         {
             client->text("NACK;\"Command unknown.\"");
         }
+        /* The whole data after the command is the binary parameter. */
+        else if (WS_BINARY == opcode)
+        {
+            if (false == wsCmd->setBinPar(reinterpret_cast<const uint8_t*>(&msg[msgIndex]), msgLen - msgIndex))
+            {
+                client->text("NACK;\"Binary parameter not supported.\"");
+            }
+            else
+            {
+                /* Execute command */
+                wsCmd->execute(server, client);
+            }
+        }
         else
         {
-            /* Determine parameters */
-            if ((msgLen > msgIndex) &&
-                (DELIMITER == msg[msgIndex]))
+            /* Determine parameters, the message is split in place. */
+            if (true == isParAvail)
             {
-                /* Overstep delimiter */
-                ++msgIndex;
+                const char* par = &msg[msgIndex];
 
                 while(msgLen > msgIndex)
                 {
                     if (DELIMITER == msg[msgIndex])
                     {
-                        wsCmd->setPar(par.c_str());
-                        par.clear();
-                    }
-                    else
-                    {
-                        par += msg[msgIndex];
+                        msg[msgIndex] = '\0';
+                        wsCmd->setPar(par);
+                        par = &msg[msgIndex + 1U];
                     }
 
                     ++msgIndex;
                 }
 
-                wsCmd->setPar(par.c_str());
+                wsCmd->setPar(par);
             }
 
             /* Execute command */
@@ -383,6 +557,35 @@ void WebSocketSrv::handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* clien
     return;
 }
 
+WsCmd* WebSocketSrv::findCmd(const char* cmd)
+{
+    WsCmd*  wsCmd   = nullptr;
+    size_t  left    = 0U;
+    size_t  right   = UTIL_ARRAY_NUM(gWsCommands);
+
+    /* Binary search, the command list is sorted by command string. */
+    while((nullptr == wsCmd) && (left < right))
+    {
+        size_t  middle  = left + ((right - left) / 2U);
+        int     result  = strcmp(cmd, gWsCommands[middle]->getCmd().c_str());
+
+        if (0 == result)
+        {
+            wsCmd = gWsCommands[middle];
+        }
+        else if (0 > result)
+        {
+            right = middle;
+        }
+        else
+        {
+            left = middle + 1U;
+        }
+    }
+
+    return wsCmd;
+}
+
 /******************************************************************************
  * External Functions
  *****************************************************************************/
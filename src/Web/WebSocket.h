@@ -48,6 +48,7 @@
 #include <Print.h>
 
 #include "WebConfig.h"
+#include "WsCmd.h"
 
 /******************************************************************************
  * Macros
@@ -83,15 +84,38 @@ public:
      */
     void init(AsyncWebServer& srv);
 
+    /** Max. websocket message size in bytes. Longer messages are rejected. */
+    static const size_t     MAX_MSG_SIZE    = 1024U;
+
+    /** Max. number of clients, which may send fragmented messages at the same time. */
+    static const uint8_t    MAX_CLIENTS     = 8U;
+
 private:
 
-    AsyncWebSocket  m_webSocket;    /**< Websocket */
+    /**
+     * A fragmented message, which is reassembled.
+     */
+    struct Message
+    {
+        bool        isUsed;     /**< Is the message used by a client? */
+        uint32_t    clientId;   /**< Websocket client id */
+        uint8_t     opcode;     /**< Message type (text or binary) */
+        size_t      size;       /**< Number of received bytes */
+        bool        isTooLong;  /**< Is the message too long? Its data is discarded. */
+        char*       buffer;     /**< Message buffer, allocated on first use. */
+    };
+
+    AsyncWebSocket  m_webSocket;                /**< Websocket */
+    Message         m_messages[MAX_CLIENTS];    /**< Fragmented messages per client */
+    char            m_msg[MAX_MSG_SIZE + 1U];   /**< Buffer for a message in a single frame, incl. string termination. */
 
     /**
      * Constructs the websocket server.
      */
     WebSocketSrv() :
-        m_webSocket(WebConfig::WEBSOCKET_PATH)
+        m_webSocket(WebConfig::WEBSOCKET_PATH),
+        m_messages(),
+        m_msg()
     {
     }
 
@@ -164,14 +188,48 @@ private:
     void onData(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsFrameInfo* info, const uint8_t* data, size_t len);
 
     /**
-     * Handle a websocket message.
+     * Reassemble a message, which is comprised of multiple frames or a frame
+     * which is split into multiple packets. If the message is complete, it
+     * will be handled.
+     *
+     * @param[in] server    Websocket server
+     * @param[in] client    Websocket client
+     * @param[in] info      Websocket frame info
+     * @param[in] data      Websocket data
+     * @param[in] len       Websocket data length in bytes
+     */
+    void reassembleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsFrameInfo* info, const uint8_t* data, size_t len);
+
+    /**
+     * Get the fragmented message of a client. If the client has none yet,
+     * a free one will be assigned.
+     *
+     * @param[in] clientId  Websocket client id
+     *
+     * @return Message. If no message is available, it will return nullptr.
+     */
+    Message* getMessage(uint32_t clientId);
+
+    /**
+     * Handle a websocket message. The message is tokenized in place, therefore
+     * it is modified.
      *
      * @param[in] server    Websocket server
      * @param[in] client    Weboscket client
-     * @param[in] msg       Websocket message (not '\0' terminated)
+     * @param[in] opcode    Message type (text or binary)
+     * @param[in] msg       Websocket message ('\0' terminated)
      * @param[in] msgLen    Websocket message length
      */
-    void handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, const char* msg, size_t msgLen);
+    void handleMsg(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t opcode, char* msg, size_t msgLen);
+
+    /**
+     * Find a command by its command string.
+     *
+     * @param[in] cmd   Command string
+     *
+     * @return Command. If not found, it will return nullptr.
+     */
+    WsCmd* findCmd(const char* cmd);
 
     /**
      * Write single data byte to all clients.
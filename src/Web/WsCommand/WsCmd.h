@@ -44,6 +44,7 @@
  * Includes
  *****************************************************************************/
 #include <ESPAsyncWebServer.h>
+#include <Util.h>
 
 /******************************************************************************
  * Macros
@@ -102,6 +103,35 @@ public:
      */
     virtual void setPar(const char* par) = 0;
 
+    /**
+     * Set binary command parameter. It is called once with the whole
+     * payload of a binary message, which follows the command string and
+     * its delimiter. The data is only valid during the call.
+     * 
+     * @param[in] data  Binary data
+     * @param[in] size  Binary data size in bytes
+     * 
+     * @return If the command accepts binary data, it will return true otherwise false.
+     */
+    virtual bool setBinPar(const uint8_t* data, size_t size)
+    {
+        UTIL_NOT_USED(data);
+        UTIL_NOT_USED(size);
+        return false;
+    }
+
+    /**
+     * Client disconnected. A command, which keeps data per client, shall
+     * release it.
+     * 
+     * @param[in] clientId  Websocket client id
+     */
+    virtual void onDisconnect(uint32_t clientId)
+    {
+        UTIL_NOT_USED(clientId);
+        return;
+    }
+
 private:
 
     String  m_cmd;  /**< Command */
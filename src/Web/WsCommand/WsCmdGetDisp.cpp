@@ -36,6 +36,7 @@
 #include "DisplayMgr.h"
 
 #include <Util.h>
+#include <Logging.h>
 
 /******************************************************************************
  * Compiler Switches
@@ -76,36 +77,80 @@ void WsCmdGetDisp::execute(AsyncWebSocket* server, AsyncWebSocketClient* client)
     }
     else
     {
-        uint32_t    index       = 0U;
-        String      rsp         = "ACK";
-        const char  DELIMITER   = ';';
-        uint32_t    framebuffer[Board::LedMatrix::width * Board::LedMatrix::height];
-        uint8_t     slotId      = DisplayMgr::SLOT_ID_INVALID;
+        uint8_t slotId = DisplayMgr::SLOT_ID_INVALID;
 
-        DisplayMgr::getInstance().getFBCopy(framebuffer, UTIL_ARRAY_NUM(framebuffer), &slotId);
+        DisplayMgr::getInstance().getFBCopy(m_framebuffer, UTIL_ARRAY_NUM(m_framebuffer), &slotId);
 
-        rsp += DELIMITER;
-        rsp += slotId;
+        if (0U == m_parCnt)
+        {
+            sendText(server, client, slotId);
+        }
+        else
+        {
+            sendFrame(server, client, slotId);
+        }
+    }
+
+    m_isError       = false;
+    m_parCnt        = 0U;
+    m_format        = FrameEncoder::PIXEL_FORMAT_RGB888;
+    m_ackFrameNo    = 0U;
+
+    return;
+}
+
+void WsCmdGetDisp::setPar(const char* par)
+{
+    uint8_t format = 0U;
+
+    switch(m_parCnt)
+    {
+    case 0:
+        if ((false == Util::strToUInt8(par, format)) ||
+            (FrameEncoder::PIXEL_FORMAT_MAX <= format))
+        {
+            LOG_ERROR("Invalid pixel format: %s", par);
+            m_isError = true;
+        }
+        else
+        {
+            m_format = static_cast<FrameEncoder::PixelFormat>(format);
+        }
+        break;
 
-        for(index = 0U; index <  UTIL_ARRAY_NUM(framebuffer); ++index)
+    case 1:
+        if (false == Util::strToUInt32(par, m_ackFrameNo))
         {
-            rsp += DELIMITER;
-            rsp += Util::uint32ToHex(framebuffer[index]);
+            LOG_ERROR("Conversion failed: %s", par);
+            m_isError = true;
         }
+        break;
 
-        server->text(client->id(), rsp);
+    default:
+        m_isError = true;
+        break;
     }
 
-    m_isError = false;
+    ++m_parCnt;
 
     return;
 }
 
-void WsCmdGetDisp::setPar(const char* par)
+void WsCmdGetDisp::onDisconnect(uint32_t clientId)
 {
-    UTIL_NOT_USED(par);
+    uint8_t index = 0U;
 
-    m_isError = true;
+    for(index = 0U; index < MAX_CLIENTS; ++index)
+    {
+        Client& entry = m_clients[index];
+
+        if ((true == entry.isUsed) &&
+            (clientId == entry.id))
+        {
+            entry.encoder.end();
+            entry.isUsed = false;
+        }
+    }
 
     return;
 }
@@ -118,6 +163,93 @@ void WsCmdGetDisp::setPar(const char* par)
  * Private Methods
  *****************************************************************************/
 
+FrameEncoder& WsCmdGetDisp::getEncoder(uint32_t clientId)
+{
+    Client* client  = nullptr;
+    uint8_t index   = 0U;
+
+    for(index = 0U; (index < MAX_CLIENTS) && (nullptr == client); ++index)
+    {
+        if ((true == m_clients[index].isUsed) &&
+            (clientId == m_clients[index].id))
+        {
+            client = &m_clients[index];
+        }
+    }
+
+    for(index = 0U; (index < MAX_CLIENTS) && (nullptr == client); ++index)
+    {
+        if (false == m_clients[index].isUsed)
+        {
+            client = &m_clients[index];
+        }
+    }
+
+    /* All used, take one over. Its former client will get a key frame next time. */
+    if (nullptr == client)
+    {
+        client = &m_clients[m_nextClient];
+
+        ++m_nextClient;
+        m_nextClient %= MAX_CLIENTS;
+    }
+
+    if ((false == client->isUsed) ||
+        (clientId != client->id))
+    {
+        client->encoder.end();
+        client->id      = clientId;
+        client->isUsed  = true;
+    }
+
+    return client->encoder;
+}
+
+void WsCmdGetDisp::sendText(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t slotId)
+{
+    uint32_t    index       = 0U;
+    String      rsp         = "ACK";
+    const char  DELIMITER   = ';';
+
+    /* "ACK;<slot id>" and ";<8 hex digits>" per pixel. */
+    (void)rsp.reserve(7U + (UTIL_ARRAY_NUM(m_framebuffer) * 9U));
+
+    rsp += DELIMITER;
+    rsp += slotId;
+
+    for(index = 0U; index < UTIL_ARRAY_NUM(m_framebuffer); ++index)
+    {
+        rsp += DELIMITER;
+        rsp += Util::uint32ToHex(m_framebuffer[index]);
+    }
+
+    server->text(client->id(), rsp);
+
+    return;
+}
+
+void WsCmdGetDisp::sendFrame(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t slotId)
+{
+    FrameEncoder&   encoder     = getEncoder(client->id());
+    size_t          frameSize   = 0U;
+
+    if (true == encoder.begin(Board::LedMatrix::width, Board::LedMatrix::height, m_format))
+    {
+        frameSize = encoder.encode(m_frame, sizeof(m_frame), m_framebuffer, slotId, m_ackFrameNo);
+    }
+
+    if (0U == frameSize)
+    {
+        server->text(client->id(), "NACK;\"Encoding failed.\"");
+    }
+    else
+    {
+        server->binary(client->id(), m_frame, frameSize);
+    }
+
+    return;
+}
+
 /******************************************************************************
  * External Functions
  *****************************************************************************/
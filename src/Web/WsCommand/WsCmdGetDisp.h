@@ -44,6 +44,9 @@
  * Includes
  *****************************************************************************/
 #include "WsCmd.h"
+#include "Board.h"
+
+#include <FrameEncoder.h>
 
 /******************************************************************************
  * Macros
@@ -55,6 +58,14 @@
 
 /**
  * Websocket command get display content
+ *
+ * Without parameters, the display content is responded as text with the
+ * color of every pixel as hex string.
+ *
+ * With the parameters pixel format (0: RGB888, 1: RGB565) and the number of
+ * the last received frame, the display content is responded as binary frame,
+ * see FrameEncoder. If the client acknowledges the frame, which was sent
+ * last, only the difference to it is sent.
  */
 class WsCmdGetDisp: public WsCmd
 {
@@ -65,8 +76,22 @@ public:
      */
     WsCmdGetDisp() :
         WsCmd("GETDISP"),
-        m_isError(false)
+        m_isError(false),
+        m_parCnt(0U),
+        m_format(FrameEncoder::PIXEL_FORMAT_RGB888),
+        m_ackFrameNo(0U),
+        m_clients(),
+        m_nextClient(0U),
+        m_framebuffer(),
+        m_frame()
     {
+        uint8_t index = 0U;
+
+        for(index = 0U; index < MAX_CLIENTS; ++index)
+        {
+            m_clients[index].id     = 0U;
+            m_clients[index].isUsed = false;
+        }
     }
 
     /**
@@ -91,12 +116,68 @@ public:
      */
     void setPar(const char* par) final;
 
+    /**
+     * Client disconnected. Its reference frame is released.
+     * 
+     * @param[in] clientId  Websocket client id
+     */
+    void onDisconnect(uint32_t clientId) final;
+
+    /** Max. number of clients with an own reference frame */
+    static const uint8_t    MAX_CLIENTS     = 4U;
+
 private:
 
-    bool    m_isError;  /**< Any error happened during parameter reception? */
+    /** Number of pixels */
+    static const size_t     PIXEL_COUNT     = Board::LedMatrix::width * Board::LedMatrix::height;
+
+    /** Frame encoder of a client */
+    struct Client
+    {
+        uint32_t        id;         /**< Websocket client id */
+        bool            isUsed;     /**< Is the encoder used by the client? */
+        FrameEncoder    encoder;    /**< Frame encoder with the reference frame of the client */
+    };
+
+    bool                        m_isError;                  /**< Any error happened during parameter reception? */
+    uint8_t                     m_parCnt;                   /**< Received number of parameters */
+    FrameEncoder::PixelFormat   m_format;                   /**< Requested pixel format */
+    uint32_t                    m_ackFrameNo;               /**< Number of the last frame, the client received. */
+    Client                      m_clients[MAX_CLIENTS];     /**< Frame encoders per client */
+    uint8_t                     m_nextClient;               /**< Index of the next frame encoder, which is taken over if all are used. */
+    uint32_t                    m_framebuffer[PIXEL_COUNT]; /**< Framebuffer copy */
+    uint8_t                     m_frame[FrameEncoder::HEADER_SIZE + (PIXEL_COUNT * FrameEncoder::MAX_BYTES_PER_PIXEL)]; /**< Encoded frame */
 
     WsCmdGetDisp(const WsCmdGetDisp& cmd);
     WsCmdGetDisp& operator=(const WsCmdGetDisp& cmd);
+
+    /**
+     * Get the frame encoder of a client. If the client has none, a free one
+     * is assigned or the one of another client is taken over.
+     * 
+     * @param[in] clientId  Websocket client id
+     * 
+     * @return Frame encoder
+     */
+    FrameEncoder& getEncoder(uint32_t clientId);
+
+    /**
+     * Send the display content as text.
+     * 
+     * @param[in] server    Websocket server
+     * @param[in] client    Websocket client
+     * @param[in] slotId    Id of slot, which shows the content.
+     */
+    void sendText(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t slotId);
+
+    /**
+     * Send the display content as binary frame.
+     * 
+     * @param[in] server    Websocket server
+     * @param[in] client    Websocket client
+     * @param[in] slotId    Id of slot, which shows the content.
+     */
+    void sendFrame(AsyncWebSocket* server, AsyncWebSocketClient* client, uint8_t slotId);
 };
 
 /******************************************************************************
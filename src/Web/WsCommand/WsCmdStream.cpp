@@ -0,0 +1,158 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Websocket command to subscribe the display stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ */
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "WsCmdStream.h"
+#include "DisplayStream.h"
+
+#include <Util.h>
+#include <Logging.h>
+
+/******************************************************************************
+ * Compiler Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and classes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Prototypes
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Variables
+ *****************************************************************************/
+
+/******************************************************************************
+ * Public Methods
+ *****************************************************************************/
+
+void WsCmdStream::execute(AsyncWebSocket* server, AsyncWebSocketClient* client)
+{
+    if ((nullptr == server) ||
+        (nullptr == client))
+    {
+        return;
+    }
+
+    /* Any error happended? */
+    if ((true == m_isError) ||
+        (2U != m_parCnt))
+    {
+        server->text(client->id(), "NACK;\"Parameter invalid.\"");
+    }
+    else if (0U == m_maxFps)
+    {
+        DisplayStream::getInstance().unsubscribe(client->id());
+        server->text(client->id(), "ACK");
+    }
+    else if (false == DisplayStream::getInstance().subscribe(client->id(), m_format, m_maxFps))
+    {
+        server->text(client->id(), "NACK;\"Too many subscribers.\"");
+    }
+    else
+    {
+        server->text(client->id(), "ACK");
+    }
+
+    m_isError   = false;
+    m_parCnt    = 0U;
+
+    return;
+}
+
+void WsCmdStream::setPar(const char* par)
+{
+    uint8_t format = 0U;
+
+    switch(m_parCnt)
+    {
+    case 0:
+        if ((false == Util::strToUInt8(par, format)) ||
+            (FrameEncoder::PIXEL_FORMAT_MAX <= format))
+        {
+            LOG_ERROR("Invalid pixel format: %s", par);
+            m_isError = true;
+        }
+        else
+        {
+            m_format = static_cast<FrameEncoder::PixelFormat>(format);
+        }
+        break;
+
+    case 1:
+        if ((false == Util::strToUInt8(par, m_maxFps)) ||
+            (DisplayStream::MAX_FPS < m_maxFps))
+        {
+            LOG_ERROR("Invalid frame rate: %s", par);
+            m_isError = true;
+        }
+        break;
+
+    default:
+        m_isError = true;
+        break;
+    }
+
+    ++m_parCnt;
+
+    return;
+}
+
+void WsCmdStream::onDisconnect(uint32_t clientId)
+{
+    DisplayStream::getInstance().unsubscribe(clientId);
+
+    return;
+}
+
+/******************************************************************************
+ * Protected Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * Private Methods
+ *****************************************************************************/
+
+/******************************************************************************
+ * External Functions
+ *****************************************************************************/
+
+/******************************************************************************
+ * Local Functions
+ *****************************************************************************/
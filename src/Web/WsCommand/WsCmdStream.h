@@ -0,0 +1,124 @@
+/* MIT License
+ *
+ * Copyright (c) 2019 - 2021 Andreas Merkle <web@blue-andi.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*******************************************************************************
+    DESCRIPTION
+*******************************************************************************/
+/**
+ * @brief  Websocket command to subscribe the display stream
+ * @author Andreas Merkle <web@blue-andi.de>
+ *
+ * @addtogroup web
+ *
+ * @{
+ */
+
+#ifndef __WSCMDSTREAM_H__
+#define __WSCMDSTREAM_H__
+
+/******************************************************************************
+ * Compile Switches
+ *****************************************************************************/
+
+/******************************************************************************
+ * Includes
+ *****************************************************************************/
+#include "WsCmd.h"
+
+#include <FrameEncoder.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+
+/******************************************************************************
+ * Types and Classes
+ *****************************************************************************/
+
+/**
+ * Websocket command to subscribe the display stream with a pixel format
+ * and a max. frame rate. A frame rate of 0 unsubscribes.
+ */
+class WsCmdStream: public WsCmd
+{
+public:
+
+    /**
+     * Constructs the websocket command.
+     */
+    WsCmdStream() :
+        WsCmd("STREAM"),
+        m_isError(false),
+        m_parCnt(0U),
+        m_format(FrameEncoder::PIXEL_FORMAT_RGB888),
+        m_maxFps(0U)
+    {
+    }
+
+    /**
+     * Destroys websocket command.
+     */
+    ~WsCmdStream()
+    {
+    }
+
+    /**
+     * Execute command.
+     *
+     * @param[in] server    Websocket server
+     * @param[in] client    Websocket client
+     */
+    void execute(AsyncWebSocket* server, AsyncWebSocketClient* client) final;
+
+    /**
+     * Set command parameter. Call this for each parameter, until executing it.
+     *
+     * @param[in] par   Parameter string
+     */
+    void setPar(const char* par) final;
+
+    /**
+     * Client disconnected. Its subscription is removed.
+     *
+     * @param[in] clientId  Websocket client id
+     */
+    void onDisconnect(uint32_t clientId) final;
+
+private:
+
+    bool                        m_isError;  /**< Any error happened during parameter reception? */
+    uint8_t                     m_parCnt;   /**< Received number of parameters */
+    FrameEncoder::PixelFormat   m_format;   /**< Pixel format */
+    uint8_t                     m_maxFps;   /**< Max. frame rate in frames per second */
+
+    WsCmdStream(const WsCmdStream& cmd);
+    WsCmdStream& operator=(const WsCmdStream& cmd);
+};
+
+/******************************************************************************
+ * Functions
+ *****************************************************************************/
+
+#endif  /* __WSCMDSTREAM_H__ */
+
+/** @} */
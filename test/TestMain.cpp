@@ -45,11 +45,16 @@
 #include <Color.h>
 #include <StateMachine.hpp>
 #include <SimpleTimer.hpp>
+#include <Hibernation.hpp>
+#include <SpscQueue.hpp>
+#include <Inflater.h>
+#include <FrameEncoder.h>
 #include <ProgressBar.h>
 #include <Logging.h>
 #include <LogSinkPrinter.h>
 #include <Util.h>
 #include <TomThumb.h>
+#include <VirtualClock.h>
 
 /******************************************************************************
  * Macros
@@ -589,6 +594,98 @@ private:
     AbstractState*  m_nextState;    /**< Next state */
 };
 
+/**
+ * Collects the decompressed data of the inflater.
+ */
+class TestInflaterOutput
+{
+public:
+
+    /**
+     * Constructs the output collector.
+     */
+    TestInflaterOutput() :
+        m_buffer(),
+        m_size(0U),
+        m_total(0U)
+    {
+    }
+
+    /**
+     * Destroys the output collector.
+     */
+    ~TestInflaterOutput()
+    {
+    }
+
+    /**
+     * Clear the collected data.
+     */
+    void clear()
+    {
+        m_size  = 0U;
+        m_total = 0U;
+        return;
+    }
+
+    /**
+     * Get collected data.
+     *
+     * @return Collected data
+     */
+    const uint8_t* getData() const
+    {
+        return m_buffer;
+    }
+
+    /**
+     * Get size of the collected data. Data, which didn't fit into the buffer,
+     * is only counted by the total size.
+     *
+     * @return Size in byte
+     */
+    size_t getSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Get the total size of the provided data.
+     *
+     * @return Size in byte
+     */
+    size_t getTotal() const
+    {
+        return m_total;
+    }
+
+    /**
+     * Output function for the inflater.
+     *
+     * @param[in] arg   Output collector
+     * @param[in] data  Decompressed data
+     * @param[in] size  Decompressed data size in byte
+     */
+    static void write(void* arg, const uint8_t* data, size_t size)
+    {
+        TestInflaterOutput* output = static_cast<TestInflaterOutput*>(arg);
+        size_t              free   = sizeof(output->m_buffer) - output->m_size;
+        size_t              toCopy = (free < size) ? free : size;
+
+        memcpy(&output->m_buffer[output->m_size], data, toCopy);
+        output->m_size  += toCopy;
+        output->m_total += size;
+
+        return;
+    }
+
+private:
+
+    uint8_t m_buffer[2048U];    /**< Collected data */
+    size_t  m_size;             /**< Size of the collected data in byte */
+    size_t  m_total;            /**< Total size of the provided data in byte */
+};
+
 /******************************************************************************
  * Prototypes
  *****************************************************************************/
@@ -606,9 +703,15 @@ static void testTextWidget(void);
 static void testColor(void);
 static void testStateMachine(void);
 static void testSimpleTimer(void);
+static void testHibernation(void);
 static void testProgressBar(void);
 static void testLogging(void);
 static void testUtil(void);
+static void testVirtualClock(void);
+static void testSpscQueue(void);
+static void testInflater(void);
+static void testFrameEncoder(void);
+static size_t decodeFrame(const uint8_t* frame, size_t size, uint32_t* values, size_t count);
 
 /******************************************************************************
  * Variables
@@ -641,9 +744,14 @@ int main(int argc, char **argv)
     RUN_TEST(testColor);
     RUN_TEST(testStateMachine);
     RUN_TEST(testSimpleTimer);
+    RUN_TEST(testHibernation);
     RUN_TEST(testProgressBar);
     RUN_TEST(testLogging);
     RUN_TEST(testUtil);
+    RUN_TEST(testVirtualClock);
+    RUN_TEST(testSpscQueue);
+    RUN_TEST(testInflater);
+    RUN_TEST(testFrameEncoder);
 
     return UNITY_END();
 }
@@ -1307,6 +1415,17 @@ static void testBitmapWidget()
         }
     }
 
+    /* Clear bitmap, nothing shall be drawn anymore. */
+    bitmapWidget.clear();
+    bitmapPtr = bitmapWidget.get(width, height);
+    TEST_ASSERT_NULL(bitmapPtr);
+    TEST_ASSERT_EQUAL_UINT16(0U, width);
+    TEST_ASSERT_EQUAL_UINT16(0U, height);
+
+    testGfx.fill(ColorDef::BLACK);
+    bitmapWidget.update(testGfx);
+    TEST_ASSERT_EQUAL_UINT16(ColorDef::BLACK, displayBuffer[0]);
+
     return;
 }
 
@@ -1548,6 +1667,73 @@ static void testSimpleTimer()
     return;
 }
 
+/**
+ * Test hibernation state and its invisibility timer.
+ */
+static void testHibernation(void)
+{
+    VirtualClock&   clock           = VirtualClock::getInstance();
+    const uint32_t  DURATION        = 100U;
+    Hibernation     hibernation;
+
+    clock.setMode(VirtualClock::MODE_VIRTUAL);
+
+    /* Not hibernated after construction. */
+    TEST_ASSERT_FALSE(hibernation.isHibernated());
+    TEST_ASSERT_EQUAL_UINT32(0U, hibernation.getReclaimedHeap());
+    TEST_ASSERT_FALSE(hibernation.resume());
+
+    /* Hibernation disabled */
+    TEST_ASSERT_FALSE(hibernation.isDue(false, 0U));
+    delay(DURATION);
+    TEST_ASSERT_FALSE(hibernation.isDue(false, 0U));
+
+    /* Visible plugin never hibernates. */
+    TEST_ASSERT_FALSE(hibernation.isDue(true, DURATION));
+    delay(DURATION);
+    TEST_ASSERT_FALSE(hibernation.isDue(true, DURATION));
+
+    /* Invisible plugin hibernates exactly after the duration. */
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(DURATION - 1U);
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(1U);
+    TEST_ASSERT_TRUE(hibernation.isDue(false, DURATION));
+
+    /* Plugin refused to hibernate, it will be asked again after the duration. */
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(DURATION);
+    TEST_ASSERT_TRUE(hibernation.isDue(false, DURATION));
+
+    /* Plugin hibernated, it won't be asked again. */
+    hibernation.hibernated(1024U);
+    TEST_ASSERT_TRUE(hibernation.isHibernated());
+    TEST_ASSERT_EQUAL_UINT32(1024U, hibernation.getReclaimedHeap());
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(2U * DURATION);
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+
+    /* Resume only once. */
+    TEST_ASSERT_TRUE(hibernation.resume());
+    TEST_ASSERT_FALSE(hibernation.isHibernated());
+    TEST_ASSERT_EQUAL_UINT32(0U, hibernation.getReclaimedHeap());
+    TEST_ASSERT_FALSE(hibernation.resume());
+
+    /* Getting visible restarts the invisibility time. */
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(DURATION - 1U);
+    TEST_ASSERT_FALSE(hibernation.isDue(true, DURATION));
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(DURATION - 1U);
+    TEST_ASSERT_FALSE(hibernation.isDue(false, DURATION));
+    delay(1U);
+    TEST_ASSERT_TRUE(hibernation.isDue(false, DURATION));
+
+    clock.setMode(VirtualClock::MODE_REALTIME);
+
+    return;
+}
+
 /**
  * Test progress bar.
  */
@@ -1783,6 +1969,19 @@ static void testUtil(void)
     TEST_ASSERT_FALSE(Util::strToInt32("4294967295", valueInt32));
     TEST_ASSERT_EQUAL_INT32(0, valueInt32);
 
+    /* Test the string object variants and an invalid string. */
+    valueUInt8 = 0U;
+    TEST_ASSERT_TRUE(Util::strToUInt8(String("0x10"), valueUInt8));
+    TEST_ASSERT_EQUAL_UINT8(0x10U, valueUInt8);
+
+    valueUInt32 = 0U;
+    TEST_ASSERT_TRUE(Util::strToUInt32(String("123"), valueUInt32));
+    TEST_ASSERT_EQUAL_UINT32(123U, valueUInt32);
+
+    TEST_ASSERT_FALSE(Util::strToUInt8(static_cast<const char*>(nullptr), valueUInt8));
+    TEST_ASSERT_FALSE(Util::strToUInt16("", valueUInt16));
+    TEST_ASSERT_FALSE(Util::strToInt32("1;", valueInt32));
+
     /* Test number to hex string conversion */
     TEST_ASSERT_EQUAL_STRING("1", Util::uint32ToHex(0x01).c_str());
     TEST_ASSERT_EQUAL_STRING("a", Util::uint32ToHex(0x0a).c_str());
@@ -1833,3 +2032,491 @@ static void testUtil(void)
 
     return;
 }
+
+/**
+ * Test virtual clock and pseudo random number generator.
+ */
+static void testVirtualClock(void)
+{
+    VirtualClock&   clock       = VirtualClock::getInstance();
+    unsigned long   timestamp   = 0U;
+    long            randomNums[4U];
+    uint8_t         index       = 0U;
+
+    /* Time doesn't run in virtual mode, only by waiting. */
+    clock.setMode(VirtualClock::MODE_VIRTUAL);
+    TEST_ASSERT_EQUAL(VirtualClock::MODE_VIRTUAL, clock.getMode());
+
+    timestamp = millis();
+    TEST_ASSERT_EQUAL_UINT32(timestamp, millis());
+
+    delay(100U);
+    TEST_ASSERT_EQUAL_UINT32(timestamp + 100U, millis());
+
+    /* Timer expires exactly after its duration. */
+    {
+        SimpleTimer testTimer;
+
+        testTimer.start(50U);
+        delay(49U);
+        TEST_ASSERT_FALSE(testTimer.isTimeout());
+        delay(1U);
+        TEST_ASSERT_TRUE(testTimer.isTimeout());
+    }
+
+    /* Switching back to realtime continues with the current time. */
+    clock.setMode(VirtualClock::MODE_REALTIME);
+    TEST_ASSERT_TRUE(timestamp + 150U <= millis());
+
+    /* Same seed, same random numbers. */
+    randomSeed(42U);
+    for(index = 0U; index < UTIL_ARRAY_NUM(randomNums); ++index)
+    {
+        randomNums[index] = random(0, 1000);
+        TEST_ASSERT_TRUE((0 <= randomNums[index]) && (1000 > randomNums[index]));
+    }
+
+    randomSeed(42U);
+    for(index = 0U; index < UTIL_ARRAY_NUM(randomNums); ++index)
+    {
+        TEST_ASSERT_EQUAL_INT32(randomNums[index], random(0, 1000));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(10, random(10, 11));
+
+    return;
+}
+
+/**
+ * Test single producer single consumer queue.
+ */
+static void testSpscQueue(void)
+{
+    const size_t                CAPACITY    = 3U;
+    SpscQueue<int, CAPACITY>    queue;
+    int                         value       = 0;
+    int                         round       = 0;
+
+    /* Queue must be empty */
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_EQUAL_size_t(CAPACITY, queue.getCapacity());
+    TEST_ASSERT_FALSE(queue.pop(value));
+
+    /* Fill queue completely */
+    TEST_ASSERT_TRUE(queue.push(1));
+    TEST_ASSERT_FALSE(queue.isEmpty());
+    TEST_ASSERT_TRUE(queue.push(2));
+    TEST_ASSERT_TRUE(queue.push(3));
+    TEST_ASSERT_FALSE(queue.push(4));
+
+    /* Elements must come out in the same order. */
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL_INT(1, value);
+    TEST_ASSERT_TRUE(queue.push(4));
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL_INT(2, value);
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL_INT(3, value);
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL_INT(4, value);
+    TEST_ASSERT_FALSE(queue.pop(value));
+    TEST_ASSERT_TRUE(queue.isEmpty());
+
+    /* Several times around the ring buffer */
+    for(round = 0; round < 10; ++round)
+    {
+        TEST_ASSERT_TRUE(queue.push(round));
+        TEST_ASSERT_TRUE(queue.push(round + 100));
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL_INT(round, value);
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL_INT(round + 100, value);
+    }
+
+    TEST_ASSERT_TRUE(queue.isEmpty());
+
+    return;
+}
+
+/**
+ * Inflater tests.
+ */
+static void testInflater(void)
+{
+    static const uint8_t    GZIP_DATA[187]  =
+    {
+        0x1FU, 0x8BU, 0x08U, 0x08U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U, 0xFFU, 0x64U, 0x61U, 0x74U, 0x61U, 0x2EU, 0x74U,
+        0x78U, 0x74U, 0x00U, 0x85U, 0xD0U, 0x3DU, 0x0AU, 0xC2U, 0x40U, 0x14U, 0x00U, 0xE1U, 0xDEU, 0x53U, 0x6CU, 0x63U,
+        0x27U, 0xB2U, 0xFBU, 0xFEU, 0xD4U, 0x3AU, 0x57U, 0xC8U, 0x05U, 0x04U, 0x03U, 0xA6U, 0x08U, 0x48U, 0x48U, 0x0AU,
+        0x6FU, 0x6FU, 0xEBU, 0x63U, 0x03U, 0xD3U, 0x4FU, 0x33U, 0xDFU, 0x38U, 0x2DU, 0x9FU, 0x69U, 0x7DU, 0x6EU, 0xFBU,
+        0x3AU, 0x15U, 0xA9U, 0x65U, 0xB8U, 0x94U, 0xF7U, 0xBEU, 0xCCU, 0xAFU, 0x79U, 0xFBU, 0x16U, 0xABU, 0xE5U, 0x7CU,
+        0x3DU, 0x8DU, 0xFFU, 0x41U, 0xCBU, 0x81U, 0x76U, 0x81U, 0xE4U, 0x20U, 0xBAU, 0x40U, 0x73U, 0xF0U, 0xE8U, 0x02U,
+        0xCBU, 0x41U, 0xEBU, 0x02U, 0xCFU, 0x81U, 0x75U, 0x41U, 0xE4U, 0xE0U, 0xD6U, 0x05U, 0x79U, 0xD3U, 0x71U, 0x53U,
+        0x68U, 0xD3U, 0x69U, 0xF3U, 0x4EU, 0x9BU, 0x95U, 0x36U, 0x95U, 0x36U, 0x03U, 0x36U, 0x0FU, 0xA8U, 0x1BU, 0x51U,
+        0x0BU, 0x51U, 0x2BU, 0x51U, 0x1BU, 0x51U, 0x3BU, 0x51U, 0x07U, 0x51U, 0x57U, 0xA2U, 0x6EU, 0x44U, 0x2DU, 0x44U,
+        0xADU, 0x44U, 0x6DU, 0x44U, 0xEDU, 0x44U, 0x1DU, 0x44U, 0x5DU, 0x89U, 0xBAU, 0x11U, 0xB5U, 0x10U, 0xB5U, 0x12U,
+        0xB5U, 0x11U, 0xB5U, 0x13U, 0x75U, 0x10U, 0x75U, 0x25U, 0xEAU, 0x46U, 0xD4U, 0x42U, 0xD4U, 0x4AU, 0xD4U, 0x76U,
+        0x40U, 0xFDU, 0x03U, 0x15U, 0x71U, 0x1DU, 0x5DU, 0x28U, 0x05U, 0x00U, 0x00U
+    };
+
+    static const uint8_t    ZLIB_DATA[163]  =
+    {
+        0x18U, 0xD3U, 0x85U, 0xCFU, 0x3BU, 0x0AU, 0xC2U, 0x50U, 0x10U, 0x40U, 0xD1U, 0xDEU, 0x55U, 0xBCU, 0xC6U, 0x4EU,
+        0xE4U, 0x7DU, 0x66U, 0xDEU, 0xA7U, 0xCEU, 0x16U, 0xB2U, 0x01U, 0xC1U, 0x80U, 0x29U, 0x02U, 0x12U, 0x92U, 0xC2U,
+        0xDDU, 0x8BU, 0x9DU, 0xC3U, 0x14U, 0xB7U, 0x3FU, 0xCDU, 0x99U, 0x97U, 0xEDU, 0xBDU, 0xECU, 0x8FU, 0xE3U, 0xDCU,
+        0x97U, 0x90U, 0x63U, 0x98U, 0x6EU, 0xE1U, 0x75U, 0x6EU, 0xEBU, 0x73U, 0x3DU, 0x3EU, 0x41U, 0x62U, 0xB8U, 0xDEU,
+        0x2FU, 0xF3U, 0x3FU, 0x48U, 0x16U, 0x14U, 0x07U, 0xB2U, 0x05U, 0xD5U, 0x81U, 0x62U, 0xC1U, 0x70U, 0x40U, 0x2CU,
+        0x48U, 0x0EU, 0xA8U, 0x05U, 0xE2U, 0x40U, 0xB5U, 0xA0U, 0x39U, 0x60U, 0x9BU, 0x8AU, 0xCDU, 0x4CU, 0x4DU, 0xA5U,
+        0x66U, 0xA7U, 0x66U, 0xA4U, 0x66U, 0xA1U, 0x66U, 0x85U, 0xA6U, 0x0CU, 0x6AU, 0x26U, 0x6AU, 0x0AU, 0x35U, 0x1BU,
+        0x34U, 0x15U, 0x9BU, 0x99U, 0x9AU, 0x4AU, 0xCDU, 0x4EU, 0xCDU, 0x48U, 0xCDU, 0x42U, 0xCDU, 0x0AU, 0x4DU, 0x19U,
+        0xD4U, 0x4CU, 0xD4U, 0x14U, 0x6AU, 0x36U, 0x68U, 0x2AU, 0x36U, 0x33U, 0x35U, 0x95U, 0x9AU, 0x9DU, 0x9AU, 0x91U,
+        0x9AU, 0x85U, 0x9AU, 0x15U, 0x9AU, 0x32U, 0xA8U, 0x99U, 0xA8U, 0x29U, 0xD4U, 0x6CU, 0x3FU, 0xF0U, 0x05U, 0x4FU,
+        0xF7U, 0x98U, 0x33U
+    };
+
+    static const uint8_t    FIXED_DATA[12]  =
+    {
+        0x0BU, 0xF0U, 0x8CU, 0x70U, 0xF5U, 0xF1U, 0x8CU, 0x50U, 0x08U, 0x80U, 0xD0U, 0x00U
+    };
+
+    static const uint8_t    STORED_DATA[12]  =
+    {
+        0x01U, 0x07U, 0x00U, 0xF8U, 0xFFU, 0x50U, 0x49U, 0x58U, 0x45U, 0x4CU, 0x49U, 0x58U
+    };
+
+    const uint32_t          ITERATIONS      = 2000U;
+    Inflater                inflater;
+    TestInflaterOutput      output;
+    char                    text[1400U];
+    size_t                  textLen         = 0U;
+    uint8_t                 corrupt[sizeof(GZIP_DATA)];
+    size_t                  index           = 0U;
+    uint32_t                iteration       = 0U;
+    Inflater::Status        status          = Inflater::STATUS_DONE;
+    uint32_t                timestamp       = 0U;
+    uint32_t                duration        = 0U;
+
+    /* Expected decompressed text */
+    for(index = 0U; index < 40U; ++index)
+    {
+        textLen += snprintf(&text[textLen], sizeof(text) - textLen, "Temperature %u C, humidity %u %%.\n",
+                    static_cast<uint32_t>(20U + (index % 7U)), static_cast<uint32_t>(40U + ((index * 3U) % 11U)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1320U, textLen);
+
+    /* Not started */
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_ERROR, inflater.write(GZIP_DATA, sizeof(GZIP_DATA)));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_ERROR, inflater.finish());
+
+    /* gzip with file name and dynamic huffman codes, written at once */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_GZIP, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.write(GZIP_DATA, sizeof(GZIP_DATA)));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.finish());
+    TEST_ASSERT_EQUAL_UINT32(textLen, output.getSize());
+    TEST_ASSERT_EQUAL_MEMORY(text, output.getData(), textLen);
+    TEST_ASSERT_EQUAL_UINT32(textLen, inflater.getOutputSize());
+    TEST_ASSERT_EQUAL_UINT32(Inflater::MAX_WINDOW_SIZE, inflater.getWindowSize());
+
+    /* gzip, written byte by byte */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_GZIP, TestInflaterOutput::write, &output));
+    for(index = 0U; index < (sizeof(GZIP_DATA) - 1U); ++index)
+    {
+        TEST_ASSERT_EQUAL_INT(Inflater::STATUS_CONTINUE, inflater.write(&GZIP_DATA[index], 1U));
+    }
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.write(&GZIP_DATA[index], 1U));
+    TEST_ASSERT_EQUAL_UINT32(textLen, output.getSize());
+    TEST_ASSERT_EQUAL_MEMORY(text, output.getData(), textLen);
+
+    /* gzip with corrupted CRC */
+    memcpy(corrupt, GZIP_DATA, sizeof(GZIP_DATA));
+    corrupt[sizeof(corrupt) - 8U] ^= 0x01U;
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_GZIP, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_ERROR, inflater.write(corrupt, sizeof(corrupt)));
+
+    /* gzip, truncated */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_GZIP, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_CONTINUE, inflater.write(GZIP_DATA, sizeof(GZIP_DATA) / 2U));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_ERROR, inflater.finish());
+
+    /* zlib with a 512 byte window, which is smaller than the data. */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_ZLIB, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.write(ZLIB_DATA, sizeof(ZLIB_DATA)));
+    TEST_ASSERT_EQUAL_UINT32(textLen, output.getSize());
+    TEST_ASSERT_EQUAL_MEMORY(text, output.getData(), textLen);
+    TEST_ASSERT_EQUAL_UINT32(512U, inflater.getWindowSize());
+
+    /* Raw deflate data with fixed huffman codes, detected by the missing zlib header. */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_ZLIB, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_CONTINUE, inflater.write(FIXED_DATA, sizeof(FIXED_DATA)));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.finish());
+    TEST_ASSERT_EQUAL_UINT32(15U, output.getSize());
+    TEST_ASSERT_EQUAL_MEMORY("PIXELIX PIXELIX", output.getData(), 15U);
+
+    /* Raw deflate data with a stored block */
+    output.clear();
+    TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_RAW, TestInflaterOutput::write, &output));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.write(STORED_DATA, sizeof(STORED_DATA)));
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, inflater.finish());
+    TEST_ASSERT_EQUAL_UINT32(7U, output.getSize());
+    TEST_ASSERT_EQUAL_MEMORY("PIXELIX", output.getData(), 7U);
+
+    /* Window buffer is released. */
+    inflater.end();
+    TEST_ASSERT_EQUAL_UINT32(0U, inflater.getWindowSize());
+
+    /* Throughput with the max. window size, fed in network sized pieces. */
+    output.clear();
+    timestamp = millis();
+    for(iteration = 0U; (iteration < ITERATIONS) && (Inflater::STATUS_DONE == status); ++iteration)
+    {
+        TEST_ASSERT_TRUE(inflater.begin(Inflater::FORMAT_GZIP, TestInflaterOutput::write, &output));
+
+        status = Inflater::STATUS_CONTINUE;
+        for(index = 0U; (index < sizeof(GZIP_DATA)) && (Inflater::STATUS_CONTINUE == status); index += 64U)
+        {
+            status = inflater.write(&GZIP_DATA[index], getMin<size_t>(64U, sizeof(GZIP_DATA) - index));
+        }
+    }
+    duration = millis() - timestamp;
+    TEST_ASSERT_EQUAL_INT(Inflater::STATUS_DONE, status);
+    TEST_ASSERT_EQUAL_UINT32(ITERATIONS * textLen, output.getTotal());
+
+    printf("Inflater: %u KB in %u ms, peak memory %u byte (window %u byte).\n",
+        static_cast<uint32_t>(output.getTotal() / 1024U),
+        duration,
+        static_cast<uint32_t>(sizeof(Inflater) + inflater.getWindowSize()),
+        static_cast<uint32_t>(inflater.getWindowSize()));
+
+    inflater.end();
+
+    return;
+}
+
+/**
+ * Frame encoder tests.
+ */
+static void testFrameEncoder(void)
+{
+    const uint16_t  WIDTH       = 32U;
+    const uint16_t  HEIGHT      = 8U;
+    const size_t    COUNT       = WIDTH * HEIGHT;
+    const uint32_t  ITERATIONS  = 10000U;
+    FrameEncoder    encoder;
+    uint32_t        pixels[COUNT];
+    uint32_t        values[COUNT];
+    uint8_t         frame[FrameEncoder::HEADER_SIZE + (COUNT * FrameEncoder::MAX_BYTES_PER_PIXEL)];
+    size_t          frameSize   = 0U;
+    size_t          textSize    = 0U;
+    size_t          index       = 0U;
+    uint32_t        frameNo     = 0U;
+    uint32_t        iteration   = 0U;
+    uint32_t        timestamp   = 0U;
+    uint32_t        duration    = 0U;
+    size_t          totalSize   = 0U;
+
+    /* Some text like content on black background */
+    for(index = 0U; index < COUNT; ++index)
+    {
+        pixels[index] = (0U == (index % 5U)) ? 0x00FF8000U : 0x00000000U;
+    }
+
+    /* Not started */
+    TEST_ASSERT_EQUAL_UINT32(0U, encoder.encode(frame, sizeof(frame), pixels, 1U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(0U, encoder.encodeKeyFrame(frame, sizeof(frame), 1U));
+
+    /* Invalid parameters */
+    TEST_ASSERT_FALSE(encoder.begin(0U, HEIGHT, FrameEncoder::PIXEL_FORMAT_RGB888));
+    TEST_ASSERT_FALSE(encoder.begin(WIDTH, HEIGHT, FrameEncoder::PIXEL_FORMAT_MAX));
+    TEST_ASSERT_TRUE(encoder.begin(WIDTH, HEIGHT, FrameEncoder::PIXEL_FORMAT_RGB888));
+    TEST_ASSERT_EQUAL_UINT32(FrameEncoder::HEADER_SIZE + (COUNT * 3U), encoder.getMaxSize());
+
+    /* Buffer too small */
+    TEST_ASSERT_EQUAL_UINT32(0U, encoder.encode(frame, encoder.getMaxSize() - 1U, pixels, 1U, 0U));
+
+    /* First frame is a key frame. */
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 1U, 0U);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_RLE, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT8(FrameEncoder::VERSION, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(FrameEncoder::PIXEL_FORMAT_RGB888, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(1U, frame[3]);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+    frameNo = encoder.getFrameNo();
+    TEST_ASSERT_NOT_EQUAL(0U, frameNo);
+
+    /* Unchanged frame, acknowledged reference frame */
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 1U, frameNo);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_DELTA, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(FrameEncoder::HEADER_SIZE + (2U * 4U), frameSize);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+    frameNo = encoder.getFrameNo();
+
+    /* Some changed pixels */
+    pixels[3U]          = 0x00123456U;
+    pixels[4U]          = 0x00123456U;
+    pixels[COUNT - 1U]  = 0x00FFFFFFU;
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 2U, frameNo);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_DELTA, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+
+    /* Text response of the former protocol for comparison: "ACK;<slot id>" and ";<8 hex digits>" per pixel. */
+    textSize = 5U + (COUNT * 9U);
+    TEST_ASSERT_LESS_THAN(textSize / 10U, frameSize);
+
+    /* The same frame as key frame, for a receiver without the reference frame. */
+    frameSize = encoder.encodeKeyFrame(frame, sizeof(frame), 2U);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_RLE, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(encoder.getFrameNo(), frame[4] | (frame[5] << 8U) | (frame[6] << 16U) | (frame[7] << 24U));
+    memset(values, 0, sizeof(values));
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+    frameNo = encoder.getFrameNo();
+
+    /* Reference frame not acknowledged */
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 2U, frameNo - 1U);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_RLE, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+
+    /* Noise can't be compressed. */
+    for(index = 0U; index < COUNT; ++index)
+    {
+        pixels[index] = (index * 0x00010203U) & 0x00FFFFFFU;
+    }
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 2U, 0U);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_RAW, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(encoder.getMaxSize(), frameSize);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+    frameSize = encoder.encodeKeyFrame(frame, sizeof(frame), 2U);
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_RAW, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT32(encoder.getMaxSize(), frameSize);
+    memset(values, 0, sizeof(values));
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(pixels, values, COUNT);
+
+    /* Changed pixel format drops the reference frame. Stream frames are marked. */
+    frameNo = encoder.getFrameNo();
+    TEST_ASSERT_TRUE(encoder.begin(WIDTH, HEIGHT, FrameEncoder::PIXEL_FORMAT_RGB565));
+    TEST_ASSERT_EQUAL_UINT32(FrameEncoder::HEADER_SIZE + (COUNT * 2U), encoder.getMaxSize());
+    encoder.setStream(true);
+    frameSize = encoder.encode(frame, sizeof(frame), pixels, 3U, frameNo);
+    encoder.setStream(false);
+    TEST_ASSERT_NOT_EQUAL(FrameEncoder::ENCODING_DELTA, encoder.getEncoding());
+    TEST_ASSERT_EQUAL_UINT8(FrameEncoder::FLAG_STREAM | FrameEncoder::PIXEL_FORMAT_RGB565, frame[1]);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, decodeFrame(frame, frameSize, values, COUNT));
+    for(index = 0U; index < COUNT; ++index)
+    {
+        const uint32_t RGB565 = ((pixels[index] >> 8U) & 0xF800U) | ((pixels[index] >> 5U) & 0x07E0U) | ((pixels[index] >> 3U) & 0x001FU);
+
+        TEST_ASSERT_EQUAL_UINT32(RGB565, values[index]);
+    }
+
+    /* Delta frames of a moving pixel */
+    TEST_ASSERT_TRUE(encoder.begin(WIDTH, HEIGHT, FrameEncoder::PIXEL_FORMAT_RGB888));
+    memset(pixels, 0, sizeof(pixels));
+    frameNo     = 0U;
+    timestamp   = millis();
+    for(iteration = 0U; iteration < ITERATIONS; ++iteration)
+    {
+        pixels[(iteration + COUNT - 1U) % COUNT]    = 0x00000000U;
+        pixels[iteration % COUNT]                   = 0x00FFFFFFU;
+
+        frameSize   = encoder.encode(frame, sizeof(frame), pixels, 0U, frameNo);
+        frameNo     = encoder.getFrameNo();
+        totalSize  += frameSize;
+    }
+    duration = millis() - timestamp;
+    TEST_ASSERT_EQUAL_INT(FrameEncoder::ENCODING_DELTA, encoder.getEncoding());
+
+    printf("Frame encoder: %u frames in %u ms, %u byte per frame (text %u byte).\n",
+        ITERATIONS,
+        duration,
+        static_cast<uint32_t>(totalSize / ITERATIONS),
+        static_cast<uint32_t>(textSize));
+
+    encoder.end();
+    TEST_ASSERT_EQUAL_UINT32(0U, encoder.encode(frame, sizeof(frame), pixels, 0U, frameNo));
+
+    return;
+}
+
+/**
+ * Decode a frame of the frame encoder to the pixel values of its pixel
+ * format. A delta frame is applied to the given pixel values.
+ *
+ * @param[in]       frame   Frame
+ * @param[in]       size    Frame size in byte
+ * @param[in,out]   values  Pixel values
+ * @param[in]       count   Number of pixel values
+ *
+ * @return Number of decoded pixels
+ */
+static size_t decodeFrame(const uint8_t* frame, size_t size, uint32_t* values, size_t count)
+{
+    const uint8_t   FORMAT          = frame[1] & ~FrameEncoder::FLAG_STREAM;
+    const uint8_t   BYTES_PER_PIXEL = (FrameEncoder::PIXEL_FORMAT_RGB565 == FORMAT) ? 2U : 3U;
+    const uint8_t   ENCODING        = frame[2];
+    size_t          rdIndex         = FrameEncoder::HEADER_SIZE;
+    size_t          index           = 0U;
+
+    while((size > rdIndex) && (count > index))
+    {
+        size_t  num         = 1U;
+        bool    isRepeated  = false;
+        size_t  pixel       = 0U;
+
+        if (FrameEncoder::ENCODING_RAW != ENCODING)
+        {
+            isRepeated  = (0U != (frame[rdIndex] & 0x80U));
+            num         = (frame[rdIndex] & 0x7FU) + 1U;
+            ++rdIndex;
+        }
+
+        for(pixel = 0U; (pixel < num) && (count > index); ++pixel)
+        {
+            const uint8_t*  src     = &frame[rdIndex];
+            uint32_t        value   = 0U;
+
+            if (2U == BYTES_PER_PIXEL)
+            {
+                value = src[0] | (static_cast<uint32_t>(src[1]) << 8U);
+            }
+            else
+            {
+                value = (static_cast<uint32_t>(src[0]) << 16U) | (static_cast<uint32_t>(src[1]) << 8U) | src[2];
+            }
+
+            if (FrameEncoder::ENCODING_DELTA == ENCODING)
+            {
+                values[index] ^= value;
+            }
+            else
+            {
+                values[index] = value;
+            }
+
+            if (false == isRepeated)
+            {
+                rdIndex += BYTES_PER_PIXEL;
+            }
+
+            ++index;
+        }
+
+        if (true == isRepeated)
+        {
+            rdIndex += BYTES_PER_PIXEL;
+        }
+    }
+
+    return index;
+}